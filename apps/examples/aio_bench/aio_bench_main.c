@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <aio.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_AIO_BENCH_NFILES
+#define CONFIG_EXAMPLES_AIO_BENCH_NFILES 2
+#endif
+
+#ifndef CONFIG_EXAMPLES_AIO_BENCH_DEPTH
+#define CONFIG_EXAMPLES_AIO_BENCH_DEPTH 4
+#endif
+
+#ifndef CONFIG_EXAMPLES_AIO_BENCH_BLOCKSIZE
+#define CONFIG_EXAMPLES_AIO_BENCH_BLOCKSIZE 512
+#endif
+
+#ifndef CONFIG_EXAMPLES_AIO_BENCH_FILESIZE
+#define CONFIG_EXAMPLES_AIO_BENCH_FILESIZE 65536
+#endif
+
+#define NFILES    CONFIG_EXAMPLES_AIO_BENCH_NFILES
+#define DEPTH     CONFIG_EXAMPLES_AIO_BENCH_DEPTH
+#define BLOCKSIZE CONFIG_EXAMPLES_AIO_BENCH_BLOCKSIZE
+#define FILESIZE  CONFIG_EXAMPLES_AIO_BENCH_FILESIZE
+#define NREQS     (NFILES * DEPTH)
+
+#define AIO_BENCH_PATHLEN 64
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_default_dirs[] = {
+#ifdef CONFIG_FS_TMPFS
+	"/tmp",
+#endif
+#ifdef CONFIG_FS_SMARTFS
+	"/mnt",
+#endif
+	NULL
+};
+
+static struct aiocb g_aiocb[NREQS];
+static struct aiocb *g_list[NREQS];
+static uint8_t g_buffer[NREQS][BLOCKSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t aio_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000);
+}
+
+static int aio_bench_pass(const char *dir, int opcode)
+{
+	char path[AIO_BENCH_PATHLEN];
+	struct timespec start;
+	struct aiocb *aiocbp;
+	uint32_t msec;
+	off_t offset;
+	int fd[NFILES];
+	int result = OK;
+	int ret;
+	int f;
+	int d;
+	int i;
+
+	for (f = 0; f < NFILES; f++) {
+		snprintf(path, AIO_BENCH_PATHLEN, "%s/aio_bench%d", dir, f);
+		if (opcode == LIO_WRITE) {
+			fd[f] = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		} else {
+			fd[f] = open(path, O_RDONLY);
+		}
+
+		if (fd[f] < 0) {
+			printf("ERROR: open %s failed: %d\n", path, errno);
+			while (--f >= 0) {
+				close(fd[f]);
+			}
+
+			return ERROR;
+		}
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	/* Each lio_listio() call keeps DEPTH adjacent requests outstanding on
+	 * every file.
+	 */
+
+	for (offset = 0; offset < FILESIZE && result == OK; offset += DEPTH * BLOCKSIZE) {
+		for (f = 0, i = 0; f < NFILES; f++) {
+			for (d = 0; d < DEPTH; d++, i++) {
+				aiocbp = &g_aiocb[i];
+				memset(aiocbp, 0, sizeof(struct aiocb));
+				aiocbp->aio_fildes = fd[f];
+				aiocbp->aio_buf = g_buffer[i];
+				aiocbp->aio_nbytes = BLOCKSIZE;
+				aiocbp->aio_offset = offset + d * BLOCKSIZE;
+				aiocbp->aio_lio_opcode = opcode;
+				aiocbp->aio_sigevent.sigev_notify = SIGEV_NONE;
+				g_list[i] = aiocbp;
+			}
+		}
+
+		ret = lio_listio(LIO_WAIT, g_list, NREQS, NULL);
+		if (ret < 0) {
+			printf("ERROR: lio_listio failed: %d\n", errno);
+			result = ERROR;
+			break;
+		}
+
+		for (i = 0; i < NREQS; i++) {
+			if (aio_error(&g_aiocb[i]) != OK || aio_return(&g_aiocb[i]) != BLOCKSIZE) {
+				printf("ERROR: request %d failed: %d\n", i, aio_error(&g_aiocb[i]));
+				result = ERROR;
+				break;
+			}
+		}
+	}
+
+	msec = aio_bench_elapsed(&start);
+
+	for (f = 0; f < NFILES; f++) {
+		close(fd[f]);
+	}
+
+	if (result == OK) {
+		if (msec == 0) {
+			msec = 1;
+		}
+
+		printf("%-6s %-5s %d files x %d bytes: %lu ms, %lu KB/s\n", dir, opcode == LIO_WRITE ? "write" : "read", NFILES, FILESIZE, (unsigned long)msec, (unsigned long)(((uint64_t)NFILES * FILESIZE * 1000) / ((uint64_t)msec * 1024)));
+	}
+
+	return result;
+}
+
+static void aio_bench_cleanup(const char *dir)
+{
+	char path[AIO_BENCH_PATHLEN];
+	int f;
+
+	for (f = 0; f < NFILES; f++) {
+		snprintf(path, AIO_BENCH_PATHLEN, "%s/aio_bench%d", dir, f);
+		unlink(path);
+	}
+}
+
+static void aio_bench_metrics(void)
+{
+#ifdef CONFIG_FS_AIO_METRICS
+	char buf[64];
+	ssize_t nread;
+	int fd;
+
+	fd = open("/proc/fs/aio", O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+
+	printf("AIO metrics:\n");
+	while ((nread = read(fd, buf, sizeof(buf) - 1)) > 0) {
+		buf[nread] = '\0';
+		printf("%s", buf);
+	}
+
+	close(fd);
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int aio_bench_main(int argc, char *argv[])
+#endif
+{
+	const char **dirs = g_default_dirs;
+	struct stat st;
+	int i;
+
+	if (argc > 1) {
+		dirs = (const char **)&argv[1];
+	}
+
+	if (dirs[0] == NULL) {
+		printf("Usage: aio_bench [dir ...]\n");
+		return ERROR;
+	}
+
+	for (i = 0; dirs[i] != NULL; i++) {
+		if (stat(dirs[i], &st) < 0 || !S_ISDIR(st.st_mode)) {
+			printf("%s: not mounted, skipped\n", dirs[i]);
+			continue;
+		}
+
+		if (aio_bench_pass(dirs[i], LIO_WRITE) == OK) {
+			(void)aio_bench_pass(dirs[i], LIO_READ);
+		}
+
+		aio_bench_cleanup(dirs[i]);
+	}
+
+	aio_bench_metrics();
+	return OK;
+}
@@ -0,0 +1,631 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <arastorage/arastorage.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_ARASTORAGE_BENCH_ROWS
+#define CONFIG_EXAMPLES_ARASTORAGE_BENCH_ROWS 200
+#endif
+
+#ifndef CONFIG_EXAMPLES_ARASTORAGE_BENCH_QUERIES
+#define CONFIG_EXAMPLES_ARASTORAGE_BENCH_QUERIES 50
+#endif
+
+#define ROWS    CONFIG_EXAMPLES_ARASTORAGE_BENCH_ROWS
+#define QUERIES CONFIG_EXAMPLES_ARASTORAGE_BENCH_QUERIES
+
+#define BENCH_RELATION  "bench"
+#define LOAD_RELATION   "bload"
+#define LOOKUP_RELATION "bname"
+#define GROUP_RELATION  "bgroup"
+#define KIND_RELATION   "bkind"
+#define BENCH_QUERY_LEN 128
+#define BENCH_NAME_LEN  16
+
+/* Each query returns the rows of one window of the id range. */
+#define BENCH_WINDOW    10
+
+/* The rows aggregated and joined fall into this many kinds. */
+#define BENCH_KINDS     8
+
+enum bench_mode_e {
+	BENCH_TEXT,					/* A new sentence for every operation */
+	BENCH_REPEAT,				/* The same sentence, reused from the plan cache */
+	BENCH_PREPARED				/* A prepared statement */
+};
+
+enum lookup_index_e {
+	LOOKUP_SCAN,				/* No index, every row is read */
+	LOOKUP_BPLUSTREE,			/* A B+tree over the prefix compressed names */
+	LOOKUP_HASH					/* A hash index, for equality only */
+};
+
+enum load_mode_e {
+	LOAD_ROW,					/* Every row updates the index */
+	LOAD_BULK					/* The index is built at db_bulk_end() */
+};
+
+enum relational_mode_e {
+	RELATIONAL_ENGINE,			/* GROUP BY and JOIN run in the query */
+	RELATIONAL_APP				/* The rows are pulled and combined through the cursor */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char *g_mode_name[] = { "text", "repeat", "prepared" };
+static const char *g_load_name[] = { "row", "bulk" };
+static const char *g_index_name[] = { NULL, "BPLUSTREE", "HASH" };
+static const char *g_relational_name[] = { "engine", "app" };
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t arastorage_bench_elapsed_us(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+static void arastorage_bench_report(const char *op, int mode, int count, uint32_t usec)
+{
+	if (usec == 0) {
+		usec = 1;
+	}
+	printf("%-6s %-8s %4d ops: %8lu us, %6lu us/op, %6lu ops/s\n", op, g_mode_name[mode], count, (unsigned long)usec, (unsigned long)(usec / count), (unsigned long)(((uint64_t)count * 1000000) / usec));
+}
+
+static int arastorage_bench_insert(int mode, int base)
+{
+	char query[BENCH_QUERY_LEN];
+	struct timespec start;
+	db_stmt_t *stmt = NULL;
+	db_result_t res;
+	long value;
+	int id;
+	int i;
+
+	if (mode == BENCH_PREPARED) {
+		stmt = db_prepare("INSERT (?, ?) INTO " BENCH_RELATION ";");
+		if (stmt == NULL) {
+			printf("ERROR: db_prepare failed\n");
+			return ERROR;
+		}
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < ROWS; i++) {
+		id = base + i;
+		value = (long)id * 3;
+		switch (mode) {
+		case BENCH_TEXT:
+			snprintf(query, BENCH_QUERY_LEN, "INSERT (%d, %ld) INTO %s;", id, value, BENCH_RELATION);
+			res = db_exec(query);
+			break;
+		case BENCH_REPEAT:
+			/* Every row gets the same values so the sentence does not change. */
+			res = db_exec("INSERT (0, 0) INTO " BENCH_RELATION ";");
+			break;
+		default:
+			db_bind(stmt, 0, DOMAIN_INT, &id);
+			db_bind(stmt, 1, DOMAIN_LONG, &value);
+			res = db_step(stmt, NULL);
+			break;
+		}
+		if (DB_ERROR(res)) {
+			printf("ERROR: insert %d failed: %s\n", i, db_get_result_message(res));
+			break;
+		}
+	}
+	arastorage_bench_report("insert", mode, i, arastorage_bench_elapsed_us(&start));
+
+	if (stmt != NULL) {
+		db_finalize(stmt);
+	}
+	return i == ROWS ? OK : ERROR;
+}
+
+static int arastorage_bench_select(int mode)
+{
+	char query[BENCH_QUERY_LEN];
+	struct timespec start;
+	db_stmt_t *stmt = NULL;
+	db_cursor_t *cursor;
+	db_result_t res;
+	int low;
+	int high;
+	int i;
+
+	if (mode == BENCH_PREPARED) {
+		stmt = db_prepare("SELECT id, value FROM " BENCH_RELATION " WHERE id >= ? AND id < ?;");
+		if (stmt == NULL) {
+			printf("ERROR: db_prepare failed\n");
+			return ERROR;
+		}
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < QUERIES; i++) {
+		low = (i * BENCH_WINDOW) % ROWS;
+		high = low + BENCH_WINDOW;
+		switch (mode) {
+		case BENCH_TEXT:
+			snprintf(query, BENCH_QUERY_LEN, "SELECT id, value FROM %s WHERE id >= %d AND id < %d;", BENCH_RELATION, low, high);
+			cursor = db_query(query);
+			break;
+		case BENCH_REPEAT:
+			cursor = db_query("SELECT id, value FROM " BENCH_RELATION " WHERE id >= 0 AND id < 10;");
+			break;
+		default:
+			db_bind(stmt, 0, DOMAIN_INT, &low);
+			db_bind(stmt, 1, DOMAIN_INT, &high);
+			res = db_step(stmt, &cursor);
+			if (DB_ERROR(res)) {
+				cursor = NULL;
+			}
+			break;
+		}
+		if (cursor == NULL) {
+			printf("ERROR: query %d failed\n", i);
+			break;
+		}
+		db_cursor_free(cursor);
+	}
+	arastorage_bench_report("select", mode, i, arastorage_bench_elapsed_us(&start));
+
+	if (stmt != NULL) {
+		db_finalize(stmt);
+	}
+	return i == QUERIES ? OK : ERROR;
+}
+
+static int arastorage_bench_lookup_index(int kind)
+{
+	char query[BENCH_QUERY_LEN];
+	db_result_t res;
+
+	snprintf(query, BENCH_QUERY_LEN, "CREATE INDEX %s.name TYPE %s;", LOOKUP_RELATION, g_index_name[kind]);
+	res = db_exec(query);
+	if (DB_ERROR(res)) {
+		printf("ERROR: failed to create index: %s\n", db_get_result_message(res));
+		return ERROR;
+	}
+	return OK;
+}
+
+/* Names of devices are looked up with and without an index on them. The
+ * index is created either before the rows are inserted, so that the B+tree
+ * learns the prefix shared by the names one insert at a time, or after.
+ */
+static int arastorage_bench_lookup(int kind, bool first)
+{
+	char query[BENCH_QUERY_LEN];
+	char name[BENCH_NAME_LEN];
+	struct timespec start;
+	db_stmt_t *stmt;
+	db_cursor_t *cursor;
+	db_result_t res;
+	int id;
+	int i;
+
+	db_exec("REMOVE RELATION " LOOKUP_RELATION ";");
+	if (DB_ERROR(db_exec("CREATE RELATION " LOOKUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE id DOMAIN INT IN " LOOKUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE name DOMAIN STRING(16) IN " LOOKUP_RELATION ";"))) {
+		printf("ERROR: failed to create relation %s\n", LOOKUP_RELATION);
+		return ERROR;
+	}
+	if (kind != LOOKUP_SCAN && first && arastorage_bench_lookup_index(kind) != OK) {
+		return ERROR;
+	}
+
+	stmt = db_prepare("INSERT (?, ?) INTO " LOOKUP_RELATION ";");
+	if (stmt == NULL) {
+		printf("ERROR: db_prepare failed\n");
+		return ERROR;
+	}
+	res = DB_OK;
+	for (i = 0; i < ROWS && DB_SUCCESS(res); i++) {
+		id = i * 37 % ROWS;
+		snprintf(name, BENCH_NAME_LEN, "device-%05d", id);
+		db_bind(stmt, 0, DOMAIN_INT, &id);
+		db_bind(stmt, 1, DOMAIN_STRING, name);
+		res = db_step(stmt, NULL);
+	}
+	db_finalize(stmt);
+	if (DB_ERROR(res)) {
+		printf("ERROR: insert %d failed: %s\n", i, db_get_result_message(res));
+		return ERROR;
+	}
+
+	if (kind != LOOKUP_SCAN && !first && arastorage_bench_lookup_index(kind) != OK) {
+		return ERROR;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < QUERIES; i++) {
+		snprintf(query, BENCH_QUERY_LEN, "SELECT id, name FROM %s WHERE name = 'device-%05d';", LOOKUP_RELATION, i * 7 % ROWS);
+		cursor = db_query(query);
+		if (cursor == NULL || cursor_get_count(cursor) != 1) {
+			printf("ERROR: lookup %d failed\n", i);
+			if (cursor != NULL) {
+				db_cursor_free(cursor);
+			}
+			break;
+		}
+		db_cursor_free(cursor);
+	}
+	printf("lookup %-9s %-5s %4d rows %4d ops: %8lu us\n", kind == LOOKUP_SCAN ? "none" : g_index_name[kind], first ? "first" : "last", ROWS, i, (unsigned long)arastorage_bench_elapsed_us(&start));
+
+	db_exec("REMOVE RELATION " LOOKUP_RELATION ";");
+	return i == QUERIES ? OK : ERROR;
+}
+
+static int arastorage_bench_create_relational(void)
+{
+	char query[BENCH_QUERY_LEN];
+	db_stmt_t *stmt;
+	db_result_t res;
+	long value;
+	int kind;
+	int i;
+
+	if (DB_ERROR(db_exec("CREATE RELATION " GROUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE id DOMAIN INT IN " GROUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE kind DOMAIN INT IN " GROUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE value DOMAIN LONG IN " GROUP_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE RELATION " KIND_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE kind DOMAIN INT IN " KIND_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE name DOMAIN STRING(16) IN " KIND_RELATION ";"))) {
+		printf("ERROR: failed to create relations %s and %s\n", GROUP_RELATION, KIND_RELATION);
+		return ERROR;
+	}
+
+	for (kind = 0; kind < BENCH_KINDS; kind++) {
+		snprintf(query, BENCH_QUERY_LEN, "INSERT (%d, 'kind-%d') INTO %s;", kind, kind, KIND_RELATION);
+		if (DB_ERROR(db_exec(query))) {
+			printf("ERROR: failed to insert kind %d\n", kind);
+			return ERROR;
+		}
+	}
+
+	stmt = db_prepare("INSERT (?, ?, ?) INTO " GROUP_RELATION ";");
+	if (stmt == NULL) {
+		printf("ERROR: db_prepare failed\n");
+		return ERROR;
+	}
+	res = DB_OK;
+	for (i = 0; i < ROWS && DB_SUCCESS(res); i++) {
+		kind = i % BENCH_KINDS;
+		value = (long)i * 3;
+		db_bind(stmt, 0, DOMAIN_INT, &i);
+		db_bind(stmt, 1, DOMAIN_INT, &kind);
+		db_bind(stmt, 2, DOMAIN_LONG, &value);
+		res = db_step(stmt, NULL);
+	}
+	db_finalize(stmt);
+	if (DB_ERROR(res)) {
+		printf("ERROR: insert %d failed: %s\n", i, db_get_result_message(res));
+		return ERROR;
+	}
+	return OK;
+}
+
+/* The count and the sum of the values of each kind, computed by GROUP BY or
+ * by reading every row through the cursor.
+ */
+static int arastorage_bench_group(int mode)
+{
+	long sum[BENCH_KINDS];
+	int count[BENCH_KINDS];
+	struct timespec start;
+	db_cursor_t *cursor;
+	cursor_row_t rows;
+	cursor_row_t row;
+	db_result_t res;
+	int kind;
+	int i;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < QUERIES; i++) {
+		if (mode == RELATIONAL_ENGINE) {
+			cursor = db_query("SELECT kind, COUNT(id), SUM(value) FROM " GROUP_RELATION " GROUP BY kind;");
+		} else {
+			cursor = db_query("SELECT kind, value FROM " GROUP_RELATION ";");
+		}
+		if (cursor == NULL) {
+			printf("ERROR: group %d failed\n", i);
+			break;
+		}
+
+		memset(sum, 0, sizeof(sum));
+		memset(count, 0, sizeof(count));
+		rows = cursor_get_count(cursor);
+		res = cursor_move_first(cursor);
+		for (row = 0; row < rows && DB_SUCCESS(res); row++) {
+			kind = cursor_get_int_value(cursor, 0);
+			if (kind >= 0 && kind < BENCH_KINDS) {
+				if (mode == RELATIONAL_ENGINE) {
+#ifdef CONFIG_ARCH_FLOAT_H
+					count[kind] = (int)cursor_get_double_value(cursor, 1);
+					sum[kind] = (long)cursor_get_double_value(cursor, 2);
+#endif
+				} else {
+					count[kind]++;
+					sum[kind] += cursor_get_long_value(cursor, 1);
+				}
+			}
+			res = cursor_move_next(cursor);
+		}
+		db_cursor_free(cursor);
+#ifndef CONFIG_ARCH_FLOAT_H
+		if (mode == RELATIONAL_ENGINE) {
+			/* The aggregates are doubles, which can not be read back */
+			continue;
+		}
+#endif
+		if (count[0] != (ROWS + BENCH_KINDS - 1) / BENCH_KINDS) {
+			printf("ERROR: group %d counted %d rows of kind 0\n", i, count[0]);
+			break;
+		}
+	}
+	printf("group  %-8s %4d rows %4d ops: %8lu us\n", g_relational_name[mode], ROWS, i, (unsigned long)arastorage_bench_elapsed_us(&start));
+	return i == QUERIES ? OK : ERROR;
+}
+
+/* The name of the kind of each row, found by JOIN or by reading both
+ * relations through the cursor and matching them in a table.
+ */
+static int arastorage_bench_join(int mode)
+{
+	char name[BENCH_KINDS][BENCH_NAME_LEN];
+	struct timespec start;
+	db_cursor_t *cursor;
+	cursor_row_t rows;
+	cursor_row_t row;
+	db_result_t res;
+	const char *match;
+	int matched;
+	int kind;
+	int i;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (i = 0; i < QUERIES; i++) {
+		if (mode == RELATIONAL_ENGINE) {
+			cursor = db_query("SELECT id, name FROM " GROUP_RELATION " JOIN " KIND_RELATION " ON kind = kind;");
+		} else {
+			cursor = db_query("SELECT kind, name FROM " KIND_RELATION ";");
+			if (cursor != NULL) {
+				memset(name, 0, sizeof(name));
+				rows = cursor_get_count(cursor);
+				res = cursor_move_first(cursor);
+				for (row = 0; row < rows && DB_SUCCESS(res); row++) {
+					kind = cursor_get_int_value(cursor, 0);
+					if (kind >= 0 && kind < BENCH_KINDS) {
+						strncpy(name[kind], (char *)cursor_get_string_value(cursor, 1), BENCH_NAME_LEN - 1);
+					}
+					res = cursor_move_next(cursor);
+				}
+				db_cursor_free(cursor);
+				cursor = db_query("SELECT id, kind FROM " GROUP_RELATION ";");
+			}
+		}
+		if (cursor == NULL) {
+			printf("ERROR: join %d failed\n", i);
+			break;
+		}
+
+		matched = 0;
+		rows = cursor_get_count(cursor);
+		res = cursor_move_first(cursor);
+		for (row = 0; row < rows && DB_SUCCESS(res); row++) {
+			if (mode == RELATIONAL_ENGINE) {
+				match = (char *)cursor_get_string_value(cursor, 1);
+			} else {
+				kind = cursor_get_int_value(cursor, 1);
+				match = (kind >= 0 && kind < BENCH_KINDS) ? name[kind] : "";
+			}
+			if (match[0] != '\0') {
+				matched++;
+			}
+			res = cursor_move_next(cursor);
+		}
+		db_cursor_free(cursor);
+		if (matched != ROWS) {
+			printf("ERROR: join %d matched %d rows\n", i, matched);
+			break;
+		}
+	}
+	printf("join   %-8s %4d rows %4d ops: %8lu us\n", g_relational_name[mode], ROWS, i, (unsigned long)arastorage_bench_elapsed_us(&start));
+	return i == QUERIES ? OK : ERROR;
+}
+
+static int arastorage_bench_create_load(void)
+{
+	db_exec("REMOVE RELATION " LOAD_RELATION ";");
+	if (DB_ERROR(db_exec("CREATE RELATION " LOAD_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE id DOMAIN INT IN " LOAD_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE value DOMAIN LONG IN " LOAD_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE INDEX " LOAD_RELATION ".id TYPE BPLUSTREE;"))) {
+		printf("ERROR: failed to create relation %s\n", LOAD_RELATION);
+		return ERROR;
+	}
+	return OK;
+}
+
+/* Each load runs in its own session, so that the bytes written include the
+ * index nodes and buckets which stay cached until db_deinit().
+ */
+static int arastorage_bench_load(int mode)
+{
+	struct timespec start;
+	db_stmt_t *stmt;
+	db_result_t res;
+	unsigned long written;
+	uint32_t usec;
+	long value;
+	int id;
+	int i;
+
+	if (DB_ERROR(db_init())) {
+		printf("ERROR: db_init failed\n");
+		return ERROR;
+	}
+	if (arastorage_bench_create_load() != OK) {
+		db_deinit();
+		return ERROR;
+	}
+
+	stmt = db_prepare("INSERT (?, ?) INTO " LOAD_RELATION ";");
+	if (stmt == NULL) {
+		printf("ERROR: db_prepare failed\n");
+		db_deinit();
+		return ERROR;
+	}
+
+	written = db_get_written_bytes();
+	clock_gettime(CLOCK_REALTIME, &start);
+	res = DB_OK;
+	if (mode == LOAD_BULK) {
+		res = db_bulk_begin(LOAD_RELATION);
+	}
+	for (i = 0; i < ROWS && DB_SUCCESS(res); i++) {
+		/* Keys arrive out of order, as they would from an import */
+		id = i * 37 % ROWS;
+		value = (long)i;
+		db_bind(stmt, 0, DOMAIN_INT, &id);
+		db_bind(stmt, 1, DOMAIN_LONG, &value);
+		res = db_step(stmt, NULL);
+	}
+	if (mode == LOAD_BULK && DB_SUCCESS(res)) {
+		res = db_bulk_end(LOAD_RELATION);
+	}
+	db_finalize(stmt);
+	db_deinit();
+	usec = arastorage_bench_elapsed_us(&start);
+	written = db_get_written_bytes() - written;
+
+	if (DB_ERROR(res)) {
+		printf("ERROR: %s load failed: %s\n", g_load_name[mode], db_get_result_message(res));
+		return ERROR;
+	}
+	if (usec == 0) {
+		usec = 1;
+	}
+	printf("load   %-8s %4d rows: %8lu us, %6lu rows/s, %8lu bytes written\n", g_load_name[mode], ROWS, (unsigned long)usec, (unsigned long)(((uint64_t)ROWS * 1000000) / usec), written);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int arastorage_bench_main(int argc, char *argv[])
+#endif
+{
+	int mode;
+
+	if (DB_ERROR(db_init())) {
+		printf("ERROR: db_init failed\n");
+		return ERROR;
+	}
+
+	db_exec("REMOVE RELATION " BENCH_RELATION ";");
+	if (DB_ERROR(db_exec("CREATE RELATION " BENCH_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE id DOMAIN INT IN " BENCH_RELATION ";")) ||
+		DB_ERROR(db_exec("CREATE ATTRIBUTE value DOMAIN LONG IN " BENCH_RELATION ";"))) {
+		printf("ERROR: failed to create relation %s\n", BENCH_RELATION);
+		db_deinit();
+		return ERROR;
+	}
+
+	for (mode = BENCH_TEXT; mode <= BENCH_PREPARED; mode++) {
+		if (arastorage_bench_insert(mode, ROWS * mode) != OK) {
+			break;
+		}
+	}
+
+	for (mode = BENCH_TEXT; mode <= BENCH_PREPARED; mode++) {
+		if (arastorage_bench_select(mode) != OK) {
+			break;
+		}
+	}
+
+	db_exec("REMOVE RELATION " BENCH_RELATION ";");
+
+	if (arastorage_bench_lookup(LOOKUP_SCAN, false) == OK) {
+		for (mode = LOOKUP_BPLUSTREE; mode <= LOOKUP_HASH; mode++) {
+			if (arastorage_bench_lookup(mode, true) != OK ||
+				arastorage_bench_lookup(mode, false) != OK) {
+				break;
+			}
+		}
+	}
+
+	/* Aggregates and a join computed by the engine, then by the application */
+	db_exec("REMOVE RELATION " GROUP_RELATION ";");
+	db_exec("REMOVE RELATION " KIND_RELATION ";");
+	if (arastorage_bench_create_relational() == OK) {
+		for (mode = RELATIONAL_ENGINE; mode <= RELATIONAL_APP; mode++) {
+			if (arastorage_bench_group(mode) != OK) {
+				break;
+			}
+		}
+		for (mode = RELATIONAL_ENGINE; mode <= RELATIONAL_APP; mode++) {
+			if (arastorage_bench_join(mode) != OK) {
+				break;
+			}
+		}
+	}
+	db_exec("REMOVE RELATION " GROUP_RELATION ";");
+	db_exec("REMOVE RELATION " KIND_RELATION ";");
+	db_deinit();
+
+	/* An indexed relation loaded row by row, then with a bulk load */
+	if (arastorage_bench_load(LOAD_ROW) == OK) {
+		arastorage_bench_load(LOAD_BULK);
+	}
+
+	if (DB_SUCCESS(db_init())) {
+		db_exec("REMOVE RELATION " LOAD_RELATION ";");
+		db_deinit();
+	}
+	return OK;
+}
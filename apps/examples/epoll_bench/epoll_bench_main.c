@@ -0,0 +1,266 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_EPOLL_BENCH_ITERATIONS
+#define CONFIG_EXAMPLES_EPOLL_BENCH_ITERATIONS 1000
+#endif
+
+#define ITERATIONS CONFIG_EXAMPLES_EPOLL_BENCH_ITERATIONS
+
+/* The active socket and the socket sending to it are not idle */
+
+#define MAX_IDLE   (CONFIG_NSOCKET_DESCRIPTORS - 2)
+#define NIDLE_MAX  256
+
+#define WAIT_MSEC  1000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum epoll_bench_mode_e {
+	BENCH_POLL = 0,
+	BENCH_EPOLL
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const int g_nidle[] = { 64, 256 };
+
+static int g_idle[NIDLE_MAX];
+static struct pollfd g_pfds[NIDLE_MAX + 1];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t epoll_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+static int epoll_bench_socket(FAR struct sockaddr_in *addr)
+{
+	socklen_t addrlen = sizeof(struct sockaddr_in);
+	int sd;
+
+	sd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sd < 0) {
+		return ERROR;
+	}
+
+	memset(addr, 0, sizeof(struct sockaddr_in));
+	addr->sin_family = AF_INET;
+	addr->sin_port = 0;
+	addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(sd, (FAR struct sockaddr *)addr, addrlen) < 0 || getsockname(sd, (FAR struct sockaddr *)addr, &addrlen) < 0) {
+		close(sd);
+		return ERROR;
+	}
+
+	return sd;
+}
+
+/* Send a datagram to the active socket, wait until it is reported ready
+ * and read it, ITERATIONS times.  The total time in microseconds is
+ * returned in 'usec'.
+ */
+
+static int epoll_bench_run(int mode, int epfd, int active, int sender, FAR const struct sockaddr_in *addr, int nfds, FAR uint32_t *usec)
+{
+	struct epoll_event event;
+	struct timespec start;
+	char buf[4];
+	int ret;
+	int i;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	for (i = 0; i < ITERATIONS; i++) {
+		if (sendto(sender, "ping", 4, 0, (FAR const struct sockaddr *)addr, sizeof(struct sockaddr_in)) != 4) {
+			printf("ERROR: sendto failed: %d\n", errno);
+			return ERROR;
+		}
+
+		if (mode == BENCH_EPOLL) {
+			ret = epoll_wait(epfd, &event, 1, WAIT_MSEC);
+			if (ret == 1 && event.data.fd != active) {
+				ret = 0;
+			}
+		} else {
+			ret = poll(g_pfds, nfds, WAIT_MSEC);
+			if (ret == 1 && g_pfds[nfds - 1].revents == 0) {
+				ret = 0;
+			}
+		}
+
+		if (ret != 1) {
+			printf("ERROR: wait returned %d: %d\n", ret, errno);
+			return ERROR;
+		}
+
+		if (recv(active, buf, sizeof(buf), 0) != 4) {
+			printf("ERROR: recv failed: %d\n", errno);
+			return ERROR;
+		}
+	}
+
+	*usec = epoll_bench_elapsed(&start);
+	return OK;
+}
+
+static void epoll_bench_measure(int nidle, int active, int sender, FAR const struct sockaddr_in *addr)
+{
+	struct epoll_event event;
+	uint32_t pollus = 0;
+	uint32_t epollus = 0;
+	int epfd;
+	int i;
+
+	/* poll() is handed every descriptor on every call */
+
+	for (i = 0; i < nidle; i++) {
+		g_pfds[i].fd = g_idle[i];
+		g_pfds[i].events = POLLIN;
+	}
+
+	g_pfds[nidle].fd = active;
+	g_pfds[nidle].events = POLLIN;
+
+	if (epoll_bench_run(BENCH_POLL, -1, active, sender, addr, nidle + 1, &pollus) < 0) {
+		return;
+	}
+
+	/* epoll registers every descriptor once */
+
+	epfd = epoll_create1(0);
+	if (epfd < 0) {
+		printf("ERROR: epoll_create1 failed: %d\n", errno);
+		return;
+	}
+
+	for (i = 0; i <= nidle; i++) {
+		event.events = EPOLLIN;
+		event.data.fd = g_pfds[i].fd;
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, g_pfds[i].fd, &event) < 0) {
+			printf("ERROR: epoll_ctl failed: %d\n", errno);
+			close(epfd);
+			return;
+		}
+	}
+
+	if (epoll_bench_run(BENCH_EPOLL, epfd, active, sender, addr, 0, &epollus) == OK) {
+		printf("%3d idle sockets: poll %lu us, epoll_wait %lu us per wakeup\n", nidle, (unsigned long)(pollus / ITERATIONS), (unsigned long)(epollus / ITERATIONS));
+	}
+
+	for (i = 0; i <= nidle; i++) {
+		(void)epoll_ctl(epfd, EPOLL_CTL_DEL, g_pfds[i].fd, NULL);
+	}
+
+	close(epfd);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int epoll_bench_main(int argc, char *argv[])
+#endif
+{
+	struct sockaddr_in addr;
+	struct sockaddr_in idleaddr;
+	int nopen = 0;
+	int active;
+	int sender;
+	int nidle;
+	int i;
+
+	active = epoll_bench_socket(&addr);
+	sender = epoll_bench_socket(&idleaddr);
+	if (active < 0 || sender < 0) {
+		printf("ERROR: failed to create the loopback sockets: %d\n", errno);
+		goto done;
+	}
+
+	for (i = 0; i < sizeof(g_nidle) / sizeof(g_nidle[0]); i++) {
+		nidle = g_nidle[i];
+		if (nidle > MAX_IDLE) {
+			printf("%3d idle sockets: skipped, CONFIG_NSOCKET_DESCRIPTORS is %d\n", nidle, CONFIG_NSOCKET_DESCRIPTORS);
+			continue;
+		}
+
+		while (nopen < nidle) {
+			g_idle[nopen] = epoll_bench_socket(&idleaddr);
+			if (g_idle[nopen] < 0) {
+				printf("ERROR: failed to create idle socket %d: %d\n", nopen, errno);
+				goto done;
+			}
+
+			nopen++;
+		}
+
+		epoll_bench_measure(nidle, active, sender, &addr);
+	}
+
+done:
+	while (nopen > 0) {
+		close(g_idle[--nopen]);
+	}
+
+	if (sender >= 0) {
+		close(sender);
+	}
+
+	if (active >= 0) {
+		close(active);
+	}
+
+	return OK;
+}
@@ -63,6 +63,7 @@
 
 #define EXEC_NORMAL   0
 #define EXEC_INFINITE 1
+#define EXEC_PERF     2
 
 static volatile bool inf_flag;
 static volatile bool is_running;
@@ -134,11 +135,11 @@ int messaging_main(int argc, char *argv[])
 	char *cnt_arg = NULL;
 	int execution_type = EXEC_NORMAL;
 
-	if (argc >= 4 || argc == 2) {
+	if (argc >= 4 || (argc == 2 && strncmp(argv[1], "-p", strlen("-p") + 1) != 0)) {
 		goto usage;
 	}
 
-	while ((option = getopt(argc, argv, "r:n:")) != ERROR) {
+	while ((option = getopt(argc, argv, "r:n:p")) != ERROR) {
 		switch (option) {
 		case 'r':
 			execution_type = EXEC_INFINITE;
@@ -148,6 +149,9 @@ int messaging_main(int argc, char *argv[])
 			execution_type = EXEC_NORMAL;
 			cnt_arg = optarg;
 			break;
+		case 'p':
+			execution_type = EXEC_PERF;
+			break;
 		case '?':
 		default:
 			goto usage;
@@ -172,6 +176,13 @@ int messaging_main(int argc, char *argv[])
 			goto usage;
 		}
 
+	} else if (execution_type == EXEC_PERF) {
+		if (is_running) {
+			goto already_running;
+		}
+		is_running = true;
+		messaging_perf_sample();
+		is_running = false;
 	} else {
 		if (is_running) {
 			goto already_running;
@@ -196,6 +207,7 @@ usage:
 	printf(" -r start : Execute messaging sample infinitely until stop cmd.\n");
 	printf("    stop  : Stop the messaging sample infinite execution.\n");
 	printf(" -n COUNT : Execute messaging sample COUNT-iterations.\n");
+	printf(" -p       : Measure the round trip time of sync messages by message size.\n");
 	return -1;
 already_running:
 	printf("There is already running Messaging Sample.\n");
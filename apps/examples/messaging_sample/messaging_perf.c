@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+
+#define PERF_PORT "perf_port"
+#define PERF_ITERATION 1000
+#define PERF_MIN_SIZE 16
+
+/* A message and the header which messaging adds to it must fit in a message of the mqueue. */
+#define PERF_HEADER_SIZE 16
+#define PERF_MAX_SIZE (CONFIG_MQ_MAXMSGSIZE - PERF_HEADER_SIZE)
+
+#define MSG_PRIO 10
+#define TASK_PRIO 100
+#define STACKSIZE 2048
+
+extern int fail_cnt;
+static volatile bool perf_done;
+
+static void perf_echo_callback(msg_reply_type_t msg_type, msg_recv_buf_t *recv_data, void *cb_data)
+{
+	int msglen;
+	msg_send_data_t reply_data;
+
+	if (msg_type != MSG_REPLY_REQUIRED) {
+		return;
+	}
+
+	/* The sender puts the length of the message at its beginning. */
+	memcpy(&msglen, recv_data->buf, sizeof(int));
+	reply_data.msg = recv_data->buf;
+	reply_data.msglen = msglen;
+	reply_data.priority = MSG_PRIO;
+	if (messaging_reply(PERF_PORT, recv_data->sender_pid, &reply_data) != OK) {
+		printf("Fail to reply to the perf sender.\n");
+	}
+}
+
+static int perf_echo_recv(int argc, FAR char *argv[])
+{
+	int ret;
+	msg_callback_info_t cb_info;
+	msg_recv_buf_t data;
+
+	data.buf = (char *)malloc(PERF_MAX_SIZE);
+	if (data.buf == NULL) {
+		fail_cnt++;
+		printf("Fail to recv perf message : out of memory.\n");
+		return ERROR;
+	}
+	data.buflen = PERF_MAX_SIZE;
+
+	cb_info.cb_func = perf_echo_callback;
+	cb_info.cb_data = NULL;
+
+	ret = messaging_recv_nonblock(PERF_PORT, &data, &cb_info);
+	if (ret != OK) {
+		fail_cnt++;
+		printf("Fail to receive perf message with non-block mode.\n");
+		free(data.buf);
+		return ERROR;
+	}
+
+	/* Messages are echoed from the callback until the sender is done. */
+	while (!perf_done) {
+		usleep(100000);
+	}
+
+	(void)messaging_cleanup(PERF_PORT);
+	free(data.buf);
+	return OK;
+}
+
+static int perf_measure(char *msg, char *reply, int msglen)
+{
+	int ret;
+	int iter;
+	struct timespec start;
+	struct timespec end;
+	long elapsed_us;
+	msg_send_data_t send_data;
+	msg_recv_buf_t reply_data;
+
+	memset(msg, 0x5a, msglen);
+	memcpy(msg, &msglen, sizeof(int));
+
+	send_data.msg = msg;
+	send_data.msglen = msglen;
+	send_data.priority = MSG_PRIO;
+	reply_data.buf = reply;
+	reply_data.buflen = PERF_MAX_SIZE;
+
+	clock_gettime(CLOCK_REALTIME, &start);
+	for (iter = 0; iter < PERF_ITERATION; iter++) {
+		ret = messaging_send_sync(PERF_PORT, &send_data, &reply_data);
+		if (ret != OK) {
+			printf("Fail to sync send perf message of %d bytes.\n", msglen);
+			return ERROR;
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &end);
+
+	if (memcmp(msg, reply, msglen) != 0) {
+		printf("The reply of %d bytes is not the same as the message.\n", msglen);
+		return ERROR;
+	}
+
+	elapsed_us = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+	if (elapsed_us <= 0) {
+		elapsed_us = 1;
+	}
+
+	/* Each round trip carries the message to the receiver and back. */
+	printf("%8d %12ld %12lld\n", msglen, elapsed_us / PERF_ITERATION, (long long)2 * msglen * PERF_ITERATION * 1000000 / elapsed_us / 1024);
+	return OK;
+}
+
+/****************************************************************************
+ * Name : messaging_perf_sample
+ *
+ * Description:
+ *  Measures the round trip latency and the throughput of sync messages for
+ *  message sizes from PERF_MIN_SIZE bytes to the largest one which fits in
+ *  a message queue.
+ ****************************************************************************/
+void messaging_perf_sample(void)
+{
+	int receiver_pid;
+	int msglen;
+	char *msg;
+	char *reply;
+
+	printf("\n--- Start the Sync messaging performance test. ---\n");
+
+	if (PERF_MAX_SIZE < PERF_MIN_SIZE) {
+		fail_cnt++;
+		printf("CONFIG_MQ_MAXMSGSIZE is too small for the perf test.\n");
+		return;
+	}
+
+	msg = (char *)malloc(PERF_MAX_SIZE);
+	reply = (char *)malloc(PERF_MAX_SIZE);
+	if (msg == NULL || reply == NULL) {
+		fail_cnt++;
+		printf("Fail to run the perf test : out of memory.\n");
+		free(msg);
+		free(reply);
+		return;
+	}
+
+	perf_done = false;
+	receiver_pid = task_create("perf_echo_recv", TASK_PRIO, STACKSIZE, perf_echo_recv, NULL);
+	if (receiver_pid < 0) {
+		fail_cnt++;
+		printf("Fail to create perf_echo_recv task.\n");
+		free(msg);
+		free(reply);
+		return;
+	}
+
+	/* Wait for the receiver to be ready. */
+	sleep(1);
+
+	printf("%8s %12s %12s\n", "bytes", "us/round", "KB/s");
+	msglen = PERF_MIN_SIZE;
+	while (true) {
+		if (perf_measure(msg, reply, msglen) != OK) {
+			fail_cnt++;
+			break;
+		}
+		if (msglen == PERF_MAX_SIZE) {
+			break;
+		}
+		msglen *= 2;
+		if (msglen > PERF_MAX_SIZE) {
+			msglen = PERF_MAX_SIZE;
+		}
+	}
+
+	/* Close the queues which were kept open for sending to the port. */
+	(void)messaging_cleanup(PERF_PORT);
+
+	perf_done = true;
+
+	/* Wait for finishing perf_echo_recv task. */
+	sleep(1);
+
+	free(msg);
+	free(reply);
+}
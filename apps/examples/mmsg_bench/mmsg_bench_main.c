@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_MMSG_BENCH_DATAGRAMS
+#define CONFIG_EXAMPLES_MMSG_BENCH_DATAGRAMS 10000
+#endif
+
+#ifndef CONFIG_EXAMPLES_MMSG_BENCH_BURST
+#define CONFIG_EXAMPLES_MMSG_BENCH_BURST 8
+#endif
+
+#define DATAGRAMS CONFIG_EXAMPLES_MMSG_BENCH_DATAGRAMS
+#define BURST     CONFIG_EXAMPLES_MMSG_BENCH_BURST
+#define DGRAM_LEN 64
+
+/* A lost datagram must not stall the measurement */
+
+#define RECV_TIMEOUT_MSEC 100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum mmsg_bench_mode_e {
+	BENCH_SINGLE = 0,
+	BENCH_MMSG
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_txbuf[DGRAM_LEN];
+static uint8_t g_rxbuf[BURST][DGRAM_LEN];
+static struct iovec g_txiov[BURST];
+static struct iovec g_rxiov[BURST];
+static struct mmsghdr g_txmsg[BURST];
+static struct mmsghdr g_rxmsg[BURST];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t mmsg_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+static int mmsg_bench_socket(FAR struct sockaddr_in *addr)
+{
+	socklen_t addrlen = sizeof(struct sockaddr_in);
+	struct timeval tv;
+	int sd;
+
+	sd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sd < 0) {
+		return ERROR;
+	}
+
+	memset(addr, 0, sizeof(struct sockaddr_in));
+	addr->sin_family = AF_INET;
+	addr->sin_port = 0;
+	addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	tv.tv_sec = 0;
+	tv.tv_usec = RECV_TIMEOUT_MSEC * 1000;
+
+	if (bind(sd, (FAR struct sockaddr *)addr, addrlen) < 0 || getsockname(sd, (FAR struct sockaddr *)addr, &addrlen) < 0 || setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
+		close(sd);
+		return ERROR;
+	}
+
+	return sd;
+}
+
+static void mmsg_bench_setup(FAR const struct sockaddr_in *addr)
+{
+	int i;
+
+	memset(g_txbuf, 0x5a, sizeof(g_txbuf));
+	memset(g_txmsg, 0, sizeof(g_txmsg));
+	memset(g_rxmsg, 0, sizeof(g_rxmsg));
+
+	for (i = 0; i < BURST; i++) {
+		g_txiov[i].iov_base = g_txbuf;
+		g_txiov[i].iov_len = DGRAM_LEN;
+		g_txmsg[i].msg_hdr.msg_name = (FAR void *)addr;
+		g_txmsg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+		g_txmsg[i].msg_hdr.msg_iov = &g_txiov[i];
+		g_txmsg[i].msg_hdr.msg_iovlen = 1;
+
+		g_rxiov[i].iov_base = g_rxbuf[i];
+		g_rxiov[i].iov_len = DGRAM_LEN;
+		g_rxmsg[i].msg_hdr.msg_iov = &g_rxiov[i];
+		g_rxmsg[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+/* Send DATAGRAMS datagrams in bursts of BURST and receive each burst
+ * before sending the next.  The number of datagrams received and the
+ * elapsed time in microseconds are returned.
+ */
+
+static int mmsg_bench_run(int mode, int rxsd, int txsd, FAR const struct sockaddr_in *addr, FAR uint32_t *received, FAR uint32_t *usec)
+{
+	struct timespec start;
+	uint32_t sent = 0;
+	int burst;
+	int ret;
+	int i;
+
+	*received = 0;
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	while (sent < DATAGRAMS) {
+		burst = (DATAGRAMS - sent < BURST) ? DATAGRAMS - sent : BURST;
+
+		if (mode == BENCH_MMSG) {
+			ret = sendmmsg(txsd, g_txmsg, burst, 0);
+			if (ret != burst) {
+				printf("ERROR: sendmmsg returned %d: %d\n", ret, errno);
+				return ERROR;
+			}
+		} else {
+			for (i = 0; i < burst; i++) {
+				if (sendto(txsd, g_txbuf, DGRAM_LEN, 0, (FAR const struct sockaddr *)addr, sizeof(struct sockaddr_in)) != DGRAM_LEN) {
+					printf("ERROR: sendto failed: %d\n", errno);
+					return ERROR;
+				}
+			}
+		}
+
+		sent += burst;
+
+		/* Receive the burst; a timeout means the rest of it was dropped */
+
+		i = 0;
+		while (i < burst) {
+			if (mode == BENCH_MMSG) {
+				ret = recvmmsg(rxsd, g_rxmsg, burst - i, 0, NULL);
+			} else {
+				ret = recv(rxsd, g_rxbuf[0], DGRAM_LEN, 0) == DGRAM_LEN ? 1 : -1;
+			}
+
+			if (ret <= 0) {
+				break;
+			}
+
+			i += ret;
+		}
+
+		*received += i;
+	}
+
+	*usec = mmsg_bench_elapsed(&start);
+	return OK;
+}
+
+static void mmsg_bench_report(FAR const char *name, uint32_t received, uint32_t usec)
+{
+	uint32_t rate = usec > 0 ? (uint32_t)((uint64_t)received * 1000000 / usec) : 0;
+
+	printf("%-18s %lu of %d datagrams in %lu us: %lu datagrams/s\n", name, (unsigned long)received, DATAGRAMS, (unsigned long)usec, (unsigned long)rate);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int mmsg_bench_main(int argc, char *argv[])
+#endif
+{
+	struct sockaddr_in rxaddr;
+	struct sockaddr_in txaddr;
+	uint32_t received;
+	uint32_t usec;
+	int rxsd;
+	int txsd;
+
+	rxsd = mmsg_bench_socket(&rxaddr);
+	txsd = mmsg_bench_socket(&txaddr);
+	if (rxsd < 0 || txsd < 0) {
+		printf("ERROR: failed to create the loopback sockets: %d\n", errno);
+		goto done;
+	}
+
+	mmsg_bench_setup(&rxaddr);
+	printf("%d byte datagrams in bursts of %d\n", DGRAM_LEN, BURST);
+
+	if (mmsg_bench_run(BENCH_SINGLE, rxsd, txsd, &rxaddr, &received, &usec) == OK) {
+		mmsg_bench_report("sendto/recv:", received, usec);
+	}
+
+	if (mmsg_bench_run(BENCH_MMSG, rxsd, txsd, &rxaddr, &received, &usec) == OK) {
+		mmsg_bench_report("sendmmsg/recvmmsg:", received, usec);
+	}
+
+done:
+	if (txsd >= 0) {
+		close(txsd);
+	}
+
+	if (rxsd >= 0) {
+		close(rxsd);
+	}
+
+	return OK;
+}
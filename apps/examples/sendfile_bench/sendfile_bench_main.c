@@ -0,0 +1,304 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mount.h>
+#include <sys/sendfile.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_SENDFILE_BENCH_FILESIZE
+#define CONFIG_EXAMPLES_SENDFILE_BENCH_FILESIZE 32
+#endif
+
+#ifndef CONFIG_EXAMPLES_SENDFILE_BENCH_ROUNDS
+#define CONFIG_EXAMPLES_SENDFILE_BENCH_ROUNDS 64
+#endif
+
+#ifndef CONFIG_EXAMPLES_SENDFILE_BENCH_BUFSIZE
+#define CONFIG_EXAMPLES_SENDFILE_BENCH_BUFSIZE 1460
+#endif
+
+#define FILESIZE ((off_t)CONFIG_EXAMPLES_SENDFILE_BENCH_FILESIZE * 1024)
+#define ROUNDS   CONFIG_EXAMPLES_SENDFILE_BENCH_ROUNDS
+#define BUFSIZE  CONFIG_EXAMPLES_SENDFILE_BENCH_BUFSIZE
+
+#define SENDFILE_BENCH_MOUNTPOINT "/sendfile_bench"
+#define SENDFILE_BENCH_FILEPATH   SENDFILE_BENCH_MOUNTPOINT "/data"
+#define SENDFILE_BENCH_PORT       5018
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_srvbuf[BUFSIZE];
+static uint8_t g_clibuf[BUFSIZE];
+static int g_listensd = -1;
+static uint32_t g_total;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t sendfile_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+/* The server side: sink g_total bytes, then acknowledge them */
+
+static FAR void *sendfile_bench_server(FAR void *arg)
+{
+	uint32_t received = 0;
+	ssize_t ret;
+	int sd;
+
+	sd = accept(g_listensd, NULL, NULL);
+	if (sd < 0) {
+		printf("ERROR: accept failed: %d\n", errno);
+		return NULL;
+	}
+
+	while (received < g_total) {
+		ret = recv(sd, g_srvbuf, BUFSIZE, 0);
+		if (ret <= 0) {
+			printf("ERROR: recv failed: %d\n", errno);
+			goto done;
+		}
+
+		received += ret;
+	}
+
+	(void)send(sd, g_srvbuf, 1, 0);
+
+done:
+	close(sd);
+	return NULL;
+}
+
+/* Send the whole file once, either through a user buffer or with sendfile() */
+
+static int sendfile_bench_file(int sd, int fd, off_t size, bool usesendfile)
+{
+	off_t offset = 0;
+	ssize_t nread;
+	ssize_t ret;
+	size_t done;
+
+	if (usesendfile) {
+		while (offset < size) {
+			ret = sendfile(sd, fd, &offset, size - offset);
+			if (ret <= 0) {
+				return ERROR;
+			}
+		}
+
+		return OK;
+	}
+
+	if (lseek(fd, 0, SEEK_SET) != 0) {
+		return ERROR;
+	}
+
+	while ((nread = read(fd, g_clibuf, BUFSIZE)) > 0) {
+		for (done = 0; done < (size_t)nread; done += ret) {
+			ret = send(sd, g_clibuf + done, nread - done, 0);
+			if (ret <= 0) {
+				return ERROR;
+			}
+		}
+	}
+
+	return nread == 0 ? OK : ERROR;
+}
+
+/* Time ROUNDS transfers of the file over a fresh loopback connection */
+
+static int sendfile_bench_run(FAR struct sockaddr_in *addr, int fd, off_t size, bool usesendfile)
+{
+	struct timespec start;
+	pthread_t server;
+	uint32_t usec;
+	int sd;
+	int ret = ERROR;
+	int i;
+
+	g_total = (uint32_t)size * ROUNDS;
+
+	if (pthread_create(&server, NULL, sendfile_bench_server, NULL) != 0) {
+		printf("ERROR: pthread_create failed\n");
+		return ERROR;
+	}
+
+	sd = socket(AF_INET, SOCK_STREAM, 0);
+	if (sd < 0 || connect(sd, (FAR struct sockaddr *)addr, sizeof(*addr)) < 0) {
+		printf("ERROR: connect failed: %d\n", errno);
+		if (sd >= 0) {
+			close(sd);
+		}
+
+		/* The server is still waiting in accept() */
+
+		pthread_cancel(server);
+		pthread_join(server, NULL);
+		return ERROR;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	for (i = 0; i < ROUNDS; i++) {
+		if (sendfile_bench_file(sd, fd, size, usesendfile) != OK) {
+			printf("ERROR: %s failed: %d\n", usesendfile ? "sendfile" : "read/send", errno);
+			goto done;
+		}
+	}
+
+	if (recv(sd, g_clibuf, 1, 0) != 1) {
+		printf("ERROR: recv failed: %d\n", errno);
+		goto done;
+	}
+
+	usec = sendfile_bench_elapsed(&start);
+	printf("%-9s: %lu bytes in %lu us: %lu KB/s\n", usesendfile ? "sendfile" : "read/send", (unsigned long)g_total, (unsigned long)usec, usec > 0 ? (unsigned long)((uint64_t)g_total * 1000000 / 1024 / usec) : 0UL);
+	ret = OK;
+
+done:
+	close(sd);
+	pthread_join(server, NULL);
+	return ret;
+}
+
+static int sendfile_bench_create(void)
+{
+	off_t written;
+	int fd;
+
+	if (mount(NULL, SENDFILE_BENCH_MOUNTPOINT, "tmpfs", 0, NULL) < 0 && errno != EEXIST) {
+		printf("ERROR: mount failed: %d\n", errno);
+		return ERROR;
+	}
+
+	fd = open(SENDFILE_BENCH_FILEPATH, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0) {
+		printf("ERROR: open failed: %d\n", errno);
+		return ERROR;
+	}
+
+	memset(g_clibuf, 0xa5, sizeof(g_clibuf));
+	for (written = 0; written < FILESIZE; written += BUFSIZE) {
+		if (write(fd, g_clibuf, FILESIZE - written < BUFSIZE ? FILESIZE - written : BUFSIZE) <= 0) {
+			printf("ERROR: write failed: %d\n", errno);
+			close(fd);
+			return ERROR;
+		}
+	}
+
+	close(fd);
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int sendfile_bench_main(int argc, char *argv[])
+#endif
+{
+	struct sockaddr_in addr;
+	FAR const char *path = SENDFILE_BENCH_FILEPATH;
+	struct stat st;
+	int fd;
+
+	/* Benchmark a given file, or create one on tmpfs */
+
+	if (argc > 1) {
+		path = argv[1];
+	} else if (sendfile_bench_create() != OK) {
+		return ERROR;
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0 || st.st_size == 0) {
+		printf("ERROR: cannot use %s: %d\n", path, errno);
+		goto errout_with_file;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SENDFILE_BENCH_PORT);
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+	g_listensd = socket(AF_INET, SOCK_STREAM, 0);
+	if (g_listensd < 0) {
+		printf("ERROR: socket failed: %d\n", errno);
+		goto errout_with_file;
+	}
+
+	if (bind(g_listensd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(g_listensd, 1) < 0) {
+		printf("ERROR: bind/listen failed: %d\n", errno);
+		goto errout_with_socket;
+	}
+
+	printf("%s: %lu bytes x %d over loopback TCP, %d byte read/send buffer\n", path, (unsigned long)st.st_size, ROUNDS, BUFSIZE);
+
+	if (sendfile_bench_run(&addr, fd, st.st_size, false) == OK) {
+		(void)sendfile_bench_run(&addr, fd, st.st_size, true);
+	}
+
+errout_with_socket:
+	close(g_listensd);
+
+errout_with_file:
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	if (argc <= 1) {
+		unlink(SENDFILE_BENCH_FILEPATH);
+		umount(SENDFILE_BENCH_MOUNTPOINT);
+	}
+
+	return OK;
+}
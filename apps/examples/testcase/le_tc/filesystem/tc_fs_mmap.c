@@ -0,0 +1,441 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_fs_mmap.c
+
+/// @brief Test Case for read-only mmap() of tmpfs and XIP ROMFS files
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <tinyara/fs/ramdisk.h>
+#include "tc_common.h"
+#include "tc_internal.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+#define MMAP_TMPFS_MOUNTPOINT "/mmap_tmpfs"
+#define MMAP_TMPFS_FILEPATH MMAP_TMPFS_MOUNTPOINT"/mmap"
+#define MMAP_TMPFS_CONTENTS "THIS IS MMAP ON TMPFS"
+
+#define MMAP_ROMFS_MINOR 3
+#define MMAP_ROMFS_DEVPATH "/dev/ram3"
+#define MMAP_ROMFS_MOUNTPOINT "/mmap_rom"
+#define MMAP_ROMFS_FILEPATH MMAP_ROMFS_MOUNTPOINT"/mmap.txt"
+#define MMAP_ROMFS_CONTENTS "THIS IS MMAP ON XIP ROMFS\n"
+#define MMAP_ROMFS_SECTSIZE 512
+
+#define MMAP_SMARTFS_MOUNTPOINT "/mmap_smartfs"
+#define MMAP_SMARTFS_FILEPATH MMAP_SMARTFS_MOUNTPOINT"/mmap"
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+#define MMAP_SMARTFS_DEVPATH TMP_MOUNT_DEV_DIR"d1"
+#else
+#define MMAP_SMARTFS_DEVPATH TMP_MOUNT_DEV_DIR
+#endif
+
+#define MMAP_TASK_STACKSIZE 2048
+
+/* A one-sector ROMFS image holding only /mmap.txt with MMAP_ROMFS_CONTENTS.
+ * A RAM disk reports its buffer as XIP base, so ROMFS maps the file right
+ * inside this array.
+ */
+
+static const unsigned char g_mmap_romfs_img[MMAP_ROMFS_SECTSIZE] = {
+	0x2d, 0x72, 0x6f, 0x6d, 0x31, 0x66, 0x73, 0x2d, 0x00, 0x00, 0x02, 0x00,
+	0xdf, 0x83, 0x7d, 0x39, 0x6d, 0x6d, 0x61, 0x70, 0x74, 0x65, 0x73, 0x74,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1a, 0x64, 0x1e, 0x26, 0x00,
+	0x6d, 0x6d, 0x61, 0x70, 0x2e, 0x74, 0x78, 0x74, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x54, 0x48, 0x49, 0x53, 0x20, 0x49, 0x53, 0x20,
+	0x4d, 0x4d, 0x41, 0x50, 0x20, 0x4f, 0x4e, 0x20, 0x58, 0x49, 0x50, 0x20,
+	0x52, 0x4f, 0x4d, 0x46, 0x53, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+#ifdef CONFIG_SCHED_WAITPID
+static int g_mmap_task_result;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int mmap_tmpfs_create(void)
+{
+	int fd;
+	ssize_t nwritten;
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0) {
+		return ERROR;
+	}
+
+	nwritten = write(fd, MMAP_TMPFS_CONTENTS, strlen(MMAP_TMPFS_CONTENTS));
+	close(fd);
+
+	return nwritten == (ssize_t)strlen(MMAP_TMPFS_CONTENTS) ? OK : ERROR;
+}
+
+/**
+* @testcase         tc_fs_mmap_tmpfs_p
+* @brief            Map a tmpfs file and read it back through the mapping
+* @scenario         Map the whole file and a part at a non-zero offset, compare
+*                   both with the written data and unmap them
+* @apicovered       mmap, munmap
+* @precondition     tmpfs is mounted at MMAP_TMPFS_MOUNTPOINT
+* @postcondition    NA
+*/
+static void tc_fs_mmap_tmpfs_p(void)
+{
+	size_t len = strlen(MMAP_TMPFS_CONTENTS);
+	char *addr;
+	char *part;
+	int fd;
+	int ret;
+
+	ret = mmap_tmpfs_create();
+	TC_ASSERT_EQ("mmap_tmpfs_create", ret, OK);
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ("open", fd, 0);
+
+	addr = (char *)mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	TC_ASSERT_NEQ_CLEANUP("mmap", addr, MAP_FAILED, close(fd));
+	TC_ASSERT_EQ_CLEANUP("mmap", memcmp(addr, MMAP_TMPFS_CONTENTS, len), 0, munmap(addr, len); close(fd));
+
+	part = (char *)mmap(NULL, len - 5, PROT_READ, MAP_SHARED, fd, 5);
+	TC_ASSERT_NEQ_CLEANUP("mmap", part, MAP_FAILED, munmap(addr, len); close(fd));
+	TC_ASSERT_EQ_CLEANUP("mmap", part, addr + 5, munmap(part, len - 5); munmap(addr, len); close(fd));
+
+	/* The mappings hold their own reference on the file */
+
+	close(fd);
+	TC_ASSERT_EQ_CLEANUP("mmap", memcmp(part, MMAP_TMPFS_CONTENTS + 5, len - 5), 0, munmap(part, len - 5); munmap(addr, len));
+
+	ret = munmap(part, len - 5);
+	TC_ASSERT_EQ_CLEANUP("munmap", ret, OK, munmap(addr, len));
+	ret = munmap(addr, len);
+	TC_ASSERT_EQ("munmap", ret, OK);
+
+	/* Both are gone now */
+
+	ret = munmap(addr, len);
+	TC_ASSERT_EQ("munmap", ret, ERROR);
+	TC_ASSERT_EQ("munmap", errno, EINVAL);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         tc_fs_mmap_tmpfs_pinned_n
+* @brief            A mapped tmpfs file can neither be truncated nor unlinked
+* @scenario         Map the file, then truncate it through open(O_TRUNC) and
+*                   unlink it; both fail with EBUSY until it is unmapped
+* @apicovered       mmap, munmap, open, unlink
+* @precondition     MMAP_TMPFS_FILEPATH exists
+* @postcondition    MMAP_TMPFS_FILEPATH is removed
+*/
+static void tc_fs_mmap_tmpfs_pinned_n(void)
+{
+	size_t len = strlen(MMAP_TMPFS_CONTENTS);
+	char *addr;
+	int fd;
+	int ret;
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ("open", fd, 0);
+
+	addr = (char *)mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	TC_ASSERT_NEQ("mmap", addr, MAP_FAILED);
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_WRONLY | O_TRUNC);
+	TC_ASSERT_EQ_CLEANUP("open", fd, ERROR, close(fd); munmap(addr, len));
+	TC_ASSERT_EQ_CLEANUP("open", errno, EBUSY, munmap(addr, len));
+
+	ret = unlink(MMAP_TMPFS_FILEPATH);
+	TC_ASSERT_EQ_CLEANUP("unlink", ret, ERROR, munmap(addr, len));
+	TC_ASSERT_EQ_CLEANUP("unlink", errno, EBUSY, munmap(addr, len));
+
+	/* The data is untouched */
+
+	TC_ASSERT_EQ_CLEANUP("mmap", memcmp(addr, MMAP_TMPFS_CONTENTS, len), 0, munmap(addr, len));
+
+	ret = munmap(addr, len);
+	TC_ASSERT_EQ("munmap", ret, OK);
+
+	ret = unlink(MMAP_TMPFS_FILEPATH);
+	TC_ASSERT_EQ("unlink", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         tc_fs_mmap_invalid_args_n
+* @brief            Reject mappings that cannot be provided without an MMU
+* @scenario         Request writable, private, empty, out-of-file and
+*                   write-only mappings and a bad descriptor
+* @apicovered       mmap
+* @precondition     tmpfs is mounted at MMAP_TMPFS_MOUNTPOINT
+* @postcondition    MMAP_TMPFS_FILEPATH is removed
+*/
+static void tc_fs_mmap_invalid_args_n(void)
+{
+	size_t len = strlen(MMAP_TMPFS_CONTENTS);
+	void *addr;
+	int fd;
+	int ret;
+
+	ret = mmap_tmpfs_create();
+	TC_ASSERT_EQ("mmap_tmpfs_create", ret, OK);
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, unlink(MMAP_TMPFS_FILEPATH));
+
+	addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, ENOSYS, goto errout);
+
+	addr = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, ENOSYS, goto errout);
+
+	addr = mmap(NULL, 0, PROT_READ, MAP_SHARED, fd, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, EINVAL, goto errout);
+
+	addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 1);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, ENXIO, goto errout);
+
+	addr = mmap(NULL, len, PROT_READ, MAP_SHARED, -1, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, EBADF, goto errout);
+
+	close(fd);
+	fd = open(MMAP_TMPFS_FILEPATH, O_WRONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, unlink(MMAP_TMPFS_FILEPATH));
+
+	addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, EACCES, goto errout);
+
+	close(fd);
+	ret = unlink(MMAP_TMPFS_FILEPATH);
+	TC_ASSERT_EQ("unlink", ret, OK);
+
+	TC_SUCCESS_RESULT();
+	return;
+
+errout:
+	if (addr != MAP_FAILED) {
+		munmap(addr, len);
+	}
+	close(fd);
+	unlink(MMAP_TMPFS_FILEPATH);
+}
+
+#ifdef CONFIG_SCHED_WAITPID
+static int mmap_exit_task(int argc, char *argv[])
+{
+	void *addr;
+	int fd;
+
+	/* Leave without munmap() and close() */
+
+	fd = open(MMAP_TMPFS_FILEPATH, O_RDONLY);
+	if (fd < 0) {
+		g_mmap_task_result = ERROR;
+		return ERROR;
+	}
+
+	addr = mmap(NULL, strlen(MMAP_TMPFS_CONTENTS), PROT_READ, MAP_SHARED, fd, 0);
+	g_mmap_task_result = addr == MAP_FAILED ? ERROR : OK;
+	return OK;
+}
+
+/**
+* @testcase         tc_fs_mmap_group_exit_p
+* @brief            The mappings of a task group are released when it exits
+* @scenario         A task maps a tmpfs file and exits without unmapping it;
+*                   the file can be unlinked afterwards
+* @apicovered       mmap, task_create, waitpid, unlink
+* @precondition     tmpfs is mounted at MMAP_TMPFS_MOUNTPOINT
+* @postcondition    MMAP_TMPFS_FILEPATH is removed
+*/
+static void tc_fs_mmap_group_exit_p(void)
+{
+	pid_t pid;
+	int status;
+	int ret;
+
+	ret = mmap_tmpfs_create();
+	TC_ASSERT_EQ("mmap_tmpfs_create", ret, OK);
+
+	g_mmap_task_result = ERROR;
+	pid = task_create("tc_mmap_exit", SCHED_PRIORITY_DEFAULT, MMAP_TASK_STACKSIZE, mmap_exit_task, NULL);
+	TC_ASSERT_GT_CLEANUP("task_create", pid, 0, unlink(MMAP_TMPFS_FILEPATH));
+
+	ret = waitpid(pid, &status, 0);
+	TC_ASSERT_EQ_CLEANUP("waitpid", ret, pid, unlink(MMAP_TMPFS_FILEPATH));
+	TC_ASSERT_EQ_CLEANUP("mmap", g_mmap_task_result, OK, unlink(MMAP_TMPFS_FILEPATH));
+
+	/* The mapping left by the task no longer pins the file */
+
+	ret = unlink(MMAP_TMPFS_FILEPATH);
+	TC_ASSERT_EQ("unlink", ret, OK);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+/**
+* @testcase         tc_fs_mmap_romfs_p
+* @brief            Map a file of a ROMFS image in place
+* @scenario         Mount a ROMFS image from a RAM disk, which is XIP, map a
+*                   file and check that the mapping points into the image
+* @apicovered       mmap, munmap
+* @precondition     NA
+* @postcondition    NA
+*/
+static void tc_fs_mmap_romfs_p(void)
+{
+	size_t len = strlen(MMAP_ROMFS_CONTENTS);
+	const unsigned char *addr;
+	int fd;
+	int ret;
+
+	ret = romdisk_register(MMAP_ROMFS_MINOR, (FAR uint8_t *)g_mmap_romfs_img, sizeof(g_mmap_romfs_img) / MMAP_ROMFS_SECTSIZE, MMAP_ROMFS_SECTSIZE);
+	TC_ASSERT_EQ("romdisk_register", ret, OK);
+
+	ret = mount(MMAP_ROMFS_DEVPATH, MMAP_ROMFS_MOUNTPOINT, "romfs", MS_RDONLY, NULL);
+	TC_ASSERT_EQ_CLEANUP("mount", ret, OK, unlink(MMAP_ROMFS_DEVPATH));
+
+	fd = open(MMAP_ROMFS_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, goto errout_with_mount);
+
+	addr = (const unsigned char *)mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	TC_ASSERT_NEQ_CLEANUP("mmap", addr, MAP_FAILED, goto errout_with_mount);
+
+	/* No copy is made: the data is read from the image itself */
+
+	TC_ASSERT_CLEANUP("mmap", addr > g_mmap_romfs_img && addr + len <= g_mmap_romfs_img + sizeof(g_mmap_romfs_img), munmap((void *)addr, len); goto errout_with_mount);
+	TC_ASSERT_EQ_CLEANUP("mmap", memcmp(addr, MMAP_ROMFS_CONTENTS, len), 0, munmap((void *)addr, len); goto errout_with_mount);
+
+	ret = munmap((void *)addr, len);
+	TC_ASSERT_EQ_CLEANUP("munmap", ret, OK, goto errout_with_mount);
+
+	ret = umount(MMAP_ROMFS_MOUNTPOINT);
+	TC_ASSERT_EQ_CLEANUP("umount", ret, OK, unlink(MMAP_ROMFS_DEVPATH));
+
+	ret = unlink(MMAP_ROMFS_DEVPATH);
+	TC_ASSERT_EQ("unlink", ret, OK);
+
+	TC_SUCCESS_RESULT();
+	return;
+
+errout_with_mount:
+	umount(MMAP_ROMFS_MOUNTPOINT);
+	unlink(MMAP_ROMFS_DEVPATH);
+}
+
+#ifdef CONFIG_FS_SMARTFS
+/**
+* @testcase         tc_fs_mmap_unsupported_fs_n
+* @brief            File systems that cannot hand out their data are refused
+* @scenario         Map a non-empty smartfs file, which fails with ENODEV
+* @apicovered       mmap
+* @precondition     The smartfs device TMP_MOUNT_DEV_DIR is formatted
+* @postcondition    NA
+*/
+static void tc_fs_mmap_unsupported_fs_n(void)
+{
+	size_t len = strlen(MMAP_TMPFS_CONTENTS);
+	void *addr;
+	int fd;
+	int ret;
+
+	umount(MMAP_SMARTFS_MOUNTPOINT);
+	ret = mount(MMAP_SMARTFS_DEVPATH, MMAP_SMARTFS_MOUNTPOINT, "smartfs", 0, NULL);
+	TC_ASSERT_EQ("mount", ret, OK);
+
+	fd = open(MMAP_SMARTFS_FILEPATH, O_RDWR | O_CREAT | O_TRUNC);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, umount(MMAP_SMARTFS_MOUNTPOINT));
+
+	ret = write(fd, MMAP_TMPFS_CONTENTS, len);
+	TC_ASSERT_EQ_CLEANUP("write", ret, (int)len, goto errout);
+
+	addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+	TC_ASSERT_EQ_CLEANUP("mmap", addr, MAP_FAILED, munmap(addr, len); goto errout);
+	TC_ASSERT_EQ_CLEANUP("mmap", errno, ENODEV, goto errout);
+
+	close(fd);
+	unlink(MMAP_SMARTFS_FILEPATH);
+	ret = umount(MMAP_SMARTFS_MOUNTPOINT);
+	TC_ASSERT_EQ("umount", ret, OK);
+
+	TC_SUCCESS_RESULT();
+	return;
+
+errout:
+	close(fd);
+	unlink(MMAP_SMARTFS_FILEPATH);
+	umount(MMAP_SMARTFS_MOUNTPOINT);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void tc_fs_mmap_main(void)
+{
+	int ret;
+
+	umount(MMAP_TMPFS_MOUNTPOINT);
+	ret = mount(NULL, MMAP_TMPFS_MOUNTPOINT, "tmpfs", 0, NULL);
+	TC_ASSERT_EQ("mount", ret, OK);
+
+	tc_fs_mmap_tmpfs_p();
+	tc_fs_mmap_tmpfs_pinned_n();
+	tc_fs_mmap_invalid_args_n();
+#ifdef CONFIG_SCHED_WAITPID
+	tc_fs_mmap_group_exit_p();
+#endif
+
+	ret = umount(MMAP_TMPFS_MOUNTPOINT);
+	TC_ASSERT_EQ("umount", ret, OK);
+
+	tc_fs_mmap_romfs_p();
+#ifdef CONFIG_FS_SMARTFS
+	tc_fs_mmap_unsupported_fs_n();
+#endif
+}
@@ -45,6 +45,7 @@ void tc_fs_procfs_main(void);
 void tc_fs_smartfs_procfs_main(void);
 void tc_fs_smartfs_mksmartfs_p(void);
 void tc_fs_smartfs_mksmartfs_invalid_path_n(void);
+void tc_fs_mmap_main(void);
 
 void itc_fs_main(void);
 
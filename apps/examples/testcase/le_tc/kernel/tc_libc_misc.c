@@ -33,6 +33,7 @@
 #include <crc8.h>
 #include <crc16.h>
 #include <crc32.h>
+#include <chksum.h>
 #include "tc_internal.h"
 
 #define BUFF_SIZE 256
@@ -47,6 +48,8 @@
 #define VAL_CRC32_1 2564639436UL
 #define VAL_CRC32_2 450215437UL
 #define VAL_CRC32_3 3051332929UL
+#define VAL_CRC32_CHECK 0xcbf43926UL
+#define CRC_BUFF_SIZE 128
 
 /**
  * @fn                  :tc_libc_misc_crc8
@@ -227,6 +230,125 @@ static void tc_libc_misc_crc32part(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+ * @fn                  :tc_libc_misc_crc32_align
+ * @brief               :Check the word-at-a-time crc32 against a bitwise reference
+ * @scenario            :Compute crc32 of buffers of every length up to CRC_BUFF_SIZE starting
+ *                       at every alignment from 0 to 7, and of the standard "123456789" check string
+ * @API's covered       :crc32, crc32part
+ * @Preconditions       :None
+ * @Postconditions      :None
+ * @Return              :void
+ */
+static uint32_t tc_libc_misc_crc32_ref(const uint8_t *src, size_t len)
+{
+	uint32_t crc = 0xffffffff;
+	int bit;
+
+	while (len-- > 0) {
+		crc ^= *src++;
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+		}
+	}
+
+	return ~crc;
+}
+
+static void tc_libc_misc_crc32_align(void)
+{
+	static uint8_t buf[CRC_BUFF_SIZE + 8];
+	uint32_t ret_chk;
+	uint32_t ref;
+	size_t align;
+	size_t len;
+	size_t i;
+
+	ret_chk = crc32((const uint8_t *)"123456789", 9);
+	TC_ASSERT_EQ("crc32", ret_chk, (uint32_t)VAL_CRC32_CHECK);
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	for (align = 0; align < 8; align++) {
+		for (len = 0; len <= CRC_BUFF_SIZE; len++) {
+			ref = tc_libc_misc_crc32_ref(buf + align, len);
+			ret_chk = crc32(buf + align, len);
+			TC_ASSERT_EQ("crc32", ret_chk, ref);
+
+			/* Splitting the buffer must not change the result */
+
+			ret_chk = crc32part(buf + align + len / 3, len - len / 3, crc32(buf + align, len / 3));
+			TC_ASSERT_EQ("crc32part", ret_chk, ref);
+		}
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+ * @fn                  :tc_libc_misc_chksum16
+ * @brief               :Return the 16-bit one's complement sum of a buffer
+ * @scenario            :Compare chksum16 with a bytewise RFC 1071 sum for every length up to
+ *                       CRC_BUFF_SIZE starting at every alignment from 0 to 7
+ * @API's covered       :chksum16
+ * @Preconditions       :None
+ * @Postconditions      :None
+ * @Return              :void
+ */
+static uint16_t tc_libc_misc_chksum16_ref(const uint8_t *src, size_t len)
+{
+	uint32_t sum = 0;
+	uint8_t net[2];
+	uint16_t host;
+	size_t i;
+
+	/* Sum in network order, then convert the result to host order */
+
+	for (i = 0; i + 1 < len; i += 2) {
+		sum += ((uint32_t)src[i] << 8) | src[i + 1];
+	}
+
+	if (i < len) {
+		sum += (uint32_t)src[i] << 8;
+	}
+
+	while ((sum >> 16) != 0) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	net[0] = (uint8_t)(sum >> 8);
+	net[1] = (uint8_t)sum;
+	memcpy(&host, net, sizeof(host));
+
+	return host;
+}
+
+static void tc_libc_misc_chksum16(void)
+{
+	static uint8_t buf[CRC_BUFF_SIZE + 8];
+	uint16_t ret_chk;
+	size_t align;
+	size_t len;
+	size_t i;
+
+	/* Use large byte values so that the sum carries */
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(0xff - i * 3);
+	}
+
+	for (align = 0; align < 8; align++) {
+		for (len = 0; len <= CRC_BUFF_SIZE; len++) {
+			ret_chk = chksum16(buf + align, len);
+			TC_ASSERT_EQ("chksum16", ret_chk, tc_libc_misc_chksum16_ref(buf + align, len));
+		}
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
 #ifdef CONFIG_DEBUG
 #ifdef CONFIG_DEBUG_ERROR
 /**
@@ -441,6 +563,8 @@ int libc_misc_main(void)
 	tc_libc_misc_crc16part();
 	tc_libc_misc_crc32();
 	tc_libc_misc_crc32part();
+	tc_libc_misc_crc32_align();
+	tc_libc_misc_chksum16();
 #ifdef CONFIG_DEBUG
 #ifdef CONFIG_DEBUG_ERROR
 	tc_libc_misc_dbg();
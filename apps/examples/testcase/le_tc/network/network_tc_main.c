@@ -106,6 +106,9 @@ int tc_network_main(int argc, char *argv[])
 #ifdef CONFIG_TC_NET_DUP
 	net_dup_main();
 #endif
+#ifdef CONFIG_TC_NET_SENDFILE
+	net_sendfile_main();
+#endif
 #ifdef CONFIG_ITC_NET_CLOSE
 	itc_net_close_main();
 #endif
@@ -97,6 +97,9 @@ int net_netdb_main(void);
 #ifdef CONFIG_TC_NET_DUP
 int net_dup_main(void);
 #endif
+#ifdef CONFIG_TC_NET_SENDFILE
+int net_sendfile_main(void);
+#endif
 #ifdef CONFIG_ITC_NET_CLOSE
 int itc_net_close_main(void);
 #endif
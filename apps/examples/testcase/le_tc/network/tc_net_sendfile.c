@@ -0,0 +1,347 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_net_sendfile.c
+/// @brief Test Case Example for sendfile() from a file to a socket
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mount.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef CONFIG_NET_LOCAL_STREAM
+#include <sys/un.h>
+#endif
+
+#include "tc_internal.h"
+
+#define PORTNUM 1116
+
+#define SENDFILE_MOUNTPOINT "/sendfile_tmpfs"
+#define SENDFILE_FILEPATH SENDFILE_MOUNTPOINT "/data"
+#define SENDFILE_UDS_PATH "/var/tc_sendfile"
+
+/* Make the file larger than everything a TCP connection can hold in
+ * flight, so that a non-blocking sendfile() cannot finish in one call.
+ */
+
+#if defined(CONFIG_NET_TCP_WND) && defined(CONFIG_NET_TCP_SND_BUF)
+#define SENDFILE_SIZE (CONFIG_NET_TCP_WND + CONFIG_NET_TCP_SND_BUF + 4096)
+#else
+#define SENDFILE_SIZE 16384
+#endif
+
+#define SENDFILE_START 3		/* *offset passed to sendfile() */
+#define SENDFILE_FPOS 1			/* File position that must be left alone */
+#define SENDFILE_MAX_RETRY 1000
+
+#define SENDFILE_PATTERN(pos) ((uint8_t)((pos) % 251))
+
+static int g_sendfile_uds_result;
+
+/* Write SENDFILE_SIZE bytes of a position dependent pattern */
+
+static int sendfile_create(void)
+{
+	uint8_t buf[256];
+	int fd;
+	int pos;
+	int len;
+	int i;
+
+	fd = open(SENDFILE_FILEPATH, O_WRONLY | O_CREAT | O_TRUNC);
+	if (fd < 0) {
+		return ERROR;
+	}
+
+	for (pos = 0; pos < SENDFILE_SIZE; pos += sizeof(buf)) {
+		len = SENDFILE_SIZE - pos;
+		if (len > sizeof(buf)) {
+			len = sizeof(buf);
+		}
+
+		for (i = 0; i < len; i++) {
+			buf[i] = SENDFILE_PATTERN(pos + i);
+		}
+
+		if (write(fd, buf, len) != len) {
+			close(fd);
+			return ERROR;
+		}
+	}
+
+	close(fd);
+	return OK;
+}
+
+/* Receive and check the stream until '*rxpos' reaches 'end' */
+
+static int sendfile_drain(int sd, int *rxpos, int end)
+{
+	uint8_t buf[256];
+	int len;
+	int i;
+
+	while (*rxpos < end) {
+		len = end - *rxpos;
+		if (len > sizeof(buf)) {
+			len = sizeof(buf);
+		}
+
+		len = recv(sd, buf, len, 0);
+		if (len <= 0) {
+			return ERROR;
+		}
+
+		for (i = 0; i < len; i++) {
+			if (buf[i] != SENDFILE_PATTERN(*rxpos + i)) {
+				printf("data mismatch at %d\n", *rxpos + i);
+				return ERROR;
+			}
+		}
+
+		*rxpos += len;
+	}
+
+	return OK;
+}
+
+/**
+ * @testcase         :tc_net_sendfile_tcp_p
+ * @brief            :Send a file to a non-blocking TCP socket from a non-NULL offset
+ * @scenario         :Call sendfile() until the file is sent, checking that *offset
+ *                    advances by the returned count, that the file position is not
+ *                    touched, that at least one call is partial and that the peer
+ *                    receives the file from the offset on
+ * @apicovered       :sendfile()
+ * @precondition     :tmpfs is mounted at SENDFILE_MOUNTPOINT
+ * @postcondition    :none
+ */
+static void tc_net_sendfile_tcp_p(void)
+{
+	struct sockaddr_in sa;
+	off_t offset;
+	off_t prev;
+	ssize_t ret;
+	int listensd;
+	int sd;
+	int peersd;
+	int fd;
+	int rxpos = SENDFILE_START;
+	int npartial = 0;
+	int nretry = 0;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(PORTNUM);
+	sa.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+	listensd = socket(AF_INET, SOCK_STREAM, 0);
+	TC_ASSERT_GEQ("socket", listensd, 0);
+
+	ret = bind(listensd, (struct sockaddr *)&sa, sizeof(sa));
+	TC_ASSERT_EQ_CLEANUP("bind", ret, OK, close(listensd));
+	ret = listen(listensd, 1);
+	TC_ASSERT_EQ_CLEANUP("listen", ret, OK, close(listensd));
+
+	/* lwIP completes a loopback connect() before accept() is called */
+
+	sd = socket(AF_INET, SOCK_STREAM, 0);
+	TC_ASSERT_GEQ_CLEANUP("socket", sd, 0, close(listensd));
+	ret = connect(sd, (struct sockaddr *)&sa, sizeof(sa));
+	TC_ASSERT_EQ_CLEANUP("connect", ret, OK, close(sd); close(listensd));
+	peersd = accept(listensd, NULL, NULL);
+	close(listensd);
+	TC_ASSERT_GEQ_CLEANUP("accept", peersd, 0, close(sd));
+
+	ret = fcntl(sd, F_SETFL, fcntl(sd, F_GETFL) | O_NONBLOCK);
+	TC_ASSERT_EQ_CLEANUP("fcntl", ret, OK, close(peersd); close(sd));
+
+	fd = open(SENDFILE_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, close(peersd); close(sd));
+	ret = lseek(fd, SENDFILE_FPOS, SEEK_SET);
+	TC_ASSERT_EQ_CLEANUP("lseek", ret, SENDFILE_FPOS, goto cleanup);
+
+	offset = SENDFILE_START;
+	while (offset < SENDFILE_SIZE) {
+		prev = offset;
+		ret = sendfile(sd, fd, &offset, SENDFILE_SIZE - offset);
+		if (ret < 0) {
+			/* Nothing fitted: the offset must not have moved */
+
+			TC_ASSERT_EQ_CLEANUP("sendfile", errno, EAGAIN, goto cleanup);
+			TC_ASSERT_EQ_CLEANUP("sendfile", offset, prev, goto cleanup);
+			TC_ASSERT_LT_CLEANUP("sendfile", nretry, SENDFILE_MAX_RETRY, goto cleanup);
+			nretry++;
+			usleep(10000);
+			continue;
+		}
+
+		TC_ASSERT_GT_CLEANUP("sendfile", ret, 0, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("sendfile", offset, prev + ret, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("sendfile", lseek(fd, 0, SEEK_CUR), SENDFILE_FPOS, goto cleanup);
+		if (offset < SENDFILE_SIZE) {
+			npartial++;
+		}
+
+		ret = sendfile_drain(peersd, &rxpos, offset);
+		TC_ASSERT_EQ_CLEANUP("recv", ret, OK, goto cleanup);
+	}
+
+	TC_ASSERT_GT_CLEANUP("sendfile", npartial, 0, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("recv", rxpos, SENDFILE_SIZE, goto cleanup);
+
+	/* At the end of the file there is nothing left to send */
+
+	ret = sendfile(sd, fd, &offset, 16);
+	TC_ASSERT_EQ_CLEANUP("sendfile", ret, 0, goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("sendfile", offset, SENDFILE_SIZE, goto cleanup);
+
+	close(fd);
+	close(peersd);
+	close(sd);
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup:
+	close(fd);
+	close(peersd);
+	close(sd);
+}
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+static void *sendfile_uds_client(void *arg)
+{
+	struct sockaddr_un *addr = (struct sockaddr_un *)arg;
+	int rxpos = SENDFILE_START;
+	int sd;
+
+	g_sendfile_uds_result = ERROR;
+
+	sd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sd < 0) {
+		return NULL;
+	}
+
+	if (connect(sd, (struct sockaddr *)addr, sizeof(*addr)) == OK && sendfile_drain(sd, &rxpos, SENDFILE_SIZE) == OK) {
+		g_sendfile_uds_result = rxpos;
+	}
+
+	close(sd);
+	return NULL;
+}
+
+/**
+ * @testcase         :tc_net_sendfile_uds_p
+ * @brief            :Splice a file into a Unix domain stream socket from a non-NULL offset
+ * @scenario         :Send the file to a connected AF_UNIX socket with sendfile() and
+ *                    check the offset, the file position and the data on the peer
+ * @apicovered       :sendfile()
+ * @precondition     :tmpfs is mounted at SENDFILE_MOUNTPOINT
+ * @postcondition    :none
+ */
+static void tc_net_sendfile_uds_p(void)
+{
+	struct sockaddr_un addr;
+	pthread_t client;
+	off_t offset;
+	off_t prev;
+	ssize_t ret;
+	int listensd;
+	int sd;
+	int fd;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, SENDFILE_UDS_PATH, sizeof(addr.sun_path) - 1);
+
+	listensd = socket(AF_UNIX, SOCK_STREAM, 0);
+	TC_ASSERT_GEQ("socket", listensd, 0);
+	ret = bind(listensd, (struct sockaddr *)&addr, sizeof(addr));
+	TC_ASSERT_EQ_CLEANUP("bind", ret, OK, close(listensd));
+	ret = listen(listensd, 1);
+	TC_ASSERT_EQ_CLEANUP("listen", ret, OK, close(listensd));
+
+	/* connect() waits for accept(), so the peer runs in its own thread */
+
+	ret = pthread_create(&client, NULL, sendfile_uds_client, &addr);
+	TC_ASSERT_EQ_CLEANUP("pthread_create", ret, 0, close(listensd));
+	sd = accept(listensd, NULL, NULL);
+	close(listensd);
+	TC_ASSERT_GEQ_CLEANUP("accept", sd, 0, pthread_join(client, NULL));
+
+	fd = open(SENDFILE_FILEPATH, O_RDONLY);
+	TC_ASSERT_GEQ_CLEANUP("open", fd, 0, close(sd); pthread_join(client, NULL));
+	ret = lseek(fd, SENDFILE_FPOS, SEEK_SET);
+	TC_ASSERT_EQ_CLEANUP("lseek", ret, SENDFILE_FPOS, goto cleanup);
+
+	offset = SENDFILE_START;
+	while (offset < SENDFILE_SIZE) {
+		prev = offset;
+		ret = sendfile(sd, fd, &offset, SENDFILE_SIZE - offset);
+		TC_ASSERT_GT_CLEANUP("sendfile", ret, 0, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("sendfile", offset, prev + ret, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("sendfile", lseek(fd, 0, SEEK_CUR), SENDFILE_FPOS, goto cleanup);
+	}
+
+	close(fd);
+	close(sd);
+	pthread_join(client, NULL);
+	TC_ASSERT_EQ("recv", g_sendfile_uds_result, SENDFILE_SIZE);
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup:
+	close(fd);
+	close(sd);
+	pthread_join(client, NULL);
+}
+#endif
+
+/****************************************************************************
+ * Name: sendfile()
+ ****************************************************************************/
+int net_sendfile_main(void)
+{
+	int ret;
+
+	umount(SENDFILE_MOUNTPOINT);
+	ret = mount(NULL, SENDFILE_MOUNTPOINT, "tmpfs", 0, NULL);
+	TC_ASSERT_EQ_RETURN("mount", ret, OK, ERROR);
+	ret = sendfile_create();
+	if (ret != OK) {
+		printf("sendfile_create fail %s:%d\n", __FUNCTION__, __LINE__);
+		total_fail++;
+	} else {
+		tc_net_sendfile_tcp_p();
+#ifdef CONFIG_NET_LOCAL_STREAM
+		tc_net_sendfile_uds_p();
+#endif
+	}
+
+	unlink(SENDFILE_FILEPATH);
+	umount(SENDFILE_MOUNTPOINT);
+	return 0;
+}
@@ -39,6 +39,7 @@
 #define RELATION_NAME2  "rel2"
 #define INDEX_BPLUS     "bplustree"
 #define INDEX_INLINE    "inline"
+#define INDEX_HASH      "hash"
 #define QUERY_LENGTH    128
 
 #define DATA_SET_NUM    10
@@ -464,6 +465,334 @@ static void utc_arastorage_db_query_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_prepare_p
+* @brief            Execute prepared statements
+* @scenario         Prepare an insert and a select with parameters, bind values and run them repeatedly
+* @apicovered       db_prepare, db_bind, db_step, db_finalize
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	db_cursor_t *cursor;
+	char query[QUERY_LENGTH];
+	int id;
+	long date;
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (id = 1000; id < 1000 + DATA_SET_NUM; id++) {
+		date = id * 10;
+		res = db_bind(stmt, 0, DOMAIN_INT, &id);
+		TC_ASSERT_EQ_CLEANUP("db_bind", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind(stmt, 1, DOMAIN_LONG, &date);
+		TC_ASSERT_EQ_CLEANUP("db_bind", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_step(stmt, NULL);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id >= ? AND id < ?;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	for (id = 1000; id < 1000 + DATA_SET_NUM; id += 5) {
+		date = id + 5;
+		res = db_bind(stmt, 0, DOMAIN_INT, &id);
+		TC_ASSERT_EQ_CLEANUP("db_bind", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind(stmt, 1, DOMAIN_LONG, &date);
+		TC_ASSERT_EQ_CLEANUP("db_bind", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_step(stmt, &cursor);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("db_step", cursor_get_count(cursor), 5, db_cursor_free(cursor); db_finalize(stmt));
+		db_cursor_free(cursor);
+	}
+
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_prepare_n
+* @brief            Prepare and execute statements with invalid arguments
+* @scenario         Prepare invalid sentences, bind out of range or mistyped values and run with unbound parameters
+* @apicovered       db_prepare, db_bind, db_step, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_n(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	int id = 0;
+
+	stmt = db_prepare(NULL);
+	TC_ASSERT_EQ("db_prepare", stmt, NULL);
+
+	snprintf(query, QUERY_LENGTH, "SELECT FROM %s WHERE;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_EQ("db_prepare", stmt, NULL);
+
+	res = db_bind(NULL, 0, DOMAIN_INT, &id);
+	TC_ASSERT_EQ("db_bind", res, DB_ARGUMENT_ERROR);
+
+	res = db_step(NULL, NULL);
+	TC_ASSERT_EQ("db_step", res, DB_ARGUMENT_ERROR);
+
+	res = db_finalize(NULL);
+	TC_ASSERT_EQ("db_finalize", res, DB_ARGUMENT_ERROR);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id > ?;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ("db_prepare", stmt, NULL);
+
+	res = db_step(stmt, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_step", res, DB_ARGUMENT_ERROR, db_finalize(stmt));
+
+	res = db_bind(stmt, 1, DOMAIN_INT, &id);
+	TC_ASSERT_EQ_CLEANUP("db_bind", res, DB_ARGUMENT_ERROR, db_finalize(stmt));
+
+	res = db_bind(stmt, 0, DOMAIN_STRING, "apple");
+	TC_ASSERT_EQ_CLEANUP("db_bind", res, DB_TYPE_ERROR, db_finalize(stmt));
+
+	db_finalize(stmt);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_bulk_p
+* @brief            Load rows into an indexed relation in bulk
+* @scenario         Insert rows between db_bulk_begin and db_bulk_end and select them back
+* @apicovered       db_bulk_begin, db_bulk_end
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_bulk_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	db_cursor_t *cursor;
+	char query[QUERY_LENGTH];
+	int id;
+	long date;
+
+	res = db_bulk_begin(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_begin", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME2);
+	stmt = db_prepare(query);
+	TC_ASSERT_NEQ_CLEANUP("db_prepare", stmt, NULL, db_bulk_end(RELATION_NAME2));
+
+	for (id = 2000 + DATA_SET_NUM - 1; id >= 2000; id--) {
+		date = id * 10;
+		db_bind(stmt, 0, DOMAIN_INT, &id);
+		db_bind(stmt, 1, DOMAIN_LONG, &date);
+		res = db_step(stmt, NULL);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt); db_bulk_end(RELATION_NAME2));
+	}
+	db_finalize(stmt);
+
+	res = db_bulk_end(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_end", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= 2000;", RELATION_NAME2);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), DATA_SET_NUM, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_string_index_p
+* @brief            Select rows by a string over hash and bplus-tree indexes
+* @scenario         Index the fruit attribute, select one fruit and a range of fruits and remove the index
+* @apicovered       db_exec, db_query
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_string_index_p(void)
+{
+	db_result_t res;
+	db_cursor_t *cursor;
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME1, g_attribute_set[2], INDEX_HASH);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE fruit = 'kiwi';", RELATION_NAME1);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), DATA_SET_MULTIPLIER, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s ;", RELATION_NAME1, g_attribute_set[2]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME1, g_attribute_set[2], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	/* melon, orange and peach */
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE fruit >= 'melon' AND fruit <= 'peach';", RELATION_NAME1);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), 3 * DATA_SET_MULTIPLIER, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s ;", RELATION_NAME1, g_attribute_set[2]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_group_join_p
+* @brief            Group rows and join two relations in the engine
+* @scenario         Count the rows of each fruit and join both relations on id in either order
+* @apicovered       db_query
+* @precondition     utc_arastorage_db_exec_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_group_join_p(void)
+{
+	db_result_t res;
+	db_cursor_t *cursor;
+	char query[QUERY_LENGTH];
+	tuple_id_t count;
+
+	snprintf(query, QUERY_LENGTH, "SELECT fruit, COUNT(id), MAX(value) FROM %s GROUP BY fruit;", RELATION_NAME1);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), DATA_SET_NUM, db_cursor_free(cursor));
+	res = cursor_move_first(cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_first", DB_SUCCESS(res), true, db_cursor_free(cursor));
+	TC_ASSERT_EQ_CLEANUP("cursor_get_string_value", strcmp((char *)cursor_get_string_value(cursor, 0), "apple"), 0, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	/* Every id of the second relation below the size of the first one has a match */
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id < %d;", RELATION_NAME2, DATA_SET_NUM * DATA_SET_MULTIPLIER);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	count = cursor_get_count(cursor);
+	db_cursor_free(cursor);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s JOIN %s ON id = id;", RELATION_NAME2, RELATION_NAME1);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), count, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	snprintf(query, QUERY_LENGTH, "SELECT fruit, date FROM %s JOIN %s ON id = id;", RELATION_NAME1, RELATION_NAME2);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), count, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	TC_SUCCESS_RESULT();
+}
+
+#if defined(CONFIG_ARASTORAGE_ENABLE_WAL) && defined(CONFIG_ARASTORAGE_FAULT_INJECTION)
+/**
+* @testcase         utc_arastorage_db_wal_recovery_p
+* @brief            Recover the committed rows after a power loss
+* @scenario         Insert rows, leave a bulk load open, cut the power and reinitialize the database
+* @apicovered       db_fault_inject, db_deinit, db_init
+* @precondition     utc_arastorage_db_bulk_p should be passed
+* @postcondition    none
+*/
+static void utc_arastorage_db_wal_recovery_p(void)
+{
+	db_result_t res;
+	db_cursor_t *cursor;
+	char query[QUERY_LENGTH];
+	int id;
+
+	for (id = 3000; id < 3000 + DATA_SET_NUM; id++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", id, (long)id * 10, RELATION_NAME2);
+		res = db_exec(query);
+		TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	}
+
+	/* Rows of a bulk load that is not committed are dropped */
+	res = db_bulk_begin(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_begin", DB_SUCCESS(res), true);
+	for (id = 4000; id < 4000 + DATA_SET_NUM; id++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", id, (long)id * 10, RELATION_NAME2);
+		db_exec(query);
+	}
+
+	/* Nothing written from here on reaches storage */
+	db_fault_inject(0);
+	snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", 5000, 50000L, RELATION_NAME2);
+	db_exec(query);
+	db_deinit();
+	db_fault_inject(-1);
+
+	res = db_init();
+	TC_ASSERT_EQ("db_init", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id FROM %s WHERE id >= 3000;", RELATION_NAME2);
+	cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_query", cursor_get_count(cursor), DATA_SET_NUM, db_cursor_free(cursor));
+	db_cursor_free(cursor);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+/**
+* @testcase         utc_arastorage_db_bulk_n
+* @brief            Start and finish bulk loads with invalid arguments
+* @scenario         Use a NULL or unknown relation, start a load twice and finish one that was not started
+* @apicovered       db_bulk_begin, db_bulk_end
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_bulk_n(void)
+{
+	db_result_t res;
+
+	res = db_bulk_begin(NULL);
+	TC_ASSERT_EQ("db_bulk_begin", res, DB_ARGUMENT_ERROR);
+
+	res = db_bulk_begin("norel");
+	TC_ASSERT_EQ("db_bulk_begin", DB_ERROR(res), true);
+
+	res = db_bulk_end(NULL);
+	TC_ASSERT_EQ("db_bulk_end", res, DB_ARGUMENT_ERROR);
+
+	res = db_bulk_end(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_end", res, DB_ARGUMENT_ERROR);
+
+	res = db_bulk_begin(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_begin", DB_SUCCESS(res), true);
+
+	res = db_bulk_begin(RELATION_NAME2);
+	TC_ASSERT_EQ_CLEANUP("db_bulk_begin", res, DB_BUSY_ERROR, db_bulk_end(RELATION_NAME2));
+
+	res = db_bulk_end(RELATION_NAME2);
+	TC_ASSERT_EQ("db_bulk_end", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_get_result_message_p
 * @brief            Get database result message
@@ -1527,6 +1856,13 @@ int utc_arastorage_main(int argc, char *argv[])
 	utc_arastorage_db_init_p();
 	utc_arastorage_db_exec_p();
 	utc_arastorage_db_query_p();
+	utc_arastorage_db_prepare_p();
+	utc_arastorage_db_bulk_p();
+	utc_arastorage_db_string_index_p();
+	utc_arastorage_db_group_join_p();
+#if defined(CONFIG_ARASTORAGE_ENABLE_WAL) && defined(CONFIG_ARASTORAGE_FAULT_INJECTION)
+	utc_arastorage_db_wal_recovery_p();
+#endif
 	utc_arastorage_db_get_result_message_p();
 	utc_arastorage_db_print_header_p();
 	utc_arastorage_db_print_tuple_p();
@@ -1557,6 +1893,8 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Negative TCs */
 	utc_arastorage_db_exec_n();
 	utc_arastorage_db_query_n();
+	utc_arastorage_db_prepare_n();
+	utc_arastorage_db_bulk_n();
 	utc_arastorage_db_get_result_message_n();
 	utc_arastorage_db_print_header_n();
 	utc_arastorage_db_print_tuple_n();
@@ -68,6 +68,17 @@
 #include "mbedtls/ecdsa.h"
 #include "mbedtls/ecdh.h"
 #include "mbedtls/error.h"
+#include "mbedtls/certs.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C)
+#include "mbedtls/memory_buffer_alloc.h"
+#endif
+#if defined(MBEDTLS_GCM_ALT) || defined(MBEDTLS_SHA256_ALT)
+#include "mbedtls/alt/hw_offload_alt.h"
+#endif
 
 #define mbedtls_exit		exit
 #define mbedtls_snprintf	snprintf
@@ -138,7 +149,7 @@ void count_time(int seconds)
 	"arc4, des3, des, camellia, blowfish,\n"				\
 	"aes_cbc, aes_gcm, aes_ccm, aes_cmac, des3_cmac,\n"		\
 	"havege, ctr_drbg, hmac_drbg\n"							\
-	"rsa, dhm, ecdsa, ecdh.\n"
+	"rsa, dhm, ecdsa, ecdh, handshake, offload.\n"
 
 #if defined(MBEDTLS_ERROR_C)
 #define PRINT_ERROR													\
@@ -272,9 +283,366 @@ typedef struct {
 		 aes_cbc, aes_gcm, aes_ccm, aes_cmac, des3_cmac,
 		 camellia, blowfish,
 		 havege, ctr_drbg, hmac_drbg,
-		 rsa, dhm, ecdsa, ecdh;
+		 rsa, dhm, ecdsa, ecdh, handshake, offload;
 } todo_list;
 
+/*
+ * TLS handshake: full versus resumed
+ */
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C) && \
+	defined(MBEDTLS_SSL_CACHE_C) && defined(MBEDTLS_CERTS_C) && \
+	defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_PEM_PARSE_C)
+
+#define HANDSHAKE_ROUNDS     4
+#define HANDSHAKE_PIPE_SIZE  4096
+#define HANDSHAKE_MAX_STEPS  1000
+
+/*
+ * Client and server run in this thread and talk through two memory pipes,
+ * so the numbers are the CPU time of the handshake alone.
+ */
+struct hs_pipe {
+	unsigned char buf[HANDSHAKE_PIPE_SIZE];
+	size_t head;
+	size_t len;
+};
+
+struct hs_bio {
+	struct hs_pipe *tx;
+	struct hs_pipe *rx;
+};
+
+struct hs_result {
+	unsigned long cli_ms;
+	unsigned long srv_ms;
+	size_t peak_heap;
+	int resumed;
+};
+
+static struct hs_pipe g_hs_pipe[2];
+
+static int hs_send(void *ctx, const unsigned char *data, size_t len)
+{
+	struct hs_pipe *p = ((struct hs_bio *)ctx)->tx;
+	size_t n = 0;
+
+	if (p->len == HANDSHAKE_PIPE_SIZE) {
+		return MBEDTLS_ERR_SSL_WANT_WRITE;
+	}
+
+	while (n < len && p->len < HANDSHAKE_PIPE_SIZE) {
+		p->buf[(p->head + p->len) % HANDSHAKE_PIPE_SIZE] = data[n++];
+		p->len++;
+	}
+
+	return (int)n;
+}
+
+static int hs_recv(void *ctx, unsigned char *data, size_t len)
+{
+	struct hs_pipe *p = ((struct hs_bio *)ctx)->rx;
+	size_t n = 0;
+
+	if (p->len == 0) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	while (n < len && p->len > 0) {
+		data[n++] = p->buf[p->head];
+		p->head = (p->head + 1) % HANDSHAKE_PIPE_SIZE;
+		p->len--;
+	}
+
+	return (int)n;
+}
+
+static size_t hs_heap_used(void)
+{
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+	size_t used, blocks;
+
+	mbedtls_memory_buffer_alloc_cur_get(&used, &blocks);
+	return used + MEM_BLOCK_OVERHEAD * blocks;
+#else
+	struct mallinfo mem = mallinfo();
+
+	return (size_t)mem.uordblks;
+#endif
+}
+
+static int hs_pending(int ret)
+{
+	return ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+/*
+ * Run one handshake.  With 'resume' set, 'session' is offered to the
+ * server; it receives the new session when the handshake is done.
+ */
+static int hs_run(mbedtls_ssl_config *cli_conf, mbedtls_ssl_config *srv_conf,
+				  mbedtls_ssl_session *session, int resume, struct hs_result *res)
+{
+	mbedtls_ssl_context cli;
+	mbedtls_ssl_context srv;
+	struct hs_bio cli_bio = { &g_hs_pipe[0], &g_hs_pipe[1] };
+	struct hs_bio srv_bio = { &g_hs_pipe[1], &g_hs_pipe[0] };
+	struct mbedtls_timing_hr_time timer;
+	int cli_ret = MBEDTLS_ERR_SSL_WANT_WRITE;
+	int srv_ret = MBEDTLS_ERR_SSL_WANT_READ;
+	size_t base;
+	size_t used;
+	int steps;
+	int ret;
+
+	memset(g_hs_pipe, 0, sizeof(g_hs_pipe));
+	memset(res, 0, sizeof(*res));
+	base = hs_heap_used();
+
+	mbedtls_ssl_init(&cli);
+	mbedtls_ssl_init(&srv);
+
+	if ((ret = mbedtls_ssl_setup(&cli, cli_conf)) != 0 ||
+		(ret = mbedtls_ssl_setup(&srv, srv_conf)) != 0 ||
+		(ret = mbedtls_ssl_set_hostname(&cli, "localhost")) != 0) {
+		goto exit;
+	}
+
+	if (resume && (ret = mbedtls_ssl_set_session(&cli, session)) != 0) {
+		goto exit;
+	}
+
+	mbedtls_ssl_set_bio(&cli, &cli_bio, hs_send, hs_recv, NULL);
+	mbedtls_ssl_set_bio(&srv, &srv_bio, hs_send, hs_recv, NULL);
+
+	for (steps = 0; cli_ret != 0 || srv_ret != 0; steps++) {
+		if (steps == HANDSHAKE_MAX_STEPS) {
+			ret = MBEDTLS_ERR_SSL_TIMEOUT;
+			goto exit;
+		}
+
+		if (cli_ret != 0) {
+			(void)mbedtls_timing_get_timer(&timer, 1);
+			cli_ret = mbedtls_ssl_handshake(&cli);
+			res->cli_ms += mbedtls_timing_get_timer(&timer, 0);
+		}
+
+		if (srv_ret != 0) {
+			(void)mbedtls_timing_get_timer(&timer, 1);
+			srv_ret = mbedtls_ssl_handshake(&srv);
+			res->srv_ms += mbedtls_timing_get_timer(&timer, 0);
+		}
+
+		used = hs_heap_used();
+		if (used > base && used - base > res->peak_heap) {
+			res->peak_heap = used - base;
+		}
+
+		if (cli_ret != 0 && !hs_pending(cli_ret)) {
+			ret = cli_ret;
+			goto exit;
+		}
+
+		if (srv_ret != 0 && !hs_pending(srv_ret)) {
+			ret = srv_ret;
+			goto exit;
+		}
+	}
+
+	/* A resumed session keeps its master secret */
+	res->resumed = resume && memcmp(cli.session->master, session->master, sizeof(session->master)) == 0;
+	ret = mbedtls_ssl_get_session(&cli, session);
+
+exit:
+	mbedtls_ssl_free(&cli);
+	mbedtls_ssl_free(&srv);
+	return ret;
+}
+
+static void hs_bench(const char *title, mbedtls_ssl_config *cli_conf, mbedtls_ssl_config *srv_conf, int resume)
+{
+	mbedtls_ssl_session session;
+	struct hs_result res;
+	struct hs_result sum;
+	unsigned char tmp[200];
+	int resumed = 0;
+	int ret = 0;
+	int i;
+
+	mbedtls_printf(HEADER_FORMAT, title);
+	fflush(stdout);
+
+	memset(&sum, 0, sizeof(sum));
+	mbedtls_ssl_session_init(&session);
+
+	/* The first full handshake gives the session to resume */
+	if (resume) {
+		ret = hs_run(cli_conf, srv_conf, &session, 0, &res);
+	}
+
+	for (i = 0; i < HANDSHAKE_ROUNDS && ret == 0; i++) {
+		ret = hs_run(cli_conf, srv_conf, &session, resume, &res);
+		sum.cli_ms += res.cli_ms;
+		sum.srv_ms += res.srv_ms;
+		if (res.peak_heap > sum.peak_heap) {
+			sum.peak_heap = res.peak_heap;
+		}
+		resumed += res.resumed;
+	}
+
+	mbedtls_ssl_session_free(&session);
+
+	if (ret != 0) {
+		PRINT_ERROR;
+		return;
+	}
+
+	mbedtls_printf("%6lu ms client, %6lu ms server, %6u heap bytes",
+				   sum.cli_ms / HANDSHAKE_ROUNDS, sum.srv_ms / HANDSHAKE_ROUNDS,
+				   (unsigned)sum.peak_heap);
+	if (resume && resumed != HANDSHAKE_ROUNDS) {
+		mbedtls_printf(" (%d of %d resumed)", resumed, HANDSHAKE_ROUNDS);
+	}
+	mbedtls_printf("\n");
+}
+
+static void tls_benchmark_handshake(void)
+{
+	mbedtls_ssl_config cli_conf;
+	mbedtls_ssl_config srv_conf;
+	mbedtls_x509_crt cacert;
+	mbedtls_x509_crt srvcert;
+	mbedtls_pk_context pkey;
+	mbedtls_ssl_cache_context cache;
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_context ticket;
+#endif
+	unsigned char tmp[200];
+	int ret;
+
+	mbedtls_ssl_config_init(&cli_conf);
+	mbedtls_ssl_config_init(&srv_conf);
+	mbedtls_x509_crt_init(&cacert);
+	mbedtls_x509_crt_init(&srvcert);
+	mbedtls_pk_init(&pkey);
+	mbedtls_ssl_cache_init(&cache);
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_init(&ticket);
+#endif
+
+	if ((ret = mbedtls_x509_crt_parse(&cacert, (const unsigned char *)mbedtls_test_cas_pem, mbedtls_test_cas_pem_len)) != 0 ||
+		(ret = mbedtls_x509_crt_parse(&srvcert, (const unsigned char *)mbedtls_test_srv_crt, mbedtls_test_srv_crt_len)) != 0 ||
+		(ret = mbedtls_pk_parse_key(&pkey, (const unsigned char *)mbedtls_test_srv_key, mbedtls_test_srv_key_len, NULL, 0)) != 0 ||
+		(ret = mbedtls_ssl_config_defaults(&cli_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT)) != 0 ||
+		(ret = mbedtls_ssl_config_defaults(&srv_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT)) != 0 ||
+		(ret = mbedtls_ssl_conf_own_cert(&srv_conf, &srvcert, &pkey)) != 0) {
+		mbedtls_printf(HEADER_FORMAT, "TLS handshake setup");
+		PRINT_ERROR;
+		goto exit;
+	}
+
+	mbedtls_ssl_conf_rng(&cli_conf, myrand, NULL);
+	mbedtls_ssl_conf_rng(&srv_conf, myrand, NULL);
+	mbedtls_ssl_conf_authmode(&cli_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+	mbedtls_ssl_conf_ca_chain(&cli_conf, &cacert, NULL);
+	mbedtls_ssl_conf_session_cache(&srv_conf, &cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+
+#if defined(MBEDTLS_SSL_TICKET_C)
+	if ((ret = mbedtls_ssl_ticket_setup(&ticket, myrand, NULL, MBEDTLS_CIPHER_AES_256_GCM, MBEDTLS_SSL_DEFAULT_TICKET_LIFETIME)) != 0) {
+		mbedtls_printf(HEADER_FORMAT, "TLS ticket setup");
+		PRINT_ERROR;
+		goto exit;
+	}
+	mbedtls_ssl_conf_session_tickets_cb(&srv_conf, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, &ticket);
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+	mbedtls_ssl_conf_session_tickets(&cli_conf, MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+#endif
+	hs_bench("TLS full handshake", &cli_conf, &srv_conf, 0);
+	hs_bench("TLS resume session id", &cli_conf, &srv_conf, 1);
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_conf_session_tickets(&cli_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+	hs_bench("TLS resume ticket", &cli_conf, &srv_conf, 1);
+#endif
+
+exit:
+#if defined(MBEDTLS_SSL_TICKET_C)
+	mbedtls_ssl_ticket_free(&ticket);
+#endif
+	mbedtls_ssl_cache_free(&cache);
+	mbedtls_pk_free(&pkey);
+	mbedtls_x509_crt_free(&srvcert);
+	mbedtls_x509_crt_free(&cacert);
+	mbedtls_ssl_config_free(&srv_conf);
+	mbedtls_ssl_config_free(&cli_conf);
+}
+
+#define TLS_BENCHMARK_HANDSHAKE
+#endif
+
+/*
+ * Security HAL offload: the same operations through the SE and in software
+ */
+#if defined(MBEDTLS_GCM_ALT) || defined(MBEDTLS_SHA256_ALT)
+static void offload_report(int op)
+{
+	struct mbedtls_hw_offload_stats st;
+
+	mbedtls_hw_offload_stats(op, &st, 1);
+	mbedtls_printf("    %lu by the HAL, %lu in software, %lu HAL errors\n",
+				   (unsigned long)st.hw_ops, (unsigned long)st.sw_ops, (unsigned long)st.hw_failed);
+}
+
+static void tls_benchmark_offload(void)
+{
+	char title[TITLE_LEN];
+	unsigned char tmp[32];
+	int hw;
+
+	for (hw = 1; hw >= 0; hw--) {
+#if defined(MBEDTLS_GCM_ALT)
+		int keysize;
+		mbedtls_gcm_context gcm;
+
+		mbedtls_hw_offload_set(MBEDTLS_HW_OFFLOAD_AES, hw);
+		mbedtls_hw_offload_stats(MBEDTLS_HW_OFFLOAD_AES, NULL, 1);
+		for (keysize = 128; keysize <= 256; keysize += 64) {
+			mbedtls_snprintf(title, sizeof(title), "AES-GCM-%d %s", keysize, hw ? "HAL" : "SW");
+
+			memset(buf, 0, sizeof(buf));
+			memset(tmp, 0, sizeof(tmp));
+			mbedtls_gcm_init(&gcm);
+			mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, tmp, keysize);
+
+			TIME_AND_TSC(title,
+						 mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, BUFSIZE, tmp,
+												   12, NULL, 0, buf, buf, 16, tmp));
+
+			mbedtls_gcm_free(&gcm);
+		}
+		offload_report(MBEDTLS_HW_OFFLOAD_AES);
+#endif
+#if defined(MBEDTLS_SHA256_ALT)
+		mbedtls_hw_offload_set(MBEDTLS_HW_OFFLOAD_SHA256, hw);
+		mbedtls_hw_offload_stats(MBEDTLS_HW_OFFLOAD_SHA256, NULL, 1);
+		mbedtls_snprintf(title, sizeof(title), "SHA-256 %s", hw ? "HAL" : "SW");
+		TIME_AND_TSC(title, mbedtls_sha256(buf, BUFSIZE, tmp, 0));
+		offload_report(MBEDTLS_HW_OFFLOAD_SHA256);
+#endif
+	}
+
+#if defined(MBEDTLS_GCM_ALT)
+	mbedtls_hw_offload_set(MBEDTLS_HW_OFFLOAD_AES, 1);
+#endif
+#if defined(MBEDTLS_SHA256_ALT)
+	mbedtls_hw_offload_set(MBEDTLS_HW_OFFLOAD_SHA256, 1);
+#endif
+}
+
+#define TLS_BENCHMARK_OFFLOAD
+#endif
+
 pthread_addr_t tls_benchmark_cb(void *args)
 {
 	int i;
@@ -342,6 +710,10 @@ pthread_addr_t tls_benchmark_cb(void *args)
 				todo.ecdsa = 1;
 			} else if (strcmp(argv[i], "ecdh") == 0) {
 				todo.ecdh = 1;
+			} else if (strcmp(argv[i], "handshake") == 0) {
+				todo.handshake = 1;
+			} else if (strcmp(argv[i], "offload") == 0) {
+				todo.offload = 1;
 			} else {
 				mbedtls_printf("Unrecognized option: %s\n", argv[i]);
 				mbedtls_printf("Available options: " OPTIONS);
@@ -819,6 +1191,18 @@ pthread_addr_t tls_benchmark_cb(void *args)
 	}
 #endif
 
+#if defined(TLS_BENCHMARK_HANDSHAKE)
+	if (todo.handshake) {
+		tls_benchmark_handshake();
+	}
+#endif
+
+#if defined(TLS_BENCHMARK_OFFLOAD)
+	if (todo.offload) {
+		tls_benchmark_offload();
+	}
+#endif
+
 	mbedtls_printf("Benchmark test finished \n");
 	mbedtls_printf("\n");
 
@@ -834,8 +1218,12 @@ int tls_benchmark_main(int argc, char **argv)
 	pthread_t tid;
 	pthread_attr_t attr;
 	struct sched_param sparam;
+	struct pthread_arg args;
 	int r;
 
+	args.argc = argc;
+	args.argv = argv;
+
 	/* Initialize the attribute variable */
 	if ((r = pthread_attr_init(&attr)) != 0) {
 		printf("%s: pthread_attr_init failed, status=%d\n", __func__, r);
@@ -857,7 +1245,7 @@ int tls_benchmark_main(int argc, char **argv)
 	}
 
 	/* 3. create pthread with entry function */
-	if ((r = pthread_create(&tid, &attr, tls_benchmark_cb, (void *)0)) != 0) {
+	if ((r = pthread_create(&tid, &attr, tls_benchmark_cb, (void *)&args)) != 0) {
 		printf("%s: pthread_create failed, status=%d\n", __func__, r);
 	}
 
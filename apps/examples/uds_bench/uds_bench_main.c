@@ -0,0 +1,244 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_UDS_BENCH_MBYTES
+#define CONFIG_EXAMPLES_UDS_BENCH_MBYTES 4
+#endif
+
+#ifndef CONFIG_EXAMPLES_UDS_BENCH_MSGSIZE
+#define CONFIG_EXAMPLES_UDS_BENCH_MSGSIZE 1024
+#endif
+
+#ifndef CONFIG_EXAMPLES_UDS_BENCH_ROUNDTRIPS
+#define CONFIG_EXAMPLES_UDS_BENCH_ROUNDTRIPS 2000
+#endif
+
+#define TOTAL_BYTES ((uint32_t)CONFIG_EXAMPLES_UDS_BENCH_MBYTES * 1024 * 1024)
+#define MSGSIZE     CONFIG_EXAMPLES_UDS_BENCH_MSGSIZE
+#define ROUNDTRIPS  CONFIG_EXAMPLES_UDS_BENCH_ROUNDTRIPS
+#define PINGSIZE    64
+
+#define UDS_BENCH_PATH "/var/uds_bench"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_srvbuf[MSGSIZE];
+static uint8_t g_clibuf[MSGSIZE];
+static int g_listensd = -1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t uds_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+/* Send or receive exactly 'len' bytes */
+
+static int uds_bench_xfer(int sd, FAR uint8_t *buf, size_t len, bool tx)
+{
+	ssize_t ret;
+	size_t done = 0;
+
+	while (done < len) {
+		ret = tx ? send(sd, buf + done, len - done, 0) : recv(sd, buf + done, len - done, 0);
+		if (ret <= 0) {
+			return ERROR;
+		}
+
+		done += ret;
+	}
+
+	return OK;
+}
+
+/* The server side: sink the throughput test, then echo the pings */
+
+static FAR void *uds_bench_server(FAR void *arg)
+{
+	uint32_t received = 0;
+	ssize_t ret;
+	int sd;
+	int i;
+
+	sd = accept(g_listensd, NULL, NULL);
+	if (sd < 0) {
+		printf("ERROR: accept failed: %d\n", errno);
+		return NULL;
+	}
+
+	while (received < TOTAL_BYTES) {
+		ret = recv(sd, g_srvbuf, MSGSIZE, 0);
+		if (ret <= 0) {
+			printf("ERROR: recv failed: %d\n", errno);
+			goto done;
+		}
+
+		received += ret;
+	}
+
+	/* Tell the client that all of the data arrived */
+
+	if (uds_bench_xfer(sd, g_srvbuf, 1, true) != OK) {
+		goto done;
+	}
+
+	for (i = 0; i < ROUNDTRIPS; i++) {
+		if (uds_bench_xfer(sd, g_srvbuf, PINGSIZE, false) != OK || uds_bench_xfer(sd, g_srvbuf, PINGSIZE, true) != OK) {
+			printf("ERROR: echo failed: %d\n", errno);
+			break;
+		}
+	}
+
+done:
+	close(sd);
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int uds_bench_main(int argc, char *argv[])
+#endif
+{
+	struct sockaddr_un addr;
+	struct timespec start;
+	pthread_t server;
+	uint32_t usec;
+	uint32_t sent;
+	int sd = -1;
+	int i;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, UDS_BENCH_PATH, sizeof(addr.sun_path) - 1);
+
+	g_listensd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (g_listensd < 0) {
+		printf("ERROR: socket failed: %d\n", errno);
+		return ERROR;
+	}
+
+	if (bind(g_listensd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(g_listensd, 1) < 0) {
+		printf("ERROR: bind/listen failed: %d\n", errno);
+		goto errout;
+	}
+
+	if (pthread_create(&server, NULL, uds_bench_server, NULL) != 0) {
+		printf("ERROR: pthread_create failed\n");
+		goto errout;
+	}
+
+	sd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sd < 0 || connect(sd, (FAR struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printf("ERROR: connect failed: %d\n", errno);
+		if (sd >= 0) {
+			close(sd);
+		}
+
+		/* The server is still waiting in accept() */
+
+		pthread_cancel(server);
+		pthread_join(server, NULL);
+		goto errout;
+	}
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	printf("Unix domain stream sockets over %d byte rings\n", CONFIG_NET_LOCAL_STREAM_RING_SIZE);
+#else
+	printf("Unix domain stream sockets over FIFOs\n");
+#endif
+
+	/* Throughput: stream TOTAL_BYTES in MSGSIZE sends */
+
+	memset(g_clibuf, 0xa5, sizeof(g_clibuf));
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	for (sent = 0; sent < TOTAL_BYTES; sent += MSGSIZE) {
+		if (uds_bench_xfer(sd, g_clibuf, MSGSIZE, true) != OK) {
+			printf("ERROR: send failed: %d\n", errno);
+			goto errout_with_server;
+		}
+	}
+
+	if (uds_bench_xfer(sd, g_clibuf, 1, false) != OK) {
+		printf("ERROR: recv failed: %d\n", errno);
+		goto errout_with_server;
+	}
+
+	usec = uds_bench_elapsed(&start);
+	printf("throughput: %lu bytes in %lu us (%d byte sends): %lu KB/s\n", (unsigned long)sent, (unsigned long)usec, MSGSIZE, usec > 0 ? (unsigned long)((uint64_t)sent * 1000000 / 1024 / usec) : 0UL);
+
+	/* Latency: PINGSIZE byte ping-pong */
+
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	for (i = 0; i < ROUNDTRIPS; i++) {
+		if (uds_bench_xfer(sd, g_clibuf, PINGSIZE, true) != OK || uds_bench_xfer(sd, g_clibuf, PINGSIZE, false) != OK) {
+			printf("ERROR: ping failed: %d\n", errno);
+			goto errout_with_server;
+		}
+	}
+
+	usec = uds_bench_elapsed(&start);
+	printf("round trip: %d x %d bytes in %lu us: %lu us each\n", ROUNDTRIPS, PINGSIZE, (unsigned long)usec, (unsigned long)(usec / ROUNDTRIPS));
+
+errout_with_server:
+	if (sd >= 0) {
+		close(sd);
+	}
+
+	pthread_join(server, NULL);
+
+errout:
+	close(g_listensd);
+	return OK;
+}
@@ -0,0 +1,292 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_EXAMPLES_ZC_BENCH_SIZE_KB
+#define CONFIG_EXAMPLES_ZC_BENCH_SIZE_KB 4096
+#endif
+
+#ifndef CONFIG_EXAMPLES_ZC_BENCH_CHUNK
+#define CONFIG_EXAMPLES_ZC_BENCH_CHUNK 4096
+#endif
+
+#define TOTAL_BYTES ((uint32_t)CONFIG_EXAMPLES_ZC_BENCH_SIZE_KB * 1024)
+#define CHUNK       CONFIG_EXAMPLES_ZC_BENCH_CHUNK
+#define RECV_NIOV   16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum zc_bench_mode_e {
+	BENCH_COPY = 0,
+	BENCH_ZEROCOPY
+};
+
+struct zc_bench_rx_s {
+	int mode;
+	int listener;
+	uint32_t received;
+	int result;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_txbuf[CHUNK];
+static uint8_t g_rxbuf[CHUNK];
+
+/* Completions of sendmsg_zc(), posted from the network thread */
+
+static sem_t g_zcdone;
+static volatile int g_zcerrors;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint32_t zc_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint32_t)((now.tv_sec - start->tv_sec) * 1000000 + (now.tv_nsec - start->tv_nsec) / 1000);
+}
+
+static void zc_bench_done(FAR void *arg, int result)
+{
+	if (result < 0) {
+		g_zcerrors++;
+	}
+
+	sem_post(&g_zcdone);
+}
+
+static FAR void *zc_bench_receiver(FAR void *arg)
+{
+	FAR struct zc_bench_rx_s *rx = (FAR struct zc_bench_rx_s *)arg;
+	struct iovec iov[RECV_NIOV];
+	struct msghdr msg;
+	FAR void *zcbuf;
+	ssize_t nread;
+	int sd;
+
+	rx->received = 0;
+	rx->result = ERROR;
+
+	sd = accept(rx->listener, NULL, NULL);
+	if (sd < 0) {
+		printf("ERROR: accept failed: %d\n", errno);
+		return NULL;
+	}
+
+	while (rx->received < TOTAL_BYTES) {
+		if (rx->mode == BENCH_ZEROCOPY) {
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = iov;
+			msg.msg_iovlen = RECV_NIOV;
+			nread = recvmsg_zc(sd, &msg, 0, &zcbuf);
+			if (nread > 0) {
+				recvmsg_zc_release(zcbuf);
+			}
+		} else {
+			nread = recv(sd, g_rxbuf, sizeof(g_rxbuf), 0);
+		}
+
+		if (nread <= 0) {
+			printf("ERROR: receive failed: %d\n", errno);
+			close(sd);
+			return NULL;
+		}
+
+		rx->received += nread;
+	}
+
+	rx->result = OK;
+	close(sd);
+	return NULL;
+}
+
+/* Stream TOTAL_BYTES to a receiver thread over loopback TCP and return the
+ * elapsed time in microseconds in 'usec'.  Every sendmsg_zc() completion
+ * is waited for before the socket is closed, as closing with data still
+ * unacknowledged would reset the connection.
+ */
+
+static int zc_bench_run(int mode, FAR uint32_t *usec)
+{
+	struct zc_bench_rx_s rx;
+	struct sockaddr_in addr;
+	socklen_t addrlen = sizeof(addr);
+	struct timespec start;
+	struct iovec iov;
+	struct msghdr msg;
+	pthread_t tid;
+	uint32_t sent = 0;
+	int pending = 0;
+	int listener;
+	int sd = -1;
+	int ret = ERROR;
+	ssize_t nwritten;
+
+	listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0) {
+		printf("ERROR: socket failed: %d\n", errno);
+		return ERROR;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = 0;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(listener, (FAR struct sockaddr *)&addr, addrlen) < 0 || getsockname(listener, (FAR struct sockaddr *)&addr, &addrlen) < 0 || listen(listener, 1) < 0) {
+		printf("ERROR: failed to set up the listener: %d\n", errno);
+		close(listener);
+		return ERROR;
+	}
+
+	rx.mode = mode;
+	rx.listener = listener;
+	if (pthread_create(&tid, NULL, zc_bench_receiver, &rx) != 0) {
+		printf("ERROR: pthread_create failed\n");
+		close(listener);
+		return ERROR;
+	}
+
+	sd = socket(AF_INET, SOCK_STREAM, 0);
+	if (sd < 0 || connect(sd, (FAR struct sockaddr *)&addr, addrlen) < 0) {
+		printf("ERROR: connect failed: %d\n", errno);
+		goto errout;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &start);
+
+	while (sent < TOTAL_BYTES) {
+		if (mode == BENCH_ZEROCOPY) {
+			/* g_txbuf is never modified, so it can be queued again before
+			 * the previous send has completed
+			 */
+
+			iov.iov_base = g_txbuf;
+			iov.iov_len = sizeof(g_txbuf);
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = &iov;
+			msg.msg_iovlen = 1;
+			nwritten = sendmsg_zc(sd, &msg, 0, zc_bench_done, NULL);
+			if (nwritten >= 0) {
+				pending++;
+			}
+		} else {
+			nwritten = send(sd, g_txbuf, sizeof(g_txbuf), 0);
+		}
+
+		if (nwritten <= 0) {
+			printf("ERROR: send failed: %d\n", errno);
+			goto errout;
+		}
+
+		sent += nwritten;
+	}
+
+	ret = OK;
+
+errout:
+	while (pending > 0) {
+		while (sem_wait(&g_zcdone) < 0 && errno == EINTR) ;
+		pending--;
+	}
+
+	if (sd >= 0) {
+		close(sd);
+	}
+
+	if (ret == OK) {
+		pthread_join(tid, NULL);
+		*usec = zc_bench_elapsed(&start);
+		ret = rx.result;
+	} else {
+		close(listener);
+		listener = -1;
+		pthread_join(tid, NULL);
+	}
+
+	if (listener >= 0) {
+		close(listener);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int zc_bench_main(int argc, char *argv[])
+#endif
+{
+	uint32_t copyus = 0;
+	uint32_t zcus = 0;
+	uint32_t mbytes;
+
+	memset(g_txbuf, 0x5a, sizeof(g_txbuf));
+	sem_init(&g_zcdone, 0, 0);
+	g_zcerrors = 0;
+
+	if (zc_bench_run(BENCH_COPY, &copyus) < 0 || zc_bench_run(BENCH_ZEROCOPY, &zcus) < 0) {
+		sem_destroy(&g_zcdone);
+		return ERROR;
+	}
+
+	/* Report per megabyte, rounding the amount up to at least 1 MB */
+
+	mbytes = (TOTAL_BYTES + (1024 * 1024) - 1) / (1024 * 1024);
+	printf("%lu KB in %d byte sends\n", (unsigned long)CONFIG_EXAMPLES_ZC_BENCH_SIZE_KB, CHUNK);
+	printf("send/recv:             %lu us per MB\n", (unsigned long)(copyus / mbytes));
+	printf("sendmsg_zc/recvmsg_zc: %lu us per MB (%d failed completions)\n", (unsigned long)(zcus / mbytes), g_zcerrors);
+
+	sem_destroy(&g_zcdone);
+	return OK;
+}
@@ -26,6 +26,7 @@
 #include <sys/ioctl.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <stdint.h>
 #include <unistd.h>
@@ -33,6 +34,7 @@
 #include <queue.h>
 
 #include <netinet/in.h>
+#include <arpa/inet.h>
 #include <net/if.h>
 
 #include <netutils/netlib.h>
@@ -51,7 +53,19 @@
 	"\n WiFi Manager stats:\n"					\
 	"       netmon wifi\n"						\
 	"\n Net device stats:\n"					\
-	"       netmon [devname]\n\n"
+	"       netmon [devname]\n"					\
+	NETMON_TOP_USAGE							\
+	"\n"
+
+#ifdef CONFIG_NET_STATS_PERF
+#define NETMON_TOP_USAGE						\
+	"\n Live socket and net device counters:\n"	\
+	"       netmon top [-d secs] [-n count] [devname]\n"
+#define NETMON_TOP_INTERVAL 1
+#define NETMON_TOP_COUNT    10
+#else
+#define NETMON_TOP_USAGE ""
+#endif
 
 #ifdef CONFIG_NET_IPv6
 static inline void PRINT_IPV(struct netmon_sock *sock)
@@ -290,6 +304,113 @@ static void print_devstats(struct netmon_netdev_stats *stats)
 }
 #endif							/* CONFIG_NET_STATS */
 
+#ifdef CONFIG_NET_STATS_PERF
+/**
+ * Print one sample of "netmon top": the rates and drops of a net device
+ * since the previous sample and the counters of every socket.
+ */
+static void print_top(struct netmon_netdev_stats *cur, struct netmon_netdev_stats *prev, int interval, int sample, int count)
+{
+	sq_queue_t q_sock;
+	struct netmon_sock *sock_info;
+	int i;
+
+	/* Move the cursor home and clear the screen */
+	printf("\033[H\033[J");
+	printf("netmon top: sample %d/%d, every %d s\n", sample, count, interval);
+
+	if (cur->devname[0] != '\0') {
+		printf("\nIFNAME    RXpkt/s  RXbyte/s   TXpkt/s  TXbyte/s\n");
+		printf("%-10s%-9lu%-11lu%-10lu%-10lu\n", cur->devname,
+			   (unsigned long)(cur->devinpkts - prev->devinpkts) / interval,
+			   (unsigned long)(cur->devinoctets - prev->devinoctets) / interval,
+			   (unsigned long)(cur->devoutpkts - prev->devoutpkts) / interval,
+			   (unsigned long)(cur->devoutoctets - prev->devoutoctets) / interval);
+		printf("drops (new/total): nomem %lu/%lu qfull %lu/%lu hdr %lu/%lu chksum %lu/%lu\n",
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_NOMEM] - prev->devdrops[NETMON_DROP_RX_NOMEM]), (unsigned long)cur->devdrops[NETMON_DROP_RX_NOMEM],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_QFULL] - prev->devdrops[NETMON_DROP_RX_QFULL]), (unsigned long)cur->devdrops[NETMON_DROP_RX_QFULL],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_HDR] - prev->devdrops[NETMON_DROP_RX_HDR]), (unsigned long)cur->devdrops[NETMON_DROP_RX_HDR],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_CHKSUM] - prev->devdrops[NETMON_DROP_RX_CHKSUM]), (unsigned long)cur->devdrops[NETMON_DROP_RX_CHKSUM]);
+		printf("                   proto %lu/%lu addr %lu/%lu txbuf %lu/%lu txerr %lu/%lu\n",
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_PROTO] - prev->devdrops[NETMON_DROP_RX_PROTO]), (unsigned long)cur->devdrops[NETMON_DROP_RX_PROTO],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_RX_ADDR] - prev->devdrops[NETMON_DROP_RX_ADDR]), (unsigned long)cur->devdrops[NETMON_DROP_RX_ADDR],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_TX_NOBUF] - prev->devdrops[NETMON_DROP_TX_NOBUF]), (unsigned long)cur->devdrops[NETMON_DROP_TX_NOBUF],
+			   (unsigned long)(cur->devdrops[NETMON_DROP_TX_ERR] - prev->devdrops[NETMON_DROP_TX_ERR]), (unsigned long)cur->devdrops[NETMON_DROP_TX_ERR]);
+	}
+
+	sq_init(&q_sock);
+	if (netlib_netmon_sock(&q_sock)) {
+		printf("Failed to fetch socket info.\n");
+		return;
+	}
+
+	printf("\nSock  Proto  Local                 Remote                RTT(ms)  Cwnd     Rexmit  RTO   RecvQ   MaxQ    Drops  PID\n");
+	i = 1;
+	sock_info = (struct netmon_sock *)sq_remfirst(&q_sock);
+	while (sock_info) {
+		printf("%-6d%-7s", i, (sock_info->type & NETMON_TCP) ? "TCP" : (sock_info->type & NETMON_UDP) ? "UDP" : "RAW");
+		printf("%15s:%-6d", inet_ntoa(sock_info->local.ip.sin_addr), sock_info->local.ip.sin_port);
+		printf("%15s:%-6d", inet_ntoa(sock_info->remote.ip.sin_addr), sock_info->remote.ip.sin_port);
+		printf("%-9lu%-9lu%-8lu%-6lu%-8lu%-8lu%-7lu%d\n",
+			   (unsigned long)sock_info->rtt, (unsigned long)sock_info->cwnd,
+			   (unsigned long)sock_info->rexmits, (unsigned long)sock_info->rtos,
+			   (unsigned long)sock_info->recvq, (unsigned long)sock_info->recvq_hwm,
+			   (unsigned long)sock_info->recvq_drops, sock_info->pid);
+		i++;
+		free(sock_info);
+		sock_info = (struct netmon_sock *)sq_remfirst(&q_sock);
+	}
+}
+
+/**
+ * netmon top [-d secs] [-n count] [devname]
+ */
+static int _netmon_top(int argc, char **argv)
+{
+	struct netmon_netdev_stats cur;
+	struct netmon_netdev_stats prev;
+	int interval = NETMON_TOP_INTERVAL;
+	int count = NETMON_TOP_COUNT;
+	int i;
+
+	memset(&cur, 0, sizeof(cur));
+	for (i = 2; i < argc; i++) {
+		if (!strncmp(argv[i], "-d", 3) && i + 1 < argc) {
+			interval = atoi(argv[++i]);
+		} else if (!strncmp(argv[i], "-n", 3) && i + 1 < argc) {
+			count = atoi(argv[++i]);
+		} else if (argv[i][0] != '-') {
+			strncpy(cur.devname, argv[i], IFNAMSIZ);
+			cur.devname[IFNAMSIZ] = '\0';
+		} else {
+			print_help();
+			return ERROR;
+		}
+	}
+	if (interval <= 0 || count <= 0) {
+		print_help();
+		return ERROR;
+	}
+
+	if (cur.devname[0] != '\0' && netlib_netmon_devstats(&cur)) {
+		printf("No device interface %s\n", cur.devname);
+		return ERROR;
+	}
+
+	for (i = 1; i <= count; i++) {
+		sleep(interval);
+		prev = cur;
+		if (cur.devname[0] != '\0' && netlib_netmon_devstats(&cur)) {
+			printf("No device interface %s\n", cur.devname);
+			return ERROR;
+		}
+		print_top(&cur, &prev, interval, i, count);
+	}
+
+	return OK;
+}
+#endif							/* CONFIG_NET_STATS_PERF */
+
 static inline int _print_wifi_info(void)
 {
 #ifdef CONFIG_WIFI_MANAGER
@@ -365,6 +486,12 @@ int cmd_netmon(int argc, char **argv)
 	sq_init(&q_data);
 	int ret;
 
+#ifdef CONFIG_NET_STATS_PERF
+	if (argc >= 2 && !(strncmp(argv[1], "top", strlen("top") + 1))) {
+		return _netmon_top(argc, argv);
+	}
+#endif
+
 	if (argc == 1 || argc > 2) {
 		print_help();
 	} else if (!(strncmp(argv[1], "sock", strlen("sock") + 1))) {
@@ -29,6 +29,7 @@
 
 #define ECP_KEY_INDEX (1)
 #define RSA_KEY_INDEX (2)
+#define AES_KEY_INDEX (3)
 
 #define MBEDTLS_MAX_ECP_KEY_SIZE_ALT       (68)
 #define MBEDTLS_MAX_BUF_SIZE_ALT           (4096)
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file gcm_alt.h
+ *
+ * \brief Galois/Counter Mode (GCM) for 128-bit block ciphers, with the
+ *        counter mode encryption of AES keys done by the security HAL.
+ *
+ * The key is loaded into a SE key slot by mbedtls_gcm_setkey() and each
+ * call to mbedtls_gcm_update() of at least CONFIG_TLS_HW_AES_GCM_THRESHOLD
+ * bytes (a whole TLS record) is encrypted by a single HAL_AES_CTR request.
+ * GHASH, the tag and short inputs are computed in software, and the
+ * software cipher context stays set up so that any HAL failure falls back
+ * to the regular implementation.
+ */
+/*
+ *  Copyright (C) 2006-2015, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of Mbed TLS (https://tls.mbed.org)
+ */
+
+#ifndef MBEDTLS_GCM_ALT_H
+#define MBEDTLS_GCM_ALT_H
+
+#include <stdint.h>
+#include "../cipher.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          The GCM context structure.
+ */
+typedef struct {
+	mbedtls_cipher_context_t cipher_ctx;	/*!< The cipher context used. */
+	uint64_t HL[16];			/*!< Precalculated HTable low. */
+	uint64_t HH[16];			/*!< Precalculated HTable high. */
+	uint64_t len;				/*!< The total length of the encrypted data. */
+	uint64_t add_len;			/*!< The total length of the additional data. */
+	unsigned char base_ectr[16];	/*!< The first ECTR for tag. */
+	unsigned char y[16];		/*!< The Y working value. */
+	unsigned char buf[16];		/*!< The buf working value. */
+	int mode;					/*!< #MBEDTLS_GCM_ENCRYPT or #MBEDTLS_GCM_DECRYPT. */
+	unsigned int keybits;		/*!< The size of the key in the SE. */
+	uint32_t key_idx;			/*!< The SE key slot, 0 if the key is only in software. */
+} mbedtls_gcm_context;
+
+/**
+ * \brief          This function initializes the specified GCM context.
+ */
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx);
+
+/**
+ * \brief          This function associates a GCM context with a key.
+ *                 AES keys are also loaded into a SE key slot when one
+ *                 is free and the offload is enabled.
+ *
+ * \return         \c 0 on success, or a cipher specific error code.
+ */
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, const unsigned char *key, unsigned int keybits);
+
+/**
+ * \brief          This function performs GCM encryption or decryption of a
+ *                 buffer.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input, unsigned char *output, size_t tag_len, unsigned char *tag);
+
+/**
+ * \brief          This function performs a GCM authenticated decryption of a
+ *                 buffer.
+ *
+ * \return         0 if successful and authenticated, or
+ *                 #MBEDTLS_ERR_GCM_AUTH_FAILED if the tag does not match.
+ */
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *tag, size_t tag_len, const unsigned char *input, unsigned char *output);
+
+/**
+ * \brief          This function starts a GCM encryption or decryption
+ *                 operation.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_gcm_starts(mbedtls_gcm_context *ctx, int mode, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len);
+
+/**
+ * \brief          This function feeds an input buffer into an ongoing GCM
+ *                 encryption or decryption operation.  All calls but the
+ *                 last one must use a multiple of 16 bytes.
+ *
+ * \return         \c 0 on success, or #MBEDTLS_ERR_GCM_BAD_INPUT on failure.
+ */
+int mbedtls_gcm_update(mbedtls_gcm_context *ctx, size_t length, const unsigned char *input, unsigned char *output);
+
+/**
+ * \brief          This function finishes the GCM operation and generates
+ *                 the authentication tag.
+ *
+ * \return         \c 0 on success, or #MBEDTLS_ERR_GCM_BAD_INPUT on failure.
+ */
+int mbedtls_gcm_finish(mbedtls_gcm_context *ctx, unsigned char *tag, size_t tag_len);
+
+/**
+ * \brief          This function clears a GCM context and the underlying
+ *                 cipher sub-context, and releases its SE key slot.
+ */
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif							/* gcm_alt.h */
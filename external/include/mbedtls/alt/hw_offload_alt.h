@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file hw_offload_alt.h
+ *
+ * \brief Shared state of the ALT implementations which offload symmetric
+ *        crypto and hashing to the security HAL (MBEDTLS_GCM_ALT,
+ *        MBEDTLS_SHA256_ALT).
+ *
+ * Every offloaded operation keeps a software path.  It is taken when the
+ * offload is switched off, when the input is too small to be worth a round
+ * trip to the SE, or when the HAL fails.  A HAL which answers
+ * HAL_NOT_SUPPORTED or HAL_NOT_IMPLEMENTED for an operation is not asked
+ * again until mbedtls_hw_offload_set(op, 1) is called.
+ */
+
+#ifndef MBEDTLS_HW_OFFLOAD_ALT_H
+#define MBEDTLS_HW_OFFLOAD_ALT_H
+
+#include <stdint.h>
+#include <tinyara/seclink.h>
+#include <tinyara/security_hal.h>
+
+#define MBEDTLS_HW_OFFLOAD_AES		0
+#define MBEDTLS_HW_OFFLOAD_SHA256	1
+#define MBEDTLS_HW_OFFLOAD_MAX		2
+
+struct mbedtls_hw_offload_stats {
+	uint32_t hw_ops;			/* operations completed by the HAL */
+	uint32_t sw_ops;			/* operations completed in software */
+	uint32_t hw_failed;			/* HAL errors recovered in software */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief  Tell whether operation 'op' may be sent to the HAL.
+ */
+int mbedtls_hw_offload_enabled(int op);
+
+/**
+ * \brief  Switch the offload of operation 'op' on or off at runtime.
+ *         Contexts set up while the offload was on keep their SE key until
+ *         they are freed, so the switch applies to new contexts only.
+ */
+void mbedtls_hw_offload_set(int op, int enable);
+
+/**
+ * \brief  Shared seclink handle of the ALT implementations.
+ *
+ * \return The handle, or NULL if the seclink driver can not be opened.
+ */
+sl_ctx mbedtls_hw_offload_handle(void);
+
+/**
+ * \brief  Account the result of an offloaded operation.  'hres' is the HAL
+ *         result, or HAL_FAIL if the seclink call itself failed.  A
+ *         HAL_NOT_SUPPORTED or HAL_NOT_IMPLEMENTED result switches the
+ *         offload of 'op' off.
+ */
+void mbedtls_hw_offload_result(int op, hal_result_e hres);
+
+/**
+ * \brief  Account an operation of 'op' which ran in software.
+ */
+void mbedtls_hw_offload_sw(int op);
+
+/**
+ * \brief  Reserve a SE key slot for a symmetric key.
+ *
+ * \return The key index, or 0 if all slots are in use.
+ */
+uint32_t mbedtls_hw_offload_key_alloc(void);
+
+/**
+ * \brief  Release a key index returned by mbedtls_hw_offload_key_alloc().
+ */
+void mbedtls_hw_offload_key_free(uint32_t key_idx);
+
+/**
+ * \brief  Read (and with 'reset' set, clear) the counters of operation 'op'.
+ */
+void mbedtls_hw_offload_stats(int op, struct mbedtls_hw_offload_stats *stats, int reset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* MBEDTLS_HW_OFFLOAD_ALT_H */
@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file sha256_alt.h
+ *
+ * \brief SHA-224 and SHA-256 with the digest computed by the security HAL.
+ *
+ * The HAL hashes a whole message in one request, so the input is collected
+ * in the context until mbedtls_sha256_finish_ret().  Messages shorter than
+ * CONFIG_TLS_HW_SHA256_MIN_LEN are hashed in software, as the round trip
+ * to the SE costs more than the digest.  A message that grows beyond
+ * CONFIG_TLS_HW_SHA256_MAX_LEN, or a HAL failure, moves the context to the
+ * software implementation without losing the data already fed.
+ */
+/*
+ *  Copyright (C) 2006-2015, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of Mbed TLS (https://tls.mbed.org)
+ */
+
+#ifndef MBEDTLS_SHA256_ALT_H
+#define MBEDTLS_SHA256_ALT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          The SHA-256 context structure.
+ */
+typedef struct {
+	uint32_t total[2];			/*!< The number of Bytes processed. */
+	uint32_t state[8];			/*!< The intermediate digest state. */
+	unsigned char buffer[64];	/*!< The data block being processed. */
+	int is224;					/*!< 0: SHA-256, 1: SHA-224. */
+	int sw;						/*!< Set once the digest is computed in software. */
+	unsigned char *msg;			/*!< The message collected for the HAL. */
+	size_t msg_len;				/*!< The length of the collected message. */
+	size_t msg_size;			/*!< The size of the \c msg buffer. */
+} mbedtls_sha256_context;
+
+/**
+ * \brief          This function initializes a SHA-256 context.
+ */
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx);
+
+/**
+ * \brief          This function clears a SHA-256 context.
+ */
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx);
+
+/**
+ * \brief          This function clones the state of a SHA-256 context.
+ *                 \p dst must have been initialized.
+ */
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst, const mbedtls_sha256_context *src);
+
+/**
+ * \brief          This function starts a SHA-224 or SHA-256 checksum
+ *                 calculation.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224);
+
+/**
+ * \brief          This function feeds an input buffer into an ongoing
+ *                 SHA-256 checksum calculation.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen);
+
+/**
+ * \brief          This function finishes the SHA-256 operation, and writes
+ *                 the result to the output buffer.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[32]);
+
+/**
+ * \brief          This function processes a single data block within
+ *                 the ongoing software SHA-256 computation. This function
+ *                 is for internal use only.
+ *
+ * \return         \c 0 on success.
+ */
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64]);
+
+#if !defined(MBEDTLS_DEPRECATED_REMOVED)
+void mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224);
+void mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen);
+void mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char output[32]);
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64]);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif							/* sha256_alt.h */
@@ -2848,12 +2848,24 @@
 //#define MBEDTLS_PLATFORM_NV_SEED_WRITE_MACRO  mbedtls_platform_std_nv_seed_write /**< Default nv_seed_write function to use, can be undefined */
 
 /* SSL Cache options */
+#if defined(CONFIG_TLS_SERVER_SESSION_CACHE_TIMEOUT)
+#define MBEDTLS_SSL_CACHE_DEFAULT_TIMEOUT       CONFIG_TLS_SERVER_SESSION_CACHE_TIMEOUT
+#else
 //#define MBEDTLS_SSL_CACHE_DEFAULT_TIMEOUT       86400 /**< 1 day  */
+#endif
+#if defined(CONFIG_TLS_SERVER_SESSION_CACHE_ENTRIES)
+#define MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES      CONFIG_TLS_SERVER_SESSION_CACHE_ENTRIES
+#else
 #define MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES      2 /**< Maximum entries in cache */
+#endif
 
 /* SSL options */
 //#define MBEDTLS_SSL_MAX_CONTENT_LEN             16384 /**< Maxium fragment length in bytes, determines the size of each of the two internal I/O buffers */
+#if defined(CONFIG_TLS_SESSION_TICKET_LIFETIME)
+#define MBEDTLS_SSL_DEFAULT_TICKET_LIFETIME     CONFIG_TLS_SESSION_TICKET_LIFETIME
+#else
 //#define MBEDTLS_SSL_DEFAULT_TICKET_LIFETIME     86400 /**< Lifetime of session tickets (if enabled) */
+#endif
 //#define MBEDTLS_PSK_MAX_LEN               32 /**< Max size of TLS pre-shared keys, in bytes (default 256 bits) */
 //#define MBEDTLS_SSL_COOKIE_TIMEOUT        60 /**< Default expiration delay of DTLS cookies, in seconds if HAVE_TIME, or in number of cookies issued */
 
@@ -2953,6 +2965,14 @@
 #undef MBEDTLS_PK_RSA_ALT_SUPPORT
 #endif
 
+#if defined(CONFIG_TLS_HW_AES_GCM)
+#define MBEDTLS_GCM_ALT
+#endif
+
+#if defined(CONFIG_TLS_HW_SHA256)
+#define MBEDTLS_SHA256_ALT
+#endif
+
 #endif /* CONFIG_SE */
 
 /**
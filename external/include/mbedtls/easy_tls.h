@@ -34,6 +34,10 @@
 #include "mbedtls/ssl_cache.h"
 #endif
 
+#ifdef CONFIG_TLS_SESSION_TICKETS
+#include "mbedtls/ssl_ticket.h"
+#endif
+
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -80,6 +84,9 @@ typedef struct tls_context {
 	mbedtls_ssl_cookie_ctx *cookie;
 #ifdef MBEDTLS_SSL_CACHE_C
 	mbedtls_ssl_cache_context *cache;
+#endif
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	mbedtls_ssl_ticket_context *ticket;
 #endif
 	bool use_se;
 } tls_ctx;
@@ -284,7 +284,7 @@ void mbedtls_gcm_free( mbedtls_gcm_context *ctx );
 #endif
 
 #else  /* !MBEDTLS_GCM_ALT */
-#include "gcm_alt.h"
+#include "alt/gcm_alt.h"
 #endif /* !MBEDTLS_GCM_ALT */
 
 #ifdef __cplusplus
@@ -218,7 +218,7 @@ MBEDTLS_DEPRECATED void mbedtls_sha256_process( mbedtls_sha256_context *ctx,
 #endif
 
 #else  /* MBEDTLS_SHA256_ALT */
-#include "sha256_alt.h"
+#include "alt/sha256_alt.h"
 #endif /* MBEDTLS_SHA256_ALT */
 
 #ifdef __cplusplus
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __TLS_SESSION_CACHE_H
+#define __TLS_SESSION_CACHE_H
+
+#include <stdint.h>
+
+#include "mbedtls/config.h"
+#include "mbedtls/ssl.h"
+
+/*
+ * Client side TLS session cache.
+ *
+ * A client that reconnects to the same server can resume the previous
+ * session (by session id or RFC 5077 ticket) instead of running a full
+ * handshake, which skips the certificate verification and the key
+ * exchange.  Sessions are kept per (host, port) in a small table sized by
+ * CONFIG_TLS_SESSION_CACHE_ENTRIES; the least recently used entry is
+ * replaced when the table is full.
+ *
+ * Since a resumed handshake does not check the server certificate again,
+ * only sessions whose certificate was verified (authmode OPTIONAL or
+ * REQUIRED with a clean verify result) are stored.  Each entry also records
+ * a digest of the ssl configuration it was verified under: authmode, the
+ * verify callback, the trusted CAs and CRLs and the client's own
+ * certificate.  A client whose configuration differs in any of these never
+ * resumes that session; it runs a full handshake and gets an entry of its
+ * own.
+ *
+ * To save memory the peer certificate chain is not kept with a cached
+ * session, so mbedtls_ssl_get_peer_cert() returns NULL after a resumed
+ * handshake.  Tickets longer than CONFIG_TLS_SESSION_CACHE_MAX_TICKET
+ * are dropped and the session is resumed by id only.
+ */
+
+/**
+ * @brief tls_session_cache_get() looks up a cached session for host:port and
+ *        sets it on 'ssl' so that the next handshake tries to resume it.
+ *        Call it after mbedtls_ssl_setup() and before the handshake.
+ *        Only a session stored under the same ssl configuration (see
+ *        above) is used.  If the handshake resumes it,
+ *        mbedtls_ssl_get_peer_cert() returns NULL afterwards; use
+ *        tls_session_cache_resumed() to tell the cases apart.
+ *
+ * @param[in] host	server name used as cache key (e.g. the SNI host name)
+ * @param[in] port	server port used as cache key
+ * @param[in] ssl	client ssl context
+ * @return On success,	0 will be returned.
+ *         If no valid session is cached, 1 will be returned and the
+ *         handshake will be a full one.
+ *         On failure,	negative mbedtls error value will be returned.
+ */
+int tls_session_cache_get(const char *host, uint16_t port, mbedtls_ssl_context *ssl);
+
+/**
+ * @brief tls_session_cache_set() stores the session of 'ssl' for host:port.
+ *        Call it after a successful handshake.  Sessions whose peer
+ *        certificate was not verified are not stored.
+ *
+ * @param[in] host	server name used as cache key
+ * @param[in] port	server port used as cache key
+ * @param[in] ssl	client ssl context which completed a handshake
+ * @return On success,	0 will be returned.
+ *         On failure,	negative mbedtls error value will be returned.
+ */
+int tls_session_cache_set(const char *host, uint16_t port, const mbedtls_ssl_context *ssl);
+
+/**
+ * @brief tls_session_cache_remove() drops the cached sessions for
+ *        host:port, e.g. after the server rejected one.
+ */
+void tls_session_cache_remove(const char *host, uint16_t port);
+
+/**
+ * @brief tls_session_cache_flush() drops all cached sessions.
+ */
+void tls_session_cache_flush(void);
+
+/**
+ * @brief tls_session_cache_resumed() tells whether the last handshake of
+ *        'ssl' resumed a cached session.  Call it before storing the new
+ *        session with tls_session_cache_set().
+ *
+ * @return 1 if the session was resumed, 0 after a full handshake.
+ */
+int tls_session_cache_resumed(const mbedtls_ssl_context *ssl);
+
+#endif							/* __TLS_SESSION_CACHE_H */
@@ -63,6 +63,9 @@
 #include "mbedtls/error.h"
 #include "mbedtls/debug.h"
 #include "mbedtls/ssl_cache.h"
+#ifdef CONFIG_TLS_SESSION_TICKETS
+#include "mbedtls/ssl_ticket.h"
+#endif
 #endif
 
 /****************************************************************************
@@ -190,6 +193,10 @@ struct http_server_t {
 	mbedtls_x509_crt          tls_srvcert;
 	mbedtls_pk_context        tls_pkey;
 	mbedtls_ssl_cache_context tls_cache;
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	mbedtls_ssl_ticket_context tls_ticket;
+#endif
+	pthread_mutex_t           tls_cache_lock;
 	mbedtls_net_context       tls_ctx;
 #endif
 
@@ -0,0 +1,682 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ *  NIST SP800-38D compliant GCM implementation
+ *
+ *  Copyright (C) 2006-2015, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of mbed TLS (https://tls.mbed.org)
+ */
+
+/*
+ * http://csrc.nist.gov/publications/nistpubs/800-38D/SP-800-38D.pdf
+ *
+ * See also:
+ * [MGV] http://csrc.nist.gov/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-revised-spec.pdf
+ *
+ * We use the algorithm described as Shoup's method with 4-bit tables in
+ * [MGV] 4.1, pp. 12-13, to enhance speed without using too much memory.
+ */
+
+#include <tinyara/config.h>
+#include <tinyara/seclink.h>
+#include <tinyara/security_hal.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+
+#include "mbedtls/gcm.h"
+
+#include <string.h>
+
+#if defined(MBEDTLS_AESNI_C)
+#include "mbedtls/aesni.h"
+#endif
+
+#if defined(MBEDTLS_GCM_ALT)
+
+#include "mbedtls/alt/hw_offload_alt.h"
+
+#ifndef CONFIG_TLS_HW_AES_GCM_THRESHOLD
+#define CONFIG_TLS_HW_AES_GCM_THRESHOLD	256
+#endif
+
+/*
+ * 32-bit integer manipulation macros (big endian)
+ */
+#ifndef GET_UINT32_BE
+#define GET_UINT32_BE(n, b, i)                          \
+{                                                       \
+	(n) = ((uint32_t) (b)[(i)    ] << 24)               \
+		| ((uint32_t) (b)[(i) + 1] << 16)               \
+		| ((uint32_t) (b)[(i) + 2] <<  8)               \
+		| ((uint32_t) (b)[(i) + 3]);                    \
+}
+#endif
+
+#ifndef PUT_UINT32_BE
+#define PUT_UINT32_BE(n, b, i)                          \
+{                                                       \
+	(b)[(i)    ] = (unsigned char) ((n) >> 24);         \
+	(b)[(i) + 1] = (unsigned char) ((n) >> 16);         \
+	(b)[(i) + 2] = (unsigned char) ((n) >>  8);         \
+	(b)[(i) + 3] = (unsigned char) ((n));               \
+}
+#endif
+
+/* Implementation that should never be optimized out by the compiler */
+static void mbedtls_zeroize(void *v, size_t n)
+{
+	volatile unsigned char *p = v;
+	while (n--) {
+		*p++ = 0;
+	}
+}
+
+/*
+ * Initialize a context
+ */
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx)
+{
+	memset(ctx, 0, sizeof(mbedtls_gcm_context));
+}
+
+/*
+ * Precompute small multiples of H, that is set
+ *      HH[i] || HL[i] = H times i,
+ * where i is seen as a field element as in [MGV], ie high-order bits
+ * correspond to low powers of P. The result is stored in the same way, that
+ * is the high-order bit of HH corresponds to P^0 and the low-order bit of HL
+ * corresponds to P^127.
+ */
+static int gcm_gen_table(mbedtls_gcm_context *ctx)
+{
+	int ret, i, j;
+	uint64_t hi, lo;
+	uint64_t vl, vh;
+	unsigned char h[16];
+	size_t olen = 0;
+
+	memset(h, 0, 16);
+	if ((ret = mbedtls_cipher_update(&ctx->cipher_ctx, h, 16, h, &olen)) != 0) {
+		return ret;
+	}
+
+	/* pack h as two 64-bits ints, big-endian */
+	GET_UINT32_BE(hi, h, 0);
+	GET_UINT32_BE(lo, h, 4);
+	vh = (uint64_t)hi << 32 | lo;
+
+	GET_UINT32_BE(hi, h, 8);
+	GET_UINT32_BE(lo, h, 12);
+	vl = (uint64_t)hi << 32 | lo;
+
+	/* 8 = 1000 corresponds to 1 in GF(2^128) */
+	ctx->HL[8] = vl;
+	ctx->HH[8] = vh;
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+	/* With CLMUL support, we need only h, not the rest of the table */
+	if (mbedtls_aesni_has_support(MBEDTLS_AESNI_CLMUL)) {
+		return 0;
+	}
+#endif
+
+	/* 0 corresponds to 0 in GF(2^128) */
+	ctx->HH[0] = 0;
+	ctx->HL[0] = 0;
+
+	for (i = 4; i > 0; i >>= 1) {
+		uint32_t T = (vl & 1) * 0xe1000000U;
+		vl = (vh << 63) | (vl >> 1);
+		vh = (vh >> 1) ^ ((uint64_t)T << 32);
+
+		ctx->HL[i] = vl;
+		ctx->HH[i] = vh;
+	}
+
+	for (i = 2; i <= 8; i *= 2) {
+		uint64_t *HiL = ctx->HL + i, *HiH = ctx->HH + i;
+		vh = *HiH;
+		vl = *HiL;
+		for (j = 1; j < i; j++) {
+			HiH[j] = vh ^ ctx->HH[j];
+			HiL[j] = vl ^ ctx->HL[j];
+		}
+	}
+
+	return 0;
+}
+
+static hal_key_type gcm_hw_key_type(unsigned int keybits)
+{
+	switch (keybits) {
+	case 128:
+		return HAL_KEY_AES_128;
+	case 192:
+		return HAL_KEY_AES_192;
+	default:
+		return HAL_KEY_AES_256;
+	}
+}
+
+/*
+ * Drop the SE copy of the key, the software one stays usable
+ */
+static void gcm_hw_release(mbedtls_gcm_context *ctx)
+{
+	hal_result_e hres;
+	sl_ctx hnd;
+
+	if (ctx->key_idx == 0) {
+		return;
+	}
+
+	hnd = mbedtls_hw_offload_handle();
+	if (hnd != NULL) {
+		sl_remove_key(hnd, gcm_hw_key_type(ctx->keybits), ctx->key_idx, &hres);
+	}
+	mbedtls_hw_offload_key_free(ctx->key_idx);
+	ctx->key_idx = 0;
+	ctx->keybits = 0;
+}
+
+/*
+ * Load an AES key into a free SE key slot.  Failing to do so is not an
+ * error, the context then runs in software only.
+ */
+static void gcm_hw_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, const unsigned char *key, unsigned int keybits)
+{
+	hal_data hkey = {(void *)key, keybits / 8, NULL, 0};
+	hal_result_e hres = HAL_FAIL;
+	uint32_t key_idx;
+	sl_ctx hnd;
+
+	if (cipher != MBEDTLS_CIPHER_ID_AES || (keybits != 128 && keybits != 192 && keybits != 256)) {
+		return;
+	}
+
+	if (!mbedtls_hw_offload_enabled(MBEDTLS_HW_OFFLOAD_AES)) {
+		return;
+	}
+
+	hnd = mbedtls_hw_offload_handle();
+	if (hnd == NULL) {
+		return;
+	}
+
+	key_idx = mbedtls_hw_offload_key_alloc();
+	if (key_idx == 0) {
+		return;
+	}
+
+	if (sl_set_key(hnd, gcm_hw_key_type(keybits), key_idx, &hkey, NULL, &hres) != SECLINK_OK) {
+		hres = HAL_FAIL;
+	}
+	if (hres != HAL_SUCCESS) {
+		mbedtls_hw_offload_result(MBEDTLS_HW_OFFLOAD_AES, hres);
+		mbedtls_hw_offload_key_free(key_idx);
+		return;
+	}
+
+	ctx->key_idx = key_idx;
+	ctx->keybits = keybits;
+}
+
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, const unsigned char *key, unsigned int keybits)
+{
+	int ret;
+	const mbedtls_cipher_info_t *cipher_info;
+
+	cipher_info = mbedtls_cipher_info_from_values(cipher, keybits, MBEDTLS_MODE_ECB);
+	if (cipher_info == NULL) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	if (cipher_info->block_size != 16) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	gcm_hw_release(ctx);
+	mbedtls_cipher_free(&ctx->cipher_ctx);
+
+	if ((ret = mbedtls_cipher_setup(&ctx->cipher_ctx, cipher_info)) != 0) {
+		return ret;
+	}
+
+	/* The software key is always set up: it computes H and the tag mask,
+	 * and takes over the records the SE can not process.
+	 */
+	if ((ret = mbedtls_cipher_setkey(&ctx->cipher_ctx, key, keybits, MBEDTLS_ENCRYPT)) != 0) {
+		return ret;
+	}
+
+	if ((ret = gcm_gen_table(ctx)) != 0) {
+		return ret;
+	}
+
+	gcm_hw_setkey(ctx, cipher, key, keybits);
+
+	return 0;
+}
+
+/*
+ * Shoup's method for multiplication use this table with
+ *      last4[x] = x times P^128
+ * where x and last4[x] are seen as elements of GF(2^128) as in [MGV]
+ */
+static const uint64_t last4[16] = {
+	0x0000, 0x1c20, 0x3840, 0x2460,
+	0x7080, 0x6ca0, 0x48c0, 0x54e0,
+	0xe100, 0xfd20, 0xd940, 0xc560,
+	0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/*
+ * Sets output to x times H using the precomputed tables.
+ * x and output are seen as elements of GF(2^128) as in [MGV].
+ */
+static void gcm_mult(mbedtls_gcm_context *ctx, const unsigned char x[16], unsigned char output[16])
+{
+	int i = 0;
+	unsigned char lo, hi, rem;
+	uint64_t zh, zl;
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+	if (mbedtls_aesni_has_support(MBEDTLS_AESNI_CLMUL)) {
+		unsigned char h[16];
+
+		PUT_UINT32_BE(ctx->HH[8] >> 32, h, 0);
+		PUT_UINT32_BE(ctx->HH[8], h, 4);
+		PUT_UINT32_BE(ctx->HL[8] >> 32, h, 8);
+		PUT_UINT32_BE(ctx->HL[8], h, 12);
+
+		mbedtls_aesni_gcm_mult(output, x, h);
+		return;
+	}
+#endif							/* MBEDTLS_AESNI_C && MBEDTLS_HAVE_X86_64 */
+
+	lo = x[15] & 0xf;
+
+	zh = ctx->HH[lo];
+	zl = ctx->HL[lo];
+
+	for (i = 15; i >= 0; i--) {
+		lo = x[i] & 0xf;
+		hi = x[i] >> 4;
+
+		if (i != 15) {
+			rem = (unsigned char)zl & 0xf;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4);
+			zh ^= (uint64_t)last4[rem] << 48;
+			zh ^= ctx->HH[lo];
+			zl ^= ctx->HL[lo];
+		}
+
+		rem = (unsigned char)zl & 0xf;
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4);
+		zh ^= (uint64_t)last4[rem] << 48;
+		zh ^= ctx->HH[hi];
+		zl ^= ctx->HL[hi];
+	}
+
+	PUT_UINT32_BE(zh >> 32, output, 0);
+	PUT_UINT32_BE(zh, output, 4);
+	PUT_UINT32_BE(zl >> 32, output, 8);
+	PUT_UINT32_BE(zl, output, 12);
+}
+
+/*
+ * Absorb 'length' bytes of ciphertext into the GHASH state 'buf'
+ */
+static void gcm_ghash(mbedtls_gcm_context *ctx, unsigned char buf[16], const unsigned char *p, size_t length)
+{
+	size_t use_len;
+	size_t i;
+
+	while (length > 0) {
+		use_len = (length < 16) ? length : 16;
+
+		for (i = 0; i < use_len; i++) {
+			buf[i] ^= p[i];
+		}
+
+		gcm_mult(ctx, buf, buf);
+
+		length -= use_len;
+		p += use_len;
+	}
+}
+
+/*
+ * Encrypt or decrypt a whole record with one HAL_AES_CTR request instead of
+ * one block cipher call per 16 bytes.  Returns 0 when the SE did the work,
+ * otherwise the caller runs the software path on the untouched context.
+ */
+static int gcm_hw_update(mbedtls_gcm_context *ctx, size_t length, const unsigned char *input, unsigned char *output)
+{
+	unsigned char ctr[16];
+	unsigned char ghash[16];
+	hal_aes_param param;
+	hal_data in;
+	hal_data out;
+	hal_result_e hres = HAL_FAIL;
+	uint32_t c;
+	size_t blocks = (length + 15) / 16;
+	sl_ctx hnd;
+
+	if (length > UINT32_MAX) {
+		return -1;
+	}
+
+	/* The SE increments the whole counter block, GCM only its low 32 bits,
+	 * so leave the (never seen in TLS) wrapping case to software.
+	 */
+	GET_UINT32_BE(c, ctx->y, 12);
+	if ((uint64_t)c + blocks > 0xFFFFFFFFull) {
+		return -1;
+	}
+
+	hnd = mbedtls_hw_offload_handle();
+	if (hnd == NULL) {
+		return -1;
+	}
+
+	memcpy(ctr, ctx->y, 16);
+	PUT_UINT32_BE(c + 1, ctr, 12);
+
+	param.mode = HAL_AES_CTR;
+	param.iv = ctr;
+	param.iv_len = 16;
+
+	in.data = (void *)input;
+	in.data_len = length;
+	in.priv = NULL;
+	in.priv_len = 0;
+
+	out.data = output;
+	out.data_len = length;
+	out.priv = NULL;
+	out.priv_len = 0;
+
+	/* The record may be processed in place, so hash the ciphertext before
+	 * the SE overwrites it.
+	 */
+	memcpy(ghash, ctx->buf, 16);
+	if (ctx->mode == MBEDTLS_GCM_DECRYPT) {
+		gcm_ghash(ctx, ghash, input, length);
+	}
+
+	if (sl_aes_encrypt(hnd, &in, &param, ctx->key_idx, &out, &hres) != SECLINK_OK) {
+		hres = HAL_FAIL;
+	}
+	if (hres == HAL_SUCCESS && out.data_len != length) {
+		hres = HAL_FAIL;
+	}
+	mbedtls_hw_offload_result(MBEDTLS_HW_OFFLOAD_AES, hres);
+	if (hres != HAL_SUCCESS) {
+		if (!mbedtls_hw_offload_enabled(MBEDTLS_HW_OFFLOAD_AES)) {
+			gcm_hw_release(ctx);
+		}
+		return -1;
+	}
+
+	if (ctx->mode == MBEDTLS_GCM_ENCRYPT) {
+		gcm_ghash(ctx, ghash, output, length);
+	}
+
+	memcpy(ctx->buf, ghash, 16);
+	PUT_UINT32_BE(c + (uint32_t)blocks, ctx->y, 12);
+
+	return 0;
+}
+
+int mbedtls_gcm_starts(mbedtls_gcm_context *ctx, int mode, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len)
+{
+	int ret;
+	unsigned char work_buf[16];
+	size_t i;
+	const unsigned char *p;
+	size_t use_len, olen = 0;
+
+	/* IV and AD are limited to 2^64 bits, so 2^61 bytes */
+	/* IV is not allowed to be zero length */
+	if (iv_len == 0 || ((uint64_t)iv_len) >> 61 != 0 || ((uint64_t)add_len) >> 61 != 0) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	memset(ctx->y, 0x00, sizeof(ctx->y));
+	memset(ctx->buf, 0x00, sizeof(ctx->buf));
+
+	ctx->mode = mode;
+	ctx->len = 0;
+	ctx->add_len = 0;
+
+	if (iv_len == 12) {
+		memcpy(ctx->y, iv, iv_len);
+		ctx->y[15] = 1;
+	} else {
+		memset(work_buf, 0x00, 16);
+		PUT_UINT32_BE(iv_len * 8, work_buf, 12);
+
+		p = iv;
+		while (iv_len > 0) {
+			use_len = (iv_len < 16) ? iv_len : 16;
+
+			for (i = 0; i < use_len; i++) {
+				ctx->y[i] ^= p[i];
+			}
+
+			gcm_mult(ctx, ctx->y, ctx->y);
+
+			iv_len -= use_len;
+			p += use_len;
+		}
+
+		for (i = 0; i < 16; i++) {
+			ctx->y[i] ^= work_buf[i];
+		}
+
+		gcm_mult(ctx, ctx->y, ctx->y);
+	}
+
+	/* A single block: cheaper in software than a round trip to the SE */
+	if ((ret = mbedtls_cipher_update(&ctx->cipher_ctx, ctx->y, 16, ctx->base_ectr, &olen)) != 0) {
+		return ret;
+	}
+
+	ctx->add_len = add_len;
+	gcm_ghash(ctx, ctx->buf, add, add_len);
+
+	return 0;
+}
+
+int mbedtls_gcm_update(mbedtls_gcm_context *ctx, size_t length, const unsigned char *input, unsigned char *output)
+{
+	int ret;
+	unsigned char ectr[16];
+	size_t i;
+	const unsigned char *p;
+	unsigned char *out_p = output;
+	size_t use_len, olen = 0;
+
+	if (output > input && (size_t)(output - input) < length) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	/* Total length is restricted to 2^39 - 256 bits, ie 2^36 - 2^5 bytes
+	 * Also check for possible overflow */
+	if (ctx->len + length < ctx->len || (uint64_t)ctx->len + length > 0xFFFFFFFE0ull) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	if (ctx->key_idx != 0 && length >= CONFIG_TLS_HW_AES_GCM_THRESHOLD) {
+		if (gcm_hw_update(ctx, length, input, output) == 0) {
+			ctx->len += length;
+			return 0;
+		}
+	}
+
+	if (length > 0) {
+		mbedtls_hw_offload_sw(MBEDTLS_HW_OFFLOAD_AES);
+	}
+
+	ctx->len += length;
+
+	p = input;
+	while (length > 0) {
+		use_len = (length < 16) ? length : 16;
+
+		for (i = 16; i > 12; i--) {
+			if (++ctx->y[i - 1] != 0) {
+				break;
+			}
+		}
+
+		if ((ret = mbedtls_cipher_update(&ctx->cipher_ctx, ctx->y, 16, ectr, &olen)) != 0) {
+			return ret;
+		}
+
+		for (i = 0; i < use_len; i++) {
+			if (ctx->mode == MBEDTLS_GCM_DECRYPT) {
+				ctx->buf[i] ^= p[i];
+			}
+			out_p[i] = ectr[i] ^ p[i];
+			if (ctx->mode == MBEDTLS_GCM_ENCRYPT) {
+				ctx->buf[i] ^= out_p[i];
+			}
+		}
+
+		gcm_mult(ctx, ctx->buf, ctx->buf);
+
+		length -= use_len;
+		p += use_len;
+		out_p += use_len;
+	}
+
+	return 0;
+}
+
+int mbedtls_gcm_finish(mbedtls_gcm_context *ctx, unsigned char *tag, size_t tag_len)
+{
+	unsigned char work_buf[16];
+	size_t i;
+	uint64_t orig_len = ctx->len * 8;
+	uint64_t orig_add_len = ctx->add_len * 8;
+
+	if (tag_len > 16 || tag_len < 4) {
+		return MBEDTLS_ERR_GCM_BAD_INPUT;
+	}
+
+	memcpy(tag, ctx->base_ectr, tag_len);
+
+	if (orig_len || orig_add_len) {
+		memset(work_buf, 0x00, 16);
+
+		PUT_UINT32_BE((orig_add_len >> 32), work_buf, 0);
+		PUT_UINT32_BE((orig_add_len), work_buf, 4);
+		PUT_UINT32_BE((orig_len >> 32), work_buf, 8);
+		PUT_UINT32_BE((orig_len), work_buf, 12);
+
+		for (i = 0; i < 16; i++) {
+			ctx->buf[i] ^= work_buf[i];
+		}
+
+		gcm_mult(ctx, ctx->buf, ctx->buf);
+
+		for (i = 0; i < tag_len; i++) {
+			tag[i] ^= ctx->buf[i];
+		}
+	}
+
+	return 0;
+}
+
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input, unsigned char *output, size_t tag_len, unsigned char *tag)
+{
+	int ret;
+
+	if ((ret = mbedtls_gcm_starts(ctx, mode, iv, iv_len, add, add_len)) != 0) {
+		return ret;
+	}
+
+	if ((ret = mbedtls_gcm_update(ctx, length, input, output)) != 0) {
+		return ret;
+	}
+
+	if ((ret = mbedtls_gcm_finish(ctx, tag, tag_len)) != 0) {
+		return ret;
+	}
+
+	return 0;
+}
+
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length, const unsigned char *iv, size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *tag, size_t tag_len, const unsigned char *input, unsigned char *output)
+{
+	int ret;
+	unsigned char check_tag[16];
+	size_t i;
+	int diff;
+
+	if ((ret = mbedtls_gcm_crypt_and_tag(ctx, MBEDTLS_GCM_DECRYPT, length, iv, iv_len, add, add_len, input, output, tag_len, check_tag)) != 0) {
+		return ret;
+	}
+
+	/* Check tag in "constant-time" */
+	for (diff = 0, i = 0; i < tag_len; i++) {
+		diff |= tag[i] ^ check_tag[i];
+	}
+
+	if (diff != 0) {
+		mbedtls_zeroize(output, length);
+		return MBEDTLS_ERR_GCM_AUTH_FAILED;
+	}
+
+	return 0;
+}
+
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx)
+{
+	gcm_hw_release(ctx);
+	mbedtls_cipher_free(&ctx->cipher_ctx);
+	mbedtls_zeroize(ctx, sizeof(mbedtls_gcm_context));
+}
+
+#endif							/* MBEDTLS_GCM_ALT */
+#endif							/* MBEDTLS_GCM_C */
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <tinyara/seclink.h>
+#include <tinyara/security_hal.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_GCM_ALT) || defined(MBEDTLS_SHA256_ALT)
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "mbedtls/alt/common.h"
+#include "mbedtls/alt/hw_offload_alt.h"
+
+#ifndef CONFIG_TLS_HW_AES_KEY_SLOTS
+#define CONFIG_TLS_HW_AES_KEY_SLOTS	2
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_offload_lock = PTHREAD_MUTEX_INITIALIZER;
+static sl_ctx g_offload_hnd;
+static int g_offload_init_failed;
+static uint32_t g_offload_keys;	/* bit n set: key index AES_KEY_INDEX + n in use */
+static uint8_t g_offload_off[MBEDTLS_HW_OFFLOAD_MAX];
+static struct mbedtls_hw_offload_stats g_offload_stats[MBEDTLS_HW_OFFLOAD_MAX];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int mbedtls_hw_offload_enabled(int op)
+{
+	if (op < 0 || op >= MBEDTLS_HW_OFFLOAD_MAX) {
+		return 0;
+	}
+	return !g_offload_off[op] && !g_offload_init_failed;
+}
+
+void mbedtls_hw_offload_set(int op, int enable)
+{
+	if (op < 0 || op >= MBEDTLS_HW_OFFLOAD_MAX) {
+		return;
+	}
+	g_offload_off[op] = !enable;
+}
+
+sl_ctx mbedtls_hw_offload_handle(void)
+{
+	sl_ctx hnd;
+
+	pthread_mutex_lock(&g_offload_lock);
+	if (g_offload_hnd == NULL && !g_offload_init_failed) {
+		/* Opening the driver for every record would cost more than the
+		 * record itself, so the handle is kept for the lifetime of the
+		 * process.
+		 */
+		if (sl_init(&g_offload_hnd) != SECLINK_OK) {
+			g_offload_hnd = NULL;
+			g_offload_init_failed = 1;
+		}
+	}
+	hnd = g_offload_hnd;
+	pthread_mutex_unlock(&g_offload_lock);
+
+	return hnd;
+}
+
+void mbedtls_hw_offload_result(int op, hal_result_e hres)
+{
+	if (op < 0 || op >= MBEDTLS_HW_OFFLOAD_MAX) {
+		return;
+	}
+
+	if (hres == HAL_SUCCESS) {
+		g_offload_stats[op].hw_ops++;
+		return;
+	}
+
+	g_offload_stats[op].hw_failed++;
+	if (hres == HAL_NOT_SUPPORTED || hres == HAL_NOT_IMPLEMENTED) {
+		g_offload_off[op] = 1;
+	}
+}
+
+void mbedtls_hw_offload_sw(int op)
+{
+	if (op < 0 || op >= MBEDTLS_HW_OFFLOAD_MAX) {
+		return;
+	}
+	g_offload_stats[op].sw_ops++;
+}
+
+uint32_t mbedtls_hw_offload_key_alloc(void)
+{
+	uint32_t key_idx = 0;
+	int i;
+
+	pthread_mutex_lock(&g_offload_lock);
+	for (i = 0; i < CONFIG_TLS_HW_AES_KEY_SLOTS && i < 32; i++) {
+		if (!(g_offload_keys & (1u << i))) {
+			g_offload_keys |= 1u << i;
+			key_idx = AES_KEY_INDEX + i;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&g_offload_lock);
+
+	return key_idx;
+}
+
+void mbedtls_hw_offload_key_free(uint32_t key_idx)
+{
+	uint32_t i;
+
+	if (key_idx < AES_KEY_INDEX) {
+		return;
+	}
+
+	i = key_idx - AES_KEY_INDEX;
+	if (i >= CONFIG_TLS_HW_AES_KEY_SLOTS || i >= 32) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_offload_lock);
+	g_offload_keys &= ~(1u << i);
+	pthread_mutex_unlock(&g_offload_lock);
+}
+
+void mbedtls_hw_offload_stats(int op, struct mbedtls_hw_offload_stats *stats, int reset)
+{
+	if (op < 0 || op >= MBEDTLS_HW_OFFLOAD_MAX) {
+		return;
+	}
+
+	if (stats != NULL) {
+		*stats = g_offload_stats[op];
+	}
+	if (reset) {
+		g_offload_stats[op].hw_ops = 0;
+		g_offload_stats[op].sw_ops = 0;
+		g_offload_stats[op].hw_failed = 0;
+	}
+}
+
+#endif							/* MBEDTLS_GCM_ALT || MBEDTLS_SHA256_ALT */
@@ -24,6 +24,11 @@
 
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <arpa/inet.h>
+
+#ifdef CONFIG_TLS_SESSION_CACHE
+#include <mbedtls/tls_session_cache.h>
+#endif
 
 #if defined(CONFIG_TLS_WITH_HW_ACCEL)
 #include <mbedtls/see_cert.h>
@@ -47,6 +52,8 @@
 
 #define PEM_END_CERTIFICATE	"-----END CERTIFICATE-----\r\n"
 
+#define TLS_SESSION_PEER_LEN	64
+
 /****************************************************************************
  * Static Functions
  ****************************************************************************/
@@ -69,6 +76,9 @@ static int tls_context_init(tls_ctx *ctx)
 	mbedtls_ctr_drbg_init(ctx->ctr_drbg);
 #ifdef MBEDTLS_SSL_CACHE_C
 	mbedtls_ssl_cache_init(ctx->cache);
+#endif
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	mbedtls_ssl_ticket_init(ctx->ticket);
 #endif
 	return 0;
 }
@@ -85,6 +95,9 @@ static int tls_context_alloc(tls_ctx *ctx)
 	TLS_MALLOC(mbedtls_timing_delay_context, ctx->timer, sizeof(mbedtls_timing_delay_context));
 #ifdef MBEDTLS_SSL_CACHE_C
 	TLS_MALLOC(mbedtls_ssl_cache_context, ctx->cache, sizeof(mbedtls_ssl_cache_context));
+#endif
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	TLS_MALLOC(mbedtls_ssl_ticket_context, ctx->ticket, sizeof(mbedtls_ssl_ticket_context));
 #endif
 	return 0;
 }
@@ -100,6 +113,9 @@ static void tls_context_free(tls_ctx *ctx)
 		TLS_FREE(ctx->timer);
 #ifdef MBEDTLS_SSL_CACHE_C
 		TLS_FREE(ctx->cache);
+#endif
+#ifdef CONFIG_TLS_SESSION_TICKETS
+		TLS_FREE(ctx->ticket);
 #endif
 		if (ctx->cookie) {
 			TLS_FREE(ctx->cookie);
@@ -117,6 +133,9 @@ static void tls_context_release(tls_ctx *ctx)
 		mbedtls_ctr_drbg_free(ctx->ctr_drbg);
 #ifdef MBEDTLS_SSL_CACHE_C
 		mbedtls_ssl_cache_free(ctx->cache);
+#endif
+#ifdef CONFIG_TLS_SESSION_TICKETS
+		mbedtls_ssl_ticket_free(ctx->ticket);
 #endif
 		if (ctx->cookie) {
 			mbedtls_ssl_cookie_free(ctx->cookie);
@@ -298,6 +317,20 @@ static int tls_set_default(tls_session *session, tls_ctx *ctx, tls_opt *opt)
 		mbedtls_ssl_conf_session_cache(ctx->conf, ctx->cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
 #endif
 
+#if defined(CONFIG_TLS_SESSION_TICKETS)
+	if (opt->server == MBEDTLS_SSL_IS_SERVER && opt->transport == MBEDTLS_SSL_TRANSPORT_STREAM) {
+		/* Keys are set up once per context, they outlive the sessions */
+		if (ctx->ticket->f_rng == NULL) {
+			ret = mbedtls_ssl_ticket_setup(ctx->ticket, mbedtls_ctr_drbg_random, ctx->ctr_drbg, MBEDTLS_CIPHER_AES_256_GCM, CONFIG_TLS_SESSION_TICKET_LIFETIME);
+			if (ret) {
+				ret = TLS_SET_DEFAULT_FAIL;
+				goto errout;
+			}
+		}
+		mbedtls_ssl_conf_session_tickets_cb(ctx->conf, mbedtls_ssl_ticket_write, mbedtls_ssl_ticket_parse, ctx->ticket);
+	}
+#endif
+
 	if (opt->auth_mode <= MBEDTLS_SSL_VERIFY_UNSET) {
 		mbedtls_ssl_conf_authmode(ctx->conf, opt->auth_mode);
 	}
@@ -489,6 +522,42 @@ int easy_tls_net_recv_timeout(void *ctx, unsigned char *buf, size_t len,
 	return( easy_tls_net_recv( ctx, buf, len ) );
 }
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+/* Client sessions are cached per server: the host name given in the options
+ * (or the peer address if there is none) and the peer port.
+ */
+static int tls_session_peer(int fd, tls_opt *opt, char *peer, size_t len, uint16_t *port)
+{
+	struct sockaddr_storage addr;
+	socklen_t n = (socklen_t)sizeof(addr);
+
+	if (getpeername(fd, (struct sockaddr *)&addr, &n) != 0) {
+		return -1;
+	}
+
+	if (addr.ss_family == AF_INET) {
+		struct sockaddr_in *addr4 = (struct sockaddr_in *)&addr;
+		*port = ntohs(addr4->sin_port);
+		if (opt->host_name == NULL && inet_ntop(AF_INET, &addr4->sin_addr, peer, len) == NULL) {
+			return -1;
+		}
+	} else {
+		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)&addr;
+		*port = ntohs(addr6->sin6_port);
+		if (opt->host_name == NULL && inet_ntop(AF_INET6, &addr6->sin6_addr, peer, len) == NULL) {
+			return -1;
+		}
+	}
+
+	if (opt->host_name != NULL) {
+		strncpy(peer, opt->host_name, len - 1);
+		peer[len - 1] = '\0';
+	}
+
+	return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -560,6 +629,11 @@ tls_session *TLSSession(int fd, tls_ctx *ctx, tls_opt *opt)
 	tls_session *session = NULL;
 	int type;
 	socklen_t type_len = (int)sizeof(type);
+#ifdef CONFIG_TLS_SESSION_CACHE
+	char peer[TLS_SESSION_PEER_LEN];
+	uint16_t peer_port = 0;
+	bool cache = false;
+#endif
 
 	if (fd < 0 || ctx == NULL || opt == NULL) {
 		EASY_TLS_DEBUG("TLSSession input error\n");
@@ -687,6 +761,15 @@ reset:
 		mbedtls_ssl_set_bio(session->ssl, &session->net, mbedtls_net_send, mbedtls_net_recv, NULL);
 	}
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	if (opt->server == MBEDTLS_SSL_IS_CLIENT && opt->transport == MBEDTLS_SSL_TRANSPORT_STREAM) {
+		cache = (tls_session_peer(session->net.fd, opt, peer, sizeof(peer), &peer_port) == 0);
+		if (cache && tls_session_cache_get(peer, peer_port, session->ssl) == 0) {
+			EASY_TLS_DEBUG("Resuming session of %s:%u\n", peer, peer_port);
+		}
+	}
+#endif
+
 	EASY_TLS_DEBUG("Handshake start ....\n");
 
 	while ((ret = mbedtls_ssl_handshake(session->ssl)) != 0) {
@@ -704,6 +787,15 @@ reset:
 
 	}
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	if (cache) {
+		if (tls_session_cache_resumed(session->ssl)) {
+			EASY_TLS_DEBUG("Session resumed\n");
+		}
+		tls_session_cache_set(peer, peer_port, session->ssl);
+	}
+#endif
+
 	EASY_TLS_DEBUG("Success !!\n");
 	return session;
 
@@ -0,0 +1,366 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "mbedtls/config.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_internal.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/tls_session_cache.h"
+
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SHA256_C)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_TLS_SESSION_CACHE_ENTRIES
+#define CONFIG_TLS_SESSION_CACHE_ENTRIES	4
+#endif
+
+#ifndef CONFIG_TLS_SESSION_CACHE_TIMEOUT
+#define CONFIG_TLS_SESSION_CACHE_TIMEOUT	3600
+#endif
+
+#ifndef CONFIG_TLS_SESSION_CACHE_MAX_TICKET
+#define CONFIG_TLS_SESSION_CACHE_MAX_TICKET	512
+#endif
+
+/* Host names longer than this are not cached */
+
+#define TLS_SESSION_HOST_MAX	64
+
+#define TLS_SESSION_CONF_ID_LEN	32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tls_session_entry {
+	bool valid;
+	uint16_t port;
+	uint32_t last_use;			/* g_session_clock at the last get or set */
+	char host[TLS_SESSION_HOST_MAX];
+	unsigned char conf_id[TLS_SESSION_CONF_ID_LEN];	/* see tls_session_conf_id() */
+	mbedtls_ssl_session session;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tls_session_entry g_session_cache[CONFIG_TLS_SESSION_CACHE_ENTRIES];
+static pthread_mutex_t g_session_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_session_clock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void tls_session_entry_free(struct tls_session_entry *e)
+{
+	mbedtls_ssl_session_free(&e->session);
+	e->valid = false;
+}
+
+static void tls_session_conf_id_add(mbedtls_sha256_context *sha, const void *buf, uint32_t len)
+{
+	mbedtls_sha256_update_ret(sha, (const unsigned char *)&len, sizeof(len));
+	mbedtls_sha256_update_ret(sha, (const unsigned char *)buf, len);
+}
+
+/* A resumed handshake is checked against nothing but the cached session,
+ * so a session may only be offered again by a client that would have
+ * accepted the same server and would have presented the same certificate.
+ * Digest the settings deciding that: the verify mode and callback, the
+ * trusted CAs and CRLs and our own certificates.  Their contents are hashed
+ * rather than their addresses, since clients such as webclient set up a
+ * new configuration for every connection and the heap may hand a freed
+ * address to a different one.
+ */
+static int tls_session_conf_id(const mbedtls_ssl_config *conf, unsigned char id[TLS_SESSION_CONF_ID_LEN])
+{
+	mbedtls_sha256_context sha;
+	uint32_t authmode = conf->authmode;
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	const mbedtls_x509_crt *crt;
+	const mbedtls_x509_crl *crl;
+	const mbedtls_ssl_key_cert *kc;
+#endif
+	int ret;
+
+	mbedtls_sha256_init(&sha);
+	ret = mbedtls_sha256_starts_ret(&sha, 0);
+	if (ret != 0) {
+		goto out;
+	}
+
+	tls_session_conf_id_add(&sha, &authmode, sizeof(authmode));
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	tls_session_conf_id_add(&sha, &conf->f_vrfy, sizeof(conf->f_vrfy));
+	tls_session_conf_id_add(&sha, &conf->p_vrfy, sizeof(conf->p_vrfy));
+	for (crt = conf->ca_chain; crt != NULL && crt->raw.p != NULL; crt = crt->next) {
+		tls_session_conf_id_add(&sha, crt->raw.p, crt->raw.len);
+	}
+	tls_session_conf_id_add(&sha, NULL, 0);
+#if defined(MBEDTLS_X509_CRL_PARSE_C)
+	for (crl = conf->ca_crl; crl != NULL && crl->raw.p != NULL; crl = crl->next) {
+		tls_session_conf_id_add(&sha, crl->raw.p, crl->raw.len);
+	}
+#endif
+	tls_session_conf_id_add(&sha, NULL, 0);
+	for (kc = conf->key_cert; kc != NULL; kc = kc->next) {
+		for (crt = kc->cert; crt != NULL && crt->raw.p != NULL; crt = crt->next) {
+			tls_session_conf_id_add(&sha, crt->raw.p, crt->raw.len);
+		}
+	}
+#endif
+
+	ret = mbedtls_sha256_finish_ret(&sha, id);
+out:
+	mbedtls_sha256_free(&sha);
+	return ret;
+}
+
+/* Find the entry of host:port made under the configuration 'conf_id', or
+ * any entry of host:port if 'conf_id' is NULL.
+ */
+static struct tls_session_entry *tls_session_find(const char *host, uint16_t port, const unsigned char *conf_id)
+{
+	struct tls_session_entry *e;
+	int i;
+
+	for (i = 0; i < CONFIG_TLS_SESSION_CACHE_ENTRIES; i++) {
+		e = &g_session_cache[i];
+		if (e->valid && e->port == port && strcmp(e->host, host) == 0 && (conf_id == NULL || memcmp(e->conf_id, conf_id, TLS_SESSION_CONF_ID_LEN) == 0)) {
+			return e;
+		}
+	}
+	return NULL;
+}
+
+static bool tls_session_expired(const struct tls_session_entry *e)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+	mbedtls_time_t age = mbedtls_time(NULL) - e->session.start;
+
+	if (age < 0 || age > CONFIG_TLS_SESSION_CACHE_TIMEOUT) {
+		return true;
+	}
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+	if (e->session.ticket != NULL && e->session.ticket_lifetime != 0 && age > (mbedtls_time_t)e->session.ticket_lifetime) {
+		return true;
+	}
+#endif
+#endif
+	return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int tls_session_cache_get(const char *host, uint16_t port, mbedtls_ssl_context *ssl)
+{
+	struct tls_session_entry *e;
+	unsigned char conf_id[TLS_SESSION_CONF_ID_LEN];
+	int ret;
+
+	if (host == NULL || ssl == NULL || ssl->conf == NULL || ssl->conf->endpoint != MBEDTLS_SSL_IS_CLIENT) {
+		return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+	}
+
+	ret = tls_session_conf_id(ssl->conf, conf_id);
+	if (ret != 0) {
+		return ret;
+	}
+	ret = 1;
+
+	pthread_mutex_lock(&g_session_lock);
+
+	/* A session stored under other trust settings is not resumed */
+	e = tls_session_find(host, port, conf_id);
+	if (e != NULL) {
+		if (tls_session_expired(e)) {
+			tls_session_entry_free(e);
+		} else {
+			ret = mbedtls_ssl_set_session(ssl, &e->session);
+			e->last_use = ++g_session_clock;
+		}
+	}
+
+	pthread_mutex_unlock(&g_session_lock);
+	return ret;
+}
+
+int tls_session_cache_set(const char *host, uint16_t port, const mbedtls_ssl_context *ssl)
+{
+	struct tls_session_entry *e;
+	mbedtls_ssl_session session;
+	unsigned char conf_id[TLS_SESSION_CONF_ID_LEN];
+	int ret;
+	int i;
+
+	if (host == NULL || ssl == NULL || ssl->conf == NULL || ssl->conf->endpoint != MBEDTLS_SSL_IS_CLIENT) {
+		return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+	}
+
+	if (strlen(host) >= TLS_SESSION_HOST_MAX) {
+		return 0;
+	}
+
+	/* Resuming a session skips the certificate check, so only sessions
+	 * whose peer certificate was verified may be stored.  With VERIFY_NONE
+	 * the verify result stays 0 without any check being made.
+	 */
+	if (ssl->conf->authmode == MBEDTLS_SSL_VERIFY_NONE || ssl->session == NULL || ssl->session->verify_result != 0) {
+		return 0;
+	}
+
+	ret = tls_session_conf_id(ssl->conf, conf_id);
+	if (ret != 0) {
+		return ret;
+	}
+
+	mbedtls_ssl_session_init(&session);
+	ret = mbedtls_ssl_get_session(ssl, &session);
+	if (ret != 0) {
+		mbedtls_ssl_session_free(&session);
+		return ret;
+	}
+
+	/* Resumption skips the certificate exchange, so the parsed chain is only
+	 * dead weight in the cache.
+	 */
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (session.peer_cert != NULL) {
+		mbedtls_x509_crt_free(session.peer_cert);
+		mbedtls_free(session.peer_cert);
+		session.peer_cert = NULL;
+	}
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+	if (session.ticket != NULL && session.ticket_len > CONFIG_TLS_SESSION_CACHE_MAX_TICKET) {
+		mbedtls_free(session.ticket);
+		session.ticket = NULL;
+		session.ticket_len = 0;
+	}
+	if (session.id_len == 0 && session.ticket == NULL) {
+		mbedtls_ssl_session_free(&session);
+		return 0;
+	}
+#else
+	if (session.id_len == 0) {
+		mbedtls_ssl_session_free(&session);
+		return 0;
+	}
+#endif
+
+	pthread_mutex_lock(&g_session_lock);
+
+	/* Replace the entry of host:port for this configuration, else take a
+	 * free entry, else evict the least recently used one.
+	 */
+	e = tls_session_find(host, port, conf_id);
+	for (i = 0; e == NULL && i < CONFIG_TLS_SESSION_CACHE_ENTRIES; i++) {
+		if (!g_session_cache[i].valid) {
+			e = &g_session_cache[i];
+		}
+	}
+	if (e == NULL) {
+		e = &g_session_cache[0];
+		for (i = 1; i < CONFIG_TLS_SESSION_CACHE_ENTRIES; i++) {
+			if ((int32_t)(g_session_cache[i].last_use - e->last_use) < 0) {
+				e = &g_session_cache[i];
+			}
+		}
+	}
+	if (e->valid) {
+		tls_session_entry_free(e);
+	}
+
+	/* The entry takes over the buffers of 'session' */
+	memcpy(&e->session, &session, sizeof(mbedtls_ssl_session));
+	strncpy(e->host, host, TLS_SESSION_HOST_MAX);
+	memcpy(e->conf_id, conf_id, TLS_SESSION_CONF_ID_LEN);
+	e->port = port;
+	e->last_use = ++g_session_clock;
+	e->valid = true;
+
+	pthread_mutex_unlock(&g_session_lock);
+	return 0;
+}
+
+void tls_session_cache_remove(const char *host, uint16_t port)
+{
+	struct tls_session_entry *e;
+
+	if (host == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_session_lock);
+	while ((e = tls_session_find(host, port, NULL)) != NULL) {
+		tls_session_entry_free(e);
+	}
+	pthread_mutex_unlock(&g_session_lock);
+}
+
+void tls_session_cache_flush(void)
+{
+	int i;
+
+	pthread_mutex_lock(&g_session_lock);
+	for (i = 0; i < CONFIG_TLS_SESSION_CACHE_ENTRIES; i++) {
+		if (g_session_cache[i].valid) {
+			tls_session_entry_free(&g_session_cache[i]);
+		}
+	}
+	pthread_mutex_unlock(&g_session_lock);
+}
+
+int tls_session_cache_resumed(const mbedtls_ssl_context *ssl)
+{
+	int resumed = 0;
+	int i;
+
+	if (ssl == NULL || ssl->session == NULL) {
+		return 0;
+	}
+
+	/* A resumed session keeps the master secret of the cached one, a full
+	 * handshake derives a fresh one.
+	 */
+	pthread_mutex_lock(&g_session_lock);
+	for (i = 0; i < CONFIG_TLS_SESSION_CACHE_ENTRIES && !resumed; i++) {
+		if (g_session_cache[i].valid && memcmp(g_session_cache[i].session.master, ssl->session->master, sizeof(ssl->session->master)) == 0) {
+			resumed = 1;
+		}
+	}
+	pthread_mutex_unlock(&g_session_lock);
+
+	return resumed;
+}
+
+#endif							/* MBEDTLS_SSL_CLI_C && MBEDTLS_SHA256_C */
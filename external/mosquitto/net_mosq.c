@@ -100,6 +100,10 @@ extern unsigned long g_pub_msgs_sent;
 
 #include "config.h"
 
+#if defined(WITH_MBEDTLS) && defined(CONFIG_TLS_SESSION_CACHE)
+#	include <mbedtls/tls_session_cache.h>
+#endif
+
 #ifdef WITH_TLS
 int tls_ex_index_mosq = -1;
 #endif
@@ -538,9 +542,18 @@ int _mosquitto_socket_connect(struct mosquitto *mosq, const char *host, uint16_t
 		((mbedtls_net_context *)mosq->net)->fd = (int)sock;
 		mbedtls_ssl_set_bio(mosq->ssl_ctx, mosq->net, mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+		/* Try to resume the last session with this broker */
+		tls_session_cache_get(host, port, mosq->ssl_ctx);
+#endif
+
 		if (mosquitto__socket_connect_tls(mosq)) {
 			return MOSQ_ERR_TLS;
 		}
+
+#ifdef CONFIG_TLS_SESSION_CACHE
+		tls_session_cache_set(host, port, mosq->ssl_ctx);
+#endif
 	}
 #endif
 
@@ -90,6 +90,10 @@
 #include <tinyara/version.h>
 #include <netutils/netlib.h>
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+#include <mbedtls/tls_session_cache.h>
+#endif
+
 #include "../webserver/http_string_util.h"
 #include "../webserver/http_client.h"
 #include <protocols/webserver/http_err.h>
@@ -601,7 +605,7 @@ void wget_tls_ssl_release(struct http_client_tls_t *client)
 	mbedtls_ssl_free(&(client->tls_ssl));
 }
 
-int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname)
+int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname, uint16_t port)
 {
 	int result = 0;
 
@@ -640,6 +644,11 @@ int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname)
 	mbedtls_ssl_set_bio(&(client->tls_ssl), &(client->tls_client_fd),
 						mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	/* Try to resume the last session with this server */
+	tls_session_cache_get(hostname, port, &(client->tls_ssl));
+#endif
+
 	/* Handshake */
 	while ((result = mbedtls_ssl_handshake(&(client->tls_ssl))) != 0) {
 		if (result != MBEDTLS_ERR_SSL_WANT_READ &&
@@ -651,6 +660,10 @@ int wget_tls_handshake(struct http_client_tls_t *client, const char *hostname)
 
 	ndbg("TLS Handshake Success\n");
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	tls_session_cache_set(hostname, port, &(client->tls_ssl));
+#endif
+
 	return 0;
 HANDSHAKE_FAIL:
 	return result;
@@ -991,7 +1004,7 @@ retry:
 	}
 
 	client_tls->client_fd = sockfd;
-	if (param->tls && (ret = wget_tls_handshake(client_tls, ws.hostname))) {
+	if (param->tls && (ret = wget_tls_handshake(client_tls, ws.hostname, ws.port))) {
 		if (handshake_retry-- > 0) {
 			if (ret == MBEDTLS_ERR_NET_SEND_FAILED ||
 				ret == MBEDTLS_ERR_NET_RECV_FAILED ||
@@ -17,6 +17,8 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
 #include <protocols/webserver/http_err.h>
 #include <protocols/webserver/http_keyvalue_list.h>
 #include <protocols/webclient.h>
@@ -564,6 +566,95 @@ errout:
 	return HTTP_ERROR;
 }
 
+static int http_send_buffer(struct http_client_t *client, const char *buf, int len)
+{
+	int ret;
+
+	while (len > 0) {
+#ifdef CONFIG_NET_SECURITY_TLS
+		if (client->server->tls_init) {
+			ret = mbedtls_ssl_write(&(client->tls_ssl), (const unsigned char *)buf, len);
+		} else
+#endif
+		{
+			ret = send(client->client_fd, buf, len, 0);
+		}
+
+		if (ret < 1) {
+			return HTTP_ERROR;
+		}
+
+		len -= ret;
+		buf += ret;
+	}
+
+	return HTTP_OK;
+}
+
+/* Send the file 'path' as the body of a 200 response.  Without TLS the
+ * file goes to the socket through sendfile(), so the kernel moves the data
+ * without copying it through a user buffer.  TLS records are built here,
+ * so that case reads the file in 'buf' sized chunks and writes them with
+ * mbedtls.
+ */
+static int http_send_file(struct http_client_t *client, const char *path, char *buf, int buflen)
+{
+	struct stat st;
+	off_t offset = 0;
+	ssize_t ret;
+	int len;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+
+	if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+		close(fd);
+		return http_send_response(client, 404, HTTP_ERROR_404, NULL);
+	}
+
+	len = snprintf(buf, buflen, "HTTP/1.1 200 OK\r\n"
+				   "Content-type: text/html\r\n"
+				   "Connection: close\r\n"
+				   "Content-Length: %ld\r\n"
+				   "\r\n", (long)st.st_size);
+	if (http_send_buffer(client, buf, len) == HTTP_ERROR) {
+		goto errout;
+	}
+
+#ifdef CONFIG_NET_SECURITY_TLS
+	if (client->server->tls_init) {
+		while (offset < st.st_size) {
+			ret = read(fd, buf, buflen);
+			if (ret <= 0 || http_send_buffer(client, buf, ret) == HTTP_ERROR) {
+				goto errout;
+			}
+
+			offset += ret;
+		}
+	} else
+#endif
+	{
+		/* sendfile() moves 'offset' past what went out */
+
+		while (offset < st.st_size) {
+			ret = sendfile(client->client_fd, fd, &offset, st.st_size - offset);
+			if (ret <= 0) {
+				goto errout;
+			}
+		}
+	}
+
+	close(fd);
+	return HTTP_OK;
+
+errout:
+	close(fd);
+	return HTTP_ERROR;
+}
+
 void http_handle_file(struct http_client_t *client, int method, const char *url, char *entity)
 {
 	FILE *f;
@@ -573,16 +664,10 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 
 	switch (method) {
 	case HTTP_METHOD_GET:
-		if ((f = fopen(url, "r")) != NULL) {
-			fgets(entity, HTTP_CONF_MAX_ENTITY_LENGTH, f);
-			if (http_send_response(client, 200, entity, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
-			fclose(f);
-		} else {
-			if (http_send_response(client, 404, HTTP_ERROR_404, NULL) == HTTP_ERROR) {
-				HTTP_LOGE("Error: Fail to send response\n");
-			}
+		/* 'entity' only serves as scratch buffer here */
+
+		if (http_send_file(client, url, entity, HTTP_CONF_MAX_ENTITY_LENGTH) == HTTP_ERROR) {
+			HTTP_LOGE("Error: Fail to send response\n");
 		}
 		break;
 	case HTTP_METHOD_POST:
@@ -661,7 +746,7 @@ void http_handle_file(struct http_client_t *client, int method, const char *url,
 int http_send_response(struct http_client_t *client, int status, const char *body, struct http_keyvalue_list_t *headers)
 {
 	char *buf;
-	int buflen = 0, ret, sndlen;
+	int buflen = 0, ret;
 	struct http_keyvalue_t *cur = NULL;
 
 	buf = HTTP_MALLOC(HTTP_CONF_MAX_REQUEST_LENGTH);
@@ -717,26 +802,7 @@ int http_send_response(struct http_client_t *client, int status, const char *bod
 		}
 	}
 
-	sndlen = strlen(buf);
-	buflen = 0;
-	while (sndlen > 0) {
-#ifdef CONFIG_NET_SECURITY_TLS
-		if (client->server->tls_init) {
-			ret = mbedtls_ssl_write(&(client->tls_ssl), (unsigned char *)buf + buflen, sndlen);
-		} else
-#endif
-		{
-			ret = send(client->client_fd, buf + buflen, sndlen, 0);
-		}
-
-		if (ret < 1) {
-			HTTP_FREE(buf);
-			return HTTP_ERROR;
-		} else {
-			sndlen -= ret;
-			buflen += ret;
-		}
-	}
+	ret = http_send_buffer(client, buf, strlen(buf));
 	HTTP_FREE(buf);
-	return HTTP_OK;
+	return ret;
 }
@@ -32,6 +32,61 @@ static void http_tls_debug(void *ctx, int level, const char *file, int line, con
 	HTTP_LOGD("%s:%04d: %s", file, line, str);
 }
 
+/*
+ * Client handler threads run handshakes in parallel, but the session cache
+ * and the ticket keys are not thread safe without MBEDTLS_THREADING_C, so
+ * every access goes through tls_cache_lock.
+ */
+static int http_tls_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	struct http_server_t *server = (struct http_server_t *)data;
+	int result;
+
+	pthread_mutex_lock(&server->tls_cache_lock);
+	result = mbedtls_ssl_cache_get(&server->tls_cache, session);
+	pthread_mutex_unlock(&server->tls_cache_lock);
+
+	return result;
+}
+
+static int http_tls_cache_set(void *data, const mbedtls_ssl_session *session)
+{
+	struct http_server_t *server = (struct http_server_t *)data;
+	int result;
+
+	pthread_mutex_lock(&server->tls_cache_lock);
+	result = mbedtls_ssl_cache_set(&server->tls_cache, session);
+	pthread_mutex_unlock(&server->tls_cache_lock);
+
+	return result;
+}
+
+#ifdef CONFIG_TLS_SESSION_TICKETS
+static int http_tls_ticket_write(void *data, const mbedtls_ssl_session *session, unsigned char *start, const unsigned char *end, size_t *tlen, uint32_t *lifetime)
+{
+	struct http_server_t *server = (struct http_server_t *)data;
+	int result;
+
+	pthread_mutex_lock(&server->tls_cache_lock);
+	result = mbedtls_ssl_ticket_write(&server->tls_ticket, session, start, end, tlen, lifetime);
+	pthread_mutex_unlock(&server->tls_cache_lock);
+
+	return result;
+}
+
+static int http_tls_ticket_parse(void *data, mbedtls_ssl_session *session, unsigned char *buf, size_t len)
+{
+	struct http_server_t *server = (struct http_server_t *)data;
+	int result;
+
+	pthread_mutex_lock(&server->tls_cache_lock);
+	result = mbedtls_ssl_ticket_parse(&server->tls_ticket, session, buf, len);
+	pthread_mutex_unlock(&server->tls_cache_lock);
+
+	return result;
+}
+#endif
+
 int http_tls_init(struct http_server_t *server, struct ssl_config_t *ssl_config)
 {
 	int result = 0;
@@ -50,6 +105,10 @@ int http_tls_init(struct http_server_t *server, struct ssl_config_t *ssl_config)
 	mbedtls_ctr_drbg_init(&(server->tls_ctr_drbg));
 	mbedtls_net_init(&(server->tls_ctx));
 	mbedtls_ssl_cache_init(&(server->tls_cache));
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	mbedtls_ssl_ticket_init(&(server->tls_ticket));
+#endif
+	pthread_mutex_init(&(server->tls_cache_lock), NULL);
 
 #ifdef MBEDTLS_DEBUG_C
 	mbedtls_debug_set_threshold(MBED_DEBUG_LEVEL);
@@ -109,7 +168,7 @@ int http_tls_init(struct http_server_t *server, struct ssl_config_t *ssl_config)
 
 	mbedtls_ssl_conf_rng(&(server->tls_conf), mbedtls_ctr_drbg_random, &(server->tls_ctr_drbg));
 	mbedtls_ssl_conf_dbg(&(server->tls_conf), http_tls_debug, stdout);
-	mbedtls_ssl_conf_session_cache(&(server->tls_conf), &(server->tls_cache), mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+	mbedtls_ssl_conf_session_cache(&(server->tls_conf), server, http_tls_cache_get, http_tls_cache_set);
 
 	/*
 	 * 3. Setup ssl stuffs
@@ -127,6 +186,18 @@ int http_tls_init(struct http_server_t *server, struct ssl_config_t *ssl_config)
 
 	HTTP_LOGD("Ok\n");
 
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	/*
+	 * 4. Setup session tickets
+	 */
+	if ((result = mbedtls_ssl_ticket_setup(&(server->tls_ticket), mbedtls_ctr_drbg_random, &(server->tls_ctr_drbg), MBEDTLS_CIPHER_AES_256_GCM, CONFIG_TLS_SESSION_TICKET_LIFETIME)) != 0) {
+		HTTP_LOGE("Error: mbedtls_ssl_ticket_setup returned -%4x\n", -result);
+		return HTTP_ERROR;
+	}
+
+	mbedtls_ssl_conf_session_tickets_cb(&(server->tls_conf), http_tls_ticket_write, http_tls_ticket_parse, server);
+#endif
+
 	mbedtls_ssl_conf_authmode(&server->tls_conf, ssl_config->auth_mode);
 
 	server->tls_init = 1;
@@ -136,6 +207,10 @@ int http_tls_init(struct http_server_t *server, struct ssl_config_t *ssl_config)
 int http_server_tls_release(struct http_server_t *server)
 {
 	mbedtls_ssl_cache_free(&(server->tls_cache));
+#ifdef CONFIG_TLS_SESSION_TICKETS
+	mbedtls_ssl_ticket_free(&(server->tls_ticket));
+#endif
+	pthread_mutex_destroy(&(server->tls_cache_lock));
 	mbedtls_x509_crt_free(&(server->tls_srvcert));
 	mbedtls_pk_free(&(server->tls_pkey));
 	mbedtls_ssl_config_free(&(server->tls_conf));
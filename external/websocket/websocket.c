@@ -43,6 +43,9 @@
 #include <netutils/netlib.h>
 #include <protocols/websocket.h>
 #include <protocols/wslay/wslay.h>
+#ifdef CONFIG_TLS_SESSION_CACHE
+#include "mbedtls/tls_session_cache.h"
+#endif
 
 /****************************************************************************
  * Definitions
@@ -67,7 +70,7 @@ websocket_t ws_srv_table[WEBSOCKET_MAX_CLIENT];
 
 /****** websocket common functions *****/
 
-int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
+int websocket_tls_handshake(websocket_t *data, char *hostname, uint16_t port, int auth_mode)
 {
 	int r;
 
@@ -98,6 +101,13 @@ int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
 
 	mbedtls_ssl_set_bio(data->tls_ssl, &(data->tls_net), mbedtls_net_send, mbedtls_net_recv, NULL);
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	/* Clients try to resume the last session with this server */
+	if (hostname != NULL) {
+		tls_session_cache_get(hostname, port, data->tls_ssl);
+	}
+#endif
+
 	/* Handshake */
 	WEBSOCKET_DEBUG("  . Performing the SSL/TLS handshake...");
 
@@ -108,6 +118,12 @@ int websocket_tls_handshake(websocket_t *data, char *hostname, int auth_mode)
 		}
 	}
 
+#ifdef CONFIG_TLS_SESSION_CACHE
+	if (hostname != NULL) {
+		tls_session_cache_set(hostname, port, data->tls_ssl);
+	}
+#endif
+
 	WEBSOCKET_DEBUG("OK\n");
 	return WEBSOCKET_SUCCESS;
 }
@@ -413,7 +429,7 @@ TLS_HS_RETRY:
 	}
 
 	if (client->tls_enabled) {
-		if ((r = websocket_tls_handshake(client, host, client->auth_mode)) != WEBSOCKET_SUCCESS) {
+		if ((r = websocket_tls_handshake(client, host, atoi(port), client->auth_mode)) != WEBSOCKET_SUCCESS) {
 			if (r == MBEDTLS_ERR_NET_SEND_FAILED || r == MBEDTLS_ERR_NET_RECV_FAILED || r == MBEDTLS_ERR_SSL_CONN_EOF) {
 				if (tls_hs_retry-- > 0) {
 					WEBSOCKET_DEBUG("Handshake again.... \n");
@@ -536,7 +552,7 @@ int websocket_server_authenticate(websocket_t *server)
 		mbedtls_ssl_init(server->tls_ssl);
 		mbedtls_net_init(&(server->tls_net));
 
-		if ((r = websocket_tls_handshake(server, NULL, server->auth_mode)) != WEBSOCKET_SUCCESS) {
+		if ((r = websocket_tls_handshake(server, NULL, 0, server->auth_mode)) != WEBSOCKET_SUCCESS) {
 			WEBSOCKET_DEBUG("fail to tls handshake\n");
 			r = WEBSOCKET_TLS_HANDSHAKE_ERROR;
 			goto EXIT_SERVER_START;
@@ -172,6 +172,9 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -195,6 +198,8 @@ static db_output_function_t output = printf;
 * @brief initialize database's resources, it must be called for using arastorage
 *
 * @details @b #include <arastorage/arastorage.h>
+* With CONFIG_ARASTORAGE_ENABLE_WAL, the rows committed before a power loss
+* are recovered from the write-ahead log here.
 * @param none
 * @return On success, DB_OK is returned. On failure, a negative value is returned.
 * @since TizenRT v1.0
@@ -232,6 +237,80 @@ db_result_t db_exec(char *format);
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief compile a query sentence once into a statement which can be executed many times
+*
+* @details @b #include <arastorage/arastorage.h>
+* A '?' in place of a value of INSERT, or of an operand in the WHERE clause of
+* SELECT and REMOVE FROM, is a parameter. Parameters are numbered from 0 in
+* the order they appear and get their values with db_bind().
+* @param[in] format query sentence
+* @return On success, a pointer to db_stmt_t is returned. On failure, a NULL is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_stmt_t *db_prepare(char *format);
+
+/**
+* @brief bind a value to a parameter of a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The value stays bound for the following db_step() calls until it is bound again.
+* Parameters of a WHERE clause accept DOMAIN_INT and DOMAIN_LONG only.
+* @param[in] stmt a pointer to statement
+* @param[in] index index of parameter
+* @param[in] domain type of value, DOMAIN_INT, DOMAIN_LONG or DOMAIN_STRING
+* @param[in] value a pointer to int, long or a string, according to domain
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bind(db_stmt_t *stmt, int index, domain_t domain, const void *value);
+
+/**
+* @brief execute a prepared statement with the values currently bound
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @param[out] cursor for SELECT and REMOVE FROM, receives the result which has to be
+*             freed with db_cursor_free(); may be NULL for other statements
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_step(db_stmt_t *stmt, db_cursor_t **cursor);
+
+/**
+* @brief free a prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
+/**
+* @brief start a bulk load of a relation
+*
+* @details @b #include <arastorage/arastorage.h>
+* Until db_bulk_end(), rows inserted into the relation are written to its
+* tuple file only; the keys for its indexes are kept in memory and added in
+* one sorted pass by db_bulk_end(). Queries on an indexed attribute do not
+* see the new rows before then.
+* @param[in] relation name of relation
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bulk_begin(char *relation);
+
+/**
+* @brief finish a bulk load of a relation and build its indexes
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] relation name of relation
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.1 PRE
+*/
+db_result_t db_bulk_end(char *relation);
+
 /**
 * @brief free allocated cursor data, it should be called before application terminated
 *
@@ -242,6 +321,33 @@ db_cursor_t *db_query(char *format);
 */
 db_result_t db_cursor_free(db_cursor_t *cursor);
 
+/**
+* @brief get the number of bytes AraStorage has written to the file system
+*
+* @details @b #include <arastorage/arastorage.h>
+* The count covers tuple, index and schema files and never resets, so the
+* cost of an operation is the difference between two readings.
+* @return The number of bytes written
+* @since TizenRT v2.1 PRE
+*/
+unsigned long db_get_written_bytes(void);
+
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+/**
+* @brief simulate a power loss, for testing crash recovery
+*
+* @details @b #include <arastorage/arastorage.h>
+* Once @p bytes more bytes have been written, the write in progress is cut
+* short and every later write, removal and rename is dropped while reporting
+* success. Call db_deinit(), then db_fault_inject(-1) and db_init() to
+* "reboot".
+* @param[in] bytes bytes written before the power loss, or -1 to restore it
+* @return none
+* @since TizenRT v2.1 PRE
+*/
+void db_fault_inject(long bytes);
+#endif
+
 /**
 * @brief get string corresponding to each result value of API
 *
@@ -197,7 +197,9 @@ int messaging_recv_nonblock(const char *port_name, msg_recv_buf_t *recv_buf, msg
  * @param[in] port_name The message port name.\n
  *		This API should be called from task/pthread who called\n
  *		messaging_recv_nonblock or messaging_unicast_send_async.\n
- *		If this API is not called, memory leak can happen.
+ *		If this API is not called, memory leak can happen.\n
+ *		It also closes the message queues which this task/pthread keeps\n
+ *		open to send to any port, so a sender should call it before it exits.
  * @return On success, OK is returned. On failure, Error is returned.
  * @since TizenRT v3.0 PRE
  */
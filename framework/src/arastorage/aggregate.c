@@ -0,0 +1,294 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file
+ *      Aggregation of the rows selected by a query.
+ *
+ *      The rows are put in groups by the value of the GROUP BY attribute,
+ *      or all in one group without it. The groups live in a table of
+ *      DB_GROUP_LIMIT entries allocated when the query starts, with
+ *      chains of entries whose values share a hash, and each entry keeps
+ *      the running value of every aggregate. A row whose value finds no
+ *      group once the table is full fails the query rather than growing
+ *      it. The result has one row per group, in the order the groups were
+ *      first seen.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aql.h"
+#include "result.h"
+#include "db_options.h"
+#include "db_debug.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define NO_GROUP         -1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct db_groups_s {
+	source_dest_map_t *attr_map;
+	unsigned attribute_count;
+	source_dest_map_t *key;		/* The GROUP BY attribute, or NULL */
+	int limit;
+	int count;
+	int16_t heads[DB_GROUP_LIMIT];
+	int16_t *next;
+	tuple_id_t *rows;			/* The number of rows in each group */
+	unsigned char *keys;
+	double *values;				/* attribute_count values for each group */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static int group_find(db_groups_t *groups, unsigned char *row)
+{
+	attribute_t *attr;
+	unsigned char *ptr;
+	unsigned size;
+	int hash;
+	int group;
+
+	if (groups->key == NULL) {
+		return 0;
+	}
+
+	attr = groups->key->from_attr;
+	size = attr->element_size;
+	ptr = row + groups->key->from_offset;
+	hash = db_value_hash(attr, ptr) % DB_GROUP_LIMIT;
+
+	for (group = groups->heads[hash]; group != NO_GROUP; group = groups->next[group]) {
+		if (db_value_equal(attr, groups->keys + group * size, attr, ptr)) {
+			return group;
+		}
+	}
+
+	if (groups->count == groups->limit) {
+		return NO_GROUP;
+	}
+
+	group = groups->count++;
+	memcpy(groups->keys + group * size, ptr, size);
+	groups->next[group] = groups->heads[hash];
+	groups->heads[hash] = group;
+
+	return group;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+db_groups_t *group_create(source_dest_map_t *attr_map, unsigned attribute_count, char *group_by)
+{
+	db_groups_t *groups;
+	unsigned i;
+
+	groups = (db_groups_t *)malloc(sizeof(db_groups_t));
+	if (groups == NULL) {
+		DB_LOG_E("DB: Failed to allocate the groups\n");
+		return NULL;
+	}
+	memset(groups, 0, sizeof(db_groups_t));
+	memset(groups->heads, 0xff, sizeof(groups->heads));
+	groups->attr_map = attr_map;
+	groups->attribute_count = attribute_count;
+
+	if (group_by != NULL) {
+		for (i = 0; i < attribute_count; i++) {
+			if (attr_map[i].to_attr->aggregator == AQL_NONE && strcmp(attr_map[i].to_attr->name, group_by) == 0) {
+				groups->key = &attr_map[i];
+				break;
+			}
+		}
+		if (groups->key == NULL) {
+			DB_LOG_E("DB: Invalid attribute to group by: %s\n", group_by);
+			free(groups);
+			return NULL;
+		}
+		groups->limit = DB_GROUP_LIMIT;
+		groups->next = (int16_t *)malloc(sizeof(int16_t) * groups->limit);
+		groups->keys = (unsigned char *)malloc(groups->key->from_attr->element_size * groups->limit);
+		if (groups->next == NULL || groups->keys == NULL) {
+			goto errout;
+		}
+	} else {
+		/* Without GROUP BY, the result has a single row even for no rows. */
+		groups->limit = 1;
+		groups->count = 1;
+	}
+
+	groups->rows = (tuple_id_t *)malloc(sizeof(tuple_id_t) * groups->limit);
+	groups->values = (double *)malloc(sizeof(double) * attribute_count * groups->limit);
+	if (groups->rows == NULL || groups->values == NULL) {
+		goto errout;
+	}
+	memset(groups->rows, 0, sizeof(tuple_id_t) * groups->limit);
+	memset(groups->values, 0, sizeof(double) * attribute_count * groups->limit);
+
+	return groups;
+
+errout:
+	DB_LOG_E("DB: Failed to allocate the groups\n");
+	group_free(groups);
+	return NULL;
+}
+
+/* Add a row, laid out as the source of the attribute map, to its group. */
+db_result_t group_add(db_groups_t *groups, unsigned char *row)
+{
+	source_dest_map_t *attr_map_ptr;
+	attribute_value_t value;
+	db_result_t result;
+	double *values;
+	double number;
+	int group;
+	int first;
+	unsigned i;
+
+	group = group_find(groups, row);
+	if (group == NO_GROUP) {
+		DB_LOG_E("DB: The result has more than %d groups\n", DB_GROUP_LIMIT);
+		return DB_LIMIT_ERROR;
+	}
+
+	first = groups->rows[group]++ == 0;
+	values = groups->values + group * groups->attribute_count;
+
+	for (i = 0; i < groups->attribute_count; i++) {
+		attr_map_ptr = &groups->attr_map[i];
+		switch (attr_map_ptr->to_attr->aggregator) {
+		case AQL_NONE:
+			continue;
+		case AQL_COUNT:
+			values[i]++;
+			continue;
+		default:
+			break;
+		}
+
+		result = db_phy_to_value(&value, attr_map_ptr->from_attr, row + attr_map_ptr->from_offset);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		if (value.domain != DOMAIN_INT && value.domain != DOMAIN_LONG) {
+			return DB_TYPE_ERROR;
+		}
+		number = (double)db_value_to_long(&value);
+
+		switch (attr_map_ptr->to_attr->aggregator) {
+		case AQL_SUM:
+		case AQL_MEAN:
+			values[i] += number;
+			break;
+		case AQL_MAX:
+			if (first || number > values[i]) {
+				values[i] = number;
+			}
+			break;
+		case AQL_MIN:
+			if (first || number < values[i]) {
+				values[i] = number;
+			}
+			break;
+		default:
+			return DB_TYPE_ERROR;
+		}
+	}
+
+	return DB_OK;
+}
+
+/* Hand a row for each group over to the cursor. */
+db_result_t group_finish(db_groups_t *groups, db_cursor_t *cursor)
+{
+	source_dest_map_t *attr_map_ptr;
+	attribute_t *to_attr;
+	unsigned char *rows;
+	unsigned char *to_ptr;
+	size_t row_length;
+	db_result_t result;
+	double value;
+	int group;
+	unsigned i;
+
+	row_length = 0;
+	for (i = 0; i < groups->attribute_count; i++) {
+		row_length += groups->attr_map[i].to_attr->element_size;
+	}
+
+	rows = (unsigned char *)malloc(row_length * groups->count + 1);
+	if (rows == NULL) {
+		DB_LOG_E("DB: Failed to allocate the result rows\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(rows, 0, row_length * groups->count + 1);
+
+	for (group = 0; group < groups->count; group++) {
+		for (i = 0; i < groups->attribute_count; i++) {
+			attr_map_ptr = &groups->attr_map[i];
+			to_attr = attr_map_ptr->to_attr;
+			to_ptr = rows + group * row_length + attr_map_ptr->to_offset;
+
+			if (attr_map_ptr == groups->key) {
+				memcpy(to_ptr, groups->keys + group * to_attr->element_size, to_attr->element_size);
+			} else if (to_attr->aggregator != AQL_NONE) {
+				value = groups->values[group * groups->attribute_count + i];
+				if (to_attr->aggregator == AQL_MEAN && groups->rows[group] > 0) {
+					value /= groups->rows[group];
+				}
+				snprintf((char *)to_ptr, to_attr->element_size, "%f", value);
+			}
+		}
+	}
+
+	result = cursor_rows_set(cursor, rows, groups->count, groups->attr_map, groups->attribute_count);
+	if (DB_ERROR(result)) {
+		free(rows);
+	}
+	return result;
+}
+
+void group_free(db_groups_t *groups)
+{
+	if (groups == NULL) {
+		return;
+	}
+	if (groups->next != NULL) {
+		free(groups->next);
+	}
+	if (groups->keys != NULL) {
+		free(groups->keys);
+	}
+	if (groups->rows != NULL) {
+		free(groups->rows);
+	}
+	if (groups->values != NULL) {
+		free(groups->values);
+	}
+	free(groups);
+}
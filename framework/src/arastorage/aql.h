@@ -96,6 +96,8 @@
 #define AQL_FLAG_AGGREGATE              1
 #define AQL_FLAG_SELECT_ALL             2
 #define AQL_FLAG_ASSIGN                 4
+#define AQL_FLAG_GROUP                  8
+#define AQL_FLAG_JOIN                   16
 
 #define AQL_CLEAR(adt)                  aql_clear(adt)
 #define AQL_SET_TYPE(adt, type)  (((adt))->optype = (type))
@@ -124,8 +126,17 @@
 	aql_add_operand_value((adt), (value))
 #define AQL_ATTRIBUTE_COUNT(adt)        ((adt)->attribute_count)
 #define AQL_SET_CONDITION(adt, cond)    ((adt)->lvm_instance = (cond))
+#define AQL_SET_GROUP(adt, attr)        aql_set_group((adt), (attr))
+#define AQL_SET_JOIN(adt, left, right)  aql_set_join((adt), (left), (right))
 #define AQL_ADD_VALUE(adt, domain, value)                               \
 	aql_add_value((adt), (domain), (value))
+#define AQL_ADD_VALUE_PARAM(adt)        aql_add_param((adt), 0)
+#define AQL_ADD_CONDITION_PARAM(adt)    aql_add_param((adt), 1)
+#define AQL_PARAM_COUNT(adt)            ((adt)->param_count)
+
+/* param_value[] entry of a parameter used in the WHERE condition; the
+   others give the index of the value the parameter stands for. */
+#define AQL_PARAM_CONDITION             0xff
 
 /****************************************************************************
 * Public Type Definitions
@@ -193,6 +204,10 @@ enum token_e {
 
 	ATTRIBUTE,
 	BPLUSTREE,					/* 48 */
+	PARAM,
+	HASH,
+	GROUP,
+	BY,							/* 52 */
 
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
@@ -244,10 +259,19 @@ struct aql_adt_s {
 	uint8_t value_count;
 	uint32_t optype;
 	uint8_t flags;
+	uint8_t param_count;
+	uint8_t param_value[AQL_PARAM_LIMIT];
+	char group_by[ATTRIBUTE_NAME_LENGTH + 1];
+	char join_on[2][ATTRIBUTE_NAME_LENGTH + 1];
 	void *lvm_instance;
 };
 typedef struct aql_adt_s aql_adt_t;
 
+struct _db_stmt_s {
+	aql_adt_t adt;
+	uint32_t bound;				/* Bit n is set once parameter n has a value */
+};
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -260,5 +284,10 @@ void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+db_result_t aql_add_param(aql_adt_t *adt, int in_condition);
+db_result_t aql_set_group(aql_adt_t *adt, char *name);
+db_result_t aql_set_join(aql_adt_t *adt, char *left, char *right);
+void aql_free_values(aql_adt_t *adt);
+void aql_plan_cache_clear(void);
 
 #endif							/* !AQL_H */
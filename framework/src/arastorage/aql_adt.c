@@ -85,6 +85,10 @@ void aql_clear(aql_adt_t *adt)
 	adt->attribute_count = 0;
 	adt->value_count = 0;
 	adt->flags = 0;
+	adt->param_count = 0;
+	adt->group_by[0] = '\0';
+	adt->join_on[0][0] = '\0';
+	adt->join_on[1][0] = '\0';
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -160,3 +164,77 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+db_result_t aql_add_param(aql_adt_t *adt, int in_condition)
+{
+	attribute_value_t *value;
+
+	if (adt->param_count == AQL_PARAM_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	if (in_condition) {
+		adt->param_value[adt->param_count++] = AQL_PARAM_CONDITION;
+		return DB_OK;
+	}
+
+	if (adt->value_count == AQL_ATTRIBUTE_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	/* The domain is set when a value is bound. */
+	value = &adt->values[adt->value_count];
+	value->domain = DOMAIN_UNSPECIFIED;
+	VALUE_LONG(value) = 0;
+	adt->param_value[adt->param_count++] = adt->value_count++;
+
+	return DB_OK;
+}
+
+/* Group the rows by an attribute; it is kept in the result even when it
+   is not projected, so that it can be read along with the aggregates. */
+db_result_t aql_set_group(aql_adt_t *adt, char *name)
+{
+	if (strlen(name) + 1 > sizeof(adt->group_by)) {
+		return DB_LIMIT_ERROR;
+	}
+
+	strncpy(adt->group_by, name, sizeof(adt->group_by));
+	adt->group_by[sizeof(adt->group_by) - 1] = '\0';
+	AQL_SET_FLAG(adt, AQL_FLAG_GROUP | AQL_FLAG_AGGREGATE);
+
+	return aql_add_attribute(adt, name, DOMAIN_UNSPECIFIED, 0, 1);
+}
+
+/* Join the rows of the two relations on the equality of two attributes,
+   which may be given in either order. */
+db_result_t aql_set_join(aql_adt_t *adt, char *left, char *right)
+{
+	if (strlen(left) + 1 > sizeof(adt->join_on[0]) || strlen(right) + 1 > sizeof(adt->join_on[1])) {
+		return DB_LIMIT_ERROR;
+	}
+
+	strncpy(adt->join_on[0], left, sizeof(adt->join_on[0]));
+	adt->join_on[0][sizeof(adt->join_on[0]) - 1] = '\0';
+	strncpy(adt->join_on[1], right, sizeof(adt->join_on[1]));
+	adt->join_on[1][sizeof(adt->join_on[1]) - 1] = '\0';
+	AQL_SET_FLAG(adt, AQL_FLAG_JOIN);
+
+	return DB_OK;
+}
+
+/* Free the strings copied by aql_add_value(). */
+void aql_free_values(aql_adt_t *adt)
+{
+	attribute_value_t *value;
+	int i;
+
+	for (i = 0; i < adt->value_count; i++) {
+		value = &adt->values[i];
+		if (value->domain == DOMAIN_STRING && VALUE_STRING(value) != NULL) {
+			free(VALUE_STRING(value));
+			VALUE_STRING(value) = NULL;
+		}
+	}
+	adt->value_count = 0;
+}
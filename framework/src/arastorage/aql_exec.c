@@ -58,16 +58,22 @@
  * Included Files
  ****************************************************************************/
 #include <stdarg.h>
+#include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
 #include "result.h"
 #include "aql.h"
+#include "lvm.h"
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+#include "wal.h"
+#endif
 
 /****************************************************************************
 * Private Functions
@@ -115,92 +121,329 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 		free((*handle)->attr_map);
 		(*handle)->attr_map = NULL;
 	}
+	if ((*handle)->groups != NULL) {
+		group_free((*handle)->groups);
+		(*handle)->groups = NULL;
+	}
 	free(*handle);
 	*handle = NULL;
 	DB_LOG_D("deinit handle!\n");
 	return res;
 }
 
-/****************************************************************************
-* Public Functions
-****************************************************************************/
-db_result_t aql_get_parse_result(char *format, aql_adt_t *adt)
+relation_t *aql_get_relation(aql_adt_t *adt)
+{
+	int first_rel_arg;
+
+	/* If the ASSIGN flag is set, the first relation in the array is
+	   the desired result relation. */
+	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
+	return relation_load(adt->relations[first_rel_arg]);
+}
+
+/* Free what the parser allocated for an adt. */
+static void aql_release_adt(aql_adt_t *adt)
+{
+	aql_free_values(adt);
+	if (adt->lvm_instance != NULL) {
+		free(adt->lvm_instance);
+		adt->lvm_instance = NULL;
+	}
+}
+
+struct aql_plan_s;
+
+#if AQL_PLAN_CACHE_SIZE > 0
+/* A parsed sentence kept for reuse. The entry owns the strings of the
+   values and the LVM program of the adt. Users run a copy of the adt with
+   their own copy of the program, since deriving the ranges writes to it,
+   and hold a reference so that an evicted plan outlives their statement. */
+struct aql_plan_s {
+	char *query;
+	uint32_t hash;
+	uint32_t last_used;
+	int refs;					/* users, plus one while in the cache */
+	aql_adt_t adt;
+};
+
+/* The cache is shared by all threads running statements; it is only
+   locked to look plans up and to add or drop them. */
+static pthread_mutex_t g_plan_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct aql_plan_s *g_plan_cache[AQL_PLAN_CACHE_SIZE];
+static uint32_t g_plan_clock;
+
+static uint32_t aql_plan_hash(const char *query)
+{
+	uint32_t hash = 5381;
+
+	while (*query != '\0') {
+		hash = (hash << 5) + hash + (unsigned char)*query++;
+	}
+	return hash;
+}
+
+static void aql_plan_free(struct aql_plan_s *plan)
+{
+	aql_release_adt(&plan->adt);
+	free(plan->query);
+	free(plan);
+}
+
+/* Drop a reference to plan. Called with g_plan_lock held; returns 1 if
+   the caller has to free the plan once the lock is released. */
+static int aql_plan_unref(struct aql_plan_s *plan)
+{
+	return --plan->refs == 0;
+}
+
+static int aql_plan_cacheable(aql_adt_t *adt)
+{
+	switch (AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt))) {
+	case AQL_TYPE_INSERT:
+	case AQL_TYPE_SELECT:
+	case AQL_TYPE_REMOVE_TUPLES:
+		return AQL_PARAM_COUNT(adt) == 0;
+	default:
+		return 0;
+	}
+}
+
+/* Called with g_plan_lock held. */
+static struct aql_plan_s *aql_plan_lookup(char *format, uint32_t hash)
+{
+	int i;
+
+	for (i = 0; i < AQL_PLAN_CACHE_SIZE; i++) {
+		if (g_plan_cache[i] != NULL && g_plan_cache[i]->hash == hash && strcmp(g_plan_cache[i]->query, format) == 0) {
+			g_plan_cache[i]->last_used = ++g_plan_clock;
+			return g_plan_cache[i];
+		}
+	}
+	return NULL;
+}
+
+/* Give adt a copy of the plan to run, and take a reference to the plan.
+   Called with g_plan_lock held. */
+static db_result_t aql_plan_use(struct aql_plan_s *plan, aql_adt_t *adt)
+{
+	lvm_instance_t *lvm;
+
+	memcpy(adt, &plan->adt, sizeof(aql_adt_t));
+	if (plan->adt.lvm_instance != NULL) {
+		lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
+		if (lvm == NULL) {
+			return DB_ALLOCATION_ERROR;
+		}
+		lvm_clone(lvm, (lvm_instance_t *)plan->adt.lvm_instance);
+		lvm_clear_derivations(lvm);
+		adt->lvm_instance = lvm;
+	}
+	plan->refs++;
+	return DB_OK;
+}
+
+/* Hand a parsed adt over to the cache, evicting the least recently used
+   plan when it is full. Called with g_plan_lock held; returns NULL if the
+   caller still owns the adt. */
+static struct aql_plan_s *aql_plan_store(char *format, uint32_t hash, aql_adt_t *adt, struct aql_plan_s **evicted)
 {
+	struct aql_plan_s *plan;
+	int victim;
+	int i;
+
+	*evicted = NULL;
+
+	/* Another thread may have parsed the same sentence meanwhile */
+	if (aql_plan_lookup(format, hash) != NULL) {
+		return NULL;
+	}
+
+	plan = (struct aql_plan_s *)malloc(sizeof(struct aql_plan_s));
+	if (plan == NULL) {
+		return NULL;
+	}
+	plan->query = (char *)malloc(strlen(format) + 1);
+	if (plan->query == NULL) {
+		free(plan);
+		return NULL;
+	}
+	strcpy(plan->query, format);
+	plan->hash = hash;
+	plan->last_used = ++g_plan_clock;
+	plan->refs = 1;
+	memcpy(&plan->adt, adt, sizeof(aql_adt_t));
+
+	victim = 0;
+	for (i = 0; i < AQL_PLAN_CACHE_SIZE; i++) {
+		if (g_plan_cache[i] == NULL) {
+			victim = i;
+			break;
+		}
+		if (g_plan_cache[i]->last_used < g_plan_cache[victim]->last_used) {
+			victim = i;
+		}
+	}
+	if (g_plan_cache[victim] != NULL) {
+		DB_LOG_D("DB: evict cached plan \"%s\"\n", g_plan_cache[victim]->query);
+		if (aql_plan_unref(g_plan_cache[victim])) {
+			*evicted = g_plan_cache[victim];
+		}
+	}
+	g_plan_cache[victim] = plan;
+	return plan;
+}
+#endif
+
+/* Fill adt with the parse result of format. On success, *plan is the
+   cached plan adt was copied from, to be given back with aql_put_plan(),
+   or NULL if the caller owns the allocations of adt and releases them
+   with aql_release_adt(). */
+static db_result_t aql_get_plan(char *format, aql_adt_t *adt, struct aql_plan_s **plan)
+{
+#if AQL_PLAN_CACHE_SIZE > 0
+	struct aql_plan_s *evicted;
+	db_result_t res;
+	uint32_t hash;
+#endif
+
+	*plan = NULL;
 	if (format == NULL) {
 		return DB_ARGUMENT_ERROR;
 	}
+
+#if AQL_PLAN_CACHE_SIZE > 0
+	hash = aql_plan_hash(format);
+	pthread_mutex_lock(&g_plan_lock);
+	*plan = aql_plan_lookup(format, hash);
+	if (*plan != NULL) {
+		res = aql_plan_use(*plan, adt);
+		pthread_mutex_unlock(&g_plan_lock);
+		if (DB_ERROR(res)) {
+			*plan = NULL;
+		}
+		return res;
+	}
+	pthread_mutex_unlock(&g_plan_lock);
+#endif
+
 	if (AQL_ERROR(aql_parse(adt, format))) {
+		aql_release_adt(adt);
 		return DB_PARSING_ERROR;
 	}
-	return DB_OK;
 
+#if AQL_PLAN_CACHE_SIZE > 0
+	if (aql_plan_cacheable(adt)) {
+		pthread_mutex_lock(&g_plan_lock);
+		*plan = aql_plan_store(format, hash, adt, &evicted);
+		if (*plan != NULL) {
+			res = aql_plan_use(*plan, adt);
+			if (DB_ERROR(res)) {
+				*plan = NULL;
+			}
+		} else {
+			res = DB_OK;
+		}
+		pthread_mutex_unlock(&g_plan_lock);
+		if (evicted != NULL) {
+			aql_plan_free(evicted);
+		}
+		return res;
+	}
+#endif
+	return DB_OK;
 }
 
-relation_t *aql_get_relation(aql_adt_t *adt)
+/* Release what aql_get_plan() gave to adt. */
+static void aql_put_plan(struct aql_plan_s *plan, aql_adt_t *adt)
 {
-	int first_rel_arg;
+#if AQL_PLAN_CACHE_SIZE > 0
+	int last;
 
-	/* If the ASSIGN flag is set, the first relation in the array is
-	   the desired result relation. */
-	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
-	return relation_load(adt->relations[first_rel_arg]);
+	if (plan != NULL) {
+		/* Only the LVM program is the user's own */
+		if (adt->lvm_instance != NULL) {
+			free(adt->lvm_instance);
+			adt->lvm_instance = NULL;
+		}
+		pthread_mutex_lock(&g_plan_lock);
+		last = aql_plan_unref(plan);
+		pthread_mutex_unlock(&g_plan_lock);
+		if (last) {
+			aql_plan_free(plan);
+		}
+		return;
+	}
+#endif
+	aql_release_adt(adt);
 }
 
-db_result_t db_exec(char *format)
+static db_result_t aql_exec_adt(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
 
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
-
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype == AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return DB_ARGUMENT_ERROR;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
 		}
+		if (rel->bulk && optype != AQL_TYPE_INSERT) {
+			/* The rows of a bulk load are not indexed yet */
+			relation_release(rel);
+			return DB_BUSY_ERROR;
+		}
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* Only inserts are logged; other changes start from a checkpoint,
+	   so that no log record refers to what they change. */
+	if (optype != AQL_TYPE_INSERT) {
+		res = wal_checkpoint();
+		if (DB_ERROR(res)) {
+			if (rel != NULL) {
+				relation_release(rel);
+			}
+			return res;
+		}
 	}
+#endif
 
 	res = DB_RELATIONAL_ERROR;
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		if (relation_create(adt->relations[0], DB_STORAGE) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_INSERT:
 		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
+			res = relation_insert(rel, adt->values);
 			if (DB_SUCCESS(res)) {
 				res = DB_OK;
 			}
@@ -209,10 +452,10 @@ db_result_t db_exec(char *format)
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -233,12 +476,18 @@ db_result_t db_exec(char *format)
 	if (rel != NULL) {
 		relation_release(rel);
 	}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* A checkpoint also makes the change durable */
+	if (optype != AQL_TYPE_INSERT && DB_SUCCESS(res)) {
+		res = wal_checkpoint();
+	}
+#endif
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+/* The LVM program stays with the adt, which is released by the caller. */
+static db_cursor_t *aql_query_adt(aql_adt_t *adt)
 {
-	aql_adt_t adt;
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -248,11 +497,7 @@ db_cursor_t *db_query(char *format)
 	handler = NULL;
 	cursor = NULL;
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(adt));
 	if (optype != AQL_OP_TYPE_QUERY) {
 		DB_LOG_E("DB : AQL OP TYPE Error \n");
 		return NULL;
@@ -263,19 +508,29 @@ db_cursor_t *db_query(char *format)
 	}
 #endif
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
 		return NULL;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
+		if (rel->bulk) {
+			DB_LOG_E("DB: Cannot remove from a relation during a bulk load\n");
+			goto errout;
+		}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+		/* Removals are not logged, see aql_exec_adt() */
+		if (DB_ERROR(wal_checkpoint())) {
+			goto errout;
+		}
+#endif
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
@@ -283,7 +538,16 @@ db_cursor_t *db_query(char *format)
 			DB_LOG_E("DB: Init handle failed\n");
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		if (AQL_GET_FLAGS(adt) & AQL_FLAG_JOIN) {
+			/* A join builds its result at once. */
+			cursor = relation_join(&handler, rel, adt);
+			if (cursor == NULL) {
+				DB_LOG_E("DB: Failed relation_join\n");
+				goto errout;
+			}
+			break;
+		}
+		if (DB_ERROR(relation_select(&handler, rel, adt))) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
@@ -299,11 +563,20 @@ db_cursor_t *db_query(char *format)
 		break;
 	}
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	if (optype == AQL_TYPE_REMOVE_TUPLES && DB_ERROR(wal_checkpoint())) {
+		DB_LOG_E("DB: Failed to checkpoint after a removal\n");
+	}
+#endif
+
 	if (rel != NULL) {
 		if (handler == NULL || !(handler->flags & DB_HANDLE_FLAG_PROCESSING)) {
 			relation_release(rel);
 		}
 	}
+	if (handler != NULL) {
+		handler->lvm_instance = NULL;
+	}
 	aql_deinit_handle(&handler);
 
 	return cursor;
@@ -312,8 +585,301 @@ errout:
 	if (rel != NULL) {
 		relation_release(rel);
 	}
-
+	if (handler != NULL) {
+		handler->lvm_instance = NULL;
+	}
 	aql_deinit_handle(&handler);
 
 	return NULL;
 }
+
+/* Run a statement that changes the database, and wait for its commit. */
+static db_result_t aql_exec_stmt(aql_adt_t *adt)
+{
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	db_result_t res;
+	db_result_t commit;
+
+	wal_enter();
+	res = aql_exec_adt(adt);
+	wal_leave();
+
+	/* Outside of the statement, so that commits share log writes */
+	commit = wal_wait_commit();
+	if (DB_SUCCESS(res) && DB_ERROR(commit)) {
+		res = commit;
+	}
+	return res;
+#else
+	return aql_exec_adt(adt);
+#endif
+}
+
+static db_cursor_t *aql_query_stmt(aql_adt_t *adt)
+{
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	db_cursor_t *cursor;
+
+	wal_enter();
+	cursor = aql_query_adt(adt);
+	wal_leave();
+	return cursor;
+#else
+	return aql_query_adt(adt);
+#endif
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+db_result_t db_exec(char *format)
+{
+	db_result_t res;
+	aql_adt_t adt;
+	struct aql_plan_s *plan;
+
+	res = aql_get_plan(format, &adt, &plan);
+	if (DB_ERROR(res)) {
+		DB_LOG_E("DB : Parsing Error in db_exec : %d\n", res);
+		return DB_PARSING_ERROR;
+	}
+
+	res = aql_exec_stmt(&adt);
+	aql_put_plan(plan, &adt);
+	return res;
+}
+
+db_cursor_t *db_query(char *format)
+{
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+	struct aql_plan_s *plan;
+
+	if (DB_ERROR(aql_get_plan(format, &adt, &plan))) {
+		DB_LOG_E("DB : Parsing Error in db_query\n");
+		return NULL;
+	}
+
+	cursor = aql_query_stmt(&adt);
+	aql_put_plan(plan, &adt);
+	return cursor;
+}
+
+void aql_plan_cache_clear(void)
+{
+#if AQL_PLAN_CACHE_SIZE > 0
+	struct aql_plan_s *plan;
+	int i;
+
+	for (i = 0; i < AQL_PLAN_CACHE_SIZE; i++) {
+		pthread_mutex_lock(&g_plan_lock);
+		plan = g_plan_cache[i];
+		g_plan_cache[i] = NULL;
+		if (plan != NULL && !aql_plan_unref(plan)) {
+			plan = NULL;
+		}
+		pthread_mutex_unlock(&g_plan_lock);
+		if (plan != NULL) {
+			aql_plan_free(plan);
+		}
+	}
+#endif
+}
+
+db_stmt_t *db_prepare(char *format)
+{
+	db_stmt_t *stmt;
+
+	if (format == NULL) {
+		return NULL;
+	}
+
+	stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (stmt == NULL) {
+		return NULL;
+	}
+
+	if (AQL_ERROR(aql_parse(&stmt->adt, format))) {
+		DB_LOG_E("DB : Parsing Error in db_prepare\n");
+		aql_release_adt(&stmt->adt);
+		free(stmt);
+		return NULL;
+	}
+	stmt->bound = 0;
+
+	return stmt;
+}
+
+db_result_t db_bind(db_stmt_t *stmt, int index, domain_t domain, const void *value)
+{
+	attribute_value_t *attr_value;
+	unsigned char *str;
+	long l;
+	int str_size;
+
+	if (stmt == NULL || value == NULL || index < 0 || index >= AQL_PARAM_COUNT(&stmt->adt)) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	switch (domain) {
+	case DOMAIN_INT:
+		l = *(const int *)value;
+		break;
+	case DOMAIN_LONG:
+		l = *(const long *)value;
+		break;
+	case DOMAIN_STRING:
+		l = 0;
+		break;
+	default:
+		return DB_TYPE_ERROR;
+	}
+
+	if (stmt->adt.param_value[index] == AQL_PARAM_CONDITION) {
+		/* Parameters of conditions are integers; strings compared in a
+		 * condition have to be written in the query. */
+		if (domain == DOMAIN_STRING) {
+			return DB_TYPE_ERROR;
+		}
+		if (LVM_ERROR(lvm_bind_param((lvm_instance_t *)stmt->adt.lvm_instance, index, l))) {
+			return DB_ARGUMENT_ERROR;
+		}
+		stmt->bound |= (uint32_t)1 << index;
+		return DB_OK;
+	}
+
+	attr_value = &stmt->adt.values[stmt->adt.param_value[index]];
+	if (attr_value->domain == DOMAIN_STRING && VALUE_STRING(attr_value) != NULL) {
+		free(VALUE_STRING(attr_value));
+		VALUE_STRING(attr_value) = NULL;
+	}
+	stmt->bound &= ~((uint32_t)1 << index);
+	attr_value->domain = DOMAIN_UNSPECIFIED;
+
+	if (domain == DOMAIN_STRING) {
+		str_size = strlen((const char *)value);
+		str = (unsigned char *)malloc(str_size + 1);
+		if (str == NULL) {
+			return DB_ALLOCATION_ERROR;
+		}
+		memcpy(str, value, str_size + 1);
+		VALUE_STRING(attr_value) = str;
+	} else {
+		VALUE_LONG(attr_value) = l;
+	}
+	attr_value->domain = domain;
+	stmt->bound |= (uint32_t)1 << index;
+
+	return DB_OK;
+}
+
+db_result_t db_step(db_stmt_t *stmt, db_cursor_t **cursor)
+{
+	aql_adt_t adt;
+	db_cursor_t *result;
+
+	if (cursor != NULL) {
+		*cursor = NULL;
+	}
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (stmt->bound != ((uint32_t)1 << AQL_PARAM_COUNT(&stmt->adt)) - 1) {
+		DB_LOG_E("DB : Unbound parameter in db_step\n");
+		return DB_ARGUMENT_ERROR;
+	}
+
+	/* Execution may rewrite the adt, so run a copy of it. */
+	memcpy(&adt, &stmt->adt, sizeof(aql_adt_t));
+
+	if (AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt)) != AQL_OP_TYPE_QUERY) {
+		return aql_exec_stmt(&adt);
+	}
+
+	if (adt.lvm_instance != NULL) {
+		lvm_clear_derivations((lvm_instance_t *)adt.lvm_instance);
+	}
+	result = aql_query_stmt(&adt);
+	if (result == NULL) {
+		return DB_RELATIONAL_ERROR;
+	}
+	if (cursor != NULL) {
+		*cursor = result;
+	} else {
+		db_cursor_free(result);
+	}
+	return DB_OK;
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	aql_release_adt(&stmt->adt);
+	free(stmt);
+	return DB_OK;
+}
+
+db_result_t db_bulk_begin(char *relation)
+{
+	relation_t *rel;
+	db_result_t res;
+
+	if (relation == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	wal_enter();
+#endif
+	/* The reference taken here keeps the relation and its tuple file
+	   loaded until db_bulk_end(). */
+	rel = relation_load(relation);
+	if (rel == NULL) {
+		res = DB_NAME_ERROR;
+	} else {
+		res = relation_bulk_begin(rel);
+		if (DB_ERROR(res)) {
+			relation_release(rel);
+		}
+	}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	wal_leave();
+#endif
+	return res;
+}
+
+db_result_t db_bulk_end(char *relation)
+{
+	relation_t *rel;
+	db_result_t res;
+
+	if (relation == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	wal_enter();
+#endif
+	rel = relation_load(relation);
+	if (rel == NULL) {
+		res = DB_NAME_ERROR;
+	} else if (!rel->bulk) {
+		relation_release(rel);
+		res = DB_ARGUMENT_ERROR;
+	} else {
+		res = relation_bulk_end(rel);
+
+		/* Drop the reference of db_bulk_begin() as well */
+		relation_release(rel);
+		relation_release(rel);
+	}
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	wal_leave();
+	if (DB_SUCCESS(res)) {
+		res = wal_wait_commit();
+	}
+#endif
+	return res;
+}
@@ -89,8 +89,9 @@ static const struct keyword keywords[] = {
 	{"*", MUL},
 	{"/", DIV},
 	{"#", COMMENT},
+	{"?", PARAM},
 
-	{">=", GEQ},				/* 13 */
+	{">=", GEQ},				/* 14 */
 	{"<=", LEQ},
 	{"<>", NOT_EQUAL},
 	{"<-", ASSIGN},
@@ -98,27 +99,31 @@ static const struct keyword keywords[] = {
 	{"IS", IS},
 	{"ON", ON},
 	{"IN", IN},
+	{"BY", BY},
 
-	{"ALL", ALL},				/* 21 */
+	{"ALL", ALL},				/* 23 */
 	{"AND", AND},
 	{"NOT", NOT},
 	{"SUM", SUM},
 	{"MAX", MAX},
 	{"MIN", MIN},
 	{"INT", INT},
+	{"AVG", MEAN},
 
-	{"INTO", INTO},				/* 28 */
+	{"INTO", INTO},				/* 31 */
 	{"FROM", FROM},
 	{"MEAN", MEAN},
 	{"JOIN", JOIN},
 	{"LONG", LONG},
 	{"TYPE", TYPE},
+	{"HASH", HASH},
 
-	{"WHERE", WHERE},			/* 34 */
+	{"WHERE", WHERE},			/* 38 */
 	{"COUNT", COUNT},
 	{"INDEX", INDEX},
+	{"GROUP", GROUP},
 
-	{"INSERT", INSERT},			/* 37 */
+	{"INSERT", INSERT},			/* 42 */
 	{"SELECT", SELECT},
 	{"REMOVE", REMOVE},
 	{"CREATE", CREATE},
@@ -128,18 +133,18 @@ static const struct keyword keywords[] = {
 	{"INLINE", INLINE},
 	{"REMAIN", REMAIN},
 
-	{"PROJECT", PROJECT},		/* 46 */
+	{"PROJECT", PROJECT},		/* 51 */
 
-	{"RELATION", RELATION},		/* 47 */
+	{"RELATION", RELATION},		/* 52 */
 
-	{"ATTRIBUTE", ATTRIBUTE},	/* 48 */
+	{"ATTRIBUTE", ATTRIBUTE},	/* 53 */
 	{"BPLUSTREE", BPLUSTREE}
 };
 
 /* Provides a pointer to the first keyword of a specific length. */
-static const int8_t skip_hint[] = { 0, 13, 21, 28, 34, 37, 46, 47, 48 };
+static const int8_t skip_hint[] = { 0, 14, 23, 31, 38, 42, 51, 52, 53 };
 
-static char separators[] = "#.;,() \t\n";
+static char separators[] = "#.;,()? \t\n";
 
 /****************************************************************************
 * Private Functions
@@ -250,6 +250,27 @@ PARSER(relations)
 	RETURN(STATUS_OK);
 }
 
+PARSER(join)
+{
+	char left[ATTRIBUTE_NAME_LENGTH + 1];
+
+	/* The relation joined to the one before JOIN, and the attributes
+	   whose values have to be equal. */
+	CONSUME(IDENTIFIER);
+	AQL_ADD_RELATION(adt, VALUE);
+	CONSUME(ON);
+	CONSUME(IDENTIFIER);
+	strncpy(left, VALUE, sizeof(left) - 1);
+	left[sizeof(left) - 1] = '\0';
+	CONSUME(EQUAL);
+	CONSUME(IDENTIFIER);
+	if (DB_ERROR(AQL_SET_JOIN(adt, left, VALUE))) {
+		RETURN(SYNTAX_ERROR);
+	}
+
+	RETURN(STATUS_OK);
+}
+
 PARSER(values)
 {
 	/* Parse comma-separated attribute values. */
@@ -261,6 +282,11 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAM:
+		if (DB_ERROR(AQL_ADD_VALUE_PARAM(adt))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -290,6 +316,9 @@ PARSER(operand)
 		AQL_ADD_PROCESSING_ATTRIBUTE(adt, VALUE);
 		break;
 	case STRING_VALUE:
+		if (LVM_ERROR(lvm_set_string(p, VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
 		break;
 	case FLOAT_VALUE:
 		break;
@@ -298,6 +327,11 @@ PARSER(operand)
 			RETURN(SYNTAX_ERROR);
 		}
 		break;
+	case PARAM:
+		if (LVM_ERROR(lvm_set_param(p, AQL_PARAM_COUNT(adt))) || DB_ERROR(AQL_ADD_CONDITION_PARAM(adt))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -502,6 +536,13 @@ PARSER(select)
 	}
 
 	NEXT;
+	if (TOKEN == JOIN) {
+		if (AQL_RELATION_COUNT(adt) != 1 || !PARSE(join)) {
+			RETURN(SYNTAX_ERROR);
+		}
+		NEXT;
+	}
+
 	if (TOKEN == WHERE) {
 		lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
 		if (lvm == NULL) {
@@ -517,12 +558,25 @@ PARSER(select)
 			AQL_SET_CONDITION(adt, NULL);
 			RETURN(SYNTAX_ERROR);
 		}
-	} else {
-		REWIND;
-		RETURN(STATUS_OK);
+		NEXT;
 	}
 
-	CONSUME(END);
+	if (TOKEN == GROUP) {
+		CONSUME(BY);
+		CONSUME(IDENTIFIER);
+		if (DB_ERROR(AQL_SET_GROUP(adt, VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		NEXT;
+	}
+
+	if (TOKEN != END) {
+		/* A sentence with clauses after the relations ends with ';' */
+		if (adt->lvm_instance != NULL || (AQL_GET_FLAGS(adt) & (AQL_FLAG_JOIN | AQL_FLAG_GROUP))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		REWIND;
+	}
 
 	return STATUS_OK;
 }
@@ -701,6 +755,7 @@ PARSER_TOKEN(index_type)
 	switch (TOKEN) {
 	case INLINE:
 	case BPLUSTREE:
+	case HASH:
 		return TOKEN;
 	default:
 		return NONE;
@@ -738,6 +793,9 @@ PARSER(create_index)
 	case BPLUSTREE:
 		type = INDEX_BPLUSTREE;
 		break;
+	case HASH:
+		type = INDEX_HASH;
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
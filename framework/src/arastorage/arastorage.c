@@ -65,6 +65,9 @@
 #include "db_debug.h"
 #include "result.h"
 #include "aql.h"
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+#include "wal.h"
+#endif
 #include <arastorage/arastorage.h>
 
 /****************************************************************************
@@ -86,15 +89,25 @@ db_result_t db_init(void)
 	if (res != DB_OK) {
 		return res;
 	}
+#endif
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	res = wal_init();
+	if (res != DB_OK) {
+		return res;
+	}
 #endif
 	return res;
 }
 
 db_result_t db_deinit()
 {
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	wal_deinit();
+#endif
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	storage_write_buffer_deinit();
 #endif
+	aql_plan_cache_clear();
 	relation_deinit();
 	index_deinit();
 	return DB_OK;
@@ -105,6 +118,18 @@ void db_set_output_function(db_output_function_t f)
 	output = f;
 }
 
+unsigned long db_get_written_bytes(void)
+{
+	return storage_get_written_bytes();
+}
+
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+void db_fault_inject(long bytes)
+{
+	storage_fault_inject(bytes);
+}
+#endif
+
 const char *db_get_result_message(db_result_t code)
 {
 	switch (code) {
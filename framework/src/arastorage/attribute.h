@@ -78,7 +78,6 @@
 struct attribute_s {
 	struct attribute_s *next;
 	void *index;
-	double aggregation_value;
 	uint8_t aggregator;
 	uint8_t domain;
 	uint8_t element_size;
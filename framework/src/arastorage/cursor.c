@@ -268,7 +268,10 @@ db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *curs
 	attr.domain = cursor->attr_map[col].domain;
 	attr.element_size = cursor->attr_map[col].data_size;
 
-	if (cursor->attr_map[col].valuetype == AGGREGATE_VALUE) {
+	if (cursor->rows != NULL) {
+		/* The result was built in memory, as for grouped aggregates and joins. */
+		buf = cursor->rows + cursor->current_storage_row * cursor->storage_row_length + cursor->attr_map[col].offset;
+	} else if (cursor->attr_map[col].valuetype == AGGREGATE_VALUE) {
 		/* If the type of value is aggregate value, we don't need to read storage.
 		 Because aggregate result is already calculated and stored in buffer. */
 		buf += cursor->attr_map[col].offset;
@@ -411,6 +414,10 @@ void cursor_clean_data(db_cursor_t *cursor)
 		free(cursor->row_arr);
 	}
 	cursor->row_arr = NULL;
+	if (cursor->rows != NULL) {
+		free(cursor->rows);
+	}
+	cursor->rows = NULL;
 }
 
 db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
@@ -450,6 +457,69 @@ db_result_t cursor_deinit(db_cursor_t *cursor)
 		free(cursor->row_arr);
 		cursor->row_arr = NULL;
 	}
+	if (cursor->rows) {
+		free(cursor->rows);
+		cursor->rows = NULL;
+	}
 	free(cursor);
 	return DB_OK;
 }
+
+/* Make the cursor hold nrows rows laid out as the destination of the
+   attribute map; the cursor frees them. */
+db_result_t cursor_rows_set(db_cursor_t *cursor, unsigned char *rows, tuple_id_t nrows, source_dest_map_t *attr_map, attribute_id_t attribute_count)
+{
+	source_dest_map_t *attr_map_ptr;
+	size_t row_length;
+	int arr_size;
+	int i;
+
+	if (cursor == NULL) {
+		DB_LOG_E("DB: Invalid cursor\n");
+		return DB_CURSOR_ERROR;
+	}
+
+	if (nrows > DB_CURSOR_RESULT_ENTRY) {
+		DB_LOG_E("DB: Too many rows for a cursor: %d\n", nrows);
+		return DB_LIMIT_ERROR;
+	}
+
+	arr_size = GET_CURSOR_DATA_ARR_SIZE(nrows);
+	if (cursor->row_arr != NULL) {
+		free(cursor->row_arr);
+	}
+	cursor->row_arr = (uint32_t *)malloc(sizeof(uint32_t) * arr_size);
+	if (cursor->row_arr == NULL) {
+		return DB_CURSOR_ERROR;
+	}
+	memset(cursor->row_arr, 0, arr_size * sizeof(uint32_t));
+	for (i = 0; i < nrows; i++) {
+		BIT_SET(cursor->row_arr[GET_INDEX(i)], GET_POS(i));
+	}
+
+	row_length = 0;
+	attr_map_ptr = attr_map;
+	for (i = 0; i < attribute_count; i++) {
+		memset(cursor->attr_map[i].name, 0, sizeof(cursor->attr_map[i].name));
+		memcpy(cursor->attr_map[i].name, attr_map_ptr->to_attr->name, sizeof(attr_map_ptr->to_attr->name));
+		cursor->attr_map[i].domain = attr_map_ptr->to_attr->domain;
+		cursor->attr_map[i].valuetype = NORMAL_VALUE;
+		cursor->attr_map[i].data_size = attr_map_ptr->to_attr->element_size;
+		cursor->attr_map[i].offset = attr_map_ptr->to_offset;
+		row_length += attr_map_ptr->to_attr->element_size;
+		attr_map_ptr++;
+	}
+
+	if (cursor->rows != NULL) {
+		free(cursor->rows);
+	}
+	cursor->rows = rows;
+	cursor->storage_row_length = row_length;
+	cursor->attribute_count = attribute_count;
+	cursor->total_rows = nrows;
+	cursor->cursor_rows = nrows;
+	cursor->current_cursor_row = -1;
+	cursor->current_storage_row = -1;
+
+	return DB_OK;
+}
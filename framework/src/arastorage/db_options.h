@@ -127,6 +127,46 @@
 #define AQL_ATTRIBUTE_LIMIT             9
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of parameters ('?') in a prepared statement. */
+#ifndef AQL_PARAM_LIMIT
+#define AQL_PARAM_LIMIT                 AQL_ATTRIBUTE_LIMIT
+#endif							/* AQL_PARAM_LIMIT */
+
+/* The number of parsed queries kept for reuse by db_exec() and db_query(). */
+#ifndef AQL_PLAN_CACHE_SIZE
+#ifdef CONFIG_ARASTORAGE_PLAN_CACHE_SIZE
+#define AQL_PLAN_CACHE_SIZE             CONFIG_ARASTORAGE_PLAN_CACHE_SIZE
+#else
+#define AQL_PLAN_CACHE_SIZE             0
+#endif
+#endif							/* AQL_PLAN_CACHE_SIZE */
+
+/* The maximum number of groups in the result of a GROUP BY query. */
+#ifndef DB_GROUP_LIMIT
+#ifdef CONFIG_ARASTORAGE_GROUP_LIMIT
+#define DB_GROUP_LIMIT                  CONFIG_ARASTORAGE_GROUP_LIMIT
+#else
+#define DB_GROUP_LIMIT                  32
+#endif
+#endif							/* DB_GROUP_LIMIT */
+
+/* The memory in bytes a join may take for holding the rows of the
+   relation after JOIN. Larger relations are read again for each row of
+   the first relation, unless the join attribute has an index. */
+#ifndef DB_JOIN_BUFFER_SIZE
+#ifdef CONFIG_ARASTORAGE_JOIN_BUFFER_SIZE
+#define DB_JOIN_BUFFER_SIZE             CONFIG_ARASTORAGE_JOIN_BUFFER_SIZE
+#else
+#define DB_JOIN_BUFFER_SIZE             4096
+#endif
+#endif							/* DB_JOIN_BUFFER_SIZE */
+
+/* The size of an aggregated value in a result row, which keeps it as
+   text. */
+#ifndef DB_AGGREGATE_VALUE_LENGTH
+#define DB_AGGREGATE_VALUE_LENGTH       24
+#endif							/* DB_AGGREGATE_VALUE_LENGTH */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -205,6 +245,10 @@
 
 #define BUCKET_FILE_LENGTH 15
 
+#define HASH_FILE_NAME "hash"
+
+#define HASH_FILE_LENGTH 15
+
 #define TEMP_FILE_SUFFIX ".tmp"
 
 #define TEMP_FILE_SUFFIX_LENGTH 4
@@ -230,11 +274,78 @@
 #define DB_TREE_CACHE_LIMIT             10
 #endif
 
+/* The number of entries by which the list of deferred index keys grows
+   during a bulk load. */
+#ifndef DB_INDEX_DEFERRED_CHUNK
+#define DB_INDEX_DEFERRED_CHUNK         64
+#endif							/* DB_INDEX_DEFERRED_CHUNK */
+
+/* The longest prefix shared by the strings in a B+tree index that is
+   left out of their keys. */
+#ifndef DB_INDEX_KEY_PREFIX_LENGTH
+#define DB_INDEX_KEY_PREFIX_LENGTH      16
+#endif							/* DB_INDEX_KEY_PREFIX_LENGTH */
+
+/* The number of buckets in a hash index. */
+#ifndef DB_HASH_BUCKETS
+#ifdef CONFIG_ARASTORAGE_HASH_INDEX_BUCKETS
+#define DB_HASH_BUCKETS                 CONFIG_ARASTORAGE_HASH_INDEX_BUCKETS
+#else
+#define DB_HASH_BUCKETS                 96
+#endif
+#endif							/* DB_HASH_BUCKETS */
+
+/* The number of entries in a bucket of a hash index. */
+#ifndef DB_HASH_BUCKET_SIZE
+#define DB_HASH_BUCKET_SIZE             16
+#endif							/* DB_HASH_BUCKET_SIZE */
+
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
 #endif
 /*----------------------------------------------------------------------------*/
 
+/* Write-ahead log options. */
+
+#define WAL_FILE_NAME "wal"
+
+/* The size of each of the two log buffers. A log record, which holds
+   a row and the name of its relation, has to fit in one buffer. */
+#ifndef DB_WAL_BUFFER_SIZE
+#ifdef CONFIG_ARASTORAGE_WAL_BUFFER_SIZE
+#define DB_WAL_BUFFER_SIZE              CONFIG_ARASTORAGE_WAL_BUFFER_SIZE
+#else
+#define DB_WAL_BUFFER_SIZE              1024
+#endif
+#endif							/* DB_WAL_BUFFER_SIZE */
+
+/* The size of the log at which a checkpoint starts in the background.
+   0 leaves checkpoints to schema changes, removals and db_deinit(). */
+#ifndef DB_WAL_CHECKPOINT_SIZE
+#ifdef CONFIG_ARASTORAGE_WAL_CHECKPOINT_SIZE
+#define DB_WAL_CHECKPOINT_SIZE          CONFIG_ARASTORAGE_WAL_CHECKPOINT_SIZE
+#else
+#define DB_WAL_CHECKPOINT_SIZE          16384
+#endif
+#endif							/* DB_WAL_CHECKPOINT_SIZE */
+
+/* The time in microseconds a commit waits for others to join its log
+   write. */
+#ifndef DB_WAL_COMMIT_DELAY
+#ifdef CONFIG_ARASTORAGE_WAL_COMMIT_DELAY
+#define DB_WAL_COMMIT_DELAY             CONFIG_ARASTORAGE_WAL_COMMIT_DELAY
+#else
+#define DB_WAL_COMMIT_DELAY             0
+#endif
+#endif							/* DB_WAL_COMMIT_DELAY */
+
+/* The maximum number of bulk loads in progress at the same time. */
+#ifndef DB_WAL_TXN_LIMIT
+#define DB_WAL_TXN_LIMIT                4
+#endif							/* DB_WAL_TXN_LIMIT */
+
+/*----------------------------------------------------------------------------*/
+
 /* LVM options. */
 
 /* The maximum length of a variable in LVM. This value should preferably
@@ -249,6 +360,11 @@
 #define LVM_MAX_VARIABLE_ID             AQL_ATTRIBUTE_LIMIT - 1
 #endif							/* LVM_MAX_VARIABLE_ID */
 
+/* The space for the string constants of a single database query. */
+#ifndef LVM_STRING_POOL_SIZE
+#define LVM_STRING_POOL_SIZE            AQL_MAX_QUERY_LENGTH
+#endif							/* LVM_STRING_POOL_SIZE */
+
 /* Specify whether floats should be used or not inside the LVM. */
 #ifndef LVM_USE_FLOATS
 #define LVM_USE_FLOATS                  DB_FEATURE_FLOATS
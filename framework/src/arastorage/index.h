@@ -77,7 +77,8 @@ struct index_api_s;
 enum index_e {
 	INDEX_NONE = 0,
 	INDEX_INLINE = 1,
-	INDEX_BPLUSTREE = 2
+	INDEX_BPLUSTREE = 2,
+	INDEX_HASH = 3
 };
 typedef enum index_e index_type_t;
 
@@ -87,6 +88,14 @@ enum index_state_e {
 };
 typedef enum index_state_e index_state_t;
 
+/* A key and the tuple it refers to, collected while index maintenance
+   is deferred. */
+struct index_entry_s {
+	long key;
+	tuple_id_t tuple_id;
+};
+typedef struct index_entry_s index_entry_t;
+
 struct index_s {
 	struct index_s *next;
 	char descriptor_file[DB_MAX_FILENAME_LENGTH];
@@ -94,10 +103,14 @@ struct index_s {
 	attribute_t *attr;
 	struct index_api_s *api;
 	void *opaque_data;
+	index_entry_t *deferred;	/* Entries waiting for index_flush_deferred() */
+	tuple_id_t deferred_count;
+	tuple_id_t deferred_size;
 	index_type_t type;
 	index_state_t state;
 	uint8_t ref_cnt;
-	uint8_t reserved[3];
+	uint8_t rescan;				/* The deferred keys are stale; build from the rows */
+	uint8_t reserved[2];
 };
 typedef struct index_s index_t;
 
@@ -121,6 +134,19 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	/* Optional: add entries sorted by key in one pass, or replace all
+	   the entries with them when the last argument is set */
+	db_result_t(*bulk_insert)(index_t *, index_entry_t *, tuple_id_t, uint8_t);
+	/* Optional: write the changes cached in memory to storage */
+	db_result_t(*flush)(index_t *);
+	/* Optional: the key stored for a value, if not the value itself.
+	   Indexes without it cannot hold strings */
+	long(*key)(index_t *, attribute_value_t *);
+	/* Optional: shown NULL and then every value of the relation before
+	   the index is built from them, and every value inserted later, to
+	   choose how keys are formed. Returns nonzero if the keys of the
+	   values seen before have changed, so the index is built again */
+	uint8_t(*analyze)(index_t *, attribute_value_t *);
 };
 
 typedef struct index_api_s index_api_t;
@@ -130,6 +156,7 @@ typedef struct index_api_s index_api_t;
 ****************************************************************************/
 extern index_api_t index_inline;
 extern index_api_t index_bplustree;
+extern index_api_t index_hash;
 
 /****************************************************************************
  * Internal function prototypes
@@ -140,7 +167,13 @@ db_result_t index_destroy(index_t *);
 db_result_t index_load(relation_t *, attribute_t *);
 db_result_t index_release(index_t *);
 db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
+db_result_t index_insert_deferred(index_t *, attribute_value_t *, tuple_id_t);
+db_result_t index_flush_deferred(index_t *);
+db_result_t index_rebuild(index_t *);
+db_result_t index_sync(void);
 db_result_t index_delete(index_t *, attribute_value_t *);
+long index_key(index_t *, attribute_value_t *);
+unsigned long index_get_range(index_t *, attribute_value_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *, uint8_t);
 int index_exists(attribute_t *);
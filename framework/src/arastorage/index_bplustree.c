@@ -80,6 +80,15 @@
 #define NODE_STATE_LOCK 2
 #define NODE_STATE_DIRTY 4
 #define ROOT_NODE_PARENT 255
+/* Buckets built by bulk_insert are left partly empty for later inserts */
+#define BUCKET_FILL      (BUCKET_SIZE * 3 / 4)
+/* The key of a string is formed from this many bytes after its prefix */
+#define STRING_KEY_BYTES 3
+/* The keys of the strings before and after all those with the prefix */
+#define STRING_KEY_BELOW 0
+#define STRING_KEY_ABOVE ((1L << (8 * STRING_KEY_BYTES)) + 1)
+/* No string has been analyzed for the prefix yet */
+#define KEY_PREFIX_UNSET 0xff
 
 /* The total number of states possible of a node */
 #define NODE_STATES 255
@@ -240,6 +249,8 @@ struct tree_s {
 	uint16_t inserted;			/*  Count of total number of tuples inserted  */
 	uint16_t deleted;			/*    Count of total number of tuples deleted  */
 	uint8_t levels;				/*  The depth of the bplus-tree including the buckets  */
+	uint8_t key_prefix_len;		/*  Length of the prefix left out of the keys of strings  */
+	char key_prefix[DB_INDEX_KEY_PREFIX_LENGTH];	/*  The prefix shared by the strings indexed  */
 	tree_cache_t *node_cache;	/*  Structure to maintain node cache  */
 	bucket_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
 	pthread_mutex_t node_cache_lock;	/*  Maintains concurrency control over Node Cache  */
@@ -282,6 +293,10 @@ static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t bulk_insert(index_t *, index_entry_t *, tuple_id_t, uint8_t);
+static db_result_t flush(index_t *);
+static long get_key(index_t *, attribute_value_t *);
+static uint8_t analyze(index_t *, attribute_value_t *);
 
 #ifdef DB_WIP
 static db_result_t vacuum(tree_t *, relation_t *);
@@ -302,7 +317,11 @@ index_api_t index_bplustree = {
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	bulk_insert,
+	flush,
+	get_key,
+	analyze
 };
 
 /****************************************************************************
@@ -362,6 +381,8 @@ static db_result_t create(index_t *index)
 		return result;
 
 	}
+	/* The prefix is taken from the first string inserted */
+	tree->key_prefix_len = KEY_PREFIX_UNSET;
 
 	/* Generating the file to store the tree structure */
 	snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x\0", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
@@ -592,6 +613,13 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
+	/* The stored locks are in whatever state they had when written */
+	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
+	pthread_mutex_init(&(tree->node_cache_lock), NULL);
+	pthread_mutex_init(&(tree->bucket_lock), NULL);
+	pthread_mutex_init(&(tree->buck_cache_lock), NULL);
+	rw_init(&(tree->tree_lock));
+
 	tree->node_cache = bptree_malloc(sizeof(tree_cache_t));
 	if (tree->node_cache != NULL) {
 		success |= 1;
@@ -738,7 +766,7 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 	long long_key;
 
 	tree = (tree_t *)index->opaque_data;
-	long_key = db_value_to_long(key);
+	long_key = get_key(index, key);
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 	if ((tree->inserted) >= DB_TUPLES_LIMIT) {
@@ -786,12 +814,444 @@ static db_result_t delete(index_t *index, attribute_value_t *value)
 {
 	int i_key;
 
-	i_key = db_value_to_long(value);
+	i_key = get_key(index, value);
 	DB_LOG_D("delete index for value %d\n", i_key);
 
 	return delete_item_btree(index, i_key);
 }
 
+/****************************************************************************
+ * Name: get_key
+ *
+ * Description: Maps a value to its key in the tree. Strings are prefix
+ *              compressed: the prefix shared by all the strings indexed
+ *              (see analyze) is left out, and the key is formed from
+ *              the next STRING_KEY_BYTES bytes. The keys keep the order of
+ *              the strings, so range queries work on them, but strings that
+ *              differ only later share a key, and the rows found have to
+ *              be checked against the query. A NULL string is above all
+ *              others.
+ *
+ ****************************************************************************/
+static long get_key(index_t *index, attribute_value_t *value)
+{
+	tree_t *tree;
+	const unsigned char *s;
+	long key;
+	int prefix_len;
+	int c;
+	int i;
+
+	if (value->domain != DOMAIN_STRING) {
+		return db_value_to_long(value);
+	}
+	s = VALUE_STRING(value);
+	if (s == NULL) {
+		return STRING_KEY_ABOVE;
+	}
+
+	tree = (tree_t *)index->opaque_data;
+	prefix_len = tree->key_prefix_len == KEY_PREFIX_UNSET ? 0 : tree->key_prefix_len;
+	c = strncmp((const char *)s, tree->key_prefix, prefix_len);
+	if (c != 0) {
+		return c < 0 ? STRING_KEY_BELOW : STRING_KEY_ABOVE;
+	}
+
+	s += prefix_len;
+	key = 0;
+	for (i = 0; i < STRING_KEY_BYTES; i++) {
+		key <<= 8;
+		if (*s != '\0') {
+			key |= *s++;
+		}
+	}
+
+	return key + 1;
+}
+
+/****************************************************************************
+ * Name: analyze
+ *
+ * Description: Shortens the prefix left out of the keys to the part that
+ *              the string given shares with those before it, so that every
+ *              string indexed keeps its own leading bytes in its key. When
+ *              the prefix changes, 1 is returned: the keys formed before
+ *              are stale, and the index has to be built again.
+ *
+ ****************************************************************************/
+static uint8_t analyze(index_t *index, attribute_value_t *value)
+{
+	tree_t *tree;
+	const char *s;
+	int i;
+
+	tree = (tree_t *)index->opaque_data;
+	if (value == NULL) {
+		tree->key_prefix_len = KEY_PREFIX_UNSET;
+		return 1;
+	}
+	if (value->domain != DOMAIN_STRING || VALUE_STRING(value) == NULL) {
+		return 0;
+	}
+
+	s = (const char *)VALUE_STRING(value);
+	if (tree->key_prefix_len == KEY_PREFIX_UNSET) {
+		for (i = 0; i < DB_INDEX_KEY_PREFIX_LENGTH && s[i] != '\0'; i++) {
+			tree->key_prefix[i] = s[i];
+		}
+		tree->key_prefix_len = i;
+		return i > 0;
+	}
+
+	i = 0;
+	while (i < tree->key_prefix_len && s[i] == tree->key_prefix[i]) {
+		i++;
+	}
+	if (i == tree->key_prefix_len) {
+		return 0;
+	}
+	tree->key_prefix_len = i;
+	return 1;
+}
+
+/****************************************************************************
+ * Name: cache_write_back
+ *
+ * Description: Writes back every dirty node and bucket. With drop set, the
+ *              caches are emptied as well, so that the files can be
+ *              rewritten directly
+ *
+ ****************************************************************************/
+static void cache_write_back(tree_t *tree, bool drop)
+{
+	qnode_t *tmp_node;
+
+	pthread_mutex_lock(&(tree->buck_cache_lock));
+	tmp_node = tree->buck_cache->in_cache.head->next;
+	while (tmp_node != tree->buck_cache->in_cache.tail) {
+		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
+			bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket));
+		}
+		UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
+		if (drop) {
+			UNSET_NODE_STATE(tmp_node, NODE_STATE_VALID | NODE_STATE_LOCK);
+		}
+		tmp_node = tmp_node->next;
+	}
+	pthread_mutex_unlock(&(tree->buck_cache_lock));
+
+	pthread_mutex_lock(&(tree->node_cache_lock));
+	tmp_node = tree->node_cache->in_cache.head->next;
+	while (tmp_node != tree->node_cache->in_cache.tail) {
+		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
+			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
+		}
+		UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
+		if (drop) {
+			UNSET_NODE_STATE(tmp_node, NODE_STATE_VALID | NODE_STATE_LOCK);
+		}
+		tmp_node = tmp_node->next;
+	}
+	pthread_mutex_unlock(&(tree->node_cache_lock));
+}
+
+/****************************************************************************
+ * Name: flush
+ *
+ * Description: Writes the dirty nodes and buckets and the tree metadata to
+ *              storage, for a checkpoint. The caches keep their contents.
+ *
+ ****************************************************************************/
+static db_result_t flush(index_t *index)
+{
+	tree_t *tree;
+	db_result_t result;
+
+	tree = (tree_t *)index->opaque_data;
+	if (tree == NULL) {
+		return DB_OK;
+	}
+
+	rw_lock_write(&(tree->tree_lock));
+	cache_write_back(tree, false);
+	result = storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+	if (DB_SUCCESS(result)) {
+		result = storage_sync(tree->bucket_storage);
+	}
+	if (DB_SUCCESS(result)) {
+		result = storage_sync(tree->tree_storage);
+	}
+	rw_unlock_write(&(tree->tree_lock));
+
+	return result;
+}
+
+/****************************************************************************
+ * Name: tree_collect
+ *
+ * Description: Reads all the index entries, in key order, by following the
+ *              bucket chain from the leftmost bucket. The caller must have
+ *              flushed the caches.
+ *
+ ****************************************************************************/
+static pair_t *tree_collect(tree_t *tree, int *count)
+{
+	tree_node_t node;
+	bucket_t bucket;
+	pair_t *pairs;
+	int bucket_id;
+	int first;
+	int total;
+	int level;
+
+	*count = 0;
+	bucket_id = tree->root;
+	for (level = 1; level < tree->levels; level++) {
+		if (DB_ERROR(storage_read_from(tree->tree_storage, &node, base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
+			return NULL;
+		}
+		bucket_id = node.id[0];
+	}
+
+	first = bucket_id;
+	total = 0;
+	while (bucket_id != CONFIG_BUCKETS_LIMIT - 1) {
+		if (DB_ERROR(storage_read_from(tree->bucket_storage, &bucket, (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
+			return NULL;
+		}
+		total += bucket.next_free_slot;
+		bucket_id = bucket.info[0];
+	}
+
+	/* One spare entry, so that an empty tree still gets a buffer */
+	pairs = bptree_malloc(sizeof(pair_t) * (total + 1));
+	if (pairs == NULL) {
+		return NULL;
+	}
+
+	total = 0;
+	bucket_id = first;
+	while (bucket_id != CONFIG_BUCKETS_LIMIT - 1) {
+		if (DB_ERROR(storage_read_from(tree->bucket_storage, &bucket, (unsigned long)bucket_id * sizeof(bucket_t), sizeof(bucket_t)))) {
+			free(pairs);
+			return NULL;
+		}
+		memcpy(&pairs[total], bucket.pairs, sizeof(pair_t) * bucket.next_free_slot);
+		total += bucket.next_free_slot;
+		bucket_id = bucket.info[0];
+	}
+
+	/* Buckets are not kept sorted internally */
+	qsort(pairs, total, sizeof(pair_t), compare);
+	*count = total;
+	return pairs;
+}
+
+/****************************************************************************
+ * Name: bulk_pack
+ *
+ * Description: Merges the old and the new entries into buckets 0, 1, ...,
+ *              chained in key order, and stores the first key of every
+ *              bucket after the first in keys[]. A run of equal keys is
+ *              only cut when it does not fit in one bucket, as a lookup
+ *              visits the buckets from the one its key maps to onwards.
+ *              When keys is NULL, only the number of buckets is computed.
+ *
+ ****************************************************************************/
+static int bulk_pack(tree_t *tree, pair_t *old_pairs, int old_count, index_entry_t *entries, int count, int *keys)
+{
+	bucket_t bucket;
+	int nbuckets = 0;
+	int i = 0;
+	int j = 0;
+	bool take_old;
+	int key;
+
+	memset(&bucket, 0, sizeof(bucket_t));
+	while (i < old_count || j < count) {
+		take_old = (j >= count || (i < old_count && old_pairs[i].key <= (int)entries[j].key));
+		key = take_old ? old_pairs[i].key : (int)entries[j].key;
+
+		if (bucket.next_free_slot == BUCKET_SIZE || (bucket.next_free_slot >= BUCKET_FILL && bucket.pairs[bucket.next_free_slot - 1].key != key)) {
+			if (keys != NULL) {
+				bucket.info[0] = nbuckets + 1;
+				bucket.info[1] = bucket.pairs[0].key;
+				bucket.info[2] = bucket.pairs[bucket.next_free_slot - 1].key;
+				if (!bucket_write(tree, nbuckets, &bucket)) {
+					return -1;
+				}
+				keys[nbuckets] = key;
+			}
+			nbuckets++;
+			memset(&bucket, 0, sizeof(bucket_t));
+		}
+
+		bucket.pairs[bucket.next_free_slot].key = key;
+		if (take_old) {
+			bucket.pairs[bucket.next_free_slot].value = old_pairs[i++].value;
+		} else {
+			bucket.pairs[bucket.next_free_slot].value = entries[j++].tuple_id;
+		}
+		bucket.next_free_slot++;
+	}
+
+	/* The last bucket ends the chain; it is kept even when empty */
+	if (keys != NULL) {
+		bucket.info[0] = CONFIG_BUCKETS_LIMIT - 1;
+		bucket.info[1] = bucket.next_free_slot ? bucket.pairs[0].key : KEY_MAX;
+		bucket.info[2] = bucket.next_free_slot ? bucket.pairs[bucket.next_free_slot - 1].key : 0;
+		if (!bucket_write(tree, nbuckets, &bucket)) {
+			return -1;
+		}
+	}
+
+	return nbuckets + 1;
+}
+
+/****************************************************************************
+ * Name: bulk_insert
+ *
+ * Description: Adds a batch of entries, sorted by key, and rebuilds the
+ *              tree bottom-up: the merged entries are packed into chained
+ *              buckets, and every level of nodes is written once. This
+ *              replaces a root-to-leaf descent, and the splits it causes,
+ *              per entry with one sequential write of each file.
+ *              With replace set, the old entries are not read, and the
+ *              tree holds the new entries only.
+ *
+ ****************************************************************************/
+static db_result_t bulk_insert(index_t *index, index_entry_t *entries, tuple_id_t count, uint8_t replace)
+{
+	tree_t *tree;
+	pair_t *old_pairs;
+	int old_count;
+	int *ids = NULL;
+	int *keys = NULL;
+	tree_node_t node;
+	int nbuckets;
+	int nchildren;
+	int nnodes;
+	int levels;
+	int i, k;
+	int node_id;
+	int per_node;
+	int extra;
+	int first;
+	int taken;
+	db_result_t result = DB_INDEX_ERROR;
+
+	tree = (tree_t *)index->opaque_data;
+
+	rw_lock_write(&(tree->tree_lock));
+	cache_write_back(tree, true);
+
+	if (replace) {
+		/* The old tree may be damaged, so it is not read at all */
+		old_pairs = NULL;
+		old_count = 0;
+	} else {
+		old_pairs = tree_collect(tree, &old_count);
+		if (old_pairs == NULL) {
+			DB_LOG_E("DB: Failed to read the bplus-tree index entries\n");
+			rw_unlock_write(&(tree->tree_lock));
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	/* Check that the result fits before the old tree is overwritten */
+	nbuckets = bulk_pack(tree, old_pairs, old_count, entries, count, NULL);
+	node_id = 0;
+	for (nchildren = nbuckets + 1; nchildren > 1; nchildren = nnodes) {
+		nnodes = (nchildren + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+		node_id += nnodes;
+	}
+	if (nbuckets > CONFIG_BUCKETS_LIMIT - 1 || node_id > CONFIG_NODE_LIMIT) {
+		DB_LOG_E("TREE FULL !");
+		result = DB_FULL_ERROR;
+		goto errout;
+	}
+
+	ids = malloc(sizeof(int) * (nbuckets + 1));
+	keys = malloc(sizeof(int) * (nbuckets + 1));
+	if (ids == NULL || keys == NULL) {
+		result = DB_ALLOCATION_ERROR;
+		goto errout;
+	}
+
+	if (bulk_pack(tree, old_pairs, old_count, entries, count, keys) != nbuckets) {
+		result = DB_STORAGE_ERROR;
+		goto errout;
+	}
+
+	/* keys[i] separates ids[i] from ids[i + 1]. Keys from KEY_MAX on map to
+	 * the sentinel, as in the tree set up by tree_insert.
+	 */
+	for (i = 0; i < nbuckets; i++) {
+		ids[i] = i;
+	}
+	ids[nbuckets] = CONFIG_BUCKETS_LIMIT - 1;
+	keys[nbuckets - 1] = KEY_MAX;
+	keys[nbuckets] = KEY_MAX;
+	nchildren = nbuckets + 1;
+
+	/* Write the nodes bottom-up, spreading the children of each level evenly
+	 * over as few nodes as possible.
+	 */
+	node_id = 0;
+	levels = 1;
+	while (true) {
+		nnodes = (nchildren + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+		per_node = nchildren / nnodes;
+		extra = nchildren % nnodes;
+		first = 0;
+		for (k = 0; k < nnodes; k++) {
+			taken = per_node + (k < extra ? 1 : 0);
+			memset(&node, 0, sizeof(tree_node_t));
+			node.is_leaf = (levels == 1);
+			node.val[BRANCH_FACTOR - 1] = taken - 1;
+			for (i = 0; i < taken; i++) {
+				node.id[i] = ids[first + i];
+				if (i < taken - 1) {
+					node.val[i] = keys[first + i];
+				}
+			}
+			if (!tree_write(tree, node_id + k, &node)) {
+				result = DB_STORAGE_ERROR;
+				goto errout;
+			}
+			/* The key between this node and the next one moves up a level */
+			ids[k] = node_id + k;
+			keys[k] = keys[first + taken - 1];
+			first += taken;
+		}
+		node_id += nnodes;
+		if (nnodes == 1) {
+			break;
+		}
+		nchildren = nnodes;
+		levels++;
+	}
+
+	memset(tree->lock_buckets, 0, sizeof(tree->lock_buckets));
+	tree->root = node_id - 1;
+	tree->off_nodes = node_id;
+	tree->off_buckets = nbuckets;
+	tree->levels = levels + 1;
+	tree->inserted = old_count + count;
+	tree->deleted = 0;
+	storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t));
+
+	DB_LOG_D("DB: Built a bplus-tree index of %d entries in %d buckets and %d nodes\n", old_count + count, nbuckets, node_id);
+	result = DB_OK;
+
+errout:
+	free(ids);
+	free(keys);
+	free(old_pairs);
+	rw_unlock_write(&(tree->tree_lock));
+	return result;
+}
+
 /****************************************************************************
  * Name: next_bucket
  *
@@ -836,15 +1296,17 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition
 	int key_max;
 	int key_min;
 	tree_t *tree;
-	key_min = *(int *)&iterator->min_value;
-	key_max = *(int *)&iterator->max_value;
+	key_min = (int)get_key(iterator->index, &iterator->min_value);
+	key_max = (int)get_key(iterator->index, &iterator->max_value);
 	tree = (tree_t *)iterator->index->opaque_data;
 
 	/* To initialize the iterator_cache */
 	if (iterator->next_item_no == 0) {	/* removed the condition of iterator inequality */
 		if (iterator->found_items == 0) {
 			rw_lock_write(&(tree->tree_lock));
-			pair_t *path = tree_find(tree, key_min);
+			/* A split can leave entries of key_min on both sides of a
+			 * separator equal to it, so start from the bucket before it */
+			pair_t *path = tree_find(tree, key_min > INT_MIN ? key_min - 1 : key_min);
 			if (path == NULL) {
 				return INVALID_TUPLE;
 			}
@@ -1165,7 +1627,7 @@ static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node
 	qnode_t *replace_node;
 	replace_node = tree->node_cache->in_cache.head->next;
 
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
+	while ((replace_node->id != id || !(replace_node->node_state & NODE_STATE_VALID)) && (replace_node != tree->node_cache->in_cache.tail)) {
 		replace_node = replace_node->next;
 	}
 	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
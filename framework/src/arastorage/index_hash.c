@@ -0,0 +1,492 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file
+ *      A hash index, which finds the rows holding a given string.
+ *
+ *      The index is a file of DB_HASH_BUCKETS buckets after a header. Each
+ *      bucket holds up to DB_HASH_BUCKET_SIZE entries: the FNV-1a hash of a
+ *      string and the tuple id of its row. An entry goes to the bucket its
+ *      hash selects or, if that one is full, to the first bucket after it
+ *      with room, and the full buckets on the way are marked as overflowed
+ *      so that lookups go on past them. A lookup thus reads a single bucket
+ *      until the index fills up. Strings may share a hash, so the rows
+ *      found are checked against the query.
+ *
+ *      The bucket used last is kept in memory, and written back when
+ *      another one is needed or the index is flushed.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+#include "random.h"
+#include "db_options.h"
+#include "db_debug.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME        16777619U
+
+#define NO_BUCKET        0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct hash_header_s {
+	uint16_t buckets;
+	uint16_t bucket_size;
+};
+
+struct hash_entry_s {
+	uint32_t hash;
+	tuple_id_t tuple_id;
+};
+typedef struct hash_entry_s hash_entry_t;
+
+struct hash_bucket_s {
+	uint8_t count;
+	uint8_t overflowed;			/* Entries for this bucket went on to later ones */
+	hash_entry_t entries[DB_HASH_BUCKET_SIZE];
+};
+typedef struct hash_bucket_s hash_bucket_t;
+
+struct hash_s {
+	db_storage_id_t fd;
+	struct hash_header_s header;
+	hash_bucket_t bucket;		/* The bucket used last */
+	uint16_t bucket_id;			/* Its number, or NO_BUCKET */
+	bool dirty;					/* It differs from the one in the file */
+	pthread_mutex_t lock;
+};
+typedef struct hash_s hash_t;
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+static db_result_t create(index_t *);
+static db_result_t destroy(index_t *);
+static db_result_t load(index_t *);
+static db_result_t release(index_t *);
+static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t delete(index_t *, attribute_value_t *);
+static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t bulk_insert(index_t *, index_entry_t *, tuple_id_t, uint8_t);
+static db_result_t flush(index_t *);
+static long get_key(index_t *, attribute_value_t *);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+index_api_t index_hash = {
+	INDEX_HASH,
+	INDEX_API_EXTERNAL,
+	create,
+	destroy,
+	load,
+	release,
+	insert,
+	delete,
+	get_next,
+	bulk_insert,
+	flush,
+	get_key,
+	NULL
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static uint32_t hash_string(const unsigned char *s)
+{
+	uint32_t hash;
+
+	hash = FNV_OFFSET_BASIS;
+	while (*s != '\0') {
+		hash ^= *s++;
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static unsigned long bucket_offset(uint16_t bucket_id)
+{
+	return sizeof(struct hash_header_s) + (unsigned long)bucket_id * sizeof(hash_bucket_t);
+}
+
+static db_result_t write_back(hash_t *hash)
+{
+	if (!hash->dirty) {
+		return DB_OK;
+	}
+	if (DB_ERROR(storage_write_to(hash->fd, &hash->bucket, bucket_offset(hash->bucket_id), sizeof(hash_bucket_t)))) {
+		DB_LOG_E("DB: Failed to write hash bucket %d\n", hash->bucket_id);
+		return DB_STORAGE_ERROR;
+	}
+	hash->dirty = false;
+
+	return DB_OK;
+}
+
+static db_result_t read_bucket(hash_t *hash, uint16_t bucket_id)
+{
+	if (hash->bucket_id == bucket_id) {
+		return DB_OK;
+	}
+	if (DB_ERROR(write_back(hash))) {
+		return DB_STORAGE_ERROR;
+	}
+	if (DB_ERROR(storage_read_from(hash->fd, &hash->bucket, bucket_offset(bucket_id), sizeof(hash_bucket_t)))) {
+		DB_LOG_E("DB: Failed to read hash bucket %d\n", bucket_id);
+		hash->bucket_id = NO_BUCKET;
+		return DB_STORAGE_ERROR;
+	}
+	hash->bucket_id = bucket_id;
+
+	return DB_OK;
+}
+
+/* Empty all the buckets in the file. */
+static db_result_t clear(hash_t *hash)
+{
+	uint16_t i;
+
+	hash->bucket_id = NO_BUCKET;
+	hash->dirty = false;
+	memset(&hash->bucket, 0, sizeof(hash->bucket));
+	for (i = 0; i < hash->header.buckets; i++) {
+		if (DB_ERROR(storage_write_to(hash->fd, &hash->bucket, bucket_offset(i), sizeof(hash_bucket_t)))) {
+			return DB_STORAGE_ERROR;
+		}
+	}
+
+	return DB_OK;
+}
+
+static db_result_t put_entry(hash_t *hash, uint32_t key, tuple_id_t tuple_id)
+{
+	uint16_t bucket_id;
+	uint16_t i;
+
+	bucket_id = key % hash->header.buckets;
+	for (i = 0; i < hash->header.buckets; i++) {
+		if (DB_ERROR(read_bucket(hash, bucket_id))) {
+			return DB_STORAGE_ERROR;
+		}
+		if (hash->bucket.count < DB_HASH_BUCKET_SIZE) {
+			hash->bucket.entries[hash->bucket.count].hash = key;
+			hash->bucket.entries[hash->bucket.count].tuple_id = tuple_id;
+			hash->bucket.count++;
+			hash->dirty = true;
+			return DB_OK;
+		}
+		if (!hash->bucket.overflowed) {
+			hash->bucket.overflowed = 1;
+			hash->dirty = true;
+		}
+		bucket_id = (bucket_id + 1) % hash->header.buckets;
+	}
+
+	DB_LOG_E("DB: The hash index is full\n");
+	return DB_FULL_ERROR;
+}
+
+static db_result_t open_index(index_t *index)
+{
+	hash_t *hash;
+
+	hash = malloc(sizeof(hash_t));
+	if (hash == NULL) {
+		DB_LOG_E("DB: Failed to allocate a hash index\n");
+		return DB_ALLOCATION_ERROR;
+	}
+
+	hash->fd = storage_open(index->descriptor_file, O_RDWR);
+	if (hash->fd < 0) {
+		DB_LOG_E("DB: Failed to open the hash index file %s\n", index->descriptor_file);
+		free(hash);
+		return DB_STORAGE_ERROR;
+	}
+	hash->bucket_id = NO_BUCKET;
+	hash->dirty = false;
+	pthread_mutex_init(&hash->lock, NULL);
+	index->opaque_data = hash;
+
+	return DB_OK;
+}
+
+static db_result_t create(index_t *index)
+{
+	char filename[DB_MAX_FILENAME_LENGTH];
+	db_storage_id_t fd;
+	hash_t *hash;
+	db_result_t result;
+
+	/* Find a file name that is not in use */
+	do {
+		snprintf(filename, HASH_FILE_LENGTH, "%s.%x", HASH_FILE_NAME, (unsigned)random_rand());
+		fd = storage_open(filename, O_RDONLY);
+		if (fd >= 0) {
+			storage_close(fd);
+		}
+	} while (fd >= 0);
+
+	if (DB_ERROR(storage_generate_file(filename))) {
+		DB_LOG_E("DB: Failed to generate a hash index file\n");
+		return DB_STORAGE_ERROR;
+	}
+	memcpy(index->descriptor_file, filename, sizeof(index->descriptor_file));
+
+	result = open_index(index);
+	if (DB_ERROR(result)) {
+		storage_remove(filename);
+		return result;
+	}
+
+	hash = (hash_t *)index->opaque_data;
+	hash->header.buckets = DB_HASH_BUCKETS;
+	hash->header.bucket_size = DB_HASH_BUCKET_SIZE;
+	if (DB_ERROR(storage_write_to(hash->fd, &hash->header, 0, sizeof(hash->header))) || DB_ERROR(clear(hash))) {
+		DB_LOG_E("DB: Failed to initialize the hash index file %s\n", filename);
+		release(index);
+		storage_remove(filename);
+		return DB_STORAGE_ERROR;
+	}
+
+	DB_LOG_D("DB: Created a hash index in %s\n", filename);
+	return DB_OK;
+}
+
+static db_result_t destroy(index_t *index)
+{
+	/* The index manager removes the file */
+	return release(index);
+}
+
+static db_result_t load(index_t *index)
+{
+	hash_t *hash;
+	db_result_t result;
+
+	result = open_index(index);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	hash = (hash_t *)index->opaque_data;
+	if (DB_ERROR(storage_read_from(hash->fd, &hash->header, 0, sizeof(hash->header))) || hash->header.buckets == 0 || hash->header.bucket_size != DB_HASH_BUCKET_SIZE) {
+		DB_LOG_E("DB: The hash index file %s is not valid\n", index->descriptor_file);
+		release(index);
+		return DB_INDEX_ERROR;
+	}
+
+	DB_LOG_D("DB: Loaded a hash index of %d buckets from %s\n", hash->header.buckets, index->descriptor_file);
+	return DB_OK;
+}
+
+static db_result_t release(index_t *index)
+{
+	hash_t *hash;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	if (hash == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	result = write_back(hash);
+	storage_close(hash->fd);
+	pthread_mutex_destroy(&hash->lock);
+	free(hash);
+	index->opaque_data = NULL;
+
+	return result;
+}
+
+static db_result_t insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+	hash_t *hash;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	pthread_mutex_lock(&hash->lock);
+	result = put_entry(hash, (uint32_t)get_key(index, value), tuple_id);
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+static db_result_t delete(index_t *index, attribute_value_t *value)
+{
+	hash_t *hash;
+	uint32_t key;
+	uint16_t bucket_id;
+	uint16_t i;
+	int j;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	key = (uint32_t)get_key(index, value);
+	result = DB_INDEX_ERROR;
+
+	pthread_mutex_lock(&hash->lock);
+	bucket_id = key % hash->header.buckets;
+	for (i = 0; i < hash->header.buckets; i++) {
+		if (DB_ERROR(read_bucket(hash, bucket_id))) {
+			result = DB_STORAGE_ERROR;
+			break;
+		}
+		for (j = 0; j < hash->bucket.count; j++) {
+			if (hash->bucket.entries[j].hash == key) {
+				break;
+			}
+		}
+		if (j < hash->bucket.count) {
+			hash->bucket.count--;
+			hash->bucket.entries[j] = hash->bucket.entries[hash->bucket.count];
+			hash->dirty = true;
+			result = DB_OK;
+			break;
+		}
+		if (!hash->bucket.overflowed) {
+			break;
+		}
+		bucket_id = (bucket_id + 1) % hash->header.buckets;
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+/*
+ * The iterator looks up the single key of min_value. next_item_no holds
+ * one more than the position of the next entry to look at, counted from
+ * the first entry of the bucket the key selects.
+ */
+static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
+{
+	hash_t *hash;
+	uint32_t key;
+	uint32_t position;
+	uint16_t bucket_id;
+	uint16_t step;
+	int slot;
+
+	hash = (hash_t *)iterator->index->opaque_data;
+	key = (uint32_t)get_key(iterator->index, &iterator->min_value);
+	if (iterator->next_item_no == 0) {
+		iterator->found_items = 0;
+		position = 0;
+	} else {
+		position = iterator->next_item_no - 1;
+	}
+
+	pthread_mutex_lock(&hash->lock);
+	for (step = position / DB_HASH_BUCKET_SIZE; step < hash->header.buckets; step++) {
+		bucket_id = (key % hash->header.buckets + step) % hash->header.buckets;
+		if (DB_ERROR(read_bucket(hash, bucket_id))) {
+			break;
+		}
+		slot = step == position / DB_HASH_BUCKET_SIZE ? position % DB_HASH_BUCKET_SIZE : 0;
+		for (; slot < hash->bucket.count; slot++) {
+			if (hash->bucket.entries[slot].hash == key) {
+				iterator->found_items++;
+				iterator->next_item_no = step * DB_HASH_BUCKET_SIZE + slot + 2;
+				pthread_mutex_unlock(&hash->lock);
+				return hash->bucket.entries[slot].tuple_id;
+			}
+		}
+		if (!hash->bucket.overflowed) {
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	/* Tell the caller whether anything was found, as the other indexes do */
+	iterator->next_item_no = iterator->found_items == 0 ? 0 : 1;
+	return INVALID_TUPLE;
+}
+
+static db_result_t bulk_insert(index_t *index, index_entry_t *entries, tuple_id_t count, uint8_t replace)
+{
+	hash_t *hash;
+	db_result_t result;
+	uint16_t bucket_id;
+	tuple_id_t i;
+
+	hash = (hash_t *)index->opaque_data;
+	result = DB_OK;
+
+	pthread_mutex_lock(&hash->lock);
+	if (replace) {
+		result = clear(hash);
+	}
+
+	/* Add the entries bucket by bucket, so that each bucket is read and
+	   written about once. */
+	for (bucket_id = 0; bucket_id < hash->header.buckets && DB_SUCCESS(result); bucket_id++) {
+		for (i = 0; i < count && DB_SUCCESS(result); i++) {
+			if ((uint32_t)entries[i].key % hash->header.buckets == bucket_id) {
+				result = put_entry(hash, (uint32_t)entries[i].key, entries[i].tuple_id);
+			}
+		}
+	}
+	if (DB_SUCCESS(result)) {
+		result = write_back(hash);
+	}
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+static db_result_t flush(index_t *index)
+{
+	hash_t *hash;
+	db_result_t result;
+
+	hash = (hash_t *)index->opaque_data;
+	pthread_mutex_lock(&hash->lock);
+	result = write_back(hash);
+	pthread_mutex_unlock(&hash->lock);
+
+	return result;
+}
+
+static long get_key(index_t *index, attribute_value_t *value)
+{
+	if (value->domain != DOMAIN_STRING) {
+		return db_value_to_long(value);
+	}
+	if (VALUE_STRING(value) == NULL) {
+		return 0;
+	}
+	return (long)hash_string(VALUE_STRING(value));
+}
@@ -58,6 +58,7 @@
 #include <sys/types.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <pthread.h>
 #include <arastorage/arastorage.h>
 #include "attribute.h"
@@ -72,7 +73,8 @@
 * Private Types
 ****************************************************************************/
 static index_api_t *index_components[] = { &index_inline,
-										   &index_bplustree
+										   &index_bplustree,
+										   &index_hash
 										 };
 
 pthread_attr_t g_attr;
@@ -81,6 +83,11 @@ pthread_attr_t g_attr;
  * Private function prototypes
  ****************************************************************************/
 static index_api_t *find_index_api(index_type_t index_type);
+static int compare_entries(const void *a, const void *b);
+static db_result_t flush_deferred(index_t *index, uint8_t replace);
+static db_result_t defer_entry(index_t *index, attribute_value_t *value, tuple_id_t tuple_id);
+static void drop_deferred(index_t *index);
+static db_result_t index_scan(index_t *index, relation_t *rel, tuple_id_t rows, uint8_t analyze);
 db_result_t db_indexing(relation_t*);
 LIST(indices);
 
@@ -116,6 +123,7 @@ db_result_t index_deinit(void)
 		}
 		tmp = index;
 		index = index->next;
+		free(tmp->deferred);
 		free(tmp);
 	}
 	if (DB_ERROR(index_init())) {
@@ -142,17 +150,26 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 		return DB_INDEX_ERROR;
 	}
 
-	if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
-		DB_LOG_E("DB: Cannot create an index for a non-number attribute!\n");
-		return DB_INDEX_ERROR;
-	}
-
 	api = find_index_api(index_type);
 	if (api == NULL) {
 		DB_LOG_E("DB: No API for index type %d\n", (int)index_type);
 		return DB_INDEX_ERROR;
 	}
 
+	if (attr->domain == DOMAIN_STRING) {
+		if (api->key == NULL) {
+			DB_LOG_E("DB: Index type %d cannot hold strings!\n", (int)index_type);
+			return DB_INDEX_ERROR;
+		}
+	} else if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
+		DB_LOG_E("DB: Cannot create an index for a non-number attribute!\n");
+		return DB_INDEX_ERROR;
+	} else if (!(api->flags & INDEX_API_RANGE_QUERIES)) {
+		/* Numbers are mostly looked up by range */
+		DB_LOG_E("DB: Index type %d is only for strings!\n", (int)index_type);
+		return DB_INDEX_ERROR;
+	}
+
 	index = malloc(sizeof(index_t));
 	if (index == NULL) {
 		DB_LOG_E("DB: Failed to allocate an index\n");
@@ -166,7 +183,11 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 	index->opaque_data = NULL;
 	index->descriptor_file[0] = '\0';
 	index->type = index_type;
+	index->deferred = NULL;
+	index->deferred_count = 0;
+	index->deferred_size = 0;
 	index->ref_cnt = 1;
+	index->rescan = FALSE;
 	
 	if (DB_ERROR(api->create(index))) {
 		free(index);
@@ -220,6 +241,7 @@ db_result_t index_destroy(index_t *index)
 	}
 	index->attr->index = NULL;
 
+	free(index->deferred);
 	free(index);
 	return DB_OK;
 }
@@ -264,7 +286,11 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 		index->rel = rel;
 		index->attr = attr;
 		index->opaque_data = NULL;
+		index->deferred = NULL;
+		index->deferred_count = 0;
+		index->deferred_size = 0;
 		index->ref_cnt = 1;
+		index->rescan = FALSE;
 		
 		api = find_index_api(index->type);
 		if (api == NULL) {
@@ -297,6 +323,7 @@ db_result_t index_release(index_t *index)
 	if (index->api->release) {
 		index->api->release(index);
 	}
+	free(index->deferred);
 	free(index);
 
 	return DB_OK;
@@ -304,9 +331,100 @@ db_result_t index_release(index_t *index)
 
 db_result_t index_insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
 {
+	db_result_t result;
+
+	/* If value changes how the keys are formed, the keys stored so far are
+	   rebuilt from the rows before the one of value, which is not stored
+	   yet or is the last one. */
+	if (index->api->analyze != NULL && index->api->analyze(index, value)) {
+		DB_LOG_D("DB: Rebuilding the index on %s.%s for new keys\n", index->rel->name, index->attr->name);
+		result = index_scan(index, index->rel, tuple_id, FALSE);
+		if (DB_SUCCESS(result)) {
+			result = flush_deferred(index, TRUE);
+		}
+		if (DB_ERROR(result)) {
+			return result;
+		}
+	}
+
 	return index->api->insert(index, value, tuple_id);
 }
 
+db_result_t index_insert_deferred(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+	if (index->api->bulk_insert == NULL) {
+		/* Nothing to gain from deferring; keep the index current. */
+		return index_insert(index, value, tuple_id);
+	}
+
+	/* Once the keys change, the index is built from all the rows when
+	   it is flushed. */
+	if (index->api->analyze != NULL && index->api->analyze(index, value)) {
+		drop_deferred(index);
+		index->rescan = TRUE;
+	}
+	if (index->rescan) {
+		return DB_OK;
+	}
+
+	return defer_entry(index, value, tuple_id);
+}
+
+db_result_t index_flush_deferred(index_t *index)
+{
+	if (index->rescan) {
+		index->rescan = FALSE;
+		return index_rebuild(index);
+	}
+	if (index->deferred_count == 0) {
+		return DB_OK;
+	}
+
+	return flush_deferred(index, FALSE);
+}
+
+/*
+ * Build the index again from the rows of its relation, for when its files
+ * may not match them, as after a power loss.
+ */
+db_result_t index_rebuild(index_t *index)
+{
+	db_result_t result;
+
+	if (index->api->flags & INDEX_API_INLINE) {
+		/* The relation itself is the index */
+		return DB_OK;
+	}
+	if (index->api->bulk_insert == NULL) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	drop_deferred(index);
+	result = index_scan(index, index->rel, relation_cardinality(index->rel), TRUE);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	return flush_deferred(index, TRUE);
+}
+
+/* Write the changes cached by the loaded indexes to storage. */
+db_result_t index_sync(void)
+{
+	index_t *index;
+	db_result_t result;
+
+	result = DB_OK;
+	for (index = list_head(indices); index != NULL; index = index->next) {
+		if (index->api->flush != NULL && DB_ERROR(index->api->flush(index))) {
+			DB_LOG_E("DB: Failed to flush the index on %s.%s\n", index->rel->name, index->attr->name);
+			result = DB_INDEX_ERROR;
+		}
+	}
+
+	return result;
+}
+
 db_result_t index_delete(index_t *index, attribute_value_t *value)
 {
 	if (index->state != INDEX_READY) {
@@ -316,13 +434,41 @@ db_result_t index_delete(index_t *index, attribute_value_t *value)
 	return index->api->delete(index, value);
 }
 
+/* The key under which index stores value. */
+long index_key(index_t *index, attribute_value_t *value)
+{
+	if (index->api->key != NULL) {
+		return index->api->key(index, value);
+	}
+	return db_value_to_long(value);
+}
+
+/*
+ * The number of keys the index has to visit to find the values between
+ * min_value and max_value, or ULONG_MAX if it cannot find them all. The
+ * keys of strings keep their order only in indexes with range queries;
+ * other indexes find a string only by its exact value.
+ */
+unsigned long index_get_range(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value)
+{
+	if (min_value->domain == DOMAIN_STRING && !(index->api->flags & INDEX_API_RANGE_QUERIES)) {
+		if (VALUE_STRING(max_value) == NULL || strcmp((char *)VALUE_STRING(min_value), (char *)VALUE_STRING(max_value)) != 0) {
+			return ULONG_MAX;
+		}
+	}
+
+	return (unsigned long)index_key(index, max_value) - (unsigned long)index_key(index, min_value);
+}
+
 db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attribute_value_t *min_value, attribute_value_t *max_value)
 {
 	tuple_id_t cardinality;
 	unsigned long range;
 	unsigned long max_range;
+#if (DEBUG & DEBUG_VERBOSE) || (DEBUG & DEBUG_ENABLE)
 	long max;
 	long min;
+#endif
 
 	cardinality = relation_cardinality(index->rel);
 	if (cardinality == INVALID_TUPLE) {
@@ -333,10 +479,13 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 		return DB_INDEX_ERROR;
 	}
 
-	min = db_value_to_long(min_value);
-	max = db_value_to_long(max_value);
+#if (DEBUG & DEBUG_VERBOSE) || (DEBUG & DEBUG_ENABLE)
+	/* The keys are only needed for the log */
+	min = index_key(index, min_value);
+	max = index_key(index, max_value);
 	DB_LOG_D("DB : Index_get_iterator min = %ld, max = %ld\n", min, max);
-	range = (unsigned long)max - min;
+#endif
+	range = index_get_range(index, min_value, max_value);
 	if (range > 0) {
 		/*
 		 * Index structures that do not have a natural ability to handle
@@ -366,8 +515,9 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 	iterator->min_value = *min_value;
 	iterator->max_value = *max_value;
 	iterator->next_item_no = 0;
+	iterator->found_items = 0;
 
-	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min_value->u.long_value, max_value->u.long_value);
+	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min, max);
 
 	return DB_OK;
 }
@@ -382,7 +532,8 @@ tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 		return INVALID_TUPLE;
 	}
 
-	if ((iterator->index->attr->flags & ATTRIBUTE_FLAG_UNIQUE) && iterator->next_item_no == 1) {
+	/* Strings may share a key, so the first item found need not match. */
+	if ((iterator->index->attr->flags & ATTRIBUTE_FLAG_UNIQUE) && iterator->next_item_no == 1 && iterator->min_value.domain != DOMAIN_STRING) {
 		min = db_value_to_long(&iterator->min_value);
 		max = db_value_to_long(&iterator->max_value);
 		if (min == max) {
@@ -414,6 +565,69 @@ static index_api_t *find_index_api(index_type_t index_type)
 	return NULL;
 }
 
+static int compare_entries(const void *a, const void *b)
+{
+	const index_entry_t *x = a;
+	const index_entry_t *y = b;
+
+	if (x->key != y->key) {
+		return x->key < y->key ? -1 : 1;
+	}
+	return (int)x->tuple_id - (int)y->tuple_id;
+}
+
+/* Hand the deferred entries of index, sorted, to its bulk_insert op. */
+static db_result_t flush_deferred(index_t *index, uint8_t replace)
+{
+	db_result_t result;
+
+	qsort(index->deferred, index->deferred_count, sizeof(index_entry_t), compare_entries);
+	result = index->api->bulk_insert(index, index->deferred, index->deferred_count, replace);
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to build the index on %s.%s from %d entries\n", index->rel->name, index->attr->name, index->deferred_count);
+	}
+
+	drop_deferred(index);
+
+	return result;
+}
+
+/* Queue the key of value for the next bulk_insert of index. */
+static db_result_t defer_entry(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
+{
+	index_entry_t *entries;
+	tuple_id_t size;
+
+	if (index->api->bulk_insert == NULL) {
+		return index->api->insert(index, value, tuple_id);
+	}
+
+	if (index->deferred_count == index->deferred_size) {
+		size = index->deferred_size == 0 ? DB_INDEX_DEFERRED_CHUNK : index->deferred_size * 2;
+		entries = realloc(index->deferred, size * sizeof(index_entry_t));
+		if (entries == NULL) {
+			DB_LOG_E("DB: Failed to allocate %d deferred index entries\n", size);
+			return DB_ALLOCATION_ERROR;
+		}
+		index->deferred = entries;
+		index->deferred_size = size;
+	}
+
+	index->deferred[index->deferred_count].key = index_key(index, value);
+	index->deferred[index->deferred_count].tuple_id = tuple_id;
+	index->deferred_count++;
+
+	return DB_OK;
+}
+
+static void drop_deferred(index_t *index)
+{
+	free(index->deferred);
+	index->deferred = NULL;
+	index->deferred_count = 0;
+	index->deferred_size = 0;
+}
+
 static index_t *get_next_index_to_load(void)
 {
 	index_t *index;
@@ -427,9 +641,10 @@ static index_t *get_next_index_to_load(void)
 	return NULL;
 }
 
-db_result_t db_indexing(relation_t *rel)
+/* Collect the key of each of the first 'rows' rows of rel as a deferred
+   entry of index, after showing them all to its analyze op if asked. */
+static db_result_t index_scan(index_t *index, relation_t *rel, tuple_id_t rows, uint8_t analyze)
 {
-	index_t *index;
 	tuple_id_t tuple_id;
 	tuple_id_t cardinality;
 	storage_row_t row;
@@ -437,14 +652,9 @@ db_result_t db_indexing(relation_t *rel)
 	attribute_t *attr;
 	db_result_t result;
 	int offset;
+	int pass;
 	bool isfound;
 
-	index = get_next_index_to_load();
-	if (index == NULL) {
-		DB_LOG_E("DB: Request to load an index, but no index is set to be loaded\n");
-		return DB_INDEX_ERROR;
-	}
-
 	row = NULL;
 	row = (storage_row_t)malloc(sizeof(char) * rel->row_length + 1);
 	if (row == NULL) {
@@ -475,31 +685,40 @@ db_result_t db_indexing(relation_t *rel)
 		goto errout;
 	}
 
-	cardinality = relation_cardinality(rel);
+	cardinality = rows;
 
-	for (tuple_id = 0; tuple_id < cardinality; tuple_id++) {
-		memset(row, 0, sizeof(char) * rel->row_length + 1);
-		DB_LOG_V("DB: Indexing Tuple id %d\n", tuple_id);
-		result = storage_get_row(rel, &tuple_id, row);
-		if (DB_ERROR(result)) {
-			DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
-			goto errout;
-		}
+	/* An index that forms its keys from all the values sees them first. */
+	pass = analyze && index->api->analyze != NULL ? 0 : 1;
+	if (pass == 0) {
+		index->api->analyze(index, NULL);
+	}
+	for (; pass < 2; pass++) {
+		for (tuple_id = 0; tuple_id < cardinality; tuple_id++) {
+			memset(row, 0, sizeof(char) * rel->row_length + 1);
+			DB_LOG_V("DB: Indexing Tuple id %d\n", tuple_id);
+			result = storage_get_row(rel, &tuple_id, row);
+			if (DB_ERROR(result)) {
+				DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
+				goto errout;
+			}
 
-		result = db_phy_to_value(&value, index->attr, row + offset);
-		if (DB_ERROR(result)) {
-			DB_LOG_E("DB: Failed to get value from row\n");
-			goto errout;
-		}
+			result = db_phy_to_value(&value, index->attr, row + offset);
+			if (DB_ERROR(result)) {
+				DB_LOG_E("DB: Failed to get value from row\n");
+				goto errout;
+			}
 
-		if (DB_ERROR(index_insert(index, &value, tuple_id))) {
-			DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
-			goto errout;
+			if (pass == 0) {
+				index->api->analyze(index, &value);
+			} else if (DB_ERROR(defer_entry(index, &value, tuple_id))) {
+				DB_LOG_E("DB: Failed to get a row in relation %s!\n", rel->name);
+				goto errout;
+			}
 		}
 	}
 
 	free(row);
-	DB_LOG_D("DB: Loaded %lu rows into the index\n", cardinality);
+	DB_LOG_D("DB: Read %lu rows for the index\n", cardinality);
 
 	return DB_OK;
 
@@ -507,6 +726,29 @@ errout:
 	if (row != NULL) {
 		free(row);
 	}
+	drop_deferred(index);
 
 	return DB_INDEX_ERROR;
 }
+
+db_result_t db_indexing(relation_t *rel)
+{
+	index_t *index;
+
+	index = get_next_index_to_load();
+	if (index == NULL) {
+		DB_LOG_E("DB: Request to load an index, but no index is set to be loaded\n");
+		return DB_INDEX_ERROR;
+	}
+
+	if (DB_ERROR(index_scan(index, rel, relation_cardinality(rel), TRUE))) {
+		return DB_INDEX_ERROR;
+	}
+
+	/* Indexes that support it are built in one pass from the sorted keys. */
+	if (DB_ERROR(index_flush_deferred(index))) {
+		return DB_INDEX_ERROR;
+	}
+
+	return DB_OK;
+}
@@ -0,0 +1,407 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file
+ *      Equality join of two relations.
+ *
+ *      Each row of the first relation is matched against the rows of the
+ *      relation after JOIN whose join attribute holds the same value. Those
+ *      rows are found in one of three ways, in order of preference:
+ *      through an index on the join attribute, through a hash table built
+ *      over the joined relation when its rows fit in DB_JOIN_BUFFER_SIZE
+ *      bytes, or by reading the joined relation once for each row.
+ *
+ *      A pair of matching rows is laid out as the row of the first relation
+ *      followed by the row of the joined one, checked against the WHERE
+ *      clause, and then either aggregated or projected into the result.
+ *      The result is kept in memory, and holds up to DB_CURSOR_RESULT_ENTRY
+ *      rows.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aql.h"
+#include "lvm.h"
+#include "index.h"
+#include "result.h"
+#include "storage.h"
+#include "db_options.h"
+#include "db_debug.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+#define JOIN_RESULT_CHUNK 16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+struct join_s {
+	db_handle_t *handle;
+	relation_t *rel;
+	relation_t *joined_rel;
+	attribute_t *key;			/* The join attribute of rel */
+	attribute_t *joined_key;	/* and that of joined_rel */
+	unsigned key_offset;		/* The offsets of the keys in their rows */
+	unsigned joined_key_offset;
+	unsigned char *row;			/* A row of rel followed by one of joined_rel */
+	unsigned char *joined_row;
+	size_t result_length;
+	unsigned char *results;
+	tuple_id_t result_count;
+	tuple_id_t result_size;
+};
+typedef struct join_s join_t;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+/* Find the join attributes, which may be named in either order. */
+static db_result_t join_keys(join_t *join, aql_adt_t *adt)
+{
+	int offset;
+	int joined_offset;
+
+	join->key = relation_attribute_get(join->rel, adt->join_on[0]);
+	join->joined_key = relation_attribute_get(join->joined_rel, adt->join_on[1]);
+	if (join->key == NULL || join->joined_key == NULL) {
+		join->key = relation_attribute_get(join->rel, adt->join_on[1]);
+		join->joined_key = relation_attribute_get(join->joined_rel, adt->join_on[0]);
+	}
+	if (join->key == NULL || join->joined_key == NULL) {
+		DB_LOG_E("DB: Invalid join attributes %s and %s\n", adt->join_on[0], adt->join_on[1]);
+		return DB_NAME_ERROR;
+	}
+
+	if ((join->key->domain == DOMAIN_STRING) != (join->joined_key->domain == DOMAIN_STRING)) {
+		DB_LOG_E("DB: Cannot join %s with %s\n", join->key->name, join->joined_key->name);
+		return DB_TYPE_ERROR;
+	}
+
+	offset = get_attribute_value_offset(join->rel, join->key);
+	joined_offset = get_attribute_value_offset(join->joined_rel, join->joined_key);
+	if (offset < 0 || joined_offset < 0) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+	join->key_offset = offset;
+	join->joined_key_offset = joined_offset;
+
+	return DB_OK;
+}
+
+/* Take a pair of matching rows into the result if they meet the condition. */
+static db_result_t join_emit(join_t *join)
+{
+	db_handle_t *handle;
+	source_dest_map_t *attr_map_ptr;
+	source_dest_map_t *attr_map_end;
+	unsigned char *results;
+	unsigned char *to_ptr;
+	tuple_id_t size;
+
+	handle = join->handle;
+	attr_map_end = handle->attr_map + handle->result_rel->attribute_count;
+
+	if (handle->lvm_instance != NULL) {
+		for (attr_map_ptr = handle->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+			if (attr_map_ptr->from_attr->domain == DOMAIN_INT || attr_map_ptr->from_attr->domain == DOMAIN_LONG || attr_map_ptr->from_attr->domain == DOMAIN_STRING) {
+				lvm_set_operand_value(handle->lvm_instance, attr_map_ptr->from_attr, join->row + attr_map_ptr->from_offset);
+			}
+		}
+		if (lvm_execute(handle->lvm_instance) != TRUE) {
+			return DB_OK;
+		}
+	}
+
+	if (handle->groups != NULL) {
+		return group_add(handle->groups, join->row);
+	}
+
+	if (join->result_count == join->result_size) {
+		if (join->result_size == DB_CURSOR_RESULT_ENTRY) {
+			DB_LOG_E("DB: The join has more than %d rows\n", DB_CURSOR_RESULT_ENTRY);
+			return DB_LIMIT_ERROR;
+		}
+		size = join->result_size + JOIN_RESULT_CHUNK;
+		if (size > DB_CURSOR_RESULT_ENTRY) {
+			size = DB_CURSOR_RESULT_ENTRY;
+		}
+		results = (unsigned char *)realloc(join->results, join->result_length * size);
+		if (results == NULL) {
+			DB_LOG_E("DB: Failed to allocate the join result\n");
+			return DB_ALLOCATION_ERROR;
+		}
+		join->results = results;
+		join->result_size = size;
+	}
+
+	to_ptr = join->results + join->result_count * join->result_length;
+	for (attr_map_ptr = handle->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		memcpy(to_ptr + attr_map_ptr->to_offset, join->row + attr_map_ptr->from_offset, attr_map_ptr->from_attr->element_size);
+	}
+	join->result_count++;
+
+	return DB_OK;
+}
+
+/* Look the rows up in the index on the join attribute of joined_rel. */
+static db_result_t join_index(join_t *join, tuple_id_t nrows)
+{
+	index_iterator_t iterator;
+	attribute_value_t value;
+	attribute_value_t key;
+	tuple_id_t tuple_id;
+	tuple_id_t joined_id;
+	db_result_t result;
+
+	for (tuple_id = 0; tuple_id < nrows; tuple_id++) {
+		result = storage_get_row(join->rel, &tuple_id, join->row);
+		if (result != DB_OK) {
+			return result;
+		}
+
+		result = db_phy_to_value(&value, join->key, join->row + join->key_offset);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		if (value.domain == DOMAIN_STRING) {
+			key = value;
+		} else {
+			key.domain = DOMAIN_LONG;
+			VALUE_LONG(&key) = db_value_to_long(&value);
+		}
+
+		result = index_get_iterator(&iterator, join->joined_key->index, &key, &key);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		while ((joined_id = index_get_next(&iterator, TRUE)) != INVALID_TUPLE) {
+			result = storage_get_row(join->joined_rel, &joined_id, join->joined_row);
+			if (result != DB_OK) {
+				result = DB_ERROR(result) ? result : DB_INDEX_ERROR;
+				break;
+			}
+			/* Keys of different values may collide in the index. */
+			if (!db_value_equal(join->key, join->row + join->key_offset, join->joined_key, join->joined_row + join->joined_key_offset)) {
+				continue;
+			}
+			result = join_emit(join);
+			if (DB_ERROR(result)) {
+				break;
+			}
+		}
+		if (joined_id != INVALID_TUPLE) {
+			/* The index stays locked until its iterator runs out. */
+			while (index_get_next(&iterator, TRUE) != INVALID_TUPLE) {
+			}
+			return result;
+		}
+	}
+
+	return DB_OK;
+}
+
+/* Hold the rows of joined_rel in memory, chained by the hash of their key. */
+static db_result_t join_hash(join_t *join, tuple_id_t nrows, tuple_id_t joined_nrows)
+{
+	unsigned char *rows;
+	tuple_id_t *heads;
+	tuple_id_t *next;
+	tuple_id_t tuple_id;
+	tuple_id_t joined_id;
+	size_t row_length;
+	db_result_t result;
+	uint32_t bucket;
+
+	row_length = join->joined_rel->row_length;
+	rows = (unsigned char *)malloc(row_length * joined_nrows + sizeof(tuple_id_t) * joined_nrows * 2);
+	if (rows == NULL) {
+		DB_LOG_E("DB: Failed to allocate the join buffer\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	heads = (tuple_id_t *)(rows + row_length * joined_nrows);
+	next = heads + joined_nrows;
+	memset(heads, 0xff, sizeof(tuple_id_t) * joined_nrows);
+
+	for (joined_id = 0; joined_id < joined_nrows; joined_id++) {
+		result = storage_get_row(join->joined_rel, &joined_id, rows + joined_id * row_length);
+		if (result != DB_OK) {
+			goto errout;
+		}
+		bucket = db_value_hash(join->joined_key, rows + joined_id * row_length + join->joined_key_offset) % joined_nrows;
+		next[joined_id] = heads[bucket];
+		heads[bucket] = joined_id;
+	}
+
+	for (tuple_id = 0; tuple_id < nrows; tuple_id++) {
+		result = storage_get_row(join->rel, &tuple_id, join->row);
+		if (result != DB_OK) {
+			goto errout;
+		}
+
+		bucket = db_value_hash(join->key, join->row + join->key_offset) % joined_nrows;
+		for (joined_id = heads[bucket]; joined_id != INVALID_TUPLE; joined_id = next[joined_id]) {
+			if (!db_value_equal(join->key, join->row + join->key_offset, join->joined_key, rows + joined_id * row_length + join->joined_key_offset)) {
+				continue;
+			}
+			memcpy(join->joined_row, rows + joined_id * row_length, row_length);
+			result = join_emit(join);
+			if (DB_ERROR(result)) {
+				goto errout;
+			}
+		}
+	}
+	result = DB_OK;
+
+errout:
+	free(rows);
+	return result;
+}
+
+/* Read joined_rel again for each row of rel. */
+static db_result_t join_scan(join_t *join, tuple_id_t nrows, tuple_id_t joined_nrows)
+{
+	tuple_id_t tuple_id;
+	tuple_id_t joined_id;
+	db_result_t result;
+
+	for (tuple_id = 0; tuple_id < nrows; tuple_id++) {
+		result = storage_get_row(join->rel, &tuple_id, join->row);
+		if (result != DB_OK) {
+			return result;
+		}
+
+		for (joined_id = 0; joined_id < joined_nrows; joined_id++) {
+			result = storage_get_row(join->joined_rel, &joined_id, join->joined_row);
+			if (result != DB_OK) {
+				return result;
+			}
+			if (!db_value_equal(join->key, join->row + join->key_offset, join->joined_key, join->joined_row + join->joined_key_offset)) {
+				continue;
+			}
+			result = join_emit(join);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+	}
+
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+db_cursor_t *relation_join(db_handle_t **handle, relation_t *rel, void *adt_ptr)
+{
+	aql_adt_t *adt;
+	join_t join;
+	db_cursor_t *cursor;
+	db_result_t result;
+	tuple_id_t nrows;
+	tuple_id_t joined_nrows;
+
+	adt = (aql_adt_t *)adt_ptr;
+	cursor = NULL;
+	memset(&join, 0, sizeof(join));
+	join.handle = *handle;
+	join.rel = rel;
+
+	(*handle)->optype = AQL_GET_TYPE(adt);
+	(*handle)->adt_flags = AQL_GET_FLAGS(adt);
+	(*handle)->lvm_instance = (lvm_instance_t *)adt->lvm_instance;
+
+	join.joined_rel = relation_load(adt->relations[1]);
+	if (join.joined_rel == NULL) {
+		DB_LOG_E("DB: Failed to load relation %s\n", adt->relations[1]);
+		return NULL;
+	}
+
+	if (rel->bulk || join.joined_rel->bulk) {
+		DB_LOG_E("DB: Cannot join a relation during a bulk load\n");
+		goto errout;
+	}
+
+	if (DB_ERROR(join_keys(&join, adt)) || DB_ERROR(relation_result_create(handle, rel, join.joined_rel, adt))) {
+		goto errout;
+	}
+	join.result_length = (*handle)->result_rel->row_length;
+	index_load(join.joined_rel, join.joined_key);
+
+	if (DB_ERROR(storage_get_row_amount(rel, &nrows)) || DB_ERROR(storage_get_row_amount(join.joined_rel, &joined_nrows))) {
+		goto errout;
+	}
+
+	join.row = (unsigned char *)malloc(rel->row_length + join.joined_rel->row_length + 1);
+	cursor = (db_cursor_t *)malloc(sizeof(db_cursor_t));
+	if (join.row == NULL || cursor == NULL) {
+		DB_LOG_E("DB: Failed to allocate the join\n");
+		goto errout;
+	}
+	memset(cursor, 0, sizeof(db_cursor_t));
+	join.joined_row = join.row + rel->row_length;
+	memcpy(cursor->rel_name, rel->name, sizeof(rel->name));
+
+	if (joined_nrows == 0) {
+		result = DB_OK;
+	} else if (join.joined_key->index != NULL) {
+		DB_LOG_D("DB: Join through the index on %s\n", join.joined_key->name);
+		result = join_index(&join, nrows);
+	} else if ((join.joined_rel->row_length + sizeof(tuple_id_t) * 2) * joined_nrows <= DB_JOIN_BUFFER_SIZE) {
+		DB_LOG_D("DB: Join through a hash table of %d rows\n", joined_nrows);
+		result = join_hash(&join, nrows, joined_nrows);
+	} else {
+		DB_LOG_D("DB: Join by reading %s for each row\n", join.joined_rel->name);
+		result = join_scan(&join, nrows, joined_nrows);
+	}
+	if (DB_ERROR(result)) {
+		goto errout;
+	}
+
+	if ((*handle)->groups != NULL) {
+		result = group_finish((*handle)->groups, cursor);
+	} else {
+		result = cursor_rows_set(cursor, join.results, join.result_count, (*handle)->attr_map, (*handle)->result_rel->attribute_count);
+	}
+	if (DB_ERROR(result)) {
+		goto errout;
+	}
+	join.results = NULL;
+
+	free(join.row);
+	relation_release(join.joined_rel);
+	return cursor;
+
+errout:
+	if (cursor != NULL) {
+		cursor_deinit(cursor);
+	}
+	if (join.results != NULL) {
+		free(join.results);
+	}
+	if (join.row != NULL) {
+		free(join.row);
+	}
+	relation_release(join.joined_rel);
+	return NULL;
+}
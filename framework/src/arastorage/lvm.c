@@ -74,6 +74,9 @@
  */
 #define IS_CONNECTIVE(op) ((op) & LVM_CONNECTIVE)
 
+/* A string variable derived to have no lower or no upper bound. */
+#define STRING_UNBOUNDED -1
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -137,11 +140,29 @@ static long operand_to_long(lvm_instance_t *p, operand_t *operand)
 #endif							/* LVM_USE_FLOATS */
 	case LVM_VARIABLE:
 		return p->variables[operand->value.id].value.l;
+	case LVM_PARAM:
+		return p->params[operand->value.id];
 	default:
 		return 0;
 	}
 }
 
+/* The string an operand stands for, or NULL if it is not a string. */
+static const char *operand_to_string(lvm_instance_t *p, operand_t *operand)
+{
+	switch (operand->type) {
+	case LVM_STRING:
+		return p->strings + operand->value.l;
+	case LVM_VARIABLE:
+		if (p->variables[operand->value.id].type == LVM_STRING) {
+			return p->variables[operand->value.id].value.s;
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
 static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *result)
 {
 	int i;
@@ -168,6 +189,10 @@ static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *resul
 		default:
 			return SEMANTIC_ERROR;
 		}
+		if (operand_to_string(p, &operand[i]) != NULL) {
+			/* There is no arithmetic on strings. */
+			return TYPE_ERROR;
+		}
 		value[i] = operand_to_long(p, &operand[i]);
 	}
 
@@ -201,8 +226,8 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 {
 	int i;
 	int r;
-	operand_t operand;
-	long result[2];
+	operand_t operand[2];
+	const char *string[2];
 	node_type_t type;
 	operator_t *operator;
 	long l1, l2;
@@ -237,22 +262,31 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 		switch (type) {
 		case LVM_ARITH_OP:
 			operator = get_operator(p);
-			r = eval_expr(p, *operator, &operand);
+			r = eval_expr(p, *operator, &operand[i]);
 			if (LVM_ERROR(r)) {
 				return r;
 			}
 			break;
 		case LVM_OPERAND:
-			get_operand(p, &operand);
+			get_operand(p, &operand[i]);
 			break;
 		default:
 			return SEMANTIC_ERROR;
 		}
-		result[i] = operand_to_long(p, &operand);
+		string[i] = operand_to_string(p, &operand[i]);
 	}
 
-	l1 = result[0];
-	l2 = result[1];
+	if (string[0] != NULL || string[1] != NULL) {
+		if (string[0] == NULL || string[1] == NULL) {
+			return TYPE_ERROR;
+		}
+		/* Strings are ordered as strcmp() orders them. */
+		l1 = strcmp(string[0], string[1]);
+		l2 = 0;
+	} else {
+		l1 = operand_to_long(p, &operand[0]);
+		l2 = operand_to_long(p, &operand[1]);
+	}
 	DB_LOG_D("Result1: %ld\nResult2: %ld\n", l1, l2);
 
 	switch (*op) {
@@ -280,9 +314,25 @@ void lvm_reset(lvm_instance_t *p)
 	p->end = 0;
 	p->ip = 0;
 	p->error = 0;
+	p->strings_end = 0;
 	memset(p->code, 0, sizeof(p->code));
 	memset(p->variables, 0, sizeof(p->variables));
 	memset(p->derivations, 0, sizeof(p->derivations));
+	memset(p->params, 0, sizeof(p->params));
+}
+
+/* The program refers to its variables and strings by offset, so a copy
+   of the instance runs on its own. */
+void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src)
+{
+	memcpy(dst, src, sizeof(lvm_instance_t));
+}
+
+/* The derived ranges depend on the bound parameters, so a program run
+   again with other values has to derive them anew. */
+void lvm_clear_derivations(lvm_instance_t *p)
+{
+	memset(p->derivations, 0, sizeof(p->derivations));
 }
 
 lvm_ip_t lvm_jump_to_operand(lvm_instance_t *p)
@@ -432,12 +482,20 @@ lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op)
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value)
 {
 	operand_value_t operand_value;
+	variable_id_t id;
 
 	/* Update the internal state of the PLE. */
 	if (attr->domain == DOMAIN_INT) {
 		operand_value.l = value[0] << 8 | value[1];
 	} else if (attr->domain == DOMAIN_LONG) {
 		operand_value.l = (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+	} else if (attr->domain == DOMAIN_STRING) {
+		/* The string is compared where it lies in the row. */
+		operand_value.s = (const char *)value;
+		id = lookup(p, attr->name);
+		if (id < LVM_MAX_VARIABLE_ID && p->variables[id].name[0] != '\0') {
+			p->variables[id].type = LVM_STRING;
+		}
 	}
 
 	return lvm_set_variable_value(p, attr->name, operand_value);
@@ -453,6 +511,48 @@ lvm_status_t lvm_set_long(lvm_instance_t *p, long l)
 	return lvm_set_operand(p, &op);
 }
 
+lvm_status_t lvm_set_string(lvm_instance_t *p, const char *s)
+{
+	operand_t op;
+	size_t length;
+
+	length = strlen(s) + 1;
+	if (p->strings_end + length > sizeof(p->strings)) {
+		DB_LOG_E("lvm_set_string failed because of overflow\n");
+		return STACK_OVERFLOW;
+	}
+	memcpy(p->strings + p->strings_end, s, length);
+
+	op.type = LVM_STRING;
+	op.value.l = p->strings_end;
+	p->strings_end += length;
+
+	return lvm_set_operand(p, &op);
+}
+
+lvm_status_t lvm_set_param(lvm_instance_t *p, unsigned id)
+{
+	operand_t op;
+
+	if (id >= AQL_PARAM_LIMIT) {
+		return VARIABLE_LIMIT_REACHED;
+	}
+
+	op.type = LVM_PARAM;
+	op.value.id = id;
+
+	return lvm_set_operand(p, &op);
+}
+
+lvm_status_t lvm_bind_param(lvm_instance_t *p, unsigned id, long l)
+{
+	if (id >= AQL_PARAM_LIMIT) {
+		return INVALID_IDENTIFIER;
+	}
+	p->params[id] = l;
+	return LVM_TRUE;
+}
+
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type)
 {
 	variable_id_t id;
@@ -502,13 +602,32 @@ lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name)
 	return lvm_set_operand(p, &op);
 }
 
-static void create_intersection(derivation_t *result, derivation_t *d1, derivation_t *d2)
+/*
+ * The bounds derived for a string variable are offsets of constants in the
+ * string pool, or STRING_UNBOUNDED. Compare two lower (upper) bounds, where
+ * STRING_UNBOUNDED is the lowest (highest) of all.
+ */
+static int compare_string_bounds(lvm_instance_t *p, long b1, long b2, int unbounded)
+{
+	if (b1 == STRING_UNBOUNDED || b2 == STRING_UNBOUNDED) {
+		if (b1 == b2) {
+			return 0;
+		}
+		return b1 == STRING_UNBOUNDED ? unbounded : -unbounded;
+	}
+	return strcmp(p->strings + b1, p->strings + b2);
+}
+
+static void create_intersection(lvm_instance_t *p, derivation_t *result, derivation_t *d1, derivation_t *d2)
 {
 	int i;
 
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
 		if (!d1[i].derived && !d2[i].derived) {
 			continue;
+		} else if (p->variables[i].type == LVM_STRING && d1[i].derived && d2[i].derived) {
+			result[i].min.l = compare_string_bounds(p, d1[i].min.l, d2[i].min.l, -1) > 0 ? d1[i].min.l : d2[i].min.l;
+			result[i].max.l = compare_string_bounds(p, d1[i].max.l, d2[i].max.l, 1) < 0 ? d1[i].max.l : d2[i].max.l;
 		} else if (d1[i].derived && !d2[i].derived) {
 			result[i].min.l = d1[i].min.l;
 			result[i].max.l = d1[i].max.l;
@@ -535,13 +654,16 @@ static void create_intersection(derivation_t *result, derivation_t *d1, derivati
 	/* DEBUG */
 }
 
-static void create_union(derivation_t *result, derivation_t *d1, derivation_t *d2)
+static void create_union(lvm_instance_t *p, derivation_t *result, derivation_t *d1, derivation_t *d2)
 {
 	int i;
 
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
 		if (!d1[i].derived && !d2[i].derived) {
 			continue;
+		} else if (p->variables[i].type == LVM_STRING && d1[i].derived && d2[i].derived) {
+			result[i].min.l = compare_string_bounds(p, d1[i].min.l, d2[i].min.l, -1) < 0 ? d1[i].min.l : d2[i].min.l;
+			result[i].max.l = compare_string_bounds(p, d1[i].max.l, d2[i].max.l, 1) > 0 ? d1[i].max.l : d2[i].max.l;
 		} else if (d1[i].derived && !d2[i].derived) {
 			result[i].min.l = d1[i].min.l;
 			result[i].max.l = d1[i].max.l;
@@ -600,10 +722,10 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 		}
 
 		if (*operator == LVM_AND) {
-			create_intersection(local_derivations, d1, d2);
+			create_intersection(p, local_derivations, d1, d2);
 			DB_LOG_V("Created an intersection of D1 and D2\n");
 		} else if (*operator == LVM_OR) {
-			create_union(local_derivations, d1, d2);
+			create_union(p, local_derivations, d1, d2);
 			DB_LOG_V("Created a union of D1 and D2\n");
 		}
 		DB_LOG_V("D1: \n");
@@ -620,6 +742,11 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 		switch (type) {
 		case LVM_OPERAND:
 			get_operand(p, &operand[i]);
+			if (operand[i].type == LVM_PARAM) {
+				/* Derive from the value bound to the parameter. */
+				operand[i].type = LVM_LONG;
+				operand[i].value.l = p->params[operand[i].value.id];
+			}
 			break;
 		default:
 			return DERIVATION_ERROR;
@@ -649,6 +776,32 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 	DB_LOG_D("variable id %d, value %ld\n", variable_id, *(long *)value);
 
 	derivation = local_derivations + variable_id;
+	if (operand[0].type == LVM_STRING || operand[1].type == LVM_STRING) {
+		/* The range of a string variable runs between constants. A
+		   strict bound is kept as it is; the rows are checked anyway. */
+		p->variables[variable_id].type = LVM_STRING;
+		derivation->max.l = STRING_UNBOUNDED;
+		derivation->min.l = STRING_UNBOUNDED;
+		switch (*operator) {
+		case LVM_EQ:
+			derivation->max = *value;
+			derivation->min = *value;
+			break;
+		case LVM_GE:
+		case LVM_GEQ:
+			derivation->min = *value;
+			break;
+		case LVM_LE:
+		case LVM_LEQ:
+			derivation->max = *value;
+			break;
+		default:
+			return DERIVATION_ERROR;
+		}
+		derivation->derived = 1;
+		return LVM_TRUE;
+	}
+
 	/* Default values. */
 	derivation->max.l = DB_LONG_MAX;
 	derivation->min.l = DB_LONG_MIN;
@@ -685,12 +838,21 @@ lvm_status_t lvm_derive(lvm_instance_t *p)
 	return derive_relation(p, p->derivations);
 }
 
+/*
+ * The range of a string variable is given as strings. An empty string
+ * stands for no lower bound, and NULL for no upper bound.
+ */
 lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max)
 {
 	int i;
 
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
 		if (strcmp(name, p->variables[i].name) == 0) {
+			if (p->derivations[i].derived && p->variables[i].type == LVM_STRING) {
+				min->s = p->derivations[i].min.l == STRING_UNBOUNDED ? "" : p->strings + p->derivations[i].min.l;
+				max->s = p->derivations[i].max.l == STRING_UNBOUNDED ? NULL : p->strings + p->derivations[i].max.l;
+				return LVM_TRUE;
+			}
 			if (p->derivations[i].derived) {
 				*min = p->derivations[i].min;
 				*max = p->derivations[i].max;
@@ -756,6 +918,12 @@ static lvm_ip_t print_operand(lvm_instance_t *p, lvm_ip_t index)
 	case LVM_LONG:
 		DB_LOG_D("long:%ld ", operand.value.l);
 		break;
+	case LVM_PARAM:
+		DB_LOG_D("param(%d):%ld ", operand.value.id, p->params[operand.value.id]);
+		break;
+	case LVM_STRING:
+		DB_LOG_D("string:'%s' ", p->strings + operand.value.l);
+		break;
 	default:
 		DB_LOG_D("?? ");
 		break;
@@ -118,7 +118,9 @@ typedef enum lvm_operator_e operator_t;
 enum operand_type_e {
 	LVM_VARIABLE,
 	LVM_FLOAT,
-	LVM_LONG
+	LVM_LONG,
+	LVM_PARAM,
+	LVM_STRING
 };
 typedef enum operand_type_e operand_type_t;
 
@@ -129,6 +131,7 @@ union operand_value_u {
 	float f;
 #endif
 	variable_id_t id;
+	const char *s;
 };
 typedef union operand_value_u operand_value_t;
 
@@ -156,6 +159,9 @@ struct lvm_instance_s {
 	unsigned char code[DB_VM_BYTECODE_SIZE];
 	variable_t variables[LVM_MAX_VARIABLE_ID];
 	derivation_t derivations[LVM_MAX_VARIABLE_ID];
+	long params[AQL_PARAM_LIMIT];	/* Values bound to the parameters of a prepared statement */
+	char strings[LVM_STRING_POOL_SIZE];	/* The string constants, which operands refer to by offset */
+	lvm_ip_t strings_end;
 	lvm_ip_t end;
 	lvm_ip_t ip;
 	unsigned error;
@@ -182,6 +188,10 @@ lvm_status_t lvm_set_relation(lvm_instance_t *p, operator_t op);
 lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op);
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value);
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l);
+lvm_status_t lvm_set_string(lvm_instance_t *p, const char *s);
+lvm_status_t lvm_set_param(lvm_instance_t *p, unsigned id);
+lvm_status_t lvm_bind_param(lvm_instance_t *p, unsigned id, long l);
+void lvm_clear_derivations(lvm_instance_t *p);
 lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name);
 lvm_status_t lvm_set_variable_value(lvm_instance_t *p, char *name, operand_value_t value);
 #endif							/* LVM_H */
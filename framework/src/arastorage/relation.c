@@ -68,6 +68,9 @@
 #include "list.h"
 #include "aql.h"
 #include "relation.h"
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+#include "wal.h"
+#endif
 
 /****************************************************************************
 * Global Function Prototypes
@@ -79,7 +82,6 @@ LIST(relations);
 //MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
 static relation_t *relation_find(char *);
 static attribute_t *attribute_find(relation_t *, char *);
-static int get_attribute_value_offset(relation_t *, attribute_t *);
 static void attribute_free(relation_t *, attribute_t *);
 static void purge_relations(void);
 static void relation_clear(relation_t *);
@@ -115,7 +117,7 @@ static attribute_t *attribute_find(relation_t *rel, char *name)
 	return NULL;
 }
 
-static int get_attribute_value_offset(relation_t *rel, attribute_t *attr)
+int get_attribute_value_offset(relation_t *rel, attribute_t *attr)
 {
 	attribute_t *ptr;
 	int offset;
@@ -249,12 +251,17 @@ relation_t *relation_load(char *name)
 	list_add(relations, rel);
 
 end:
-	if (rel->dir == DB_STORAGE && DB_ERROR(storage_load(rel))) {
+	/* The tuple file stays open while the relation has references */
+	if (rel->dir == DB_STORAGE && !RELATION_HAS_TUPLES(rel) && DB_ERROR(storage_load(rel))) {
 		relation_release(rel);
 		return NULL;
 	}
 
 	rel->cardinality = relation_cardinality(rel);
+	if (rel->next_row < rel->cardinality) {
+		/* A relation read back from storage continues after its last row */
+		rel->next_row = rel->cardinality;
+	}
 	DB_LOG_D("DB: Rel %s, Cardinality %d\n", rel->name, rel->cardinality);
 
 	return rel;
@@ -563,12 +570,18 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			DB_LOG_V(", ");
 		}
 #endif              /* DEBUG */
-		if (attr->index == NULL) {
+		/* A bulk load has loaded the indexes already */
+		if (attr->index == NULL && !rel->bulk) {
 			index_load(rel, attr);
 		}
 		ptr += attr->element_size;
 		if (attr->index != NULL) {
-			if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
+			if (rel->bulk) {
+				result = index_insert_deferred(attr->index, value, rel->next_row);
+			} else {
+				result = index_insert(attr->index, value, rel->next_row);
+			}
+			if (DB_ERROR(result)) {
 				return DB_INDEX_ERROR;
 			}
 		}
@@ -578,65 +591,87 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 
 	DB_LOG_V(")\n");
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	result = wal_log_insert(rel, record);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+#endif
+
 	return storage_put_row(rel, record, FALSE);
 }
 
 /*
- * Update aggregation value whenever each tuple is read.
+ * Start a bulk load: rows inserted into the relation until relation_bulk_end()
+ * reach the indexes in one sorted batch per index instead of one by one.
  */
-static db_result_t aggregate(attribute_t *attr, attribute_value_t *value, tuple_id_t count)
+db_result_t relation_bulk_begin(relation_t *rel)
 {
-	long long_value;
-	double sum_value;
-
-	switch (value->domain) {
-	case DOMAIN_INT:
-		long_value = VALUE_INT(value);
-		break;
-	case DOMAIN_LONG:
-		long_value = VALUE_LONG(value);
-		break;
-	default:
-		return DB_TYPE_ERROR;
-	}
-
-	sum_value = 0;
-	switch (attr->aggregator) {
-	case AQL_COUNT:
-		attr->aggregation_value++;
-		break;
-	case AQL_SUM:
-		attr->aggregation_value += (double)long_value;
-		break;
-	case AQL_MEAN:
-		if (count == 1) {
-			attr->aggregation_value = (double)long_value;
-		} else {
-			sum_value = (double) (attr->aggregation_value * (count - 1));
-			attr->aggregation_value = (double) ((sum_value + long_value) / count);
-		}
-		break;
-	case AQL_MAX:
-		if (long_value > attr->aggregation_value) {
-			attr->aggregation_value = (double)long_value;
-		}
-		break;
-	case AQL_MIN:
-		if (long_value < attr->aggregation_value) {
-			attr->aggregation_value = (double)long_value;
+	attribute_t *attr;
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	db_result_t res;
+#endif
+
+	if (rel->bulk) {
+		return DB_BUSY_ERROR;
+	}
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->index == NULL) {
+			index_load(rel, attr);
 		}
-		break;
-	default:
-		return DB_TYPE_ERROR;
-		break;
 	}
 
-	DB_LOG_D("DB: aggregation value of attribute %s is %f.\n", attr->name, attr->aggregation_value);
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* The rows stay uncommitted in the log until relation_bulk_end() */
+	res = wal_begin(rel);
+	if (DB_ERROR(res)) {
+		return res;
+	}
+#endif
 
+	rel->bulk = 1;
 	return DB_OK;
 }
 
-static db_result_t generate_attribute_map(source_dest_map_t *attr_map, unsigned attribute_count, relation_t *from_rel, relation_t *to_rel)
+db_result_t relation_bulk_end(relation_t *rel)
+{
+	attribute_t *attr;
+	db_result_t result;
+	db_result_t res;
+
+	if (!rel->bulk) {
+		return DB_ARGUMENT_ERROR;
+	}
+	rel->bulk = 0;
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* The indexes can be rebuilt from the rows, so commit these first */
+	result = wal_commit(rel);
+#else
+	result = DB_OK;
+#endif
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	storage_flush_insert_buffer();
+#endif
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->index != NULL) {
+			res = index_flush_deferred(attr->index);
+			if (DB_ERROR(res)) {
+				result = res;
+			}
+		}
+	}
+
+	return result;
+}
+
+/* The source rows of a join are a row of from_rel followed by a row of
+   the joined relation, whose attributes are used when from_rel has none
+   of the name. */
+static db_result_t generate_attribute_map(source_dest_map_t *attr_map, unsigned attribute_count, relation_t *from_rel, relation_t *joined_rel, relation_t *to_rel)
 {
 	attribute_t *from_attr;
 	attribute_t *to_attr;
@@ -649,19 +684,23 @@ static db_result_t generate_attribute_map(source_dest_map_t *attr_map, unsigned
 	to_attr = list_head(to_rel->attributes);
 	while (to_attr != NULL) {
 		from_attr = attribute_find(from_rel, to_attr->name);
-		if (from_attr == NULL) {
+		if (from_attr != NULL) {
+			offset = get_attribute_value_offset(from_rel, from_attr);
+		} else if (joined_rel != NULL && (from_attr = attribute_find(joined_rel, to_attr->name)) != NULL) {
+			offset = get_attribute_value_offset(joined_rel, from_attr);
+			if (offset >= 0) {
+				offset += from_rel->row_length;
+			}
+		} else {
 			DB_LOG_E("DB: Invalid attribute in the result relation: %s\n", to_attr->name);
 			return DB_NAME_ERROR;
 		}
-
-		attr_map_ptr->from_attr = from_attr;
-		attr_map_ptr->to_attr = to_attr;
-
-		offset = get_attribute_value_offset(from_rel, from_attr);
 		if (offset < 0) {
 			return DB_IMPLEMENTATION_ERROR;
 		}
 
+		attr_map_ptr->from_attr = from_attr;
+		attr_map_ptr->to_attr = to_attr;
 		attr_map_ptr->from_offset = offset;
 		attr_map_ptr->to_offset = size_sum;
 		size_sum += to_attr->element_size;
@@ -686,7 +725,9 @@ static void select_index(db_handle_t **handle)
 	operand_value_t max;
 	attribute_value_t av_min;
 	attribute_value_t av_max;
-	long range;
+	attribute_value_t lo;
+	attribute_value_t hi;
+	unsigned long range;
 	unsigned long min_range;
 	index = NULL;
 	min_range = ULONG_MAX;
@@ -696,13 +737,22 @@ static void select_index(db_handle_t **handle)
 	attr = list_head((*handle)->rel->attributes);
 	while (attr != NULL) {
 		if (attr->index != NULL && !LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
-			range = (unsigned long)max.l - (unsigned long)min.l;
-			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %ld values\n", attr->name, range + 1);
+			if (attr->domain == DOMAIN_STRING) {
+				lo.domain = hi.domain = DOMAIN_STRING;
+				VALUE_STRING(&lo) = (unsigned char *)min.s;
+				VALUE_STRING(&hi) = (unsigned char *)max.s;
+			} else {
+				lo.domain = hi.domain = DOMAIN_LONG;
+				VALUE_LONG(&lo) = min.l;
+				VALUE_LONG(&hi) = max.l;
+			}
+			range = index_get_range(attr->index, &lo, &hi);
+			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %lu keys\n", attr->name, range + 1);
 			if (range <= min_range) {
 				index = attr->index;
-				av_min.domain = av_max.domain = DOMAIN_INT;
-				VALUE_LONG(&av_min) = min.l;
-				VALUE_LONG(&av_max) = max.l;
+				min_range = range;
+				av_min = lo;
+				av_max = hi;
 			}
 		}
 		attr = attr->next;
@@ -765,36 +815,12 @@ static void relation_delete_index_item(db_handle_t **handle, unsigned char *row_
 static db_result_t generate_selection_result(db_handle_t **handle, relation_t *rel)
 {
 	relation_t *result_rel;
-	unsigned attribute_count;
-	attribute_t *attr;
 
 	result_rel = (*handle)->result_rel;
 
 	(*handle)->current_row = 0;
-	(*handle)->ncolumns = 0;
 	(*handle)->tuple_id = -1;
 
-	for (attr = list_head(result_rel->attributes); attr != NULL; attr = attr->next) {
-		if (attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
-			continue;
-		}
-		(*handle)->ncolumns++;
-	}
-
-	attribute_count = result_rel->attribute_count;
-
-	/* Allocate attribute map and tuple row which is used in select operation */
-	(*handle)->attr_map = (source_dest_map_t *)malloc(sizeof(source_dest_map_t) * attribute_count);
-	if ((*handle)->attr_map == NULL) {
-		DB_LOG_E("DB: Failed to malloc attr_map\n");
-		return DB_ALLOCATION_ERROR;
-	}
-
-	if (DB_ERROR(generate_attribute_map((*handle)->attr_map, attribute_count, rel, result_rel))) {
-		free((*handle)->attr_map);
-		return DB_IMPLEMENTATION_ERROR;
-	}
-
 	if ((*handle)->lvm_instance != NULL) {
 		/* Try to establish acceptable ranges for the attribute values. */
 		if (!LVM_ERROR(lvm_derive((*handle)->lvm_instance))) {
@@ -805,7 +831,6 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 	(*handle)->tuple = (tuple_t)malloc(sizeof(char) * result_rel->row_length + 1);
 	if ((*handle)->tuple == NULL) {
 		DB_LOG_E("DB: Failed to malloc tuple row\n");
-		free((*handle)->attr_map);
 		return DB_ALLOCATION_ERROR;
 	}
 
@@ -847,10 +872,8 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 	db_result_t result;
 	unsigned attribute_count;
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
-	attribute_t *result_attr, *from_attr;
-	unsigned char *from_ptr, *to_ptr;
-	char aggr_buf[8];
-	attribute_value_t value;
+	attribute_t *from_attr;
+	unsigned char *from_ptr;
 	storage_row_t row = NULL;
 	tuple_t result_row;
 
@@ -909,7 +932,7 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG || from_attr->domain == DOMAIN_STRING)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -930,17 +953,9 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 		(*handle)->current_row++;
 
 		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
-			for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-				from_ptr = row + attr_map_ptr->from_offset;
-				result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
-
-				result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
+			result = group_add((*handle)->groups, row);
+			if (DB_ERROR(result)) {
+				goto errout;
 			}
 		} else {
 			result = cursor_data_add(cursor, (*handle)->tuple_id);
@@ -957,26 +972,13 @@ db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
 
 processing_aggregation:
 	/* Generate aggregated result if requested. */
-	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-		result_attr = attr_map_ptr->to_attr;
-		to_ptr = result_row + attr_map_ptr->to_offset;
-
-		snprintf(aggr_buf, sizeof(aggr_buf), "%f", result_attr->aggregation_value);
-		from_ptr = (unsigned char *)aggr_buf;
-		memcpy(to_ptr, from_ptr, sizeof(aggr_buf));
-	}
-
-	/* Copy aggregated result to tuple in cursor */
-	memcpy(cursor->tuple, result_row, sizeof(cursor->tuple));
-
 	(*handle)->current_row = 0;
 	(*handle)->adt_flags &= ~AQL_FLAG_AGGREGATE; /* Stop the aggregation. */
 
-	result = cursor_data_add(cursor, (*handle)->current_row);
+	result = group_finish((*handle)->groups, cursor);
 	if (DB_ERROR(result)) {
 		goto errout;
 	}
-	cursor->total_rows = 1;
 
 	if (row != NULL) {
 		free(row);
@@ -1036,7 +1038,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG || from_attr->domain == DOMAIN_STRING)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -1166,22 +1168,46 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 	return NULL;
 }
 
-db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
+static db_result_t result_attribute_add(db_handle_t **handle, db_direction_t dir, relation_t *from_rel, attribute_t *attr_ptr)
+{
+	attribute_t *attr;
+
+	if (attr_ptr->flags & ATTRIBUTE_FLAG_INVALID) {
+		DB_LOG_E("DB: Failed to add a result attribute\n");
+		relation_release((*handle)->result_rel);
+		return DB_ALLOCATION_ERROR;
+	} else {
+		index_load(from_rel, attr_ptr);
+	}
+
+	attr = relation_attribute_add((*handle)->result_rel, dir, attr_ptr->name, attr_ptr->domain, attr_ptr->element_size);
+	if (attr == NULL) {
+		DB_LOG_E("DB: Failed to add a result attribute\n");
+		relation_release((*handle)->result_rel);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	return DB_OK;
+}
+
+/*
+ * Create the result relation of a query on rel, or on the rows of rel
+ * joined with those of joined_rel, and the map from the source rows to
+ * the result rows.
+ */
+db_result_t relation_result_create(db_handle_t **handle, relation_t *rel, relation_t *joined_rel, void *adt_ptr)
 {
 	aql_adt_t *adt;
 	char *name;
 	db_direction_t dir;
 	char *attribute_name;
 	attribute_t *attr, *attr_ptr;
+	relation_t *from_rel;
 	relation_t * res_rel;
+	relation_t *result_rel;
 	int i;
 	int normal_attributes = 0;
 	adt = (aql_adt_t *)adt_ptr;
-	(*handle)->rel = rel;
-	(*handle)->optype = AQL_GET_TYPE(adt);
-	DB_LOG_D("relation_select... optype = %d\n", (*handle)->optype);
-	(*handle)->adt_flags = AQL_GET_FLAGS(adt);
-	(*handle)->lvm_instance = (lvm_instance_t *)adt->lvm_instance;
 
 	if (AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
 		name = adt->relations[0];
@@ -1202,39 +1228,42 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 	}
 
 	if (AQL_GET_FLAGS(adt) & AQL_FLAG_SELECT_ALL) {
-		attr_ptr = list_head(rel->attributes);
-		while (attr_ptr != NULL) {
-			if (attr_ptr->flags & ATTRIBUTE_FLAG_INVALID) {
-				DB_LOG_E("DB: Failed to add a result attribute\n");
-				relation_release((*handle)->result_rel);
+		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
+			if (DB_ERROR(result_attribute_add(handle, dir, rel, attr_ptr))) {
 				return DB_ALLOCATION_ERROR;
-			} else {
-				index_load(rel, attr_ptr);
 			}
-
-			attr = relation_attribute_add((*handle)->result_rel, dir, attr_ptr->name, attr_ptr->domain, attr_ptr->element_size);
-			if (attr == NULL) {
-				DB_LOG_E("DB: Failed to add a result attribute\n");
-				relation_release((*handle)->result_rel);
-				return DB_ALLOCATION_ERROR;
+		}
+		if (joined_rel != NULL) {
+			for (attr_ptr = list_head(joined_rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
+				if (attribute_find(rel, attr_ptr->name) != NULL) {
+					/* The first relation hides attributes of the same name. */
+					continue;
+				}
+				if (DB_ERROR(result_attribute_add(handle, dir, joined_rel, attr_ptr))) {
+					return DB_ALLOCATION_ERROR;
+				}
 			}
-			attr_ptr = attr_ptr->next;
 		}
 	} else {
 		for (i = normal_attributes; i < AQL_ATTRIBUTE_COUNT(adt); i++) {
 			attribute_name = adt->attributes[i].name;
 
+			from_rel = rel;
 			attr = relation_attribute_get(rel, attribute_name);
+			if (attr == NULL && joined_rel != NULL) {
+				from_rel = joined_rel;
+				attr = relation_attribute_get(joined_rel, attribute_name);
+			}
 			if (attr == NULL) {
 				DB_LOG_E("DB: Select for invalid attribute %s in relation %s!\n", attribute_name, rel->name);
 				return DB_NAME_ERROR;
 			} else {
-				index_load(rel, attr);
+				index_load(from_rel, attr);
 			}
 
-			DB_LOG_D("DB: Found attribute %s in relation %s\n", attribute_name, rel->name);
+			DB_LOG_D("DB: Found attribute %s in relation %s\n", attribute_name, from_rel->name);
 
-			attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, adt->aggregators[i] ? DOMAIN_DOUBLE : attr->domain, adt->aggregators[i] ? sizeof(double) : attr->element_size);
+			attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, adt->aggregators[i] ? DOMAIN_DOUBLE : attr->domain, adt->aggregators[i] ? DB_AGGREGATE_VALUE_LENGTH : attr->element_size);
 
 			if (attr == NULL) {
 				DB_LOG_E("DB: Failed to add a result attribute\n");
@@ -1242,32 +1271,72 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 				return DB_ALLOCATION_ERROR;
 			}
 			attr->aggregator = adt->aggregators[i];
-			switch (attr->aggregator) {
-			case AQL_NONE:
-				if (!(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE)) {
-					/* Only count attributes projected into the result set. */
-					normal_attributes++;
+			if (attr->aggregator == AQL_NONE && !(adt->attributes[i].flags & ATTRIBUTE_FLAG_NO_STORE)) {
+				/* Only count attributes projected into the result set. */
+				normal_attributes++;
+				if ((AQL_GET_FLAGS(adt) & AQL_FLAG_GROUP) && strcmp(attribute_name, adt->group_by) != 0) {
+					DB_LOG_E("DB: %s is neither aggregated nor grouped by\n", attribute_name);
+					return DB_RELATIONAL_ERROR;
 				}
-				break;
-			case AQL_MAX:
-				attr->aggregation_value = LONG_MIN;
-				break;
-			case AQL_MIN:
-				attr->aggregation_value = LONG_MAX;
-				break;
-			default:
-				attr->aggregation_value = 0;
-				break;
 			}
 			attr->flags = adt->attributes[i].flags;
 		}
 	}
 	/* Preclude mixes of normal attributes and aggregated ones in
-	   selection results. */
-	if (normal_attributes > 0 && (*handle)->result_rel->attribute_count > normal_attributes) {
+	   selection results, but for the attribute the rows are grouped by. */
+	if ((AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) && normal_attributes > 0 && !(AQL_GET_FLAGS(adt) & AQL_FLAG_GROUP)) {
+		return DB_RELATIONAL_ERROR;
+	}
+	if ((AQL_GET_FLAGS(adt) & AQL_FLAG_GROUP) && (AQL_GET_FLAGS(adt) & AQL_FLAG_SELECT_ALL)) {
 		return DB_RELATIONAL_ERROR;
 	}
 
+	result_rel = (*handle)->result_rel;
+	(*handle)->ncolumns = 0;
+	for (attr = list_head(result_rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
+			continue;
+		}
+		(*handle)->ncolumns++;
+	}
+
+	/* Allocate attribute map which is used in select operation */
+	(*handle)->attr_map = (source_dest_map_t *)malloc(sizeof(source_dest_map_t) * result_rel->attribute_count);
+	if ((*handle)->attr_map == NULL) {
+		DB_LOG_E("DB: Failed to malloc attr_map\n");
+		return DB_ALLOCATION_ERROR;
+	}
+
+	if (DB_ERROR(generate_attribute_map((*handle)->attr_map, result_rel->attribute_count, rel, joined_rel, result_rel))) {
+		return DB_IMPLEMENTATION_ERROR;
+	}
+
+	if (AQL_GET_FLAGS(adt) & AQL_FLAG_AGGREGATE) {
+		(*handle)->groups = group_create((*handle)->attr_map, result_rel->attribute_count, (AQL_GET_FLAGS(adt) & AQL_FLAG_GROUP) ? adt->group_by : NULL);
+		if ((*handle)->groups == NULL) {
+			return DB_ALLOCATION_ERROR;
+		}
+	}
+
+	return DB_OK;
+}
+
+db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
+{
+	aql_adt_t *adt;
+	db_result_t result;
+	adt = (aql_adt_t *)adt_ptr;
+	(*handle)->rel = rel;
+	(*handle)->optype = AQL_GET_TYPE(adt);
+	DB_LOG_D("relation_select... optype = %d\n", (*handle)->optype);
+	(*handle)->adt_flags = AQL_GET_FLAGS(adt);
+	(*handle)->lvm_instance = (lvm_instance_t *)adt->lvm_instance;
+
+	result = relation_result_create(handle, rel, NULL, adt);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
 	return generate_selection_result(handle, rel);
 }
 
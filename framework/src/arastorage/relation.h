@@ -134,6 +134,10 @@ struct relation_s {
 	db_storage_id_t tuple_storage;
 	db_direction_t dir;
 	uint8_t references;
+	uint8_t bulk;				/* Index updates deferred until relation_bulk_end() */
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	uint32_t txn;				/* Log transaction of the bulk load, or 0 */
+#endif
 	char name[RELATION_NAME_LENGTH + 1];
 	char tuple_filename[TUPLE_NAME_LENGTH + 1];
 };
@@ -159,6 +163,7 @@ struct _db_cursor_s {
 	attribute_id_t attribute_count;
 	size_t storage_row_length;
 	uint32_t *row_arr;
+	unsigned char *rows;		/* Rows of a result built in memory, or NULL */
 	unsigned char tuple[DB_MAX_ELEMENT_SIZE + 1];
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
@@ -187,12 +192,17 @@ relation_t *relation_create(char *, db_direction_t);
 db_result_t relation_rename(char *, char *);
 attribute_t *relation_attribute_add(relation_t *, db_direction_t, char *, domain_t, size_t);
 attribute_t *relation_attribute_get(relation_t *, char *);
+int get_attribute_value_offset(relation_t *, attribute_t *);
 db_result_t relation_get_value(relation_t *, attribute_t *, unsigned char *, attribute_value_t *);
 db_result_t relation_attribute_remove(relation_t *, char *);
 db_result_t relation_set_primary_key(relation_t *, char *);
 db_result_t relation_remove(relation_t *, int);
 db_result_t relation_insert(relation_t *, attribute_value_t *);
+db_result_t relation_bulk_begin(relation_t *);
+db_result_t relation_bulk_end(relation_t *);
 db_result_t relation_select(db_handle_t **, relation_t *, void *);
+db_result_t relation_result_create(db_handle_t **, relation_t *, relation_t *, void *);
+db_cursor_t *relation_join(db_handle_t **, relation_t *, void *);
 tuple_id_t relation_cardinality(relation_t *);
 
 #endif              /* RELATION_H */
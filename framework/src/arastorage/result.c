@@ -60,6 +60,12 @@
 #include "db_debug.h"
 #include "result.h"
 
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME        16777619U
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -180,3 +186,62 @@ long db_value_to_long(attribute_value_t *value)
 		return 0;
 	}
 }
+
+/* db_value_hash: Hash a value in the physical storage representation,
+   so that equal integers hash alike whatever their size. */
+uint32_t db_value_hash(attribute_t *attr, unsigned char *ptr)
+{
+	attribute_value_t value;
+	unsigned char bytes[4];
+	unsigned char *end;
+	uint32_t hash;
+	unsigned long long_value;
+
+	hash = FNV_OFFSET_BASIS;
+	if (attr->domain == DOMAIN_STRING) {
+		for (end = ptr + attr->element_size; ptr < end && *ptr != '\0'; ptr++) {
+			hash ^= *ptr;
+			hash *= FNV_PRIME;
+		}
+		return hash;
+	}
+
+	if (DB_ERROR(db_phy_to_value(&value, attr, ptr))) {
+		return hash;
+	}
+	long_value = (unsigned long)db_value_to_long(&value);
+	bytes[0] = long_value >> 24;
+	bytes[1] = long_value >> 16;
+	bytes[2] = long_value >> 8;
+	bytes[3] = long_value & 0xff;
+	for (ptr = bytes; ptr < bytes + sizeof(bytes); ptr++) {
+		hash ^= *ptr;
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/* db_value_equal: Compare two values in the physical storage
+   representation, which may belong to attributes of different sizes. */
+int db_value_equal(attribute_t *attr1, unsigned char *ptr1, attribute_t *attr2, unsigned char *ptr2)
+{
+	attribute_value_t value1;
+	attribute_value_t value2;
+	size_t size;
+
+	if ((attr1->domain == DOMAIN_STRING) != (attr2->domain == DOMAIN_STRING)) {
+		return 0;
+	}
+
+	if (attr1->domain == DOMAIN_STRING) {
+		size = attr1->element_size < attr2->element_size ? attr1->element_size : attr2->element_size;
+		return strncmp((char *)ptr1, (char *)ptr2, size) == 0;
+	}
+
+	if (DB_ERROR(db_phy_to_value(&value1, attr1, ptr1)) || DB_ERROR(db_phy_to_value(&value2, attr2, ptr2))) {
+		return 0;
+	}
+
+	return db_value_to_long(&value1) == db_value_to_long(&value2);
+}
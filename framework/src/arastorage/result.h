@@ -94,6 +94,10 @@ struct source_dest_map_s {
 };
 typedef struct source_dest_map_s source_dest_map_t;
 
+/* The groups of an aggregation, see aggregate.c */
+struct db_groups_s;
+typedef struct db_groups_s db_groups_t;
+
 struct _db_handle_s {
 	index_iterator_t index_iterator;
 	tuple_id_t tuple_id;
@@ -107,6 +111,7 @@ struct _db_handle_s {
 	uint8_t ncolumns;
 	void *lvm_instance;
 	source_dest_map_t *attr_map;
+	db_groups_t *groups;
 };
 
 /****************************************************************************
@@ -115,6 +120,15 @@ struct _db_handle_s {
 db_result_t db_get_value(attribute_value_t *value, db_handle_t *handle, unsigned col);
 db_result_t db_phy_to_value(attribute_value_t *value, attribute_t *attr, unsigned char *ptr);
 db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_value_t *value);
+uint32_t db_value_hash(attribute_t *attr, unsigned char *ptr);
+int db_value_equal(attribute_t *attr1, unsigned char *ptr1, attribute_t *attr2, unsigned char *ptr2);
+
+db_result_t cursor_rows_set(db_cursor_t *cursor, unsigned char *rows, tuple_id_t nrows, source_dest_map_t *attr_map, attribute_id_t attribute_count);
+
+db_groups_t *group_create(source_dest_map_t *attr_map, unsigned attribute_count, char *group_by);
+db_result_t group_add(db_groups_t *groups, unsigned char *row);
+db_result_t group_finish(db_groups_t *groups, db_cursor_t *cursor);
+void group_free(db_groups_t *groups);
 
 #endif              /* !RESULT_H */
 long db_value_to_long(attribute_value_t *value);
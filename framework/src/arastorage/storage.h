@@ -99,6 +99,7 @@ db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t, uint8_t);
 db_result_t storage_write_row(db_storage_id_t, storage_row_t, unsigned, char *);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
+db_result_t storage_truncate_rows(relation_t *, tuple_id_t);
 db_result_t storage_read_from(db_storage_id_t, void *, unsigned long, unsigned);
 db_result_t storage_write_to(db_storage_id_t, void *, unsigned long, unsigned);
 
@@ -116,6 +117,11 @@ db_result_t storage_rename(const char *, const char *);
 off_t storage_seek(db_storage_id_t, unsigned long, int);
 ssize_t storage_read(db_storage_id_t, void *, unsigned);
 ssize_t storage_write(db_storage_id_t, void *, unsigned);
+db_result_t storage_sync(db_storage_id_t);
+unsigned long storage_get_written_bytes(void);
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+void storage_fault_inject(long);
+#endif
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 ssize_t storage_get_availbyte_size(void);
 #endif
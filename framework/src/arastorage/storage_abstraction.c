@@ -29,6 +29,19 @@
 #include "db_debug.h"
 #include "storage.h"
 
+/****************************************************************************
+* Private Data
+****************************************************************************/
+/* Bytes handed to the file system, for measuring write amplification */
+static unsigned long g_storage_written;
+
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+/* Bytes left before a simulated power loss, or -1 when none is planned */
+static long g_storage_write_limit = -1;
+/* Set once the power is "lost": later changes to storage are dropped */
+static bool g_storage_lost;
+#endif
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -48,6 +61,11 @@ db_storage_id_t storage_open(const char *filename, int oflag)
 		return INVALID_STORAGE_ID;
 	}
 	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+	if (g_storage_lost) {
+		oflag &= ~(O_CREAT | O_TRUNC);
+	}
+#endif
 	fd = open(rel_path, oflag);
 	free(rel_path);
 	return fd;
@@ -69,6 +87,12 @@ db_result_t storage_remove(const char *filename)
 		return DB_STORAGE_ERROR;
 	}
 	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+	if (g_storage_lost) {
+		free(rel_path);
+		return DB_OK;
+	}
+#endif
 	if (unlink(rel_path) == OK) {
 		res = DB_OK;
 	}
@@ -96,6 +120,13 @@ db_result_t storage_rename(const char *old_name, const char *new_name)
 	snprintf(old_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, old_name);
 	snprintf(new_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, new_name);
 
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+	if (g_storage_lost) {
+		free(old_path);
+		free(new_path);
+		return DB_OK;
+	}
+#endif
 	if (rename(old_path, new_path) == OK) {
 		res = DB_OK;
 	}
@@ -119,9 +150,67 @@ ssize_t storage_read(db_storage_id_t fd, void *buffer, unsigned length)
 /* It mapped with write function in specific file system */
 ssize_t storage_write(db_storage_id_t fd, void *buffer, unsigned length)
 {
-	return write(fd, buffer, length);
+	ssize_t r;
+
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+	if (g_storage_lost) {
+		return length;
+	}
+	if (g_storage_write_limit >= 0 && length > g_storage_write_limit) {
+		/* The power fails in the middle of this write */
+		if (g_storage_write_limit > 0) {
+			r = write(fd, buffer, g_storage_write_limit);
+			if (r > 0) {
+				g_storage_written += r;
+			}
+		}
+		g_storage_lost = true;
+		return length;
+	}
+	if (g_storage_write_limit >= 0) {
+		g_storage_write_limit -= length;
+	}
+#endif
+	r = write(fd, buffer, length);
+	if (r > 0) {
+		g_storage_written += r;
+	}
+	return r;
+}
+
+/* It mapped with fsync function in specific file system */
+db_result_t storage_sync(db_storage_id_t fd)
+{
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+	if (g_storage_lost) {
+		return DB_OK;
+	}
+#endif
+	if (fsync(fd) != OK) {
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
 }
 
+unsigned long storage_get_written_bytes(void)
+{
+	return g_storage_written;
+}
+
+#ifdef CONFIG_ARASTORAGE_FAULT_INJECTION
+/*
+ * Simulate a power loss once @bytes more bytes have been written: the write
+ * crossing the limit is cut short, and all later writes, removals and
+ * renames report success without reaching storage. A negative @bytes
+ * restores the power.
+ */
+void storage_fault_inject(long bytes)
+{
+	g_storage_write_limit = bytes;
+	g_storage_lost = false;
+}
+#endif
+
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 ssize_t storage_get_availbyte_size(void)
 {
@@ -67,6 +67,9 @@
 #include "db_debug.h"
 #include "random.h"
 #include "storage.h"
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+#include "wal.h"
+#endif
 
 /****************************************************************************
 * Private Types
@@ -83,6 +86,24 @@ struct index_record_s {
 	uint8_t type;
 };
 
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+/* Create an empty tuple file under a name that is not in use yet. */
+static db_result_t generate_tuple_file(char *tuple_path)
+{
+	int fd;
+
+	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	while ((fd = storage_open(tuple_path, O_RDWR)) > 0) {
+		DB_LOG_D("DB: tuplefile = %s already exist, try another\n", tuple_path);
+		storage_close(fd);
+		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	}
+
+	return storage_generate_file(tuple_path);
+}
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -231,15 +252,7 @@ db_result_t storage_put_relation(relation_t *rel)
 	}
 
 	if (rel->tuple_filename[0] == '\0') {
-		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
-		int nfd;
-		while ((nfd = storage_open(tuple_path, O_RDWR)) > 0) {
-			DB_LOG_D("DB: tuplefile = %s already exist, try another\n", tuple_path);
-			storage_close(nfd);
-			snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
-		}
-		
-		result = storage_generate_file(tuple_path);
+		result = generate_tuple_file(tuple_path);
 		if (DB_ERROR(result)) {
 			storage_close(fd);
 			storage_remove(rel->tuple_filename);
@@ -584,6 +597,13 @@ db_result_t storage_flush_insert_buffer()
 		return DB_OK;
 	}
 
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* The rows may only reach their file once they are in the log */
+	if (DB_ERROR(wal_force())) {
+		return DB_STORAGE_ERROR;
+	}
+#endif
+
 	fd = storage_open(g_storage_write_buffer.file_name, O_APPEND | O_RDWR);
 	if (fd < 0) {
 		DB_LOG_D("Failed to open %s\n", g_storage_write_buffer.file_name);
@@ -596,6 +616,13 @@ db_result_t storage_flush_insert_buffer()
 		return DB_STORAGE_ERROR;
 	}
 	DB_LOG_D("DB : Stored buffer(%d bytes) in storage\n", g_storage_write_buffer.data_size);
+#ifdef CONFIG_ARASTORAGE_ENABLE_WAL
+	/* A checkpoint empties the log after this, so the rows must be durable */
+	if (DB_ERROR(storage_sync(fd))) {
+		storage_close(fd);
+		return DB_STORAGE_ERROR;
+	}
+#endif
 	storage_close(fd);
 	storage_write_buffer_clean();
 	return DB_OK;
@@ -617,6 +644,79 @@ db_result_t storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 	return DB_OK;
 }
 
+/*
+ * Cut the tuple file of a relation down to its first @nrows rows. As files
+ * cannot be truncated, the rows are copied to a new tuple file, which the
+ * relation file then refers to.
+ */
+db_result_t storage_truncate_rows(relation_t *rel, tuple_id_t nrows)
+{
+	char tuple_path[sizeof(rel->tuple_filename)];
+	char old_path[sizeof(rel->tuple_filename)];
+	storage_row_t row;
+	tuple_id_t tuple_id;
+	db_result_t result;
+	int fd;
+
+	row = (storage_row_t)malloc(rel->row_length);
+	if (row == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	memset(tuple_path, 0, sizeof(tuple_path));
+	result = generate_tuple_file(tuple_path);
+	if (DB_ERROR(result)) {
+		free(row);
+		return result;
+	}
+
+	fd = storage_open(tuple_path, O_RDWR | O_APPEND);
+	if (fd < 0) {
+		free(row);
+		storage_remove(tuple_path);
+		return DB_STORAGE_ERROR;
+	}
+	for (tuple_id = 0; tuple_id < nrows; tuple_id++) {
+		result = storage_read_from(rel->tuple_storage, row, (unsigned long)tuple_id * rel->row_length, rel->row_length);
+		if (DB_ERROR(result) || storage_write(fd, row, rel->row_length) != rel->row_length) {
+			result = DB_STORAGE_ERROR;
+			break;
+		}
+	}
+	free(row);
+	if (DB_SUCCESS(result)) {
+		result = storage_sync(fd);
+	}
+	storage_close(fd);
+	if (DB_ERROR(result)) {
+		storage_remove(tuple_path);
+		return result;
+	}
+
+	/* The relation file starts with the name of its tuple file */
+	fd = storage_open(rel->name, O_RDWR);
+	if (fd < 0) {
+		storage_remove(tuple_path);
+		return DB_STORAGE_ERROR;
+	}
+	result = storage_write_to(fd, tuple_path, 0, sizeof(tuple_path));
+	if (DB_SUCCESS(result)) {
+		result = storage_sync(fd);
+	}
+	storage_close(fd);
+	if (DB_ERROR(result)) {
+		storage_remove(tuple_path);
+		return result;
+	}
+
+	memcpy(old_path, rel->tuple_filename, sizeof(old_path));
+	memcpy(rel->tuple_filename, tuple_path, sizeof(rel->tuple_filename));
+	storage_unload(rel);
+	storage_remove(old_path);
+	rel->cardinality = nrows;
+	return storage_load(rel);
+}
+
 db_result_t storage_read_from(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
 {
 	ssize_t r;
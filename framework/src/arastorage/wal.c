@@ -0,0 +1,761 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file
+ *      The write-ahead log of AraStorage.
+ *
+ *      The log is a file of checksummed records:
+ *        INSERT - a row of a relation and the tuple id it gets there; with
+ *                 transaction 0 the record commits itself.
+ *        BEGIN  - the start of a bulk load, at a tuple id of a relation.
+ *        COMMIT - the end of a bulk load.
+ *
+ *      Records are appended to one of two buffers. A thread that needs its
+ *      records durable writes and syncs the buffer while the other one takes
+ *      new records, and threads that need the same or an earlier position
+ *      wait for that write instead of syncing on their own (group commit).
+ *
+ *      A checkpoint flushes the insert buffer and the index caches, then
+ *      empties the log, keeping a BEGIN record for each bulk load in
+ *      progress. Recovery writes the committed rows of the log to their
+ *      tuple files, cuts off the rows of bulk loads that were not
+ *      committed, and rebuilds the indexes of the relations concerned.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <crc32.h>
+
+#include "db_options.h"
+#include "db_debug.h"
+#include "index.h"
+#include "storage.h"
+#include "wal.h"
+
+/****************************************************************************
+* Private Types
+****************************************************************************/
+enum wal_record_type_e {
+	WAL_INSERT = 1,
+	WAL_BEGIN,
+	WAL_COMMIT
+};
+
+struct wal_record_s {
+	uint8_t type;
+	uint8_t name_length;		/* length of the relation name that follows */
+	uint16_t row_length;		/* length of the row that follows the name */
+	uint32_t txn;				/* bulk load, or 0 */
+	uint32_t tuple_id;
+	uint32_t crc;				/* crc32 of the record, with crc set to 0 */
+};
+
+/* A bulk load in progress */
+struct wal_txn_s {
+	uint32_t id;
+	tuple_id_t start;
+	char name[RELATION_NAME_LENGTH + 1];
+};
+
+/* Log positions count the bytes appended since wal_init() */
+typedef unsigned long wal_lsn_t;
+
+struct wal_s {
+	db_storage_id_t fd;
+	unsigned char *buffer[2];
+	int active;					/* the buffer taking new records */
+	unsigned used;				/* bytes in the active buffer */
+	uint8_t writing;			/* the other buffer is being written */
+	uint8_t broken;				/* a log write failed since the last checkpoint */
+	wal_lsn_t lsn;				/* end of the last record */
+	wal_lsn_t commit_lsn;		/* end of the last record that commits */
+	wal_lsn_t durable_lsn;		/* end of the last record synced */
+	unsigned long size;			/* bytes in the log file */
+	uint32_t next_txn;
+	struct wal_txn_s txns[DB_WAL_TXN_LIMIT];
+	pthread_mutex_t lock;		/* protects the fields above */
+	pthread_cond_t written;		/* a buffer write has finished */
+	pthread_mutex_t exec_lock;	/* held by the running statement */
+#if DB_WAL_CHECKPOINT_SIZE > 0
+	pthread_t checkpointer;
+	pthread_cond_t wakeup;		/* the log is due for a checkpoint */
+	uint8_t checkpoint_due;
+	uint8_t stop;
+#endif
+};
+
+/****************************************************************************
+* Private Data
+****************************************************************************/
+static struct wal_s g_wal;
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+/*
+ * Write the active buffer to the log and sync it, as the leader of a group
+ * commit. Called with g_wal.lock held and no write in progress; the lock is
+ * released during the write, while new records go to the other buffer.
+ */
+static void wal_write_buffer(void)
+{
+	unsigned char *buffer;
+	unsigned length;
+	wal_lsn_t end;
+	bool ok;
+
+	length = g_wal.used;
+	end = g_wal.lsn;
+	if (length == 0) {
+		g_wal.durable_lsn = end;
+		return;
+	}
+
+	buffer = g_wal.buffer[g_wal.active];
+	g_wal.active ^= 1;
+	g_wal.used = 0;
+	g_wal.writing = 1;
+	pthread_mutex_unlock(&g_wal.lock);
+
+	ok = storage_write(g_wal.fd, buffer, length) == length && DB_SUCCESS(storage_sync(g_wal.fd));
+
+	pthread_mutex_lock(&g_wal.lock);
+	g_wal.writing = 0;
+	/* On failure the records are lost; their waiters see the broken log */
+	g_wal.durable_lsn = end;
+	if (ok) {
+		g_wal.size += length;
+	} else {
+		DB_LOG_E("DB: Failed to write %u bytes to the log\n", length);
+		g_wal.broken = 1;
+	}
+#if DB_WAL_CHECKPOINT_SIZE > 0
+	if (g_wal.size >= DB_WAL_CHECKPOINT_SIZE && !g_wal.checkpoint_due) {
+		g_wal.checkpoint_due = 1;
+		pthread_cond_signal(&g_wal.wakeup);
+	}
+#endif
+	pthread_cond_broadcast(&g_wal.written);
+}
+
+/* Wait until the log is durable up to lsn, writing it if nobody else is. */
+static db_result_t wal_sync(wal_lsn_t lsn)
+{
+	db_result_t result;
+#if DB_WAL_COMMIT_DELAY > 0
+	bool delayed = false;
+#endif
+
+	pthread_mutex_lock(&g_wal.lock);
+	while (g_wal.durable_lsn < lsn) {
+		if (g_wal.writing) {
+			pthread_cond_wait(&g_wal.written, &g_wal.lock);
+			continue;
+		}
+#if DB_WAL_COMMIT_DELAY > 0
+		if (!delayed) {
+			/* Give other commits the chance to join this write */
+			delayed = true;
+			pthread_mutex_unlock(&g_wal.lock);
+			usleep(DB_WAL_COMMIT_DELAY);
+			pthread_mutex_lock(&g_wal.lock);
+			continue;
+		}
+#endif
+		wal_write_buffer();
+	}
+	result = g_wal.broken ? DB_STORAGE_ERROR : DB_OK;
+	pthread_mutex_unlock(&g_wal.lock);
+
+	return result;
+}
+
+static db_result_t wal_append(uint8_t type, uint32_t txn, tuple_id_t tuple_id, const char *name, const unsigned char *row, unsigned row_length)
+{
+	struct wal_record_s record;
+	unsigned char *ptr;
+	unsigned name_length;
+	unsigned length;
+
+	name_length = strlen(name);
+	length = sizeof(record) + name_length + row_length;
+	if (length > DB_WAL_BUFFER_SIZE) {
+		DB_LOG_E("DB: A log record of %u bytes does not fit in the log buffer\n", length);
+		return DB_LIMIT_ERROR;
+	}
+
+	record.type = type;
+	record.name_length = name_length;
+	record.row_length = row_length;
+	record.txn = txn;
+	record.tuple_id = tuple_id;
+	record.crc = 0;
+
+	pthread_mutex_lock(&g_wal.lock);
+	while (g_wal.used + length > DB_WAL_BUFFER_SIZE) {
+		if (g_wal.writing) {
+			pthread_cond_wait(&g_wal.written, &g_wal.lock);
+		} else {
+			wal_write_buffer();
+		}
+	}
+
+	ptr = g_wal.buffer[g_wal.active] + g_wal.used;
+	memcpy(ptr, &record, sizeof(record));
+	memcpy(ptr + sizeof(record), name, name_length);
+	if (row_length > 0) {
+		memcpy(ptr + sizeof(record) + name_length, row, row_length);
+	}
+	record.crc = crc32(ptr, length);
+	memcpy(ptr + offsetof(struct wal_record_s, crc), &record.crc, sizeof(record.crc));
+
+	g_wal.used += length;
+	g_wal.lsn += length;
+	if (type == WAL_COMMIT || (type == WAL_INSERT && txn == 0)) {
+		g_wal.commit_lsn = g_wal.lsn;
+	}
+	pthread_mutex_unlock(&g_wal.lock);
+
+	return DB_OK;
+}
+
+/* Start the log over, with the bulk loads in progress. */
+static db_result_t wal_reset(void)
+{
+	db_result_t result;
+	int i;
+
+	pthread_mutex_lock(&g_wal.lock);
+	while (g_wal.writing) {
+		pthread_cond_wait(&g_wal.written, &g_wal.lock);
+	}
+	if (g_wal.fd >= 0) {
+		storage_close(g_wal.fd);
+	}
+	g_wal.fd = storage_open(WAL_FILE_NAME, O_RDWR | O_APPEND | O_CREAT | O_TRUNC);
+	g_wal.size = 0;
+	g_wal.used = 0;
+	g_wal.durable_lsn = g_wal.lsn;
+	g_wal.broken = g_wal.fd < 0;
+	pthread_mutex_unlock(&g_wal.lock);
+
+	if (g_wal.fd < 0) {
+		DB_LOG_E("DB: Failed to create the log file\n");
+		return DB_STORAGE_ERROR;
+	}
+
+	for (i = 0; i < DB_WAL_TXN_LIMIT; i++) {
+		if (g_wal.txns[i].id != 0) {
+			result = wal_append(WAL_BEGIN, g_wal.txns[i].id, g_wal.txns[i].start, g_wal.txns[i].name, NULL, 0);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+	}
+
+	return wal_force();
+}
+
+/*
+ * Read the record at offset into record and payload, which has room for
+ * DB_WAL_BUFFER_SIZE bytes. Returns the length of the record, or 0 at the
+ * end of the log, which a torn or damaged record also marks.
+ */
+static unsigned wal_read_record(db_storage_id_t fd, unsigned long offset, struct wal_record_s *record, unsigned char *payload)
+{
+	unsigned length;
+	uint32_t crc;
+
+	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
+		return 0;
+	}
+	if (storage_read(fd, record, sizeof(*record)) != sizeof(*record)) {
+		return 0;
+	}
+	if (record->type < WAL_INSERT || record->type > WAL_COMMIT || record->name_length > RELATION_NAME_LENGTH) {
+		return 0;
+	}
+
+	length = record->name_length + record->row_length;
+	if (sizeof(*record) + length > DB_WAL_BUFFER_SIZE) {
+		return 0;
+	}
+	if (length > 0 && storage_read(fd, payload, length) != length) {
+		return 0;
+	}
+
+	crc = record->crc;
+	record->crc = 0;
+	if (crc32part(payload, length, crc32((uint8_t *)record, sizeof(*record))) != crc) {
+		DB_LOG_E("DB: Log record at %lu is damaged\n", offset);
+		return 0;
+	}
+	record->crc = crc;
+
+	return sizeof(*record) + length;
+}
+
+static bool wal_is_committed(struct wal_record_s *record, uint32_t *commits, int ncommits)
+{
+	int i;
+
+	if (record->txn == 0) {
+		return true;
+	}
+	for (i = 0; i < ncommits; i++) {
+		if (commits[i] == record->txn) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool wal_is_for(struct wal_record_s *record, unsigned char *payload, const char *name)
+{
+	return record->type != WAL_COMMIT && record->name_length == strlen(name) && strncmp((char *)payload, name, record->name_length) == 0;
+}
+
+/*
+ * Bring one relation up to date with the records in the first end bytes of
+ * the log: write its committed rows, drop the rows of the bulk loads that
+ * were not committed, and rebuild its indexes.
+ */
+static db_result_t wal_redo(db_storage_id_t log, unsigned long end, const char *name, uint32_t *commits, int ncommits, unsigned char *payload)
+{
+	struct wal_record_s record;
+	relation_t *rel;
+	attribute_t *attr;
+	db_storage_id_t fd;
+	tuple_id_t keep;
+	tuple_id_t nrows;
+	off_t size;
+	unsigned long offset;
+	unsigned length;
+	db_result_t result;
+
+	/* The rows from the first uncommitted bulk load on are not kept */
+	keep = INVALID_TUPLE;
+	for (offset = 0; offset < end; offset += length) {
+		length = wal_read_record(log, offset, &record, payload);
+		if (length == 0) {
+			return DB_STORAGE_ERROR;
+		}
+		if (wal_is_for(&record, payload, name) && !wal_is_committed(&record, commits, ncommits) && record.tuple_id < keep) {
+			keep = record.tuple_id;
+		}
+	}
+
+	rel = relation_load((char *)name);
+	if (rel == NULL) {
+		/* The relation was removed after these records */
+		DB_LOG_D("DB: Skip the log records of %s\n", name);
+		return DB_OK;
+	}
+
+	if (rel->row_length == 0) {
+		relation_release(rel);
+		return DB_OK;
+	}
+
+	fd = storage_open(rel->tuple_filename, O_RDWR);
+	if (fd < 0) {
+		relation_release(rel);
+		return DB_STORAGE_ERROR;
+	}
+	nrows = (tuple_id_t)(storage_seek(fd, 0, SEEK_END) / rel->row_length);
+
+	result = DB_OK;
+	for (offset = 0; offset < end && DB_SUCCESS(result); offset += length) {
+		length = wal_read_record(log, offset, &record, payload);
+		if (length == 0) {
+			result = DB_STORAGE_ERROR;
+			break;
+		}
+		if (record.type != WAL_INSERT || !wal_is_for(&record, payload, name)) {
+			continue;
+		}
+		if (record.row_length != rel->row_length || !wal_is_committed(&record, commits, ncommits) || record.tuple_id >= keep) {
+			continue;
+		}
+		if (record.tuple_id > nrows) {
+			DB_LOG_E("DB: Row %lu of %s is missing\n", (unsigned long)nrows, rel->name);
+			result = DB_INCONSISTENCY_ERROR;
+			break;
+		}
+		/* The row may be in the file already, but possibly torn */
+		result = storage_write_to(fd, payload + record.name_length, (unsigned long)record.tuple_id * rel->row_length, rel->row_length);
+		if (record.tuple_id == nrows) {
+			nrows++;
+		}
+	}
+	size = storage_seek(fd, 0, SEEK_END);
+	if (DB_SUCCESS(result)) {
+		result = storage_sync(fd);
+	}
+	storage_close(fd);
+
+	/* Cut off uncommitted rows, and a row torn by the power loss */
+	if (nrows > keep) {
+		nrows = keep;
+	}
+	if (DB_SUCCESS(result) && size != (off_t)nrows * rel->row_length) {
+		DB_LOG_D("DB: Cut %s down to %lu rows\n", rel->name, (unsigned long)nrows);
+		result = storage_truncate_rows(rel, nrows);
+	}
+
+	if (DB_SUCCESS(result)) {
+		rel->cardinality = INVALID_TUPLE;
+		rel->cardinality = relation_cardinality(rel);
+		rel->next_row = rel->cardinality;
+		for (attr = list_head(rel->attributes); attr != NULL && DB_SUCCESS(result); attr = attr->next) {
+			if (attr->index == NULL) {
+				/* Fails for attributes without an index */
+				index_load(rel, attr);
+			}
+			if (attr->index != NULL) {
+				result = index_rebuild(attr->index);
+			}
+		}
+	}
+
+	relation_release(rel);
+	return result;
+}
+
+static db_result_t wal_recover(void)
+{
+	struct wal_record_s record;
+	unsigned char *payload;
+	char (*names)[RELATION_NAME_LENGTH + 1];
+	void *tmp;
+	uint32_t *commits;
+	int nnames;
+	int ncommits;
+	db_storage_id_t fd;
+	unsigned long offset;
+	unsigned length;
+	db_result_t result;
+	int i;
+
+	fd = storage_open(WAL_FILE_NAME, O_RDONLY);
+	if (fd < 0) {
+		/* No log, nothing to recover */
+		return DB_OK;
+	}
+
+	payload = (unsigned char *)malloc(DB_WAL_BUFFER_SIZE);
+	if (payload == NULL) {
+		storage_close(fd);
+		return DB_ALLOCATION_ERROR;
+	}
+
+	/* Find the end of the log, the committed bulk loads and the relations */
+	names = NULL;
+	commits = NULL;
+	nnames = 0;
+	ncommits = 0;
+	result = DB_OK;
+	for (offset = 0; (length = wal_read_record(fd, offset, &record, payload)) > 0; offset += length) {
+		if (record.type == WAL_COMMIT) {
+			tmp = realloc(commits, (ncommits + 1) * sizeof(uint32_t));
+			if (tmp == NULL) {
+				result = DB_ALLOCATION_ERROR;
+				break;
+			}
+			commits = tmp;
+			commits[ncommits++] = record.txn;
+			continue;
+		}
+
+		for (i = 0; i < nnames; i++) {
+			if (wal_is_for(&record, payload, names[i])) {
+				break;
+			}
+		}
+		if (i == nnames) {
+			tmp = realloc(names, (nnames + 1) * sizeof(*names));
+			if (tmp == NULL) {
+				result = DB_ALLOCATION_ERROR;
+				break;
+			}
+			names = tmp;
+			memcpy(names[i], payload, record.name_length);
+			names[i][record.name_length] = '\0';
+			nnames++;
+		}
+	}
+
+	if (nnames > 0) {
+		DB_LOG_D("DB: Recover %d relations from %lu bytes of log\n", nnames, offset);
+	}
+	for (i = 0; i < nnames && DB_SUCCESS(result); i++) {
+		result = wal_redo(fd, offset, names[i], commits, ncommits, payload);
+	}
+
+	storage_close(fd);
+	free(payload);
+	free(names);
+	free(commits);
+	return result;
+}
+
+#if DB_WAL_CHECKPOINT_SIZE > 0
+static void *wal_checkpointer(void *arg)
+{
+	pthread_mutex_lock(&g_wal.lock);
+	while (!g_wal.stop) {
+		if (!g_wal.checkpoint_due) {
+			pthread_cond_wait(&g_wal.wakeup, &g_wal.lock);
+			continue;
+		}
+		pthread_mutex_unlock(&g_wal.lock);
+
+		wal_enter();
+		wal_checkpoint();
+		wal_leave();
+
+		pthread_mutex_lock(&g_wal.lock);
+		g_wal.checkpoint_due = 0;
+	}
+	pthread_mutex_unlock(&g_wal.lock);
+
+	return NULL;
+}
+#endif
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+db_result_t wal_init(void)
+{
+	db_result_t result;
+
+	memset(&g_wal, 0, sizeof(g_wal));
+	g_wal.fd = -1;
+	g_wal.next_txn = 1;
+	g_wal.buffer[0] = (unsigned char *)malloc(DB_WAL_BUFFER_SIZE);
+	g_wal.buffer[1] = (unsigned char *)malloc(DB_WAL_BUFFER_SIZE);
+	if (g_wal.buffer[0] == NULL || g_wal.buffer[1] == NULL) {
+		free(g_wal.buffer[0]);
+		free(g_wal.buffer[1]);
+		return DB_ALLOCATION_ERROR;
+	}
+	pthread_mutex_init(&g_wal.lock, NULL);
+	pthread_cond_init(&g_wal.written, NULL);
+	pthread_mutex_init(&g_wal.exec_lock, NULL);
+
+	/* The log is only emptied once its rows are safe in the relations */
+	result = wal_recover();
+	if (DB_SUCCESS(result)) {
+		result = wal_reset();
+	}
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to recover from the log : %d\n", result);
+		goto errout;
+	}
+
+#if DB_WAL_CHECKPOINT_SIZE > 0
+	pthread_cond_init(&g_wal.wakeup, NULL);
+	if (pthread_create(&g_wal.checkpointer, NULL, wal_checkpointer, NULL) != 0) {
+		DB_LOG_E("DB: Failed to start the checkpoint thread\n");
+		pthread_cond_destroy(&g_wal.wakeup);
+		result = DB_ALLOCATION_ERROR;
+		goto errout;
+	}
+#endif
+	return DB_OK;
+
+errout:
+	if (g_wal.fd >= 0) {
+		storage_close(g_wal.fd);
+		g_wal.fd = -1;
+	}
+	pthread_mutex_destroy(&g_wal.exec_lock);
+	pthread_cond_destroy(&g_wal.written);
+	pthread_mutex_destroy(&g_wal.lock);
+	free(g_wal.buffer[0]);
+	free(g_wal.buffer[1]);
+	g_wal.buffer[0] = NULL;
+	g_wal.buffer[1] = NULL;
+	return result;
+}
+
+db_result_t wal_deinit(void)
+{
+	db_result_t result;
+
+	if (g_wal.buffer[0] == NULL) {
+		return DB_OK;
+	}
+
+#if DB_WAL_CHECKPOINT_SIZE > 0
+	pthread_mutex_lock(&g_wal.lock);
+	g_wal.stop = 1;
+	pthread_cond_signal(&g_wal.wakeup);
+	pthread_mutex_unlock(&g_wal.lock);
+	pthread_join(g_wal.checkpointer, NULL);
+	pthread_cond_destroy(&g_wal.wakeup);
+#endif
+
+	wal_enter();
+	result = wal_checkpoint();
+	wal_leave();
+
+	storage_close(g_wal.fd);
+	g_wal.fd = -1;
+	pthread_mutex_destroy(&g_wal.exec_lock);
+	pthread_cond_destroy(&g_wal.written);
+	pthread_mutex_destroy(&g_wal.lock);
+	free(g_wal.buffer[0]);
+	free(g_wal.buffer[1]);
+	g_wal.buffer[0] = NULL;
+	g_wal.buffer[1] = NULL;
+	return result;
+}
+
+void wal_enter(void)
+{
+	pthread_mutex_lock(&g_wal.exec_lock);
+}
+
+void wal_leave(void)
+{
+	pthread_mutex_unlock(&g_wal.exec_lock);
+}
+
+/* Log a row that relation_insert() is about to store as rel->next_row. */
+db_result_t wal_log_insert(relation_t *rel, storage_row_t row)
+{
+	return wal_append(WAL_INSERT, rel->txn, rel->next_row, rel->name, row, rel->row_length);
+}
+
+/* Start the transaction of a bulk load; its rows are logged under it. */
+db_result_t wal_begin(relation_t *rel)
+{
+	db_result_t result;
+	int i;
+
+	for (i = 0; i < DB_WAL_TXN_LIMIT; i++) {
+		if (g_wal.txns[i].id == 0) {
+			break;
+		}
+	}
+	if (i == DB_WAL_TXN_LIMIT) {
+		DB_LOG_E("DB: Too many bulk loads in progress\n");
+		return DB_LIMIT_ERROR;
+	}
+
+	result = wal_append(WAL_BEGIN, g_wal.next_txn, rel->next_row, rel->name, NULL, 0);
+	if (DB_ERROR(result)) {
+		return result;
+	}
+
+	g_wal.txns[i].id = g_wal.next_txn;
+	g_wal.txns[i].start = rel->next_row;
+	strncpy(g_wal.txns[i].name, rel->name, sizeof(g_wal.txns[i].name));
+	g_wal.txns[i].name[sizeof(g_wal.txns[i].name) - 1] = '\0';
+	rel->txn = g_wal.next_txn++;
+	if (g_wal.next_txn == 0) {
+		g_wal.next_txn = 1;
+	}
+
+	return DB_OK;
+}
+
+/* Commit the bulk load of rel; wal_wait_commit() makes it durable. */
+db_result_t wal_commit(relation_t *rel)
+{
+	db_result_t result;
+	int i;
+
+	if (rel->txn == 0) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	result = wal_append(WAL_COMMIT, rel->txn, 0, rel->name, NULL, 0);
+	for (i = 0; i < DB_WAL_TXN_LIMIT; i++) {
+		if (g_wal.txns[i].id == rel->txn) {
+			g_wal.txns[i].id = 0;
+		}
+	}
+	rel->txn = 0;
+
+	return result;
+}
+
+/* Make every record appended so far durable. */
+db_result_t wal_force(void)
+{
+	wal_lsn_t lsn;
+
+	pthread_mutex_lock(&g_wal.lock);
+	lsn = g_wal.lsn;
+	pthread_mutex_unlock(&g_wal.lock);
+
+	return wal_sync(lsn);
+}
+
+/*
+ * Wait until the statements committed so far are durable. Statements call
+ * this after wal_leave(), so that the commits of other threads can share
+ * the same log write.
+ */
+db_result_t wal_wait_commit(void)
+{
+	wal_lsn_t lsn;
+
+	pthread_mutex_lock(&g_wal.lock);
+	lsn = g_wal.commit_lsn;
+	pthread_mutex_unlock(&g_wal.lock);
+
+	return wal_sync(lsn);
+}
+
+/*
+ * Write the buffered rows and the cached index changes to storage and
+ * empty the log. Called between wal_enter() and wal_leave().
+ */
+db_result_t wal_checkpoint(void)
+{
+	db_result_t result;
+
+	result = wal_force();
+	if (DB_SUCCESS(result)) {
+		result = storage_flush_insert_buffer();
+	}
+	if (DB_SUCCESS(result)) {
+		result = index_sync();
+	}
+	if (DB_ERROR(result)) {
+		/* The log still has the rows, so recovery remains possible */
+		DB_LOG_E("DB: Checkpoint failed : %d\n", result);
+		return result;
+	}
+
+	DB_LOG_D("DB: Checkpoint with %lu bytes of log\n", g_wal.size);
+	return wal_reset();
+}
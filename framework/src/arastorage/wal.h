@@ -0,0 +1,58 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * \file
+ *      The write-ahead log of AraStorage.
+ *
+ *      Inserted rows are appended to the log before they reach their tuple
+ *      files, and a statement returns once its rows are durable in the log.
+ *      Tuple and index files are brought up to date by checkpoints, after
+ *      which the log starts over. db_init() replays the committed rows of
+ *      the log into the tuple files and rebuilds the indexes of the
+ *      relations it touched.
+ */
+
+#ifndef WAL_H
+#define WAL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <arastorage/arastorage.h>
+#include "relation.h"
+#include "storage.h"
+
+/****************************************************************************
+* Global Function Prototypes
+****************************************************************************/
+db_result_t wal_init(void);
+db_result_t wal_deinit(void);
+
+/* Statements run between wal_enter() and wal_leave(), one at a time. */
+void wal_enter(void);
+void wal_leave(void);
+
+db_result_t wal_log_insert(relation_t *, storage_row_t);
+db_result_t wal_begin(relation_t *);
+db_result_t wal_commit(relation_t *);
+
+db_result_t wal_force(void);
+db_result_t wal_wait_commit(void);
+db_result_t wal_checkpoint(void);
+
+#endif							/* WAL_H */
@@ -28,12 +28,40 @@
 #include "ui_request_callback.h"
 #include "ui_debug.h"
 
+#if defined(CONFIG_UI_ENABLE_EMOJI)
+#include "utils/emoji.h"
+#endif
+
 #define STB_TRUETYPE_IMPLEMENTATION 
 #include <stb/stb_truetype.h>
 
 #define DEFAULT_GLYPH_MAP_CAPACITY 256
 
+#define UI_GLYPH_HASH_SIZE 64
+
+#define UI_GLYPH_HASH(font, utf_code, font_size) \
+	((((uintptr_t)(font) >> 4) + ((utf_code) * 31) + (font_size)) & (UI_GLYPH_HASH_SIZE - 1))
+
+/**
+ * @brief Glyph cache shared by all font assets
+ *
+ * Rasterizing a glyph takes far longer than drawing it, so the glyphs are kept until
+ * CONFIG_UI_GLYPH_CACHE_SIZE bytes are used up and then the least recently used ones
+ * are dropped. It is only accessed by the UI thread.
+ */
+typedef struct {
+	ui_glyph_t *hash[UI_GLYPH_HASH_SIZE];
+	ui_glyph_t *lru_head; //!< Most recently used glyph
+	ui_glyph_t *lru_tail; //!< Least recently used glyph
+	size_t used;          //!< Bytes of the cached glyphs, including their headers
+} ui_glyph_cache_t;
+
 static void _ui_font_asset_destroy_func(void *userdata);
+static ui_glyph_t *_ui_glyph_cache_alloc(size_t bitmap_size);
+static void _ui_glyph_cache_remove(ui_glyph_t *glyph);
+static ui_glyph_t *_ui_glyph_rasterize(ui_font_asset_body_t *font, uint32_t utf_code, size_t font_size);
+
+static ui_glyph_cache_t g_glyph_cache;
 
 ui_asset_t ui_font_asset_create_from_file(const char *filename)
 {
@@ -172,9 +200,217 @@ ui_error_t ui_font_asset_destroy(ui_asset_t font)
 static void _ui_font_asset_destroy_func(void *userdata)
 {
 	ui_font_asset_body_t *body;
+	ui_glyph_t *glyph;
+	ui_glyph_t *next;
 
 	body = (ui_font_asset_body_t *)userdata;
 
+	// The glyphs of this font can never be hit again and the address may be reused by a new font
+	glyph = g_glyph_cache.lru_head;
+	while (glyph) {
+		next = glyph->lru_next;
+		if (glyph->font == body) {
+			_ui_glyph_cache_remove(glyph);
+		}
+		glyph = next;
+	}
+
 	UI_FREE(body->ttf_buf);
 	UI_FREE(body);
 }
+
+int32_t ui_font_asset_get_ascent(ui_font_asset_body_t *font, size_t font_size)
+{
+	int ascent;
+
+	stbtt_GetFontVMetrics(&font->ttf_info, &ascent, NULL, NULL);
+
+	return (int32_t)(ascent * stbtt_ScaleForPixelHeight(&font->ttf_info, font_size));
+}
+
+ui_glyph_t *ui_font_asset_get_glyph(ui_font_asset_body_t *font, uint32_t utf_code, size_t font_size)
+{
+	ui_glyph_t *glyph;
+	uint32_t key;
+
+	if (!font) {
+		return NULL;
+	}
+
+	key = UI_GLYPH_HASH(font, utf_code, font_size);
+
+	for (glyph = g_glyph_cache.hash[key]; glyph; glyph = glyph->hash_next) {
+		if (glyph->font == font && glyph->utf_code == utf_code && glyph->font_size == font_size) {
+			break;
+		}
+	}
+
+	if (glyph) {
+		// Move it to the head of the LRU list
+		if (glyph != g_glyph_cache.lru_head) {
+			glyph->lru_prev->lru_next = glyph->lru_next;
+			if (glyph->lru_next) {
+				glyph->lru_next->lru_prev = glyph->lru_prev;
+			} else {
+				g_glyph_cache.lru_tail = glyph->lru_prev;
+			}
+			glyph->lru_prev = NULL;
+			glyph->lru_next = g_glyph_cache.lru_head;
+			g_glyph_cache.lru_head->lru_prev = glyph;
+			g_glyph_cache.lru_head = glyph;
+		}
+		return glyph;
+	}
+
+	glyph = _ui_glyph_rasterize(font, utf_code, font_size);
+	if (!glyph) {
+		return NULL;
+	}
+
+	glyph->hash_next = g_glyph_cache.hash[key];
+	g_glyph_cache.hash[key] = glyph;
+
+	glyph->lru_prev = NULL;
+	glyph->lru_next = g_glyph_cache.lru_head;
+	if (g_glyph_cache.lru_head) {
+		g_glyph_cache.lru_head->lru_prev = glyph;
+	} else {
+		g_glyph_cache.lru_tail = glyph;
+	}
+	g_glyph_cache.lru_head = glyph;
+
+	return glyph;
+}
+
+/**
+ * @brief Allocate a glyph with room for its bitmap, dropping the least recently used glyphs to stay in the budget.
+ */
+static ui_glyph_t *_ui_glyph_cache_alloc(size_t bitmap_size)
+{
+	ui_glyph_t *glyph;
+	size_t size = sizeof(ui_glyph_t) + bitmap_size;
+
+	if (size > CONFIG_UI_GLYPH_CACHE_SIZE) {
+		UI_LOGE("error: glyph of %u bytes does not fit in the glyph cache!\n", (uint32_t)size);
+		return NULL;
+	}
+
+	while (g_glyph_cache.used + size > CONFIG_UI_GLYPH_CACHE_SIZE) {
+		_ui_glyph_cache_remove(g_glyph_cache.lru_tail);
+	}
+
+	glyph = (ui_glyph_t *)UI_ALLOC(size);
+	if (!glyph) {
+		UI_LOGE("error: out of memory!\n");
+		return NULL;
+	}
+
+	memset(glyph, 0, sizeof(ui_glyph_t));
+	glyph->bitmap = (uint8_t *)(glyph + 1);
+	g_glyph_cache.used += size;
+
+	return glyph;
+}
+
+static void _ui_glyph_cache_remove(ui_glyph_t *glyph)
+{
+	ui_glyph_t **link;
+
+	link = &g_glyph_cache.hash[UI_GLYPH_HASH(glyph->font, glyph->utf_code, glyph->font_size)];
+	while (*link != glyph) {
+		link = &(*link)->hash_next;
+	}
+	*link = glyph->hash_next;
+
+	if (glyph->lru_prev) {
+		glyph->lru_prev->lru_next = glyph->lru_next;
+	} else {
+		g_glyph_cache.lru_head = glyph->lru_next;
+	}
+	if (glyph->lru_next) {
+		glyph->lru_next->lru_prev = glyph->lru_prev;
+	} else {
+		g_glyph_cache.lru_tail = glyph->lru_prev;
+	}
+
+	g_glyph_cache.used -= sizeof(ui_glyph_t) + glyph->width * glyph->height * ((glyph->pf == UI_PIXEL_FORMAT_A8) ? 1 : 4);
+	UI_FREE(glyph);
+}
+
+/**
+ * @brief Rasterize a glyph as an A8 coverage bitmap, or an emoji scaled to the font size.
+ */
+static ui_glyph_t *_ui_glyph_rasterize(ui_font_asset_body_t *font, uint32_t utf_code, size_t font_size)
+{
+	ui_glyph_t *glyph;
+	float scale;
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+
+#if defined(CONFIG_UI_ENABLE_EMOJI)
+	ui_bitmap_data_t *emoji;
+	const uint8_t *src;
+	uint8_t *dst;
+	int32_t x;
+	int32_t y;
+
+	if (is_emoji(utf_code)) {
+		emoji = emoji_get_bitmap(utf_code);
+		if (!emoji || emoji->pf != UI_PIXEL_FORMAT_RGBA8888) {
+			return NULL;
+		}
+
+		glyph = _ui_glyph_cache_alloc(font_size * font_size * 4);
+		if (!glyph) {
+			return NULL;
+		}
+
+		// An emoji fills a square of the font size from the top of the line
+		glyph->x = 0;
+		glyph->y = -ui_font_asset_get_ascent(font, font_size);
+		glyph->width = font_size;
+		glyph->height = font_size;
+		glyph->pf = UI_PIXEL_FORMAT_RGBA8888;
+
+		// Each pixel takes the texel under its centre, as the renderer does
+		dst = glyph->bitmap;
+		for (y = 0; y < glyph->height; y++) {
+			src = ((uint8_t *)emoji) + sizeof(ui_bitmap_data_t) +
+				((((2 * y + 1) * emoji->height) / (2 * glyph->height)) * emoji->width) * 4;
+			for (x = 0; x < glyph->width; x++) {
+				memcpy(dst, src + (((2 * x + 1) * emoji->width) / (2 * glyph->width)) * 4, 4);
+				dst += 4;
+			}
+		}
+	} else {
+#endif
+		scale = stbtt_ScaleForPixelHeight(&font->ttf_info, font_size);
+
+		// The bounding box may be offset to account for glyphs that dip above or below the line
+		stbtt_GetCodepointBitmapBox(&font->ttf_info, utf_code, scale, scale, &x1, &y1, &x2, &y2);
+
+		glyph = _ui_glyph_cache_alloc((x2 - x1) * (y2 - y1));
+		if (!glyph) {
+			return NULL;
+		}
+
+		glyph->x = x1;
+		glyph->y = y1;
+		glyph->width = x2 - x1;
+		glyph->height = y2 - y1;
+		glyph->pf = UI_PIXEL_FORMAT_A8;
+
+		stbtt_MakeCodepointBitmap(&font->ttf_info, glyph->bitmap,
+			glyph->width, glyph->height, glyph->width, scale, scale, utf_code);
+#if defined(CONFIG_UI_ENABLE_EMOJI)
+	}
+#endif
+
+	glyph->font = font;
+	glyph->utf_code = utf_code;
+	glyph->font_size = font_size;
+
+	return glyph;
+}
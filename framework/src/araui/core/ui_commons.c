@@ -77,6 +77,16 @@ bool ui_coord_inside_rect(ui_coord_t coord, ui_rect_t rect)
 	return false;
 }
 
+bool ui_rect_inside_rect(ui_rect_t inner, ui_rect_t outer)
+{
+	if ((inner.x >= outer.x) && (inner.x + inner.width <= outer.x + outer.width) &&
+		(inner.y >= outer.y) && (inner.y + inner.height <= outer.y + outer.height)) {
+		return true;
+	}
+
+	return false;
+}
+
 void ui_fread(void *ptr, size_t size, size_t n_items, FILE *stream)
 {
 	size_t ret = 0;
@@ -73,6 +73,9 @@ static ui_error_t _ui_process_widget(ui_widget_body_t *widget, uint32_t dt);
 static void _ui_call_anim_finished_cb(void *userdata);
 static void *_ui_core_thread_loop(void *param);
 static bool _ui_core_quick_panel_visible(void);
+#if defined(CONFIG_UI_PARTIAL_UPDATE)
+static bool _ui_widget_is_occluded(ui_widget_body_t *widget, ui_rect_t area);
+#endif
 
 #if defined(CONFIG_UI_ENABLE_TOUCH)
 static void _ui_core_dispatch_touch_event(void);
@@ -228,7 +231,8 @@ static ui_error_t _ui_process_widget(ui_widget_body_t *widget, uint32_t dt)
 
 		if (anim) {
 			temp = dt;
-			if (anim->func((ui_widget_t)curr_widget, (ui_anim_t)anim, &temp)) {
+			// A looped animation starts over by itself and never finishes.
+			if (anim->func((ui_widget_t)curr_widget, (ui_anim_t)anim, &temp) && !curr_widget->anim_loop) {
 				if (curr_widget->anim_finished_cb) {
 					if (ui_request_callback(_ui_call_anim_finished_cb, curr_widget) != UI_OK) {
 						UI_LOGE("Error: cannot make a request to call.anim_finished_cb!\n");
@@ -293,9 +297,11 @@ static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_are
 			if (curr_widget->render_cb) {
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
 				new_vp = ui_rect_intersect(draw_area, curr_widget->global_rect);
-				ui_dal_set_viewport(new_vp.x, new_vp.y, new_vp.width, new_vp.height);
-				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
-				ui_dal_set_viewport(draw_area.x, draw_area.y, draw_area.width, draw_area.height);
+				if (new_vp.width > 0 && new_vp.height > 0 && !_ui_widget_is_occluded(curr_widget, new_vp)) {
+					ui_dal_set_viewport(new_vp.x, new_vp.y, new_vp.width, new_vp.height);
+					curr_widget->render_cb((ui_widget_t)curr_widget, dt);
+					ui_dal_set_viewport(draw_area.x, draw_area.y, draw_area.width, draw_area.height);
+				}
 #else
 				curr_widget->render_cb((ui_widget_t)curr_widget, dt);
 #endif
@@ -310,6 +316,32 @@ static ui_error_t _ui_render_widget(ui_widget_body_t *widget, ui_rect_t draw_are
 	return UI_OK;
 }
 
+#if defined(CONFIG_UI_PARTIAL_UPDATE)
+/**
+ * @brief Check whether an opaque sibling drawn after the widget hides all of it in the area.
+ */
+static bool _ui_widget_is_occluded(ui_widget_body_t *widget, ui_rect_t area)
+{
+	ui_widget_body_t *sibling;
+	bool above = false;
+	int iter;
+
+	if (!widget->parent) {
+		return false;
+	}
+
+	vec_foreach(&widget->parent->children, sibling, iter) {
+		if (sibling == widget) {
+			above = true;
+		} else if (above && ui_widget_is_opaque(sibling) && ui_rect_inside_rect(area, sibling->global_rect)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
 static void _ui_call_anim_finished_cb(void *userdata)
 {
 	ui_widget_body_t *body;
@@ -337,6 +369,8 @@ static void _ui_redraw(uint32_t dt)
 #endif
 	ui_window_body_t *window;
 
+	ui_renderer_reset_pixel_count();
+
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
 	vec_foreach(ui_window_get_redraw_list(), redraw_rect, iter) {
 		window = ui_window_get_current();
@@ -353,6 +387,10 @@ static void _ui_redraw(uint32_t dt)
 		}
 	}
 
+	if (ui_window_get_redraw_list()->length > 0) {
+		UI_LOGD("redraw: %d areas, %u pixels\n", ui_window_get_redraw_list()->length, ui_renderer_get_pixel_count());
+	}
+
 	ui_window_redraw_list_clear();
 #else
 	redraw_rect.x = 0;
@@ -374,6 +412,8 @@ static void _ui_redraw(uint32_t dt)
 	if (window || _ui_core_quick_panel_visible()) {
 		ui_dal_redraw(redraw_rect.x, redraw_rect.y, redraw_rect.width, redraw_rect.height);
 	}
+
+	UI_LOGD("redraw: full screen, %u pixels\n", ui_renderer_get_pixel_count());
 #endif // CONFIG_UI_PARTIAL_UPDATE
 }
 
@@ -444,6 +484,7 @@ static void *_ui_core_thread_loop(void *param)
 	ui_window_body_t *window;
 	struct timespec before;
 	struct timespec now;
+	int64_t elapsed;
 	uint32_t dt;
 
 #if (CONFIG_UI_MAXIMUM_FPS > 0)
@@ -460,8 +501,15 @@ static void *_ui_core_thread_loop(void *param)
 
 		clock_gettime(CLOCK_MONOTONIC, &now);
 
-		dt = ((now.tv_sec - before.tv_sec) * 1000) + ((now.tv_nsec - before.tv_nsec) / 1000000);
-		before = now;
+		elapsed = ((int64_t)(now.tv_sec - before.tv_sec) * 1000000000) + (now.tv_nsec - before.tv_nsec);
+		dt = (uint32_t)(elapsed / 1000000);
+
+		// Only the whole milliseconds are handed to the widgets, the rest is
+		// carried over. Otherwise a frame shorter than a millisecond would
+		// stop every animation.
+		elapsed = (int64_t)before.tv_nsec + (int64_t)dt * 1000000;
+		before.tv_sec += elapsed / 1000000000;
+		before.tv_nsec = elapsed % 1000000000;
 
 #if (CONFIG_UI_MAXIMUM_FPS > 0)
 		if (dt < ms_per_frame) {
@@ -703,6 +751,29 @@ void ui_core_unlock_and_deliver_touch(ui_widget_body_t *body, ui_touch_event_t t
 	_ui_deliver_touch_event(body, touch_event, touch);
 }
 
+void ui_core_forget_touch_widget(ui_widget_body_t *widget)
+{
+	ui_window_body_t *window;
+	ui_quick_panel_body_t *quick_panel;
+	int idx;
+
+	if (g_core.locked_target == widget) {
+		g_core.locked_target = NULL;
+	}
+
+	window = ui_window_get_current();
+	if (window && window->focus == widget) {
+		window->focus = NULL;
+	}
+
+	for (idx = 0; idx < UI_QUICK_PANEL_TYPE_NUM; idx++) {
+		quick_panel = (ui_quick_panel_body_t *)g_quick_panel_info[idx];
+		if (quick_panel && quick_panel->focus == widget) {
+			quick_panel->focus = NULL;
+		}
+	}
+}
+
 #endif // CONFIG_UI_ENABLE_TOUCH
 
 ui_error_t ui_core_quick_panel_appear(ui_quick_panel_event_type_t event_type)
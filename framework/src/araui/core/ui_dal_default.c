@@ -59,6 +59,15 @@ UI_DAL ui_rect_t ui_dal_get_viewport(void)
 	return (ui_rect_t){ 0, 0, 0, 0 };
 }
 
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+
+UI_DAL ui_error_t ui_dal_get_framebuffer(ui_dal_framebuffer_t *fb)
+{
+	return UI_OPERATION_FAIL;
+}
+
+#endif // CONFIG_UI_ENABLE_DAL_FRAMEBUFFER
+
 #if defined(CONFIG_UI_ENABLE_TOUCH)
 
 UI_DAL bool ui_dal_get_touch(bool *pressed, ui_coord_t *coord)
@@ -31,15 +31,22 @@
 static vec_void_t g_window_list;
 static ui_window_body_t *g_current_window = UI_NULL;
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
+//!< Pieces of a new redraw rect waiting to be added, beyond that the rects are merged
+#define UI_REDRAW_PENDING_MAX (16)
+
 static vec_void_t g_window_redraw_list;
 static ui_rect_t g_rect_mempool[CONFIG_UI_UPDATE_MEMPOOL_SIZE];
-static int g_rect_mempool_idx = 0;
+static ui_rect_t *g_rect_free[CONFIG_UI_UPDATE_MEMPOOL_SIZE];
+static int g_rect_free_count = 0;
 #endif
 
 static void _ui_window_create_func(void *userdata);
 static void _ui_window_destroy_func(void *userdata);
 #if defined(CONFIG_UI_PARTIAL_UPDATE)
-static ui_rect_t *_ui_window_get_mempool_rect(void);
+static ui_rect_t *_ui_window_alloc_rect(void);
+static void _ui_window_free_rect(ui_rect_t *rect);
+static int32_t _ui_window_redraw_cost(ui_rect_t rect);
+static int _ui_window_split_rect(ui_rect_t rect, ui_rect_t hole, ui_rect_t *pieces);
 #endif
 
 ui_error_t ui_window_list_init(void)
@@ -66,6 +73,7 @@ ui_error_t ui_window_list_deinit(void)
 ui_error_t ui_window_redraw_list_init(void)
 {
 	vec_init(&g_window_redraw_list);
+	ui_window_redraw_list_clear();
 
 	return UI_OK;
 }
@@ -254,13 +262,33 @@ vec_void_t *ui_window_get_redraw_list(void)
 	return &g_window_redraw_list;
 }
 
+/**
+ * @brief Add an area to be redrawn in this frame.
+ *
+ * The rects in the list never overlap, or the overlapping part would be
+ * blended twice. Every rect costs a pass over the widget tree and a transfer
+ * to the display on top of its pixels, CONFIG_UI_REDRAW_RECT_COST pixels
+ * worth. So an overlapping rect is either merged into the bounding box or
+ * cut into the parts outside of the existing one, and a separate rect is
+ * merged with a close one, whichever costs less.
+ */
 ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 {
 	ui_rect_t *window;
-	ui_rect_t *new_area;
-	ui_rect_t previous;
-	ui_rect_t ret;
+	ui_rect_t *slot;
+	ui_rect_t *best;
+	ui_rect_t pending[UI_REDRAW_PENDING_MAX];
+	ui_rect_t pieces[4];
+	ui_rect_t area;
+	ui_rect_t merged;
+	ui_rect_t overlap;
+	int32_t split_cost;
+	int32_t best_cost;
+	bool grown;
+	int pending_count;
+	int count;
 	int iter;
+	int i;
 
 	if (redraw_rect.x < 0) {
 		redraw_rect.width += redraw_rect.x;
@@ -276,74 +304,161 @@ ui_error_t ui_window_add_redraw_list(ui_rect_t redraw_rect)
 		return UI_OK;
 	}
 
-	if (redraw_rect.width <= 0 || redraw_rect.height <= 0) {
-		return UI_OK;
+	if (redraw_rect.x + redraw_rect.width >= CONFIG_UI_DISPLAY_WIDTH) {
+		redraw_rect.width = CONFIG_UI_DISPLAY_WIDTH - redraw_rect.x;
 	}
-
-	new_area = _ui_window_get_mempool_rect();
-
-	new_area->x = redraw_rect.x;
-	new_area->y = redraw_rect.y;
-	new_area->width = redraw_rect.width;
-	new_area->height = redraw_rect.height;
-
-	if (new_area->x + new_area->width >= CONFIG_UI_DISPLAY_WIDTH) {
-		new_area->width = CONFIG_UI_DISPLAY_WIDTH - new_area->x;
+	if (redraw_rect.y + redraw_rect.height >= CONFIG_UI_DISPLAY_HEIGHT) {
+		redraw_rect.height = CONFIG_UI_DISPLAY_HEIGHT - redraw_rect.y;
 	}
-	if (new_area->y + new_area->height >= CONFIG_UI_DISPLAY_HEIGHT) {
-		new_area->height = CONFIG_UI_DISPLAY_HEIGHT - new_area->y;
+
+	if (redraw_rect.width <= 0 || redraw_rect.height <= 0) {
+		return UI_OK;
 	}
 
-	vec_foreach(&g_window_redraw_list, window, iter) {
-		// window is whole screen case
-		if ((window->x == 0) && (window->y == 0) &&
-			(window->width == CONFIG_UI_DISPLAY_WIDTH) &&
-			(window->height == CONFIG_UI_DISPLAY_HEIGHT)) {
-			return UI_OK;
+	pending[0] = redraw_rect;
+	pending_count = 1;
+
+	while (pending_count > 0) {
+		area = pending[--pending_count];
+		slot = NULL;
+		grown = false;
+
+restart:
+		vec_foreach(&g_window_redraw_list, window, iter) {
+			overlap = ui_rect_intersect(*window, area);
+			if (overlap.width > 0 && overlap.height > 0) {
+				if (ui_rect_inside_rect(area, *window)) {
+					// Already redrawn, which is always the case once the whole screen is
+					goto next;
+				}
+
+				merged = ui_get_contain_rect(*window, area);
+				count = _ui_window_split_rect(area, overlap, pieces);
+				split_cost = 0;
+				for (i = 0; i < count; i++) {
+					split_cost += _ui_window_redraw_cost(pieces[i]);
+				}
+
+				if (!grown && pending_count + count <= UI_REDRAW_PENDING_MAX &&
+					_ui_window_redraw_cost(merged) > _ui_window_redraw_cost(*window) + split_cost) {
+					for (i = 0; i < count; i++) {
+						pending[pending_count++] = pieces[i];
+					}
+					goto next;
+				}
+			} else {
+				merged = ui_get_contain_rect(*window, area);
+				if (_ui_window_redraw_cost(merged) > _ui_window_redraw_cost(*window) + _ui_window_redraw_cost(area)) {
+					continue;
+				}
+			}
+
+			// The merged rect may reach the rects checked before, so check them again.
+			// Cutting it up from now on could give the rects taken in back, it is only merged.
+			area = merged;
+			grown = true;
+			vec_splice(&g_window_redraw_list, iter, 1);
+			_ui_window_free_rect(slot);
+			slot = window;
+			goto restart;
 		}
 
-		previous.x = window->x;
-		previous.y = window->y;
-		previous.width = window->width;
-		previous.height = window->height;
+		if (!slot) {
+			slot = _ui_window_alloc_rect();
+		}
 
-		ret = ui_rect_intersect(previous, *new_area);
-		if (ret.x == 0 && ret.y == 0 && ret.width == 0 && ret.height == 0) {
-			continue;
+		if (!slot) {
+			// Out of rects, merge it with the one it adds the least to
+			best = NULL;
+			best_cost = 0;
+			vec_foreach(&g_window_redraw_list, window, iter) {
+				merged = ui_get_contain_rect(*window, area);
+				if (!best || _ui_window_redraw_cost(merged) - _ui_window_redraw_cost(*window) < best_cost) {
+					best = window;
+					best_cost = _ui_window_redraw_cost(merged) - _ui_window_redraw_cost(*window);
+				}
+			}
+
+			area = ui_get_contain_rect(*best, area);
+			vec_remove(&g_window_redraw_list, best);
+			slot = best;
+			grown = true;
+			goto restart;
 		}
 
-		ret = ui_get_contain_rect(previous, *new_area);
-		new_area->x = ret.x;
-		new_area->y = ret.y;
-		new_area->width = ret.width;
-		new_area->height = ret.height;
+		*slot = area;
+		vec_push(&g_window_redraw_list, slot);
+		slot = NULL;
 
-		vec_remove(&g_window_redraw_list, window);
-		iter--;
+next:
+		// A rect taken over from a merge is left when the area needs no rect of its own
+		_ui_window_free_rect(slot);
 	}
 
-	vec_push(&g_window_redraw_list, new_area);
-
 	return UI_OK;
 }
 
 ui_error_t ui_window_redraw_list_clear(void)
 {
+	int i;
+
 	vec_clear(&g_window_redraw_list);
 
+	for (i = 0; i < CONFIG_UI_UPDATE_MEMPOOL_SIZE; i++) {
+		g_rect_free[i] = &g_rect_mempool[i];
+	}
+	g_rect_free_count = CONFIG_UI_UPDATE_MEMPOOL_SIZE;
+
 	return UI_OK;
 }
 
-static ui_rect_t *_ui_window_get_mempool_rect(void)
+static ui_rect_t *_ui_window_alloc_rect(void)
+{
+	if (g_rect_free_count == 0) {
+		return NULL;
+	}
+
+	return g_rect_free[--g_rect_free_count];
+}
+
+static void _ui_window_free_rect(ui_rect_t *rect)
+{
+	if (rect) {
+		g_rect_free[g_rect_free_count++] = rect;
+	}
+}
+
+static int32_t _ui_window_redraw_cost(ui_rect_t rect)
 {
-	int alloc_idx = g_rect_mempool_idx;
+	return rect.width * rect.height + CONFIG_UI_REDRAW_RECT_COST;
+}
+
+/**
+ * @brief Cut the hole, which lies inside the rect, out of the rect.
+ *
+ * @return The number of pieces left around the hole, up to four.
+ */
+static int _ui_window_split_rect(ui_rect_t rect, ui_rect_t hole, ui_rect_t *pieces)
+{
+	int count = 0;
 
-	g_rect_mempool_idx++;
-	if (g_rect_mempool_idx >= CONFIG_UI_UPDATE_MEMPOOL_SIZE) {
-		g_rect_mempool_idx = 0;
+	// Above and below the hole, as wide as the rect
+	if (hole.y > rect.y) {
+		pieces[count++] = (ui_rect_t){ rect.x, rect.y, rect.width, hole.y - rect.y };
+	}
+	if (hole.y + hole.height < rect.y + rect.height) {
+		pieces[count++] = (ui_rect_t){ rect.x, hole.y + hole.height, rect.width, rect.y + rect.height - hole.y - hole.height };
+	}
+
+	// Left and right of the hole, as high as the hole
+	if (hole.x > rect.x) {
+		pieces[count++] = (ui_rect_t){ rect.x, hole.y, hole.x - rect.x, hole.height };
+	}
+	if (hole.x + hole.width < rect.x + rect.width) {
+		pieces[count++] = (ui_rect_t){ hole.x + hole.width, hole.y, rect.x + rect.width - hole.x - hole.width, hole.height };
 	}
 
-	return &g_rect_mempool[alloc_idx];
+	return count;
 }
 #endif // CONFIG_UI_PARTIAL_UPDATE
 
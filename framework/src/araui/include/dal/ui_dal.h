@@ -121,6 +121,33 @@ UI_DAL ui_error_t ui_dal_set_viewport(int32_t x, int32_t y, int32_t width, int32
  */
 UI_DAL ui_rect_t ui_dal_get_viewport(void);
 
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+
+/**
+ * @brief Framebuffer of the display, which the renderer writes rows of pixels to.
+ */
+typedef struct {
+	uint8_t *buf;         //!< First pixel of the top line
+	int32_t stride;       //!< Bytes from one line to the next
+	ui_pixel_format_t pf; //!< UI_PIXEL_FORMAT_RGB565 (native 16 bit words) or UI_PIXEL_FORMAT_RGB888 (r, g, b bytes)
+} ui_dal_framebuffer_t;
+
+/**
+ * @brief ui_dal_get_framebuffer()
+ *
+ * Get the framebuffer of CONFIG_UI_DISPLAY_WIDTH x CONFIG_UI_DISPLAY_HEIGHT pixels.
+ * The renderer then blends whole rows into the framebuffer, clipped to the viewport
+ * given by ui_dal_get_viewport(), instead of calling ui_dal_put_pixel_*() for each pixel.
+ *
+ * @param[out] fb Framebuffer information
+ *
+ * @return On success, UI_OK is returned. Otherwise the pixels are put one by one.
+ *
+ */
+UI_DAL ui_error_t ui_dal_get_framebuffer(ui_dal_framebuffer_t *fb);
+
+#endif // CONFIG_UI_ENABLE_DAL_FRAMEBUFFER
+
 #if defined(CONFIG_UI_ENABLE_TOUCH)
 
 /**
@@ -62,12 +62,34 @@ typedef struct {
 	uint8_t *ttf_buf;
 } ui_font_asset_body_t;
 
+/**
+ * @brief A rasterized glyph kept in the glyph cache of the font assets
+ *
+ * It stays valid until the next call of ui_font_asset_get_glyph(), which can drop it from the cache.
+ */
+typedef struct ui_glyph_s {
+	struct ui_glyph_s *hash_next; //!< Next glyph in the same hash bucket
+	struct ui_glyph_s *lru_prev;  //!< More recently used glyph
+	struct ui_glyph_s *lru_next;  //!< Less recently used glyph
+	ui_font_asset_body_t *font;
+	uint32_t utf_code;
+	size_t font_size;
+	int32_t x;                    //!< Offset of the bitmap from the pen position
+	int32_t y;                    //!< Offset of the bitmap from the baseline
+	int32_t width;
+	int32_t height;
+	ui_pixel_format_t pf;
+	uint8_t *bitmap;
+} ui_glyph_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 bool ui_asset_check_type(ui_asset_t asset, ui_asset_type_t type);
 bool ui_image_asset_has_alpha(ui_pixel_format_t format);
+int32_t ui_font_asset_get_ascent(ui_font_asset_body_t *font, size_t font_size);
+ui_glyph_t *ui_font_asset_get_glyph(ui_font_asset_body_t *font, uint32_t utf_code, size_t font_size);
 
 #ifdef __cplusplus
 }
@@ -39,6 +39,8 @@ ui_rect_t ui_get_contain_rect(ui_rect_t r1, ui_rect_t r2);
 
 bool ui_coord_inside_rect(ui_coord_t coord, ui_rect_t rect);
 
+bool ui_rect_inside_rect(ui_rect_t inner, ui_rect_t outer);
+
 void ui_fread(void *ptr, size_t size, size_t n_items, FILE *stream);
 
 #ifdef __cplusplus
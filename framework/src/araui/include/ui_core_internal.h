@@ -48,6 +48,11 @@ void ui_core_unlock_touch_event_target(void);
 
 void ui_core_unlock_and_deliver_touch(ui_widget_body_t *body,ui_touch_event_t touch_event, ui_coord_t touch);
 
+/**
+ * @brief Drops every reference of the touch handling to a widget which is about to be freed.
+ */
+void ui_core_forget_touch_widget(ui_widget_body_t *widget);
+
 #endif // CONFIG_UI_ENABLE_TOUCH
 
 #ifdef __cplusplus
@@ -19,6 +19,7 @@
 #define __UI_RENDERER_H__
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <araui/ui_commons.h>
 
 /**
@@ -76,6 +77,19 @@ void ui_renderer_scale(ui_mat3_t *mat, float x, float y);
 void ui_renderer_set_texture(uint8_t *bitmap, int32_t width, int32_t height, ui_pixel_format_t pf);
 void ui_renderer_set_fill_color(ui_color_t color);
 
+/**
+ * @brief Check whether any part of the rect transformed by trans_mat can be drawn
+ *
+ * Callers skip the geometry in the rect when it returns false, as nothing of it would reach the display.
+ */
+bool ui_renderer_is_visible(ui_mat3_t *trans_mat, ui_rect_t rect);
+
+/**
+ * @brief Number of pixels written to the display since the last reset, the cost of redrawing
+ */
+uint32_t ui_renderer_get_pixel_count(void);
+void ui_renderer_reset_pixel_count(void);
+
 /**
  * @brief Rendering geometry functions
  * 
@@ -108,6 +108,7 @@ struct ui_widget_body_s {
 	anim_finished_callback anim_finished_cb;
 
 	ui_anim_t *anim;
+	bool anim_loop;
 
 #if defined(CONFIG_UI_ENABLE_TOUCH)
 	ui_touch_info_t touch_info;
@@ -125,6 +126,12 @@ typedef struct {
 	ui_uv_t uv[4]; // top-left, bottom-left, bottom-right, top-right
 } ui_image_widget_body_t;
 
+typedef struct {
+	size_t start;  //!< Index of the first utf code of the line
+	size_t end;    //!< Index next to the last utf code of the line
+	int32_t width; //!< Width of the line in pixels
+} ui_text_line_t;
+
 typedef struct {
 	ui_widget_body_t base;
 	ui_font_asset_body_t *font;
@@ -134,6 +141,9 @@ typedef struct {
 	uint32_t *width_array;
 	size_t text_length;
 	size_t line_num;
+	ui_text_line_t *lines;  //!< Result of the layout, kept until the text, font size, word wrap or width changes
+	int32_t layout_width;   //!< Width of the widget when the lines were broken
+	int32_t ascent;
 	ui_align_t align;
 	bool word_wrap;
 } ui_text_widget_body_t;
@@ -236,6 +246,7 @@ ui_error_t ui_widget_update_position_info(ui_widget_body_t *widget);
 void ui_widget_init(ui_widget_body_t *body, int32_t width, int32_t height);
 void ui_widget_deinit(ui_widget_body_t *body);
 void ui_widget_update_global_rect(ui_widget_body_t *widget);
+bool ui_widget_is_opaque(ui_widget_body_t *widget);
 ui_error_t ui_widget_destroy_sync(ui_widget_body_t *body);
 ui_error_t ui_widget_set_position_sync(ui_widget_body_t *body, int32_t x, int32_t y);
 ui_error_t ui_widget_set_rotation_sync(ui_widget_body_t *body, int32_t degree);
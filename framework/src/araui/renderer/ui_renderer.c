@@ -19,6 +19,7 @@
 #include <tinyara/config.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <float.h>
 #include <math.h>
 #include <vec/vec.h>
@@ -34,16 +35,21 @@
 #define MAX_RENDERER_MATRIX_STACK (256)
 #define UI_TM (g_rc.tm_stack[g_rc.sp])
 
-#define UI_SUB_DIVIDE_SHIFT (4)
-#define UI_SUB_DIVIDE_SIZE (1 << UI_SUB_DIVIDE_SHIFT)
-#define UI_SUB_PIX(a) (ceilf(a) - (a))
+/* Edges and texture coordinates are walked in 16.16 fixed point */
+#define UI_FIXED_SHIFT (16)
+#define UI_FIXED_ONE (1 << UI_FIXED_SHIFT)
+#define UI_FIXED_HALF (1 << (UI_FIXED_SHIFT - 1))
+#define UI_FIXED_CEIL(a) (((a) + UI_FIXED_ONE - 1) >> UI_FIXED_SHIFT)
+#define UI_FIXED_MUL(a, b) ((int32_t)(((int64_t)(a) * (b)) >> UI_FIXED_SHIFT))
 
-#define CONFIG_UI_DEFAULT_FILL_COLOR 0x000000
+//!< Pixels sampled from a texture before they are written out at once
+#define UI_SPAN_LENGTH (CONFIG_UI_DISPLAY_WIDTH)
 
-/****************************************************************************
- * Private function declaration
- ****************************************************************************/
-static void ui_draw_triangle_segment(int32_t y1, int32_t y2);
+#define UI_CLAMP(a, min, max) ((a) < (min) ? (min) : ((a) > (max) ? (max) : (a)))
+
+#define UI_RGB565(r, g, b) ((uint16_t)((((r) & 0xf8) << 8) | (((g) & 0xfc) << 3) | ((b) >> 3)))
+
+#define CONFIG_UI_DEFAULT_FILL_COLOR 0x000000
 
 /****************************************************************************
  * Private types
@@ -52,35 +58,51 @@ typedef struct {
 	uint8_t          *texture;
 	int32_t           tex_width;
 	int32_t           tex_height;
+	int32_t           tex_bpp;    //!< Bytes per texel
 	ui_pixel_format_t tex_pf;
 	ui_color_t        fill_color;
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+	ui_dal_framebuffer_t fb;      //!< Framebuffer of the DAL, or NULL buf to put pixels one by one
+#endif
+	ui_rect_t         clip;       //!< Pixels outside of it are not drawn
+	uint32_t          pixel_count; //!< Pixels written since the last reset
 } ui_render_context_t;
 
+typedef struct {
+	int32_t x;    //!< x coordinate on the current row
+	int32_t dxdy;
+	int32_t u;    //!< Texel coordinates on the current row
+	int32_t dudy;
+	int32_t v;
+	int32_t dvdy;
+} ui_edge_t;
+
+/****************************************************************************
+ * Private function declaration
+ ****************************************************************************/
+static bool ui_renderer_begin(void);
+static void ui_draw_triangle(ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3);
+static void ui_draw_triangle_segment(int32_t y1, int32_t y2, ui_edge_t *left, ui_edge_t *right, int32_t dudx, int32_t dvdx);
+static bool ui_draw_rect(ui_mat3_t *trans_mat, ui_vec3_t *v1, ui_vec3_t *v2, ui_vec3_t *v3, ui_vec3_t *v4,
+	ui_uv_t *uv1, ui_uv_t *uv2, ui_uv_t *uv3, ui_uv_t *uv4);
+static void ui_draw_span(int32_t y, int32_t x1, int32_t x2, int32_t u, int32_t v, int32_t dudx, int32_t dvdx);
+static void ui_write_row(int32_t x, int32_t y, const uint8_t *src, int32_t count);
+
+/****************************************************************************
+ * Private data
+ ****************************************************************************/
+
 //!< Render context (global instance)
 ui_render_context_t g_rc = {
 	.texture = NULL,
 	.tex_width = 0,
 	.tex_height = 0,
+	.tex_bpp = 0,
 	.tex_pf = UI_PIXEL_FORMAT_UNKNOWN,
 	.fill_color = CONFIG_UI_DEFAULT_FILL_COLOR
 };
 
-float g_left_dxdy;
-float g_right_dxdy;
-float g_leftx;
-float g_rightx;
-float g_left_dudy;
-float g_leftu;
-float g_left_dvdy;
-float g_leftv;
-float g_left_dzdy;
-float g_leftz;
-float g_pk_dudx;
-float g_pk_dvdx;
-float g_pk_dzdx;
-float g_pk_dudx_;
-float g_pk_dvdx_;
-float g_pk_dzdx_;
+static uint8_t g_span[UI_SPAN_LENGTH * 4];
 
 /****************************************************************************
  * Public function implementation
@@ -183,6 +205,21 @@ void ui_renderer_set_texture(uint8_t *bitmap, int32_t width, int32_t height, ui_
 		g_rc.tex_height = 0;
 		g_rc.tex_pf = UI_PIXEL_FORMAT_UNKNOWN;
 	}
+
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGBA8888:
+		g_rc.tex_bpp = 4;
+		break;
+	case UI_PIXEL_FORMAT_RGB888:
+		g_rc.tex_bpp = 3;
+		break;
+	case UI_PIXEL_FORMAT_A8:
+		g_rc.tex_bpp = 1;
+		break;
+	default:
+		g_rc.tex_bpp = 0;
+		break;
+	}
 }
 
 void ui_renderer_set_fill_color(ui_color_t color)
@@ -190,41 +227,164 @@ void ui_renderer_set_fill_color(ui_color_t color)
 	g_rc.fill_color = color;
 }
 
+bool ui_renderer_is_visible(ui_mat3_t *trans_mat, ui_rect_t rect)
+{
+	ui_rect_t clip = { 0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT };
+	ui_vec3_t corner[4] = {
+		{ rect.x, rect.y, 1.0f },
+		{ rect.x + rect.width, rect.y, 1.0f },
+		{ rect.x, rect.y + rect.height, 1.0f },
+		{ rect.x + rect.width, rect.y + rect.height, 1.0f }
+	};
+	ui_vec3_t v;
+	float x1 = (float)INT32_MAX;
+	float y1 = (float)INT32_MAX;
+	float x2 = (float)INT32_MIN;
+	float y2 = (float)INT32_MIN;
+	int i;
+
+#if defined(CONFIG_UI_PARTIAL_UPDATE)
+	clip = ui_rect_intersect(ui_dal_get_viewport(), clip);
+#endif
+
+	for (i = 0; i < 4; i++) {
+		v = ui_mat3_vec3_multiply(trans_mat, &corner[i]);
+		x1 = UI_MIN(x1, v.x);
+		y1 = UI_MIN(y1, v.y);
+		x2 = UI_MAX(x2, v.x);
+		y2 = UI_MAX(y2, v.y);
+	}
+
+	return x2 > clip.x && x1 < clip.x + clip.width && y2 > clip.y && y1 < clip.y + clip.height;
+}
+
+uint32_t ui_renderer_get_pixel_count(void)
+{
+	return g_rc.pixel_count;
+}
+
+void ui_renderer_reset_pixel_count(void)
+{
+	g_rc.pixel_count = 0;
+}
+
 void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3,
 	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3)
 {
-	float u_a;
-	float v_a;
-	float z_a;
-	float u_b;
-	float v_b;
-	float z_b;
-	float u_c;
-	float v_c;
-	float z_c;
-	int32_t y1i;
-	int32_t y2i;
-	int32_t y3i;
-	float prestep;
-	float dXdY_V1V3;
-	float dXdY_V2V3;
-	float dXdY_V1V2;
-	float dUdY_V1V3;
-	float dUdY_V2V3;
-	float dUdY_V1V2;
-	float dVdY_V1V3;
-	float dVdY_V2V3;
-	float dVdY_V1V2;
-	float dZdY_V1V3;
-	float dZdY_V2V3;
-	float dZdY_V1V2;
-	float denom;
+	if (!ui_renderer_begin()) {
+		return;
+	}
 
 	v1 = ui_mat3_vec3_multiply(trans_mat, &v1);
 	v2 = ui_mat3_vec3_multiply(trans_mat, &v2);
 	v3 = ui_mat3_vec3_multiply(trans_mat, &v3);
 
+	ui_draw_triangle(v1, v2, v3, uv1, uv2, uv3);
+}
+
+void ui_render_quad_uv(ui_mat3_t *trans_mat,
+	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
+	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4)
+{
+	if (!ui_renderer_begin()) {
+		return;
+	}
+
+	// Most quads are images and glyphs which are only moved or scaled
+	if (ui_draw_rect(trans_mat, &v1, &v2, &v3, &v4, &uv1, &uv2, &uv3, &uv4)) {
+		return;
+	}
+
+	v1 = ui_mat3_vec3_multiply(trans_mat, &v1);
+	v2 = ui_mat3_vec3_multiply(trans_mat, &v2);
+	v3 = ui_mat3_vec3_multiply(trans_mat, &v3);
+	v4 = ui_mat3_vec3_multiply(trans_mat, &v4);
+
+	ui_draw_triangle(v1, v2, v3, uv1, uv2, uv3);
+	ui_draw_triangle(v1, v3, v4, uv1, uv3, uv4);
+}
+
+/****************************************************************************
+ * Private function implementation
+ ****************************************************************************/
+static inline int32_t ui_fixed(float a)
+{
+	a *= (float)UI_FIXED_ONE;
+
+	if (a >= (float)INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (a <= (float)INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t)a;
+}
+
+/**
+ * @brief Check that the texture can be drawn and find out where its pixels go.
+ */
+static bool ui_renderer_begin(void)
+{
+	ui_rect_t screen = { 0, 0, CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT };
+
+	if (!g_rc.texture || !g_rc.tex_bpp || g_rc.tex_width <= 0 || g_rc.tex_height <= 0) {
+		return false;
+	}
+
+	g_rc.clip = screen;
+
+#if defined(CONFIG_UI_PARTIAL_UPDATE)
+	// Only the area being redrawn, the rest of the screen is not sent to the display
+	g_rc.clip = ui_rect_intersect(ui_dal_get_viewport(), screen);
+#endif
+
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+	if (ui_dal_get_framebuffer(&g_rc.fb) != UI_OK ||
+		(g_rc.fb.pf != UI_PIXEL_FORMAT_RGB565 && g_rc.fb.pf != UI_PIXEL_FORMAT_RGB888)) {
+		g_rc.fb.buf = NULL;
+	} else {
+		g_rc.clip = ui_rect_intersect(ui_dal_get_viewport(), screen);
+	}
+#endif
+
+	return true;
+}
+
+static void ui_edge_setup(ui_edge_t *edge, ui_vec3_t *va, ui_vec3_t *vb,
+	float tua, float tva, float tub, float tvb, int32_t y)
+{
+	float dy = vb->y - va->y;
+	float prestep = (float)y - va->y;
+	float dxdy = (vb->x - va->x) / dy;
+	float dudy = (tub - tua) / dy;
+	float dvdy = (tvb - tva) / dy;
+
+	edge->x = ui_fixed(va->x + prestep * dxdy);
+	edge->dxdy = ui_fixed(dxdy);
+	edge->u = ui_fixed(tua + prestep * dudy);
+	edge->dudy = ui_fixed(dudy);
+	edge->v = ui_fixed(tva + prestep * dvdy);
+	edge->dvdy = ui_fixed(dvdy);
+}
+
+static void ui_draw_triangle(ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3)
+{
+	ui_edge_t major;
+	ui_edge_t minor;
+	int32_t y1i;
+	int32_t y2i;
+	int32_t y3i;
+	int32_t dudx;
+	int32_t dvdx;
+	float tu1;
+	float tv1;
+	float tu2;
+	float tv2;
+	float tu3;
+	float tv3;
+	float denom;
+
 	if (v1.y > v2.y) {
 		UI_SWAP(v1, v2);
 		UI_SWAP(uv1, uv2);
@@ -246,311 +406,415 @@ void ui_render_triangle_uv(ui_mat3_t *trans_mat,
 		return;
 	}
 
-	u_a = uv1.u;
-	u_b = uv2.u;
-	u_c = uv3.u;
-	v_a = uv1.v;
-	v_b = uv2.v;
-	v_c = uv3.v;
-	z_a = 1.0f;
-	z_b = 1.0f;
-	z_c = 1.0f;
-
-	dXdY_V1V3 = (v3.x - v1.x) / (v3.y - v1.y);
-	dXdY_V2V3 = (v3.x - v2.x) / (v3.y - v2.y);
-	dXdY_V1V2 = (v2.x - v1.x) / (v2.y - v1.y);
-
-	dUdY_V1V3 = (u_c - u_a) / (v3.y - v1.y);
-	dUdY_V2V3 = (u_c - u_b) / (v3.y - v2.y);
-	dUdY_V1V2 = (u_b - u_a) / (v2.y - v1.y);
-
-	dVdY_V1V3 = (v_c - v_a) / (v3.y - v1.y);
-	dVdY_V2V3 = (v_c - v_b) / (v3.y - v2.y);
-	dVdY_V1V2 = (v_b - v_a) / (v2.y - v1.y);
-
-	dZdY_V1V3 = (z_c - z_a) / (v3.y - v1.y);
-	dZdY_V2V3 = (z_c - z_b) / (v3.y - v2.y);
-	dZdY_V1V2 = (z_b - z_a) / (v2.y - v1.y);
-
 	denom = ((v3.x - v1.x) * (v2.y - v1.y) - (v2.x - v1.x) * (v3.y - v1.y));
-
 	if (!denom) {
 		return;
 	}
 
-	denom = 1.0f / denom;
-
-	g_pk_dudx = ((u_c - u_a) * (v2.y - v1.y) - (u_b - u_a) * (v3.y - v1.y)) * denom;
-	g_pk_dvdx = ((v_c - v_a) * (v2.y - v1.y) - (v_b - v_a) * (v3.y - v1.y)) * denom;
-	g_pk_dzdx = ((z_c - z_a) * (v2.y - v1.y) - (z_b - z_a) * (v3.y - v1.y)) * denom;
+	// Texture coordinates in texels, rounded to the nearest one when sampled
+	tu1 = uv1.u * (g_rc.tex_width - 1);
+	tv1 = uv1.v * (g_rc.tex_height - 1);
+	tu2 = uv2.u * (g_rc.tex_width - 1);
+	tv2 = uv2.v * (g_rc.tex_height - 1);
+	tu3 = uv3.u * (g_rc.tex_width - 1);
+	tv3 = uv3.v * (g_rc.tex_height - 1);
+
+	dudx = ui_fixed(((tu3 - tu1) * (v2.y - v1.y) - (tu2 - tu1) * (v3.y - v1.y)) / denom);
+	dvdx = ui_fixed(((tv3 - tv1) * (v2.y - v1.y) - (tv2 - tv1) * (v3.y - v1.y)) / denom);
+
+	// The long edge from v1 to v3 is on the left when v2 is on its right.
+	// It is set up again for each half, as the segments do not step it
+	// past their last row.
+	if (denom < 0) {
+		if (y1i < y2i) {
+			ui_edge_setup(&major, &v1, &v3, tu1, tv1, tu3, tv3, y1i);
+			ui_edge_setup(&minor, &v1, &v2, tu1, tv1, tu2, tv2, y1i);
+			ui_draw_triangle_segment(y1i, y2i, &major, &minor, dudx, dvdx);
+		}
+		if (y2i < y3i) {
+			ui_edge_setup(&major, &v1, &v3, tu1, tv1, tu3, tv3, y2i);
+			ui_edge_setup(&minor, &v2, &v3, tu2, tv2, tu3, tv3, y2i);
+			ui_draw_triangle_segment(y2i, y3i, &major, &minor, dudx, dvdx);
+		}
+	} else {
+		if (y1i < y2i) {
+			ui_edge_setup(&major, &v1, &v3, tu1, tv1, tu3, tv3, y1i);
+			ui_edge_setup(&minor, &v1, &v2, tu1, tv1, tu2, tv2, y1i);
+			ui_draw_triangle_segment(y1i, y2i, &minor, &major, dudx, dvdx);
+		}
+		if (y2i < y3i) {
+			ui_edge_setup(&major, &v1, &v3, tu1, tv1, tu3, tv3, y2i);
+			ui_edge_setup(&minor, &v2, &v3, tu2, tv2, tu3, tv3, y2i);
+			ui_draw_triangle_segment(y2i, y3i, &minor, &major, dudx, dvdx);
+		}
+	}
+}
 
-	g_pk_dudx_ = g_pk_dudx * UI_SUB_DIVIDE_SIZE;
-	g_pk_dvdx_ = g_pk_dvdx * UI_SUB_DIVIDE_SIZE;
-	g_pk_dzdx_ = g_pk_dzdx * UI_SUB_DIVIDE_SIZE;
+static void ui_draw_triangle_segment(int32_t y1, int32_t y2, ui_edge_t *left, ui_edge_t *right, int32_t dudx, int32_t dvdx)
+{
+	int32_t prestep;
+	int32_t skip;
+	int32_t x1;
+	int32_t x2;
+	int32_t y;
 
-	bool mid = dXdY_V1V3 < dXdY_V1V2;
-	if (!mid) {
-		prestep = UI_SUB_PIX(v1.y);
-		if (y1i == y2i) {
+	y2 = UI_MIN(y2, g_rc.clip.y + g_rc.clip.height);
+	if (UI_MAX(y1, g_rc.clip.y) >= y2) {
+		return;
+	}
 
-			g_left_dudy = dUdY_V2V3;
-			g_left_dvdy = dVdY_V2V3;
-			g_left_dzdy = dZdY_V2V3;
-			g_left_dxdy = dXdY_V2V3;
-			g_right_dxdy = dXdY_V1V3;
+	// Rows above the clip only move the edges along. The edges of a segment
+	// which is a single row tall can be nearly flat, so they are never stepped
+	// past its last row.
+	if (y1 < g_rc.clip.y) {
+		skip = g_rc.clip.y - y1;
+		left->x += (int32_t)((int64_t)skip * left->dxdy);
+		left->u += (int32_t)((int64_t)skip * left->dudy);
+		left->v += (int32_t)((int64_t)skip * left->dvdy);
+		right->x += (int32_t)((int64_t)skip * right->dxdy);
+		y1 += skip;
+	}
 
-			g_leftu = u_b + UI_SUB_PIX(v2.y) * g_left_dudy;
-			g_leftv = v_b + UI_SUB_PIX(v2.y) * g_left_dvdy;
-			g_leftz = z_b + UI_SUB_PIX(v2.y) * g_left_dzdy;
-			g_leftx = v2.x + UI_SUB_PIX(v2.y) * g_left_dxdy;
-			g_rightx = v1.x + prestep * g_right_dxdy;
+	for (y = y1; y < y2; y++) {
+		if (y > y1) {
+			left->x += left->dxdy;
+			left->u += left->dudy;
+			left->v += left->dvdy;
+			right->x += right->dxdy;
+		}
 
-			ui_draw_triangle_segment(y1i, y3i);
+		x1 = UI_FIXED_CEIL(left->x);
+		x2 = UI_FIXED_CEIL(right->x);
 
-			return;
+		if (x1 < x2) {
+			prestep = x1 * UI_FIXED_ONE - left->x;
+			ui_draw_span(y, x1, x2,
+				left->u + UI_FIXED_MUL(prestep, dudx) + UI_FIXED_HALF,
+				left->v + UI_FIXED_MUL(prestep, dvdx) + UI_FIXED_HALF,
+				dudx, dvdx);
 		}
+	}
+}
 
-		g_right_dxdy = dXdY_V1V3;
+/**
+ * @brief Draw a quad which stays an upright rectangle after the transform.
+ *
+ * Such a quad needs no edge walking, and when one texel covers one pixel the
+ * rows of the texture are written out as they are.
+ *
+ * @return false if the quad is rotated and has to be drawn as triangles.
+ */
+static bool ui_draw_rect(ui_mat3_t *trans_mat, ui_vec3_t *v1, ui_vec3_t *v2, ui_vec3_t *v3, ui_vec3_t *v4,
+	ui_uv_t *uv1, ui_uv_t *uv2, ui_uv_t *uv3, ui_uv_t *uv4)
+{
+	const uint8_t *row;
+	int32_t px1;
+	int32_t px2;
+	int32_t py1;
+	int32_t py2;
+	int32_t u;
+	int32_t v;
+	int32_t du;
+	int32_t dv;
+	int32_t iu;
+	int32_t y;
+	float x1;
+	float x2;
+	float y1;
+	float y2;
+	float tu1;
+	float tu2;
+	float tv1;
+	float tv2;
+
+	if (trans_mat->m[0][1] != 0.0f || trans_mat->m[1][0] != 0.0f ||
+		trans_mat->m[2][0] != 0.0f || trans_mat->m[2][1] != 0.0f || trans_mat->m[2][2] != 1.0f) {
+		return false;
+	}
 
-		if (y1i < y2i) {
+	if (v1->x != v2->x || v3->x != v4->x || v1->y != v4->y || v2->y != v3->y ||
+		v1->w != 1.0f || v3->w != 1.0f ||
+		uv1->u != uv2->u || uv3->u != uv4->u || uv1->v != uv4->v || uv2->v != uv3->v) {
+		return false;
+	}
 
-			g_left_dudy = dUdY_V1V2;
-			g_left_dvdy = dVdY_V1V2;
-			g_left_dzdy = dZdY_V1V2;
-			g_left_dxdy = dXdY_V1V2;
+	x1 = trans_mat->m[0][0] * v1->x + trans_mat->m[0][2];
+	x2 = trans_mat->m[0][0] * v3->x + trans_mat->m[0][2];
+	y1 = trans_mat->m[1][1] * v1->y + trans_mat->m[1][2];
+	y2 = trans_mat->m[1][1] * v3->y + trans_mat->m[1][2];
+	tu1 = uv1->u * g_rc.tex_width;
+	tu2 = uv3->u * g_rc.tex_width;
+	tv1 = uv1->v * g_rc.tex_height;
+	tv2 = uv3->v * g_rc.tex_height;
+
+	if (x1 > x2) {
+		UI_SWAP(x1, x2);
+		UI_SWAP(tu1, tu2);
+	}
+	if (y1 > y2) {
+		UI_SWAP(y1, y2);
+		UI_SWAP(tv1, tv2);
+	}
 
-			g_leftu = u_a + prestep * g_left_dudy;
-			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
-			g_leftx = v1.x + prestep * g_left_dxdy;
-			g_rightx = v1.x + prestep * g_right_dxdy;
+	px1 = (int32_t)ceilf(x1);
+	px2 = (int32_t)ceilf(x2);
+	py1 = (int32_t)ceilf(y1);
+	py2 = (int32_t)ceilf(y2);
 
-			ui_draw_triangle_segment(y1i, y2i);
-		}
+	// Each pixel takes the texel under its centre
+	du = ui_fixed((tu2 - tu1) / (x2 - x1));
+	dv = ui_fixed((tv2 - tv1) / (y2 - y1));
+	u = ui_fixed(tu1 + ((float)px1 + 0.5f - x1) * (tu2 - tu1) / (x2 - x1));
+	v = ui_fixed(tv1 + ((float)py1 + 0.5f - y1) * (tv2 - tv1) / (y2 - y1));
 
-		if (y2i < y3i) {
+	if (px1 < g_rc.clip.x) {
+		u += (int32_t)((int64_t)(g_rc.clip.x - px1) * du);
+		px1 = g_rc.clip.x;
+	}
+	if (py1 < g_rc.clip.y) {
+		v += (int32_t)((int64_t)(g_rc.clip.y - py1) * dv);
+		py1 = g_rc.clip.y;
+	}
+	px2 = UI_MIN(px2, g_rc.clip.x + g_rc.clip.width);
+	py2 = UI_MIN(py2, g_rc.clip.y + g_rc.clip.height);
 
-			g_left_dxdy = dXdY_V2V3;
-			g_left_dudy = dUdY_V2V3;
-			g_left_dvdy = dVdY_V2V3;
-			g_left_dzdy = dZdY_V2V3;
+	if (px1 >= px2) {
+		return true;
+	}
 
-			g_leftu = u_b + UI_SUB_PIX(v2.y) * g_left_dudy;
-			g_leftv = v_b + UI_SUB_PIX(v2.y) * g_left_dvdy;
-			g_leftz = z_b + UI_SUB_PIX(v2.y) * g_left_dzdy;
-			g_leftx = v2.x + UI_SUB_PIX(v2.y) * g_left_dxdy;
+	iu = u >> UI_FIXED_SHIFT;
 
-			ui_draw_triangle_segment(y2i, y3i);
+	for (y = py1; y < py2; y++) {
+		if (du == UI_FIXED_ONE && iu >= 0 && iu + (px2 - px1) <= g_rc.tex_width &&
+			v >= 0 && (v >> UI_FIXED_SHIFT) < g_rc.tex_height) {
+			row = g_rc.texture + ((v >> UI_FIXED_SHIFT) * g_rc.tex_width + iu) * g_rc.tex_bpp;
+			ui_write_row(px1, y, row, px2 - px1);
+		} else {
+			ui_draw_span(y, px1, px2, u, v, du, 0);
 		}
-	} else if (mid) {
-
-		prestep = UI_SUB_PIX(v1.y);
+		v += dv;
+	}
 
-		if (y1i == y2i) {
+	return true;
+}
 
-			g_left_dudy = dUdY_V1V3;
-			g_left_dvdy = dVdY_V1V3;
-			g_left_dzdy = dZdY_V1V3;
-			g_left_dxdy = dXdY_V1V3;
-			g_right_dxdy = dXdY_V2V3;
+/**
+ * @brief Sample the texture along a row and write the texels out.
+ *
+ * u and v are the texel coordinates at x1, which step by dudx and dvdx for
+ * each pixel.
+ */
+static void ui_draw_span(int32_t y, int32_t x1, int32_t x2, int32_t u, int32_t v, int32_t dudx, int32_t dvdx)
+{
+	const uint8_t *texture = g_rc.texture;
+	const uint8_t *texel;
+	uint8_t *out;
+	int32_t width = g_rc.tex_width;
+	int32_t max_u = g_rc.tex_width - 1;
+	int32_t max_v = g_rc.tex_height - 1;
+	int32_t count;
+	int32_t iu;
+	int32_t iv;
+	int32_t i;
 
-			g_leftu = u_a + prestep * g_left_dudy;
-			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
-			g_leftx = v1.x + prestep * g_left_dxdy;
-			g_rightx = v2.x + UI_SUB_PIX(v2.y) * g_right_dxdy;
+	if (y < g_rc.clip.y || y >= g_rc.clip.y + g_rc.clip.height) {
+		return;
+	}
+	if (x1 < g_rc.clip.x) {
+		u += (int32_t)((int64_t)(g_rc.clip.x - x1) * dudx);
+		v += (int32_t)((int64_t)(g_rc.clip.x - x1) * dvdx);
+		x1 = g_rc.clip.x;
+	}
+	x2 = UI_MIN(x2, g_rc.clip.x + g_rc.clip.width);
+
+	while (x1 < x2) {
+		count = UI_MIN(x2 - x1, UI_SPAN_LENGTH);
+		out = g_span;
+
+#define UI_SAMPLE(bpp) \
+		for (i = 0; i < count; i++) { \
+			iu = u >> UI_FIXED_SHIFT; \
+			iv = v >> UI_FIXED_SHIFT; \
+			iu = UI_CLAMP(iu, 0, max_u); \
+			iv = UI_CLAMP(iv, 0, max_v); \
+			texel = texture + (iv * width + iu) * (bpp); \
+			memcpy(out, texel, (bpp)); \
+			out += (bpp); \
+			u += dudx; \
+			v += dvdx; \
+		}
 
-			ui_draw_triangle_segment(y1i, y3i);
-			return;
+		switch (g_rc.tex_bpp) {
+		case 4:
+			UI_SAMPLE(4);
+			break;
+		case 3:
+			UI_SAMPLE(3);
+			break;
+		default:
+			UI_SAMPLE(1);
+			break;
 		}
+#undef UI_SAMPLE
 
-		g_left_dxdy = dXdY_V1V3;
-		g_left_dudy = dUdY_V1V3;
-		g_left_dvdy = dVdY_V1V3;
-		g_left_dzdy = dZdY_V1V3;
+		ui_write_row(x1, y, g_span, count);
+		x1 += count;
+	}
+}
 
-		if (y1i < y2i) {
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+/**
+ * @brief Blend channels spread over a word with 8 free bits above each of
+ * them, so that one multiply blends two channels at once.
+ */
+static inline uint32_t ui_blend_lanes(uint32_t src, uint32_t dst, uint32_t mask, uint32_t weight)
+{
+	return (((src * weight) + (dst * (256 - weight))) >> 8) & mask;
+}
 
-			g_right_dxdy = dXdY_V1V2;
+static inline void ui_blend_rgb888(uint8_t *dst, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+	uint32_t weight = a + (a >> 7);
+	uint32_t rb;
 
-			g_leftu = u_a + prestep * g_left_dudy;
-			g_leftv = v_a + prestep * g_left_dvdy;
-			g_leftz = z_a + prestep * g_left_dzdy;
-			g_leftx = v1.x + prestep * g_left_dxdy;
-			g_rightx = v1.x + prestep * g_right_dxdy;
+	rb = ui_blend_lanes(r | (b << 16), dst[0] | (dst[2] << 16), 0x00ff00ff, weight);
+	dst[1] = ui_blend_lanes(g << 8, dst[1] << 8, 0x0000ff00, weight) >> 8;
+	dst[0] = rb;
+	dst[2] = rb >> 16;
+}
 
-			ui_draw_triangle_segment(y1i, y2i);
-		}
+/**
+ * @brief Blend RGB565 colors with the green channel moved to the upper half
+ * of the word, so that the three channels are blended with one multiply.
+ */
+static inline uint16_t ui_blend_rgb565(uint16_t dst, uint16_t src, uint32_t a)
+{
+	uint32_t weight = (a + 4) >> 3;
+	uint32_t s = (src | ((uint32_t)src << 16)) & 0x07e0f81f;
+	uint32_t d = (dst | ((uint32_t)dst << 16)) & 0x07e0f81f;
+	uint32_t c = ((s * weight + d * (32 - weight)) >> 5) & 0x07e0f81f;
 
-		if (y2i < y3i) {
-			g_right_dxdy = dXdY_V2V3;
-			g_rightx = v2.x + UI_SUB_PIX(v2.y) * g_right_dxdy;
+	return (uint16_t)(c | (c >> 16));
+}
 
-			ui_draw_triangle_segment(y2i, y3i);
+static void ui_fb_write_rgb888(uint8_t *dst, const uint8_t *src, int32_t count)
+{
+	uint32_t r = (g_rc.fill_color & 0xff0000) >> 16;
+	uint32_t g = (g_rc.fill_color & 0x00ff00) >> 8;
+	uint32_t b = (g_rc.fill_color & 0x0000ff) >> 0;
+
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGB888:
+		memcpy(dst, src, count * 3);
+		break;
+	case UI_PIXEL_FORMAT_RGBA8888:
+		while (count--) {
+			if (src[3] == 0xff) {
+				dst[0] = src[0];
+				dst[1] = src[1];
+				dst[2] = src[2];
+			} else if (src[3]) {
+				ui_blend_rgb888(dst, src[0], src[1], src[2], src[3]);
+			}
+			src += 4;
+			dst += 3;
+		}
+		break;
+	case UI_PIXEL_FORMAT_A8:
+		while (count--) {
+			if (*src) {
+				ui_blend_rgb888(dst, r, g, b, *src);
+			}
+			src++;
+			dst += 3;
 		}
+		break;
+	default:
+		break;
 	}
 }
 
-void ui_render_quad_uv(ui_mat3_t *trans_mat,
-	ui_vec3_t v1, ui_vec3_t v2, ui_vec3_t v3, ui_vec3_t v4,
-	ui_uv_t uv1, ui_uv_t uv2, ui_uv_t uv3, ui_uv_t uv4)
+static void ui_fb_write_rgb565(uint16_t *dst, const uint8_t *src, int32_t count)
 {
-	ui_render_triangle_uv(trans_mat, v1, v2, v3, uv1, uv2, uv3);
-	ui_render_triangle_uv(trans_mat, v1, v3, v4, uv1, uv3, uv4);
+	uint16_t fill = UI_RGB565((g_rc.fill_color & 0xff0000) >> 16,
+		(g_rc.fill_color & 0x00ff00) >> 8,
+		(g_rc.fill_color & 0x0000ff) >> 0);
+
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGB888:
+		while (count--) {
+			*dst++ = UI_RGB565(src[0], src[1], src[2]);
+			src += 3;
+		}
+		break;
+	case UI_PIXEL_FORMAT_RGBA8888:
+		while (count--) {
+			if (src[3] == 0xff) {
+				*dst = UI_RGB565(src[0], src[1], src[2]);
+			} else if (src[3]) {
+				*dst = ui_blend_rgb565(*dst, UI_RGB565(src[0], src[1], src[2]), src[3]);
+			}
+			src += 4;
+			dst++;
+		}
+		break;
+	case UI_PIXEL_FORMAT_A8:
+		while (count--) {
+			if (*src) {
+				*dst = ui_blend_rgb565(*dst, fill, *src);
+			}
+			src++;
+			dst++;
+		}
+		break;
+	default:
+		break;
+	}
 }
+#endif // CONFIG_UI_ENABLE_DAL_FRAMEBUFFER
 
-/****************************************************************************
- * Private function implementation
- ****************************************************************************/
-static void ui_draw_triangle_segment(int32_t y1, int32_t y2)
+/**
+ * @brief Write a row of texels, in the format of the texture, from (x, y).
+ */
+static void ui_write_row(int32_t x, int32_t y, const uint8_t *src, int32_t count)
 {
-	float u;
-	float v;
-	float z;
-	float Z;
-	int32_t du;
-	int32_t dv;
-	int32_t width;
-	int32_t U;
-	int32_t V;
-	int32_t U1;
-	int32_t V1;
-	int32_t U2;
-	int32_t V2;
-	int32_t x1;
-	int32_t x2;
-	int32_t y;
-	int32_t x;
-	int32_t iu;
-	int32_t iv;
-	int32_t uv_offset;
-
-	for (y = y1; y < y2; y++) {
-
-		x1 = ceilf(g_leftx);
-		x2 = ceilf(g_rightx);
-
-		u = g_leftu + UI_SUB_PIX(g_leftx) * g_pk_dudx;
-		v = g_leftv + UI_SUB_PIX(g_leftx) * g_pk_dvdx;
-		z = g_leftz + UI_SUB_PIX(g_leftx) * g_pk_dzdx;
-
-		Z = 65536.0f;
-		U2 = u * Z;
-		V2 = v * Z;
-		width = x2 - x1;
-
-		while (width >= UI_SUB_DIVIDE_SIZE) {
-
-			u += g_pk_dudx_;
-			v += g_pk_dvdx_;
-			z += g_pk_dzdx_;
-
-			U1 = U2;
-			V1 = V2;
-
-			Z = 65536.0f;
-			U2 = u * Z;
-			V2 = v * Z;
-
-			du = (U2 - U1) >> UI_SUB_DIVIDE_SHIFT;
-			dv = (V2 - V1) >> UI_SUB_DIVIDE_SHIFT;
-			U = U1;
-			V = V1;
-			x = UI_SUB_DIVIDE_SIZE;
-
-			while (x--) {
-				iu = (int32_t)((U / 65536.0f) * (g_rc.tex_width - 1) + 0.5f);
-				iv = (int32_t)((V / 65536.0f) * (g_rc.tex_height - 1) + 0.5f);
-
-				if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGBA8888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 4;
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2],
-						g_rc.texture[uv_offset + 3]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGB888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 3;
-					ui_dal_put_pixel_rgb888(x1++, y, UI_COLOR_RGB888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_A8) {
-					uv_offset = ((iv * g_rc.tex_width) + iu);
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						(g_rc.fill_color & 0xff0000) >> 16,
-						(g_rc.fill_color & 0x00ff00) >> 8,
-						(g_rc.fill_color & 0x0000ff) >> 0,
-						g_rc.texture[uv_offset]
-					));
-				}
-
-				U += du;
-				V += dv;
-			}
-
-			width -= UI_SUB_DIVIDE_SIZE;
+	uint8_t r = (g_rc.fill_color & 0xff0000) >> 16;
+	uint8_t g = (g_rc.fill_color & 0x00ff00) >> 8;
+	uint8_t b = (g_rc.fill_color & 0x0000ff) >> 0;
+
+	g_rc.pixel_count += count;
+
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+	if (g_rc.fb.buf) {
+		if (g_rc.fb.pf == UI_PIXEL_FORMAT_RGB565) {
+			ui_fb_write_rgb565((uint16_t *)(g_rc.fb.buf + y * g_rc.fb.stride) + x, src, count);
+		} else {
+			ui_fb_write_rgb888(g_rc.fb.buf + y * g_rc.fb.stride + x * 3, src, count);
 		}
+		return;
+	}
+#endif
 
-		if (width > 0) {
-
-			U1 = U2;
-			V1 = V2;
-
-			u += (g_pk_dudx * width);
-			v += (g_pk_dvdx * width);
-			z += (g_pk_dzdx * width);
-
-			Z = 65536.0f;
-			U2 = u * Z;
-			V2 = v * Z;
-
-			du = (U2 - U1) / width;
-			dv = (V2 - V1) / width;
-			U = U1;
-			V = V1;
-
-			while (width--) {
-				iu = (int32_t)((U / 65536.0f) * (g_rc.tex_width - 1) + 0.5f);
-				iv = (int32_t)((V / 65536.0f) * (g_rc.tex_height - 1) + 0.5f);
-
-				if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGBA8888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 4;
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2],
-						g_rc.texture[uv_offset + 3]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_RGB888) {
-					uv_offset = ((iv * g_rc.tex_width) + iu) * 3;
-					ui_dal_put_pixel_rgb888(x1++, y, UI_COLOR_RGB888(
-						g_rc.texture[uv_offset + 0],
-						g_rc.texture[uv_offset + 1],
-						g_rc.texture[uv_offset + 2]
-					));
-				} else if (g_rc.tex_pf == UI_PIXEL_FORMAT_A8) {
-					uv_offset = ((iv * g_rc.tex_width) + iu);
-					ui_dal_put_pixel_rgba8888(x1++, y, UI_COLOR_RGBA8888(
-						(g_rc.fill_color & 0xff0000) >> 16,
-						(g_rc.fill_color & 0x00ff00) >> 8,
-						(g_rc.fill_color & 0x0000ff) >> 0,
-						g_rc.texture[uv_offset]
-					));
-				}
-
-				U += du;
-				V += dv;
-			}
+	switch (g_rc.tex_pf) {
+	case UI_PIXEL_FORMAT_RGBA8888:
+		while (count--) {
+			ui_dal_put_pixel_rgba8888(x++, y, UI_COLOR_RGBA8888(src[0], src[1], src[2], src[3]));
+			src += 4;
 		}
-
-		g_leftu += g_left_dudy;
-		g_leftv += g_left_dvdy;
-		g_leftz += g_left_dzdy;
-		g_leftx += g_left_dxdy;
-		g_rightx += g_right_dxdy;
+		break;
+	case UI_PIXEL_FORMAT_RGB888:
+		while (count--) {
+			ui_dal_put_pixel_rgb888(x++, y, UI_COLOR_RGB888(src[0], src[1], src[2]));
+			src += 3;
+		}
+		break;
+	case UI_PIXEL_FORMAT_A8:
+		while (count--) {
+			ui_dal_put_pixel_rgba8888(x++, y, UI_COLOR_RGBA8888(r, g, b, *src));
+			src++;
+		}
+		break;
+	default:
+		break;
 	}
 }
-
@@ -27,7 +27,7 @@
 
 #define UTF8_EMOJI_START (0x1f600)
 #define UTF8_EMOJI_END (0x1f644)
-#define UTF8_MAX_EMOJI_COUNT (UTF8_EMOJI_END + UTF8_EMOJI_START + 1)
+#define UTF8_MAX_EMOJI_COUNT (UTF8_EMOJI_END - UTF8_EMOJI_START + 1)
 
 #if defined(CONFIG_UI_USE_BUILTIN_EMOJI)
 static const uint8_t *g_emoji_bitmap[UTF8_MAX_EMOJI_COUNT] = {
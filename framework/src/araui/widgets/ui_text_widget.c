@@ -33,6 +33,7 @@
 #include "ui_asset_internal.h"
 #include "ui_window_internal.h"
 #include "dal/ui_dal.h"
+#include "ui_renderer.h"
 
 #if defined(CONFIG_UI_ENABLE_EMOJI)
 #include "utils/emoji.h"
@@ -64,10 +65,10 @@ typedef struct {
 } ui_set_font_size_info_t;
 
 #define CONFIG_UI_TEXT_FORMAT_MAX_LENGTH  512
-#define CONFIG_UI_GLYPH_BITMAP_WIDTH      256
-#define CONFIG_UI_GLYPH_BITMAP_HEIGHT     256
 #define CONFIG_UI_DEFAULT_FILL_COLOR      0x000000
 
+#define UI_UTF_REPLACEMENT_CHAR           0xfffd
+
 static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const char *text);
 static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt);
 static void _ui_text_widget_removed_func(ui_widget_t widget);
@@ -76,9 +77,8 @@ static void _ui_text_widget_set_align_func(void *userdata);
 static void _ui_text_widget_set_color(void *userdata);
 static void _ui_text_widget_set_word_wrap_func(void *userdata);
 static void _ui_text_widget_set_font_size_func(void *userdata);
-static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body);
-
-static uint8_t g_glyph_bitmap[CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT];
+static ui_error_t _ui_text_widget_layout(ui_text_widget_body_t *body);
+static size_t _ui_text_widget_break_lines(ui_text_widget_body_t *body, ui_text_line_t *lines);
 
 ui_widget_t ui_text_widget_create(int32_t width, int32_t height, ui_asset_t font, const char *text, size_t font_size)
 {
@@ -133,7 +133,10 @@ static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const ch
 	size_t length = 0;
 	size_t utf_idx = 0;
 	size_t str_idx = 0;
-	uint8_t b0, b1, b2;
+	size_t seq_len;
+	size_t i;
+	uint32_t code;
+	uint8_t b0;
 
 	if (!body || !text) {
 		return UI_INVALID_PARAM;
@@ -143,6 +146,7 @@ static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const ch
 	if (!length) {
 		body->utf_code = NULL;
 		body->width_array = NULL;
+		body->lines = NULL;
 		body->text_length = length;
 		body->line_num = 0;
 
@@ -160,61 +164,58 @@ static ui_error_t _ui_text_widget_text2utf(ui_text_widget_body_t *body, const ch
 		return UI_NOT_ENOUGH_MEMORY;
 	}
 
-	body->text_length = length;
-
 	// Convert char array to UTF8 code array
 	while (str_idx < length) {
-		/**
-		 * 7-bits UTF-8
-		 */
-		if ((text[str_idx] & 0x80) != 0x80) {
-			body->utf_code[utf_idx] = (uint32_t)text[str_idx];
-			str_idx++;
-
-		/**
-		 * 16-bits UTF-8 (Such as Korean, Japanese, Chinese)
-		 */
-		} else if (
-			(str_idx + 2 < length) &&
-			((text[str_idx] & 0xf0) == 0xe0) &&
-			((text[str_idx + 1] & 0xc0) == 0x80) &&
-			((text[str_idx + 2] & 0xc0) == 0x80)) {
-
-			b1 = b0 = 0;
-			b1 |= (text[str_idx] & 0x0f) << 4;
-			b1 |= (text[str_idx + 1] & 0x3c) >> 2;
-			b0 |= (text[str_idx + 1] & 0x03) << 6;
-			b0 |= (text[str_idx + 2] & 0x3f);
-
-			body->utf_code[utf_idx] = (uint16_t)(b1 << 8) + b0;
-			str_idx += 3;
-
-		/**
-		 * 21-bits UTF-8 (Such as Emoji)
-		 */
-		} else if (
-			(str_idx + 3 < length) &&
-			((text[str_idx] & 0xf8) == 0xf0) &&
-			((text[str_idx + 1] & 0xc0) == 0x80) &&
-			((text[str_idx + 2] & 0xc0) == 0x80) &&
-			((text[str_idx + 3] & 0xc0) == 0x80)) {
-
-			b2 = b1 = b0 = 0;
-			b2 |= (text[str_idx] & 0x07) << 2;
-			b2 |= (text[str_idx + 1] & 0x30) >> 4;
-			b1 |= (text[str_idx + 1] & 0x0f) << 4;
-			b1 |= (text[str_idx + 2] & 0x3c) >> 2;
-			b0 |= (text[str_idx + 2] & 0x03) << 6;
-			b0 |= (text[str_idx + 3] & 0x3f);
-
-			body->utf_code[utf_idx] = (uint32_t)(b2 << 16) + (b1 << 8) + b0;
-			str_idx += 4;
+		b0 = (uint8_t)text[str_idx];
+
+		if ((b0 & 0x80) == 0x00) {
+			// 7-bits UTF-8
+			code = b0;
+			seq_len = 1;
+		} else if ((b0 & 0xe0) == 0xc0) {
+			// 11-bits UTF-8 (Such as Latin-1 Supplement, Greek, Cyrillic)
+			code = b0 & 0x1f;
+			seq_len = 2;
+		} else if ((b0 & 0xf0) == 0xe0) {
+			// 16-bits UTF-8 (Such as Korean, Japanese, Chinese)
+			code = b0 & 0x0f;
+			seq_len = 3;
+		} else if ((b0 & 0xf8) == 0xf0) {
+			// 21-bits UTF-8 (Such as Emoji)
+			code = b0 & 0x07;
+			seq_len = 4;
+		} else {
+			code = 0;
+			seq_len = 0;
 		}
-		utf_idx++;
+
+		for (i = 1; i < seq_len; i++) {
+			if (str_idx + i >= length || (text[str_idx + i] & 0xc0) != 0x80) {
+				seq_len = 0;
+				break;
+			}
+			code = (code << 6) | (text[str_idx + i] & 0x3f);
+		}
+
+		// A broken sequence is shown as the replacement character and only its first byte is consumed
+		if (!seq_len) {
+			code = UI_UTF_REPLACEMENT_CHAR;
+			seq_len = 1;
+		}
+
+		body->utf_code[utf_idx++] = code;
+		str_idx += seq_len;
 	}
 
 	body->text_length = utf_idx;
-	_ui_text_widget_calculate_line_num(body);
+	body->lines = NULL;
+
+	if (_ui_text_widget_layout(body) != UI_OK) {
+		UI_FREE(body->utf_code);
+		UI_FREE(body->width_array);
+		body->text_length = 0;
+		return UI_NOT_ENOUGH_MEMORY;
+	}
 
 	return UI_OK;
 }
@@ -322,6 +323,7 @@ static void _ui_text_widget_set_text_func(void *userdata)
 
 	UI_FREE(body->utf_code);
 	UI_FREE(body->width_array);
+	UI_FREE(body->lines);
 
 	if (_ui_text_widget_text2utf(body, text) != UI_OK) {
 		UI_LOGE("error: out of memory!\n");
@@ -429,38 +431,19 @@ static void _ui_text_widget_set_color(void *userdata)
 static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 {
 	ui_text_widget_body_t *body;
-	float scale;
-	int ascent;
-	int i;
-	int c_x1;
-	int c_y1;
-	int c_x2;
-	int c_y2;
-	int out_w;
-	int out_h;
-	int x;
-	int y;
-	int32_t text_width;
-	size_t utf_idx = 0;
-	size_t draw_idx = 0;
-	uint8_t r = 0;
-	uint8_t g = 0;
-	uint8_t b = 0;
-	uint8_t a = 0;
+	ui_text_line_t *line;
+	ui_glyph_t *glyph;
+	size_t i;
+	size_t utf_idx;
+	int32_t x;
+	int32_t y;
+	int32_t pad;
 	ui_vec3_t v1;
 	ui_vec3_t v2;
 	ui_vec3_t v3;
 	ui_vec3_t v4;
 	ui_mat3_t text_mat;
 
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-	ui_bitmap_data_t *emoji_bitmap;
-	ui_vec3_t emoji_v1;
-	ui_vec3_t emoji_v2;
-	ui_vec3_t emoji_v3;
-	ui_vec3_t emoji_v4;
-#endif
-
 	if (!widget) {
 		UI_LOGE("error: Invalid Parameter!\n");
 		return;
@@ -473,14 +456,14 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 		return;
 	}
 
-	memset(g_glyph_bitmap, 0, CONFIG_UI_GLYPH_BITMAP_WIDTH * CONFIG_UI_GLYPH_BITMAP_HEIGHT);
-
-	scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
-
-	stbtt_GetFontVMetrics(&(body->font->ttf_info), &ascent, NULL, NULL);
-	ascent *= scale;
+	// The lines are broken again only when the widget has been resized
+	if (body->word_wrap && body->layout_width != body->base.local_rect.width) {
+		if (_ui_text_widget_layout(body) != UI_OK) {
+			UI_LOGE("error: out of memory!\n");
+			return;
+		}
+	}
 
-	x = 0;
 	y = 0;
 
 	if (body->align & UI_ALIGN_MIDDLE) {
@@ -489,138 +472,53 @@ static void _ui_text_widget_render_func(ui_widget_t widget, uint32_t dt)
 		y = (body->base.global_rect.height - ((int32_t)body->line_num * body->font_size));
 	}
 
-	for (i = 0; i < body->line_num; i++) {
-		// Calculate the width of text
-		text_width = 0;
-		while (body->utf_code[utf_idx] != '\n') {
-			text_width += body->width_array[utf_idx];
-
-			if (body->word_wrap) {
-				if (text_width > body->base.local_rect.width) {
-					// As the width of text exceeds the width of text widget,
-					// this utf code will be printed at the next line.
-					text_width -= body->width_array[utf_idx];
-					utf_idx--;
-					break;
-				}
-			}
+	// Some glyphs reach a little out of their line
+	pad = body->font_size >> 2;
 
-			if (utf_idx >= (body->text_length - 1)) {
-				break;
-			} else {
-				utf_idx++;
-			}
-		}
+	ui_renderer_set_fill_color(body->font_color);
 
-		utf_idx++;
+	for (i = 0; i < body->line_num; i++, y += body->font_size) {
+		line = &body->lines[i];
 
 		// Calculate proper x coordinate according to align
-		if (body->align & UI_ALIGN_LEFT) {
-			x = 0;
-		} else if (body->align & UI_ALIGN_CENTER) {
-			x = ((body->base.global_rect.width - text_width) >> 1);
+		x = 0;
+		if (body->align & UI_ALIGN_CENTER) {
+			x = ((body->base.global_rect.width - line->width) >> 1);
 		} else if (body->align & UI_ALIGN_RIGHT) {
-			x = (body->base.global_rect.width - text_width);
+			x = (body->base.global_rect.width - line->width);
 		}
 
-#if defined(CONFIG_UI_DISPLAY_RGB888)
-		a = ((ui_color_argb8888_t *)&(body->font_color))->a;
-		r = ((ui_color_argb8888_t *)&(body->font_color))->r;
-		g = ((ui_color_argb8888_t *)&(body->font_color))->g;
-		b = ((ui_color_argb8888_t *)&(body->font_color))->b;
-#endif
+		// A long text scrolled in a small screen has most of its lines out of sight
+		if (!ui_renderer_is_visible(&body->base.trans_mat,
+			(ui_rect_t){ x - pad, y - pad, line->width + (pad << 1), body->font_size + (pad << 1) })) {
+			continue;
+		}
 
-		while (draw_idx < utf_idx) {
-			if (body->utf_code[draw_idx] == '\n') {
-				draw_idx++;
-				continue;
-			}
+		for (utf_idx = line->start; utf_idx < line->end; utf_idx++) {
+			glyph = ui_font_asset_get_glyph(body->font, body->utf_code[utf_idx], body->font_size);
+			if (glyph && glyph->width > 0 && glyph->height > 0) {
+				ui_renderer_translate(&body->base.trans_mat, &text_mat,
+					(float)(x + glyph->x), (float)(y + body->ascent + glyph->y));
+				ui_renderer_set_texture(glyph->bitmap, glyph->width, glyph->height, glyph->pf);
 
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-			// If the code is emoji
-			if (is_emoji(body->utf_code[draw_idx])) {
-				emoji_bitmap = emoji_get_bitmap(body->utf_code[draw_idx]);
-				if (emoji_bitmap) {
-					ui_renderer_set_texture(
-						((uint8_t *)emoji_bitmap) + sizeof(ui_bitmap_data_t),
-						emoji_bitmap->width,
-						emoji_bitmap->height,
-						emoji_bitmap->pf);
-
-						emoji_v1 = (ui_vec3_t){ .x = x - body->base.global_rect.x, .y = y - body->base.global_rect.y, .w = 1.0f };
-						emoji_v2 = (ui_vec3_t){ .x = x - body->base.global_rect.x, .y = y - body->base.global_rect.y + body->font_size, .w = 1.0f };
-						emoji_v3 = (ui_vec3_t){ .x = x - body->base.global_rect.x + body->font_size, .y = y - body->base.global_rect.y + body->font_size, .w = 1.0f };
-						emoji_v4 = (ui_vec3_t){ .x = x - body->base.global_rect.x + body->font_size, .y = y - body->base.global_rect.y, .w = 1.0f };
-
-						ui_render_quad_uv(&body->base.trans_mat, emoji_v1, emoji_v2, emoji_v3, emoji_v4,
-							(ui_uv_t){ 0.0f, 0.0f },
-							(ui_uv_t){ 0.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 0.0f });
-
-						ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
-				}
-				x += body->font_size;
-			} else {
-#endif
-				/* get bounding box for character (may be offset to account for chars that dip above or below the line */
-				stbtt_GetCodepointBitmapBox(&(body->font->ttf_info), body->utf_code[draw_idx],
-					scale, scale, &c_x1, &c_y1, &c_x2, &c_y2);
-
-				out_w = c_x2 - c_x1;
-				out_h = c_y2 - c_y1;
-
-				/* render character (stride and offset is important here) */
-				stbtt_MakeCodepointBitmap(&(body->font->ttf_info), g_glyph_bitmap,
-					out_w, out_h,
-					out_w,
-					scale, scale,
-					body->utf_code[draw_idx]);
-
-				ui_renderer_translate(&body->base.trans_mat, &text_mat, (float)x, (float)(y + ascent + c_y1));
-				ui_renderer_set_texture(g_glyph_bitmap, out_w, out_h, UI_PIXEL_FORMAT_A8);
-				ui_renderer_set_fill_color(body->font_color);
-
-				v1 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = 0.0f,
-					1.0f
-				};
-				v2 = (ui_vec3_t){
-					.x = 0.0f,
-					.y = out_h,
-					1.0f
-				};
-				v3 = (ui_vec3_t){
-					.x = out_w,
-					.y = out_h,
-					1.0f
-				};
-				v4 = (ui_vec3_t){
-					.x = out_w,
-					.y = 0.0f,
-					1.0f
-				};
+				v1 = (ui_vec3_t){ 0.0f, 0.0f, 1.0f };
+				v2 = (ui_vec3_t){ 0.0f, glyph->height, 1.0f };
+				v3 = (ui_vec3_t){ glyph->width, glyph->height, 1.0f };
+				v4 = (ui_vec3_t){ glyph->width, 0.0f, 1.0f };
 
 				ui_render_quad_uv(&text_mat, v1, v2, v3, v4,
-							(ui_uv_t){ 0.0f, 0.0f },
-							(ui_uv_t){ 0.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 1.0f },
-							(ui_uv_t){ 1.0f, 0.0f });
-
-				ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
-				ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
-				memset(g_glyph_bitmap, 0, out_w * out_h);
-
-				x += body->width_array[draw_idx];
-#if defined(CONFIG_UI_ENABLE_EMOJI)
+					(ui_uv_t){ 0.0f, 0.0f },
+					(ui_uv_t){ 0.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 1.0f },
+					(ui_uv_t){ 1.0f, 0.0f });
 			}
-#endif
-			draw_idx++;
-		}
 
-		y += body->font_size;
+			x += body->width_array[utf_idx];
+		}
 	}
+
+	ui_renderer_set_texture(NULL, 0, 0, UI_PIXEL_FORMAT_UNKNOWN);
+	ui_renderer_set_fill_color(CONFIG_UI_DEFAULT_FILL_COLOR);
 }
 
 static void _ui_text_widget_removed_func(ui_widget_t widget)
@@ -636,6 +534,7 @@ static void _ui_text_widget_removed_func(ui_widget_t widget)
 
 	UI_FREE(body->utf_code);
 	UI_FREE(body->width_array);
+	UI_FREE(body->lines);
 }
 
 ui_error_t ui_text_widget_set_word_wrap(ui_widget_t widget, bool word_wrap)
@@ -690,8 +589,10 @@ static void _ui_text_widget_set_word_wrap_func(void *userdata)
 	body->word_wrap = info->word_wrap;
 
 	// According to the text wrap option, a line number of the text widget can be differ from the current one.
-	// Therefore, this value should be recalculated.
-	_ui_text_widget_calculate_line_num(body);
+	// Therefore, the lines should be broken again.
+	if (_ui_text_widget_layout(body) != UI_OK) {
+		UI_LOGE("error: out of memory!\n");
+	}
 	body->base.update_flag = true;
 
 	UI_FREE(info);
@@ -749,88 +650,137 @@ static void _ui_text_widget_set_font_size_func(void *userdata)
 	body->font_size = info->font_size;
 
 	// According to the text wrap option, a line number of the text widget can be differ from the current one.
-	// Therefore, this value should be recalculated.
-	_ui_text_widget_calculate_line_num(body);
+	// Therefore, the lines should be broken again.
+	if (_ui_text_widget_layout(body) != UI_OK) {
+		UI_LOGE("error: out of memory!\n");
+	}
 	body->base.update_flag = true;
 
 	UI_FREE(info);
 }
 
-static void _ui_text_widget_calculate_line_num(ui_text_widget_body_t *body)
+/**
+ * @brief Measure the text and break it into lines.
+ * The result is kept until the text, font size, word wrap or width of the widget changes.
+ */
+static ui_error_t _ui_text_widget_layout(ui_text_widget_body_t *body)
 {
-	size_t utf_idx = 0;
-	size_t text_width = 0;
-	size_t line_num = 1;
+	size_t utf_idx;
 	float scale;
 	int ax;
 	int kern;
 
 	if (!body) {
 		UI_LOGE("error: invalid parameter!\n");
-		return;
+		return UI_INVALID_PARAM;
+	}
+
+	UI_FREE(body->lines);
+	body->line_num = 0;
+	body->layout_width = body->base.local_rect.width;
+
+	if (!body->text_length) {
+		return UI_OK;
 	}
 
 	scale = stbtt_ScaleForPixelHeight(&(body->font->ttf_info), body->font_size);
+	body->ascent = ui_font_asset_get_ascent(body->font, body->font_size);
+
+	for (utf_idx = 0; utf_idx < body->text_length; utf_idx++) {
+		if (body->utf_code[utf_idx] == '\n') {
+			body->width_array[utf_idx] = 0;
+			continue;
+		}
 
-	if (body->word_wrap) {
-		while (utf_idx < body->text_length) {
-			if (body->utf_code[utf_idx] == '\n') {
-				line_num++;
-				text_width = 0;
-				body->width_array[utf_idx] = 0;
-			} else {
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-				if (is_emoji(body->utf_code[utf_idx])) {
-					body->width_array[utf_idx] = body->font_size;
-				} else {
-#endif
-					stbtt_GetCodepointHMetrics(&(body->font->ttf_info),  body->utf_code[utf_idx], &ax, 0);
-					body->width_array[utf_idx] = ax * scale;
-
-					if (utf_idx < body->text_length - 1) {
-						kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info), body->utf_code[utf_idx + 1],
-							stbtt_FindGlyphIndex(&(body->font->ttf_info), body->utf_code[utf_idx + 1]));
-						body->width_array[utf_idx] += kern * scale;
-					}
 #if defined(CONFIG_UI_ENABLE_EMOJI)
-				}
+		if (is_emoji(body->utf_code[utf_idx])) {
+			body->width_array[utf_idx] = body->font_size;
+			continue;
+		}
 #endif
 
-				text_width += body->width_array[utf_idx];
-				if (text_width > body->base.local_rect.width) {
-					line_num++;
-					text_width = 0;
-					continue;
-				}
-			}
-			utf_idx++;
+		stbtt_GetCodepointHMetrics(&(body->font->ttf_info), body->utf_code[utf_idx], &ax, 0);
+
+		kern = 0;
+		if (utf_idx < body->text_length - 1) {
+			kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info),
+				body->utf_code[utf_idx], body->utf_code[utf_idx + 1]);
 		}
-		body->line_num = line_num;
-	} else {
-		while (utf_idx < body->text_length) {
-			if (body->utf_code[utf_idx] == '\n') {
-				line_num++;
+
+		body->width_array[utf_idx] = (ax + kern) * scale;
+	}
+
+	body->lines = (ui_text_line_t *)UI_ALLOC(_ui_text_widget_break_lines(body, NULL) * sizeof(ui_text_line_t));
+	if (!body->lines) {
+		return UI_NOT_ENOUGH_MEMORY;
+	}
+
+	body->line_num = _ui_text_widget_break_lines(body, body->lines);
+
+	return UI_OK;
+}
+
+/**
+ * @brief Break the text at new lines and, with word wrap, at the last space fitting in the width.
+ * A word longer than the width is broken between its characters.
+ *
+ * @return The number of lines, which are stored in the lines when it is not NULL
+ */
+static size_t _ui_text_widget_break_lines(ui_text_widget_body_t *body, ui_text_line_t *lines)
+{
+	size_t line_num = 0;
+	size_t start = 0;
+	size_t utf_idx = 0;
+	size_t space_idx = 0;
+	int32_t width = 0;
+	int32_t space_width = 0;
+	bool has_space = false;
+
+	while (utf_idx < body->text_length) {
+		if (body->utf_code[utf_idx] == '\n') {
+			if (lines) {
+				lines[line_num] = (ui_text_line_t){ start, utf_idx, width };
 			}
+			line_num++;
+			start = ++utf_idx;
+			width = 0;
+			has_space = false;
+			continue;
+		}
 
-#if defined(CONFIG_UI_ENABLE_EMOJI)
-			if (is_emoji(body->utf_code[utf_idx])) {
-				body->width_array[utf_idx] = body->font_size;
-			} else {
-#endif
-				stbtt_GetCodepointHMetrics(&(body->font->ttf_info),  body->utf_code[utf_idx], &ax, 0);
-				body->width_array[utf_idx] = ax * scale;
-
-				if (utf_idx < body->text_length - 1) {
-					kern = stbtt_GetCodepointKernAdvance(&(body->font->ttf_info), body->utf_code[utf_idx + 1],
-						stbtt_FindGlyphIndex(&(body->font->ttf_info), body->utf_code[utf_idx + 1]));
-					body->width_array[utf_idx] += kern * scale;
-				}
-#if defined(CONFIG_UI_ENABLE_EMOJI)
+		// A line has one character at least, even if it is wider than the widget
+		if (body->word_wrap && utf_idx > start &&
+			width + (int32_t)body->width_array[utf_idx] > body->base.local_rect.width) {
+			if (body->utf_code[utf_idx] == ' ' || !has_space || space_idx == start) {
+				space_idx = utf_idx;
+				space_width = width;
 			}
-#endif
-			utf_idx++;
+			if (lines) {
+				lines[line_num] = (ui_text_line_t){ start, space_idx, space_width };
+			}
+			line_num++;
+
+			// The space at the break is drawn in neither of the lines
+			utf_idx = (body->utf_code[space_idx] == ' ') ? space_idx + 1 : space_idx;
+			start = utf_idx;
+			width = 0;
+			has_space = false;
+			continue;
 		}
-		body->line_num = line_num;
+
+		if (body->utf_code[utf_idx] == ' ') {
+			space_idx = utf_idx;
+			space_width = width;
+			has_space = true;
+		}
+
+		width += body->width_array[utf_idx];
+		utf_idx++;
 	}
-}
 
+	if (lines) {
+		lines[line_num] = (ui_text_line_t){ start, utf_idx, width };
+	}
+
+	return line_num + 1;
+}
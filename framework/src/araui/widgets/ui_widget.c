@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <math.h>
 #include <sys/types.h>
 #include <vec/vec.h>
 #include <araui/ui_commons.h>
@@ -91,6 +92,7 @@ typedef struct {
 	ui_widget_body_t *body;
 	ui_anim_t *anim;
 	anim_finished_callback anim_finished_cb;
+	bool loop;
 } ui_set_anim_info_t;
 
 /**
@@ -492,6 +494,12 @@ static void _ui_widget_destroy_func(void *userdata)
 
 	widget = (ui_widget_body_t *)userdata;
 
+	// Only the top of the tree is detached, the parents of the others are
+	// freed before them.
+	if (widget->parent) {
+		vec_remove(&widget->parent->children, widget);
+	}
+
 	ui_widget_queue_init();
 	ui_widget_queue_enqueue(widget);
 
@@ -506,11 +514,6 @@ static void _ui_widget_destroy_func(void *userdata)
 			widget->remove_cb((ui_widget_t)widget);
 		}
 
-		if (widget->parent) {
-			vec_remove(&widget->parent->children, widget);
-		}
-
-
 		// In the below function, An item of the widget->children will be deleted.
 		// So this while loop will be finished when the all items are deleted.
 		vec_foreach(&widget->children, child, iter) {
@@ -519,6 +522,10 @@ static void _ui_widget_destroy_func(void *userdata)
 
 		ui_widget_deinit(widget);
 
+#if defined(CONFIG_UI_ENABLE_TOUCH)
+		ui_core_forget_touch_widget(widget);
+#endif
+
 		UI_FREE(widget);
 	}
 }
@@ -896,6 +903,7 @@ ui_error_t ui_widget_play_anim(ui_widget_t widget, ui_anim_t anim, anim_finished
 	info->body = (ui_widget_body_t *)widget;
 	info->anim = (ui_anim_t *)anim;
 	info->anim_finished_cb = anim_finished_cb;
+	info->loop = loop;
 
 	if (ui_request_callback(_ui_widget_play_anim, info)) {
 		UI_FREE(info);
@@ -920,6 +928,9 @@ static void _ui_widget_play_anim(void *userdata)
 
 	body->anim_finished_cb = info->anim_finished_cb;
 	body->anim = info->anim;
+	body->anim_loop = info->loop;
+
+	UI_FREE(info);
 }
 
 void ui_widget_update_global_rect(ui_widget_body_t *widget)
@@ -935,10 +946,40 @@ void ui_widget_update_global_rect(ui_widget_body_t *widget)
 	vertex[3].x = UI_GET_TRANS_X(widget, - widget->pivot_x + widget->local_rect.width, - widget->pivot_y + widget->local_rect.height);
 	vertex[3].y = UI_GET_TRANS_Y(widget, - widget->pivot_x + widget->local_rect.width, - widget->pivot_y + widget->local_rect.height);
 
-	widget->global_rect.x = (int32_t)UI_MIN4(vertex[0].x, vertex[1].x, vertex[2].x, vertex[3].x);
-	widget->global_rect.y = (int32_t)UI_MIN4(vertex[0].y, vertex[1].y, vertex[2].y, vertex[3].y);
-	widget->global_rect.width = (int32_t)UI_MAX4(vertex[0].x, vertex[1].x, vertex[2].x, vertex[3].x) - widget->global_rect.x;
-	widget->global_rect.height = (int32_t)UI_MAX4(vertex[0].y, vertex[1].y, vertex[2].y, vertex[3].y) - widget->global_rect.y;
+	// Rounded outwards, so that it holds every pixel a rotated or scaled widget touches
+	widget->global_rect.x = (int32_t)floorf(UI_MIN4(vertex[0].x, vertex[1].x, vertex[2].x, vertex[3].x));
+	widget->global_rect.y = (int32_t)floorf(UI_MIN4(vertex[0].y, vertex[1].y, vertex[2].y, vertex[3].y));
+	widget->global_rect.width = (int32_t)ceilf(UI_MAX4(vertex[0].x, vertex[1].x, vertex[2].x, vertex[3].x)) - widget->global_rect.x;
+	widget->global_rect.height = (int32_t)ceilf(UI_MAX4(vertex[0].y, vertex[1].y, vertex[2].y, vertex[3].y)) - widget->global_rect.y;
+}
+
+/**
+ * @brief Check that the widget overwrites every pixel of its global rect.
+ *
+ * That is an image without alpha which is only moved by whole pixels, so
+ * anything drawn earlier under its global rect can be skipped.
+ */
+bool ui_widget_is_opaque(ui_widget_body_t *widget)
+{
+	ui_image_widget_body_t *body;
+	ui_mat3_t *mat;
+
+	if (!widget->visible || widget->type != UI_IMAGE_WIDGET) {
+		return false;
+	}
+
+	body = (ui_image_widget_body_t *)widget;
+	if (!body->image || body->image->pixel_format != UI_PIXEL_FORMAT_RGB888) {
+		return false;
+	}
+
+	mat = &widget->trans_mat;
+	if (mat->m[0][0] != 1.0f || mat->m[0][1] != 0.0f || mat->m[1][0] != 0.0f || mat->m[1][1] != 1.0f ||
+		mat->m[2][0] != 0.0f || mat->m[2][1] != 0.0f || mat->m[2][2] != 1.0f) {
+		return false;
+	}
+
+	return (mat->m[0][2] == (float)(int32_t)mat->m[0][2]) && (mat->m[1][2] == (float)(int32_t)mat->m[1][2]);
 }
 
 ui_error_t ui_widget_set_position_sync(ui_widget_body_t *body, int32_t x, int32_t y)
@@ -78,6 +78,11 @@ int messaging_cleanup(const char *port_name)
 		return ERROR;
 	}
 
+	/* Close the queues which this thread kept open to send to any port. They
+	 * belong to its task group, so nobody else can close them after it exits.
+	 */
+	messaging_release_handles(NULL, false);
+
 	ret = FREE_MSG_RECEIVER(port_name);
 	if (ret != OK) {
 		return ERROR;
@@ -95,6 +100,7 @@ int messaging_cleanup(const char *port_name)
 	do {
 		if ((strncmp(port_info->name, port_name, strlen(port_name) + 1) == 0) && (my_pid == port_info->pid)) {
 			cleanup_pid = port_info->pid;
+			messaging_drain_queue(port_info->mqdes);
 			mq_close(port_info->mqdes);
 			sq_rem((FAR sq_entry_t *)port_info, port_info_list_ptr);
 			MSG_FREE(port_info->data);
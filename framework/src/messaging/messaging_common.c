@@ -18,6 +18,7 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <tinyara/config.h>
 #include <debug.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -49,7 +50,7 @@ int messaging_get_version(void)
  *  FOR MSG_INFO_READ : On success, the number of receivers who waits is returned.
  *			  On failure, -1 (ERROR) is returned.
  ****************************************************************************/
-int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data_arr, int *recv_cnt)
+int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data_arr, int *epoch_arr, int *recv_cnt)
 {
 	int ret;
 	pid_t pid;
@@ -68,7 +69,7 @@ int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data
 		}
 		ret = prctl(PR_MSG_SAVE, port_name, pid, param.sched_priority);
 	} else if (type == MSG_INFO_READ) {
-		ret = prctl(PR_MSG_READ, port_name, data_arr, recv_cnt);
+		ret = prctl(PR_MSG_READ, port_name, data_arr, recv_cnt, epoch_arr);
 	} else if (type == MSG_INFO_REMOVE) {
 		ret = prctl(PR_MSG_REMOVE, port_name);
 	} else {
@@ -121,6 +122,7 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	uint32_t parsing_version;
 	int ret = OK;
 	uint32_t offset;
+	messaging_msgref_t *msgref;
 
 	my_version = messaging_get_version();
 
@@ -140,8 +142,16 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 	switch (parsing_version) {
 	case 1:
 		*sender_pid = ((messaging_packet_t *)packet)->sender_pid;
-		*msg_type = ((messaging_packet_t *)packet)->msg_type;
-		memcpy(buf, packet + offset, buflen);
+		*msg_type = ((messaging_packet_t *)packet)->msg_type & ~MSG_TYPE_REF;
+		if (((messaging_packet_t *)packet)->msg_type & MSG_TYPE_REF) {
+			msgref = (messaging_msgref_t *)(packet + offset);
+			memcpy(buf, msgref->data, msgref->datalen < (uint32_t)buflen ? msgref->datalen : buflen);
+			if (msgref->owned) {
+				MSG_FREE(msgref->data);
+			}
+		} else {
+			memcpy(buf, packet + offset, buflen);
+		}
 		ret = OK;
 		break;
 	default:
@@ -152,6 +162,44 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
 
 	return ret;
 }
+/****************************************************************************
+ * Name : messaging_drain_queue
+ *
+ * Description:
+ *  Receive the messages left in a queue which is going to be removed, and
+ *  free the large messages which were allocated for them.
+ ****************************************************************************/
+void messaging_drain_queue(mqd_t mqdes)
+{
+#ifdef MSG_USE_REF
+	struct mq_attr attr;
+	char *packet;
+	messaging_msgref_t *msgref;
+
+	if (mq_getattr(mqdes, &attr) != OK || attr.mq_curmsgs == 0) {
+		return;
+	}
+
+	packet = (char *)MSG_ALLOC(attr.mq_msgsize);
+	if (packet == NULL) {
+		return;
+	}
+
+	attr.mq_flags = O_NONBLOCK;
+	if (mq_setattr(mqdes, &attr, NULL) == OK) {
+		while (mq_receive(mqdes, packet, attr.mq_msgsize, 0) > 0) {
+			if (((messaging_packet_t *)packet)->msg_type & MSG_TYPE_REF) {
+				msgref = (messaging_msgref_t *)(packet + ((messaging_packet_t *)packet)->offset);
+				if (msgref->owned) {
+					MSG_FREE(msgref->data);
+				}
+			}
+		}
+	}
+
+	MSG_FREE(packet);
+#endif
+}
 /****************************************************************************
  * Name : messaging_set_notification
  * 
@@ -234,6 +282,7 @@ void messaging_run_callback(int signo, siginfo_t *data)
 		MSG_FREE(recv_packet);
 		if (msg_type == MSG_SEND_REPLY) {
 			/* This is only for async-reply msg. In this case, callback registration is removed after one-time use. */
+			messaging_drain_queue(recv_info->mqdes);
 			ret = mq_close(recv_info->mqdes);
 			if (ret != OK) {
 				msgdbg("[Messaging] Mq_close fail for async-reply.\n");
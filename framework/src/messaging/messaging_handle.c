@@ -0,0 +1,478 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <queue.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_internal.h"
+
+#define INVALID_PID (-1)
+
+/****************************************************************************
+ * private variables
+ ****************************************************************************/
+/* The message queues which senders keep open. mq descriptors belong to the
+ * task group which opened them, so each entry is used and closed only by its
+ * own thread. A thread closes its entries in messaging_cleanup().
+ */
+static sq_queue_t g_handle_list;
+static int g_handle_cnt;
+static sem_t g_handle_sem = SEM_INITIALIZER(1);
+static volatile pid_t g_handle_holder = INVALID_PID;
+
+/****************************************************************************
+ * private functions
+ ****************************************************************************/
+static bool messaging_handle_lock(pid_t pid)
+{
+	if (sem_trywait(&g_handle_sem) != OK) {
+		if (g_handle_holder == pid) {
+			/* A messaging callback interrupted this thread while it was using the list. */
+			return false;
+		}
+		while (sem_wait(&g_handle_sem) != OK) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+	}
+	g_handle_holder = pid;
+	return true;
+}
+
+static void messaging_handle_unlock(void)
+{
+	g_handle_holder = INVALID_PID;
+	sem_post(&g_handle_sem);
+}
+
+static char *messaging_handle_name(const char *port_name, pid_t pid, pid_t recv_pid)
+{
+	char *name;
+
+	if (recv_pid == MSG_REPLY_CHANNEL) {
+		/* Sender waits the reply with "port_name + sender_pid + _r". */
+		MSG_ASPRINTF(&name, "%s%d%s", port_name, pid, "_r");
+	} else {
+		MSG_ASPRINTF(&name, "%s%d", port_name, recv_pid);
+	}
+
+	return name;
+}
+
+static msg_handle_t *messaging_find_handle(const char *port_name, pid_t pid, pid_t recv_pid)
+{
+	msg_handle_t *handle;
+
+	handle = (msg_handle_t *)sq_peek(&g_handle_list);
+	while (handle != NULL) {
+		if (handle->pid == pid && handle->recv_pid == recv_pid && strncmp(handle->port_name, port_name, MAX_PORT_NAME_SIZE) == 0) {
+			return handle;
+		}
+		handle = (msg_handle_t *)sq_next(handle);
+	}
+
+	return NULL;
+}
+
+static void messaging_remove_handle(msg_handle_t *handle, bool close_mq)
+{
+	char *name;
+
+	sq_rem((FAR sq_entry_t *)handle, &g_handle_list);
+	g_handle_cnt--;
+
+	if (close_mq) {
+		mq_close(handle->mqdes);
+	}
+
+	if (handle->recv_pid == MSG_REPLY_CHANNEL) {
+		/* Nobody else waits on the reply channel, so it goes away with its entry. */
+		name = messaging_handle_name(handle->port_name, handle->pid, MSG_REPLY_CHANNEL);
+		if (name != NULL) {
+			mq_unlink(name);
+			MSG_FREE(name);
+		}
+	}
+
+	MSG_FREE(handle);
+}
+
+/****************************************************************************
+ * Name : messaging_reserve_handle
+ *
+ * Description:
+ *  Makes room for a new entry of this thread. The entries of the threads
+ *  which have exited are removed first, then the oldest entry of this thread
+ *  if the list is still full. The descriptors of an exited thread cannot be
+ *  closed from another thread, as they may belong to another task group.
+ *
+ * Return Value:
+ *  true if a new entry can be added.
+ ****************************************************************************/
+static bool messaging_reserve_handle(pid_t pid)
+{
+	msg_handle_t *handle;
+	msg_handle_t *next;
+	msg_handle_t *oldest = NULL;
+	struct sched_param param;
+
+	if (CONFIG_MESSAGING_HANDLE_CACHE_SIZE <= 0) {
+		return false;
+	}
+
+	handle = (msg_handle_t *)sq_peek(&g_handle_list);
+	while (handle != NULL) {
+		next = (msg_handle_t *)sq_next(handle);
+		if (handle->pid == pid) {
+			/* New entries are added first, so the last one is the oldest. */
+			oldest = handle;
+		} else if (sched_getparam(handle->pid, &param) != OK) {
+			/* The thread has exited without messaging_cleanup(). Its descriptors
+			 * stay open until its task group exits; only the entry is dropped.
+			 */
+			messaging_remove_handle(handle, false);
+		}
+		handle = next;
+	}
+
+	if (g_handle_cnt < CONFIG_MESSAGING_HANDLE_CACHE_SIZE) {
+		return true;
+	}
+
+	if (oldest != NULL) {
+		messaging_remove_handle(oldest, true);
+		return true;
+	}
+
+	return false;
+}
+
+static bool messaging_add_handle(const char *port_name, pid_t pid, pid_t recv_pid, int epoch, mqd_t mqdes, int msgsize)
+{
+	msg_handle_t *handle;
+
+	if (strlen(port_name) >= MAX_PORT_NAME_SIZE || !messaging_reserve_handle(pid)) {
+		return false;
+	}
+
+	handle = (msg_handle_t *)MSG_ALLOC(sizeof(msg_handle_t));
+	if (handle == NULL) {
+		return false;
+	}
+
+	strncpy(handle->port_name, port_name, strlen(port_name) + 1);
+	handle->pid = pid;
+	handle->recv_pid = recv_pid;
+	handle->epoch = epoch;
+	handle->mqdes = mqdes;
+	handle->msgsize = msgsize;
+	sq_addfirst((FAR sq_entry_t *)handle, &g_handle_list);
+	g_handle_cnt++;
+
+	return true;
+}
+
+/****************************************************************************
+ * Name : messaging_open_handle
+ *
+ * Description:
+ *  Opens the message queue of a receiver for sending. The queue is kept open
+ *  for the next sends of this thread while the receiver keeps it. The epoch
+ *  of the receiver changes when it opens a new queue after removing the
+ *  previous one, and the cached descriptor is reopened then.
+ *
+ * Input Parameters:
+ *  port_name : The message port name
+ *  recv_pid  : The pid of the receiver
+ *  epoch     : The epoch of the receiver, from the receiver list
+ *  msgsize   : Returns the message size of the queue, 0 if it is unknown
+ *  cached    : Returns whether the descriptor is kept in the cache
+ *
+ * Return Value:
+ *  On success, the mq descriptor is returned.; On failure, (mqd_t)ERROR is returned.
+ ****************************************************************************/
+mqd_t messaging_open_handle(const char *port_name, pid_t recv_pid, int epoch, int *msgsize, bool *cached)
+{
+	pid_t pid;
+	bool locked;
+	mqd_t mqdes;
+	char *private_portname;
+	struct mq_attr attr;
+	msg_handle_t *handle;
+
+	pid = getpid();
+	*cached = false;
+	*msgsize = 0;
+
+	locked = messaging_handle_lock(pid);
+	if (locked) {
+		handle = messaging_find_handle(port_name, pid, recv_pid);
+		if (handle != NULL) {
+			if (handle->epoch == epoch) {
+				mqdes = handle->mqdes;
+				*msgsize = handle->msgsize;
+				*cached = true;
+				messaging_handle_unlock();
+				return mqdes;
+			}
+			/* The queue was removed by the receiver. */
+			messaging_remove_handle(handle, true);
+		}
+	}
+
+	private_portname = messaging_handle_name(port_name, pid, recv_pid);
+	if (private_portname == NULL) {
+		msgdbg("[Messaging] send fail : out of memory for private portname.\n");
+		goto errout;
+	}
+
+	mqdes = mq_open(private_portname, O_WRONLY);
+	MSG_FREE(private_portname);
+	if (mqdes == (mqd_t)ERROR) {
+		if (errno == ENOENT) {
+			msgdbg("[Messaging] send fail : no receiver.\n");
+		} else {
+			msgdbg("[Messaging] send fail : open fail, errno %d.\n", errno);
+		}
+		goto errout;
+	}
+
+	if (locked && mq_getattr(mqdes, &attr) == OK) {
+		*msgsize = attr.mq_msgsize;
+		*cached = messaging_add_handle(port_name, pid, recv_pid, epoch, mqdes, attr.mq_msgsize);
+	}
+
+	if (locked) {
+		messaging_handle_unlock();
+	}
+	return mqdes;
+
+errout:
+	if (locked) {
+		messaging_handle_unlock();
+	}
+	return (mqd_t)ERROR;
+}
+
+/****************************************************************************
+ * Name : messaging_close_handle
+ *
+ * Description:
+ *  Closes the message queue which messaging_open_handle opened, unless it is
+ *  cached. If sending failed, the queue is removed as well.
+ ****************************************************************************/
+void messaging_close_handle(const char *port_name, pid_t recv_pid, mqd_t mqdes, bool cached, bool failed)
+{
+	pid_t pid;
+	char *private_portname;
+	msg_handle_t *handle;
+
+	if (cached && !failed) {
+		return;
+	}
+
+	pid = getpid();
+	if (cached) {
+		if (!messaging_handle_lock(pid)) {
+			/* The interrupted thread may be using this entry. It is not closed. */
+			return;
+		}
+		handle = messaging_find_handle(port_name, pid, recv_pid);
+		if (handle != NULL && handle->mqdes == mqdes) {
+			messaging_remove_handle(handle, false);
+		}
+		messaging_handle_unlock();
+	}
+
+	mq_close(mqdes);
+	if (failed) {
+		private_portname = messaging_handle_name(port_name, pid, recv_pid);
+		if (private_portname != NULL) {
+			mq_unlink(private_portname);
+			MSG_FREE(private_portname);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name : messaging_open_reply_channel
+ *
+ * Description:
+ *  Opens the message queue which this thread waits the sync replies on.
+ *  The queue is kept for the next sync sends of this thread to the port, as
+ *  long as their replies fit in it.
+ *
+ * Input Parameters:
+ *  port_name : The message port name
+ *  msgsize   : The size of the reply, including the header
+ *  chsize    : Returns the message size of the queue
+ *  cached    : Returns whether the queue is kept in the cache
+ *
+ * Return Value:
+ *  On success, the mq descriptor is returned.; On failure, (mqd_t)ERROR is returned.
+ ****************************************************************************/
+mqd_t messaging_open_reply_channel(const char *port_name, int msgsize, int *chsize, bool *cached)
+{
+	pid_t pid;
+	bool locked;
+	mqd_t mqdes;
+	char *sync_portname;
+	struct mq_attr attr;
+	msg_handle_t *handle;
+
+	pid = getpid();
+	*cached = false;
+
+	locked = messaging_handle_lock(pid);
+	if (locked) {
+		handle = messaging_find_handle(port_name, pid, MSG_REPLY_CHANNEL);
+		if (handle != NULL) {
+			if (handle->msgsize >= msgsize) {
+				mqdes = handle->mqdes;
+				*chsize = handle->msgsize;
+				*cached = true;
+				messaging_handle_unlock();
+				return mqdes;
+			}
+			/* The reply would not fit, so a larger queue is opened instead. */
+			messaging_remove_handle(handle, true);
+		}
+	}
+
+	sync_portname = messaging_handle_name(port_name, pid, MSG_REPLY_CHANNEL);
+	if (sync_portname == NULL) {
+		msgdbg("message send fail : sync portname allocation fail.\n");
+		goto errout;
+	}
+
+	attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	attr.mq_msgsize = msgsize;
+	attr.mq_flags = 0;
+
+	mqdes = mq_open(sync_portname, O_RDONLY | O_CREAT, 0666, &attr);
+	if (mqdes == (mqd_t)ERROR) {
+		msgdbg("message send fail : sync open fail %d.\n", errno);
+		MSG_FREE(sync_portname);
+		goto errout;
+	}
+
+	/* The queue may exist already, and then it keeps its own attributes. */
+	if (mq_getattr(mqdes, &attr) != OK) {
+		msgdbg("message send fail : sync getattr fail %d.\n", errno);
+		mq_close(mqdes);
+		mq_unlink(sync_portname);
+		MSG_FREE(sync_portname);
+		goto errout;
+	}
+	MSG_FREE(sync_portname);
+	*chsize = attr.mq_msgsize;
+
+	if (locked) {
+		*cached = messaging_add_handle(port_name, pid, MSG_REPLY_CHANNEL, 0, mqdes, attr.mq_msgsize);
+		messaging_handle_unlock();
+	}
+	return mqdes;
+
+errout:
+	if (locked) {
+		messaging_handle_unlock();
+	}
+	return (mqd_t)ERROR;
+}
+
+/****************************************************************************
+ * Name : messaging_close_reply_channel
+ *
+ * Description:
+ *  Closes and removes the reply channel, unless it is cached. A cached
+ *  channel is removed as well when the sync send failed, so that a late
+ *  reply cannot be taken for the reply of the next send.
+ ****************************************************************************/
+void messaging_close_reply_channel(const char *port_name, mqd_t mqdes, bool cached, bool failed)
+{
+	pid_t pid;
+	char *sync_portname;
+	msg_handle_t *handle;
+
+	if (cached && !failed) {
+		return;
+	}
+
+	pid = getpid();
+	if (cached) {
+		if (messaging_handle_lock(pid)) {
+			handle = messaging_find_handle(port_name, pid, MSG_REPLY_CHANNEL);
+			if (handle != NULL && handle->mqdes == mqdes) {
+				messaging_remove_handle(handle, true);
+			}
+			messaging_handle_unlock();
+		}
+		return;
+	}
+
+	mq_close(mqdes);
+	sync_portname = messaging_handle_name(port_name, pid, MSG_REPLY_CHANNEL);
+	if (sync_portname != NULL) {
+		mq_unlink(sync_portname);
+		MSG_FREE(sync_portname);
+	}
+}
+
+/****************************************************************************
+ * Name : messaging_release_handles
+ *
+ * Description:
+ *  Closes the message queues which this thread keeps open for the port, or
+ *  for every port if port_name is NULL. If reply_only is set, only the reply
+ *  channels are closed.
+ ****************************************************************************/
+void messaging_release_handles(const char *port_name, bool reply_only)
+{
+	pid_t pid;
+	msg_handle_t *handle;
+	msg_handle_t *next;
+
+	pid = getpid();
+	if (!messaging_handle_lock(pid)) {
+		return;
+	}
+
+	handle = (msg_handle_t *)sq_peek(&g_handle_list);
+	while (handle != NULL) {
+		next = (msg_handle_t *)sq_next(handle);
+		if (handle->pid == pid && (!reply_only || handle->recv_pid == MSG_REPLY_CHANNEL) && (port_name == NULL || strncmp(handle->port_name, port_name, MAX_PORT_NAME_SIZE) == 0)) {
+			messaging_remove_handle(handle, true);
+		}
+		handle = next;
+	}
+
+	messaging_handle_unlock();
+}
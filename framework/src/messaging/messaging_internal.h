@@ -17,6 +17,7 @@
  ****************************************************************************/
 #include <tinyara/compiler.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <queue.h>
@@ -46,6 +47,28 @@ struct messaging_packet_s {
 typedef struct messaging_packet_s messaging_packet_t;
 #define MSG_HEADER_SIZE (sizeof(messaging_packet_t) - sizeof(char *)) /* Messaging Version 1 */
 
+/* The message of a packet which has MSG_TYPE_REF in its msg_type is a messaging_msgref_t. */
+#define MSG_TYPE_REF 0x80000000
+
+/**
+ * @brief The reference to a message which is not copied through the message queue.
+ * @details If owned is set, data was allocated for this packet and the receiver frees it.
+ * Otherwise data is the buffer of a sync sender, which waits for the reply.
+ */
+struct messaging_msgref_s {
+	char *data;
+	uint32_t datalen;
+	uint32_t owned;
+};
+typedef struct messaging_msgref_s messaging_msgref_t;
+
+#if defined(CONFIG_MESSAGING_LARGE_MSG_SIZE) && CONFIG_MESSAGING_LARGE_MSG_SIZE > 0
+#define MSG_USE_REF
+#define MSG_SEND_BY_REF(msglen) ((msglen) >= CONFIG_MESSAGING_LARGE_MSG_SIZE && (msglen) >= (int)sizeof(messaging_msgref_t))
+#else
+#define MSG_SEND_BY_REF(msglen) false
+#endif
+
 #define MAX_PORT_NAME_SIZE 64
 
 /**
@@ -62,9 +85,9 @@ enum msg_info_type_e {
 };
 typedef enum msg_info_type_e msg_info_type_t;
 
-#define SAVE_MSG_RECEIVER(port_name)  messaging_handle_data(MSG_INFO_SAVE, port_name, NULL, NULL)
-#define READ_MSG_RECEIVER(port_name, recv_arr, recv_cnt)  messaging_handle_data(MSG_INFO_READ, port_name, recv_arr, &recv_cnt)
-#define FREE_MSG_RECEIVER(port_name)  messaging_handle_data(MSG_INFO_REMOVE, port_name, NULL, NULL)
+#define SAVE_MSG_RECEIVER(port_name)  messaging_handle_data(MSG_INFO_SAVE, port_name, NULL, NULL, NULL)
+#define READ_MSG_RECEIVER(port_name, recv_arr, epoch_arr, recv_cnt)  messaging_handle_data(MSG_INFO_READ, port_name, recv_arr, epoch_arr, &recv_cnt)
+#define FREE_MSG_RECEIVER(port_name)  messaging_handle_data(MSG_INFO_REMOVE, port_name, NULL, NULL, NULL)
 
 /**
  * @brief The type of sending message
@@ -106,6 +129,22 @@ struct msg_port_info_s {
 };
 typedef struct msg_port_info_s msg_port_info_t;
 
+/**
+ * @brief The internal structure for a message queue which is kept open by a sender.
+ * @details recv_pid is MSG_REPLY_CHANNEL for the queue which the sender waits the sync replies on.
+ */
+struct msg_handle_s {
+	struct msg_handle_s *flink;
+	char port_name[MAX_PORT_NAME_SIZE];
+	pid_t pid;
+	pid_t recv_pid;
+	int epoch;
+	mqd_t mqdes;
+	int msgsize;
+};
+typedef struct msg_handle_s msg_handle_t;
+#define MSG_REPLY_CHANNEL (-1)
+
 /**
  * @brief Internal function for setting callback function to the messaging signal.
  */
@@ -117,7 +156,7 @@ int messaging_set_notification(int signo, msg_recv_info_t *data);
 /**
  * @brief Internal function for save/read the message information when sending and receiving the message.
  */
-int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data_arr, int *recv_cnt);
+int messaging_handle_data(msg_info_type_t type, const char *port_name, int *data_arr, int *epoch_arr, int *recv_cnt);
 /**
  * @brief Internal function for unicast and multicast send APIs.
  */
@@ -125,7 +164,27 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 /**
  * @brief Internal function for sending message packet which has header and message.
  */
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info);
+int messaging_send_packet(mqd_t mqdes, int msgsize, msg_send_type_t msg_type, msg_send_data_t *send_data, bool borrow);
+/**
+ * @brief Internal function for opening the message queue of a receiver, from the cache if possible.
+ */
+mqd_t messaging_open_handle(const char *port_name, pid_t recv_pid, int epoch, int *msgsize, bool *cached);
+/**
+ * @brief Internal function for closing the message queue which messaging_open_handle opened.
+ */
+void messaging_close_handle(const char *port_name, pid_t recv_pid, mqd_t mqdes, bool cached, bool failed);
+/**
+ * @brief Internal function for opening the queue which a sync sender waits the reply on.
+ */
+mqd_t messaging_open_reply_channel(const char *port_name, int msgsize, int *chsize, bool *cached);
+/**
+ * @brief Internal function for closing the queue which messaging_open_reply_channel opened.
+ */
+void messaging_close_reply_channel(const char *port_name, mqd_t mqdes, bool cached, bool failed);
+/**
+ * @brief Internal function for closing the queues which this thread keeps open for the port, or for every port if port_name is NULL.
+ */
+void messaging_release_handles(const char *port_name, bool reply_only);
 /**
  * @brief Internal function for receiving APIs.
  */
@@ -138,6 +197,10 @@ void messaging_run_callback(int signo, siginfo_t *data);
  * @brief Internal function for parsing received packet
  */
 int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pid, int *msg_type);
+/**
+ * @brief Internal function for dropping the messages left in a queue which is going to be removed.
+ */
+void messaging_drain_queue(mqd_t mqdes);
 /**
  * @brief Internal function for getting g_port_info_list
  */
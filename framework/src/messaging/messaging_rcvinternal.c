@@ -87,7 +87,6 @@ static int messaging_rcv_nonblock(mqd_t mqdes, const char *port_name, msg_recv_b
 				MSG_FREE(recv_packet);
 				goto errout_with_mq;
 			}
-			recv_buf->buflen = recv_size_chk;
 			(*cb_info->cb_func)(msg_type, recv_buf, cb_info->cb_data);
 		} else if (recv_size_chk == ERROR && errno == EAGAIN) {
 			msgdbg("[Messaging] recv : empty queue, but NONBLOCK mode.\n");
@@ -196,6 +195,10 @@ static int messaging_rcv_block(mqd_t mqdes, const char *port_name, msg_recv_buf_
 
 cleanup_return:
 	MSG_FREE(recv_packet);
+
+	/* Stop being a receiver before removing the queue, then drop what was sent meanwhile. */
+	(void)FREE_MSG_RECEIVER(port_name);
+	messaging_drain_queue(mqdes);
 	mq_close(mqdes);
 	MSG_ASPRINTF(&internal_portname, "%s%d", port_name, getpid());
 	mq_unlink(internal_portname);
@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -50,6 +51,9 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
 		return ERROR;
 	}
 
+	/* The async reply is waited on the same queue name as the sync replies, and the queue is removed after it. */
+	messaging_release_handles(port_name, true);
+
 	recv_size = MSG_HEADER_SIZE + recv_data->buflen;
 
 	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
@@ -93,49 +97,54 @@ static int messaging_set_async_callback(const char *port_name, msg_recv_buf_t *r
  * Name : messaging_send_packet
  * 
  * Description:
- *  This function calls receive function based on receive type.
+ *  This function sends the message with the packet header to the queue.
+ *  A message of CONFIG_MESSAGING_LARGE_MSG_SIZE bytes or more is not copied
+ *  into the queue. Only a reference to it is, and the receiver copies it.
+ *  The reference is to a heap copy, or to the caller's buffer if borrow is
+ *  set.
  *
  * Input Parameters:
- *  port_name : The message port name to send
- *  msg       : The message to be sent
- *  msglen    : The length of message to be sent
- *  priority  : A non-negative integer that specifies the priority of this message
+ *  mqdes     : The message queue to send
+ *  msgsize   : The message size of the queue, 0 if it is unknown
+ *  msg_type  : The type of sending message
+ *  send_data : The message to be sent, its length and priority
+ *  borrow    : The caller keeps its buffer until the receiver replies
  * 
  * Return Value:
  *  On success, 0 (OK) is returned.; On failure, -1 (ERROR) is returned.
  ****************************************************************************/
-int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_send_data_t *send_data, msg_callback_info_t *cb_info)
+int messaging_send_packet(mqd_t mqdes, int msgsize, msg_send_type_t msg_type, msg_send_data_t *send_data, bool borrow)
 {
 	int ret = OK;
-	mqd_t mqdes;
-	struct mq_attr internal_attr;
 	char *send_packet;
 	int send_size;
 	uint32_t send_type;
 	uint32_t msg_offset;
 	uint32_t msg_version;
+	struct mq_attr attr;
+	messaging_msgref_t *msgref = NULL;
 
-	send_size = MSG_HEADER_SIZE + send_data->msglen;
-
-	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
-	internal_attr.mq_msgsize = send_size;
-	internal_attr.mq_flags = 0;
-
-	mqdes = mq_open(port_name, O_WRONLY, 0666, &internal_attr);
-	if (mqdes == (mqd_t)ERROR) {
-		if (errno == ENOENT) {
-			msgdbg("[Messagmemcpying] send fail : no receiver.\n");
-		} else {
-			msgdbg("[Messaging] send fail : open fail, errno %d.\n", errno);
+	if (MSG_SEND_BY_REF(send_data->msglen)) {
+		/* Only the reference is queued, but the receiver still needs room for the message. */
+		if (msgsize <= 0) {
+			if (mq_getattr(mqdes, &attr) != OK) {
+				msgdbg("[Messaging] send fail : getattr fail, errno %d.\n", errno);
+				return ERROR;
+			}
+			msgsize = attr.mq_msgsize;
 		}
-		return ERROR;
+		if ((int)MSG_HEADER_SIZE + send_data->msglen > msgsize) {
+			msgdbg("[Messaging] send fail : message is larger than the receive buffer.\n");
+			return ERROR;
+		}
+		send_size = MSG_HEADER_SIZE + sizeof(messaging_msgref_t);
+	} else {
+		send_size = MSG_HEADER_SIZE + send_data->msglen;
 	}
 
 	send_packet = (char *)MSG_ALLOC(send_size);
 	if (send_packet == NULL) {
 		msgdbg("[Messaging] send fail : out of memory for including header.\n");
-		mq_close(mqdes);
-		mq_unlink(port_name);
 		return ERROR;
 	}
 
@@ -143,6 +152,7 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	 * +--------------------------------------------------------------------------------------------------------+
 	 * | version(4bytes) | msg_offset(4bytes) | sender_pid(4bytes) | msg type(4bytes) | message(Max 65515bytes) |
 	 * +--------------------------------------------------------------------------------------------------------+
+	 * If msg type has MSG_TYPE_REF, the message is a messaging_msgref_t.
 	 */
 
 	/* Add data header for message version and msg offset. */
@@ -162,22 +172,42 @@ int messaging_send_packet(const char *port_name, msg_send_type_t msg_type, msg_s
 	} else {
 		send_type = MSG_REPLY_REQUIRED;
 	}
-	((messaging_packet_t *)send_packet)->msg_type = send_type;
 
-	/* Copy the real send message. */
-	memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	if (MSG_SEND_BY_REF(send_data->msglen)) {
+		msgref = (messaging_msgref_t *)(send_packet + msg_offset);
+		msgref->datalen = send_data->msglen;
+		if (borrow) {
+			/* The sender waits for the reply, so the receiver copies from the sender's buffer. */
+			msgref->data = send_data->msg;
+			msgref->owned = 0;
+		} else {
+			msgref->data = (char *)MSG_ALLOC(send_data->msglen);
+			if (msgref->data == NULL) {
+				msgdbg("[Messaging] send fail : out of memory for large message.\n");
+				MSG_FREE(send_packet);
+				return ERROR;
+			}
+			memcpy(msgref->data, send_data->msg, send_data->msglen);
+			msgref->owned = 1;
+		}
+		send_type |= MSG_TYPE_REF;
+	} else {
+		/* Copy the real send message. */
+		memcpy(send_packet + msg_offset, send_data->msg, send_data->msglen);
+	}
+	((messaging_packet_t *)send_packet)->msg_type = send_type;
 
 	ret = mq_send(mqdes, (char *)send_packet, send_size, send_data->priority);
 	if (ret != OK) {
 		msgdbg("[Messaging] send fail : errno %d.\n", errno);
+		if (msgref != NULL && msgref->owned) {
+			MSG_FREE(msgref->data);
+		}
 		MSG_FREE(send_packet);
-		mq_close(mqdes);
-		mq_unlink(port_name);
 		return ERROR;
 	}
 
 	MSG_FREE(send_packet);
-	mq_close(mqdes);
 	return ret;
 }
 
@@ -210,13 +240,18 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 	int ret = ERROR;
 	int read_status = MSG_READ_YET;
 	int recv_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
-	char *private_portname;
+	int epoch_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
 	int recv_cnt;
+	int sent = 0;
+	bool borrow;
+	mqd_t mqdes;
+	int msgsize;
+	bool cached;
 
 	/* Check that how many receivers are waiting. */
 	while (read_status != MSG_READ_ALL) {
 		(void)messaging_init_recv_arr(recv_arr);
-		read_status = READ_MSG_RECEIVER(port_name, recv_arr, recv_cnt);
+		read_status = READ_MSG_RECEIVER(port_name, recv_arr, epoch_arr, recv_cnt);
 		if (read_status == ERROR) {
 			return ERROR;
 		}
@@ -231,24 +266,24 @@ int messaging_send_internal(const char *port_name, msg_send_type_t msg_type, msg
 			if (recv_arr[recv_idx] == MSG_RECV_NOT_INIT) {
 				continue;
 			}
-			MSG_ASPRINTF(&private_portname, "%s%d", port_name, recv_arr[recv_idx]);
-			if (private_portname == NULL) {
-				msgdbg("[Messaging] send fail : out of memory for private portname.\n");
-				return ERROR;
-			}
-			if (msg_type == MSG_SEND_ASYNC) {
-				if (recv_cnt == 1) {
-					ret = messaging_set_async_callback(port_name, recv_data, cb_info);
-					if (ret != OK) {
-						MSG_FREE(private_portname);
-						return ERROR;
-					}
+			if (msg_type == MSG_SEND_ASYNC && recv_cnt == 1) {
+				ret = messaging_set_async_callback(port_name, recv_data, cb_info);
+				if (ret != OK) {
+					return ERROR;
 				}
-				ret = messaging_send_packet(private_portname, msg_type, send_data, cb_info);
-			} else {
-				ret = messaging_send_packet(private_portname, msg_type, send_data, NULL);
 			}
-			MSG_FREE(private_portname);
+			mqdes = messaging_open_handle(port_name, recv_arr[recv_idx], epoch_arr[recv_idx], &msgsize, &cached);
+			if (mqdes == (mqd_t)ERROR) {
+				return ERROR;
+			}
+			/* The buffer may be lent only to the one receiver whose reply is
+			 * waited for. If sending to another one failed, the caller could
+			 * reuse the buffer while a receiver still copies from it.
+			 */
+			borrow = (msg_type == MSG_SEND_SYNC && recv_cnt == 1 && read_status == MSG_READ_ALL && sent == 0);
+			ret = messaging_send_packet(mqdes, msgsize, msg_type, send_data, borrow);
+			messaging_close_handle(port_name, recv_arr[recv_idx], mqdes, cached, ret != OK);
+			sent++;
 		}
 	}
 	if (ret == OK) {
@@ -23,6 +23,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -47,44 +48,23 @@ static int messaging_send_param_validation(const char *port_name, msg_send_data_
 
 	return OK;
 }
-static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
+static int messaging_sync_recv(mqd_t sync_mqdes, int chsize, msg_recv_buf_t *reply_buf)
 {
 	int ret = OK;
-	mqd_t sync_mqdes;
-	char *sync_portname;
-	struct mq_attr internal_attr;
 	char *reply_data;
-	int reply_size;
 	int msg_type;
 
-	reply_size = reply_buf->buflen + MSG_HEADER_SIZE;
-
-	internal_attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
-	internal_attr.mq_msgsize = reply_size;
-	internal_attr.mq_flags = 0;
-
-	/* sender waits the reply with "port_name + sender_pid + _r". */
-	MSG_ASPRINTF(&sync_portname, "%s%d%s", port_name, getpid(), "_r");
-	if (sync_portname == NULL) {
-		msgdbg("message send fail : sync portname allocation fail.\n");
-		return ERROR;
-	}
-	sync_mqdes = mq_open(sync_portname, O_RDONLY | O_CREAT, 0666, &internal_attr);
-	if (sync_mqdes == (mqd_t)ERROR) {
-		msgdbg("message send fail : sync open fail %d.\n", errno);
-		MSG_FREE(sync_portname);
-		return ERROR;
-	}
-
-	reply_data = (char *)MSG_ALLOC(reply_size);
+	/* The reply channel may be larger than the reply, and mq_receive needs room for its message size. */
+	reply_data = (char *)MSG_ALLOC(chsize);
 	if (reply_data == NULL) {
 		msgdbg("message send fail : out of memory for including header\n");
-		mq_close(sync_mqdes);
-		mq_unlink(sync_portname);
 		return ERROR;
 	}
 
-	ret = mq_receive(sync_mqdes, reply_data, reply_size, 0);
+	do {
+		ret = mq_receive(sync_mqdes, reply_data, chsize, 0);
+	} while (ret < 0 && errno == EINTR);
+
 	if (ret < 0) {
 		msgdbg("message send fail : sync recv fail %d.\n", errno);
 		ret = ERROR;
@@ -95,10 +75,7 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 		}
 	}
 
-	mq_close(sync_mqdes);
-	mq_unlink(sync_portname);
 	MSG_FREE(reply_data);
-	MSG_FREE(sync_portname);
 
 	return ret;
 }
@@ -112,6 +89,9 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 int messaging_send_sync(const char *port_name, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf)
 {
 	int ret;
+	mqd_t sync_mqdes;
+	int chsize;
+	bool cached;
 
 	ret = messaging_send_param_validation(port_name, send_data);
 	if (ret == ERROR) {
@@ -123,17 +103,23 @@ int messaging_send_sync(const char *port_name, msg_send_data_t *send_data, msg_r
 		return ERROR;
 	}
 
-	ret = messaging_send_internal(port_name, MSG_SEND_SYNC, send_data, NULL, NULL);
-	if (ret == ERROR) {
+	/* The reply channel is opened before sending, so that the reply cannot come before it. */
+	sync_mqdes = messaging_open_reply_channel(port_name, reply_buf->buflen + MSG_HEADER_SIZE, &chsize, &cached);
+	if (sync_mqdes == (mqd_t)ERROR) {
 		return ERROR;
 	}
 
-	ret = messaging_sync_recv(port_name, reply_buf);
-	if (ret != OK) {
+	ret = messaging_send_internal(port_name, MSG_SEND_SYNC, send_data, NULL, NULL);
+	if (ret != ERROR) {
+		ret = messaging_sync_recv(sync_mqdes, chsize, reply_buf);
+	}
+
+	messaging_close_reply_channel(port_name, sync_mqdes, cached, ret == ERROR);
+	if (ret == ERROR) {
 		return ERROR;
 	}
 
-	return OK;	
+	return OK;
 }
 
 /****************************************************************************
@@ -196,6 +182,7 @@ int messaging_send(const char *port_name, msg_send_data_t *send_data)
 int messaging_reply(const char *port_name, pid_t sender_pid, msg_send_data_t *reply_data)
 {
 	int ret = OK;
+	mqd_t mqdes;
 	char *reply_portname;
 	msg_send_data_t reply;
 
@@ -211,10 +198,21 @@ int messaging_reply(const char *port_name, pid_t sender_pid, msg_send_data_t *re
 		return ERROR;
 	}
 
+	mqdes = mq_open(reply_portname, O_WRONLY);
+	if (mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] unicast reply fail : open fail, errno %d.\n", errno);
+		MSG_FREE(reply_portname);
+		return ERROR;
+	}
+
 	reply.msg = reply_data->msg;
 	reply.msglen = reply_data->msglen;
 	reply.priority = MSG_REPLY_PRIO;
-	ret = messaging_send_packet(reply_portname, MSG_SEND_REPLY, &reply, NULL);
+	ret = messaging_send_packet(mqdes, 0, MSG_SEND_REPLY, &reply, false);
+	mq_close(mqdes);
+	if (ret != OK) {
+		mq_unlink(reply_portname);
+	}
 	MSG_FREE(reply_portname);
 	return ret;
 }
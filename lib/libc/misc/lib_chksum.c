@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <chksum.h>
+
+#ifndef CONFIG_ARCH_CHKSUM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ARMv7 can add a chain of words with carry in one instruction per word.
+ * Elsewhere the words are added into a 64-bit accumulator and the carries
+ * are folded back at the end.
+ */
+
+#if defined(__GNUC__) && (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+	defined(__ARM_ARCH_7R__) || defined(__ARM_ARCH_7A__))
+#define CHKSUM_ARM_ADC 1
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CHKSUM_ARM_ADC
+/* Add four aligned words to 'sum' with end-around carry */
+
+static inline uint32_t chksum_add16bytes(FAR const uint32_t *pl, uint32_t sum)
+{
+	uint32_t a;
+	uint32_t b;
+	uint32_t c;
+	uint32_t d;
+
+	__asm__ __volatile__(
+		"ldr	%[a], [%[p], #0]\n\t"
+		"ldr	%[b], [%[p], #4]\n\t"
+		"ldr	%[c], [%[p], #8]\n\t"
+		"ldr	%[d], [%[p], #12]\n\t"
+		"adds	%[s], %[s], %[a]\n\t"
+		"adcs	%[s], %[s], %[b]\n\t"
+		"adcs	%[s], %[s], %[c]\n\t"
+		"adcs	%[s], %[s], %[d]\n\t"
+		"adc	%[s], %[s], #0\n\t"
+		: [s] "+r"(sum), [a] "=&r"(a), [b] "=&r"(b), [c] "=&r"(c), [d] "=&r"(d)
+		: [p] "r"(pl)
+		: "cc", "memory");
+
+	return sum;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: chksum16
+ *
+ * Description:
+ *   Return the 16-bit one's complement sum of a buffer.  By RFC 1071 the
+ *   sum of the host order words is the byte-swapped sum of the network
+ *   order words, so the bulk of the buffer is summed a word at a time and
+ *   only the odd head and tail bytes need special treatment.
+ *
+ ****************************************************************************/
+
+uint16_t chksum16(FAR const void *src, size_t len)
+{
+	FAR const uint8_t *pb = (FAR const uint8_t *)src;
+	FAR const uint32_t *pl;
+	FAR const uint16_t *ps;
+	uint64_t acc = 0;
+	uint16_t t = 0;
+	bool odd = ((uintptr_t)pb & 1) != 0;
+
+	/* Get aligned to uint16_t.  The first byte goes into the high half of
+	 * the host order word; the result is swapped back at the end.
+	 */
+
+	if (odd && len > 0) {
+		((FAR uint8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	/* Get aligned to uint32_t */
+
+	ps = (FAR const uint16_t *)pb;
+	if (((uintptr_t)ps & 2) != 0 && len > 1) {
+		acc += *ps++;
+		len -= 2;
+	}
+
+	/* Add the bulk of the data */
+
+	pl = (FAR const uint32_t *)ps;
+
+#ifdef CHKSUM_ARM_ADC
+	{
+		uint32_t sum = 0;
+
+		while (len >= 16) {
+			sum = chksum_add16bytes(pl, sum);
+			pl += 4;
+			len -= 16;
+		}
+
+		acc += sum;
+	}
+#else
+	while (len >= 16) {
+		acc += pl[0];
+		acc += pl[1];
+		acc += pl[2];
+		acc += pl[3];
+		pl += 4;
+		len -= 16;
+	}
+#endif
+
+	while (len >= 4) {
+		acc += *pl++;
+		len -= 4;
+	}
+
+	/* 16-bit aligned word remaining? */
+
+	ps = (FAR const uint16_t *)pl;
+	if (len > 1) {
+		acc += *ps++;
+		len -= 2;
+	}
+
+	/* Dangling tail byte remaining? */
+
+	if (len > 0) {
+		((FAR uint8_t *)&t)[0] = *(FAR const uint8_t *)ps;
+	}
+
+	acc += t;
+
+	/* Fold the 64-bit sum to 16 bits */
+
+	while ((acc >> 16) != 0) {
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	/* Swap if the alignment was odd */
+
+	if (odd) {
+		acc = ((acc & 0xff) << 8) | ((acc >> 8) & 0xff);
+	}
+
+	return (uint16_t)acc;
+}
+
+#endif /* CONFIG_ARCH_CHKSUM */
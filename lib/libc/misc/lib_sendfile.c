@@ -97,6 +97,10 @@
  *   nothing in TinyAra but provide some Linux compatible (and adding
  *   another 'almost standard' interface).
  *
+ *   With CONFIG_NET_SENDFILE, the kernel provides sendfile() and hands
+ *   socket destinations to the network stack.  This read/write loop is then
+ *   exported as lib_sendfile() and used for every other combination.
+ *
  *   NOTE: This interface is *not* specified in POSIX.1-2001, or other
  *   standards.  The implementation here is very similar to the Linux
  *   sendfile interface.  Other UNIX systems implement sendfile() with
@@ -130,7 +134,11 @@
  *
  ************************************************************************/
 
+#ifdef CONFIG_NET_SENDFILE
+ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count)
+#else
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
+#endif
 {
 	FAR uint8_t *iobuffer;
 	FAR uint8_t *wrbuffer;
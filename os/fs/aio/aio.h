@@ -64,6 +64,7 @@
 #include <aio.h>
 #include <queue.h>
 
+#include <tinyara/clock.h>
 #include <tinyara/wqueue.h>
 #include <tinyara/net/net.h>
 
@@ -90,6 +91,58 @@
 #error AIO needs file and/or socket descriptors
 #endif
 
+#if !defined(CONFIG_FS_AIO_WORKERS) && !defined(CONFIG_SCHED_LPWORK)
+#error AIO needs CONFIG_FS_AIO_WORKERS or CONFIG_SCHED_LPWORK
+#endif
+
+#ifdef CONFIG_FS_AIO_WORKERS
+#ifndef CONFIG_FS_AIO_NWORKERS
+#define CONFIG_FS_AIO_NWORKERS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_WORKER_PRIORITY
+#define CONFIG_FS_AIO_WORKER_PRIORITY 50
+#endif
+
+#ifndef CONFIG_FS_AIO_WORKER_STACKSIZE
+#define CONFIG_FS_AIO_WORKER_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_FS_AIO_MERGE_SIZE
+#define CONFIG_FS_AIO_MERGE_SIZE 0
+#endif
+
+/* Maximum number of requests combined into one merged transfer */
+
+#define AIO_MERGE_MAXREQS 8
+
+/* Container states (aioc_state) */
+
+#define AIOC_STATE_NEW     0	/* Contained but not yet queued */
+#define AIOC_STATE_QUEUED  1	/* Waiting for a worker thread */
+#define AIOC_STATE_RUNNING 2	/* Taken by a worker thread */
+#endif
+
+/* The caller's priority is kept in the container when it is needed either
+ * to boost the low-priority work queue or to order the requests for the
+ * worker threads.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) || defined(CONFIG_FS_AIO_WORKERS)
+#define AIOC_HAVE_PRIO
+#endif
+
+/* The AIO worker threads manage their own priority.  Otherwise, the
+ * low-priority work queue has to be returned to its default priority when
+ * each request completes.
+ */
+
+#ifdef CONFIG_FS_AIO_WORKERS
+#define aio_restorepriority(prio) ((void)(prio))
+#else
+#define aio_restorepriority(prio) lpwork_restorepriority(prio)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -108,13 +161,34 @@ struct aio_container_s {
 #endif
 		FAR void *ptr;			/* Generic pointer to FAR data */
 	} u;
+#ifdef CONFIG_FS_AIO_WORKERS
+	worker_t aioc_worker;		/* Performs the I/O on the worker thread */
+	uint8_t aioc_state;			/* See AIOC_STATE_* definitions */
+#ifdef CONFIG_FS_AIO_METRICS
+	clock_t aioc_qtime;			/* Time when the request was queued */
+#endif
+#else
 	struct work_s aioc_work;	/* Used to defer I/O to the work thread */
+#endif
+	uint8_t aioc_opcode;		/* LIO_READ, LIO_WRITE or LIO_NOP (fsync) */
 	pid_t aioc_pid;				/* ID of the waiting task */
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIOC_HAVE_PRIO
 	uint8_t aioc_prio;			/* Priority of the waiting task */
 #endif
 };
 
+#ifdef CONFIG_FS_AIO_METRICS
+/* Completion statistics of the AIO worker threads (see /proc/fs/aio) */
+
+struct aio_metrics_s {
+	uint32_t am_completed;		/* Number of completed requests */
+	uint32_t am_merged;			/* Requests completed by a merged transfer */
+	uint32_t am_transfers;		/* Number of transfers performed */
+	uint64_t am_latency;		/* Sum of all completion latencies (ticks) */
+	clock_t am_maxlatency;		/* Largest completion latency (ticks) */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -133,6 +207,14 @@ extern "C" {
 
 EXTERN dq_queue_t g_aio_pending;
 
+#ifdef CONFIG_FS_AIO_METRICS
+/* Completion statistics.  The user must hold the lock on the pending list
+ * in order to access them.
+ */
+
+EXTERN struct aio_metrics_s g_aio_metrics;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -250,7 +332,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the AIO worker threads or, if they are
+ *   not enabled, on the low priority work queue
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -264,6 +347,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Withdraw a request that was passed to aio_queue() but has not yet been
+ *   started.  The caller must hold the lock on the pending list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request will not be performed; -ENOENT if the I/O has
+ *   already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
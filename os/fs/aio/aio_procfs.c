@@ -0,0 +1,230 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO_METRICS) && !defined(CONFIG_DISABLE_MOUNTPOINT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the buffer that holds the complete formatted report */
+
+#define AIO_PROCFS_BUFLEN 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct aio_procfs_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	unsigned int linesize;		/* Number of valid characters in line[] */
+	char line[AIO_PROCFS_BUFLEN];	/* The report sampled on the first read */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int aio_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int aio_procfs_close(FAR struct file *filep);
+static ssize_t aio_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static int aio_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+static int aio_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations aio_procfsoperations = {
+	aio_procfs_open,			/* open */
+	aio_procfs_close,			/* close */
+	aio_procfs_read,			/* read */
+	NULL,						/* write */
+
+	aio_procfs_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	aio_procfs_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_procfs_open
+ ****************************************************************************/
+
+static int aio_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct aio_procfs_file_s *attr;
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	if (strcmp(relpath, "fs/aio") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	attr = (FAR struct aio_procfs_file_s *)kmm_zalloc(sizeof(struct aio_procfs_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_close
+ ****************************************************************************/
+
+static int aio_procfs_close(FAR struct file *filep)
+{
+	FAR struct aio_procfs_file_s *attr;
+
+	attr = (FAR struct aio_procfs_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_read
+ ****************************************************************************/
+
+static ssize_t aio_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct aio_procfs_file_s *attr;
+	struct aio_metrics_s metrics;
+	unsigned long avgms = 0;
+	off_t offset;
+	ssize_t ret;
+
+	attr = (FAR struct aio_procfs_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Sample the metrics on the first read so that the report stays
+	 * consistent if it is read in several pieces.
+	 */
+
+	if (filep->f_pos == 0) {
+		aio_lock();
+		metrics = g_aio_metrics;
+		aio_unlock();
+
+		if (metrics.am_completed > 0) {
+			avgms = (unsigned long)TICK2MSEC(metrics.am_latency / metrics.am_completed);
+		}
+
+		attr->linesize = snprintf(attr->line, AIO_PROCFS_BUFLEN,
+								  "Completed:   %lu\n"
+								  "Merged:      %lu\n"
+								  "Transfers:   %lu\n"
+								  "Latency avg: %lu ms\n"
+								  "Latency max: %lu ms\n",
+								  (unsigned long)metrics.am_completed, (unsigned long)metrics.am_merged, (unsigned long)metrics.am_transfers, avgms, (unsigned long)TICK2MSEC(metrics.am_maxlatency));
+	}
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->line, attr->linesize, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_dup
+ ****************************************************************************/
+
+static int aio_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct aio_procfs_file_s *oldattr;
+	FAR struct aio_procfs_file_s *newattr;
+
+	oldattr = (FAR struct aio_procfs_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct aio_procfs_file_s *)kmm_malloc(sizeof(struct aio_procfs_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct aio_procfs_file_s));
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_procfs_stat
+ ****************************************************************************/
+
+static int aio_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	if (strcmp(relpath, "fs/aio") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif /* CONFIG_FS_AIO_METRICS && !CONFIG_DISABLE_MOUNTPOINT */
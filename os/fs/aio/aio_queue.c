@@ -138,4 +138,25 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 	return ret;
 }
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Withdraw a request that was passed to aio_queue() but has not yet been
+ *   started.  The caller must hold the lock on the pending list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request will not be performed; -ENOENT if the I/O has
+ *   already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+	return work_cancel(LPWORK, &aioc->aioc_work);
+}
+
 #endif							/* CONFIG_FS_AIO */
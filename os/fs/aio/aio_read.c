@@ -109,6 +109,7 @@ static void aio_read_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+	FAR struct file *filep;
 	pid_t pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t prio;
@@ -121,6 +122,7 @@ static void aio_read_worker(FAR void *arg)
 	 */
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
+	filep = aioc->u.aioc_filep;
 	pid = aioc->aioc_pid;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	prio = aioc->aioc_prio;
@@ -137,7 +139,7 @@ static void aio_read_worker(FAR void *arg)
 		 *   aio_offset   - File offset
 		 */
 
-		nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
+		nread = file_pread(filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
 	}
 #endif
 
@@ -159,7 +161,7 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	/* Restore the low priority worker thread default priority */
 
-	lpwork_restorepriority(prio);
+	aio_restorepriority(prio);
 #endif
 }
 
@@ -289,6 +291,7 @@ int aio_read(FAR struct aiocb *aiocbp)
 
 	/* Defer the work to the worker thread */
 
+	aioc->aioc_opcode = LIO_READ;
 	ret = aio_queue(aioc, aio_read_worker);
 	if (ret < 0) {
 		/* The result and the errno have already been set */
@@ -0,0 +1,550 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO_WORKERS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Counts the wake-ups owed to the worker threads.  Posted whenever a request
+ * is queued or a request that may have been held back becomes runnable.
+ */
+
+static sem_t g_aio_worksem;
+
+/* The open file that each worker thread is operating on, if any.  Protected
+ * by the lock on the pending list.
+ */
+
+static FAR struct file *g_aio_busy[CONFIG_FS_AIO_NWORKERS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_AIO_METRICS
+struct aio_metrics_s g_aio_metrics;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_priority
+ *
+ * Description:
+ *   Return the priority of a request: the priority of the submitting thread
+ *   lowered by aio_reqprio.
+ *
+ ****************************************************************************/
+
+static int aio_priority(FAR struct aio_container_s *aioc)
+{
+	int prio = (int)aioc->aioc_prio - aioc->aioc_aiocbp->aio_reqprio;
+
+	return prio < SCHED_PRIORITY_MIN ? SCHED_PRIORITY_MIN : prio;
+}
+
+/****************************************************************************
+ * Name: aio_filebusy
+ *
+ * Description:
+ *   Return true if the request must wait for an earlier request on the same
+ *   open file: either one still in the pending list ahead of it, or one
+ *   that a worker thread is performing now.  The caller must hold the lock
+ *   on the pending list.
+ *
+ ****************************************************************************/
+
+static bool aio_filebusy(FAR struct aio_container_s *aioc)
+{
+	FAR struct aio_container_s *prev;
+	FAR struct file *filep = aioc->u.aioc_filep;
+	int i;
+
+	for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++) {
+		if (g_aio_busy[i] == filep) {
+			return true;
+		}
+	}
+
+	for (prev = (FAR struct aio_container_s *)g_aio_pending.head; prev != aioc; prev = (FAR struct aio_container_s *)prev->aioc_link.flink) {
+		if (prev->u.aioc_filep == filep) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: aio_gather
+ *
+ * Description:
+ *   Collect the queued requests that directly follow 'first' on the same
+ *   file and can be performed with it as one transfer.  The chain stops at
+ *   the first later request on that file that does not qualify so that
+ *   per-file ordering is preserved.  The caller must hold the lock on the
+ *   pending list.
+ *
+ * Returned Value:
+ *   The number of requests in 'batch', including 'first'.
+ *
+ ****************************************************************************/
+
+static int aio_gather(FAR struct aio_container_s *first, FAR struct aio_container_s **batch)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aiocb *aiocbp;
+	FAR struct file *filep = first->u.aioc_filep;
+	size_t total;
+	off_t next;
+	int nreqs = 1;
+
+	batch[0] = first;
+
+	if (CONFIG_FS_AIO_MERGE_SIZE <= 0 || first->aioc_opcode == LIO_NOP) {
+		return nreqs;
+	}
+
+	/* Appending writes ignore the offset and cannot be combined */
+
+	if (first->aioc_opcode == LIO_WRITE && (filep->f_oflags & O_APPEND) != 0) {
+		return nreqs;
+	}
+
+	total = first->aioc_aiocbp->aio_nbytes;
+	next = first->aioc_aiocbp->aio_offset + (off_t)total;
+
+	for (aioc = (FAR struct aio_container_s *)first->aioc_link.flink; aioc != NULL && nreqs < AIO_MERGE_MAXREQS; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (aioc->u.aioc_filep != filep) {
+			continue;
+		}
+
+		aiocbp = aioc->aioc_aiocbp;
+		if (aioc->aioc_state != AIOC_STATE_QUEUED || aioc->aioc_opcode != first->aioc_opcode || aiocbp->aio_offset != next || total + aiocbp->aio_nbytes > CONFIG_FS_AIO_MERGE_SIZE) {
+			break;
+		}
+
+		batch[nreqs++] = aioc;
+		total += aiocbp->aio_nbytes;
+		next += (off_t)aiocbp->aio_nbytes;
+	}
+
+	return nreqs;
+}
+
+/****************************************************************************
+ * Name: aio_pick
+ *
+ * Description:
+ *   Select the next work for worker thread 'index': the highest priority
+ *   queued request whose file is not busy, together with any requests that
+ *   can be merged with it.  Among requests of equal priority the oldest is
+ *   taken.  The selected requests are marked as running.  The caller must
+ *   hold the lock on the pending list.
+ *
+ * Returned Value:
+ *   The number of requests in 'batch'; zero if there is nothing to do.
+ *
+ ****************************************************************************/
+
+static int aio_pick(int index, FAR struct aio_container_s **batch, FAR int *prio)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aio_container_s *best = NULL;
+	int bestprio = 0;
+	int nreqs;
+	int i;
+
+	for (aioc = (FAR struct aio_container_s *)g_aio_pending.head; aioc != NULL; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (aioc->aioc_state == AIOC_STATE_QUEUED && aio_priority(aioc) > bestprio && !aio_filebusy(aioc)) {
+			best = aioc;
+			bestprio = aio_priority(aioc);
+		}
+	}
+
+	if (best == NULL) {
+		return 0;
+	}
+
+	nreqs = aio_gather(best, batch);
+	for (i = 0; i < nreqs; i++) {
+		batch[i]->aioc_state = AIOC_STATE_RUNNING;
+	}
+
+	g_aio_busy[index] = best->u.aioc_filep;
+	*prio = bestprio;
+	return nreqs;
+}
+
+/****************************************************************************
+ * Name: aio_merged
+ *
+ * Description:
+ *   Perform a batch of adjacent reads or writes as a single transfer through
+ *   a kernel buffer, then complete each request with its share of the
+ *   result.  If the buffer cannot be allocated, the requests are performed
+ *   one at a time instead.
+ *
+ ****************************************************************************/
+
+static void aio_merged(FAR struct aio_container_s **batch, int nreqs)
+{
+	FAR struct aiocb *aiocbp[AIO_MERGE_MAXREQS];
+	pid_t pid[AIO_MERGE_MAXREQS];
+	FAR struct file *filep;
+	FAR uint8_t *buffer;
+	uint8_t opcode;
+	size_t total = 0;
+	size_t remaining;
+	size_t nbytes;
+	size_t pos;
+	off_t offset;
+	ssize_t ret;
+	int i;
+
+	for (i = 0; i < nreqs; i++) {
+		total += batch[i]->aioc_aiocbp->aio_nbytes;
+	}
+
+	buffer = (FAR uint8_t *)kmm_malloc(total);
+	if (buffer == NULL) {
+		for (i = 0; i < nreqs; i++) {
+			batch[i]->aioc_worker(batch[i]);
+		}
+
+		return;
+	}
+
+	/* Decant all of the requests before starting the I/O */
+
+	filep = batch[0]->u.aioc_filep;
+	opcode = batch[0]->aioc_opcode;
+
+	for (i = 0; i < nreqs; i++) {
+		pid[i] = batch[i]->aioc_pid;
+		aiocbp[i] = aioc_decant(batch[i]);
+	}
+
+	offset = aiocbp[0]->aio_offset;
+
+	if (opcode == LIO_WRITE) {
+		for (i = 0, pos = 0; i < nreqs; pos += aiocbp[i]->aio_nbytes, i++) {
+			memcpy(buffer + pos, (FAR const void *)aiocbp[i]->aio_buf, aiocbp[i]->aio_nbytes);
+		}
+
+		ret = file_pwrite(filep, buffer, total, offset);
+	} else {
+		ret = file_pread(filep, buffer, total, offset);
+	}
+
+	if (ret < 0) {
+		ret = -get_errno();
+		fdbg("ERROR: merged transfer failed: %d\n", (int)ret);
+	}
+
+	/* Hand out the result in request order: a short transfer completes the
+	 * leading requests and leaves the rest with a short or zero count.
+	 */
+
+	remaining = ret < 0 ? 0 : (size_t)ret;
+	for (i = 0, pos = 0; i < nreqs; pos += aiocbp[i]->aio_nbytes, i++) {
+		if (ret < 0) {
+			aiocbp[i]->aio_result = ret;
+		} else {
+			nbytes = aiocbp[i]->aio_nbytes < remaining ? aiocbp[i]->aio_nbytes : remaining;
+			if (opcode == LIO_READ && nbytes > 0) {
+				memcpy((FAR void *)aiocbp[i]->aio_buf, buffer + pos, nbytes);
+			}
+
+			aiocbp[i]->aio_result = nbytes;
+			remaining -= nbytes;
+		}
+
+		(void)aio_signal(pid[i], aiocbp[i]);
+	}
+
+	kmm_free(buffer);
+}
+
+/****************************************************************************
+ * Name: aio_setpriority
+ *
+ * Description:
+ *   Change the priority of the calling worker thread, if necessary.
+ *
+ ****************************************************************************/
+
+static void aio_setpriority(FAR int *curprio, int prio)
+{
+	struct sched_param param;
+
+	if (*curprio != prio) {
+		param.sched_priority = prio;
+		if (sched_setparam(0, &param) == OK) {
+			*curprio = prio;
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: aio_worker
+ *
+ * Description:
+ *   The body of an AIO worker thread.  argv[1] holds the index of the
+ *   worker.
+ *
+ ****************************************************************************/
+
+static int aio_worker(int argc, FAR char *argv[])
+{
+	FAR struct aio_container_s *batch[AIO_MERGE_MAXREQS];
+	FAR struct aio_container_s *aioc;
+#ifdef CONFIG_FS_AIO_METRICS
+	clock_t qtime[AIO_MERGE_MAXREQS];
+	clock_t latency;
+#endif
+	int curprio = CONFIG_FS_AIO_WORKER_PRIORITY;
+	bool runnable;
+	int index;
+	int nreqs;
+	int prio;
+	int i;
+
+	DEBUGASSERT(argc == 2);
+	index = atoi(argv[1]);
+	DEBUGASSERT(index >= 0 && index < CONFIG_FS_AIO_NWORKERS);
+
+	for (;;) {
+		aio_lock();
+		nreqs = aio_pick(index, batch, &prio);
+		aio_unlock();
+
+		if (nreqs == 0) {
+			/* Nothing that can be started.  Wait at the idle priority. */
+
+			aio_setpriority(&curprio, CONFIG_FS_AIO_WORKER_PRIORITY);
+			while (sem_wait(&g_aio_worksem) < 0) {
+				DEBUGASSERT(get_errno() == EINTR);
+			}
+
+			continue;
+		}
+
+#ifdef CONFIG_FS_AIO_METRICS
+		for (i = 0; i < nreqs; i++) {
+			qtime[i] = batch[i]->aioc_qtime;
+		}
+#endif
+
+		/* Perform the I/O at the priority of the request.  The containers
+		 * are decanted, and so must not be referenced, after this.
+		 */
+
+		aio_setpriority(&curprio, prio);
+
+		if (nreqs == 1) {
+			aioc = batch[0];
+			aioc->aioc_worker(aioc);
+		} else {
+			aio_merged(batch, nreqs);
+		}
+
+		/* Release the file and wake a worker if a request that was held back
+		 * behind this one may now be started.
+		 */
+
+		aio_lock();
+		g_aio_busy[index] = NULL;
+
+#ifdef CONFIG_FS_AIO_METRICS
+		g_aio_metrics.am_transfers++;
+		g_aio_metrics.am_completed += nreqs;
+		if (nreqs > 1) {
+			g_aio_metrics.am_merged += nreqs;
+		}
+
+		for (i = 0; i < nreqs; i++) {
+			latency = clock_systimer() - qtime[i];
+			g_aio_metrics.am_latency += latency;
+			if (latency > g_aio_metrics.am_maxlatency) {
+				g_aio_metrics.am_maxlatency = latency;
+			}
+		}
+#endif
+
+		runnable = false;
+		for (aioc = (FAR struct aio_container_s *)g_aio_pending.head; aioc != NULL; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+			if (aioc->aioc_state == AIOC_STATE_QUEUED) {
+				runnable = true;
+				break;
+			}
+		}
+
+		aio_unlock();
+
+		if (runnable) {
+			sem_post(&g_aio_worksem);
+		}
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO worker threads.  This is called from the OS bring-up
+ *   logic, once kernel threads can be created.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_start(void)
+{
+	FAR char *argv[2];
+	char arg[4];
+	pid_t pid;
+	int i;
+
+	(void)sem_init(&g_aio_worksem, 0, 0);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	(void)sem_setprotocol(&g_aio_worksem, SEM_PRIO_NONE);
+#endif
+
+	argv[0] = arg;
+	argv[1] = NULL;
+
+	for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++) {
+		snprintf(arg, sizeof(arg), "%d", i);
+
+		pid = kernel_thread("aio_worker", CONFIG_FS_AIO_WORKER_PRIORITY, CONFIG_FS_AIO_WORKER_STACKSIZE, (main_t)aio_worker, (FAR char *const *)argv);
+		if (pid < 0) {
+			int errcode = get_errno();
+			fdbg("ERROR: Failed to start AIO worker %d: %d\n", i, errcode);
+			return -errcode;
+		}
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_queue
+ *
+ * Description:
+ *   Queue the asynchronous I/O for the AIO worker threads.  The request is
+ *   started when a worker is free, no earlier request on the same file is
+ *   outstanding, and no runnable request has a higher priority.
+ *
+ * Input Parameters:
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+	FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
+
+	DEBUGASSERT(aiocbp);
+
+	/* aio_reqprio can only lower the priority of a request */
+
+	if (aiocbp->aio_reqprio < 0) {
+		(void)aioc_decant(aioc);
+		aiocbp->aio_result = -EINVAL;
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	aio_lock();
+	aioc->aioc_worker = worker;
+	aioc->aioc_state = AIOC_STATE_QUEUED;
+#ifdef CONFIG_FS_AIO_METRICS
+	aioc->aioc_qtime = clock_systimer();
+#endif
+	aio_unlock();
+
+	sem_post(&g_aio_worksem);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Withdraw a request that was passed to aio_queue() but has not yet been
+ *   started.  The caller must hold the lock on the pending list.
+ *
+ * Input Parameters:
+ *   aioc - Pointer to the AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the request will not be performed; -ENOENT if the I/O has
+ *   already been started.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+	return aioc->aioc_state == AIOC_STATE_QUEUED ? OK : -ENOENT;
+}
+
+#endif /* CONFIG_FS_AIO_WORKERS */
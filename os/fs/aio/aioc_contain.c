@@ -118,7 +118,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 #endif
 		FAR void *ptr;
 	} u;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIOC_HAVE_PRIO
 	struct sched_param param;
 #endif
 	int ret;
@@ -148,7 +148,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
 	aioc->u.ptr = u.ptr;
 	aioc->aioc_pid = getpid();
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIOC_HAVE_PRIO
 	DEBUGVERIFY(sched_getparam(aioc->aioc_pid, &param));
 	aioc->aioc_prio = param.sched_priority;
 #endif
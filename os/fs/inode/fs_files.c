@@ -130,6 +130,12 @@ static int _files_close(FAR struct file *filep)
 	/* Check if the struct file is open (i.e., assigned an inode) */
 
 	if (inode) {
+#ifdef CONFIG_FS_EPOLL
+		/* Drop its epoll registrations while it can still be polled */
+
+		epoll_fdclose(-1, filep);
+#endif
+
 		/* Close the file, driver, or mountpoint. */
 
 		if (inode->u.i_ops && inode->u.i_ops->close) {
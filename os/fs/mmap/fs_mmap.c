@@ -0,0 +1,200 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/sched.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include "inode/inode.h"
+#include "mmap/fs_mmap.h"
+
+#ifdef CONFIG_FS_MMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap
+ *
+ * Description:
+ *   Map a file into the caller's address space.  There is no MMU, so this
+ *   only succeeds when the file system can hand out the address of the file
+ *   data directly through the FIOC_MMAP ioctl (ROMFS on XIP flash, tmpfs).
+ *   No data is copied.  A mapped tmpfs file is pinned, so writes that would
+ *   move its data, truncation and unlink fail with EBUSY until it is
+ *   unmapped.
+ *
+ * Parameters:
+ *   start  - Ignored; the mapping address is dictated by the media.
+ *   length - The length of the mapping.  offset + length must not exceed
+ *            the current size of the file.
+ *   prot   - Must be PROT_READ.  PROT_WRITE and PROT_EXEC are not
+ *            supported.
+ *   flags  - Must be MAP_SHARED.  MAP_PRIVATE, MAP_FIXED, MAP_ANONYMOUS and
+ *            MAP_DENYWRITE are not supported.
+ *   fd     - A file descriptor open for reading.
+ *   offset - The offset into the file of the first mapped byte.
+ *
+ * Returned Value:
+ *   On success, the address of the mapped region.  Otherwise MAP_FAILED is
+ *   returned and errno is set:
+ *
+ *   EACCES - fd is not open for reading.
+ *   EBADF  - fd is not a valid file descriptor.
+ *   EINVAL - length is zero, offset is negative or MAP_SHARED is missing.
+ *   ENODEV - The file system does not support direct mapping.
+ *   ENOMEM - The mapping container could not be allocated.
+ *   ENOSYS - An unsupported protection or flag was requested.
+ *   ENXIO  - offset + length lies beyond the end of the file.
+ *
+ ****************************************************************************/
+
+FAR void *mmap(FAR void *start, size_t length, int prot, int flags, int fd, off_t offset)
+{
+	FAR struct task_group_s *group;
+	FAR struct fs_mapping_s *map;
+	FAR struct file *filep;
+	FAR uint8_t *addr;
+	struct stat buf;
+	int errcode;
+	int ret;
+
+	/* Only read-only, shared mappings of directly addressable media can be
+	 * provided without an MMU.
+	 */
+
+	if ((prot & (PROT_WRITE | PROT_EXEC)) != 0) {
+		fdbg("ERROR: Unsupported protection: %x\n", prot);
+		errcode = ENOSYS;
+		goto errout;
+	}
+
+	if ((flags & (MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS | MAP_DENYWRITE)) != 0) {
+		fdbg("ERROR: Unsupported flags: %x\n", flags);
+		errcode = ENOSYS;
+		goto errout;
+	}
+
+	if (length == 0 || offset < 0 || (flags & MAP_SHARED) == 0) {
+		errcode = EINVAL;
+		goto errout;
+	}
+
+	ret = fs_getfilep(fd, &filep);
+	if (ret < 0) {
+		errcode = -ret;
+		goto errout;
+	}
+
+	if ((filep->f_oflags & O_RDOK) == 0) {
+		errcode = EACCES;
+		goto errout;
+	}
+
+	/* The whole region must lie inside the file */
+
+	ret = fstat(fd, &buf);
+	if (ret < 0) {
+		errcode = get_errno();
+		goto errout;
+	}
+
+	if ((off_t)length > buf.st_size || offset > buf.st_size - (off_t)length) {
+		errcode = ENXIO;
+		goto errout;
+	}
+
+	/* Hold a private reference on the file for the life of the mapping */
+
+	map = (FAR struct fs_mapping_s *)kmm_zalloc(sizeof(struct fs_mapping_s));
+	if (map == NULL) {
+		errcode = ENOMEM;
+		goto errout;
+	}
+
+	ret = file_dup2(filep, &map->file);
+	if (ret < 0) {
+		errcode = get_errno();
+		kmm_free(map);
+		goto errout;
+	}
+
+	/* File systems whose data can move (tmpfs) keep it in place while it
+	 * is pinned.  Others do not know the command and never move it.
+	 */
+
+	ret = file_ioctl(&map->file, FIOC_MMAP_PIN, 0);
+	if (ret >= 0) {
+		map->pinned = true;
+	} else if (ret != -ENOTTY) {
+		mmap_free(map);
+		errcode = -ret;
+		goto errout;
+	}
+
+	/* Ask the file system for the address of the file data */
+
+	ret = file_ioctl(&map->file, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+	if (ret < 0) {
+		fvdbg("FIOC_MMAP not supported: %d\n", ret);
+		mmap_free(map);
+		errcode = ENODEV;
+		goto errout;
+	}
+
+	map->addr = (FAR void *)(addr + offset);
+	map->length = length;
+
+	/* Record the mapping in the task group so that it can be released by
+	 * munmap() or when the group exits.
+	 */
+
+	group = sched_self()->group;
+	DEBUGASSERT(group != NULL);
+
+	sched_lock();
+	sq_addlast((FAR sq_entry_t *)map, &group->tg_mmapq);
+	sched_unlock();
+
+	fvdbg("Mapped fd %d offset %ld length %lu at %p\n", fd, (long)offset, (unsigned long)length, map->addr);
+	return map->addr;
+
+errout:
+	set_errno(errcode);
+	return MAP_FAILED;
+}
+
+#endif /* CONFIG_FS_MMAP */
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_MMAP_H
+#define __FS_MMAP_FS_MMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <queue.h>
+
+#include <tinyara/fs/fs.h>
+
+#ifdef CONFIG_FS_MMAP
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One instance of this structure is kept in the task group's tg_mmapq for
+ * each region returned by mmap().  The embedded file is a private duplicate
+ * of the descriptor passed to mmap() so that the backing object stays alive
+ * even if the caller closes the descriptor before calling munmap().
+ */
+
+struct fs_mapping_s {
+	FAR struct fs_mapping_s *flink;	/* Supports a singly linked list */
+	FAR void *addr;				/* Start of the region returned to the user */
+	size_t length;				/* Length of the region in bytes */
+	bool pinned;				/* The file system was asked to keep the data in place */
+	struct file file;			/* Reference on the mapped file */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap_free
+ *
+ * Description:
+ *   Close the file reference held by a mapping and free the mapping
+ *   container.  The mapping must already be removed from its group list.
+ *
+ ****************************************************************************/
+
+void mmap_free(FAR struct fs_mapping_s *map);
+
+#endif /* CONFIG_FS_MMAP */
+#endif /* __FS_MMAP_FS_MMAP_H */
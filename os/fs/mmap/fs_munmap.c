@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/sched.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+
+#include "mmap/fs_mmap.h"
+
+#ifdef CONFIG_FS_MMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mmap_free
+ *
+ * Description:
+ *   Close the file reference held by a mapping and free the mapping
+ *   container.  The mapping must already be removed from its group list.
+ *
+ ****************************************************************************/
+
+void mmap_free(FAR struct fs_mapping_s *map)
+{
+	int ret;
+
+	if (map->pinned) {
+		(void)file_ioctl(&map->file, FIOC_MMAP_UNPIN, 0);
+	}
+
+	ret = file_close(&map->file);
+	if (ret < 0) {
+		fdbg("ERROR: file_close failed: %d\n", ret);
+	}
+
+	kmm_free(map);
+}
+
+/****************************************************************************
+ * Name: munmap
+ *
+ * Description:
+ *   Release a region returned by mmap().  The media is addressed in place,
+ *   so there is nothing to write back; releasing the mapping just drops the
+ *   reference it holds on the file.
+ *
+ *   Partial unmapping is not supported: 'start' must be an address returned
+ *   by mmap() and 'length' must not exceed the length of that mapping.
+ *
+ * Parameters:
+ *   start  - The address returned by mmap().
+ *   length - The length of the region to release.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise -1 (ERROR) is returned and errno is
+ *   set to EINVAL if the region does not describe a mapping owned by the
+ *   caller's task group.
+ *
+ ****************************************************************************/
+
+int munmap(FAR void *start, size_t length)
+{
+	FAR struct task_group_s *group;
+	FAR struct fs_mapping_s *curr;
+
+	if (start == NULL || length == 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	group = sched_self()->group;
+	DEBUGASSERT(group != NULL);
+
+	/* Find and detach the mapping */
+
+	sched_lock();
+	for (curr = (FAR struct fs_mapping_s *)group->tg_mmapq.head; curr != NULL && curr->addr != start; curr = curr->flink) ;
+
+	if (curr == NULL || length > curr->length) {
+		sched_unlock();
+		fdbg("ERROR: No mapping at %p length %lu\n", start, (unsigned long)length);
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	sq_rem((FAR sq_entry_t *)curr, &group->tg_mmapq);
+	sched_unlock();
+
+	mmap_free(curr);
+	return OK;
+}
+
+/****************************************************************************
+ * Name: mmap_release
+ *
+ * Description:
+ *   Release every file mapping still held by a task group.  Called when the
+ *   final member of the group exits.
+ *
+ ****************************************************************************/
+
+void mmap_release(FAR struct task_group_s *group)
+{
+	FAR struct fs_mapping_s *map;
+
+	while ((map = (FAR struct fs_mapping_s *)sq_remfirst(&group->tg_mmapq)) != NULL) {
+		mmap_free(map);
+	}
+}
+
+#endif /* CONFIG_FS_MMAP */
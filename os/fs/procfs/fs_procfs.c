@@ -108,6 +108,8 @@ extern const struct procfs_operations power_procfsoperations;
 extern const struct procfs_operations cm_operations;
 extern const struct procfs_operations irqs_operations;
 extern const struct procfs_operations ereport_operations;
+extern const struct procfs_operations aio_procfsoperations;
+extern const struct procfs_operations net_procfsoperations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
@@ -129,6 +131,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"cpuload", &cpuload_operations},
 #endif
 
+#ifdef CONFIG_FS_AIO_METRICS
+	{"fs/aio", &aio_procfsoperations},
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	{"fs/smartfs**", &smartfs_procfsoperations},
 #endif
@@ -141,6 +147,11 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"mtd", &mtd_procfsoperations},
 #endif
 
+#if defined(CONFIG_NET_STATS_PERF) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+	{"net/dev", &net_procfsoperations},
+	{"net/sock", &net_procfsoperations},
+#endif
+
 #if defined(CONFIG_MTD_PARTITION) && !defined(CONFIG_FS_PROCFS_EXCLUDE_PARTITIONS)
 	{"partitions", &part_procfsoperations},
 #endif
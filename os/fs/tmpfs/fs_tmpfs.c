@@ -384,6 +384,20 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
 
 	objsize = SIZEOF_TMPFS_FILE(newsize);
 
+	/* A mapped file must not move, nor lose the bytes that are mapped.  Use
+	 * the current allocation as it is, and refuse to shrink or to grow
+	 * beyond it.
+	 */
+
+	if (oldtfo->tfo_maps > 0) {
+		if (newsize < oldtfo->tfo_size || objsize > oldtfo->tfo_alloc) {
+			return -EBUSY;
+		}
+
+		oldtfo->tfo_size = newsize;
+		return OK;
+	}
+
 	/* Are we growing or shrinking the object? */
 
 	if (objsize <= oldtfo->tfo_alloc) {
@@ -616,6 +630,7 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 	tfo->tfo_type  = TMPFS_REGULAR;
 	tfo->tfo_refs  = 1;
 	tfo->tfo_flags = 0;
+	tfo->tfo_maps  = 0;
 	tfo->tfo_size  = 0;
 
 	tfo->tfo_exclsem.ts_holder = getpid();
@@ -1626,6 +1641,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
 	FAR struct tmpfs_file_s *tfo;
 	FAR void **ppv = (FAR void**)arg;
+	int ret;
 
 	fvdbg("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
 	DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1636,8 +1652,6 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 	DEBUGASSERT(tfo != NULL);
 
-	/* Only one ioctl command is supported */
-
 	if (cmd == FIOC_MMAP && ppv != NULL) {
 		/* Return the address on the media corresponding to the start of
 		 * the file.
@@ -1647,6 +1661,23 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 		return OK;
 	}
 
+	/* While a mapping pins the file, writes must not reallocate it */
+
+	if (cmd == FIOC_MMAP_PIN || cmd == FIOC_MMAP_UNPIN) {
+		ret = OK;
+		tmpfs_lock_file(tfo);
+		if (cmd == FIOC_MMAP_UNPIN) {
+			DEBUGASSERT(tfo->tfo_maps > 0);
+			tfo->tfo_maps--;
+		} else if (tfo->tfo_maps < UINT8_MAX) {
+			tfo->tfo_maps++;
+		} else {
+			ret = -EMFILE;
+		}
+		tmpfs_unlock_file(tfo);
+		return ret;
+	}
+
 	fdbg("ERROR: Invalid cmd: %d\n", cmd);
 	return -ENOTTY;
 }
@@ -2055,6 +2086,13 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 	}
 	DEBUGASSERT(tfo != NULL);
 
+	/* A mapped file cannot be removed until it is unmapped */
+
+	if (tfo->tfo_maps > 0) {
+		ret = -EBUSY;
+		goto errout_with_objects;
+	}
+
 	/* Get the file name from the relative path */
 
 	name = strrchr(relpath, '/');
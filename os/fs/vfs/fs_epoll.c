@@ -0,0 +1,782 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <queue.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/cancelpt.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/sched.h>
+#include <tinyara/semaphore.h>
+#include <tinyara/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_EPOLL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Events that are handed to the drivers.  Errors and hang-ups are always
+ * reported, as with poll().
+ */
+
+#define EPOLL_POLLEVENTS  (POLLIN | POLLOUT)
+#define EPOLL_ALWAYS      (POLLERR | POLLHUP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One registered descriptor.  The pollfd stays set up in the driver or
+ * network stack for as long as the descriptor is registered, so a ready
+ * descriptor is found by looking at revents only.  The registration is
+ * dropped when the descriptor is closed: a file is recognized by its
+ * struct file, a socket by its number in the registering task group.
+ */
+
+struct epoll_entry_s {
+	dq_entry_t link;			/* Supports a doubly linked list */
+	uint32_t events;			/* Events requested with epoll_ctl() */
+	epoll_data_t data;			/* User data returned by epoll_wait() */
+	struct pollfd pfd;			/* Poll state shared with the driver */
+	FAR struct file *filep;		/* File of pfd.fd, NULL for a socket */
+	FAR struct task_group_s *group;	/* Task group that registered pfd.fd */
+	bool armed;					/* True: pfd is set up in the driver */
+};
+
+/* The state of one epoll instance.  It is the i_private data of an
+ * unnamed inode so that it can be referenced by a file descriptor.
+ */
+
+struct epoll_head_s {
+	dq_entry_t link;			/* Links all epoll instances */
+	sem_t exclsem;				/* Protects the list of entries */
+	sem_t waitsem;				/* Posted by the drivers when an event occurs */
+	dq_queue_t entries;			/* List of struct epoll_entry_s */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int epoll_close(FAR struct file *filep);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All epoll instances, so that the registrations of a descriptor can be
+ * found when it is closed.
+ */
+
+static dq_queue_t g_epoll_heads;
+static sem_t g_epoll_sem = SEM_INITIALIZER(1);
+
+static const struct file_operations g_epoll_fops = {
+	0,							/* open */
+	epoll_close,				/* close */
+	0,							/* read */
+	0,							/* write */
+	0,							/* seek */
+	0,							/* ioctl */
+#ifndef CONFIG_DISABLE_POLL
+	0,							/* poll */
+#endif
+	0							/* unlink */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR struct epoll_head_s *eph)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(&eph->exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define epoll_semgive(eph) sem_post(&(eph)->exclsem)
+
+/****************************************************************************
+ * Name: epoll_listtake
+ ****************************************************************************/
+
+static void epoll_listtake(void)
+{
+	while (sem_wait(&g_epoll_sem) != 0) {
+		ASSERT(get_errno() == EINTR);
+	}
+}
+
+#define epoll_listgive() sem_post(&g_epoll_sem)
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Set up or tear down the poll of one entry.  Files are reached through
+ *   their struct file, so that this works from any task, including one
+ *   closing the files of an exiting task group.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(FAR struct epoll_entry_s *ent, bool setup)
+{
+	if (ent->filep != NULL) {
+		return file_poll(ent->filep, &ent->pfd, setup);
+	}
+
+	return poll_fdsetup(ent->pfd.fd, &ent->pfd, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the poll on the descriptor of one entry.  Events that are
+ *   already pending are reported in pfd.revents right away.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_head_s *eph, FAR struct epoll_entry_s *ent)
+{
+	int ret;
+
+	ent->pfd.sem = &eph->waitsem;
+	ent->pfd.events = (pollevent_t)(ent->events & EPOLL_POLLEVENTS) | EPOLL_ALWAYS;
+	ent->pfd.revents = 0;
+	ent->pfd.priv = NULL;
+	ent->pfd.filep = NULL;
+
+	ret = epoll_fdsetup(ent, true);
+	ent->armed = (ret >= 0);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_entry_s *ent)
+{
+	if (ent->armed) {
+		(void)epoll_fdsetup(ent, false);
+		ent->armed = false;
+	}
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_entry_s *epoll_find(FAR struct epoll_head_s *eph, int fd)
+{
+	FAR struct epoll_entry_s *ent;
+
+	for (ent = (FAR struct epoll_entry_s *)dq_peek(&eph->entries); ent; ent = (FAR struct epoll_entry_s *)dq_next(&ent->link)) {
+		if (ent->pfd.fd == fd) {
+			return ent;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: epoll_gethead
+ *
+ * Description:
+ *   Return the epoll instance referred to by a file descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_gethead(int epfd, FAR struct epoll_head_s **eph)
+{
+	FAR struct file *filep;
+	int ret;
+
+	if ((unsigned int)epfd >= CONFIG_NFILE_DESCRIPTORS) {
+		return -EBADF;
+	}
+
+	ret = fs_getfilep(epfd, &filep);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (filep->f_inode == NULL || filep->f_inode->u.i_ops != &g_epoll_fops) {
+		return -EINVAL;
+	}
+
+	*eph = (FAR struct epoll_head_s *)filep->f_inode->i_private;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_checkfd
+ *
+ * Description:
+ *   Verify that a descriptor can be registered.  Regular files and block
+ *   devices are always ready and epoll instances cannot be nested.  The
+ *   file of the descriptor is returned in 'filep', NULL for a socket.
+ *
+ ****************************************************************************/
+
+static int epoll_checkfd(int fd, FAR struct file **filepp)
+{
+	FAR struct file *filep;
+	FAR struct inode *inode;
+	int ret;
+
+	*filepp = NULL;
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+		/* Sockets are checked by their network stack */
+
+		return OK;
+	}
+
+	ret = fs_getfilep(fd, &filep);
+	if (ret < 0) {
+		return ret;
+	}
+
+	inode = filep->f_inode;
+	if (inode == NULL) {
+		return -EBADF;
+	}
+
+	if (INODE_IS_MOUNTPT(inode) || INODE_IS_BLOCK(inode)) {
+		return -EPERM;
+	}
+
+	if (inode->u.i_ops == &g_epoll_fops) {
+		return -EINVAL;
+	}
+
+	*filepp = filep;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: epoll_collect
+ *
+ * Description:
+ *   Return the ready entries of an epoll instance.  Each reported entry is
+ *   torn down to obtain its final events and then set up again, which
+ *   reports it again on the next call if it is still ready (level
+ *   triggered).  For EPOLLET the state reported by that setup is dropped,
+ *   so the entry is only reported again when the driver signals a new
+ *   event (edge triggered).  Reported entries move to the end of the list
+ *   so that a busy descriptor cannot starve the others when maxevents is
+ *   small.
+ *
+ *   The caller holds exclsem.
+ *
+ ****************************************************************************/
+
+static int epoll_collect(FAR struct epoll_head_s *eph, FAR struct epoll_event *events, int maxevents)
+{
+	FAR struct epoll_entry_s *ent;
+	FAR struct epoll_entry_s *next;
+	FAR struct epoll_entry_s *tail;
+	pollevent_t revents;
+	int nevents = 0;
+
+	tail = (FAR struct epoll_entry_s *)dq_tail(&eph->entries);
+	for (ent = (FAR struct epoll_entry_s *)dq_peek(&eph->entries); ent != NULL && nevents < maxevents; ent = next) {
+		next = (ent == tail) ? NULL : (FAR struct epoll_entry_s *)dq_next(&ent->link);
+
+		if (!ent->armed || ent->pfd.revents == 0) {
+			continue;
+		}
+
+		(void)epoll_fdsetup(ent, false);
+		revents = ent->pfd.revents & ent->pfd.events;
+		ent->armed = false;
+
+		if (revents != 0) {
+			events[nevents].events = revents;
+			events[nevents].data = ent->data;
+			nevents++;
+		}
+
+		if ((ent->events & EPOLLONESHOT) == 0 || revents == 0) {
+			if (epoll_arm(eph, ent) < 0) {
+				fdbg("ERROR: Failed to re-arm fd %d\n", ent->pfd.fd);
+			} else if ((ent->events & EPOLLET) != 0 && revents != 0) {
+				/* The caller is about to be told and must drain the
+				 * descriptor, so what is pending now is not a new edge.
+				 */
+
+				ent->pfd.revents = 0;
+			}
+		}
+
+		dq_rem(&ent->link, &eph->entries);
+		dq_addlast(&ent->link, &eph->entries);
+	}
+
+	return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_close
+ *
+ * Description:
+ *   Called when a descriptor of the epoll instance is closed.  All
+ *   registrations are removed when the last descriptor goes away; the
+ *   unnamed inode itself is freed by inode_release().
+ *
+ ****************************************************************************/
+
+static int epoll_close(FAR struct file *filep)
+{
+	FAR struct inode *inode = filep->f_inode;
+	FAR struct epoll_head_s *eph;
+	FAR struct epoll_entry_s *ent;
+	bool last;
+
+	DEBUGASSERT(inode != NULL && inode->i_private != NULL);
+	eph = (FAR struct epoll_head_s *)inode->i_private;
+
+	inode_semtake();
+	last = (inode->i_crefs <= 1);
+	inode_semgive();
+
+	if (!last) {
+		return OK;
+	}
+
+	epoll_listtake();
+	dq_rem(&eph->link, &g_epoll_heads);
+	epoll_listgive();
+
+	while ((ent = (FAR struct epoll_entry_s *)dq_remfirst(&eph->entries)) != NULL) {
+		epoll_disarm(ent);
+		kmm_free(ent);
+	}
+
+	sem_destroy(&eph->waitsem);
+	sem_destroy(&eph->exclsem);
+	kmm_free(eph);
+	inode->i_private = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_create1
+ *
+ * Description:
+ *   Create an epoll instance.  See include/sys/epoll.h.
+ *
+ ****************************************************************************/
+
+int epoll_create1(int flags)
+{
+	FAR struct epoll_head_s *eph;
+	FAR struct inode *inode;
+	int ret;
+	int fd;
+
+	if ((flags & ~EPOLL_CLOEXEC) != 0) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+	if (eph == NULL) {
+		ret = -ENOMEM;
+		goto errout;
+	}
+
+	/* The inode has no name and is never linked into the tree.  Marking it
+	 * deleted lets inode_release() free it with the last reference.
+	 */
+
+	inode = (FAR struct inode *)kmm_zalloc(sizeof(struct inode));
+	if (inode == NULL) {
+		ret = -ENOMEM;
+		goto errout_with_eph;
+	}
+
+	inode->i_crefs = 1;
+	inode->i_flags = FSNODEFLAG_TYPE_DRIVER | FSNODEFLAG_DELETED;
+	inode->u.i_ops = &g_epoll_fops;
+	inode->i_private = eph;
+
+	sem_init(&eph->exclsem, 0, 1);
+	sem_init(&eph->waitsem, 0, 0);
+	sem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+	dq_init(&eph->entries);
+
+	epoll_listtake();
+	dq_addlast(&eph->link, &g_epoll_heads);
+	epoll_listgive();
+
+	fd = files_allocate(inode, O_RDOK, 0, 0);
+	if (fd < 0) {
+		ret = -EMFILE;
+		goto errout_with_list;
+	}
+
+	return fd;
+
+errout_with_list:
+	epoll_listtake();
+	dq_rem(&eph->link, &g_epoll_heads);
+	epoll_listgive();
+
+	sem_destroy(&eph->waitsem);
+	sem_destroy(&eph->exclsem);
+	kmm_free(inode);
+
+errout_with_eph:
+	kmm_free(eph);
+
+errout:
+	set_errno(-ret);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_create
+ *
+ * Description:
+ *   Create an epoll instance.  See include/sys/epoll.h.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size)
+{
+	if (size <= 0) {
+		set_errno(EINVAL);
+		return ERROR;
+	}
+
+	return epoll_create1(0);
+}
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add, modify or remove a registration.  See include/sys/epoll.h.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 on failure with errno set:
+ *
+ *   EBADF  - epfd or fd is not a valid descriptor.
+ *   EEXIST - op is EPOLL_CTL_ADD and fd is already registered.
+ *   EINVAL - epfd is not an epoll instance, fd is epfd or an epoll
+ *            instance, or op is not valid.
+ *   ENOENT - op is EPOLL_CTL_MOD or EPOLL_CTL_DEL and fd is not registered.
+ *   ENOMEM - There was no memory for the registration.
+ *   EPERM  - fd does not support poll.
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *event)
+{
+	FAR struct epoll_head_s *eph;
+	FAR struct epoll_entry_s *ent;
+	FAR struct file *filep;
+	int ret;
+
+	ret = epoll_gethead(epfd, &eph);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (fd == epfd) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	if (op != EPOLL_CTL_DEL && event == NULL) {
+		ret = -EFAULT;
+		goto errout;
+	}
+
+	epoll_semtake(eph);
+	ent = epoll_find(eph, fd);
+
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		if (ent != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		ret = epoll_checkfd(fd, &filep);
+		if (ret < 0) {
+			break;
+		}
+
+		ent = (FAR struct epoll_entry_s *)kmm_zalloc(sizeof(struct epoll_entry_s));
+		if (ent == NULL) {
+			ret = -ENOMEM;
+			break;
+		}
+
+		ent->pfd.fd = fd;
+		ent->filep = filep;
+		ent->group = sched_self()->group;
+		ent->events = event->events;
+		ent->data = event->data;
+
+		ret = epoll_arm(eph, ent);
+		if (ret < 0) {
+			kmm_free(ent);
+			break;
+		}
+
+		dq_addlast(&ent->link, &eph->entries);
+		break;
+
+	case EPOLL_CTL_MOD:
+		if (ent == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_disarm(ent);
+		ent->events = event->events;
+		ent->data = event->data;
+		ret = epoll_arm(eph, ent);
+		break;
+
+	case EPOLL_CTL_DEL:
+		if (ent == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_disarm(ent);
+		dq_rem(&ent->link, &eph->entries);
+		kmm_free(ent);
+		ret = OK;
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	epoll_semgive(eph);
+
+	if (ret < 0) {
+		/* Descriptors whose driver or stack has no poll method cannot be
+		 * waited on.
+		 */
+
+		if (ret == -ENOSYS) {
+			ret = -EPERM;
+		}
+
+		goto errout;
+	}
+
+	return OK;
+
+errout:
+	set_errno(-ret);
+	return ERROR;
+}
+
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   Remove the registrations of a descriptor that is being closed from
+ *   every epoll instance.  See include/tinyara/fs/fs.h.
+ *
+ ****************************************************************************/
+
+void epoll_fdclose(int fd, FAR struct file *filep)
+{
+	FAR struct task_group_s *group = NULL;
+	FAR struct epoll_head_s *eph;
+	FAR struct epoll_entry_s *ent;
+	FAR struct epoll_entry_s *next;
+
+	if (filep == NULL) {
+		group = sched_self()->group;
+	}
+
+	epoll_listtake();
+	for (eph = (FAR struct epoll_head_s *)dq_peek(&g_epoll_heads); eph; eph = (FAR struct epoll_head_s *)dq_next(&eph->link)) {
+		epoll_semtake(eph);
+		for (ent = (FAR struct epoll_entry_s *)dq_peek(&eph->entries); ent; ent = next) {
+			next = (FAR struct epoll_entry_s *)dq_next(&ent->link);
+
+			if (filep != NULL) {
+				if (ent->filep != filep) {
+					continue;
+				}
+			} else if (ent->filep != NULL || ent->pfd.fd != fd || ent->group != group) {
+				continue;
+			}
+
+			epoll_disarm(ent);
+			dq_rem(&ent->link, &eph->entries);
+			kmm_free(ent);
+		}
+
+		epoll_semgive(eph);
+	}
+
+	epoll_listgive();
+}
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait for events on an epoll instance.  See include/sys/epoll.h.
+ *
+ *   Only the registered entries are examined, and only their revents: the
+ *   drivers and network stacks are not called for descriptors that are
+ *   not ready.
+ *
+ * Returned Value:
+ *   The number of ready descriptors, zero on timeout, or -1 with errno set:
+ *
+ *   EBADF  - epfd is not a valid descriptor.
+ *   EINTR  - A signal occurred before any requested event.
+ *   EINVAL - epfd is not an epoll instance or maxevents is not positive.
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout)
+{
+	FAR struct epoll_head_s *eph;
+	struct timespec abstime;
+	int nevents;
+	int ret;
+
+	/* epoll_wait() is a cancellation point */
+
+	(void)enter_cancellation_point();
+
+	ret = epoll_gethead(epfd, &eph);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	if (maxevents <= 0 || events == NULL) {
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	if (timeout > 0) {
+		(void)clock_gettime(CLOCK_REALTIME, &abstime);
+
+		abstime.tv_sec += timeout / MSEC_PER_SEC;
+		abstime.tv_nsec += (timeout % MSEC_PER_SEC) * NSEC_PER_MSEC;
+		if (abstime.tv_nsec >= NSEC_PER_SEC) {
+			abstime.tv_sec++;
+			abstime.tv_nsec -= NSEC_PER_SEC;
+		}
+	}
+
+	for (;;) {
+		/* Consume the posts of events that are about to be collected.  Any
+		 * event after this point either shows up in the scan below or posts
+		 * the semaphore again.
+		 */
+
+		while (sem_trywait(&eph->waitsem) == 0) {
+		}
+
+		epoll_semtake(eph);
+		nevents = epoll_collect(eph, events, maxevents);
+		epoll_semgive(eph);
+
+		if (nevents > 0 || timeout == 0) {
+			break;
+		}
+
+		if (timeout > 0) {
+			ret = sem_timedwait(&eph->waitsem, &abstime);
+		} else {
+			ret = sem_wait(&eph->waitsem);
+		}
+
+		if (ret < 0) {
+			ret = get_errno();
+			if (ret == ETIMEDOUT) {
+				/* Pick up an event that raced with the timeout */
+
+				epoll_semtake(eph);
+				nevents = epoll_collect(eph, events, maxevents);
+				epoll_semgive(eph);
+				break;
+			}
+
+			/* EINTR is the only other error expected in normal operation */
+
+			ret = -ret;
+			goto errout;
+		}
+	}
+
+	leave_cancellation_point();
+	return nevents;
+
+errout:
+	leave_cancellation_point();
+	set_errno(-ret);
+	return ERROR;
+}
+
+#endif /* CONFIG_FS_EPOLL */
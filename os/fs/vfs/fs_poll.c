@@ -72,6 +72,9 @@
 #ifdef CONFIG_NET_LWIP
 #include "lwip/sockets.h"
 #endif
+#ifdef CONFIG_NET_NETMGR
+#include <tinyara/net/net.h>
+#endif
 
 #include <arch/irq.h>
 
@@ -111,40 +114,6 @@ static int poll_semtake(FAR sem_t *sem)
 	return OK;
 }
 
-/****************************************************************************
- * Name: poll_fdsetup
- *
- * Description:
- *   Configure (or unconfigure) one file/socket descriptor for the poll
- *   operation.  If fds and sem are non-null, then the poll is being setup.
- *   if fds and sem are NULL, then the poll is being torn down.
- *
- ****************************************************************************/
-
-#if CONFIG_NFILE_DESCRIPTORS > 0
-static int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
-{
-	/* Check for a valid file descriptor */
-
-	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
-		/* Perform the socket ioctl */
-
-#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
-		if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)) {
-#ifdef CONFIG_NET_LWIP
-			return lwip_poll(fd, fds, setup);
-#endif
-		} else
-#endif
-		{
-			return -EBADF;
-		}
-	}
-
-	return fdesc_poll(fd, fds, setup);
-}
-#endif
-
 /****************************************************************************
  * Name: poll_setup
  *
@@ -352,6 +321,54 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 	return file_poll(filep, fds, setup);
 }
 
+/****************************************************************************
+ * Name: poll_fdsetup
+ *
+ * Description:
+ *   Configure (or unconfigure) one file/socket descriptor for the poll
+ *   operation.  This is used by poll() on every call and by epoll when a
+ *   descriptor is registered, re-armed or removed.
+ *
+ * Input Parameters:
+ *   fd    - The file or socket descriptor of interest
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  Zero (OK) is returned on success; a negated errno value is returned on
+ *  any failure.  -ENOSYS is returned if the driver or the network stack
+ *  owning the descriptor does not support poll.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+{
+	/* Check for a valid file descriptor */
+
+	if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS) {
+		/* Perform the socket ioctl */
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+		if ((unsigned int)fd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS)) {
+#if defined(CONFIG_NET_NETMGR)
+			return net_poll(fd, fds, setup);
+#elif defined(CONFIG_NET_LWIP)
+			return lwip_poll(fd, fds, setup);
+#else
+			return -ENOSYS;
+#endif
+		} else
+#endif
+		{
+			return -EBADF;
+		}
+	}
+
+	return fdesc_poll(fd, fds, setup);
+}
+#endif
+
 /****************************************************************************
  * Name: poll
  *
@@ -0,0 +1,150 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/sendfile.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/net/net.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_NET_SENDFILE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_xipbase
+ *
+ * Description:
+ *   Return the address and size of the data of a file that lives in
+ *   memory-mapped, read-only media.  Such data can be handed to a network
+ *   stack by reference: it cannot change or go away while the stack still
+ *   holds it.  Only ROMFS with an XIP base address qualifies.
+ *
+ * Input Parameters:
+ *   filep - The open file
+ *   base  - Location to return the address of the first byte of the file
+ *   size  - Location to return the size of the file
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the file data is not
+ *   directly addressable.
+ *
+ ****************************************************************************/
+
+int file_xipbase(FAR struct file *filep, FAR const uint8_t **base, FAR off_t *size)
+{
+	FAR struct inode *inode;
+	struct statfs fsbuf;
+	struct stat buf;
+	FAR void *addr;
+	int ret;
+
+	DEBUGASSERT(filep != NULL && base != NULL && size != NULL);
+
+	inode = filep->f_inode;
+	if (inode == NULL || !INODE_IS_MOUNTPT(inode) || inode->u.i_mops->statfs == NULL || inode->u.i_mops->fstat == NULL) {
+		return -ENOSYS;
+	}
+
+	ret = inode->u.i_mops->statfs(inode, &fsbuf);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (fsbuf.f_type != ROMFS_MAGIC) {
+		return -ENOSYS;
+	}
+
+	/* ROMFS answers FIOC_MMAP only when the image is directly addressable */
+
+	ret = file_ioctl(filep, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = inode->u.i_mops->fstat(filep, &buf);
+	if (ret < 0) {
+		return ret;
+	}
+
+	*base = (FAR const uint8_t *)addr;
+	*size = buf.st_size;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: sendfile
+ *
+ * Description:
+ *   sendfile() copies data between one file descriptor and another.  When
+ *   'outfd' is a socket and 'infd' is a file, the transfer is performed by
+ *   the network stack owning the socket so that the file data never passes
+ *   through a user buffer.  All other combinations, and sockets whose stack
+ *   has no sendfile support, fall back to the C library read/write loop.
+ *
+ *   See include/sys/sendfile.h for the full description of the interface.
+ *
+ ****************************************************************************/
+
+ssize_t sendfile(int outfd, int infd, FAR off_t *offset, size_t count)
+{
+	FAR struct file *filep;
+	ssize_t ret;
+
+	if ((unsigned int)outfd >= CONFIG_NFILE_DESCRIPTORS && (unsigned int)infd < CONFIG_NFILE_DESCRIPTORS) {
+		ret = fs_getfilep(infd, &filep);
+		if (ret < 0) {
+			set_errno(-ret);
+			return ERROR;
+		}
+
+		if ((filep->f_oflags & O_RDOK) == 0) {
+			set_errno(EBADF);
+			return ERROR;
+		}
+
+		ret = net_sendfile(outfd, filep, offset, count);
+		if (ret >= 0 || get_errno() != ENOSYS) {
+			return ret;
+		}
+
+		fvdbg("No stack sendfile for fd %d, using read/write loop\n", outfd);
+	}
+
+	return lib_sendfile(outfd, infd, offset, count);
+}
+
+#endif /* CONFIG_NET_SENDFILE */
@@ -146,7 +146,7 @@ struct aiocb {
 #else
 	int8_t aio_fildes;			/* File descriptor (should be int) */
 #endif
-	int8_t aio_reqprio;			/* Request priority offset (not used, should be int) */
+	int8_t aio_reqprio;			/* Request priority offset (should be int) */
 	uint8_t aio_lio_opcode;		/* Operation to be performed (should be int) */
 
 	/* Non-standard, implementation-dependent data.  For portability reasons,
@@ -0,0 +1,70 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @addtogroup CRC_KERNEL
+ * @{
+ */
+///@file chksum.h
+///@brief 16-bit one's complement checksum APIs
+
+#ifndef __INCLUDE_CHKSUM_H
+#define __INCLUDE_CHKSUM_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/**
+ * @brief  Return the 16-bit one's complement sum of the 'src' buffer, length 'len'
+ *
+ * @details @b #include <chksum.h>
+ * The buffer may start at any address.  The sum is not inverted and is in
+ * host byte order, as for lwIP's LWIP_CHKSUM (RFC 1071): the Internet
+ * checksum of the buffer is ~chksum16(src, len) stored in host byte order.
+ * @param[in] src start of the data to be summed
+ * @param[in] len number of bytes to sum
+ * @return The folded 16-bit sum.
+ * @since TizenRT v2.1 PRE
+ */
+
+uint16_t chksum16(FAR const void *src, size_t len);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __INCLUDE_CHKSUM_H */
+
+/**
+ * @}
+ */
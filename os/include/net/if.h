@@ -242,6 +242,22 @@ struct ifconf {
 #define ifc_buf	ifc_ifcu.ifcu_buf	/* Buffer address.  */
 #define ifc_req	ifc_ifcu.ifcu_req	/* Array of structures.  */
 
+#ifdef CONFIG_NET_STATS_PERF
+/* Reasons for a packet to be dropped on a network interface, counted
+ * in struct netif even without the network monitor */
+enum netmon_drop {
+	NETMON_DROP_RX_NOMEM,		/* No buffer for a received frame */
+	NETMON_DROP_RX_QFULL,		/* Stack input queue full */
+	NETMON_DROP_RX_HDR,			/* Truncated or malformed header */
+	NETMON_DROP_RX_CHKSUM,		/* Bad IP header checksum */
+	NETMON_DROP_RX_PROTO,		/* Unknown or unsupported protocol */
+	NETMON_DROP_RX_ADDR,		/* Not addressed to this host */
+	NETMON_DROP_TX_NOBUF,		/* No room for the link header */
+	NETMON_DROP_TX_ERR,			/* Rejected by the driver */
+	NETMON_DROP_MAX,
+};
+#endif
+
 #ifdef CONFIG_NET_NETMON
 /* This is Network monitor request */
 enum netmon_proto {
@@ -275,6 +291,15 @@ struct netmon_sock {
 	} remote;
 	pid_t pid;
 	char  pid_name[CONFIG_TASK_NAME_SIZE];
+#ifdef CONFIG_NET_STATS_PERF
+	u32_t rtt;					/* Smoothed RTT in milliseconds (TCP) */
+	u32_t cwnd;					/* Congestion window in bytes (TCP) */
+	u32_t rexmits;				/* Segments retransmitted by fast recovery (TCP) */
+	u32_t rtos;					/* Retransmission timeouts (TCP) */
+	u32_t recvq;				/* Bytes queued and not read yet */
+	u32_t recvq_hwm;			/* Highest number of bytes queued */
+	u32_t recvq_drops;			/* Datagrams dropped on a full receive queue */
+#endif
 };
 #ifdef CONFIG_NET_STATS
 /* Netdev info. */
@@ -284,6 +309,9 @@ struct netmon_netdev_stats {
 	u32_t devinoctets;
 	u32_t devoutpkts;
 	u32_t devoutoctets;
+#ifdef CONFIG_NET_STATS_PERF
+	u32_t devdrops[NETMON_DROP_MAX];
+#endif
 };
 #endif								/* CONFIG_NET_STATS */
 #endif                              /* CONFIG_NET_NETMON */
@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_EPOLL_H
+#define __INCLUDE_SYS_EPOLL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <poll.h>
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Event definitions.  The low bits are the poll() events so that they can
+ * be handed to the drivers unchanged.
+ *
+ *   EPOLLONESHOT
+ *     Report the descriptor once, then disable it until it is re-armed
+ *     with EPOLL_CTL_MOD.
+ *   EPOLLET
+ *     Edge triggered: once reported, the descriptor is reported again only
+ *     after the driver or network stack signals a new event, such as more
+ *     data arriving.  The caller must read or write until EAGAIN.  Without
+ *     it, a descriptor is reported by every epoll_wait() call for as long
+ *     as it stays ready.
+ */
+
+#define EPOLLIN         POLLIN
+#define EPOLLPRI        POLLPRI
+#define EPOLLOUT        POLLOUT
+#define EPOLLRDNORM     POLLRDNORM
+#define EPOLLWRNORM     POLLWRNORM
+#define EPOLLERR        POLLERR
+#define EPOLLHUP        POLLHUP
+#define EPOLLONESHOT    (1u << 30)
+#define EPOLLET         (1u << 31)
+
+/* Valid opcodes for epoll_ctl() */
+
+#define EPOLL_CTL_ADD   1		/* Register a descriptor */
+#define EPOLL_CTL_DEL   2		/* Remove a registered descriptor */
+#define EPOLL_CTL_MOD   3		/* Change the events of a registered descriptor */
+
+/* Flags for epoll_create1().  TinyAra has no exec(), so EPOLL_CLOEXEC is
+ * accepted and ignored.
+ */
+
+#define EPOLL_CLOEXEC   0x80000
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+typedef union epoll_data {
+	FAR void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;			/* Epoll events */
+	epoll_data_t data;			/* User data, returned unchanged */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: epoll_create, epoll_create1
+ *
+ * Description:
+ *   Create an epoll instance and return a file descriptor referring to it.
+ *   The descriptor is released with close().  'size' is ignored but must
+ *   be greater than zero; 'flags' may be zero or EPOLL_CLOEXEC.
+ *
+ ****************************************************************************/
+
+int epoll_create(int size);
+int epoll_create1(int flags);
+
+/****************************************************************************
+ * Name: epoll_ctl
+ *
+ * Description:
+ *   Add, modify or remove the registration of 'fd' in the epoll instance
+ *   'epfd'.  The registration persists across epoll_wait() calls, so the
+ *   driver or network stack is set up once rather than on every wait.
+ *
+ *   Closing a descriptor removes it from every epoll instance, so a new
+ *   descriptor that reuses the number starts without a registration.
+ *   Regular files and block devices cannot be registered (EPERM), nor can
+ *   descriptors whose driver or network stack does not support poll.
+ *
+ ****************************************************************************/
+
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *event);
+
+/****************************************************************************
+ * Name: epoll_wait
+ *
+ * Description:
+ *   Wait for events on the epoll instance 'epfd'.  Up to 'maxevents' ready
+ *   descriptors are returned in 'events'.  'timeout' is in milliseconds;
+ *   a negative value waits forever and zero returns immediately.
+ *
+ * Returned Value:
+ *   The number of ready descriptors, zero on timeout, or -1 with errno set.
+ *
+ ****************************************************************************/
+
+int epoll_wait(int epfd, FAR struct epoll_event *events, int maxevents, int timeout);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif							/* __INCLUDE_SYS_EPOLL_H */
@@ -182,7 +182,7 @@ int msync(FAR void *addr, size_t len, int flags);
 int munlock(FAR const void *addr, size_t len);
 int munlockall(void);
 
-#ifdef CONFIG_FS_RAMMAP
+#ifdef CONFIG_FS_MMAP
 int munmap(FAR void *start, size_t length);
 #else
 #define munmap(start, length)
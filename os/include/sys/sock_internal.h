@@ -104,6 +104,7 @@
 #define MSG_ERRQUEUE   0x2000	/* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000	/* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000	/* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000	/* recvmmsg: wait for the first message only.  */
 
 /* Socket options */
 
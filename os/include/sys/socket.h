@@ -152,6 +152,11 @@ struct msghdr {
 	int msg_flags;                 /* flags on received message */
 };
 
+struct mmsghdr {
+	struct msghdr msg_hdr;         /* message header */
+	unsigned int msg_len;          /* number of bytes transmitted */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -373,6 +378,110 @@ int getpeername(int s, struct sockaddr *name, socklen_t *namelen);
 ssize_t recvmsg(int sockfd, struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags);
 
+struct timespec;
+
+/**
+* @brief  receive multiple messages from a socket
+*
+* @details @b #include <sys/socket.h>\n
+* The first message is waited for as in recvmsg(). After it, only messages
+* that are already queued are returned, as with MSG_WAITFORONE. Each message
+* is received into the first entry of its msg_iov.
+* @param[in] sockfd the file descriptor associated with the socket
+* @param[inout] msgvec array of messages; msg_len receives the number of bytes of each
+* @param[in] vlen number of entries in msgvec
+* @param[in] flags receive flags
+* @param[in] timeout NULL to wait as recvmsg() does, otherwise the longest time to wait for the first message
+* @return On success, the number of messages received. On failure, -1 is returned and errno is set.
+* @since TizenRT v2.1 PRE
+*/
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags, FAR struct timespec *timeout);
+
+/**
+* @brief  send multiple messages on a socket
+*
+* @details @b #include <sys/socket.h>\n
+* Datagrams are handed to the network stack in batches rather than one
+* call per message.
+* @param[in] sockfd the file descriptor associated with the socket
+* @param[inout] msgvec array of messages; msg_len receives the number of bytes sent for each
+* @param[in] vlen number of entries in msgvec
+* @param[in] flags send flags
+* @return On success, the number of messages sent, which is less than vlen if one failed. On failure of the first message, -1 is returned and errno is set.
+* @since TizenRT v2.1 PRE
+*/
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen, int flags);
+
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+/**
+* @brief  completion callback of sendmsg_zc()
+*
+* @details Called once when the network stack no longer references the
+* buffers of a sendmsg_zc() call. For TCP this is when the remote side has
+* acknowledged the data. The callback runs in the network thread, possibly
+* before sendmsg_zc() returns, and must not block.
+* @param[in] arg the argument passed to sendmsg_zc()
+* @param[in] result 0 on success, or a negated errno when the data could not
+* be delivered (for example -ECONNABORTED if the socket was closed first).
+* @since TizenRT v2.1 PRE
+*/
+typedef void (*sendmsg_zc_done_t)(FAR void *arg, int result);
+
+/**
+* @brief  receive a message without copying it
+*
+* @details @b #include <sys/socket.h>\n
+* TizenRT extension. The received data is lent to the caller: msg_iov is
+* filled with pointers into the network buffers of a single received
+* datagram (or TCP segment chain) and msg_iovlen is set to the number of
+* entries used. The buffers must be returned with recvmsg_zc_release()
+* and count against the network buffer pool until then.
+* If msg_iovlen is too small, -1 is returned with errno set to EMSGSIZE,
+* msg_iovlen is set to the number of entries needed and the data stays
+* queued. MSG_PEEK is not supported.
+* @param[in] sockfd the file descriptor associated with the socket
+* @param[inout] msg message header; msg_name receives the source address
+* @param[in] flags MSG_DONTWAIT or 0
+* @param[out] zcbuf handle to pass to recvmsg_zc_release()
+* @return On success, the number of bytes lent (0 on end of stream, with
+* no handle). On failure, -1 is returned and errno is set.
+* @since TizenRT v2.1 PRE
+*/
+ssize_t recvmsg_zc(int sockfd, FAR struct msghdr *msg, int flags, FAR void **zcbuf);
+
+/**
+* @brief  release buffers lent by recvmsg_zc()
+*
+* @details @b #include <sys/socket.h>\n
+* TizenRT extension.
+* @param[in] zcbuf handle returned by recvmsg_zc()
+* @return On success, 0 is returned. On failure, -1 is returned.
+* @since TizenRT v2.1 PRE
+*/
+int recvmsg_zc_release(FAR void *zcbuf);
+
+/**
+* @brief  send a message from caller-owned buffers without copying it
+*
+* @details @b #include <sys/socket.h>\n
+* TizenRT extension. The data in msg_iov is referenced by the network stack
+* instead of being copied and must not be modified or freed until done is
+* called. done is called exactly once if and only if sendmsg_zc() returns a
+* non-negative value. Closing a TCP socket while data is unacknowledged
+* resets the connection and fails the pending completions.
+* @param[in] sockfd the file descriptor associated with the socket
+* @param[in] msg message header; msg_name is the destination of a datagram
+* @param[in] flags MSG_DONTWAIT or 0
+* @param[in] done completion callback
+* @param[in] arg argument of the completion callback
+* @return On success, the number of bytes queued, which can be less than
+* requested for a non-blocking TCP socket. On failure, -1 is returned and
+* errno is set.
+* @since TizenRT v2.1 PRE
+*/
+ssize_t sendmsg_zc(int sockfd, FAR const struct msghdr *msg, int flags, sendmsg_zc_done_t done, FAR void *arg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -289,7 +289,15 @@
 #ifndef CONFIG_DISABLE_POLL
 #define SYS_poll                       __SYS_poll
 #define SYS_select                     (__SYS_poll + 1)
+#ifdef CONFIG_FS_EPOLL
+#define SYS_epoll_create               (__SYS_poll + 2)
+#define SYS_epoll_create1              (__SYS_poll + 3)
+#define SYS_epoll_ctl                  (__SYS_poll + 4)
+#define SYS_epoll_wait                 (__SYS_poll + 5)
+#define __SYS_boardctl                 (__SYS_poll + 6)
+#else
 #define __SYS_boardctl                 (__SYS_poll + 2)
+#endif
 #else
 #define __SYS_boardctl                 __SYS_poll
 #endif
@@ -321,14 +329,20 @@
 #else
 #define __SYS_mmap                     (__SYS_filedesc + 7)
 #endif
+#if defined(CONFIG_FS_MMAP)
 #define SYS_mmap                       (__SYS_mmap + 0)
-#define SYS_open                       (__SYS_mmap + 1)
-#define SYS_opendir                    (__SYS_mmap + 2)
+#define SYS_munmap                     (__SYS_mmap + 1)
+#define __SYS_open                     (__SYS_mmap + 2)
+#else
+#define __SYS_open                     __SYS_mmap
+#endif
+#define SYS_open                       (__SYS_open + 0)
+#define SYS_opendir                    (__SYS_open + 1)
 #if defined(CONFIG_PIPES)
-#define SYS_pipe                       (__SYS_mmap + 3)
-#define __SYS_readdir                  (__SYS_mmap + 4)
+#define SYS_pipe                       (__SYS_open + 2)
+#define __SYS_readdir                  (__SYS_open + 3)
 #else
-#define __SYS_readdir                  (__SYS_mmap + 3)
+#define __SYS_readdir                  (__SYS_open + 2)
 #endif
 #define SYS_readdir                    (__SYS_readdir + 0)
 #define SYS_rewinddir                  (__SYS_readdir + 1)
@@ -471,7 +485,14 @@
 #define SYS_setsockopt                 (__SYS_network + 12)
 #define SYS_shutdown                   (__SYS_network + 13)
 #define SYS_socket                     (__SYS_network + 14)
-#define SYS_nnetsocket                 (__SYS_network + 15)
+#define SYS_recvmmsg                   (__SYS_network + 15)
+#define SYS_sendmmsg                   (__SYS_network + 16)
+#ifdef CONFIG_NET_SENDFILE
+#define SYS_sendfile                   (__SYS_network + 17)
+#define SYS_nnetsocket                 (__SYS_network + 18)
+#else
+#define SYS_nnetsocket                 (__SYS_network + 17)
+#endif
 #else
 #define SYS_nnetsocket                 __SYS_network
 #endif
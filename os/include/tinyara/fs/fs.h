@@ -390,6 +390,22 @@ extern "C" {
 
 void fs_initialize(void);
 
+#ifdef CONFIG_FS_AIO_WORKERS
+/****************************************************************************
+ * Name: aio_start
+ *
+ * Description:
+ *   Start the AIO worker threads.  This is called from the OS bring-up
+ *   logic, once kernel threads can be created.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_start(void);
+#endif
+
 /****************************************************************************
  * Name: fs_auto_mount
  *
@@ -550,6 +566,50 @@ void files_releaselist(FAR struct filelist *list);
 int file_dup2(FAR struct file *filep1, FAR struct file *filep2);
 #endif
 
+/* fs_sendfile.c ************************************************************/
+/****************************************************************************
+ * Name: file_xipbase
+ *
+ * Description:
+ *   Return the address and size of the data of a file that lives in
+ *   memory-mapped, read-only media (ROMFS on XIP flash).  Returns a negated
+ *   errno value if the file data is not directly addressable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+int file_xipbase(FAR struct file *filep, FAR const uint8_t **base, FAR off_t *size);
+#endif
+
+/****************************************************************************
+ * Name: lib_sendfile
+ *
+ * Description:
+ *   The C library read/write implementation of sendfile().  The kernel
+ *   sendfile() falls back to it for descriptors the network stack cannot
+ *   handle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+ssize_t lib_sendfile(int outfd, int infd, FAR off_t *offset, size_t count);
+#endif
+
+/* fs_munmap.c **************************************************************/
+/****************************************************************************
+ * Name: mmap_release
+ *
+ * Description:
+ *   Release every file mapping still held by a task group.  Called when the
+ *   final member of the group exits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_MMAP
+struct task_group_s;
+void mmap_release(FAR struct task_group_s *group);
+#endif
+
 /* fs_filedup.c *************************************************************/
 /****************************************************************************
  * Name: fs_dupfd OR dup
@@ -1019,6 +1079,46 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_fdsetup
+ *
+ * Description:
+ *   Set up or tear down the poll operation on a file or socket descriptor.
+ *   This is the common path used by poll(), select() and epoll.
+ *
+ * Input Parameters:
+ *   fd    - The file or socket descriptor of interest
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *  0: Success; Negated errno on failure
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup);
+#endif
+
+/* fs/vfs/fs_epoll.c ********************************************************/
+/****************************************************************************
+ * Name: epoll_fdclose
+ *
+ * Description:
+ *   Remove the epoll registrations of a descriptor that is being closed.
+ *   Called before the file or socket is closed, while its poll state can
+ *   still be torn down.
+ *
+ * Input Parameters:
+ *   fd    - The socket descriptor being closed, ignored for files
+ *   filep - The file being closed, or NULL for a socket descriptor
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_EPOLL
+void epoll_fdclose(int fd, FAR struct file *filep);
+#endif
+
 /* fs/driver/block/fs_blockproxy.c ******************************************/
 /****************************************************************************
  * Name: unique_chardev_initialize
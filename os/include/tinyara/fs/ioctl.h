@@ -160,6 +160,13 @@
 #define FIONWRITE       _FIOC(0x0006)	/* IN:  Location to return value (int *)
 										 * OUT: Bytes writable to this fd
 										 */
+#define FIOC_MMAP_PIN   _FIOC(0x0007)	/* IN:  None
+										 * OUT: None.  The file data must not move
+										 *      until FIOC_MMAP_UNPIN (mmap)
+										 */
+#define FIOC_MMAP_UNPIN _FIOC(0x0008)	/* IN:  None
+										 * OUT: None.  Releases FIOC_MMAP_PIN
+										 */
 
 /* TinyAra file system ioctl definitions **************************************/
 
@@ -339,6 +339,28 @@ void net_releaselist(FAR struct socketlist *list);
 
 int net_close(int sockfd);
 
+/****************************************************************************
+ * Function: net_poll
+ *
+ * Description:
+ *   Set up or tear down the poll operation on a socket descriptor.  This is
+ *   called by poll_fdsetup() for descriptors in the socket range.
+ *
+ * Parameters:
+ *   fd    - Socket descriptor of interest
+ *   fds   - The structure describing the events to be monitored
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POLL
+struct pollfd;
+int net_poll(int fd, FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Function: net_dupsd
  *
@@ -428,6 +450,34 @@ int net_vfcntl(int sockfd, int cmd, va_list ap);
 
 int net_ioctl(int sockfd, int cmd, unsigned long arg);
 
+/****************************************************************************
+ * Name: net_sendfile
+ *
+ * Description:
+ *   Transfer data from an open file to a socket inside the network stack
+ *   that owns the socket.  This is the socket half of sendfile().
+ *
+ * Parameters:
+ *   outfd    Socket descriptor to send on
+ *   infile   The open file to read from
+ *   offset   If not NULL, the file offset to start from; updated to the
+ *            offset following the last byte sent and the file position is
+ *            left untouched.  If NULL, the file position is used and
+ *            advanced.
+ *   count    The number of bytes to transfer
+ *
+ * Return:
+ *   The number of bytes sent on success.  On a failure, -1 is returned
+ *   with errno set appropriately.  ENOSYS means that the stack cannot
+ *   handle this socket and the caller should fall back to a copy loop.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+struct file;
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count);
+#endif
+
 /****************************************************************************
  * Function: netdev_foreach
  *
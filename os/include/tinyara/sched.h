@@ -471,6 +471,12 @@ struct task_group_s {
 	struct filelist tg_filelist;	/* Maps file descriptor to file             */
 #endif
 
+#ifdef CONFIG_FS_MMAP
+	/* Memory-mapped files ******************************************************* */
+
+	sq_queue_t tg_mmapq;		/* List of active file mappings             */
+#endif
+
 #if CONFIG_NFILE_STREAMS > 0
 	/* FILE streams ************************************************************** */
 	/* In a flat, single-heap build.  The stream list is allocated with this
@@ -193,6 +193,12 @@ static inline void group_release(FAR struct task_group_s *group)
 	 * soon as possible while we still have a functioning task.
 	 */
 
+#ifdef CONFIG_FS_MMAP
+	/* Drop the mappings before the files backing them go away */
+
+	mmap_release(group);
+#endif
+
 	/* Free resources held by the file descriptor list */
 
 	files_releaselist(&group->tg_filelist);
@@ -68,6 +68,7 @@
 #include <tinyara/init.h>
 #include <tinyara/kthread.h>
 #include <tinyara/userspace.h>
+#include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 #ifdef CONFIG_SCHED_WORKQUEUE
 #include <tinyara/wqueue.h>
@@ -465,6 +466,12 @@ int os_bringup(void)
 
 	os_workqueues();
 
+#ifdef CONFIG_FS_AIO_WORKERS
+	/* Start the worker threads that perform asynchronous I/O */
+
+	(void)aio_start();
+#endif
+
 #ifdef CONFIG_LOGM
 	logm_start();
 #endif
@@ -91,6 +91,7 @@ struct msg_recv_node_s {
 	struct msg_recv_node_s *flink;
 	pid_t pid;
 	int prio;
+	int epoch;
 };
 typedef struct msg_recv_node_s msg_recv_node_t;
 
@@ -105,6 +106,7 @@ static sem_t port_list_sem;
  ****************************************************************************/
 static sq_queue_t g_port_node_list;
 static int curr_recv_cnt;;
+static int g_recv_epoch;
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -121,6 +123,12 @@ static int messaging_append_receiver(pid_t pid, int prio, sq_queue_t *queue)
 	recv_node->pid = pid;
 	recv_node->prio = prio;
 
+	/* A new epoch tells the senders that this receiver has a new message queue. */
+	if (++g_recv_epoch <= 0) {
+		g_recv_epoch = 1;
+	}
+	recv_node->epoch = g_recv_epoch;
+
 	/* Append recv node by decreasing order. */
 	next_node = (msg_recv_node_t *)sq_peek(queue);
 	prev_node = next_node;
@@ -242,6 +250,9 @@ int messaging_save_receiver(char *port_name, pid_t recv_pid, int recv_prio)
  *
  * Parameters:
  *   port_name - A message port name
+ *   recv_arr  - The pids of the receivers
+ *   epoch_arr - The epochs of the receivers, may be NULL
+ *   total_cnt - The number of receivers who wait the port
  *
  * Return Value:
  *   Return the number of receivers who wait the port on success.
@@ -250,7 +261,7 @@ int messaging_save_receiver(char *port_name, pid_t recv_pid, int recv_prio)
  * Assumptions:
  *
  ****************************************************************************/
-int messaging_read_list(char *port_name, int *recv_arr, int *total_cnt)
+int messaging_read_list(char *port_name, int *recv_arr, int *epoch_arr, int *total_cnt)
 {
 	int recv_idx;
 	msg_port_node_t *port_node;
@@ -278,6 +289,9 @@ int messaging_read_list(char *port_name, int *recv_arr, int *total_cnt)
 				/* Read receivers' information. */
 				for (recv_idx = 0; recv_idx < CONFIG_MESSAGING_RECV_LIST_SIZE; recv_idx++) {
 					recv_arr[recv_idx] = recv_node->pid;
+					if (epoch_arr != NULL) {
+						epoch_arr[recv_idx] = recv_node->epoch;
+					}
 					curr_recv_cnt++;
 					recv_node = (msg_recv_node_t *)sq_next(recv_node);
 					if (recv_node == NULL) {
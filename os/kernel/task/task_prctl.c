@@ -198,10 +198,11 @@ int prctl(int option, ...)
 		char *port_name = va_arg(ap, char *);
 		int *recv_arr = va_arg(ap, int *);
 		int *recv_cnt = va_arg(ap, int *);
+		int *epoch_arr = va_arg(ap, int *);
 		int total_cnt;
 		static int curr_cnt = 0;
 		int ret;
-		ret = messaging_read_list(port_name, recv_arr, &total_cnt);
+		ret = messaging_read_list(port_name, recv_arr, epoch_arr, &total_cnt);
 		if (ret == ERROR) {
 			va_end(ap);
 			return ret;
@@ -91,6 +91,24 @@
 #define LOCAL_SYNC_BYTE 0x42 /* Byte in sync sequence */
 #define LOCAL_END_BYTE 0xbd  /* End of sync seqence */
 
+/* Packet format in a stream ring: 16-bit packet length (in host order)
+ * followed by the packet data.  The length is only made visible together
+ * with the first byte of data.
+ */
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+#define LOCAL_RING_SIZE CONFIG_NET_LOCAL_STREAM_RING_SIZE
+#define LOCAL_RING_MASK (LOCAL_RING_SIZE - 1)
+#define LOCAL_RING_HDRLEN sizeof(uint16_t)
+
+#if (LOCAL_RING_SIZE & LOCAL_RING_MASK) != 0 || LOCAL_RING_SIZE < 64
+#error "CONFIG_NET_LOCAL_STREAM_RING_SIZE must be a power of two, at least 64"
+#endif
+
+#define LOCAL_RING_RCLOSED (1 << 0) /* The receiving end has been closed */
+#define LOCAL_RING_WCLOSED (1 << 1) /* The sending end has been closed */
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -123,6 +141,42 @@ enum local_state_s {
 	LOCAL_STATE_DISCONNECTED /* Peer disconnected */
 };
 
+/* One direction of a connected SOCK_STREAM pair.  lr_head is only
+ * written by the sender and lr_tail only by the receiver; both count bytes
+ * since the connection was made, so head - tail is the number of bytes
+ * queued.  lr_head, lr_tail and lr_flags are updated and checked with
+ * interrupts disabled; a side that finds the ring empty (or full) sleeps on
+ * lr_rsem (lr_wsem) before re-enabling them, and the other side wakes every
+ * sleeper as the pipe driver does.  Threads sharing a socket take lr_wlock
+ * (lr_rlock) for a whole send (receive), so that there is only ever one
+ * sender and one receiver on the ring.
+ */
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+struct local_ring_s {
+	FAR uint8_t *lr_buf;	 /* LOCAL_RING_SIZE bytes of data */
+	uint32_t lr_head;		 /* Bytes written by the sender */
+	uint32_t lr_tail;		 /* Bytes read by the receiver */
+	uint32_t lr_flags;		 /* See LOCAL_RING_* definitions */
+	sem_t lr_rsem;			 /* Posted when data is added */
+	sem_t lr_wsem;			 /* Posted when space is freed */
+	sem_t lr_rlock;			 /* Serializes receivers of the ring */
+	sem_t lr_wlock;			 /* Serializes senders on the ring */
+	FAR struct pollfd *lr_rfds[LOCAL_NPOLLWAITERS]; /* Receivers polling for POLLIN */
+	FAR struct pollfd *lr_wfds[LOCAL_NPOLLWAITERS]; /* Senders polling for POLLOUT */
+};
+
+/* The two rings of a connection, allocated by accept() and shared by the
+ * client and the server-side peer.  The data buffers follow the structure.
+ */
+
+struct local_ringpair_s {
+	uint8_t lp_crefs;		 /* Number of connected ends not yet closed */
+	struct local_ring_s lp_cs; /* Client-to-server ring */
+	struct local_ring_s lp_sc; /* Server-to-client ring */
+};
+#endif
+
 /* Representation of a local connection.  There are four types of
  * connection structures:
  *
@@ -179,6 +233,14 @@ struct local_conn_s {
 	struct pollfd lc_inout_fds[2 * LOCAL_NPOLLWAITERS];
 #endif
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Connected peers use these in place of lc_infile and lc_outfile */
+
+	FAR struct local_ringpair_s *lc_rings; /* Rings shared with the peer */
+	FAR struct local_ring_s *lc_rxring;	/* Ring the peer sends on */
+	FAR struct local_ring_s *lc_txring;	/* Ring this end sends on */
+#endif
+
 	/* Union of fields unique to SOCK_STREAM client, server, and connected
 	 * peers.
 	 */
@@ -662,6 +724,89 @@ int local_open_sender(FAR struct local_conn_s *conn, FAR const char *path,
 					  bool nonblock);
 #endif
 
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the rings of a new SOCK_STREAM connection and attach them to
+ *   the accepting (server-side) peer and the connecting client.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+int local_ring_alloc(FAR struct local_conn_s *server,
+					 FAR struct local_conn_s *client);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a closing peer from its rings.  The other peer sees end-of-
+ *   stream on receive and EPIPE on send; the rings are freed when both
+ *   peers have been released.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+void local_ring_release(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Queue data on the transmit ring of a connected peer.  A blocking send
+ *   returns once all of 'len' is queued; a non-blocking one queues what
+ *   fits.
+ *
+ * Returned Value:
+ *   The number of bytes queued on success; -EAGAIN if nothing could be
+ *   queued without blocking, or -EPIPE if the peer was closed before
+ *   anything was queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const uint8_t *buf,
+						size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data from the receive ring of a connected peer.  As with the
+ *   FIFOs, a single call never returns data from more than one packet.
+ *
+ * Returned Value:
+ *   The number of bytes received on success; -EAGAIN if no data is queued
+ *   and 'nonblock' is set, or -ECONNRESET if no data is queued and the
+ *   peer has been closed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR uint8_t *buf,
+						size_t len, bool nonblock);
+#endif
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of the rings of a connected peer.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_STREAM_RING) && defined(HAVE_LOCAL_POLL)
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds, bool setup);
+#endif
+
 /****************************************************************************
  * Name: local_accept_pollnotify
  ****************************************************************************/
@@ -191,6 +191,9 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 				conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
 				conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+				ret = OK;
+#else
 				/* Open the server-side write-only FIFO.  This should not
 				 * block.
 				 */
@@ -201,8 +204,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 					ndbg("ERROR: Failed to open write-only FIFOs for %s: %d\n",
 						 conn->lc_path, ret);
 				}
+#endif
 			}
 
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
 			/* Do we have a connection?  Is the write-side FIFO opened? */
 
 			if (ret == OK) {
@@ -225,13 +230,25 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
 			if (ret == OK) {
 				DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+			}
+#endif
+
+			/* Return the address family */
+
+			if (ret == OK && addr != NULL) {
+				ret = local_getaddr(client, addr, addrlen);
+			}
 
-				/* Return the address family */
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+			/* Give both ends the rings that carry the connection's data */
 
-				if (addr != NULL) {
-					ret = local_getaddr(client, addr, addrlen);
+			if (ret == OK) {
+				ret = local_ring_alloc(conn, client);
+				if (ret < 0) {
+					local_free(conn);
 				}
 			}
+#endif
 
 			if (ret == OK) {
 				/* Setup the client socket structure */
@@ -157,6 +157,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	server->u.server.lc_pending++;
 	DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
 	/* Create the FIFOs needed for the connection */
 
 	ret = local_create_fifos(client);
@@ -182,6 +183,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	}
 
 	DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+#endif
 
 	/* Set the busy "result" before giving the semaphore. */
 
@@ -213,6 +215,11 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 		goto errout_with_outfd;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Yes.. the server has attached the rings of the connection */
+
+	DEBUGASSERT(client->lc_rings != NULL);
+#else
 	/* Yes.. open the read-only FIFO */
 
 	ret = local_open_client_rx(client, nonblock);
@@ -223,15 +230,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
 	}
 
 	DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif
 	client->lc_state = LOCAL_STATE_CONNECTED;
 	return OK;
 
 errout_with_outfd:
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
 	file_close(&client->lc_outfile);
 	client->lc_outfile.f_inode = NULL;
 
 errout_with_fifos:
 	local_release_fifos(client);
+#endif
 	client->lc_state = LOCAL_STATE_BOUND;
 	return ret;
 }
@@ -202,6 +202,16 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 		goto pollerr;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* A connected peer is watched on its rings */
+
+	if (conn->lc_rings == NULL) {
+		fds->priv = NULL;
+		goto pollerr;
+	}
+
+	ret = local_ring_pollsetup(conn, fds, true);
+#else
 	switch (fds->events & (POLLIN | POLLOUT)) {
 	case (POLLIN | POLLOUT): {
 		FAR struct pollfd *shadowfds;
@@ -283,6 +293,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 		ret = OK;
 		break;
 	}
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 #endif
 
 	return ret;
@@ -327,6 +338,15 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 		return local_accept_pollsetup(conn, fds, false);
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* The rings stay attached when the peer disconnects, so the slots must
+	 * be released in that state too.
+	 */
+
+	if (conn->lc_rings != NULL) {
+		status = local_ring_pollsetup(conn, fds, false);
+	}
+#else
 	if (conn->lc_state == LOCAL_STATE_DISCONNECTED) {
 		return OK;
 	}
@@ -375,6 +395,7 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
 	default:
 		break;
 	}
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 #endif
 
 	return status;
@@ -170,6 +170,28 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 		return -ENOTCONN;
 	}
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Receive from the ring shared with the peer */
+
+	DEBUGASSERT(conn->lc_rings != NULL);
+
+	ret = local_ring_recv(conn, buf, len, _SS_ISNONBLOCK(psock->s_flags) ||
+						  (flags & MSG_DONTWAIT) != 0);
+	if (ret < 0) {
+		if (ret == -ECONNRESET) {
+			/* The peer closed the connection and all of its data has been
+			 * read.  Report this the same way as the FIFOs do.
+			 */
+
+			psock->s_flags &= ~(_SF_CONNECTED | _SF_CLOSED);
+			conn->lc_state = LOCAL_STATE_DISCONNECTED;
+		}
+
+		return ret;
+	}
+
+	readlen = ret;
+#else
 	/* The incoming FIFO should be open */
 
 	DEBUGASSERT(conn->lc_infile.f_inode != NULL);
@@ -205,6 +227,7 @@ psock_stream_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
 	DEBUGASSERT(readlen <= conn->u.peer.lc_remaining);
 	conn->u.peer.lc_remaining -= readlen;
+#endif
 
 	/* Return the address family */
 
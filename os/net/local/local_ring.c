@@ -0,0 +1,701 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_STREAM_RING)
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/semaphore.h>
+
+#include "local/local.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_init
+ ****************************************************************************/
+
+static void local_ring_init(FAR struct local_ring_s *ring, FAR uint8_t *buf)
+{
+	memset(ring, 0, sizeof(struct local_ring_s));
+	ring->lr_buf = buf;
+
+	/* These semaphores are used for signaling and, hence, should not have
+	 * priority inheritance enabled.
+	 */
+
+	sem_init(&ring->lr_rsem, 0, 0);
+	sem_setprotocol(&ring->lr_rsem, SEM_PRIO_NONE);
+	sem_init(&ring->lr_wsem, 0, 0);
+	sem_setprotocol(&ring->lr_wsem, SEM_PRIO_NONE);
+
+	sem_init(&ring->lr_rlock, 0, 1);
+	sem_init(&ring->lr_wlock, 0, 1);
+}
+
+/****************************************************************************
+ * Name: local_ring_lock
+ *
+ * Description:
+ *   Take the receive or send lock of a ring.  A non-blocking caller does
+ *   not wait for another thread's send or receive to finish.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the lock is held and 'nonblock' is
+ *   set.
+ *
+ ****************************************************************************/
+
+static int local_ring_lock(FAR sem_t *lock, bool nonblock)
+{
+	if (nonblock) {
+		return sem_trywait(lock) < 0 ? -EAGAIN : OK;
+	}
+
+	while (sem_wait(lock) < 0) {
+		/* The only case that an error should occur here is if the wait
+		 * was awakened by a signal.
+		 */
+
+		DEBUGASSERT(get_errno() == EINTR);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_used
+ *
+ * Description:
+ *   Return the number of bytes queued in the ring.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static inline uint32_t local_ring_used(FAR struct local_ring_s *ring)
+{
+	return ring->lr_head - ring->lr_tail;
+}
+
+/****************************************************************************
+ * Name: local_ring_copyin and local_ring_copyout
+ *
+ * Description:
+ *   Copy data into or out of the ring at the byte count 'pos', wrapping at
+ *   the end of the buffer.
+ *
+ ****************************************************************************/
+
+static void local_ring_copyin(FAR struct local_ring_s *ring, uint32_t pos,
+							  FAR const uint8_t *src, size_t len)
+{
+	size_t offset = pos & LOCAL_RING_MASK;
+	size_t first = MIN(len, LOCAL_RING_SIZE - offset);
+
+	memcpy(&ring->lr_buf[offset], src, first);
+	memcpy(ring->lr_buf, src + first, len - first);
+}
+
+static void local_ring_copyout(FAR struct local_ring_s *ring, uint32_t pos,
+							   FAR uint8_t *dest, size_t len)
+{
+	size_t offset = pos & LOCAL_RING_MASK;
+	size_t first = MIN(len, LOCAL_RING_SIZE - offset);
+
+	memcpy(dest, &ring->lr_buf[offset], first);
+	memcpy(dest + first, ring->lr_buf, len - first);
+}
+
+/****************************************************************************
+ * Name: local_ring_pollnotify
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+static void local_ring_pollnotify(FAR struct pollfd **fds, pollevent_t eventset)
+{
+	int i;
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		struct pollfd *pfd = fds[i];
+		if (pfd) {
+			pfd->revents |= (pfd->events & eventset) | (eventset & (POLLERR | POLLHUP));
+			if (pfd->revents != 0) {
+				nvdbg("Report events: %02x\n", pfd->revents);
+				sem_post(pfd->sem);
+			}
+		}
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: local_ring_notify
+ *
+ * Description:
+ *   Wake all threads sleeping on 'sem' and notify the pollers in 'fds'.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void local_ring_notify(FAR sem_t *sem, FAR struct pollfd **fds,
+							  pollevent_t eventset)
+{
+	int sval;
+
+	while (sem_getvalue(sem, &sval) == 0 && sval < 0) {
+		sem_post(sem);
+	}
+
+#ifdef HAVE_LOCAL_POLL
+	local_ring_pollnotify(fds, eventset);
+#endif
+}
+
+/****************************************************************************
+ * Name: local_ring_waitdata
+ *
+ * Description:
+ *   Wait until data is queued in the ring.
+ *
+ * Returned Value:
+ *   The number of bytes queued; -EAGAIN if none is queued and 'nonblock' is
+ *   set, or -ECONNRESET if none is queued and the sender has been closed.
+ *
+ ****************************************************************************/
+
+static int local_ring_waitdata(FAR struct local_ring_s *ring, bool nonblock)
+{
+	irqstate_t flags;
+	int ret;
+
+	/* Interrupts stay disabled until we sleep, so the sender cannot queue
+	 * data or close the ring between the check and sem_wait().  Signals
+	 * are ignored here as they are when reading from the FIFOs.
+	 */
+
+	flags = irqsave();
+	for (;;) {
+		ret = (int)local_ring_used(ring);
+		if (ret > 0) {
+			break;
+		}
+
+		if (ring->lr_flags & LOCAL_RING_WCLOSED) {
+			ret = -ECONNRESET;
+			break;
+		}
+
+		if (nonblock) {
+			ret = -EAGAIN;
+			break;
+		}
+
+		sem_wait(&ring->lr_rsem);
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_waitspace
+ *
+ * Description:
+ *   Wait until at least 'need' bytes are free in the ring.
+ *
+ * Returned Value:
+ *   The number of bytes free; -EAGAIN if not enough are free and 'nonblock'
+ *   is set, or -EPIPE if the receiver has been closed.
+ *
+ ****************************************************************************/
+
+static int local_ring_waitspace(FAR struct local_ring_s *ring, size_t need,
+								bool nonblock)
+{
+	irqstate_t flags;
+	int ret;
+
+	flags = irqsave();
+	for (;;) {
+		if (ring->lr_flags & LOCAL_RING_RCLOSED) {
+			ret = -EPIPE;
+			break;
+		}
+
+		ret = (int)(LOCAL_RING_SIZE - local_ring_used(ring));
+		if ((size_t)ret >= need) {
+			break;
+		}
+
+		if (nonblock) {
+			ret = -EAGAIN;
+			break;
+		}
+
+		sem_wait(&ring->lr_wsem);
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_produce and local_ring_consume
+ *
+ * Description:
+ *   Make 'len' more bytes at lr_head visible to the receiver, or free the
+ *   'len' bytes at lr_tail for the sender.  The data itself is copied with
+ *   interrupts enabled: only the sender writes lr_head and only the
+ *   receiver writes lr_tail, and neither touches the bytes between them
+ *   that the other one owns.
+ *
+ ****************************************************************************/
+
+static void local_ring_produce(FAR struct local_ring_s *ring, uint32_t head,
+							   size_t len)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	ring->lr_head = head + len;
+	local_ring_notify(&ring->lr_rsem, ring->lr_rfds, POLLIN);
+	irqrestore(flags);
+}
+
+static void local_ring_consume(FAR struct local_ring_s *ring, uint32_t tail,
+							   size_t len)
+{
+	irqstate_t flags;
+
+	flags = irqsave();
+	ring->lr_tail = tail + len;
+	local_ring_notify(&ring->lr_wsem, ring->lr_wfds, POLLOUT);
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_alloc
+ *
+ * Description:
+ *   Allocate the rings of a new SOCK_STREAM connection and attach them to
+ *   the accepting (server-side) peer and the connecting client.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if the rings could not be allocated.
+ *
+ ****************************************************************************/
+
+int local_ring_alloc(FAR struct local_conn_s *server,
+					 FAR struct local_conn_s *client)
+{
+	FAR struct local_ringpair_s *rings;
+	FAR uint8_t *buf;
+
+	rings = (FAR struct local_ringpair_s *)
+		kmm_malloc(sizeof(struct local_ringpair_s) + 2 * LOCAL_RING_SIZE);
+	if (rings == NULL) {
+		ndbg("ERROR: Failed to allocate the stream rings\n");
+		return -ENOMEM;
+	}
+
+	buf = (FAR uint8_t *)(rings + 1);
+	local_ring_init(&rings->lp_cs, buf);
+	local_ring_init(&rings->lp_sc, buf + LOCAL_RING_SIZE);
+	rings->lp_crefs = 2;
+
+	server->lc_rings = rings;
+	server->lc_rxring = &rings->lp_cs;
+	server->lc_txring = &rings->lp_sc;
+
+	client->lc_rings = rings;
+	client->lc_rxring = &rings->lp_sc;
+	client->lc_txring = &rings->lp_cs;
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_release
+ *
+ * Description:
+ *   Detach a closing peer from its rings.  The other peer sees end-of-
+ *   stream on receive and EPIPE on send; the rings are freed when both
+ *   peers have been released.
+ *
+ ****************************************************************************/
+
+void local_ring_release(FAR struct local_conn_s *conn)
+{
+	FAR struct local_ringpair_s *rings = conn->lc_rings;
+	FAR struct local_ring_s *rxring = conn->lc_rxring;
+	FAR struct local_ring_s *txring = conn->lc_txring;
+	irqstate_t flags;
+	uint8_t crefs;
+
+	if (rings == NULL) {
+		return;
+	}
+
+	/* Tell the other peer, and wake it wherever it waits on us */
+
+	flags = irqsave();
+	txring->lr_flags |= LOCAL_RING_WCLOSED;
+	rxring->lr_flags |= LOCAL_RING_RCLOSED;
+
+	local_ring_notify(&txring->lr_rsem, txring->lr_rfds, POLLIN | POLLHUP);
+	local_ring_notify(&rxring->lr_wsem, rxring->lr_wfds, POLLOUT | POLLERR);
+
+	crefs = --rings->lp_crefs;
+	irqrestore(flags);
+
+	conn->lc_rings = NULL;
+	conn->lc_rxring = NULL;
+	conn->lc_txring = NULL;
+
+	if (crefs == 0) {
+		sem_destroy(&rings->lp_cs.lr_rsem);
+		sem_destroy(&rings->lp_cs.lr_wsem);
+		sem_destroy(&rings->lp_cs.lr_rlock);
+		sem_destroy(&rings->lp_cs.lr_wlock);
+		sem_destroy(&rings->lp_sc.lr_rsem);
+		sem_destroy(&rings->lp_sc.lr_wsem);
+		sem_destroy(&rings->lp_sc.lr_rlock);
+		sem_destroy(&rings->lp_sc.lr_wlock);
+		kmm_free(rings);
+	}
+}
+
+/****************************************************************************
+ * Name: local_ring_send
+ *
+ * Description:
+ *   Queue data on the transmit ring of a connected peer.  A blocking send
+ *   returns once all of 'len' is queued; a non-blocking one queues what
+ *   fits.
+ *
+ * Returned Value:
+ *   The number of bytes queued on success; -EAGAIN if nothing could be
+ *   queued without blocking, or -EPIPE if the peer was closed before
+ *   anything was queued.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_send(FAR struct local_conn_s *conn, FAR const uint8_t *buf,
+						size_t len, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_txring;
+	uint32_t head;
+	uint16_t pktlen;
+	size_t remaining;
+	size_t chunk;
+	size_t sent = 0;
+	int space;
+	int ret;
+
+	DEBUGASSERT(ring != NULL);
+
+	/* Packets of concurrent senders must not interleave */
+
+	ret = local_ring_lock(&ring->lr_wlock, nonblock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (sent < len) {
+		/* Wait for room for the packet length and at least one byte */
+
+		space = local_ring_waitspace(ring, LOCAL_RING_HDRLEN + 1, nonblock);
+		if (space < 0) {
+			ret = space;
+			break;
+		}
+
+		/* A non-blocking send makes the packet no longer than what fits
+		 * now, so that it never has to wait half way through a packet.
+		 */
+
+		pktlen = MIN(len - sent, UINT16_MAX);
+		chunk = MIN(pktlen, space - LOCAL_RING_HDRLEN);
+		if (nonblock) {
+			pktlen = chunk;
+		}
+
+		head = ring->lr_head;
+		local_ring_copyin(ring, head, (FAR const uint8_t *)&pktlen,
+						  LOCAL_RING_HDRLEN);
+		local_ring_copyin(ring, head + LOCAL_RING_HDRLEN, buf + sent, chunk);
+		local_ring_produce(ring, head, LOCAL_RING_HDRLEN + chunk);
+
+		sent += chunk;
+		remaining = pktlen - chunk;
+
+		/* Finish the packet as the receiver makes room */
+
+		while (remaining > 0) {
+			space = local_ring_waitspace(ring, 1, false);
+			if (space < 0) {
+				ret = space;
+				break;
+			}
+
+			chunk = MIN(remaining, (size_t)space);
+			head = ring->lr_head;
+			local_ring_copyin(ring, head, buf + sent, chunk);
+			local_ring_produce(ring, head, chunk);
+
+			sent += chunk;
+			remaining -= chunk;
+		}
+
+		if (remaining > 0) {
+			break;
+		}
+	}
+
+	sem_post(&ring->lr_wlock);
+
+	/* Bytes already queued are reported even if the peer went away */
+
+	return sent > 0 ? (ssize_t)sent : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_recv
+ *
+ * Description:
+ *   Receive data from the receive ring of a connected peer.  As with the
+ *   FIFOs, a single call never returns data from more than one packet.
+ *
+ * Returned Value:
+ *   The number of bytes received on success; -EAGAIN if no data is queued
+ *   and 'nonblock' is set, or -ECONNRESET if no data is queued and the
+ *   peer has been closed.
+ *
+ ****************************************************************************/
+
+ssize_t local_ring_recv(FAR struct local_conn_s *conn, FAR uint8_t *buf,
+						size_t len, bool nonblock)
+{
+	FAR struct local_ring_s *ring = conn->lc_rxring;
+	uint32_t tail;
+	uint16_t pktlen;
+	size_t readlen;
+	size_t chunk;
+	size_t nread = 0;
+	int used;
+	int ret;
+
+	DEBUGASSERT(ring != NULL);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	/* A packet is consumed by one receiver at a time, so that concurrent
+	 * receivers do not split its length from its data.
+	 */
+
+	ret = local_ring_lock(&ring->lr_rlock, nonblock);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Are there still bytes in the ring from the last packet? */
+
+	if (conn->u.peer.lc_remaining == 0) {
+		/* No.. get the length of the next one.  It is queued together with
+		 * the first byte of the packet.
+		 */
+
+		used = local_ring_waitdata(ring, nonblock);
+		if (used < 0) {
+			sem_post(&ring->lr_rlock);
+			return used;
+		}
+
+		DEBUGASSERT(used > LOCAL_RING_HDRLEN);
+		tail = ring->lr_tail;
+		local_ring_copyout(ring, tail, (FAR uint8_t *)&pktlen,
+						   LOCAL_RING_HDRLEN);
+		local_ring_consume(ring, tail, LOCAL_RING_HDRLEN);
+		conn->u.peer.lc_remaining = pktlen;
+	}
+
+	/* Read the packet */
+
+	readlen = MIN(conn->u.peer.lc_remaining, len);
+	while (nread < readlen) {
+		used = local_ring_waitdata(ring, nonblock);
+		if (used < 0) {
+			ret = used;
+			break;
+		}
+
+		chunk = MIN(readlen - nread, (size_t)used);
+		tail = ring->lr_tail;
+		local_ring_copyout(ring, tail, buf + nread, chunk);
+		local_ring_consume(ring, tail, chunk);
+
+		nread += chunk;
+	}
+
+	/* Adjust the number of bytes remaining to be read from the packet */
+
+	conn->u.peer.lc_remaining -= nread;
+	sem_post(&ring->lr_rlock);
+
+	return nread > 0 ? (ssize_t)nread : ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_pollsetup
+ *
+ * Description:
+ *   Setup or teardown monitoring of the rings of a connected peer.  POLLIN
+ *   is watched on the receive ring and POLLOUT on the transmit ring.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+int local_ring_pollsetup(FAR struct local_conn_s *conn,
+						 FAR struct pollfd *fds, bool setup)
+{
+	FAR struct local_ring_s *rxring = conn->lc_rxring;
+	FAR struct local_ring_s *txring = conn->lc_txring;
+	FAR struct pollfd **rslot = NULL;
+	FAR struct pollfd **wslot = NULL;
+	pollevent_t eventset;
+	irqstate_t flags;
+	int i;
+
+	DEBUGASSERT(rxring != NULL && txring != NULL);
+
+	flags = irqsave();
+	if (!setup) {
+		/* This is a request to tear down the poll */
+
+		for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+			if (rxring->lr_rfds[i] == fds) {
+				rxring->lr_rfds[i] = NULL;
+			}
+
+			if (txring->lr_wfds[i] == fds) {
+				txring->lr_wfds[i] = NULL;
+			}
+		}
+
+		fds->priv = NULL;
+		irqrestore(flags);
+		return OK;
+	}
+
+	/* Find a slot on each ring that has to be watched */
+
+	for (i = 0; i < LOCAL_NPOLLWAITERS; i++) {
+		if (rslot == NULL && rxring->lr_rfds[i] == NULL) {
+			rslot = &rxring->lr_rfds[i];
+		}
+
+		if (wslot == NULL && txring->lr_wfds[i] == NULL) {
+			wslot = &txring->lr_wfds[i];
+		}
+	}
+
+	if (((fds->events & POLLIN) && rslot == NULL) ||
+		((fds->events & POLLOUT) && wslot == NULL)) {
+		irqrestore(flags);
+		fds->priv = NULL;
+		return -EBUSY;
+	}
+
+	if (fds->events & POLLIN) {
+		*rslot = fds;
+	}
+
+	if (fds->events & POLLOUT) {
+		*wslot = fds;
+	}
+
+	fds->priv = conn;
+
+	/* Report what is ready already */
+
+	eventset = 0;
+	if (local_ring_used(rxring) > 0) {
+		eventset |= POLLIN;
+	}
+
+	if (rxring->lr_flags & LOCAL_RING_WCLOSED) {
+		eventset |= POLLIN | POLLHUP;
+	}
+
+	if (LOCAL_RING_SIZE - local_ring_used(txring) > LOCAL_RING_HDRLEN) {
+		eventset |= POLLOUT;
+	}
+
+	if (txring->lr_flags & LOCAL_RING_RCLOSED) {
+		eventset |= POLLOUT | POLLERR;
+	}
+
+	fds->revents |= (fds->events & eventset) | (eventset & (POLLERR | POLLHUP));
+	if (fds->revents != 0) {
+		sem_post(fds->sem);
+	}
+
+	irqrestore(flags);
+	return OK;
+}
+#endif /* HAVE_LOCAL_POLL */
+
+#endif /* CONFIG_NET && CONFIG_NET_LOCAL_STREAM_RING */
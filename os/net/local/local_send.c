@@ -57,12 +57,14 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <sys/socket.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
 
 #include <tinyara/net/net.h>
 
+#include "socket/socket.h"
 #include "local/local.h"
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -94,11 +96,27 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
 						 size_t len, int flags)
 {
 	FAR struct local_conn_s *peer;
+#ifndef CONFIG_NET_LOCAL_STREAM_RING
 	int ret;
+#endif
 
 	DEBUGASSERT(psock && psock->s_conn && buf);
 	peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+	/* Verify that this is a connected peer socket with its rings attached */
+
+	if (peer->lc_state != LOCAL_STATE_CONNECTED || peer->lc_rings == NULL) {
+		ndbg("ERROR: not connected\n");
+		return -ENOTCONN;
+	}
+
+	/* Queue the data on the ring */
+
+	return local_ring_send(peer, (FAR const uint8_t *)buf, len,
+						   _SS_ISNONBLOCK(psock->s_flags) ||
+						   (flags & MSG_DONTWAIT) != 0);
+#else
 	/* Verify that this is a connected peer socket and that it has opened the
 	 * outgoing FIFO for write-only access.
 	 */
@@ -116,6 +134,7 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
 	/* If the send was successful, then the full packet will have been sent */
 
 	return ret < 0 ? ret : len;
+#endif
 }
 
 #endif /* CONFIG_NET_LOCAL_STREAM */
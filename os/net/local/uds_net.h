@@ -19,11 +19,15 @@
 #ifndef __NET_LOCAL_UDS_NET_H
 #define __NET_LOCAL_UDS_NET_H
 
+#include <stdbool.h>
+#include <poll.h>
+#include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 
 void uds_net_initlist(FAR struct socketlist *list);
 void uds_net_releaselist(FAR struct socketlist *list);
 int uds_checksd(int fd, int oflags);
+int uds_poll(int sockfd, FAR struct pollfd *fds, bool setup);
 
 int uds_socket(int domain, int type, int protocol);
 int uds_bind(int sockfd, const struct sockaddr *addr, socklen_t addrlen);
@@ -36,5 +40,8 @@ ssize_t uds_recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t uds_recvfrom(int sockfd, FAR void *buf, size_t len, int flags, FAR struct sockaddr *from, FAR socklen_t *fromlen);
 int uds_getsockname(int sockfd, FAR struct sockaddr *addr, FAR socklen_t *addrlen);
 int uds_getpeername(int sockfd, FAR struct sockaddr *addr, FAR socklen_t *addrlen);
+#ifdef CONFIG_NET_SENDFILE
+ssize_t uds_sendfile(int sockfd, FAR struct file *infile, FAR off_t *offset, size_t count);
+#endif
 
 #endif /* __NET_LOCAL_UDS_NET_H */
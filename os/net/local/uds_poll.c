@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * Copyright 2020 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/net/net.h>
+
+#include "local/uds_net.h"
+#include "local/uds_socket.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uds_poll
+ *
+ * Description:
+ *   Set up or tear down the poll operation on a Unix domain socket by
+ *   handing it to the poll method of the socket's address family.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of the socket
+ *   fds    - The structure describing the events to be monitored
+ *   setup  - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int uds_poll(int sockfd, FAR struct pollfd *fds, bool setup)
+{
+	FAR struct socket *psock = sockfd_socket(sockfd);
+
+	/* Verify that the sockfd corresponds to valid, allocated socket */
+
+	if (psock == NULL || psock->s_crefs <= 0) {
+		return -EBADF;
+	}
+
+	if (psock->s_sockif == NULL || psock->s_sockif->si_poll == NULL) {
+		return -ENOSYS;
+	}
+
+	return psock->s_sockif->si_poll(psock, fds, setup);
+}
+
+#endif /* CONFIG_NET */
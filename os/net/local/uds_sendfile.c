@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/cancelpt.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/net/net.h>
+
+#include "local/uds_net.h"
+#include "local/uds_socket.h"
+
+#ifdef CONFIG_NET_SENDFILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uds_sendfile
+ *
+ * Description:
+ *   Splice file data into a Unix domain socket.  The data is written from
+ *   the file straight into the connection FIFO: files on XIP ROMFS are
+ *   copied directly from flash, other files go through a single kernel
+ *   buffer.  Nothing crosses the user/kernel boundary.
+ *
+ * Input Parameters:
+ *   sockfd - Socket descriptor of the connected socket
+ *   infile - The open file to read from
+ *   offset - Optional file offset to start from (see sendfile())
+ *   count  - The number of bytes to transfer
+ *
+ * Returned Value:
+ *   The number of bytes sent.  On error, -1 is returned and errno is set
+ *   as for send() and read().
+ *
+ ****************************************************************************/
+
+ssize_t uds_sendfile(int sockfd, FAR struct file *infile, FAR off_t *offset, size_t count)
+{
+	FAR struct socket *psock;
+	FAR const uint8_t *xipbase;
+	FAR uint8_t *iobuffer = NULL;
+	off_t filesize;
+	off_t savepos;
+	off_t startpos;
+	size_t total = 0;
+	size_t chunk;
+	size_t sent;
+	ssize_t nread;
+	ssize_t ret = OK;
+
+	/* sendfile() is a cancellation point */
+
+	enter_cancellation_point();
+
+	psock = sockfd_socket(sockfd);
+	if (psock == NULL) {
+		ret = -EBADF;
+		goto errout;
+	}
+
+	savepos = infile->f_pos;
+	startpos = offset ? *offset : savepos;
+
+	if (file_xipbase(infile, &xipbase, &filesize) == OK) {
+		if (startpos >= filesize) {
+			count = 0;
+		} else if (count > (size_t)(filesize - startpos)) {
+			count = (size_t)(filesize - startpos);
+		}
+
+		while (total < count) {
+			chunk = MIN(count - total, CONFIG_NET_SENDFILE_BUFSIZE);
+			ret = psock_send(psock, xipbase + startpos + total, chunk, 0);
+			if (ret <= 0) {
+				break;
+			}
+
+			total += ret;
+		}
+	} else {
+		if (file_seek(infile, startpos, SEEK_SET) == (off_t)-1) {
+			ret = -get_errno();
+			goto errout;
+		}
+
+		iobuffer = (FAR uint8_t *)kmm_malloc(CONFIG_NET_SENDFILE_BUFSIZE);
+		if (iobuffer == NULL) {
+			ret = -ENOMEM;
+			goto errout;
+		}
+
+		while (total < count) {
+			nread = file_read(infile, iobuffer, MIN(count - total, CONFIG_NET_SENDFILE_BUFSIZE));
+			if (nread <= 0) {
+				ret = nread;
+				break;
+			}
+
+			/* The file position is already past the chunk, so all of it
+			 * must go out before the next read.
+			 */
+
+			sent = 0;
+			while (sent < (size_t)nread) {
+				ret = psock_send(psock, iobuffer + sent, nread - sent, 0);
+				if (ret <= 0) {
+					break;
+				}
+
+				sent += ret;
+			}
+
+			total += sent;
+			if (sent < (size_t)nread) {
+				break;
+			}
+		}
+
+		kmm_free(iobuffer);
+	}
+
+	/* Report where the transfer stopped.  With an explicit offset the file
+	 * position must be left as it was found.
+	 */
+
+	if (offset) {
+		*offset = startpos + total;
+		if (infile->f_pos != savepos) {
+			(void)file_seek(infile, savepos, SEEK_SET);
+		}
+	} else {
+		(void)file_seek(infile, startpos + total, SEEK_SET);
+	}
+
+	if (total > 0 || ret >= 0) {
+		leave_cancellation_point();
+		return (ssize_t)total;
+	}
+
+errout:
+	leave_cancellation_point();
+	set_errno(-ret);
+	return ERROR;
+}
+
+#endif /* CONFIG_NET_SENDFILE */
@@ -143,6 +143,7 @@
  ****************************************************************************/
 
 FAR struct socket *sockfd_socket(int sockfd);
+ssize_t psock_send(FAR struct socket *psock, FAR const void *buf, size_t len, int flags);
 FAR const struct sock_intf_s *
 net_sockif(sa_family_t family, int type, int protocol);
 
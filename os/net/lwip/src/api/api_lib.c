@@ -567,6 +567,7 @@ static err_t netconn_recv_data(struct netconn *conn, void **new_buf)
 #if LWIP_SO_RCVBUF
 	SYS_ARCH_DEC(conn->recv_avail, len);
 #endif							/* LWIP_SO_RCVBUF */
+	NETCONN_RECVQ_OUT(conn, len);
 	/* Register event with callback */
 	API_EVENT(conn, NETCONN_EVT_RCVMINUS, len);
 
@@ -698,6 +699,41 @@ err_t netconn_send(struct netconn *conn, struct netbuf *buf)
 	return err;
 }
 
+/**
+ * Send several datagrams over a UDP or RAW netconn with a single message
+ * to the tcpip thread. Each netbuf is sent to its own address, or to the
+ * connected remote if that is 'any'.
+ *
+ * @param conn the UDP or RAW netconn over which to send data
+ * @param bufs the netbufs to send
+ * @param count number of netbufs in bufs
+ * @param sent receives the number of netbufs sent, which is less than count
+ *             if one failed
+ * @return ERR_OK if all netbufs were sent, else the error of the first one
+ *         that was not sent
+ */
+err_t netconn_send_batch(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent)
+{
+	API_MSG_VAR_DECLARE(msg);
+	err_t err;
+
+	LWIP_ERROR("netconn_send_batch: invalid conn", (conn != NULL), return ERR_ARG;);
+	LWIP_ERROR("netconn_send_batch: invalid args", (bufs != NULL) && (sent != NULL), return ERR_ARG;);
+
+	LWIP_DEBUGF(API_LIB_DEBUG, ("netconn_send_batch: sending %" U16_F " datagrams\n", count));
+
+	API_MSG_VAR_ALLOC(msg);
+	API_MSG_VAR_REF(msg).conn = conn;
+	API_MSG_VAR_REF(msg).msg.sb.bufs = bufs;
+	API_MSG_VAR_REF(msg).msg.sb.count = count;
+	API_MSG_VAR_REF(msg).msg.sb.sent = 0;
+	err = netconn_apimsg(lwip_netconn_do_send_batch, &API_MSG_VAR_REF(msg));
+	*sent = API_MSG_VAR_REF(msg).msg.sb.sent;
+	API_MSG_VAR_FREE(msg);
+
+	return err;
+}
+
 /**
  * Send data over a TCP netconn.
  *
@@ -825,6 +861,37 @@ err_t netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx)
 	return netconn_close_shutdown(conn, (shut_rx ? NETCONN_SHUT_RD : 0) | (shut_tx ? NETCONN_SHUT_WR : 0));
 }
 
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+/**
+ * Request a notification once the remote side has acknowledged all data
+ * written to a TCP netconn so far. The data of a NETCONN_NOCOPY write must
+ * stay valid until then.
+ *
+ * @param conn the TCP netconn that was written to
+ * @param zc a completion allocated with mem_malloc and filled with the callback
+ *           and its argument; owned by the netconn (and freed after the
+ *           callback) only if ERR_OK is returned
+ * @return ERR_OK if the completion was queued (it may already have run),
+ *         ERR_CONN if the connection is gone
+ */
+err_t netconn_zc_notify(struct netconn *conn, struct netconn_zc *zc)
+{
+	API_MSG_VAR_DECLARE(msg);
+	err_t err;
+
+	LWIP_ERROR("netconn_zc_notify: invalid conn", (conn != NULL), return ERR_ARG;);
+	LWIP_ERROR("netconn_zc_notify: invalid zc", (zc != NULL) && (zc->done != NULL), return ERR_ARG;);
+
+	API_MSG_VAR_ALLOC(msg);
+	API_MSG_VAR_REF(msg).conn = conn;
+	API_MSG_VAR_REF(msg).msg.zc.zc = zc;
+	err = netconn_apimsg(lwip_netconn_do_zc_notify, &API_MSG_VAR_REF(msg));
+	API_MSG_VAR_FREE(msg);
+
+	return err;
+}
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
+
 #if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
 /**
  * Join multicast groups for UDP netconns.
@@ -127,6 +127,7 @@ static u8_t recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p, const ip_ad
 		int recv_avail;
 		SYS_ARCH_GET(conn->recv_avail, recv_avail);
 		if ((recv_avail + (int)(p->tot_len)) > conn->recv_bufsize) {
+			NETCONN_RECVQ_DROP(conn);
 			return 0;
 		}
 #endif							/* LWIP_SO_RCVBUF */
@@ -154,12 +155,14 @@ static u8_t recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p, const ip_ad
 
 			len = q->tot_len;
 			if (sys_mbox_trypost(&conn->recvmbox, buf) != ERR_OK) {
+				NETCONN_RECVQ_DROP(conn);
 				netbuf_delete(buf);
 				return 0;
 			} else {
 #if LWIP_SO_RCVBUF
 				SYS_ARCH_INC(conn->recv_avail, len);
 #endif							/* LWIP_SO_RCVBUF */
+				NETCONN_RECVQ_IN(conn, len);
 				/* Register event with callback */
 				API_EVENT(conn, NETCONN_EVT_RCVPLUS, len);
 			}
@@ -199,6 +202,9 @@ static void recv_udp(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 #else							/* LWIP_SO_RCVBUF */
 	if ((conn == NULL) || !sys_mbox_valid(&conn->recvmbox)) {
 #endif							/* LWIP_SO_RCVBUF */
+		if (conn != NULL) {
+			NETCONN_RECVQ_DROP(conn);
+		}
 		pbuf_free(p);
 		return;
 	}
@@ -227,12 +233,14 @@ static void recv_udp(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_ad
 
 	len = p->tot_len;
 	if (sys_mbox_trypost(&conn->recvmbox, buf) != ERR_OK) {
+		NETCONN_RECVQ_DROP(conn);
 		netbuf_delete(buf);
 		return;
 	} else {
 #if LWIP_SO_RCVBUF
 		SYS_ARCH_INC(conn->recv_avail, len);
 #endif							/* LWIP_SO_RCVBUF */
+		NETCONN_RECVQ_IN(conn, len);
 		/* Register event with callback */
 		API_EVENT(conn, NETCONN_EVT_RCVPLUS, len);
 	}
@@ -293,6 +301,7 @@ static err_t recv_tcp(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
 #if LWIP_SO_RCVBUF
 		SYS_ARCH_INC(conn->recv_avail, len);
 #endif							/* LWIP_SO_RCVBUF */
+		NETCONN_RECVQ_IN(conn, len);
 		/* Register event with callback */
 		API_EVENT(conn, NETCONN_EVT_RCVPLUS, len);
 	}
@@ -343,6 +352,31 @@ static err_t poll_tcp(void *arg, struct tcp_pcb *pcb)
 	return ERR_OK;
 }
 
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * Complete the zero-copy writes of a TCP netconn.
+ * With err == ERR_OK, the writes whose data has been acknowledged by the
+ * remote side are completed. Otherwise the pcb is gone and all pending
+ * writes fail with err.
+ *
+ * @param conn the TCP netconn
+ * @param err ERR_OK or the reason the connection went away
+ */
+static void netconn_zc_complete(struct netconn *conn, err_t err)
+{
+	struct netconn_zc *zc;
+
+	while ((zc = conn->zc_pending) != NULL) {
+		if ((err == ERR_OK) && ((s32_t)(conn->zc_acked - zc->end) < 0)) {
+			break;
+		}
+		conn->zc_pending = zc->next;
+		zc->done(zc->arg, (err == ERR_OK) ? 0 : -err_to_errno(err));
+		mem_free(zc);
+	}
+}
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+
 /**
  * Sent callback function for TCP netconns.
  * Signals the conn->sem and calls API_EVENT.
@@ -358,6 +392,10 @@ static err_t sent_tcp(void *arg, struct tcp_pcb *pcb, u16_t len)
 	LWIP_ASSERT("conn != NULL", (conn != NULL));
 
 	if (conn) {
+#if LWIP_SOCKET_ZEROCOPY
+		conn->zc_acked += len;
+		netconn_zc_complete(conn, ERR_OK);
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 		if (conn->state == NETCONN_WRITE) {
 			lwip_netconn_do_writemore(conn WRITE_DELAYED);
 		} else if (conn->state == NETCONN_CLOSE) {
@@ -392,6 +430,11 @@ static void err_tcp(void *arg, err_t err)
 
 	conn->pcb.tcp = NULL;
 
+#if LWIP_SOCKET_ZEROCOPY
+	/* the pcb and its segments are gone: pending zero-copy writes fail */
+	netconn_zc_complete(conn, err);
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+
 	/* reset conn->state now before waking up other threads */
 	old_state = conn->state;
 	conn->state = NETCONN_NONE;
@@ -704,6 +747,11 @@ struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback)
 #if LWIP_TCP
 	conn->current_msg = NULL;
 	conn->write_offset = 0;
+#if LWIP_SOCKET_ZEROCOPY
+	conn->zc_written = 0;
+	conn->zc_acked = 0;
+	conn->zc_pending = NULL;
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 #endif							/* LWIP_TCP */
 #if LWIP_SO_SNDTIMEO
 	conn->send_timeout = 0;
@@ -715,6 +763,12 @@ struct netconn *netconn_alloc(enum netconn_type t, netconn_callback callback)
 	conn->recv_bufsize = RECV_BUFSIZE_DEFAULT;
 	conn->recv_avail = 0;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_STATS_PERF
+	conn->recvq_in = 0;
+	conn->recvq_out = 0;
+	conn->recvq_hwm = 0;
+	conn->recvq_drops = 0;
+#endif							/* LWIP_STATS_PERF */
 #if LWIP_SO_LINGER
 	conn->linger = -1;
 #endif							/* LWIP_SO_LINGER */
@@ -863,7 +917,12 @@ static err_t lwip_netconn_do_close_internal(struct netconn *conn WRITE_DELAYED_P
 			tcp_recv(tpcb, NULL);
 			tcp_accept(tpcb, NULL);
 		}
-		if (shut_tx) {
+		if (shut_tx
+#if LWIP_SOCKET_ZEROCOPY
+			/* keep counting acknowledged bytes for pending zero-copy writes */
+			&& (conn->zc_pending == NULL)
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+		   ) {
 			tcp_sent(tpcb, NULL);
 		}
 		if (close) {
@@ -873,11 +932,22 @@ static err_t lwip_netconn_do_close_internal(struct netconn *conn WRITE_DELAYED_P
 	}
 	/* Try to close the connection */
 	if (close) {
+#if LWIP_SOCKET_ZEROCOPY
+		err = ERR_OK;
+		if (conn->zc_pending != NULL) {
+			/* zero-copy data is still unacknowledged: a graceful close would keep
+			   sending from application buffers nobody waits for any more, so fail
+			   the pending writes and reset the connection */
+			netconn_zc_complete(conn, ERR_ABRT);
+			tcp_abort(tpcb);
+			tpcb = NULL;
+		}
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 #if LWIP_SO_LINGER
 		/* check linger possibilites before calling tcp_close */
 		err = ERR_OK;
 		/* linger enabled/required at all? (i.e. is there untransmitted data left?) */
-		if ((conn->linger >= 0) && (conn->pcb.tcp->unsent || conn->pcb.tcp->unacked)) {
+		if ((tpcb != NULL) && (conn->linger >= 0) && (conn->pcb.tcp->unsent || conn->pcb.tcp->unacked)) {
 			if ((conn->linger == 0)) {
 				/* data left but linger prevents waiting */
 				tcp_abort(tpcb);
@@ -898,8 +968,10 @@ static err_t lwip_netconn_do_close_internal(struct netconn *conn WRITE_DELAYED_P
 				}
 			}
 		}
-		if ((err == ERR_OK) && (tpcb != NULL))
 #endif							/* LWIP_SO_LINGER */
+#if LWIP_SO_LINGER || LWIP_SOCKET_ZEROCOPY
+		if ((err == ERR_OK) && (tpcb != NULL))
+#endif							/* LWIP_SO_LINGER || LWIP_SOCKET_ZEROCOPY */
 		{
 			err = tcp_close(tpcb);
 		}
@@ -1360,6 +1432,54 @@ void lwip_netconn_do_listen(void *m)
 }
 #endif							/* LWIP_TCP */
 
+/**
+ * Send one netbuf on the pcb of a UDP or RAW netconn: to the address of
+ * the netbuf, or to the connected remote if that is 'any'.
+ *
+ * @param conn the UDP or RAW netconn
+ * @param b the netbuf to send
+ * @return the result of the pcb send function, ERR_CONN if there is no pcb
+ */
+static err_t netconn_send_netbuf(struct netconn *conn, struct netbuf *b)
+{
+	err_t err = ERR_CONN;
+
+	if (conn->pcb.tcp != NULL) {
+		switch (NETCONNTYPE_GROUP(conn->type)) {
+#if LWIP_RAW
+		case NETCONN_RAW:
+			if (ip_addr_isany(&b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = raw_send(conn->pcb.raw, b->p);
+			} else {
+				err = raw_sendto(conn->pcb.raw, b->p, &b->addr);
+			}
+			break;
+#endif
+#if LWIP_UDP
+		case NETCONN_UDP:
+#if LWIP_CHECKSUM_ON_COPY
+			if (ip_addr_isany(&b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = udp_send_chksum(conn->pcb.udp, b->p, b->flags & NETBUF_FLAG_CHKSUM, b->toport_chksum);
+			} else {
+				err = udp_sendto_chksum(conn->pcb.udp, b->p, &b->addr, b->port, b->flags & NETBUF_FLAG_CHKSUM, b->toport_chksum);
+			}
+#else							/* LWIP_CHECKSUM_ON_COPY */
+			if (ip_addr_isany_val(b->addr) || IP_IS_ANY_TYPE_VAL(b->addr)) {
+				err = udp_send(conn->pcb.udp, b->p);
+			} else {
+				err = udp_sendto(conn->pcb.udp, b->p, &b->addr, b->port);
+			}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+			break;
+#endif							/* LWIP_UDP */
+		default:
+			break;
+		}
+	}
+
+	return err;
+}
+
 /**
  * Send some data on a RAW or UDP pcb contained in a netconn
  * Called from netconn_send
@@ -1373,38 +1493,33 @@ void lwip_netconn_do_send(void *m)
 	if (ERR_IS_FATAL(msg->conn->last_err)) {
 		msg->err = msg->conn->last_err;
 	} else {
-		msg->err = ERR_CONN;
-		if (msg->conn->pcb.tcp != NULL) {
-			switch (NETCONNTYPE_GROUP(msg->conn->type)) {
-#if LWIP_RAW
-			case NETCONN_RAW:
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = raw_send(msg->conn->pcb.raw, msg->msg.b->p);
-				} else {
-					msg->err = raw_sendto(msg->conn->pcb.raw, msg->msg.b->p, &msg->msg.b->addr);
-				}
-				break;
-#endif
-#if LWIP_UDP
-			case NETCONN_UDP:
-#if LWIP_CHECKSUM_ON_COPY
-				if (ip_addr_isany(&msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send_chksum(msg->conn->pcb.udp, msg->msg.b->p, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				} else {
-					msg->err = udp_sendto_chksum(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port, msg->msg.b->flags & NETBUF_FLAG_CHKSUM, msg->msg.b->toport_chksum);
-				}
-#else							/* LWIP_CHECKSUM_ON_COPY */
-				if (ip_addr_isany_val(msg->msg.b->addr) || IP_IS_ANY_TYPE_VAL(msg->msg.b->addr)) {
-					msg->err = udp_send(msg->conn->pcb.udp, msg->msg.b->p);
-				} else {
-					msg->err = udp_sendto(msg->conn->pcb.udp, msg->msg.b->p, &msg->msg.b->addr, msg->msg.b->port);
-				}
-#endif							/* LWIP_CHECKSUM_ON_COPY */
-				break;
-#endif							/* LWIP_UDP */
-			default:
+		msg->err = netconn_send_netbuf(msg->conn, msg->msg.b);
+	}
+	TCPIP_APIMSG_ACK(msg);
+}
+
+/**
+ * Send a batch of netbufs on a RAW or UDP pcb contained in a netconn,
+ * stopping at the first one that fails.
+ * Called from netconn_send_batch
+ *
+ * @param m the api_msg_msg pointing to the connection and the netbufs
+ */
+void lwip_netconn_do_send_batch(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+
+	msg->msg.sb.sent = 0;
+	if (ERR_IS_FATAL(msg->conn->last_err)) {
+		msg->err = msg->conn->last_err;
+	} else {
+		msg->err = ERR_OK;
+		while (msg->msg.sb.sent < msg->msg.sb.count) {
+			msg->err = netconn_send_netbuf(msg->conn, msg->msg.sb.bufs[msg->msg.sb.sent]);
+			if (msg->err != ERR_OK) {
 				break;
 			}
+			msg->msg.sb.sent++;
 		}
 	}
 	TCPIP_APIMSG_ACK(msg);
@@ -1435,6 +1550,34 @@ void lwip_netconn_do_recv(void *m)
 	TCPIP_APIMSG_ACK(msg);
 }
 
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+/**
+ * Queue a zero-copy completion behind the data written so far.
+ * Called from netconn_zc_notify. The completion fires right away if that
+ * data has already been acknowledged.
+ *
+ * @param m the api_msg_msg pointing to the connection and the completion
+ */
+void lwip_netconn_do_zc_notify(void *m)
+{
+	struct api_msg *msg = (struct api_msg *)m;
+	struct netconn *conn = msg->conn;
+	struct netconn_zc **tail;
+
+	if ((NETCONNTYPE_GROUP(conn->type) != NETCONN_TCP) || (conn->pcb.tcp == NULL)) {
+		msg->err = ERR_CONN;
+	} else {
+		msg->msg.zc.zc->next = NULL;
+		msg->msg.zc.zc->end = conn->zc_written;
+		for (tail = &conn->zc_pending; *tail != NULL; tail = &(*tail)->next) ;
+		*tail = msg->msg.zc.zc;
+		netconn_zc_complete(conn, ERR_OK);
+		msg->err = ERR_OK;
+	}
+	TCPIP_APIMSG_ACK(msg);
+}
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
+
 #if TCP_LISTEN_BACKLOG
 /** Indicate that a TCP pcb has been accepted
  * Called from netconn_accept
@@ -1542,6 +1685,9 @@ err_mem:
 		if (err == ERR_OK) {
 			err_t out_err;
 			conn->write_offset += len;
+#if LWIP_SOCKET_ZEROCOPY
+			conn->zc_written += len;
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 			if ((conn->write_offset == conn->current_msg->msg.w.len) || dontblock) {
 				/* return sent length */
 				conn->current_msg->msg.w.len = conn->write_offset;
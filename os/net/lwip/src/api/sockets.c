@@ -258,6 +258,8 @@ struct lwip_select_cb {
 	sys_sem_t *poll_sem;
 	/** Pointer to event-set of requested poll events */
 	pollevent_t events;
+	/** pollfd to report the returned events in */
+	struct pollfd *fds;
 	/** socket descriptor value */
 	int sfd;
 	/** semaphore to wake up a task waiting for select */
@@ -791,6 +793,46 @@ int lwip_listen(int s, int backlog)
 	return 0;
 }
 
+/**
+ * Store the source address of received data in a sockaddr.
+ *
+ * @param sock the socket the data was received on
+ * @param buf the received pbuf (TCP) or netbuf (UDP, RAW)
+ * @param from the sockaddr to fill
+ * @param fromlen on input the size of 'from', on output the size stored
+ */
+static void lwip_recv_fromaddr(struct lwip_sock *sock, void *buf, struct sockaddr *from, socklen_t *fromlen)
+{
+	u16_t port;
+	ip_addr_t tmpaddr;
+	ip_addr_t *fromaddr;
+	union sockaddr_aligned saddr;
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		fromaddr = &tmpaddr;
+		netconn_getaddr(sock->conn, fromaddr, &port, 0);
+	} else {
+		port = netbuf_fromport((struct netbuf *)buf);
+		fromaddr = netbuf_fromaddr((struct netbuf *)buf);
+	}
+
+#if LWIP_IPV4 && LWIP_IPV6
+	/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
+	if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
+		ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
+		IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+	IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
+	ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
+	LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F "\n", port));
+	if (*fromlen > saddr.sa.sa_len) {
+		*fromlen = saddr.sa.sa_len;
+	}
+	MEMCPY(from, &saddr, *fromlen);
+}
+
 int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from, socklen_t *fromlen)
 {
 	struct lwip_sock *sock;
@@ -895,34 +937,8 @@ int lwip_recvfrom(int s, void *mem, size_t len, int flags, struct sockaddr *from
 		/* Check to see from where the data was. */
 		if (done) {
 			if (from && fromlen) {
-				u16_t port;
-				ip_addr_t tmpaddr;
-				ip_addr_t *fromaddr;
-				union sockaddr_aligned saddr;
-				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): addr=", s));
-				if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
-					fromaddr = &tmpaddr;
-					netconn_getaddr(sock->conn, fromaddr, &port, 0);
-				} else {
-					port = netbuf_fromport((struct netbuf *)buf);
-					fromaddr = netbuf_fromaddr((struct netbuf *)buf);
-				}
-
-#if LWIP_IPV4 && LWIP_IPV6
-				/* Dual-stack: Map IPv4 addresses to IPv4 mapped IPv6 */
-				if (NETCONNTYPE_ISIPV6(netconn_type(sock->conn)) && IP_IS_V4(fromaddr)) {
-					ip4_2_ipv4_mapped_ipv6(ip_2_ip6(fromaddr), ip_2_ip4(fromaddr));
-					IP_SET_TYPE(fromaddr, IPADDR_TYPE_V6);
-				}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
-
-				IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
-				ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
-				LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%" U16_F " len=%d\n", port, off));
-				if (*fromlen > saddr.sa.sa_len) {
-					*fromlen = saddr.sa.sa_len;
-				}
-				MEMCPY(from, &saddr, *fromlen);
+				LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): len=%d addr=", s, off));
+				lwip_recv_fromaddr(sock, buf, from, fromlen);
 			}
 		}
 
@@ -996,6 +1012,94 @@ int lwip_send(int s, const void *data, size_t size, int flags)
 	return (err == ERR_OK ? (int)written : -1);
 }
 
+#if LWIP_UDP || LWIP_RAW
+/**
+ * Fill a netbuf with the destination and the IO vectors of a message.
+ * The netbuf must be empty; on failure, the pbufs already attached are
+ * left to the caller to free with the netbuf.
+ *
+ * @param msg the message to send
+ * @param chain_buf the netbuf to fill
+ * @param size receives the length of the datagram
+ * @return ERR_OK, ERR_ARG for an invalid message or ERR_MEM
+ */
+static err_t lwip_msg_to_netbuf(const struct msghdr *msg, struct netbuf *chain_buf, int *size)
+{
+	err_t err = ERR_OK;
+	int i;
+
+	LWIP_ERROR("lwip_sendmsg: invalid msghdr iov", (msg->msg_iov != NULL && msg->msg_iovlen != 0), return ERR_ARG;);
+	LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), return ERR_ARG;);
+
+	*size = 0;
+	if (msg->msg_name) {
+		u16_t remote_port;
+		SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &chain_buf->addr, remote_port);
+		netbuf_fromport(chain_buf) = remote_port;
+	}
+#if LWIP_NETIF_TX_SINGLE_PBUF
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		*size += msg->msg_iov[i].iov_len;
+	}
+	/* Allocate a new netbuf and copy the data into it. */
+	if (netbuf_alloc(chain_buf, (u16_t) *size) == NULL) {
+		err = ERR_MEM;
+	} else {
+		/* flatten the IO vectors */
+		size_t offset = 0;
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+			offset += msg->msg_iov[i].iov_len;
+		}
+#if LWIP_CHECKSUM_ON_COPY
+		{
+			/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
+			u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
+			netbuf_set_chksum(chain_buf, chksum);
+		}
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+		err = ERR_OK;
+	}
+#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
+	/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
+	   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
+		if (p == NULL) {
+			err = ERR_MEM;	/* let netbuf_delete() cleanup chain_buf */
+			break;
+		}
+		p->payload = msg->msg_iov[i].iov_base;
+		LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
+		p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
+		/* netbuf empty, add new pbuf */
+		if (chain_buf->p == NULL) {
+			chain_buf->p = chain_buf->ptr = p;
+			/* add pbuf to existing pbuf chain */
+		} else {
+			pbuf_cat(chain_buf->p, p);
+		}
+	}
+	/* save size of total chain */
+	if (err == ERR_OK) {
+		*size = netbuf_len(chain_buf);
+	}
+#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
+
+#if LWIP_IPV4 && LWIP_IPV6
+	if (err == ERR_OK) {
+		/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+		if (IP_IS_V6_VAL(chain_buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&chain_buf->addr))) {
+			unmap_ipv4_mapped_ipv6(ip_2_ip4(&chain_buf->addr), ip_2_ip6(&chain_buf->addr));
+			IP_SET_TYPE_VAL(chain_buf->addr, IPADDR_TYPE_V4);
+		}
+	}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+	return err;
+}
+#endif							/* LWIP_UDP || LWIP_RAW */
+
 int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 {
 	struct lwip_sock *sock;
@@ -1060,7 +1164,6 @@ int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 		struct netbuf *chain_buf;
 
 		LWIP_UNUSED_ARG(flags);
-		LWIP_ERROR("lwip_sendmsg: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
 
 		/* initialize chain buffer with destination */
 		chain_buf = netbuf_new();
@@ -1068,69 +1171,9 @@ int lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 			sock_set_errno(sock, err_to_errno(ERR_MEM));
 			return -1;
 		}
-		if (msg->msg_name) {
-			u16_t remote_port;
-			SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &chain_buf->addr, remote_port);
-			netbuf_fromport(chain_buf) = remote_port;
-		}
-#if LWIP_NETIF_TX_SINGLE_PBUF
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			size += msg->msg_iov[i].iov_len;
-		}
-		/* Allocate a new netbuf and copy the data into it. */
-		if (netbuf_alloc(chain_buf, (u16_t) size) == NULL) {
-			err = ERR_MEM;
-		} else {
-			/* flatten the IO vectors */
-			size_t offset = 0;
-			for (i = 0; i < msg->msg_iovlen; i++) {
-				MEMCPY(&((u8_t *) chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
-				offset += msg->msg_iov[i].iov_len;
-			}
-#if LWIP_CHECKSUM_ON_COPY
-			{
-				/* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
-				u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
-				netbuf_set_chksum(chain_buf, chksum);
-			}
-#endif							/* LWIP_CHECKSUM_ON_COPY */
-			err = ERR_OK;
-		}
-#else							/* LWIP_NETIF_TX_SINGLE_PBUF */
-		/* create a chained netbuf from the IO vectors. NOTE: we assemble a pbuf chain
-		   manually to avoid having to allocate, chain, and delete a netbuf for each iov */
-		for (i = 0; i < msg->msg_iovlen; i++) {
-			struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, 0, PBUF_REF);
-			if (p == NULL) {
-				err = ERR_MEM;	/* let netbuf_delete() cleanup chain_buf */
-				break;
-			}
-			p->payload = msg->msg_iov[i].iov_base;
-			LWIP_ASSERT("iov_len < u16_t", msg->msg_iov[i].iov_len <= 0xFFFF);
-			p->len = p->tot_len = (u16_t) msg->msg_iov[i].iov_len;
-			/* netbuf empty, add new pbuf */
-			if (chain_buf->p == NULL) {
-				chain_buf->p = chain_buf->ptr = p;
-				/* add pbuf to existing pbuf chain */
-			} else {
-				pbuf_cat(chain_buf->p, p);
-			}
-		}
-		/* save size of total chain */
-		if (err == ERR_OK) {
-			size = netbuf_len(chain_buf);
-		}
-#endif							/* LWIP_NETIF_TX_SINGLE_PBUF */
 
+		err = lwip_msg_to_netbuf(msg, chain_buf, &size);
 		if (err == ERR_OK) {
-#if LWIP_IPV4 && LWIP_IPV6
-			/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
-			if (IP_IS_V6_VAL(chain_buf->addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&chain_buf->addr))) {
-				unmap_ipv4_mapped_ipv6(ip_2_ip4(&chain_buf->addr), ip_2_ip6(&chain_buf->addr));
-				IP_SET_TYPE_VAL(chain_buf->addr, IPADDR_TYPE_V4);
-			}
-#endif							/* LWIP_IPV4 && LWIP_IPV6 */
-
 			/* send the data */
 			err = netconn_send(sock->conn, chain_buf);
 		}
@@ -1301,6 +1344,496 @@ int lwip_writev(int s, const struct iovec *iov, int iovcnt)
 	return lwip_sendmsg(s, &msg, 0);
 }
 
+/**
+ * Send several messages. Datagrams are passed to the tcpip thread in
+ * batches of up to LWIP_SOCKET_MMSG_BATCH, one message per batch; TCP
+ * messages are sent one by one.
+ *
+ * @return the number of messages sent (msg_len of each is set), or -1 if
+ *         the first one failed
+ */
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	struct lwip_sock *sock;
+	unsigned int nsent = 0;
+	err_t err = ERR_OK;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_sendmmsg: invalid msgvec", (msgvec != NULL) || (vlen == 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		int ret;
+
+		for (nsent = 0; nsent < vlen; nsent++) {
+			ret = lwip_sendmsg(s, &msgvec[nsent].msg_hdr, flags);
+			if (ret < 0) {
+				break;
+			}
+			msgvec[nsent].msg_len = (unsigned int)ret;
+		}
+		if (nsent == 0 && vlen > 0) {
+			return -1;
+		}
+		sock_set_errno(sock, 0);
+		return (int)nsent;
+	}
+	/* else, UDP and RAW NETCONNs */
+#if LWIP_UDP || LWIP_RAW
+	LWIP_UNUSED_ARG(flags);
+
+	while (nsent < vlen && err == ERR_OK) {
+		struct netbuf bufs[LWIP_SOCKET_MMSG_BATCH];
+		struct netbuf *bufp[LWIP_SOCKET_MMSG_BATCH];
+		int sizes[LWIP_SOCKET_MMSG_BATCH];
+		u16_t count = 0;
+		u16_t sent = 0;
+		u16_t i;
+
+		/* prepare as many datagrams as fit in one batch */
+		while ((count < LWIP_SOCKET_MMSG_BATCH) && (nsent + count < vlen)) {
+			memset(&bufs[count], 0, sizeof(struct netbuf));
+			ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &bufs[count].addr);
+			bufp[count] = &bufs[count];
+			err = lwip_msg_to_netbuf(&msgvec[nsent + count].msg_hdr, &bufs[count], &sizes[count]);
+			if (err != ERR_OK) {
+				netbuf_free(&bufs[count]);
+				break;
+			}
+			count++;
+		}
+
+		if (count > 0) {
+			err_t serr = netconn_send_batch(sock->conn, bufp, count, &sent);
+			if (err == ERR_OK) {
+				err = serr;
+			}
+		}
+
+		for (i = 0; i < count; i++) {
+			if (i < sent) {
+				msgvec[nsent + i].msg_len = (unsigned int)sizes[i];
+			}
+			netbuf_free(&bufs[i]);
+		}
+		nsent += sent;
+		if (sent < count) {
+			/* the batch failed part way: report its error for the next message */
+			break;
+		}
+	}
+
+	if (nsent == 0 && vlen > 0) {
+		sock_set_errno(sock, err_to_errno(err));
+		return -1;
+	}
+	sock_set_errno(sock, 0);
+	return (int)nsent;
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+
+/**
+ * Receive several messages: the first one as recvfrom() would, then as
+ * many more as are already queued without waiting. Each message is
+ * received into its first IO vector.
+ *
+ * @return the number of messages received (msg_len of each is set), or -1
+ *         if none could be received
+ */
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	struct lwip_sock *sock;
+	struct msghdr *msg;
+	unsigned int nrecv;
+	int ret;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_recvmmsg: invalid msgvec", (msgvec != NULL) || (vlen == 0), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	flags &= ~MSG_WAITFORONE;
+	for (nrecv = 0; nrecv < vlen; nrecv++) {
+		msg = &msgvec[nrecv].msg_hdr;
+		if ((msg->msg_iov == NULL) || (msg->msg_iovlen == 0)) {
+			sock_set_errno(sock, EINVAL);
+			ret = -1;
+			break;
+		}
+
+		if (nrecv > 0 && sock->lastdata == NULL && sock->rcvevent <= 0) {
+			/* nothing more is queued */
+			break;
+		}
+
+		ret = lwip_recvfrom(s, msg->msg_iov[0].iov_base, msg->msg_iov[0].iov_len, flags | ((nrecv > 0) ? MSG_DONTWAIT : 0), (struct sockaddr *)msg->msg_name, msg->msg_name ? &msg->msg_namelen : NULL);
+		if (ret < 0) {
+			break;
+		}
+		msg->msg_controllen = 0;
+		msg->msg_flags = 0;
+		msgvec[nrecv].msg_len = (unsigned int)ret;
+		if (ret == 0 && NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+			/* end of stream */
+			nrecv++;
+			break;
+		}
+	}
+
+	if (nrecv == 0 && vlen > 0) {
+		return -1;
+	}
+	sock_set_errno(sock, 0);
+	return (int)nrecv;
+}
+
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * Receive a datagram or the next part of a TCP stream without copying it.
+ * The payload is lent to the caller as IO vectors pointing into the pbuf
+ * chain, which is handed over as *zcbuf and freed by lwip_zc_release().
+ * If msg->msg_iovlen is too small, EMSGSIZE is returned, msg->msg_iovlen
+ * is set to the number of vectors needed and the data stays queued.
+ */
+int lwip_recvmsg_zc(int s, struct msghdr *msg, int flags, void **zcbuf)
+{
+	struct lwip_sock *sock;
+	void *buf;
+	struct pbuf *p;
+	struct pbuf *q;
+	u16_t off;
+	int niov;
+	int total;
+	err_t err;
+
+	LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmsg_zc(%d, %p, 0x%x, ..)\n", s, msg, flags));
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_recvmsg_zc: invalid arguments", (msg != NULL) && (msg->msg_iov != NULL) && (msg->msg_iovlen > 0) && (zcbuf != NULL), sock_set_errno(sock, EINVAL); return -1;);
+	if ((flags & MSG_PEEK) != 0) {
+		sock_set_errno(sock, EOPNOTSUPP);
+		return -1;
+	}
+
+	*zcbuf = NULL;
+	if (sock->lastdata == NULL) {
+		if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) && (sock->rcvevent <= 0)) {
+			set_errno(EWOULDBLOCK);
+			return -1;
+		}
+
+		if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+			err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
+		} else {
+			err = netconn_recv(sock->conn, (struct netbuf **)&buf);
+		}
+
+		if (err != ERR_OK) {
+			LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmsg_zc(%d): error is \"%s\"!\n", s, lwip_strerr(err)));
+			sock_set_errno(sock, err_to_errno(err));
+			if (err == ERR_CLSD) {
+				sock->conn->last_err = ERR_OK;
+				return 0;
+			}
+			return -1;
+		}
+		LWIP_ASSERT("buf != NULL", buf != NULL);
+		sock->lastdata = buf;
+	}
+	buf = sock->lastdata;
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		p = (struct pbuf *)buf;
+	} else {
+		p = ((struct netbuf *)buf)->p;
+	}
+
+	/* skip what a previous lwip_recvfrom() already consumed */
+	off = sock->lastoffset;
+	for (q = p; (q != NULL) && (off >= q->len); q = q->next) {
+		off -= q->len;
+	}
+
+	niov = 0;
+	for (p = q; p != NULL; p = p->next) {
+		niov++;
+	}
+	if (niov > msg->msg_iovlen) {
+		msg->msg_iovlen = niov;
+		sock_set_errno(sock, EMSGSIZE);
+		return -1;
+	}
+
+	niov = 0;
+	total = 0;
+	for (p = q; p != NULL; p = p->next) {
+		msg->msg_iov[niov].iov_base = (u8_t *)p->payload + off;
+		msg->msg_iov[niov].iov_len = p->len - off;
+		total += p->len - off;
+		off = 0;
+		niov++;
+	}
+	msg->msg_iovlen = niov;
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	if ((msg->msg_name != NULL) && (msg->msg_namelen > 0)) {
+		LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmsg_zc(%d): len=%d addr=", s, total));
+		lwip_recv_fromaddr(sock, buf, (struct sockaddr *)msg->msg_name, &msg->msg_namelen);
+	}
+
+	/* hand the whole pbuf chain over to the caller */
+	sock->lastdata = NULL;
+	sock->lastoffset = 0;
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+		*zcbuf = buf;
+	} else {
+		struct netbuf *nbuf = (struct netbuf *)buf;
+		*zcbuf = nbuf->p;
+		nbuf->p = nbuf->ptr = NULL;
+		netbuf_delete(nbuf);
+	}
+
+	sock_set_errno(sock, 0);
+	return total;
+}
+
+/**
+ * Give back the buffers lent by lwip_recvmsg_zc().
+ */
+int lwip_zc_release(void *zcbuf)
+{
+	if (zcbuf == NULL) {
+		set_errno(EINVAL);
+		return -1;
+	}
+
+	pbuf_free((struct pbuf *)zcbuf);
+	return 0;
+}
+
+#if (LWIP_UDP || LWIP_RAW) && !LWIP_NETIF_TX_SINGLE_PBUF
+/** The buffers of a datagram sent by lwip_sendmsg_zc(): one custom PBUF_REF
+ * per IO vector, all allocated with the datagram. */
+struct lwip_zc_pbuf {
+	struct pbuf_custom pc;
+	struct lwip_zc_dgram *dgram;
+};
+
+struct lwip_zc_dgram {
+	void (*done)(void *arg, int result);
+	void *arg;
+	int result;
+	int refs;
+	struct lwip_zc_pbuf pbufs[1];
+};
+
+/** custom_free_function of the pbufs of a zero-copy datagram: completes the
+ * datagram when the stack has released its last pbuf */
+static void lwip_zc_dgram_free(struct pbuf *p)
+{
+	struct lwip_zc_dgram *dgram = ((struct lwip_zc_pbuf *)p)->dgram;
+	int refs;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	refs = --dgram->refs;
+	SYS_ARCH_UNPROTECT(lev);
+
+	if (refs == 0) {
+		if (dgram->done != NULL) {
+			dgram->done(dgram->arg, dgram->result);
+		}
+		mem_free(dgram);
+	}
+}
+#endif							/* (LWIP_UDP || LWIP_RAW) && !LWIP_NETIF_TX_SINGLE_PBUF */
+
+/**
+ * Send from caller-owned buffers without copying them. done(arg, result)
+ * is called once the stack no longer references the buffers: for TCP when
+ * the data has been acknowledged, for UDP and RAW when the last pbuf of the
+ * datagram has been freed by the stack or the driver. done is called if and
+ * only if a non-negative value is returned.
+ */
+int lwip_sendmsg_zc(int s, const struct msghdr *msg, int flags, void (*done)(void *arg, int result), void *arg)
+{
+	struct lwip_sock *sock;
+	int i;
+	int size = 0;
+	err_t err = ERR_OK;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	LWIP_ERROR("lwip_sendmsg_zc: invalid arguments", (msg != NULL) && (msg->msg_iov != NULL) && (msg->msg_iovlen > 0) && (done != NULL), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+#if LWIP_TCP
+		struct netconn_zc *zc;
+		u8_t write_flags;
+		size_t written;
+
+		/* allocate the completion first so that nothing is queued if this fails */
+		zc = (struct netconn_zc *)mem_malloc(sizeof(struct netconn_zc));
+		if (zc == NULL) {
+			sock_set_errno(sock, ENOMEM);
+			return -1;
+		}
+		zc->done = done;
+		zc->arg = arg;
+
+		write_flags = ((flags & MSG_MORE) ? NETCONN_MORE : 0) | ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			u8_t apiflags = write_flags;
+			if (i + 1 < msg->msg_iovlen) {
+				apiflags |= NETCONN_MORE;
+			}
+			written = 0;
+			/* no NETCONN_COPY: the segments reference the caller's buffer */
+			err = netconn_write_partly(sock->conn, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len, apiflags, &written);
+			if (err == ERR_OK) {
+				size += written;
+				if (written != msg->msg_iov[i].iov_len) {
+					break;
+				}
+			} else {
+				if (size > 0) {
+					/* return the partial write, the error persists on the netconn */
+					err = ERR_OK;
+				}
+				break;
+			}
+		}
+
+		if (err == ERR_OK) {
+			if (size > 0) {
+				err = netconn_zc_notify(sock->conn, zc);
+			} else {
+				/* only empty vectors: nothing is referenced */
+				mem_free(zc);
+				done(arg, 0);
+			}
+		}
+		if (err != ERR_OK) {
+			mem_free(zc);
+			sock_set_errno(sock, err_to_errno(err));
+			return -1;
+		}
+		sock_set_errno(sock, 0);
+		return size;
+#else							/* LWIP_TCP */
+		sock_set_errno(sock, err_to_errno(ERR_ARG));
+		return -1;
+#endif							/* LWIP_TCP */
+	}
+	/* else, UDP and RAW NETCONNs */
+#if (LWIP_UDP || LWIP_RAW) && LWIP_NETIF_TX_SINGLE_PBUF
+	/* the netif needs the datagram in one pbuf: copy it and complete now */
+	size = lwip_sendmsg(s, msg, flags);
+	if (size >= 0) {
+		done(arg, 0);
+	}
+	return size;
+#elif LWIP_UDP || LWIP_RAW
+	{
+		struct lwip_zc_dgram *dgram;
+		struct netbuf buf;
+		size_t total = 0;
+		size_t dsize;
+
+		LWIP_UNUSED_ARG(flags);
+		LWIP_ERROR("lwip_sendmsg_zc: invalid msghdr name", (((msg->msg_name == NULL) && (msg->msg_namelen == 0)) || IS_SOCK_ADDR_LEN_VALID(msg->msg_namelen)), sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			total += msg->msg_iov[i].iov_len;
+		}
+		if (total > 0xffff) {
+			sock_set_errno(sock, EMSGSIZE);
+			return -1;
+		}
+
+		dsize = sizeof(struct lwip_zc_dgram) + (msg->msg_iovlen - 1) * sizeof(struct lwip_zc_pbuf);
+		dgram = (dsize == (mem_size_t)dsize) ? (struct lwip_zc_dgram *)mem_malloc((mem_size_t)dsize) : NULL;
+		if (dgram == NULL) {
+			sock_set_errno(sock, ENOMEM);
+			return -1;
+		}
+		dgram->done = done;
+		dgram->arg = arg;
+		dgram->result = 0;
+		dgram->refs = msg->msg_iovlen;
+
+		buf.p = buf.ptr = NULL;
+#if LWIP_CHECKSUM_ON_COPY
+		buf.flags = 0;
+#endif							/* LWIP_CHECKSUM_ON_COPY */
+		if (msg->msg_name) {
+			u16_t remote_port;
+			SOCKADDR_TO_IPADDR_PORT((const struct sockaddr *)msg->msg_name, &buf.addr, remote_port);
+			netbuf_fromport(&buf) = remote_port;
+		} else {
+			ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &buf.addr);
+			netbuf_fromport(&buf) = 0;
+		}
+
+		for (i = 0; i < msg->msg_iovlen; i++) {
+			struct lwip_zc_pbuf *zp = &dgram->pbufs[i];
+			u16_t len = (u16_t)msg->msg_iov[i].iov_len;
+			struct pbuf *p;
+
+			zp->dgram = dgram;
+			zp->pc.custom_free_function = lwip_zc_dgram_free;
+			p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &zp->pc, msg->msg_iov[i].iov_base, len);
+			if (buf.p == NULL) {
+				buf.p = buf.ptr = p;
+			} else {
+				pbuf_cat(buf.p, p);
+			}
+		}
+
+#if LWIP_IPV4 && LWIP_IPV6
+		/* Dual-stack: Unmap IPv4 mapped IPv6 addresses */
+		if (IP_IS_V6_VAL(buf.addr) && ip6_addr_isipv4mappedipv6(ip_2_ip6(&buf.addr))) {
+			unmap_ipv4_mapped_ipv6(ip_2_ip4(&buf.addr), ip_2_ip6(&buf.addr));
+			IP_SET_TYPE_VAL(buf.addr, IPADDR_TYPE_V4);
+		}
+#endif							/* LWIP_IPV4 && LWIP_IPV6 */
+
+		err = netconn_send(sock->conn, &buf);
+
+		/* Our reference on the head keeps the whole chain alive, so the
+		   datagram cannot complete before the result is known. On failure
+		   the caller is told by the return value instead. */
+		if (err != ERR_OK) {
+			dgram->done = NULL;
+		}
+		dgram->result = -err_to_errno(err);
+		netbuf_free(&buf);
+
+		sock_set_errno(sock, err_to_errno(err));
+		return (err == ERR_OK ? (int)total : -1);
+	}
+#else							/* LWIP_UDP || LWIP_RAW */
+	sock_set_errno(sock, err_to_errno(ERR_ARG));
+	return -1;
+#endif							/* LWIP_UDP || LWIP_RAW */
+}
+#endif							/* LWIP_SOCKET_ZEROCOPY */
+
 #if LWIP_SELECT
 
 /**
@@ -1651,6 +2184,7 @@ static int lwip_poll_setup(int fd, struct lwip_sock *sock, struct pollfd *fds)
 	select_cb->sem_signalled = 0;
 	select_cb->poll_sem = fds->sem;
 	select_cb->events = fds->events;
+	select_cb->fds = fds;
 	select_cb->sfd = fd;
 
 	/* Protect the select_cb_list */
@@ -1869,12 +2403,18 @@ again:
 			/* semaphore not signalled yet */
 			int do_signal = 0;
 			int check_set = 0;
+#if !LWIP_SELECT
+			pollevent_t revents = 0;
+#endif
 			/* Test this select call for our socket */
 			if (sock->rcvevent > 0) {
 #if LWIP_SELECT
 				check_set = scb->readset && FD_ISSET(s, scb->readset);
 #else
 				check_set = (scb->sfd == s) && (scb->events & POLLIN);
+				if (check_set) {
+					revents |= POLLIN;
+				}
 #endif
 				if (check_set) {
 					do_signal = 1;
@@ -1885,6 +2425,9 @@ again:
 				check_set = scb->writeset && FD_ISSET(s, scb->writeset);
 #else
 				check_set = (scb->sfd == s) && (scb->events & POLLOUT);
+				if (check_set) {
+					revents |= POLLOUT;
+				}
 #endif
 				if (!do_signal && check_set) {
 					do_signal = 1;
@@ -1895,6 +2438,9 @@ again:
 				check_set = scb->exceptset && FD_ISSET(s, scb->exceptset);
 #else
 				check_set = (scb->sfd == s) && (scb->events & POLLERR);
+				if (check_set) {
+					revents |= POLLERR;
+				}
 #endif
 				if (!do_signal && check_set) {
 					do_signal = 1;
@@ -1907,6 +2453,9 @@ again:
 #if LWIP_SELECT
 				sys_sem_signal(&scb->sem);
 #else
+				/* Report the events right away so that waiters holding
+				   many descriptors (epoll) need not rescan every socket. */
+				scb->fds->revents |= revents;
 				sys_sem_signal(scb->poll_sem);
 #endif
 			}
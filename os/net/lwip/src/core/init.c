@@ -169,6 +169,9 @@ PACK_STRUCT_END
 #error "If you want to use TCP, TCP_WND must fit in an u16_t, so, you have to reduce it in your lwipopts.h (or enable window scaling)"
 #endif
 #endif							/* LWIP_WND_SCALE */
+#if (LWIP_TCP_RACK && !LWIP_TCP_SACK)
+#error "LWIP_TCP_RACK needs LWIP_TCP_SACK enabled in your lwipopts.h"
+#endif
 #if (LWIP_TCP && (TCP_SND_QUEUELEN > 0xffff))
 #error "If you want to use TCP, TCP_SND_QUEUELEN must fit in an u16_t, so, you have to reduce it in your lwipopts.h"
 #endif
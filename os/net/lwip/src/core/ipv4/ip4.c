@@ -406,6 +406,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 		IP_STATS_INC(ip.err);
 		IP_STATS_INC(ip.drop);
 		MIB2_STATS_INC(mib2.ipinhdrerrors);
+		NETIF_DROP_INC(inp, RX_HDR);
 		return ERR_OK;
 	}
 #ifdef LWIP_HOOK_IP4_INPUT
@@ -443,6 +444,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 		IP_STATS_INC(ip.lenerr);
 		IP_STATS_INC(ip.drop);
 		MIB2_STATS_INC(mib2.ipindiscards);
+		NETIF_DROP_INC(inp, RX_HDR);
 		return ERR_OK;
 	}
 
@@ -457,6 +459,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 			IP_STATS_INC(ip.chkerr);
 			IP_STATS_INC(ip.drop);
 			MIB2_STATS_INC(mib2.ipinhdrerrors);
+			NETIF_DROP_INC(inp, RX_CHKSUM);
 			return ERR_OK;
 		}
 	}
@@ -583,6 +586,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 			IP_STATS_INC(ip.drop);
 			MIB2_STATS_INC(mib2.ipinaddrerrors);
 			MIB2_STATS_INC(mib2.ipindiscards);
+			NETIF_DROP_INC(inp, RX_ADDR);
 			return ERR_OK;
 		}
 	}
@@ -602,6 +606,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 			IP_STATS_INC(ip.drop);
 			MIB2_STATS_INC(mib2.ipinaddrerrors);
 			MIB2_STATS_INC(mib2.ipindiscards);
+			NETIF_DROP_INC(inp, RX_ADDR);
 		}
 		pbuf_free(p);
 		return ERR_OK;
@@ -624,6 +629,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 		IP_STATS_INC(ip.drop);
 		/* unsupported protocol feature */
 		MIB2_STATS_INC(mib2.ipinunknownprotos);
+		NETIF_DROP_INC(inp, RX_PROTO);
 		return ERR_OK;
 #endif							/* IP_REASSEMBLY */
 	}
@@ -641,6 +647,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 		IP_STATS_INC(ip.drop);
 		/* unsupported protocol feature */
 		MIB2_STATS_INC(mib2.ipinunknownprotos);
+		NETIF_DROP_INC(inp, RX_PROTO);
 		return ERR_OK;
 	}
 #endif							/* IP_OPTIONS_ALLOWED == 0 */
@@ -705,6 +712,7 @@ err_t ip4_input(struct pbuf *p, struct netif *inp)
 			IP_STATS_INC(ip.proterr);
 			IP_STATS_INC(ip.drop);
 			MIB2_STATS_INC(mib2.ipinunknownprotos);
+			NETIF_DROP_INC(inp, RX_PROTO);
 		}
 	}
 
@@ -59,6 +59,7 @@
 
 #include "lwip/opt.h"
 #include "lwip/debug.h"
+#include "lwip/sys.h"
 #include "lwip/memp.h"
 #include "lwip/pbuf.h"
 #include "lwip/raw.h"
@@ -271,6 +271,9 @@ struct netif *netif_add(struct netif *netif,
 #ifdef netif_get_client_data
 	memset(netif->client_data, 0, sizeof(netif->client_data));
 #endif							/* LWIP_NUM_NETIF_CLIENT_DATA */
+#if LWIP_STATS_PERF
+	memset(netif->drops, 0, sizeof(netif->drops));
+#endif							/* LWIP_STATS_PERF */
 #if LWIP_IPV6_AUTOCONFIG
 	/* IPv6 address autoconfiguration not enabled by default */
 	netif->ip6_autoconfig_enabled = 0;
@@ -767,6 +770,7 @@ err_t netif_loop_output(struct netif *netif, struct pbuf *p)
 		LINK_STATS_INC(link.memerr);
 		LINK_STATS_INC(link.drop);
 		MIB2_STATS_NETIF_INC(stats_if, ifoutdiscards);
+		NETIF_DROP_INC(stats_if, TX_NOBUF);
 		return ERR_MEM;
 	}
 #if LWIP_LOOPBACK_MAX_PBUFS
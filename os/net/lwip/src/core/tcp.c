@@ -142,6 +142,13 @@ struct tcp_pcb **const tcp_pcb_lists[] = { &tcp_listen_pcbs.pcbs, &tcp_bound_pcb
 		   &tcp_active_pcbs, &tcp_tw_pcbs
 };
 
+#if LWIP_PCB_HASH
+/** Hash table over tcp_active_pcbs, keyed on local and remote address and port */
+struct tcp_pcb *tcp_active_hash[LWIP_PCB_HASH_SIZE];
+/** Hash table over tcp_listen_pcbs, keyed on the local port */
+struct tcp_pcb_listen *tcp_listen_hash[LWIP_PCB_HASH_SIZE];
+#endif							/* LWIP_PCB_HASH */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -721,6 +728,7 @@ struct tcp_pcb *tcp_listen_with_backlog_and_err(struct tcp_pcb *pcb, u8_t backlo
 	tcp_backlog_set(lpcb, backlog);
 #endif							/* TCP_LISTEN_BACKLOG */
 	TCP_REG(&tcp_listen_pcbs.pcbs, (struct tcp_pcb *)lpcb);
+	TCP_HASH_REG((struct tcp_pcb *)lpcb);
 	res = ERR_OK;
 done:
 	if (err != NULL) {
@@ -1109,6 +1117,7 @@ tcp_slowtmr_start:
 			enum tcp_state last_state;
 			tcp_pcb_purge(pcb);
 			/* Remove PCB from tcp_active_pcbs list. */
+			TCP_HASH_RMV(pcb);
 			if (prev != NULL) {
 				LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_active_pcbs", pcb != tcp_active_pcbs);
 				prev->next = pcb->next;
@@ -1765,6 +1774,40 @@ void tcp_pcb_purge(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_PCB_HASH
+/**
+ * Adds an active PCB to tcp_active_hash or a listening PCB to
+ * tcp_listen_hash. Called when the PCB is registered with tcp_active_pcbs
+ * or tcp_listen_pcbs.
+ *
+ * @param pcb tcp_pcb (or tcp_pcb_listen in LISTEN state) to hash
+ */
+void tcp_pcb_hash_add(struct tcp_pcb *pcb)
+{
+	if (pcb->state == LISTEN) {
+		struct tcp_pcb_listen *lpcb = (struct tcp_pcb_listen *)pcb;
+		PCB_HASH_ADD(tcp_listen_hash, pcb_hash_port(lpcb->local_port), lpcb);
+	} else {
+		PCB_HASH_ADD(tcp_active_hash, pcb_hash_tuple(&pcb->local_ip, pcb->local_port, &pcb->remote_ip, pcb->remote_port), pcb);
+	}
+}
+
+/**
+ * Removes a PCB from the hash table it is in, if any.
+ *
+ * @param pcb tcp_pcb (or tcp_pcb_listen in LISTEN state) to unhash
+ */
+void tcp_pcb_hash_remove(struct tcp_pcb *pcb)
+{
+	if (pcb->state == LISTEN) {
+		struct tcp_pcb_listen *lpcb = (struct tcp_pcb_listen *)pcb;
+		PCB_HASH_RMV(lpcb);
+	} else {
+		PCB_HASH_RMV(pcb);
+	}
+}
+#endif							/* LWIP_PCB_HASH */
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
@@ -1773,6 +1816,7 @@ void tcp_pcb_purge(struct tcp_pcb *pcb)
  */
 void tcp_pcb_remove(struct tcp_pcb **pcblist, struct tcp_pcb *pcb)
 {
+	TCP_HASH_RMV(pcb);
 	TCP_RMV(pcblist, pcb);
 
 	tcp_pcb_purge(pcb);
@@ -78,6 +78,9 @@
 #if LWIP_ND6_TCP_REACHABILITY_HINTS
 #include "lwip/nd6.h"
 #endif							/* LWIP_ND6_TCP_REACHABILITY_HINTS */
+#if LWIP_TCP_RACK || LWIP_STATS_PERF
+#include "lwip/sys.h"
+#endif							/* LWIP_TCP_RACK || LWIP_STATS_PERF */
 
 /** Initial CWND calculation as defined RFC 2581 */
 #define LWIP_TCP_CALC_INITIAL_CWND(mss) LWIP_MIN((4U * (mss)), LWIP_MAX((2U * (mss)), 4380U));
@@ -99,12 +102,24 @@ static u8_t flags;
 static u8_t recv_flags;
 static struct pbuf *recv_data;
 
+#if LWIP_TCP_SACK
+/* SACK blocks of the incoming segment (left and right edge, host byte order) */
+static u32_t tcp_sack_blocks[2 * LWIP_TCP_SACK_MAX_BLOCKS];
+static u8_t tcp_sack_nblocks;
+#endif							/* LWIP_TCP_SACK */
+
 struct tcp_pcb *tcp_input_pcb;
 
 /* Forward declarations. */
 static err_t tcp_process(struct tcp_pcb *pcb);
 static void tcp_receive(struct tcp_pcb *pcb);
 static void tcp_parseopt(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+static void tcp_sack_update(struct tcp_pcb *pcb);
+#endif							/* LWIP_TCP_SACK */
+#if LWIP_TCP_RACK
+static void tcp_rack_update(struct tcp_pcb *pcb, struct tcp_seg *seg);
+#endif							/* LWIP_TCP_RACK */
 
 static void tcp_listen_input(struct tcp_pcb_listen *pcb);
 static void tcp_timewait_input(struct tcp_pcb *pcb);
@@ -126,6 +141,9 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 	struct tcp_pcb *lpcb_prev = NULL;
 	struct tcp_pcb_listen *lpcb_any = NULL;
 #endif							/* SO_REUSE */
+#if LWIP_PCB_HASH
+	u32_t bucket;
+#endif							/* LWIP_PCB_HASH */
 	u8_t hdrlen_bytes;
 	err_t err;
 
@@ -236,7 +254,12 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 	   for an active connection. */
 	prev = NULL;
 
+#if LWIP_PCB_HASH
+	bucket = pcb_hash_tuple(ip_current_dest_addr(), tcphdr->dest, ip_current_src_addr(), tcphdr->src);
+	for (pcb = tcp_active_hash[bucket]; pcb != NULL; pcb = pcb->hash_next) {
+#else							/* LWIP_PCB_HASH */
 	for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif							/* LWIP_PCB_HASH */
 		LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
 		LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
 		LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
@@ -246,9 +269,13 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 			   arrivals). */
 			LWIP_ASSERT("tcp_input: pcb->next != pcb (before cache)", pcb->next != pcb);
 			if (prev != NULL) {
+#if LWIP_PCB_HASH
+				PCB_HASH_TO_FRONT(tcp_active_hash, bucket, pcb);
+#else							/* LWIP_PCB_HASH */
 				prev->next = pcb->next;
 				pcb->next = tcp_active_pcbs;
 				tcp_active_pcbs = pcb;
+#endif							/* LWIP_PCB_HASH */
 			} else {
 				TCP_STATS_INC(tcp.cachehit);
 			}
@@ -277,7 +304,12 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 		/* Finally, if we still did not get a match, we check all PCBs that
 		   are LISTENing for incoming connections. */
 		prev = NULL;
+#if LWIP_PCB_HASH
+		bucket = pcb_hash_port(tcphdr->dest);
+		for (lpcb = tcp_listen_hash[bucket]; lpcb != NULL; lpcb = lpcb->hash_next) {
+#else							/* LWIP_PCB_HASH */
 		for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+#endif							/* LWIP_PCB_HASH */
 			if (lpcb->local_port == tcphdr->dest) {
 				if (IP_IS_ANY_TYPE_VAL(lpcb->local_ip)) {
 					/* found an ANY TYPE (IPv4/IPv6) match */
@@ -317,11 +349,15 @@ void tcp_input(struct pbuf *p, struct netif *inp)
 			   lookups will be faster (we exploit locality in TCP segment
 			   arrivals). */
 			if (prev != NULL) {
+#if LWIP_PCB_HASH
+				PCB_HASH_TO_FRONT(tcp_listen_hash, bucket, lpcb);
+#else							/* LWIP_PCB_HASH */
 				((struct tcp_pcb_listen *)prev)->next = lpcb->next;
 				/* our successor is the remainder of the listening list */
 				lpcb->next = tcp_listen_pcbs.listen_pcbs;
 				/* put this listening pcb at the head of the listening list */
 				tcp_listen_pcbs.listen_pcbs = lpcb;
+#endif							/* LWIP_PCB_HASH */
 			} else {
 				TCP_STATS_INC(tcp.cachehit);
 			}
@@ -992,12 +1028,26 @@ static void tcp_receive(struct tcp_pcb *pcb)
 	u32_t ooseq_blen;
 	u16_t ooseq_qlen;
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+	u8_t partial_ack = 0;
+#if TCP_QUEUE_OOSEQ
+	u8_t fills_hole;
+#endif							/* TCP_QUEUE_OOSEQ */
+#endif							/* LWIP_TCP_SACK */
 
 	LWIP_ASSERT("tcp_receive: wrong state", pcb->state >= ESTABLISHED);
 
 	if (flags & TCP_ACK) {
 		right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
 
+#if LWIP_TCP_SACK
+		/* Mark what the remote host reported before the dupack logic below
+		   looks at the scoreboard */
+		if ((pcb->flags & TF_SACK) && tcp_sack_nblocks > 0) {
+			tcp_sack_update(pcb);
+		}
+#endif							/* LWIP_TCP_SACK */
+
 		/* Update window. */
 		if (TCP_SEQ_LT(pcb->snd_wl1, seqno) || (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) || (pcb->snd_wl2 == ackno && (u32_t) SND_WND_SCALE(pcb, tcphdr->wnd) > pcb->snd_wnd)) {
 			pcb->snd_wnd = SND_WND_SCALE(pcb, tcphdr->wnd);
@@ -1087,8 +1137,17 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			   in fast retransmit. Also reset the congestion window to the
 			   slow start threshold. */
 			if (pcb->flags & TF_INFR) {
-				pcb->flags &= ~TF_INFR;
-				pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+				if ((pcb->flags & TF_SACK) && TCP_SEQ_LT(ackno, pcb->sack_recover)) {
+					/* Partial ACK: stay in recovery until everything that was
+					   outstanding when it began is acknowledged (RFC 6675) */
+					partial_ack = 1;
+				} else
+#endif							/* LWIP_TCP_SACK */
+				{
+					pcb->flags &= ~TF_INFR;
+					pcb->cwnd = pcb->ssthresh;
+				}
 			}
 
 			/* Reset the number of retransmissions. */
@@ -1102,8 +1161,8 @@ static void tcp_receive(struct tcp_pcb *pcb)
 			pcb->lastack = ackno;
 
 			/* Update the congestion control variables (cwnd and
-			   ssthresh). */
-			if (pcb->state >= ESTABLISHED) {
+			   ssthresh). The window does not grow during recovery. */
+			if (pcb->state >= ESTABLISHED && !(pcb->flags & TF_INFR)) {
 				if (pcb->cwnd < pcb->ssthresh) {
 					if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
 						pcb->cwnd += pcb->mss;
@@ -1132,6 +1191,11 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 				pcb->snd_queuelen -= pbuf_clen(next->p);
 				recv_acked += next->len;
+#if LWIP_TCP_RACK
+				if ((pcb->flags & TF_SACK) && !(next->flags & TF_SEG_SACKED)) {
+					tcp_rack_update(pcb, next);
+				}
+#endif							/* LWIP_TCP_RACK */
 				tcp_seg_free(next);
 
 				LWIP_DEBUGF(TCP_QLEN_DEBUG, ("%" TCPWNDSIZE_F " (after freeing unacked)\n", (tcpwnd_size_t) pcb->snd_queuelen));
@@ -1215,8 +1279,27 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			LWIP_DEBUGF(TCP_RTO_DEBUG, ("tcp_receive: RTO %" U16_F " (%" U16_F " milliseconds)\n", pcb->rto, (u16_t)(pcb->rto * TCP_SLOW_INTERVAL)));
 
+#if LWIP_STATS_PERF
+			/* The estimator above counts slow timer ticks, keep a
+			   millisecond one for monitoring: srtt += (rtt - srtt) / 8 */
+			{
+				u32_t rtt = sys_now() - pcb->perf_rtt_ts;
+				if (pcb->perf_srtt == 0) {
+					pcb->perf_srtt = rtt << 3;
+				} else {
+					pcb->perf_srtt += rtt - (pcb->perf_srtt >> 3);
+				}
+			}
+#endif							/* LWIP_STATS_PERF */
+
 			pcb->rttest = 0;
 		}
+
+#if LWIP_TCP_SACK
+		if ((pcb->flags & TF_SACK) && pcb->unacked != NULL) {
+			tcp_rexmit_sack(pcb, partial_ack);
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 
 	/* If the incoming segment contains data, we must process it
@@ -1322,6 +1405,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 				   we have to trim the end of the segment and update rcv_nxt
 				   and pass the data to the application. */
 				tcplen = TCP_TCPLEN(&inseg);
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+				fills_hole = (pcb->ooseq != NULL);
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 				if (tcplen > pcb->rcv_wnd) {
 					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_receive: other end overran receive window" "seqno %" U32_F " len %" U16_F " right edge %" U32_F "\n", seqno, tcplen, pcb->rcv_nxt + pcb->rcv_wnd));
@@ -1452,7 +1538,16 @@ static void tcp_receive(struct tcp_pcb *pcb)
 #endif							/* TCP_QUEUE_OOSEQ */
 
 				/* Acknowledge the segment(s). */
-				tcp_ack(pcb);
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+				if ((pcb->flags & TF_SACK) && fills_hole) {
+					/* Tell the sender at once that a hole was filled
+					   (RFC 5681, section 4.2) */
+					tcp_ack_now(pcb);
+				} else
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+				{
+					tcp_ack(pcb);
+				}
 
 #if LWIP_IPV6 && LWIP_ND6_TCP_REACHABILITY_HINTS
 				if (ip_current_is_v6()) {
@@ -1463,7 +1558,13 @@ static void tcp_receive(struct tcp_pcb *pcb)
 
 			} else {
 				/* We get here if the incoming segment is out-of-sequence. */
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+				/* The ACK is sent once the segment is queued, so that the
+				   first SACK block can report it */
+				pcb->rcv_sack_recent = seqno;
+#else							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 				tcp_send_empty_ack(pcb);
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 #if TCP_QUEUE_OOSEQ
 				/* We queue the segment on the ->ooseq queue. */
 				if (pcb->ooseq == NULL) {
@@ -1604,6 +1705,9 @@ static void tcp_receive(struct tcp_pcb *pcb)
 					}
 				}
 #endif							/* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+				tcp_send_empty_ack(pcb);
+#endif							/* LWIP_TCP_SACK */
 #endif							/* TCP_QUEUE_OOSEQ */
 			}
 		} else {
@@ -1619,6 +1723,80 @@ static void tcp_receive(struct tcp_pcb *pcb)
 	}
 }
 
+#if LWIP_TCP_RACK
+/**
+ * Remember the most recently sent segment that has been delivered,
+ * together with its RTT.  Called for segments acknowledged cumulatively
+ * or by a SACK block.
+ *
+ * @param pcb the tcp_pcb the segment belongs to
+ * @param seg the delivered segment
+ */
+static void tcp_rack_update(struct tcp_pcb *pcb, struct tcp_seg *seg)
+{
+	u32_t rtt = sys_now() - seg->xmit_time;
+	u32_t end = lwip_ntohl(seg->tcphdr->seqno) + TCP_TCPLEN(seg);
+	s32_t order;
+
+	if ((seg->flags & TF_SEG_RETX) && rtt < pcb->rack_min_rtt) {
+		/* Faster than any RTT seen: this acknowledges the original
+		   transmission, not the retransmission */
+		return;
+	}
+	if (rtt < pcb->rack_min_rtt) {
+		pcb->rack_min_rtt = rtt;
+	}
+
+	order = (s32_t)(seg->xmit_time - pcb->rack_xmit_ts);
+	if (order > 0 || (order == 0 && TCP_SEQ_GT(end, pcb->rack_end_seq))) {
+		pcb->rack_xmit_ts = seg->xmit_time;
+		pcb->rack_end_seq = end;
+		pcb->rack_rtt = rtt;
+	}
+}
+#endif							/* LWIP_TCP_RACK */
+
+#if LWIP_TCP_SACK
+/**
+ * Mark the segments on pcb->unacked that the SACK blocks of the incoming
+ * segment cover.  A segment only counts as SACKed if a block covers it
+ * completely.  Blocks below the cumulative ACK (D-SACK, RFC 2883) and
+ * beyond snd_nxt are ignored.
+ *
+ * @param pcb the tcp_pcb that received the SACK blocks
+ */
+static void tcp_sack_update(struct tcp_pcb *pcb)
+{
+	struct tcp_seg *seg;
+	u32_t left;
+	u32_t right;
+	u32_t seg_seqno;
+	u8_t i;
+
+	for (i = 0; i < tcp_sack_nblocks; i++) {
+		left = tcp_sack_blocks[2 * i];
+		right = tcp_sack_blocks[2 * i + 1];
+		if (!TCP_SEQ_LT(left, right) || TCP_SEQ_LEQ(right, ackno) || TCP_SEQ_GT(right, pcb->snd_nxt)) {
+			continue;
+		}
+
+		for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+			seg_seqno = lwip_ntohl(seg->tcphdr->seqno);
+			if (TCP_SEQ_GEQ(seg_seqno, right)) {
+				break;
+			}
+			if ((seg->flags & TF_SEG_SACKED) == 0 && TCP_SEQ_GEQ(seg_seqno, left) && TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), right)) {
+				LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_sack_update: SACKed %" U32_F ":%" U32_F "\n", seg_seqno, seg_seqno + TCP_TCPLEN(seg)));
+				seg->flags |= TF_SEG_SACKED;
+#if LWIP_TCP_RACK
+				tcp_rack_update(pcb, seg);
+#endif							/* LWIP_TCP_RACK */
+			}
+		}
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 static u8_t tcp_getoptbyte(void)
 {
 	if ((tcphdr_opt2 == NULL) || (tcp_optidx < tcphdr_opt1len)) {
@@ -1646,6 +1824,10 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 	u32_t tsval;
 #endif
 
+#if LWIP_TCP_SACK
+	tcp_sack_nblocks = 0;
+#endif							/* LWIP_TCP_SACK */
+
 	/* Parse the TCP MSS option, if present. */
 	if (tcphdr_optlen != 0) {
 		for (tcp_optidx = 0; tcp_optidx < tcphdr_optlen;) {
@@ -1723,6 +1905,53 @@ static void tcp_parseopt(struct tcp_pcb *pcb)
 				tcp_optidx += LWIP_TCP_OPT_LEN_TS - 6;
 				break;
 #endif
+#if LWIP_TCP_SACK
+			case LWIP_TCP_OPT_SACK_PERM:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+				if (tcp_getoptbyte() != LWIP_TCP_OPT_LEN_SACK_PERM || (tcp_optidx - 2 + LWIP_TCP_OPT_LEN_SACK_PERM) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* SACK-permitted is only valid on a SYN */
+				if ((flags & TCP_SYN) && !(pcb->flags & TF_SACK)) {
+					pcb->flags |= TF_SACK;
+					pcb->sack_recover = pcb->snd_nxt;
+#if LWIP_TCP_RACK
+					pcb->rack_xmit_ts = sys_now();
+					pcb->rack_end_seq = pcb->snd_nxt;
+					/* No RTT sample yet: this disables time-based detection */
+					pcb->rack_min_rtt = 0xFFFFFFFFUL;
+#endif							/* LWIP_TCP_RACK */
+				}
+				break;
+			case LWIP_TCP_OPT_SACK:
+				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+				data = tcp_getoptbyte();
+				if (data < LWIP_TCP_OPT_LEN_SACK(1) || ((data - 2) & 7) != 0 || (tcp_optidx - 2 + data) > tcphdr_optlen) {
+					/* Bad length */
+					LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+					return;
+				}
+				/* Keep the first blocks, the sender lists the most recent first */
+				for (data = (data - 2) / 8; data > 0; data--) {
+					u32_t left = ((u32_t)tcp_getoptbyte() << 24);
+					u32_t right;
+					left |= ((u32_t)tcp_getoptbyte() << 16);
+					left |= ((u32_t)tcp_getoptbyte() << 8);
+					left |= tcp_getoptbyte();
+					right = ((u32_t)tcp_getoptbyte() << 24);
+					right |= ((u32_t)tcp_getoptbyte() << 16);
+					right |= ((u32_t)tcp_getoptbyte() << 8);
+					right |= tcp_getoptbyte();
+					if (tcp_sack_nblocks < LWIP_TCP_SACK_MAX_BLOCKS) {
+						tcp_sack_blocks[2 * tcp_sack_nblocks] = left;
+						tcp_sack_blocks[2 * tcp_sack_nblocks + 1] = right;
+						tcp_sack_nblocks++;
+					}
+				}
+				break;
+#endif							/* LWIP_TCP_SACK */
 			default:
 				LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
 				data = tcp_getoptbyte();
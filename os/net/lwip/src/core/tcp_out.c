@@ -70,7 +70,7 @@
 #include "lwip/ip6.h"
 #include "lwip/ip6_addr.h"
 #include "lwip/priv/tcp_priv.h"
-#if LWIP_TCP_TIMESTAMPS
+#if LWIP_TCP_TIMESTAMPS || LWIP_TCP_RACK || LWIP_STATS_PERF
 #include "lwip/sys.h"
 #endif
 
@@ -781,6 +781,12 @@ err_t tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 			optflags |= TF_SEG_OPTS_WND_SCALE;
 		}
 #endif							/* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+		if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+			/* Likewise, a <SYN,ACK> only permits SACK if the <SYN> did. */
+			optflags |= TF_SEG_OPTS_SACK_PERM;
+		}
+#endif							/* LWIP_TCP_SACK */
 	}
 #if LWIP_TCP_TIMESTAMPS
 	if ((pcb->flags & TF_TIMESTAMP)) {
@@ -869,6 +875,71 @@ static void tcp_build_wnd_scale_option(u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+/** Collect the SACK blocks describing the data held on pcb->ooseq.
+ * The block holding the most recently received segment comes first
+ * (RFC 2018, section 4), the others follow in sequence order.
+ *
+ * @param pcb tcp_pcb
+ * @param blocks where to store left and right edge of each block
+ * @param max maximum number of blocks to store
+ * @return number of blocks stored
+ */
+static u8_t tcp_sack_blocks(struct tcp_pcb *pcb, u32_t *blocks, u8_t max)
+{
+	struct tcp_seg *seg = pcb->ooseq;
+	u32_t left;
+	u32_t right;
+	u8_t n = 0;
+	u8_t i;
+
+	while (seg != NULL && max > 0) {
+		/* Merge adjacent segments into one block */
+		left = seg->tcphdr->seqno;
+		right = left + TCP_TCPLEN(seg);
+		for (seg = seg->next; seg != NULL && seg->tcphdr->seqno == right; seg = seg->next) {
+			right += TCP_TCPLEN(seg);
+		}
+
+		if (TCP_SEQ_BETWEEN(pcb->rcv_sack_recent, left, right - 1)) {
+			/* Move the other blocks up, dropping the last one if full */
+			if (n < max) {
+				n++;
+			}
+			for (i = n - 1; i > 0; i--) {
+				blocks[2 * i] = blocks[2 * (i - 1)];
+				blocks[2 * i + 1] = blocks[2 * (i - 1) + 1];
+			}
+			blocks[0] = left;
+			blocks[1] = right;
+		} else if (n < max) {
+			blocks[2 * n] = left;
+			blocks[2 * n + 1] = right;
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/* Build a SACK option (4 + 8 * n bytes long) at the specified options pointer
+ *
+ * @param opts option pointer where to store the SACK option
+ * @param blocks left and right edge of each block, in host byte order
+ * @param n number of blocks
+ */
+static void tcp_build_sack_option(u32_t *opts, const u32_t *blocks, u8_t n)
+{
+	u8_t i;
+
+	/* Pad with two NOP options to make everything nicely aligned */
+	opts[0] = lwip_htonl(0x01010000 | (LWIP_TCP_OPT_SACK << 8) | LWIP_TCP_OPT_LEN_SACK(n));
+	for (i = 0; i < 2 * n; i++) {
+		opts[1 + i] = lwip_htonl(blocks[i]);
+	}
+}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+
 /**
  * Send an ACK without data.
  *
@@ -880,15 +951,29 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 	struct pbuf *p;
 	u8_t optlen = 0;
 	struct netif *netif;
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	struct tcp_hdr *tcphdr;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	u32_t sack_blocks[2 * LWIP_TCP_SACK_MAX_BLOCKS];
+	u8_t sack_n = 0;
+	u32_t *opts;
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 #if LWIP_TCP_TIMESTAMPS
 	if (pcb->flags & TF_TIMESTAMP) {
 		optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if ((pcb->flags & TF_SACK) && pcb->ooseq != NULL) {
+		/* Report as many blocks as the remaining option space holds */
+		sack_n = tcp_sack_blocks(pcb, sack_blocks, (u8_t)LWIP_MIN(LWIP_TCP_SACK_MAX_BLOCKS, (LWIP_TCP_OPT_LEN_MAX - optlen - LWIP_TCP_OPT_LEN_SACK_OUT(0)) / 8));
+		if (sack_n > 0) {
+			optlen += LWIP_TCP_OPT_LEN_SACK_OUT(sack_n);
+		}
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	p = tcp_output_alloc_header(pcb, optlen, 0, lwip_htonl(pcb->snd_nxt));
 	if (p == NULL) {
@@ -897,9 +982,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: (ACK) could not allocate pbuf\n"));
 		return ERR_BUF;
 	}
-#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP
+#if LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK
 	tcphdr = (struct tcp_hdr *)p->payload;
-#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP */
+#endif							/* LWIP_TCP_TIMESTAMPS || CHECKSUM_GEN_TCP || LWIP_TCP_SACK */
 	LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output: sending ACK for %" U32_F "\n", pcb->rcv_nxt));
 
 	/* NB. MSS option is only sent on SYNs, so ignore it here */
@@ -910,6 +995,13 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb)
 		tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
 	}
 #endif
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	if (sack_n > 0) {
+		/* The SACK option follows the timestamp, if any */
+		opts = (u32_t *)(void *)((u8_t *)(tcphdr + 1) + optlen - LWIP_TCP_OPT_LEN_SACK_OUT(sack_n));
+		tcp_build_sack_option(opts, sack_blocks, sack_n);
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
 
 	netif = ip_route(&pcb->local_ip, &pcb->remote_ip);
 	if (netif == NULL) {
@@ -969,6 +1061,15 @@ err_t tcp_output(struct tcp_pcb *pcb)
 
 	seg = pcb->unsent;
 
+#if LWIP_TCP_SACK && TCP_QUEUE_OOSEQ
+	/* Data segments carry no SACK blocks: while there are holes in the
+	 * received data, send the ACK on its own and the data after it.
+	 */
+	if ((pcb->flags & TF_ACK_NOW) && (pcb->flags & TF_SACK) && pcb->ooseq != NULL && seg != NULL) {
+		tcp_send_empty_ack(pcb);
+	}
+#endif							/* LWIP_TCP_SACK && TCP_QUEUE_OOSEQ */
+
 	/* If the TF_ACK_NOW flag is set and no data will be sent (either
 	 * because the ->unsent queue is empty or because the window does
 	 * not allow it), construct an empty ACK segment and send it.
@@ -1173,6 +1274,16 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 		opts += 1;
 	}
 #endif
+#if LWIP_TCP_SACK
+	if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+		/* Pad with two NOP options to make everything nicely aligned */
+		*opts = PP_HTONL(0x01010000 | (LWIP_TCP_OPT_SACK_PERM << 8) | LWIP_TCP_OPT_LEN_SACK_PERM);
+		opts += 1;
+	}
+#endif
+#if LWIP_TCP_RACK
+	seg->xmit_time = sys_now();
+#endif
 
 	/* Set retransmission timer running if it is not currently enabled
 	   This must be set before checking the route. */
@@ -1183,6 +1294,9 @@ static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct
 	if (pcb->rttest == 0) {
 		pcb->rttest = tcp_ticks;
 		pcb->rtseq = lwip_ntohl(seg->tcphdr->seqno);
+#if LWIP_STATS_PERF
+		pcb->perf_rtt_ts = sys_now();
+#endif							/* LWIP_STATS_PERF */
 
 		LWIP_DEBUGF(TCP_RTO_DEBUG, ("tcp_output_segment: rtseq %" U32_F "\n", pcb->rtseq));
 	}
@@ -1313,25 +1427,79 @@ void tcp_rst(u32_t seqno, u32_t ackno, ip_addr_t *local_ip, const ip_addr_t *rem
 void tcp_rexmit_rto(struct tcp_pcb *pcb)
 {
 	struct tcp_seg *seg;
+#if LWIP_TCP_SACK
+	struct tcp_seg **cur_seg;
+	struct tcp_seg *rexmit;
+	struct tcp_seg *last;
+#endif							/* LWIP_TCP_SACK */
 
 	if (pcb->unacked == NULL) {
 		return;
 	}
 
-	/* Move all unacked segments to the head of the unsent queue */
-	for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
-	/* concatenate unsent queue after unacked queue */
-	seg->next = pcb->unsent;
+#if LWIP_STATS_PERF
+	pcb->perf_rtos++;
+#endif							/* LWIP_STATS_PERF */
+
+#if LWIP_TCP_SACK
+	if (pcb->flags & TF_SACK) {
+		/* The timeout ends fast recovery and starts a new recovery episode */
+		pcb->flags &= ~TF_INFR;
+		pcb->sack_recover = pcb->snd_nxt;
+
+		/* Only move the segments the remote host does not hold, the SACKed
+		 * ones stay on ->unacked.  The receiver may discard SACKed data
+		 * again (RFC 2018, section 8), so once the timeout repeats without
+		 * progress forget the scoreboard and resend everything.
+		 */
+		rexmit = NULL;
+		last = NULL;
+		cur_seg = &(pcb->unacked);
+		while ((seg = *cur_seg) != NULL) {
+			if (pcb->nrtx >= 2) {
+				seg->flags &= ~TF_SEG_SACKED;
+			}
+			if (seg->flags & TF_SEG_SACKED) {
+				cur_seg = &(seg->next);
+			} else {
+				*cur_seg = seg->next;
+				seg->flags |= TF_SEG_RETX;
+				if (last == NULL) {
+					rexmit = seg;
+				} else {
+					last->next = seg;
+				}
+				last = seg;
+			}
+		}
+		if (last != NULL) {
+			/* concatenate unsent queue after the segments to resend */
+			last->next = pcb->unsent;
 #if TCP_OVERSIZE_DBGCHECK
-	/* if last unsent changed, we need to update unsent_oversize */
-	if (pcb->unsent == NULL) {
-		pcb->unsent_oversize = seg->oversize_left;
-	}
+			if (pcb->unsent == NULL) {
+				pcb->unsent_oversize = last->oversize_left;
+			}
+#endif							/* TCP_OVERSIZE_DBGCHECK */
+			pcb->unsent = rexmit;
+		}
+	} else
+#endif							/* LWIP_TCP_SACK */
+	{
+		/* Move all unacked segments to the head of the unsent queue */
+		for (seg = pcb->unacked; seg->next != NULL; seg = seg->next) ;
+		/* concatenate unsent queue after unacked queue */
+		seg->next = pcb->unsent;
+#if TCP_OVERSIZE_DBGCHECK
+		/* if last unsent changed, we need to update unsent_oversize */
+		if (pcb->unsent == NULL) {
+			pcb->unsent_oversize = seg->oversize_left;
+		}
 #endif							/* TCP_OVERSIZE_DBGCHECK */
-	/* unsent queue is the concatenated queue (of unacked, unsent) */
-	pcb->unsent = pcb->unacked;
-	/* unacked queue is now empty */
-	pcb->unacked = NULL;
+		/* unsent queue is the concatenated queue (of unacked, unsent) */
+		pcb->unsent = pcb->unacked;
+		/* unacked queue is now empty */
+		pcb->unacked = NULL;
+	}
 
 	/* increment number of retransmissions */
 	if (pcb->nrtx < 0xFF) {
@@ -1355,17 +1523,35 @@ void tcp_rexmit_rto(struct tcp_pcb *pcb)
 void tcp_rexmit(struct tcp_pcb *pcb)
 {
 	struct tcp_seg *seg;
-	struct tcp_seg **cur_seg;
 
 	if (pcb->unacked == NULL) {
 		return;
 	}
 
 	/* Move the first unacked segment to the unsent queue */
-	/* Keep the unsent queue sorted. */
 	seg = pcb->unacked;
 	pcb->unacked = seg->next;
+	tcp_rexmit_seg(pcb, seg);
+
+	if (pcb->nrtx < 0xFF) {
+		++pcb->nrtx;
+	}
 
+	/* No need to call tcp_output: we are always called from tcp_input()
+	   and thus tcp_output directly returns. */
+}
+
+/**
+ * Requeue a segment taken off pcb->unacked for retransmission
+ *
+ * @param pcb the tcp_pcb the segment belongs to
+ * @param seg the segment, no longer linked to pcb->unacked
+ */
+void tcp_rexmit_seg(struct tcp_pcb *pcb, struct tcp_seg *seg)
+{
+	struct tcp_seg **cur_seg;
+
+	/* Keep the unsent queue sorted. */
 	cur_seg = &(pcb->unsent);
 	while (*cur_seg && TCP_SEQ_LT(lwip_ntohl((*cur_seg)->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno))) {
 		cur_seg = &((*cur_seg)->next);
@@ -1378,18 +1564,18 @@ void tcp_rexmit(struct tcp_pcb *pcb)
 		pcb->unsent_oversize = 0;
 	}
 #endif							/* TCP_OVERSIZE */
-
-	if (pcb->nrtx < 0xFF) {
-		++pcb->nrtx;
-	}
+#if LWIP_TCP_SACK
+	seg->flags |= TF_SEG_RETX;
+#endif							/* LWIP_TCP_SACK */
 
 	/* Don't take any rtt measurements after retransmitting. */
 	pcb->rttest = 0;
 
 	/* Do the actual retransmission. */
 	MIB2_STATS_INC(mib2.tcpretranssegs);
-	/* No need to call tcp_output: we are always called from tcp_input()
-	   and thus tcp_output directly returns. */
+#if LWIP_STATS_PERF
+	pcb->perf_rexmits++;
+#endif							/* LWIP_STATS_PERF */
 }
 
 /**
@@ -1399,6 +1585,13 @@ void tcp_rexmit(struct tcp_pcb *pcb)
  */
 void tcp_rexmit_fast(struct tcp_pcb *pcb)
 {
+#if LWIP_TCP_SACK
+	if ((pcb->flags & TF_SACK) && TCP_SEQ_LT(pcb->lastack, pcb->sack_recover)) {
+		/* Data sent before the last recovery is still outstanding: this loss
+		   belongs to that episode, don't reduce the window again (RFC 6582) */
+		return;
+	}
+#endif							/* LWIP_TCP_SACK */
 	if (pcb->unacked != NULL && !(pcb->flags & TF_INFR)) {
 		/* This is fast retransmit. Retransmit the first unacked segment. */
 		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_receive: dupacks %" U16_F " (%" U32_F "), fast retransmit %" U32_F "\n", (u16_t) pcb->dupacks, pcb->lastack, lwip_ntohl(pcb->unacked->tcphdr->seqno)));
@@ -1416,12 +1609,104 @@ void tcp_rexmit_fast(struct tcp_pcb *pcb)
 
 		pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
 		pcb->flags |= TF_INFR;
+#if LWIP_TCP_SACK
+		pcb->sack_recover = pcb->snd_nxt;
+#endif							/* LWIP_TCP_SACK */
 
 		/* Reset the retransmission timer to prevent immediate rto retransmissions */
 		pcb->rtime = 0;
 	}
 }
 
+#if LWIP_TCP_SACK
+/** A hole is lost once this many segments above it are SACKed, or more
+ * than (TCP_SACK_DUPTHRESH - 1) * mss bytes (RFC 6675, IsLost) */
+#define TCP_SACK_DUPTHRESH 3
+
+/**
+ * Retransmit the holes the SACK scoreboard considers lost
+ *
+ * A segment that was not SACKed is lost when enough data above it was
+ * SACKed (see TCP_SACK_DUPTHRESH) or, with LWIP_TCP_RACK, when a segment
+ * sent after it was delivered and it has been in flight for longer than
+ * the last RTT plus a quarter of the minimum RTT.  Each hole is resent
+ * once per recovery, except that RACK may resend a lost retransmission.
+ * Recovery is entered through tcp_rexmit_fast(), so the window is reduced
+ * once per episode.
+ *
+ * Called by tcp_receive() for every ACK on a connection that uses SACK.
+ *
+ * @param pcb the tcp_pcb to check
+ * @param partial_ack the ACK acknowledged new data but not all of the
+ *        data outstanding when recovery began: resend the first
+ *        unacknowledged segment as well (NewReno)
+ */
+void tcp_rexmit_sack(struct tcp_pcb *pcb, u8_t partial_ack)
+{
+	struct tcp_seg *seg;
+	struct tcp_seg **cur_seg;
+	u32_t sacked = 0;
+	u16_t sacked_segs = 0;
+	u8_t lost;
+#if LWIP_TCP_RACK
+	u32_t now = sys_now();
+	u32_t rack_wnd = pcb->rack_rtt + (pcb->rack_min_rtt >> 2);
+	s32_t order;
+#endif							/* LWIP_TCP_RACK */
+
+	seg = pcb->unacked;
+	if (partial_ack && seg != NULL && (seg->flags & (TF_SEG_SACKED | TF_SEG_RETX)) == 0) {
+		pcb->unacked = seg->next;
+		tcp_rexmit_seg(pcb, seg);
+	}
+
+	/* Sum up what the remote host holds above the cumulative ACK */
+	for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+		if (seg->flags & TF_SEG_SACKED) {
+			sacked += seg->len;
+			sacked_segs++;
+		}
+	}
+
+	cur_seg = &(pcb->unacked);
+	while ((seg = *cur_seg) != NULL && sacked_segs > 0) {
+		if (seg->flags & TF_SEG_SACKED) {
+			/* 'sacked' now counts what is held above the next segment */
+			sacked -= seg->len;
+			sacked_segs--;
+			cur_seg = &(seg->next);
+			continue;
+		}
+
+		lost = 0;
+		if (!(seg->flags & TF_SEG_RETX) && (sacked_segs >= TCP_SACK_DUPTHRESH || sacked > (TCP_SACK_DUPTHRESH - 1) * (u32_t)pcb->mss)) {
+			lost = 1;
+		}
+#if LWIP_TCP_RACK
+		order = (s32_t)(seg->xmit_time - pcb->rack_xmit_ts);
+		if ((order < 0 || (order == 0 && TCP_SEQ_LT(lwip_ntohl(seg->tcphdr->seqno) + TCP_TCPLEN(seg), pcb->rack_end_seq))) && (u32_t)(now - seg->xmit_time) >= rack_wnd) {
+			lost = 1;
+		}
+#endif							/* LWIP_TCP_RACK */
+		if (!lost) {
+			cur_seg = &(seg->next);
+			continue;
+		}
+
+		if (!(pcb->flags & TF_INFR) && seg == pcb->unacked) {
+			/* Enter recovery, this resends 'seg' */
+			tcp_rexmit_fast(pcb);
+			if (pcb->flags & TF_INFR) {
+				continue;
+			}
+		}
+		LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rexmit_sack: resending %" U32_F ":%" U32_F "\n", lwip_ntohl(seg->tcphdr->seqno), lwip_ntohl(seg->tcphdr->seqno) + TCP_TCPLEN(seg)));
+		*cur_seg = seg->next;
+		tcp_rexmit_seg(pcb, seg);
+	}
+}
+#endif							/* LWIP_TCP_SACK */
+
 /**
  * Send keepalive packets to keep a connection active although
  * no data is sent over it.
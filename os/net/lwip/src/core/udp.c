@@ -79,6 +79,7 @@
 #include "lwip/snmp.h"
 #include "lwip/arch/perf.h"
 #include "lwip/dhcp.h"
+#include "lwip/priv/pcb_hash.h"
 
 #include <string.h>
 
@@ -97,6 +98,11 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs = NULL;
 
+#if LWIP_PCB_HASH
+/* Hash table over udp_pcbs, keyed on the local port */
+static struct udp_pcb *udp_hash[LWIP_PCB_HASH_SIZE];
+#endif							/* LWIP_PCB_HASH */
+
 /**
  * Initialize this module.
  */
@@ -201,6 +207,9 @@ void udp_input(struct pbuf *p, struct netif *inp)
 	u16_t src, dest;
 	u8_t broadcast;
 	u8_t for_us = 0;
+#if LWIP_PCB_HASH
+	u32_t bucket;
+#endif							/* LWIP_PCB_HASH */
 
 	LWIP_UNUSED_ARG(inp);
 
@@ -246,7 +255,13 @@ void udp_input(struct pbuf *p, struct netif *inp)
 	 * 'Perfect match' pcbs (connected to the remote port & ip address) are
 	 * preferred. If no perfect match is found, the first unconnected pcb that
 	 * matches the local port and ip address gets the datagram. */
+#if LWIP_PCB_HASH
+	/* Only the pcbs bound to the destination port need to be looked at */
+	bucket = pcb_hash_port(dest);
+	for (pcb = udp_hash[bucket]; pcb != NULL; pcb = pcb->hash_next) {
+#else							/* LWIP_PCB_HASH */
 	for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif							/* LWIP_PCB_HASH */
 		/* print the PCB local and remote address */
 		LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
 		ip_addr_debug_print(UDP_DEBUG, &pcb->local_ip);
@@ -272,9 +287,13 @@ void udp_input(struct pbuf *p, struct netif *inp)
 				if (prev != NULL) {
 					/* move the pcb to the front of udp_pcbs so that is
 					   found faster next time */
+#if LWIP_PCB_HASH
+					PCB_HASH_TO_FRONT(udp_hash, bucket, pcb);
+#else							/* LWIP_PCB_HASH */
 					prev->next = pcb->next;
 					pcb->next = udp_pcbs;
 					udp_pcbs = pcb;
+#endif							/* LWIP_PCB_HASH */
 				} else {
 					UDP_STATS_INC(udp.cachehit);
 				}
@@ -908,6 +927,13 @@ err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
 	ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+#if LWIP_PCB_HASH
+	/* (re)hash the pcb on its new port */
+	if (rebind == 0 || pcb->local_port != port) {
+		PCB_HASH_RMV(pcb);
+		PCB_HASH_ADD(udp_hash, pcb_hash_port(port), pcb);
+	}
+#endif							/* LWIP_PCB_HASH */
 	pcb->local_port = port;
 	mib2_udp_bind(pcb);
 	/* pcb not active yet? */
@@ -972,6 +998,9 @@ err_t udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 	/* PCB not yet on the list, add PCB now */
 	pcb->next = udp_pcbs;
 	udp_pcbs = pcb;
+#if LWIP_PCB_HASH
+	PCB_HASH_ADD(udp_hash, pcb_hash_port(pcb->local_port), pcb);
+#endif							/* LWIP_PCB_HASH */
 	return ERR_OK;
 }
 
@@ -1026,6 +1055,9 @@ void udp_remove(struct udp_pcb *pcb)
 	struct udp_pcb *pcb2;
 
 	mib2_udp_unbind(pcb);
+#if LWIP_PCB_HASH
+	PCB_HASH_RMV(pcb);
+#endif							/* LWIP_PCB_HASH */
 	/* pcb to be removed is first in list? */
 	if (udp_pcbs == pcb) {
 		/* make list start at 2nd pcb */
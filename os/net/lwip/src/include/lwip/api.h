@@ -229,6 +229,22 @@ struct api_msg;
 /* A callback prototype to inform about events for a netconn */
 typedef void (*netconn_callback)(struct netconn *, enum netconn_evt, u16_t len);
 
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+/* A callback prototype to inform that the data of a zero-copy write has been
+   acknowledged (result 0) or will never be (negated errno). Called from the
+   tcpip thread, so it must not block. */
+typedef void (*netconn_zc_callback)(void *arg, int result);
+
+/* A zero-copy write waiting for its last byte to be acknowledged */
+struct netconn_zc {
+	struct netconn_zc *next;
+	/* value of netconn.zc_written when the write was queued */
+	u32_t end;
+	netconn_zc_callback done;
+	void *arg;
+};
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
+
 /* A netconn descriptor */
 struct netconn {
 	/* type of the netconn (TCP, UDP or RAW) */
@@ -286,6 +302,16 @@ struct netconn {
 	   for UDP and RAW, used for FIONREAD */
 	int recv_avail;
 #endif							/* LWIP_SO_RCVBUF */
+#if LWIP_STATS_PERF
+	/* bytes posted to recvmbox by the tcpip thread and bytes taken from it
+	   by the application: each side only writes its own counter */
+	u32_t recvq_in;
+	u32_t recvq_out;
+	/* highest recvq_in - recvq_out seen when posting */
+	u32_t recvq_hwm;
+	/* UDP and RAW packets dropped because recvmbox was full */
+	u32_t recvq_drops;
+#endif							/* LWIP_STATS_PERF */
 #if LWIP_SO_LINGER
 	/* values <0 mean linger is disabled, values > 0 are seconds to linger */
 	s16_t linger;
@@ -300,6 +326,15 @@ struct netconn {
 	   this temporarily stores the message.
 	   Also used during connect and close. */
 	struct api_msg *current_msg;
+#if LWIP_SOCKET_ZEROCOPY
+	/* TCP: bytes passed to tcp_write and bytes acknowledged by the remote
+	   side since the connection was set up, both wrapping */
+	u32_t zc_written;
+	u32_t zc_acked;
+	/* TCP: zero-copy writes waiting for their data to be acknowledged,
+	   oldest first */
+	struct netconn_zc *zc_pending;
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 #endif							/* LWIP_TCP */
 	/* A callback function that is informed about events for this netconn */
 	netconn_callback callback;
@@ -322,6 +357,24 @@ struct netconn {
 	SYS_ARCH_UNPROTECT(netconn_set_safe_err_lev); \
 } } while (0)
 
+/* Account for len bytes posted to or taken from conn->recvmbox */
+#if LWIP_STATS_PERF
+#define NETCONN_RECVQ_IN(conn, len) do { \
+	u32_t netconn_recvq_depth; \
+	(conn)->recvq_in += (len); \
+	netconn_recvq_depth = (conn)->recvq_in - (conn)->recvq_out; \
+	if (netconn_recvq_depth > (conn)->recvq_hwm) { \
+		(conn)->recvq_hwm = netconn_recvq_depth; \
+	} \
+} while (0)
+#define NETCONN_RECVQ_OUT(conn, len) do { (conn)->recvq_out += (len); } while (0)
+#define NETCONN_RECVQ_DROP(conn) do { (conn)->recvq_drops++; } while (0)
+#else							/* LWIP_STATS_PERF */
+#define NETCONN_RECVQ_IN(conn, len)
+#define NETCONN_RECVQ_OUT(conn, len)
+#define NETCONN_RECVQ_DROP(conn)
+#endif							/* LWIP_STATS_PERF */
+
 /* Network connection functions: */
 
 #define netconn_new(t)                  netconn_new_with_proto_and_callback(t, 0, NULL)
@@ -345,11 +398,15 @@ err_t netconn_recv(struct netconn *conn, struct netbuf **new_buf);
 err_t netconn_recv_tcp_pbuf(struct netconn *conn, struct pbuf **new_buf);
 err_t netconn_sendto(struct netconn *conn, struct netbuf *buf, const ip_addr_t *addr, u16_t port);
 err_t netconn_send(struct netconn *conn, struct netbuf *buf);
+err_t netconn_send_batch(struct netconn *conn, struct netbuf **bufs, u16_t count, u16_t *sent);
 err_t netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size, u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
 		netconn_write_partly(conn, dataptr, size, apiflags, NULL)
 err_t netconn_close(struct netconn *conn);
 err_t netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+err_t netconn_zc_notify(struct netconn *conn, struct netconn_zc *zc);
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
 
 #if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
 err_t netconn_join_leave_group(struct netconn *conn, const ip_addr_t *multiaddr, const ip_addr_t *netif_addr, enum netconn_igmp join_or_leave);
@@ -26,6 +26,10 @@
 #include <mqueue.h>
 #include <semaphore.h>
 
+#ifdef CONFIG_NET_LWIP_MBOX_RING
+#include "lwip/arch/sys_mbox_ring.h"
+#endif
+
 #define SYS_MBOX_NULL ((sys_mbox_t *)NULL)
 #define SYS_SEM_NULL  ((sys_sem_t *)NULL)
 #define SYS_DEFAULT_THREAD_STACK_DEPTH  PTHREAD_STACK_MIN
@@ -39,6 +43,23 @@ typedef pid_t sys_thread_t;
 
 // === MAIL BOX ===
 
+#ifdef CONFIG_NET_LWIP_MBOX_RING
+/* Messages are passed through a ring accessed with the scheduler locked.
+ * The semaphores are only touched when a thread has to block: 'mail' wakes
+ * fetchers waiting on an empty mailbox and 'space' wakes posters waiting
+ * on a full one.  'wait_send' and 'wait_fetch' count the blocked threads.
+ */
+
+struct sys_mbox {
+	u8_t is_valid;
+	u8_t id;
+	u32_t wait_send;
+	u32_t wait_fetch;
+	struct sys_mbox_ring ring;
+	sys_sem_t mail;
+	sys_sem_t space;
+};
+#else
 struct sys_mbox {
 	u8_t is_valid;
 	u8_t id;
@@ -49,9 +70,17 @@ struct sys_mbox {
 	u32_t rear;
 	void *msgs[SYS_MBOX_MAXSIZE];
 	sys_sem_t mail;
+	sys_sem_t space;
 	sys_sem_t mutex;
 };
+#endif
 
 typedef struct sys_mbox sys_mbox_t;
 
+/* Fetch up to 'max' messages without blocking, returning the number of
+ * messages stored in 'msgs'.  Lets the tcpip thread handle a batch of
+ * messages per wakeup.
+ */
+u32_t sys_arch_mbox_tryfetch_many(sys_mbox_t *mbox, void **msgs, u32_t max);
+
 #endif							/* __ARCH_SYS_ARCH_H__ */
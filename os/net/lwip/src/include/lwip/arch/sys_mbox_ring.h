@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __ARCH_SYS_MBOX_RING_H__
+#define __ARCH_SYS_MBOX_RING_H__
+
+/* Bounded message ring used by the mailboxes.
+ *
+ * 'head' and 'tail' count the messages posted and fetched so far and are
+ * only reduced to a slot index when the ring is accessed, so the ring is
+ * full when they are 'mask + 1' apart and both may wrap freely.
+ *
+ * The ring itself is not thread safe and does not block.  sys_arch.c
+ * accesses it with the scheduler locked and layers blocking on top.
+ */
+
+#include <stdint.h>
+
+#define SYS_MBOX_RING_MAXSIZE 128
+
+struct sys_mbox_ring {
+	uint32_t mask;				/* Capacity - 1, capacity is a power of two */
+	uint32_t head;				/* Messages posted */
+	uint32_t tail;				/* Messages fetched */
+	void *msgs[SYS_MBOX_RING_MAXSIZE];
+};
+
+/* Initialize a ring holding at least 'size' messages.  'size' is rounded
+ * up to a power of two; zero or anything above SYS_MBOX_RING_MAXSIZE gives
+ * SYS_MBOX_RING_MAXSIZE.
+ */
+
+static inline void sys_mbox_ring_init(struct sys_mbox_ring *ring, int size)
+{
+	uint32_t cap = 2;
+
+	if (size <= 0 || size > SYS_MBOX_RING_MAXSIZE) {
+		size = SYS_MBOX_RING_MAXSIZE;
+	}
+
+	while (cap < (uint32_t)size) {
+		cap <<= 1;
+	}
+
+	ring->mask = cap - 1;
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+/* Add 'msg' to the ring.  Returns 0 on success or -1 if the ring is full. */
+
+static inline int sys_mbox_ring_put(struct sys_mbox_ring *ring, void *msg)
+{
+	if (ring->head - ring->tail > ring->mask) {
+		return -1;
+	}
+
+	ring->msgs[ring->head & ring->mask] = msg;
+	ring->head++;
+	return 0;
+}
+
+/* Remove the oldest message from the ring.  Returns 0 on success or -1 if
+ * the ring is empty.
+ */
+
+static inline int sys_mbox_ring_get(struct sys_mbox_ring *ring, void **msg)
+{
+	if (ring->head == ring->tail) {
+		return -1;
+	}
+
+	if (msg != NULL) {
+		*msg = ring->msgs[ring->tail & ring->mask];
+	}
+	ring->tail++;
+	return 0;
+}
+
+#endif							/* __ARCH_SYS_MBOX_RING_H__ */
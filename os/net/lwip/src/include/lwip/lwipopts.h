@@ -277,6 +277,12 @@
 #define IP_DEFAULT_TTL                 CONFIG_NET_IP_DEFAULT_TTL
 #endif
 
+/* Use the word-wise one's complement sum from libc (or the architecture
+ * version selected by CONFIG_ARCH_CHKSUM) instead of lwip_standard_chksum.
+ */
+#include <chksum.h>
+#define LWIP_CHKSUM                    chksum16
+
 /* ---------- IP options ---------- */
 
 /* ---------- IPv6 options ---------- */
@@ -432,6 +438,14 @@
 #define TCP_TIMESTAMPS	CONFIG_NET_TCP_TIMESTAMPS
 #endif
 
+#ifdef CONFIG_NET_TCP_SACK
+#define LWIP_TCP_SACK	1
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+#define LWIP_TCP_RACK	1
+#endif
+
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 #define LWIP_TCP_KEEPALIVE              CONFIG_NET_TCP_KEEPALIVE
 #endif
@@ -463,6 +477,13 @@
 
 /* ---------- UDP options ---------- */
 
+/* ---------- PCB lookup options ---------- */
+#ifdef CONFIG_NET_LWIP_PCB_HASH
+#define LWIP_PCB_HASH	1
+#define LWIP_PCB_HASH_SIZE	CONFIG_NET_LWIP_PCB_HASH_SIZE
+#endif
+/* ---------- PCB lookup options ---------- */
+
 /* ---------- SNMP options ---------- */
 #ifdef CONFIG_NET_LWIP_SNMP
 #define LWIP_SNMP                       1
@@ -681,6 +702,10 @@
 #define SO_REUSE_RXTOALL	CONFIG_NET_SO_REUSE_RXTOALL
 #endif
 
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY	1
+#endif
+
 /* ---------- Socket options ---------- */
 
 /* ---------- SLIP options ---------- */
@@ -827,6 +852,10 @@
 #define TCPIP_MBOX_SIZE	CONFIG_NET_TCPIP_MBOX_SIZE
 #endif
 
+#ifdef CONFIG_NET_TCPIP_MBOX_BATCH
+#define TCPIP_MBOX_BATCH	CONFIG_NET_TCPIP_MBOX_BATCH
+#endif
+
 /* ---------- Mailbox options ---------- */
 
 /* ---------- Debug options ---------- */
@@ -1050,6 +1079,10 @@
 #define LWIP_STATS_DISPLAY	CONFIG_NET_STATS_DISPLAY
 #endif
 
+#ifdef CONFIG_NET_STATS_PERF
+#define LWIP_STATS_PERF	CONFIG_NET_STATS_PERF
+#endif
+
 #ifdef CONFIG_NET_LINK_STATS
 #define LINK_STATS	CONFIG_NET_LINK_STATS
 #endif
@@ -77,6 +77,9 @@
 #include "lwip/def.h"
 #include "lwip/pbuf.h"
 #include "lwip/stats.h"
+#if LWIP_STATS_PERF
+#include <net/if.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -345,6 +348,10 @@ struct netif {
 	/** counters */
 	struct stats_mib2_netif_ctrs mib2_counters;
 #endif							/* MIB2_STATS */
+#if LWIP_STATS_PERF
+	/** packets dropped, indexed by enum netmon_drop */
+	u32_t drops[NETMON_DROP_MAX];
+#endif							/* LWIP_STATS_PERF */
 #if LWIP_IPV4 && LWIP_IGMP
 	/** This function could be called to add or delete an entry in the multicast
 	    filter table of the ethernet MAC.*/
@@ -392,6 +399,17 @@ struct netif {
 #endif
 };
 
+/* Count a dropped packet.  The receive drops are counted by the tcpip
+ * thread and the ones before netif->input() by the driver thread, so each
+ * counter has a single writer and needs no lock.
+ */
+#if LWIP_STATS_PERF
+#define NETIF_DROP_INC(netif, reason) do { \
+		++(netif)->drops[NETMON_DROP_##reason]; } while (0)
+#else							/* LWIP_STATS_PERF */
+#define NETIF_DROP_INC(netif, reason)
+#endif							/* LWIP_STATS_PERF */
+
 #if LWIP_CHECKSUM_CTRL_PER_NETIF
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags) do { \
 		(netif)->chksum_flags = chksumflags; } while (0)
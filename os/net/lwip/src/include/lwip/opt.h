@@ -1277,6 +1277,28 @@
 #define LWIP_TCP_TIMESTAMPS             0
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: support selective acknowledgments (RFC 2018).  Every SYN
+ * offers the SACK-permitted option.  Once both sides agree, ACKs report the
+ * segments held on ->ooseq, and a loss only retransmits the holes the remote
+ * host reported, instead of every unacknowledged segment.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_RACK==1: also declare a segment lost by time (RACK, RFC 8985).
+ * A segment is lost if a segment sent after it has been delivered and it
+ * is older than the last measured RTT plus a reordering window.  Without
+ * this option a hole counts as lost once three segments above it are
+ * SACKed.  Adds a transmit timestamp to every tcp_seg.  Only valid for
+ * LWIP_TCP_SACK==1.
+ */
+#ifndef LWIP_TCP_RACK
+#define LWIP_TCP_RACK                   0
+#endif
+
 /**
  * TCP_WND_UPDATE_THRESHOLD: difference in window to trigger an
  * explicit window update
@@ -1285,6 +1307,24 @@
 #define TCP_WND_UPDATE_THRESHOLD   LWIP_MIN((TCP_WND / 4), (TCP_MSS * 4))
 #endif
 
+/**
+ * LWIP_PCB_HASH==1: find the PCB of incoming TCP segments and UDP datagrams
+ * through hash tables instead of walking tcp_active_pcbs, tcp_listen_pcbs
+ * and udp_pcbs.  Connected TCP PCBs are hashed on the 4-tuple, listeners and
+ * UDP PCBs on the local port.  Each PCB grows by two pointers.
+ */
+#ifndef LWIP_PCB_HASH
+#define LWIP_PCB_HASH                   0
+#endif
+
+/**
+ * LWIP_PCB_HASH_SIZE: number of buckets in each PCB hash table.  Must be a
+ * power of two.
+ */
+#ifndef LWIP_PCB_HASH_SIZE
+#define LWIP_PCB_HASH_SIZE              64
+#endif
+
 /**
  * LWIP_EVENT_API and LWIP_CALLBACK_API: Only one of these should be set to 1.
  *     LWIP_EVENT_API==1: The user defines lwip_tcp_event() to receive all
@@ -1553,6 +1593,15 @@
 #define TCPIP_MBOX_SIZE                 0
 #endif
 
+/**
+ * TCPIP_MBOX_BATCH: The number of messages the tcpip thread takes from its
+ * mailbox per wakeup, using sys_arch_mbox_tryfetch_many() for all but the
+ * first.  1 handles one message per pass.
+ */
+#ifndef TCPIP_MBOX_BATCH
+#define TCPIP_MBOX_BATCH                1
+#endif
+
 /**
  * Define this to something that triggers a watchdog. This is called from
  * tcpip_thread after processing a message.
@@ -1757,6 +1806,25 @@
 #define LWIP_SOCKET_OFFSET              0
 #endif
 
+/**
+ * LWIP_SOCKET_ZEROCOPY==1: Enable lwip_recvmsg_zc(), lwip_zc_release() and
+ * lwip_sendmsg_zc() which lend received pbufs to the application and send
+ * from application-owned buffers without copying. (only used if you use
+ * sockets.c, requires LWIP_SUPPORT_CUSTOM_PBUF)
+ */
+#ifndef LWIP_SOCKET_ZEROCOPY
+#define LWIP_SOCKET_ZEROCOPY            0
+#endif
+
+/**
+ * LWIP_SOCKET_MMSG_BATCH: Maximum number of datagrams lwip_sendmmsg() passes
+ * to the tcpip thread in one message. The netbufs of a batch are kept on the
+ * caller's stack. (only used if you use sockets.c)
+ */
+#ifndef LWIP_SOCKET_MMSG_BATCH
+#define LWIP_SOCKET_MMSG_BATCH          8
+#endif
+
 /**
  * LWIP_TCP_KEEPALIVE==1: Enable TCP_KEEPIDLE, TCP_KEEPINTVL and TCP_KEEPCNT
  * options processing. Note that TCP_KEEPIDLE and TCP_KEEPINTVL have to be set
@@ -1997,6 +2065,14 @@
 #define MIB2_STATS                      1
 #endif
 
+/**
+ * LWIP_STATS_PERF==1: Per-connection RTT and retransmission counters,
+ * receive queue high-water marks and per-netif drop counters by reason.
+ */
+#ifndef LWIP_STATS_PERF
+#define LWIP_STATS_PERF                 0
+#endif
+
 #else
 
 #define LINK_STATS                      0
@@ -2017,6 +2093,7 @@
 #define MLD6_STATS                      0
 #define ND6_STATS                       0
 #define MIB2_STATS                      0
+#define LWIP_STATS_PERF                 0
 
 #endif							/* LWIP_STATS */
 /**
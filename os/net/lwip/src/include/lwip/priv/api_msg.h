@@ -103,6 +103,12 @@ struct api_msg {
 	union {
 		/** used for lwip_netconn_do_send */
 		struct netbuf *b;
+		/** used for lwip_netconn_do_send_batch */
+		struct {
+			struct netbuf **bufs;
+			u16_t count;
+			u16_t sent;
+		} sb;
 		/** used for lwip_netconn_do_newconn */
 		struct {
 			u8_t proto;
@@ -155,6 +161,12 @@ struct api_msg {
 			u8_t backlog;
 		} lb;
 #endif							/* TCP_LISTEN_BACKLOG */
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+		/** used for lwip_netconn_do_zc_notify */
+		struct {
+			struct netconn_zc *zc;
+		} zc;
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
 	} msg;
 #if LWIP_NETCONN_SEM_PER_THREAD
 	sys_sem_t *op_completed_sem;
@@ -204,6 +216,7 @@ void lwip_netconn_do_connect(void *m);
 void lwip_netconn_do_disconnect(void *m);
 void lwip_netconn_do_listen(void *m);
 void lwip_netconn_do_send(void *m);
+void lwip_netconn_do_send_batch(void *m);
 void lwip_netconn_do_recv(void *m);
 #if TCP_LISTEN_BACKLOG
 void lwip_netconn_do_accepted(void *m);
@@ -212,6 +225,9 @@ void lwip_netconn_do_write(void *m);
 void lwip_netconn_do_getaddr(void *m);
 void lwip_netconn_do_close(void *m);
 void lwip_netconn_do_shutdown(void *m);
+#if LWIP_TCP && LWIP_SOCKET_ZEROCOPY
+void lwip_netconn_do_zc_notify(void *m);
+#endif							/* LWIP_TCP && LWIP_SOCKET_ZEROCOPY */
 #if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
 void lwip_netconn_do_join_leave_group(void *m);
 #endif							/* LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD) */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file
+ * PCB hash tables used to demultiplex incoming TCP segments and UDP
+ * datagrams (do not use in application code)
+ */
+
+#ifndef LWIP_HDR_PCB_HASH_H
+#define LWIP_HDR_PCB_HASH_H
+
+#include "lwip/opt.h"
+
+#if LWIP_PCB_HASH				/* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/ip_addr.h"
+
+#if (LWIP_PCB_HASH_SIZE & (LWIP_PCB_HASH_SIZE - 1)) != 0
+#error "LWIP_PCB_HASH_SIZE must be a power of two"
+#endif
+
+#define PCB_HASH_MASK (LWIP_PCB_HASH_SIZE - 1)
+
+/* A hashed PCB carries 'hash_next' and 'hash_pprev'.  'hash_pprev' points
+ * at the pointer that links to the PCB, either the bucket head or the
+ * 'hash_next' of its predecessor, so a PCB is unlinked without knowing its
+ * bucket.  'hash_pprev' is NULL while the PCB is not hashed, which makes
+ * PCB_HASH_RMV safe to apply to any PCB.
+ */
+
+#define PCB_HASH_ADD(table, idx, npcb) \
+	do { \
+		(npcb)->hash_next = (table)[idx]; \
+		if ((npcb)->hash_next != NULL) { \
+			(npcb)->hash_next->hash_pprev = &(npcb)->hash_next; \
+		} \
+		(table)[idx] = (npcb); \
+		(npcb)->hash_pprev = &(table)[idx]; \
+	} while (0)
+
+#define PCB_HASH_RMV(npcb) \
+	do { \
+		if ((npcb)->hash_pprev != NULL) { \
+			*(npcb)->hash_pprev = (npcb)->hash_next; \
+			if ((npcb)->hash_next != NULL) { \
+				(npcb)->hash_next->hash_pprev = (npcb)->hash_pprev; \
+			} \
+			(npcb)->hash_next = NULL; \
+			(npcb)->hash_pprev = NULL; \
+		} \
+	} while (0)
+
+/* Move a hashed PCB to the front of bucket 'idx' so that the next segment
+ * of the same flow is found first.
+ */
+
+#define PCB_HASH_TO_FRONT(table, idx, npcb) \
+	do { \
+		if ((table)[idx] != (npcb)) { \
+			PCB_HASH_RMV(npcb); \
+			PCB_HASH_ADD(table, idx, npcb); \
+		} \
+	} while (0)
+
+/* Bucket of a local port (TCP listeners and UDP PCBs) */
+
+static inline u32_t pcb_hash_port(u16_t port)
+{
+	return ((u32_t)port ^ ((u32_t)port >> 8)) & PCB_HASH_MASK;
+}
+
+static inline u32_t pcb_hash_addr(const ip_addr_t *addr)
+{
+#if LWIP_IPV6
+	if (IP_IS_V6(addr)) {
+		const ip6_addr_t *addr6 = ip_2_ip6(addr);
+		return addr6->addr[0] ^ addr6->addr[1] ^ addr6->addr[2] ^ addr6->addr[3];
+	}
+#endif							/* LWIP_IPV6 */
+#if LWIP_IPV4
+	return ip4_addr_get_u32(ip_2_ip4(addr));
+#else
+	return 0;
+#endif							/* LWIP_IPV4 */
+}
+
+/* Bucket of a connection.  Equal tuples (as compared by ip_addr_cmp) give
+ * equal buckets; the final mix spreads connections that differ only in the
+ * remote port, as many clients behind one NAT do.
+ */
+
+static inline u32_t pcb_hash_tuple(const ip_addr_t *local_ip, u16_t local_port, const ip_addr_t *remote_ip, u16_t remote_port)
+{
+	u32_t h;
+
+	h = pcb_hash_addr(local_ip) ^ pcb_hash_addr(remote_ip) ^ (((u32_t)local_port << 16) | remote_port);
+	h ^= h >> 16;
+	h *= 0x7feb352dUL;
+	h ^= h >> 15;
+	h *= 0x846ca68bUL;
+	h ^= h >> 16;
+
+	return h & PCB_HASH_MASK;
+}
+
+#endif							/* LWIP_PCB_HASH */
+
+#endif							/* LWIP_HDR_PCB_HASH_H */
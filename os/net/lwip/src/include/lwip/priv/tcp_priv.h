@@ -67,6 +67,7 @@
 #include "lwip/ip6.h"
 #include "lwip/ip6_addr.h"
 #include "lwip/prot/tcp.h"
+#include "lwip/priv/pcb_hash.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -99,6 +100,9 @@ err_t tcp_send_empty_ack(struct tcp_pcb *pcb);
 void tcp_rexmit(struct tcp_pcb *pcb);
 void tcp_rexmit_rto(struct tcp_pcb *pcb);
 void tcp_rexmit_fast(struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+void tcp_rexmit_sack(struct tcp_pcb *pcb, u8_t partial_ack);
+#endif
 u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -279,6 +283,12 @@ struct tcp_seg {
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U	/* ALL data (not the header) is
 											   checksummed into 'chksum' */
 #define TF_SEG_OPTS_WND_SCALE   (u8_t)0x08U	/* Include WND SCALE option */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x10U	/* Include SACK Permitted option */
+#define TF_SEG_SACKED           (u8_t)0x20U	/* Reported in a SACK block by the remote host */
+#define TF_SEG_RETX             (u8_t)0x40U	/* Retransmitted in the current recovery */
+#if LWIP_TCP_RACK
+	u32_t xmit_time;		/* sys_now() when the segment was last sent */
+#endif							/* LWIP_TCP_RACK */
 	struct tcp_hdr *tcphdr;	/* the TCP header */
 };
 
@@ -286,6 +296,8 @@ struct tcp_seg {
 #define LWIP_TCP_OPT_NOP        1
 #define LWIP_TCP_OPT_MSS        2
 #define LWIP_TCP_OPT_WS         3
+#define LWIP_TCP_OPT_SACK_PERM  4
+#define LWIP_TCP_OPT_SACK       5
 #define LWIP_TCP_OPT_TS         8
 
 #define LWIP_TCP_OPT_LEN_MSS    4
@@ -301,11 +313,22 @@ struct tcp_seg {
 #else
 #define LWIP_TCP_OPT_LEN_WS_OUT 0
 #endif
+#if LWIP_TCP_SACK
+#define LWIP_TCP_OPT_LEN_SACK_PERM      2
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT  4	/* aligned for output (includes NOP padding) */
+#define LWIP_TCP_OPT_LEN_SACK(n)        (2 + 8 * (n))
+#define LWIP_TCP_OPT_LEN_SACK_OUT(n)    (4 + 8 * (n))	/* aligned for output (includes NOP padding) */
+#define LWIP_TCP_SACK_MAX_BLOCKS        4	/* as many as fit into the 40 option bytes */
+#else
+#define LWIP_TCP_OPT_LEN_SACK_PERM_OUT  0
+#endif
+#define LWIP_TCP_OPT_LEN_MAX    40
 
 #define LWIP_TCP_OPT_LENGTH(flags) \
 		(flags & TF_SEG_OPTS_MSS       ? LWIP_TCP_OPT_LEN_MSS    : 0) + \
 		(flags & TF_SEG_OPTS_TS        ? LWIP_TCP_OPT_LEN_TS_OUT : 0) + \
-		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0)
+		(flags & TF_SEG_OPTS_WND_SCALE ? LWIP_TCP_OPT_LEN_WS_OUT : 0) + \
+		(flags & TF_SEG_OPTS_SACK_PERM ? LWIP_TCP_OPT_LEN_SACK_PERM_OUT : 0)
 
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) lwip_htonl(0x02040000 | ((mss) & 0xFFFF))
@@ -339,6 +362,13 @@ extern struct tcp_pcb *tcp_active_pcbs;	/* List of all TCP PCBs that are in a
 					   data. */
 extern struct tcp_pcb *tcp_tw_pcbs;	/* List of all TCP PCBs in TIME-WAIT. */
 
+#if LWIP_PCB_HASH
+/* Hash tables over tcp_active_pcbs (keyed on the 4-tuple) and
+   tcp_listen_pcbs (keyed on the local port). */
+extern struct tcp_pcb *tcp_active_hash[LWIP_PCB_HASH_SIZE];
+extern struct tcp_pcb_listen *tcp_listen_hash[LWIP_PCB_HASH_SIZE];
+#endif							/* LWIP_PCB_HASH */
+
 #define NUM_TCP_PCB_LISTS_NO_TIME_WAIT  3
 #define NUM_TCP_PCB_LISTS               4
 extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
@@ -417,14 +447,27 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 
 #endif							/* LWIP_DEBUG */
 
+/* Define two macros, TCP_HASH_REG and TCP_HASH_RMV that add an active or
+   listening PCB to its hash table or remove it, respectively.  A PCB must
+   have its final address and port when it is hashed. */
+#if LWIP_PCB_HASH
+#define TCP_HASH_REG(npcb)     tcp_pcb_hash_add(npcb)
+#define TCP_HASH_RMV(npcb)     tcp_pcb_hash_remove(npcb)
+#else							/* LWIP_PCB_HASH */
+#define TCP_HASH_REG(npcb)
+#define TCP_HASH_RMV(npcb)
+#endif							/* LWIP_PCB_HASH */
+
 #define TCP_REG_ACTIVE(npcb)                       \
 	do {                                             \
 		TCP_REG(&tcp_active_pcbs, npcb);               \
+		TCP_HASH_REG(npcb);                            \
 		tcp_active_pcbs_changed = 1;                   \
 	} while (0)
 
 #define TCP_RMV_ACTIVE(npcb)                       \
 	do {                                             \
+		TCP_HASH_RMV(npcb);                            \
 		TCP_RMV(&tcp_active_pcbs, npcb);               \
 		tcp_active_pcbs_changed = 1;                   \
 	} while (0)
@@ -437,6 +480,10 @@ extern struct tcp_pcb **const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 
 /* Internal functions: */
 struct tcp_pcb *tcp_pcb_copy(struct tcp_pcb *pcb);
+#if LWIP_PCB_HASH
+void tcp_pcb_hash_add(struct tcp_pcb *pcb);
+void tcp_pcb_hash_remove(struct tcp_pcb *pcb);
+#endif							/* LWIP_PCB_HASH */
 void tcp_pcb_purge(struct tcp_pcb *pcb);
 void tcp_pcb_remove(struct tcp_pcb **pcblist, struct tcp_pcb *pcb);
 
@@ -167,6 +167,7 @@ struct lwip_setgetsockopt_data {
 #endif /* IOV_MAX */
 
 struct msghdr;
+struct mmsghdr;
 
 /* struct msghdr->msg_flags bit field values */
 #define MSG_TRUNC   0x04
@@ -287,6 +288,7 @@ struct linger {
 #define MSG_OOB        0x04		/* Unimplemented: Requests out-of-band data. The significance and semantics of out-of-band data are protocol-specific */
 #define MSG_DONTWAIT   0x08		/* Nonblocking i/o for this operation only */
 #define MSG_MORE       0x10		/* Sender will send more */
+#define MSG_WAITFORONE 0x20		/* recvmmsg: do not wait after the first message (always the case) */
 
 /*
  * Options for level IPPROTO_IP
@@ -521,6 +523,13 @@ int lwip_sendto(int s, const void *dataptr, size_t size, int flags, const struct
 int lwip_socket(int domain, int type, int protocol);
 int lwip_write(int s, const void *dataptr, size_t size);
 int lwip_writev(int s, const struct iovec *iov, int iovcnt);
+int lwip_sendmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+int lwip_recvmmsg(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+#if LWIP_SOCKET_ZEROCOPY
+int lwip_recvmsg_zc(int s, struct msghdr *msg, int flags, void **zcbuf);
+int lwip_zc_release(void *zcbuf);
+int lwip_sendmsg_zc(int s, const struct msghdr *msg, int flags, void (*done)(void *arg, int result), void *arg);
+#endif							/* LWIP_SOCKET_ZEROCOPY */
 int lwip_select(int maxfdp1, fd_set * readset, fd_set * writeset, fd_set * exceptset, struct timeval *timeout);
 int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
@@ -154,7 +154,7 @@ typedef u32_t tcpwnd_size_t;
 typedef u16_t tcpwnd_size_t;
 #endif
 
-#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS
+#if LWIP_WND_SCALE || TCP_LISTEN_BACKLOG || LWIP_TCP_TIMESTAMPS || LWIP_TCP_SACK
 typedef u16_t tcpflags_t;
 #else
 typedef u8_t tcpflags_t;
@@ -177,8 +177,18 @@ enum tcp_state {
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
+#if LWIP_PCB_HASH
+/** for the hash chain, see lwip/priv/pcb_hash.h */
+#define TCP_PCB_HASH_COMMON(type) \
+		type *hash_next; \
+		type **hash_pprev;
+#else							/* LWIP_PCB_HASH */
+#define TCP_PCB_HASH_COMMON(type)
+#endif							/* LWIP_PCB_HASH */
+
 #define TCP_PCB_COMMON(type) \
 		type *next; /* for the linked list */ \
+		TCP_PCB_HASH_COMMON(type) \
 		void *callback_arg; \
 		enum tcp_state state; /* TCP state */ \
 		u8_t prio; \
@@ -230,6 +240,9 @@ struct tcp_pcb {
 #endif
 #if LWIP_TCP_TIMESTAMPS
 #define TF_TIMESTAMP   0x0400U	/* Timestamp option enabled */
+#endif
+#if LWIP_TCP_SACK
+#define TF_SACK        0x0800U	/* SACK option enabled */
 #endif
 
 	/* the rest of the fields are in host byte order
@@ -315,6 +328,24 @@ struct tcp_pcb {
 	u32_t ts_recent;
 #endif							/* LWIP_TCP_TIMESTAMPS */
 
+#if LWIP_TCP_SACK
+	u32_t rcv_sack_recent;	/* seqno of the last out-of-sequence segment received */
+	u32_t sack_recover;		/* snd_nxt when loss recovery was last entered */
+#if LWIP_TCP_RACK
+	u32_t rack_xmit_ts;		/* sys_now() when the most recently sent delivered segment was sent */
+	u32_t rack_end_seq;		/* end of that segment */
+	u32_t rack_rtt;			/* RTT of that segment in milliseconds */
+	u32_t rack_min_rtt;		/* minimum RTT seen, sets the reordering window */
+#endif							/* LWIP_TCP_RACK */
+#endif							/* LWIP_TCP_SACK */
+
+#if LWIP_STATS_PERF
+	u32_t perf_rtt_ts;		/* sys_now() when the segment being timed was sent */
+	u32_t perf_srtt;		/* smoothed RTT in milliseconds, scaled by 8 */
+	u32_t perf_rexmits;		/* segments retransmitted before a timeout */
+	u32_t perf_rtos;		/* retransmission timeouts */
+#endif							/* LWIP_STATS_PERF */
+
 	/* idle time before KEEPALIVE is sent */
 	u32_t keep_idle;
 #if LWIP_TCP_KEEPALIVE
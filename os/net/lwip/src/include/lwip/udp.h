@@ -94,6 +94,11 @@ struct udp_pcb {
 
 	/* Protocol specific PCB members */
 	struct udp_pcb *next;
+#if LWIP_PCB_HASH
+	/* for the hash chain, see lwip/priv/pcb_hash.h */
+	struct udp_pcb *hash_next;
+	struct udp_pcb **hash_pprev;
+#endif							/* LWIP_PCB_HASH */
 
 	u8_t flags;
 	/** ports are in host byte order */
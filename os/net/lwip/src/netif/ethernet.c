@@ -107,6 +107,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 		ETHARP_STATS_INC(etharp.proterr);
 		ETHARP_STATS_INC(etharp.drop);
 		MIB2_STATS_NETIF_INC(netif, ifinerrors);
+		NETIF_DROP_INC(netif, RX_HDR);
 		goto free_and_return;
 	}
 
@@ -137,6 +138,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 			ETHARP_STATS_INC(etharp.proterr);
 			ETHARP_STATS_INC(etharp.drop);
 			MIB2_STATS_NETIF_INC(netif, ifinerrors);
+			NETIF_DROP_INC(netif, RX_HDR);
 			goto free_and_return;
 		}
 #if defined(LWIP_HOOK_VLAN_CHECK) || defined(ETHARP_VLAN_CHECK) || defined(ETHARP_VLAN_CHECK_FN)	/* if not, allow all VLANs */
@@ -194,6 +196,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 		if ((p->len < ip_hdr_offset) || pbuf_header(p, (s16_t) - ip_hdr_offset)) {
 			LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_WARNING, ("ethernet_input: IPv4 packet dropped, too short (%" S16_F "/%" S16_F ")\n", p->tot_len, ip_hdr_offset));
 			LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("Can't move over header in packet"));
+			NETIF_DROP_INC(netif, RX_HDR);
 			goto free_and_return;
 		} else {
 			/* pass to IP layer */
@@ -214,6 +217,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 			ETHARP_STATS_INC(etharp.lenerr);
 			ETHARP_STATS_INC(etharp.drop);
 			MIB2_STATS_NETIF_INC(netif, ifinerrors);
+			NETIF_DROP_INC(netif, RX_HDR);
 			goto free_and_return;
 		} else {
 			/* pass p to ARP module */
@@ -243,6 +247,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 		if ((p->len < ip_hdr_offset) || pbuf_header(p, (s16_t) - ip_hdr_offset)) {
 			LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_WARNING, ("ethernet_input: IPv6 packet dropped, too short (%" S16_F "/%" S16_F ")\n", p->tot_len, ip_hdr_offset));
 			MIB2_STATS_NETIF_INC(netif, ifinerrors);
+			NETIF_DROP_INC(netif, RX_HDR);
 			goto free_and_return;
 		} else {
 			/* pass to IPv6 layer */
@@ -262,6 +267,7 @@ err_t ethernet_input(struct pbuf *p, struct netif *netif)
 		ETHARP_STATS_INC(etharp.proterr);
 		ETHARP_STATS_INC(etharp.drop);
 		MIB2_STATS_NETIF_INC(netif, ifinunknownprotos);
+		NETIF_DROP_INC(netif, RX_PROTO);
 		goto free_and_return;
 	}
 
@@ -328,13 +334,24 @@ err_t ethernet_output(struct netif * netif, struct pbuf * p, const struct eth_ad
 	/* send the packet */
 	MIB2_STATS_NETIF_ADD(netif, ifoutoctets, netif->d_len);
 	MIB2_STATS_NETIF_INC(netif, ifoutucastpkts);
+#if LWIP_STATS_PERF
+	{
+		err_t err = netif->linkoutput(netif, p);
+		if (err != ERR_OK) {
+			NETIF_DROP_INC(netif, TX_ERR);
+		}
+		return err;
+	}
+#else							/* LWIP_STATS_PERF */
 	return netif->linkoutput(netif, p);
+#endif							/* LWIP_STATS_PERF */
 
 pbuf_header_failed:
 	LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_SERIOUS, ("ethernet_output: could not allocate room for header.\n"));
 	LINK_STATS_INC(link.lenerr);
 	MIB2_STATS_NETIF_ADD(netif, ifoutoctets, netif->d_len);
 	MIB2_STATS_NETIF_INC(netif, ifoutdiscards);
+	NETIF_DROP_INC(netif, TX_NOBUF);
 	return ERR_BUF;
 }
 
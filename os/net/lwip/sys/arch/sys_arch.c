@@ -52,6 +52,287 @@
 
 static u16_t s_nextthread = 0;
 
+#ifdef CONFIG_NET_LWIP_MBOX_RING
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_wake
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Wake a thread blocked on "sem" unless every waiting thread already
+ *      has a wakeup pending.  Woken threads re-try the ring and block
+ *      again if they lose the race.  Called with the scheduler locked.
+ * Inputs:
+ *      sys_sem_t sem           -- Semaphore the waiters block on
+ *      u32_t waiters           -- Number of threads waiting
+ *---------------------------------------------------------------------------*/
+static void sys_mbox_wake(sys_sem_t *sem, u32_t waiters)
+{
+	int count;
+
+	if (waiters == 0) {
+		return;
+	}
+
+	if (sem_getvalue(sem, &count) == OK && count < (int)waiters) {
+		sys_sem_signal(sem);
+	}
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_new
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Creates a new mailbox
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      int queue_sz            -- Size of elements in the mailbox
+ * Outputs:
+ *      err_t                   -- ERR_OK if message posted, else ERR_MEM
+ *---------------------------------------------------------------------------*/
+err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
+{
+	mbox->is_valid = 1;
+#if LWIP_STATS
+	mbox->id = lwip_stats.sys.mbox.used + 1;
+#endif
+	mbox->wait_send = 0;
+	mbox->wait_fetch = 0;
+	sys_mbox_ring_init(&mbox->ring, queue_sz);
+	sys_sem_new(&(mbox->mail), 0);
+	sys_sem_new(&(mbox->space), 0);
+
+#if SYS_STATS
+	SYS_STATS_INC_USED(mbox);
+#endif							/* SYS_STATS */
+
+	LWIP_DEBUGF(SYS_DEBUG, ("Succesfully Created MBOX with id %d", mbox->id));
+	return ERR_OK;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_free
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Deallocates a mailbox. If there are messages still present in the
+ *      mailbox when the mailbox is deallocated, it is an indication of a
+ *      programming error in lwIP and the developer should be notified.
+ * Inputs:
+ *      sys_mbox_t *mbox         -- Handle of mailbox
+ *---------------------------------------------------------------------------*/
+void sys_mbox_free(sys_mbox_t *mbox)
+{
+	if (mbox != SYS_MBOX_NULL) {
+
+		LWIP_DEBUGF(SYS_DEBUG, ("Deleting MBOX with id %d", mbox->id));
+
+		mbox->is_valid = 0;
+		mbox->id = 0;
+		mbox->wait_send = 0;
+		mbox->wait_fetch = 0;
+		sys_sem_free(&(mbox->mail));
+		sys_sem_free(&(mbox->space));
+
+#if SYS_STATS
+		SYS_STATS_DEC(mbox.used);
+#endif							/* SYS_STATS */
+	}
+
+	return;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_post (Blocking Call)
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Post the "msg" to the mailbox, waiting while it is full.
+ * Inputs:
+ *      sys_mbox_t mbox        -- Handle of mailbox
+ *      void *msg              -- Pointer to data to post
+ *---------------------------------------------------------------------------*/
+void sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+	u32_t status;
+
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+
+	sched_lock();
+	while (sys_mbox_ring_put(&mbox->ring, msg) != 0) {
+		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, Wait until gets free\n"));
+		mbox->wait_send++;
+		sched_unlock();
+
+		status = sys_arch_sem_wait(&(mbox->space), 0);
+
+		sched_lock();
+		mbox->wait_send--;
+		if (status == SYS_ARCH_CANCELED) {
+			sched_unlock();
+			return;
+		}
+	}
+
+	sys_mbox_wake(&(mbox->mail), mbox->wait_fetch);
+	sched_unlock();
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_mbox_trypost
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Try to post the "msg" to the mailbox.  Returns immediately with
+ *      error if cannot.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void *msg               -- Pointer to data to post
+ * Outputs:
+ *      err_t                   -- ERR_OK if message posted, else ERR_MEM
+ *                                  if not.
+ *---------------------------------------------------------------------------*/
+err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+	err_t err = ERR_OK;
+
+	LWIP_DEBUGF(SYS_DEBUG, ("mbox %p msg %p\n", (void *)mbox, (void *)msg));
+
+	sched_lock();
+	if (sys_mbox_ring_put(&mbox->ring, msg) != 0) {
+		LWIP_DEBUGF(SYS_DEBUG, ("Queue Full, returning error\n"));
+		err = ERR_MEM;
+	} else {
+		sys_mbox_wake(&(mbox->mail), mbox->wait_fetch);
+	}
+	sched_unlock();
+
+	return err;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_fetch
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Blocks the thread until a message arrives in the mailbox, but does
+ *      not block the thread longer than "timeout" milliseconds (similar to
+ *      the sys_arch_sem_wait() function). The "msg" argument is a result
+ *      parameter that is set by the function (i.e., by doing "*msg =
+ *      ptr"). The "msg" parameter maybe NULL to indicate that the message
+ *      should be dropped.
+ *
+ *      The return values are the same as for the sys_arch_sem_wait() function:
+ *      Number of milliseconds spent waiting or SYS_ARCH_TIMEOUT if there was a
+ *      timeout.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msg              -- Pointer to pointer to msg received
+ *      u32_t timeout           -- Number of milliseconds until timeout
+ * Outputs:
+ *      u32_t                   -- SYS_ARCH_CANCELED if the operation canceled,
+ *				   SYS_ARCH_TIMEOUT if timeout, else number
+ *                                 of milliseconds until received.
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+	clock_t start = clock_systimer();
+	u32_t elapsed;
+	u32_t status;
+
+	sched_lock();
+	while (sys_mbox_ring_get(&mbox->ring, msg) != 0) {
+		mbox->wait_fetch++;
+		sched_unlock();
+
+		/* We block while waiting for a mail to arrive in the mailbox. A
+		 * wakeup may be stale, so the remaining time is recomputed on
+		 * every pass.
+		 */
+
+		if (timeout != 0) {
+			elapsed = TICK2MSEC(clock_systimer() - start);
+			if (elapsed >= timeout) {
+				status = SYS_ARCH_TIMEOUT;
+			} else if (timeout - elapsed < MSEC_PER_TICK) {
+				status = sys_arch_sem_wait(&(mbox->mail), MSEC_PER_TICK);
+			} else {
+				status = sys_arch_sem_wait(&(mbox->mail), timeout - elapsed);
+			}
+		} else {
+			status = sys_arch_sem_wait(&(mbox->mail), 0);
+		}
+
+		sched_lock();
+		mbox->wait_fetch--;
+		if (status == SYS_ARCH_CANCELED || status == SYS_ARCH_TIMEOUT) {
+			sched_unlock();
+			return status;
+		}
+	}
+
+	LWIP_DEBUGF(SYS_DEBUG, (" mbox %p msg %p\n", (void *)mbox, msg != NULL ? *msg : NULL));
+
+	/* We just fetched a msg, wake a post blocked on a full queue */
+
+	sys_mbox_wake(&(mbox->space), mbox->wait_send);
+	sched_unlock();
+
+	return TICK2MSEC(clock_systimer() - start);
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_tryfetch
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Similar to sys_arch_mbox_fetch, but if message is not ready
+ *      immediately, we'll return with SYS_MBOX_EMPTY.  On success, 0 is
+ *      returned.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msg              -- Pointer to pointer to msg received
+ * Outputs:
+ *      u32_t                   -- SYS_MBOX_EMPTY if no messages.  Otherwise,
+ *                                  return ERR_OK.
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+	u32_t err = ERR_OK;
+
+	sched_lock();
+	if (sys_mbox_ring_get(&mbox->ring, msg) != 0) {
+		LWIP_DEBUGF(SYS_DEBUG, ("SYS_MBOX_EMPTY , returning\n"));
+		err = SYS_MBOX_EMPTY;
+	} else {
+		sys_mbox_wake(&(mbox->space), mbox->wait_send);
+	}
+	sched_unlock();
+
+	return err;
+}
+
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_tryfetch_many
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Fetch up to "max" messages without blocking.  Posters waiting on a
+ *      full queue are woken once per freed slot.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msgs             -- Array receiving the messages
+ *      u32_t max               -- Size of the array
+ * Outputs:
+ *      u32_t                   -- Number of messages fetched
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_tryfetch_many(sys_mbox_t *mbox, void **msgs, u32_t max)
+{
+	u32_t n = 0;
+
+	sched_lock();
+	while (n < max && sys_mbox_ring_get(&mbox->ring, &msgs[n]) == 0) {
+		sys_mbox_wake(&(mbox->space), mbox->wait_send);
+		n++;
+	}
+	sched_unlock();
+
+	return n;
+}
+
+#else							/* CONFIG_NET_LWIP_MBOX_RING */
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_new
  *---------------------------------------------------------------------------*
@@ -75,6 +356,7 @@ err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz)
 	mbox->wait_fetch = 0;
 	mbox->front = mbox->rear = 0;
 	sys_sem_new(&(mbox->mail), 0);
+	sys_sem_new(&(mbox->space), 0);
 	sys_sem_new(&(mbox->mutex), 1);
 
 #if SYS_STATS
@@ -107,6 +389,7 @@ void sys_mbox_free(sys_mbox_t *mbox)
 		mbox->wait_send = 0;
 		mbox->wait_fetch = 0;
 		sys_sem_free(&(mbox->mail));
+		sys_sem_free(&(mbox->space));
 		sys_sem_free(&(mbox->mutex));
 
 		LWIP_DEBUGF(SYS_DEBUG, ("Succesfully deleted MBOX with id %d", mbox->id));
@@ -145,12 +428,16 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg)
 	while (tmp == mbox->front) {
 		mbox->wait_send++;
 		sys_sem_signal(&(mbox->mutex));
-		sys_arch_sem_wait(&(mbox->mail), 0);
+		sys_arch_sem_wait(&(mbox->space), 0);
 		status = sys_arch_sem_wait(&(mbox->mutex), 0);
 		mbox->wait_send--;
 		if (status == SYS_ARCH_CANCELED) {
 			return;
 		}
+
+		/* Another post may have taken the freed slot */
+
+		tmp = (mbox->rear + 1) % mbox->queue_size;
 	}
 
 	if (mbox->rear == mbox->front) {
@@ -305,7 +592,7 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
 	/* We just fetched a msg, Release semaphore for
 	   some post api blocked on this sem due to queue full. */
 	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
+		sys_sem_signal(&(mbox->space));
 	}
 
 	sys_sem_signal(&(mbox->mutex));
@@ -352,7 +639,7 @@ u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
 	/* We just fetched a msg, Release semaphore for
 	   some post api blocked on this sem due to queue full. */
 	if (mbox->wait_send) {
-		sys_sem_signal(&(mbox->mail));
+		sys_sem_signal(&(mbox->space));
 	}
 
 errout_with_mutex:
@@ -360,6 +647,31 @@ errout_with_mutex:
 	return err;
 }
 
+/*---------------------------------------------------------------------------*
+ * Routine:  sys_arch_mbox_tryfetch_many
+ *---------------------------------------------------------------------------*
+ * Description:
+ *      Fetch up to "max" messages without blocking.
+ * Inputs:
+ *      sys_mbox_t mbox         -- Handle of mailbox
+ *      void **msgs             -- Array receiving the messages
+ *      u32_t max               -- Size of the array
+ * Outputs:
+ *      u32_t                   -- Number of messages fetched
+ *---------------------------------------------------------------------------*/
+u32_t sys_arch_mbox_tryfetch_many(sys_mbox_t *mbox, void **msgs, u32_t max)
+{
+	u32_t n = 0;
+
+	while (n < max && sys_arch_mbox_tryfetch(mbox, &msgs[n]) == ERR_OK) {
+		n++;
+	}
+
+	return n;
+}
+
+#endif							/* CONFIG_NET_LWIP_MBOX_RING */
+
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_valid
  *---------------------------------------------------------------------------*
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <debug.h>: assertions go to the C library and the
+ * lwIP debug output to stdout.
+ */
+
+#ifndef __LWIP_PERF_HOST_DEBUG_H
+#define __LWIP_PERF_HOST_DEBUG_H
+
+#include <assert.h>
+#include <stdio.h>
+
+#define DEBUGASSERT(x)	assert(x)
+#define lwipdbg(...)	printf(__VA_ARGS__)
+#define dbg(...)
+#define ndbg(...)
+#define nvdbg(...)
+#define nlldbg(...)
+#define nllvdbg(...)
+
+#endif							/* __LWIP_PERF_HOST_DEBUG_H */
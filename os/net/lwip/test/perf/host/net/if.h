@@ -0,0 +1,41 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for the TizenRT <net/if.h>: the host header plus the drop
+ * reasons that lwIP counts per interface with CONFIG_NET_STATS_PERF.
+ */
+
+#ifndef __LWIP_PERF_HOST_NET_IF_H
+#define __LWIP_PERF_HOST_NET_IF_H
+
+#include_next <net/if.h>
+
+#ifdef CONFIG_NET_STATS_PERF
+enum netmon_drop {
+	NETMON_DROP_RX_NOMEM,
+	NETMON_DROP_RX_QFULL,
+	NETMON_DROP_RX_HDR,
+	NETMON_DROP_RX_CHKSUM,
+	NETMON_DROP_RX_PROTO,
+	NETMON_DROP_RX_ADDR,
+	NETMON_DROP_TX_NOBUF,
+	NETMON_DROP_TX_ERR,
+	NETMON_DROP_MAX,
+};
+#endif
+
+#endif							/* __LWIP_PERF_HOST_NET_IF_H */
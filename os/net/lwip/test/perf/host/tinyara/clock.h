@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <tinyara/clock.h>, used by the mailbox benchmark.  The
+ * system timer ticks every millisecond.
+ */
+
+#ifndef __LWIP_PERF_HOST_CLOCK_H
+#define __LWIP_PERF_HOST_CLOCK_H
+
+#include <time.h>
+
+#define MSEC_PER_TICK		1
+#define TICK2MSEC(t)		((t) * MSEC_PER_TICK)
+#define MSEC2TICK(m)		((m) / MSEC_PER_TICK)
+
+clock_t clock_systimer(void);
+
+#endif							/* __LWIP_PERF_HOST_CLOCK_H */
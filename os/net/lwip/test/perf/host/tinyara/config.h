@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <tinyara/config.h>.
+ *
+ * The lwIP options are taken from lwipopts.h exactly as on the target; only
+ * the CONFIG_ values feeding it are set here.  They follow the TCP/IPv4
+ * part of build/configs/artik053/nettest/defconfig.  Interfaces, ARP, DHCP,
+ * DNS, IGMP, IPv6 and the socket layer are left out: the benchmark drives
+ * the raw TCP and UDP API over a point-to-point link.
+ *
+ * Every value can be overridden from the command line, e.g.
+ *   make CONFIG="-DCONFIG_NET_TCP_SACK=1 -DCONFIG_NET_TCP_WND=29200"
+ */
+
+#ifndef __LWIP_PERF_HOST_CONFIG_H
+#define __LWIP_PERF_HOST_CONFIG_H
+
+#define FAR
+
+#define CONFIG_NET 1
+#define CONFIG_NET_LWIP 1
+#define CONFIG_NET_NETMGR 1
+#define CONFIG_NET_IPv4 1
+#define CONFIG_NET_TCP 1
+#define CONFIG_NET_UDP 1
+#define CONFIG_NET_SOCKET 0
+
+#ifndef CONFIG_NBSDSOCKET_DESCRIPTORS
+#define CONFIG_NBSDSOCKET_DESCRIPTORS 8
+#endif
+
+#ifndef CONFIG_NET_IP_DEFAULT_TTL
+#define CONFIG_NET_IP_DEFAULT_TTL 255
+#endif
+
+#ifndef CONFIG_NET_TCP_WND
+#define CONFIG_NET_TCP_WND 58400
+#endif
+
+#ifndef CONFIG_NET_TCP_MSS
+#define CONFIG_NET_TCP_MSS 1460
+#endif
+
+#ifndef CONFIG_NET_TCP_MAXRTX
+#define CONFIG_NET_TCP_MAXRTX 12
+#endif
+
+#ifndef CONFIG_NET_TCP_SYNMAXRTX
+#define CONFIG_NET_TCP_SYNMAXRTX 6
+#endif
+
+#ifndef CONFIG_NET_TCP_QUEUE_OOSEQ
+#define CONFIG_NET_TCP_QUEUE_OOSEQ 1
+#endif
+
+#ifndef CONFIG_NET_TCP_CALCULATE_EFF_SEND_MSS
+#define CONFIG_NET_TCP_CALCULATE_EFF_SEND_MSS 1
+#endif
+
+#ifndef CONFIG_NET_TCP_SND_BUF
+#define CONFIG_NET_TCP_SND_BUF 29200
+#endif
+
+#ifndef CONFIG_NET_TCP_SND_QUEUELEN
+#define CONFIG_NET_TCP_SND_QUEUELEN 80
+#endif
+
+#ifndef CONFIG_NET_TCP_OVERSIZE
+#define CONFIG_NET_TCP_OVERSIZE 536
+#endif
+
+#ifndef CONFIG_NET_TCP_WND_UPDATE_THRESHOLD
+#define CONFIG_NET_TCP_WND_UPDATE_THRESHOLD 14600
+#endif
+
+#ifndef CONFIG_NET_MEM_ALIGNMENT
+#define CONFIG_NET_MEM_ALIGNMENT 4
+#endif
+
+#ifndef CONFIG_NET_MEMP_MEM_MALLOC
+#define CONFIG_NET_MEMP_MEM_MALLOC 1
+#endif
+
+#ifndef CONFIG_NET_MEM_SIZE
+#define CONFIG_NET_MEM_SIZE 153600
+#endif
+
+#ifndef CONFIG_NET_SYS_LIGHTWEIGHT_PROT
+#define CONFIG_NET_SYS_LIGHTWEIGHT_PROT 1
+#endif
+
+#ifndef CONFIG_NET_STATS
+#define CONFIG_NET_STATS 1
+#define CONFIG_NET_IP_STATS 1
+#define CONFIG_NET_UDP_STATS 1
+#define CONFIG_NET_TCP_STATS 1
+#define CONFIG_NET_MEM_STATS 1
+#endif
+
+#endif							/* __LWIP_PERF_HOST_CONFIG_H */
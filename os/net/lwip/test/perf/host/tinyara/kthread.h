@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <tinyara/kthread.h> */
+
+#ifndef __LWIP_PERF_HOST_KTHREAD_H
+#define __LWIP_PERF_HOST_KTHREAD_H
+
+#include <tinyara/arch.h>
+
+int kernel_thread(const char *name, int priority, int stack_size, main_t entry, char *const argv[]);
+
+#endif							/* __LWIP_PERF_HOST_KTHREAD_H */
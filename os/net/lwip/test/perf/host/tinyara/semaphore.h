@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <tinyara/semaphore.h>: the TizenRT extensions to the
+ * POSIX semaphores that sys_arch.c uses.
+ */
+
+#ifndef __LWIP_PERF_HOST_SEMAPHORE_H
+#define __LWIP_PERF_HOST_SEMAPHORE_H
+
+#include <semaphore.h>
+#include <time.h>
+
+#define SEM_PRIO_NONE		0
+
+int sem_tickwait(sem_t *sem, clock_t start, int delay);
+int sem_setprotocol(sem_t *sem, int protocol);
+
+#endif							/* __LWIP_PERF_HOST_SEMAPHORE_H */
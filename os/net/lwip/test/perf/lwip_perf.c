@@ -0,0 +1,896 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file lwip_perf.c
+ * @brief Host benchmark of the lwIP TCP and UDP paths
+ *
+ * Runs the stack built from this tree, configured by lwipopts.h, over the
+ * emulated link of perf_link.c and reports one line per test:
+ *
+ *   tcp_bulk     one-way transfer of -n bytes
+ *   tcp_rps      -n request/response exchanges of -m bytes each way
+ *   tcp_connect  -n connect/accept/close cycles
+ *   udp_pps      -n datagrams of -m bytes, sent in bursts of 16
+ *
+ * Payload is copied into the stack on send and out of it on receive, as
+ * send() and recv() do.  With -z it is not: TCP writes reference the
+ * buffer, datagrams are sent from PBUF_REF pbufs and received pbufs are
+ * freed unread, as sendmsg_zc() and recvmsg_zc() let the socket layer do.
+ *
+ * With -c, that many idle TCP connections and bound UDP PCBs stay open
+ * next to the ones under test, so the cost of finding the PCB of an
+ * incoming packet among many shows up in the CPU figures.
+ *
+ * "virt_ms" is the virtual time the test took on the emulated link, and
+ * for the TCP tests "rate" is derived from it; it reflects the protocol
+ * behaviour (windows, timers, recovery).  "cpu_ms" is the host CPU time
+ * spent in the stack and the benchmark, and "cpu_ns_op" the same per byte,
+ * exchange, connection or datagram; the udp_pps rate is datagrams per CPU
+ * second.  Compare CPU figures between builds on the same host only.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lwip/opt.h"
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/priv/tcp_priv.h"
+
+#include "lwip_perf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERF_PORT_TCP		5001
+#define PERF_PORT_UDP		5002
+#define PERF_PORT_IDLE		5003
+#define PERF_PORT_IDLE_UDP	10000	/* First port of the idle UDP PCBs */
+#define PERF_MAX_IDLE		1024
+#define PERF_UDP_BURST		16
+#define PERF_TIMEOUT_MS		(600 * 1000)	/* Virtual time allowed per test */
+#define PERF_BUF_SIZE		0xffff
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum perf_fmt {
+	PERF_FMT_JSON,
+	PERF_FMT_CSV,
+};
+
+struct perf_result {
+	const char *test;
+	const char *unit;			/* Unit of rate */
+	u32_t count;				/* Bytes, exchanges, connections or datagrams */
+	u32_t virt_ms;
+	double cpu_ms;
+	double rate;
+	u32_t lost;					/* UDP datagrams not received */
+	int timeout;
+};
+
+struct perf_test {
+	/* Parameters */
+
+	u32_t count;
+	u16_t msgsize;
+
+	/* Connection state */
+
+	struct tcp_pcb *listener;
+	struct tcp_pcb *client;
+	struct tcp_pcb *server;
+	struct udp_pcb *usend;
+	struct udp_pcb *urecv;
+
+	/* Progress */
+
+	u32_t started;				/* Virtual time of the first byte */
+	u32_t queued;				/* Bytes given to tcp_write() */
+	u32_t received;				/* Bytes or datagrams received */
+	u32_t srv_pending;			/* Request bytes not yet answered */
+	u32_t cli_pending;			/* Response bytes still expected */
+	u32_t done;					/* Exchanges or connections completed */
+	int connected;
+	int error;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static u8_t g_buf[PERF_BUF_SIZE];
+static u8_t g_rxbuf[PERF_BUF_SIZE];
+static int g_zerocopy;
+static struct perf_link_cfg g_link;
+static struct tcp_pcb **g_idle_tcp;	/* Client and server end of each idle connection */
+static struct udp_pcb **g_idle_udp;
+static u32_t g_nidle;
+static u32_t g_accepted;
+static enum perf_fmt g_fmt = PERF_FMT_JSON;
+static int g_header;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double perf_cpu_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void perf_report(const struct perf_result *r)
+{
+	struct perf_link_stats ls;
+	double ns_op = r->count ? r->cpu_ms * 1000000.0 / r->count : 0;
+
+	perf_link_stats(&ls);
+
+	if (g_fmt == PERF_FMT_CSV) {
+		if (!g_header) {
+			printf("test,status,delay_ms,jitter_ms,loss_ppm,rate_kbps,seed,idle,zerocopy,"
+				   "count,virt_ms,cpu_ms,rate,unit,cpu_ns_op,pkts,bytes,drops,nomem,rexmits,lost\n");
+			g_header = 1;
+		}
+		printf("%s,%s,%u,%u,%u,%u,%u,%u,%d,%u,%u,%.3f,%.1f,%s,%.1f,%u,%u,%u,%u,%u,%u\n",
+			   r->test, r->timeout ? "timeout" : "ok",
+			   g_link.delay_ms, g_link.jitter_ms, g_link.loss_ppm, g_link.rate_kbps, g_link.seed, g_nidle, g_zerocopy,
+			   r->count, r->virt_ms, r->cpu_ms, r->rate, r->unit, ns_op,
+			   ls.pkts, ls.bytes, ls.drops, ls.nomem, ls.rexmits, r->lost);
+	} else {
+		printf("{\"test\":\"%s\",\"status\":\"%s\","
+			   "\"delay_ms\":%u,\"jitter_ms\":%u,\"loss_ppm\":%u,\"rate_kbps\":%u,\"seed\":%u,\"idle\":%u,\"zerocopy\":%d,"
+			   "\"count\":%u,\"virt_ms\":%u,\"cpu_ms\":%.3f,\"rate\":%.1f,\"unit\":\"%s\",\"cpu_ns_op\":%.1f,"
+			   "\"pkts\":%u,\"bytes\":%u,\"drops\":%u,\"nomem\":%u,\"rexmits\":%u,\"lost\":%u}\n",
+			   r->test, r->timeout ? "timeout" : "ok",
+			   g_link.delay_ms, g_link.jitter_ms, g_link.loss_ppm, g_link.rate_kbps, g_link.seed, g_nidle, g_zerocopy,
+			   r->count, r->virt_ms, r->cpu_ms, r->rate, r->unit, ns_op,
+			   ls.pkts, ls.bytes, ls.drops, ls.nomem, ls.rexmits, r->lost);
+	}
+	fflush(stdout);
+}
+
+static double perf_per_sec(u32_t count, u32_t ms)
+{
+	return ms ? count * 1000.0 / ms : 0;
+}
+
+/* Hand received data to the application */
+
+static void perf_consume(struct pbuf *p)
+{
+	if (!g_zerocopy) {
+		pbuf_copy_partial(p, g_rxbuf, p->tot_len, 0);
+	}
+	pbuf_free(p);
+}
+
+static u8_t perf_write_flags(void)
+{
+	return g_zerocopy ? 0 : TCP_WRITE_FLAG_COPY;
+}
+
+/* Only the idle connections are left */
+
+static int perf_idle(void *arg)
+{
+	struct tcp_pcb *pcb;
+	u32_t n = 0;
+
+	LWIP_UNUSED_ARG(arg);
+
+	for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+		n++;
+	}
+	return n == 2 * g_nidle && tcp_tw_pcbs == NULL;
+}
+
+/* Shut both ends down and let TIME_WAIT expire, so that the next test
+ * starts from an empty stack and heap.
+ */
+
+static void perf_teardown(struct perf_test *t)
+{
+	if (t->client != NULL) {
+		tcp_arg(t->client, NULL);
+		tcp_abort(t->client);
+	}
+	if (t->server != NULL) {
+		tcp_arg(t->server, NULL);
+		tcp_abort(t->server);
+	}
+	if (t->listener != NULL) {
+		tcp_close(t->listener);
+	}
+	if (t->usend != NULL) {
+		udp_remove(t->usend);
+	}
+	if (t->urecv != NULL) {
+		udp_remove(t->urecv);
+	}
+	perf_run(perf_idle, NULL, 2 * TCP_MSL + PERF_TIMEOUT_MS);
+	perf_link_reset();
+}
+
+/* On error the pcb is already freed by the stack */
+
+static void perf_client_err(void *arg, err_t err)
+{
+	struct perf_test *t = arg;
+
+	if (t != NULL) {
+		t->error = err;
+		t->client = NULL;
+	}
+}
+
+static void perf_server_err(void *arg, err_t err)
+{
+	struct perf_test *t = arg;
+
+	if (t != NULL) {
+		t->error = err;
+		t->server = NULL;
+	}
+}
+
+static int perf_listen(struct perf_test *t, tcp_accept_fn accept)
+{
+	struct tcp_pcb *pcb = tcp_new();
+
+	if (pcb == NULL) {
+		return -ENOMEM;
+	}
+	if (tcp_bind(pcb, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_TCP) != ERR_OK) {
+		tcp_abort(pcb);
+		return -EADDRINUSE;
+	}
+	t->listener = tcp_listen(pcb);
+	if (t->listener == NULL) {
+		tcp_abort(pcb);
+		return -ENOMEM;
+	}
+	tcp_arg(t->listener, t);
+	tcp_accept(t->listener, accept);
+	return 0;
+}
+
+static int perf_connect(struct perf_test *t, tcp_connected_fn connected)
+{
+	struct tcp_pcb *pcb = tcp_new();
+
+	if (pcb == NULL) {
+		return -ENOMEM;
+	}
+	if (tcp_bind(pcb, (const ip_addr_t *)perf_link_addr(PERF_CLIENT), 0) != ERR_OK) {
+		tcp_abort(pcb);
+		return -EADDRINUSE;
+	}
+	tcp_arg(pcb, t);
+	tcp_err(pcb, perf_client_err);
+	if (tcp_connect(pcb, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_TCP, connected) != ERR_OK) {
+		tcp_abort(pcb);
+		return -EHOSTUNREACH;
+	}
+	t->client = pcb;
+	return 0;
+}
+
+/****************************************************************************
+ * Idle PCBs
+ ****************************************************************************/
+
+static err_t idle_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	LWIP_UNUSED_ARG(arg);
+	LWIP_UNUSED_ARG(err);
+
+	g_idle_tcp[2 * g_accepted + 1] = pcb;
+	g_accepted++;
+	return ERR_OK;
+}
+
+static int idle_accepted(void *arg)
+{
+	LWIP_UNUSED_ARG(arg);
+
+	return g_accepted == g_nidle;
+}
+
+/* Open 'count' TCP connections and bind 'count' UDP PCBs that stay idle
+ * for the whole run.
+ */
+
+static int perf_idle_open(u32_t count)
+{
+	struct tcp_pcb *listener;
+	struct tcp_pcb *pcb;
+	u32_t i;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	g_idle_tcp = calloc(2 * count, sizeof(*g_idle_tcp));
+	g_idle_udp = calloc(count, sizeof(*g_idle_udp));
+	pcb = tcp_new();
+	if (g_idle_tcp == NULL || g_idle_udp == NULL || pcb == NULL ||
+		tcp_bind(pcb, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_IDLE) != ERR_OK) {
+		return -ENOMEM;
+	}
+	listener = tcp_listen_with_backlog(pcb, 255);
+	if (listener == NULL) {
+		return -ENOMEM;
+	}
+	tcp_accept(listener, idle_accept);
+
+	for (i = 0; i < count; i++) {
+		pcb = tcp_new();
+		if (pcb == NULL ||
+			tcp_bind(pcb, (const ip_addr_t *)perf_link_addr(PERF_CLIENT), 0) != ERR_OK ||
+			tcp_connect(pcb, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_IDLE, NULL) != ERR_OK) {
+			return -ENOMEM;
+		}
+		g_idle_tcp[2 * i] = pcb;
+		g_nidle++;
+
+		g_idle_udp[i] = udp_new();
+		if (g_idle_udp[i] == NULL ||
+			udp_bind(g_idle_udp[i], (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_IDLE_UDP + i) != ERR_OK) {
+			return -ENOMEM;
+		}
+
+		/* Connect a few at a time so the handshakes fit in the pools */
+
+		if ((g_nidle % 16 == 0 || g_nidle == count) &&
+			perf_run(idle_accepted, NULL, PERF_TIMEOUT_MS) != 0) {
+			return -ETIMEDOUT;
+		}
+	}
+	tcp_close(listener);
+	perf_link_reset();
+	return 0;
+}
+
+/****************************************************************************
+ * TCP bulk transfer
+ ****************************************************************************/
+
+static void bulk_send(struct perf_test *t)
+{
+	struct tcp_pcb *pcb = t->client;
+
+	while (t->queued < t->count) {
+		u32_t len = t->count - t->queued;
+
+		if (len > tcp_sndbuf(pcb)) {
+			len = tcp_sndbuf(pcb);
+		}
+		if (len > TCP_MSS * 4) {
+			len = TCP_MSS * 4;
+		}
+		if (len == 0 || tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN) {
+			break;
+		}
+		if (tcp_write(pcb, g_buf, (u16_t)len, perf_write_flags()) != ERR_OK) {
+			break;
+		}
+		t->queued += len;
+	}
+	tcp_output(pcb);
+}
+
+static err_t bulk_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(len);
+
+	bulk_send(arg);
+	return ERR_OK;
+}
+
+static err_t bulk_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	t->connected = 1;
+	t->started = perf_now();
+	tcp_sent(pcb, bulk_sent);
+	bulk_send(t);
+	return ERR_OK;
+}
+
+static err_t sink_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	if (p == NULL) {
+		return ERR_OK;
+	}
+	t->received += p->tot_len;
+	tcp_recved(pcb, p->tot_len);
+	perf_consume(p);
+	return ERR_OK;
+}
+
+static err_t sink_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	t->server = pcb;
+	tcp_arg(pcb, t);
+	tcp_err(pcb, perf_server_err);
+	tcp_recv(pcb, sink_recv);
+	return ERR_OK;
+}
+
+static int bulk_done(void *arg)
+{
+	struct perf_test *t = arg;
+
+	return t->error != ERR_OK || t->received >= t->count;
+}
+
+static void perf_tcp_bulk(u32_t bytes)
+{
+	struct perf_test t;
+	struct perf_result r;
+	double cpu;
+
+	memset(&t, 0, sizeof(t));
+	memset(&r, 0, sizeof(r));
+	t.count = bytes;
+	r.test = "tcp_bulk";
+	r.unit = "kbps";
+
+	cpu = perf_cpu_ms();
+	if (perf_listen(&t, sink_accept) == 0 && perf_connect(&t, bulk_connected) == 0) {
+		r.timeout = perf_run(bulk_done, &t, PERF_TIMEOUT_MS) != 0 || t.error != ERR_OK;
+	} else {
+		r.timeout = 1;
+	}
+	r.cpu_ms = perf_cpu_ms() - cpu;
+	r.count = t.received;
+	r.virt_ms = perf_now() - t.started;
+	r.rate = r.virt_ms ? t.received * 8.0 / r.virt_ms : 0;
+
+	perf_report(&r);
+	perf_teardown(&t);
+}
+
+/****************************************************************************
+ * TCP request/response
+ ****************************************************************************/
+
+static void rps_request(struct perf_test *t)
+{
+	t->cli_pending = t->msgsize;
+	if (tcp_write(t->client, g_buf, t->msgsize, perf_write_flags()) != ERR_OK) {
+		t->error = ERR_MEM;
+		return;
+	}
+	tcp_output(t->client);
+}
+
+static err_t rps_client_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	if (p == NULL) {
+		return ERR_OK;
+	}
+	tcp_recved(pcb, p->tot_len);
+	t->cli_pending -= LWIP_MIN(t->cli_pending, p->tot_len);
+	perf_consume(p);
+
+	if (t->cli_pending == 0 && ++t->done < t->count) {
+		rps_request(t);
+	}
+	return ERR_OK;
+}
+
+static err_t rps_server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	if (p == NULL) {
+		return ERR_OK;
+	}
+	tcp_recved(pcb, p->tot_len);
+	t->srv_pending += p->tot_len;
+	perf_consume(p);
+
+	while (t->srv_pending >= t->msgsize) {
+		t->srv_pending -= t->msgsize;
+		if (tcp_write(pcb, g_buf, t->msgsize, perf_write_flags()) != ERR_OK) {
+			t->error = ERR_MEM;
+			break;
+		}
+	}
+	tcp_output(pcb);
+	return ERR_OK;
+}
+
+static err_t rps_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	t->server = pcb;
+	tcp_arg(pcb, t);
+	tcp_err(pcb, perf_server_err);
+	tcp_recv(pcb, rps_server_recv);
+	return ERR_OK;
+}
+
+static err_t rps_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	t->connected = 1;
+	t->started = perf_now();
+	tcp_recv(pcb, rps_client_recv);
+	rps_request(t);
+	return ERR_OK;
+}
+
+static int rps_done(void *arg)
+{
+	struct perf_test *t = arg;
+
+	return t->error != ERR_OK || t->done >= t->count;
+}
+
+static void perf_tcp_rps(u32_t count, u16_t msgsize)
+{
+	struct perf_test t;
+	struct perf_result r;
+	double cpu;
+
+	memset(&t, 0, sizeof(t));
+	memset(&r, 0, sizeof(r));
+	t.count = count;
+	t.msgsize = msgsize;
+	r.test = "tcp_rps";
+	r.unit = "trans/s";
+
+	cpu = perf_cpu_ms();
+	if (perf_listen(&t, rps_accept) == 0 && perf_connect(&t, rps_connected) == 0) {
+		r.timeout = perf_run(rps_done, &t, PERF_TIMEOUT_MS) != 0 || t.error != ERR_OK;
+	} else {
+		r.timeout = 1;
+	}
+	r.cpu_ms = perf_cpu_ms() - cpu;
+	r.count = t.done;
+	r.virt_ms = perf_now() - t.started;
+	r.rate = perf_per_sec(t.done, r.virt_ms);
+
+	perf_report(&r);
+	perf_teardown(&t);
+}
+
+/****************************************************************************
+ * TCP connection setup
+ ****************************************************************************/
+
+static err_t conn_server_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	if (p != NULL) {
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+		return ERR_OK;
+	}
+
+	/* The client closed: close this end too, which completes the cycle */
+
+	tcp_arg(pcb, NULL);
+	tcp_close(pcb);
+	t->server = NULL;
+	t->done++;
+	return ERR_OK;
+}
+
+static err_t conn_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	t->server = pcb;
+	tcp_arg(pcb, t);
+	tcp_err(pcb, perf_server_err);
+	tcp_recv(pcb, conn_server_recv);
+	return ERR_OK;
+}
+
+static err_t conn_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(err);
+
+	/* The stack owns the pcb from here and frees it after TIME_WAIT */
+
+	tcp_arg(pcb, NULL);
+	tcp_close(pcb);
+	t->client = NULL;
+	t->connected = 1;
+	return ERR_OK;
+}
+
+static int conn_done(void *arg)
+{
+	struct perf_test *t = arg;
+
+	return t->error != ERR_OK || (t->connected && t->done >= t->count);
+}
+
+static void perf_tcp_connect(u32_t count)
+{
+	struct perf_test t;
+	struct perf_result r;
+	double cpu;
+
+	memset(&t, 0, sizeof(t));
+	memset(&r, 0, sizeof(r));
+	r.test = "tcp_connect";
+	r.unit = "conn/s";
+
+	cpu = perf_cpu_ms();
+	t.started = perf_now();
+	if (perf_listen(&t, conn_accept) != 0) {
+		r.timeout = 1;
+	}
+	while (!r.timeout && t.done < count) {
+		t.connected = 0;
+		t.count = t.done + 1;
+		if (perf_connect(&t, conn_connected) != 0 ||
+			perf_run(conn_done, &t, PERF_TIMEOUT_MS) != 0 || t.error != ERR_OK) {
+			r.timeout = 1;
+		}
+	}
+	r.cpu_ms = perf_cpu_ms() - cpu;
+	r.count = t.done;
+	r.virt_ms = perf_now() - t.started;
+	r.rate = perf_per_sec(t.done, r.virt_ms);
+
+	perf_report(&r);
+	perf_teardown(&t);
+}
+
+/****************************************************************************
+ * UDP datagrams
+ ****************************************************************************/
+
+static void udp_sink(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	struct perf_test *t = arg;
+
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(addr);
+	LWIP_UNUSED_ARG(port);
+
+	t->received++;
+	perf_consume(p);
+}
+
+/* A burst is over when everything sent has arrived or was lost */
+
+static int udp_burst_done(void *arg)
+{
+	struct perf_test *t = arg;
+	struct perf_link_stats ls;
+
+	perf_link_stats(&ls);
+	return t->received + ls.drops + ls.nomem >= t->queued;
+}
+
+static void perf_udp_pps(u32_t count, u16_t msgsize)
+{
+	struct perf_test t;
+	struct perf_result r;
+	double cpu;
+
+	memset(&t, 0, sizeof(t));
+	memset(&r, 0, sizeof(r));
+	r.test = "udp_pps";
+	r.unit = "pkt/s";
+
+	t.usend = udp_new();
+	t.urecv = udp_new();
+	if (t.usend == NULL || t.urecv == NULL ||
+		udp_bind(t.usend, (const ip_addr_t *)perf_link_addr(PERF_CLIENT), 0) != ERR_OK ||
+		udp_bind(t.urecv, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_UDP) != ERR_OK) {
+		r.timeout = 1;
+	} else {
+		udp_recv(t.urecv, udp_sink, &t);
+	}
+
+	cpu = perf_cpu_ms();
+	t.started = perf_now();
+	while (!r.timeout && t.queued < count) {
+		int i;
+
+		for (i = 0; i < PERF_UDP_BURST && t.queued < count; i++) {
+			struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, msgsize, g_zerocopy ? PBUF_REF : PBUF_RAM);
+
+			t.queued++;
+			if (p == NULL) {
+				continue;
+			}
+			if (g_zerocopy) {
+				p->payload = g_buf;
+			} else {
+				pbuf_take(p, g_buf, msgsize);
+			}
+			udp_sendto(t.usend, p, (const ip_addr_t *)perf_link_addr(PERF_SERVER), PERF_PORT_UDP);
+			pbuf_free(p);
+		}
+		r.timeout = perf_run(udp_burst_done, &t, PERF_TIMEOUT_MS) != 0;
+	}
+	r.cpu_ms = perf_cpu_ms() - cpu;
+	r.count = t.received;
+	r.lost = t.queued - t.received;
+	r.virt_ms = perf_now() - t.started;
+	r.rate = r.cpu_ms > 0 ? t.received * 1000.0 / r.cpu_ms : 0;
+
+	perf_report(&r);
+	perf_teardown(&t);
+}
+
+static void show_usage(const char *progname)
+{
+	fprintf(stderr, "Usage: %s [-t test] [-n count] [-m size] [-d delay_ms] [-j jitter_ms]\n"
+			"          [-l loss_pct] [-r rate_kbps] [-s seed] [-c idle] [-z] [-o json|csv]\n"
+			"  test: tcp_bulk, tcp_rps, tcp_connect, udp_pps or all (default)\n"
+			"  count: bytes, exchanges, connections or datagrams (default per test)\n"
+			"  size: request/response and datagram size (default 64)\n"
+			"  idle: idle TCP connections and UDP PCBs kept open (default 0)\n"
+			"  -z: do not copy payload into and out of the stack\n", progname);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	const char *test = "all";
+	u32_t count = 0;
+	u16_t msgsize = 64;
+	u32_t idle = 0;
+	double loss = 0.0;
+	char *end;
+	int all;
+	int opt;
+
+	g_link.delay_ms = 1;
+	g_link.seed = 1;
+
+	while ((opt = getopt(argc, argv, "t:n:m:d:j:l:r:s:c:zo:h")) != -1) {
+		switch (opt) {
+		case 't':
+			test = optarg;
+			break;
+		case 'n':
+			count = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			msgsize = (u16_t)strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			g_link.delay_ms = strtoul(optarg, NULL, 0);
+			break;
+		case 'j':
+			g_link.jitter_ms = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			loss = strtod(optarg, &end);
+			if (end == optarg || *end != '\0') {
+				fprintf(stderr, "loss must be 0..100\n");
+				return 1;
+			}
+			break;
+		case 'r':
+			g_link.rate_kbps = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			g_link.seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			idle = strtoul(optarg, NULL, 0);
+			break;
+		case 'z':
+			g_zerocopy = 1;
+			break;
+		case 'o':
+			g_fmt = strcmp(optarg, "csv") == 0 ? PERF_FMT_CSV : PERF_FMT_JSON;
+			break;
+		default:
+			show_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (!(loss >= 0.0 && loss <= 100.0)) {
+		fprintf(stderr, "loss must be 0..100\n");
+		return 1;
+	}
+	g_link.loss_ppm = (u32_t)(loss * 10000.0);
+	if (idle > PERF_MAX_IDLE) {
+		fprintf(stderr, "idle must be 0..%d\n", PERF_MAX_IDLE);
+		return 1;
+	}
+	if (msgsize == 0 || msgsize > TCP_SND_BUF) {
+		fprintf(stderr, "size must be 1..%d\n", TCP_SND_BUF);
+		return 1;
+	}
+
+	lwip_init();
+	perf_link_init(&g_link);
+	if (perf_idle_open(idle) != 0) {
+		fprintf(stderr, "cannot open %u idle connections\n", idle);
+		return 1;
+	}
+
+	all = strcmp(test, "all") == 0;
+	if (all || strcmp(test, "tcp_bulk") == 0) {
+		perf_tcp_bulk(count ? count : 4 * 1024 * 1024);
+	}
+	if (all || strcmp(test, "tcp_rps") == 0) {
+		perf_tcp_rps(count ? count : 10000, msgsize);
+	}
+	if (all || strcmp(test, "tcp_connect") == 0) {
+		perf_tcp_connect(count ? count : 1000);
+	}
+	if (all || strcmp(test, "udp_pps") == 0) {
+		perf_udp_pps(count ? count : 100000, msgsize);
+	}
+
+	return 0;
+}
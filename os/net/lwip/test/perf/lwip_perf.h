@@ -0,0 +1,74 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LWIP_PERF_H
+#define __LWIP_PERF_H
+
+#include "lwip/opt.h"
+#include "lwip/ip4_addr.h"
+#include "lwip/netif.h"
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Characteristics of the emulated link, applied to both directions */
+
+struct perf_link_cfg {
+	u32_t delay_ms;				/* One way propagation delay */
+	u32_t jitter_ms;			/* Random extra delay, 0..jitter_ms */
+	u32_t loss_ppm;				/* Packets lost per million */
+	u32_t rate_kbps;			/* Serialisation rate, 0 for unlimited */
+	u32_t seed;					/* Seed of the loss and jitter generator */
+};
+
+struct perf_link_stats {
+	u32_t pkts;					/* IP packets handed to the link */
+	u32_t bytes;				/* Bytes handed to the link */
+	u32_t drops;				/* Packets lost on the link */
+	u32_t nomem;				/* Packets lost for lack of a receive pbuf */
+	u32_t rexmits;				/* TCP segments carrying already sent data */
+};
+
+/* The two ends of the link */
+
+enum perf_side {
+	PERF_CLIENT = 0,
+	PERF_SERVER = 1,
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* perf_sys.c */
+
+u32_t perf_now(void);
+void perf_advance(u32_t ms);
+void perf_poll(void);
+
+/* perf_link.c */
+
+void perf_link_init(const struct perf_link_cfg *cfg);
+void perf_link_reset(void);
+const ip4_addr_t *perf_link_addr(enum perf_side side);
+void perf_link_stats(struct perf_link_stats *stats);
+int perf_run(int (*done)(void *arg), void *arg, u32_t timeout_ms);
+struct netif *perf_route_src(const ip4_addr_t *dest, const ip4_addr_t *src);
+
+#endif							/* __LWIP_PERF_H */
@@ -0,0 +1,314 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file mbox_perf.c
+ * @brief Host benchmark of the lwIP mailboxes
+ *
+ * Runs sys_mbox_post() and sys_arch_mbox_fetch() of sys/arch/sys_arch.c,
+ * built from this tree, with -p producer threads posting -n messages each
+ * to one mailbox of -q entries.  The consumer takes them the way the
+ * tcpip thread does: a blocking fetch followed by up to -b - 1 more with
+ * sys_arch_mbox_tryfetch_many().  Each producer's messages must arrive in
+ * order.
+ *
+ * With -w each producer waits after every post until the consumer has
+ * handled its message, as a netconn call waits for the tcpip thread on
+ * its op_completed semaphore.  The rate is then that of round trips
+ * through the tcpip thread.
+ *
+ * The TizenRT kernel calls sys_arch.c makes are replaced by host ones:
+ * the semaphores are the POSIX ones and sched_lock() takes a global mutex,
+ * which serializes the same sections the scheduler lock does on a single
+ * CPU target.  Build with CONFIG="-DCONFIG_NET_LWIP_MBOX_RING=1" for the
+ * ring mailboxes, without for the mutex queue; run under "taskset -c 0"
+ * to keep all threads on one CPU as on the target.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/kthread.h>
+#include <tinyara/semaphore.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MBOX_MAX_PRODUCERS	64
+#define MBOX_MAX_BATCH		64
+
+#ifdef CONFIG_NET_LWIP_MBOX_RING
+#define MBOX_KIND			"ring"
+#else
+#define MBOX_KIND			"queue"
+#endif
+
+/* A message carries its producer and sequence number */
+
+#define MBOX_MSG(p, n)		((void *)(uintptr_t)(((uintptr_t)(p) << 24) | (n)))
+#define MBOX_MSG_P(m)		((int)((uintptr_t)(m) >> 24))
+#define MBOX_MSG_N(m)		((u32_t)((uintptr_t)(m) & 0xffffff))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_sched_lock = PTHREAD_MUTEX_INITIALIZER;
+static sys_mbox_t g_mbox;
+static sys_sem_t g_done[MBOX_MAX_PRODUCERS];
+static u32_t g_count = 200000;
+static int g_wait;
+
+/****************************************************************************
+ * Host stand-ins for the kernel
+ ****************************************************************************/
+
+clock_t clock_systimer(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (clock_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+int sched_lock(void)
+{
+	return pthread_mutex_lock(&g_sched_lock);
+}
+
+int sched_unlock(void)
+{
+	return pthread_mutex_unlock(&g_sched_lock);
+}
+
+int sem_tickwait(sem_t *sem, clock_t start, int delay)
+{
+	struct timespec abstime;
+
+	(void)start;
+	clock_gettime(CLOCK_REALTIME, &abstime);
+	abstime.tv_sec += delay / 1000;
+	abstime.tv_nsec += (delay % 1000) * 1000000L;
+	if (abstime.tv_nsec >= 1000000000L) {
+		abstime.tv_sec++;
+		abstime.tv_nsec -= 1000000000L;
+	}
+
+	while (sem_timedwait(sem, &abstime) != 0) {
+		if (errno != EINTR) {
+			return -errno;
+		}
+	}
+	return OK;
+}
+
+int sem_setprotocol(sem_t *sem, int protocol)
+{
+	(void)sem;
+	(void)protocol;
+	return OK;
+}
+
+pid_t task_create(const char *name, int priority, int stack_size, main_t entry, char *const argv[])
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+int kernel_thread(const char *name, int priority, int stack_size, main_t entry, char *const argv[])
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static double mbox_ms(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void *mbox_producer(void *arg)
+{
+	int p = (int)(intptr_t)arg;
+	u32_t n;
+
+	for (n = 1; n <= g_count; n++) {
+		sys_mbox_post(&g_mbox, MBOX_MSG(p, n));
+		if (g_wait) {
+			sys_arch_sem_wait(&g_done[p], 0);
+		}
+	}
+
+	return NULL;
+}
+
+static void show_usage(const char *progname)
+{
+	fprintf(stderr, "Usage: %s [-p producers] [-n count] [-q size] [-b batch] [-w] [-o json|csv]\n"
+			"  producers: posting threads (default 4)\n"
+			"  count: messages per producer (default 200000)\n"
+			"  size: mailbox size (default 64)\n"
+			"  batch: messages taken per consumer wakeup (default 8)\n"
+			"  -w: wait for each message to be handled before the next post\n", progname);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	pthread_t threads[MBOX_MAX_PRODUCERS];
+	u32_t last[MBOX_MAX_PRODUCERS] = { 0 };
+	void *msgs[MBOX_MAX_BATCH];
+	int producers = 4;
+	int qsize = 64;
+	int batch = 8;
+	int csv = 0;
+	u32_t total;
+	u32_t got = 0;
+	u32_t errors = 0;
+	double wall;
+	double cpu;
+	u32_t n;
+	u32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:n:q:b:wo:h")) != -1) {
+		switch (opt) {
+		case 'p':
+			producers = atoi(optarg);
+			break;
+		case 'n':
+			g_count = strtoul(optarg, NULL, 0);
+			break;
+		case 'q':
+			qsize = atoi(optarg);
+			break;
+		case 'b':
+			batch = atoi(optarg);
+			break;
+		case 'w':
+			g_wait = 1;
+			break;
+		case 'o':
+			csv = strcmp(optarg, "csv") == 0;
+			break;
+		default:
+			show_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (producers < 1 || producers > MBOX_MAX_PRODUCERS) {
+		fprintf(stderr, "producers must be 1..%d\n", MBOX_MAX_PRODUCERS);
+		return 1;
+	}
+	if (g_count < 1 || g_count > 0xffffff) {
+		fprintf(stderr, "count must be 1..%d\n", 0xffffff);
+		return 1;
+	}
+	if (qsize < 2 || qsize > SYS_MBOX_MAXSIZE) {
+		fprintf(stderr, "size must be 2..%d\n", SYS_MBOX_MAXSIZE);
+		return 1;
+	}
+	if (batch < 1 || batch > MBOX_MAX_BATCH) {
+		fprintf(stderr, "batch must be 1..%d\n", MBOX_MAX_BATCH);
+		return 1;
+	}
+
+	sys_init();
+	if (sys_mbox_new(&g_mbox, qsize) != ERR_OK) {
+		fprintf(stderr, "sys_mbox_new failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < (u32_t)producers; i++) {
+		sys_sem_new(&g_done[i], 0);
+	}
+
+	total = g_count * producers;
+	wall = mbox_ms(CLOCK_MONOTONIC);
+	cpu = mbox_ms(CLOCK_PROCESS_CPUTIME_ID);
+	for (i = 0; i < (u32_t)producers; i++) {
+		pthread_create(&threads[i], NULL, mbox_producer, (void *)(intptr_t)i);
+	}
+
+	while (got < total) {
+		sys_arch_mbox_fetch(&g_mbox, &msgs[0], 0);
+		n = 1;
+		if (batch > 1) {
+			n += sys_arch_mbox_tryfetch_many(&g_mbox, &msgs[1], batch - 1);
+		}
+
+		for (i = 0; i < n; i++) {
+			int p = MBOX_MSG_P(msgs[i]);
+
+			if (p >= producers || MBOX_MSG_N(msgs[i]) != last[p] + 1) {
+				errors++;
+				continue;
+			}
+			last[p]++;
+			if (g_wait) {
+				sys_sem_signal(&g_done[p]);
+			}
+		}
+		got += n;
+	}
+
+	for (i = 0; i < (u32_t)producers; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	wall = mbox_ms(CLOCK_MONOTONIC) - wall;
+	cpu = mbox_ms(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+	sys_mbox_free(&g_mbox);
+	for (i = 0; i < (u32_t)producers; i++) {
+		sys_sem_free(&g_done[i]);
+	}
+
+	if (csv) {
+		printf("test,status,mbox,producers,size,batch,wait,count,wall_ms,cpu_ms,rate,unit,cpu_ns_op,errors\n");
+		printf("mbox,%s,%s,%d,%d,%d,%d,%u,%.3f,%.3f,%.1f,msgs/s,%.1f,%u\n",
+			   errors ? "error" : "ok", MBOX_KIND, producers, qsize, batch, g_wait,
+			   total, wall, cpu, wall > 0 ? total * 1000.0 / wall : 0, cpu * 1000000.0 / total, errors);
+	} else {
+		printf("{\"test\":\"mbox\",\"status\":\"%s\",\"mbox\":\"%s\","
+			   "\"producers\":%d,\"size\":%d,\"batch\":%d,\"wait\":%d,\"count\":%u,"
+			   "\"wall_ms\":%.3f,\"cpu_ms\":%.3f,\"rate\":%.1f,\"unit\":\"msgs/s\",\"cpu_ns_op\":%.1f,\"errors\":%u}\n",
+			   errors ? "error" : "ok", MBOX_KIND, producers, qsize, batch, g_wait,
+			   total, wall, cpu, wall > 0 ? total * 1000.0 / wall : 0, cpu * 1000000.0 / total, errors);
+	}
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file perf_link.c
+ * @brief Emulated point-to-point link between two lwIP interfaces
+ *
+ * Both ends live in the same stack: the client interface owns 10.0.0.1,
+ * the server interface 10.0.0.2, and perf_route_src() sends each packet
+ * out of the interface owning its source address.  An IP packet handed to
+ * an interface is copied off the stack, held for the configured delay
+ * (plus serialisation time and jitter) or dropped, and then delivered to
+ * the other interface from a fresh pool pbuf, as a driver would.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lwip/opt.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/priv/tcp_priv.h"
+
+#include "lwip_perf.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct perf_pkt {
+	struct perf_pkt *next;
+	u32_t due;					/* Virtual time of delivery */
+	enum perf_side to;			/* Receiving end */
+	u16_t len;
+	u8_t data[];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct perf_link_cfg g_cfg;
+static struct perf_link_stats g_stats;
+static struct netif g_netif[2];
+static ip4_addr_t g_addr[2];
+static struct perf_pkt *g_queue;	/* Sorted by due time */
+static u32_t g_busy[2];			/* End of serialisation per direction */
+static u32_t g_snd_max[2];		/* Highest TCP sequence sent per direction */
+static u32_t g_rand;
+static u32_t g_next_tmr;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static u32_t perf_rand(void)
+{
+	/* xorshift32, good enough for loss and jitter and reproducible */
+
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return g_rand;
+}
+
+/* Count TCP segments whose payload ends at or below what was already sent
+ * in that direction.  One connection at a time is assumed.
+ */
+
+static void perf_count_rexmit(enum perf_side from, const u8_t *data, u16_t len)
+{
+	const struct ip_hdr *iph = (const struct ip_hdr *)data;
+	const struct tcp_hdr *tcph;
+	u16_t hlen;
+	u16_t tlen;
+	u32_t seq;
+	u32_t end;
+
+	if (len < IP_HLEN || IPH_PROTO(iph) != IP_PROTO_TCP) {
+		return;
+	}
+	hlen = IPH_HL(iph) * 4;
+	if (len < hlen + TCP_HLEN) {
+		return;
+	}
+	tcph = (const struct tcp_hdr *)(data + hlen);
+	tlen = lwip_ntohs(IPH_LEN(iph)) - hlen - TCPH_HDRLEN(tcph) * 4;
+	seq = lwip_ntohl(tcph->seqno);
+	end = seq + tlen;
+
+	if (TCPH_FLAGS(tcph) & TCP_SYN) {
+		g_snd_max[from] = seq + 1;
+		return;
+	}
+	if (tlen == 0) {
+		return;
+	}
+	if (TCP_SEQ_LEQ(end, g_snd_max[from])) {
+		g_stats.rexmits++;
+	} else {
+		g_snd_max[from] = end;
+	}
+}
+
+static void perf_enqueue(struct perf_pkt *pkt)
+{
+	struct perf_pkt **pp = &g_queue;
+
+	while (*pp != NULL && TCP_SEQ_LEQ((*pp)->due, pkt->due)) {
+		pp = &(*pp)->next;
+	}
+	pkt->next = *pp;
+	*pp = pkt;
+}
+
+static err_t perf_link_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	enum perf_side from = (netif == &g_netif[PERF_CLIENT]) ? PERF_CLIENT : PERF_SERVER;
+	struct perf_pkt *pkt;
+	u32_t start;
+
+	LWIP_UNUSED_ARG(ipaddr);
+
+	g_stats.pkts++;
+	g_stats.bytes += p->tot_len;
+
+	pkt = malloc(sizeof(struct perf_pkt) + p->tot_len);
+	if (pkt == NULL) {
+		return ERR_MEM;
+	}
+	pkt->len = pbuf_copy_partial(p, pkt->data, p->tot_len, 0);
+	pkt->to = (from == PERF_CLIENT) ? PERF_SERVER : PERF_CLIENT;
+	perf_count_rexmit(from, pkt->data, pkt->len);
+
+	/* The packet occupies the wire even when it is lost afterwards */
+
+	start = perf_now();
+	if (g_cfg.rate_kbps != 0) {
+		if (TCP_SEQ_GT(g_busy[from], start)) {
+			start = g_busy[from];
+		}
+		g_busy[from] = start + (pkt->len * 8 + g_cfg.rate_kbps - 1) / g_cfg.rate_kbps;
+		start = g_busy[from];
+	}
+
+	if (g_cfg.loss_ppm != 0 && perf_rand() % 1000000 < g_cfg.loss_ppm) {
+		g_stats.drops++;
+		free(pkt);
+		return ERR_OK;
+	}
+
+	pkt->due = start + g_cfg.delay_ms;
+	if (g_cfg.jitter_ms != 0) {
+		pkt->due += perf_rand() % (g_cfg.jitter_ms + 1);
+	}
+	perf_enqueue(pkt);
+	return ERR_OK;
+}
+
+static void perf_deliver(struct perf_pkt *pkt)
+{
+	struct netif *netif = &g_netif[pkt->to];
+	struct pbuf *p;
+
+	p = pbuf_alloc(PBUF_RAW, pkt->len, PBUF_POOL);
+	if (p == NULL) {
+		g_stats.nomem++;
+		return;
+	}
+	pbuf_take(p, pkt->data, pkt->len);
+	if (netif->input(p, netif) != ERR_OK) {
+		pbuf_free(p);
+	}
+}
+
+static err_t perf_netif_init(struct netif *netif)
+{
+	netif->name[0] = 'p';
+	netif->name[1] = (netif == &g_netif[PERF_CLIENT]) ? 'c' : 's';
+	netif->output = perf_link_output;
+	netif->mtu = 1500;
+	netif->flags = NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/**
+ * Bring up both ends of the link.  lwip_init() must have been called.
+ */
+void perf_link_init(const struct perf_link_cfg *cfg)
+{
+	ip4_addr_t mask;
+	int i;
+
+	g_cfg = *cfg;
+	g_rand = cfg->seed != 0 ? cfg->seed : 1;
+	g_next_tmr = perf_now() + TCP_TMR_INTERVAL;
+
+	IP4_ADDR(&g_addr[PERF_CLIENT], 10, 0, 0, 1);
+	IP4_ADDR(&g_addr[PERF_SERVER], 10, 0, 0, 2);
+	IP4_ADDR(&mask, 255, 255, 255, 0);
+
+	for (i = 0; i < 2; i++) {
+		netif_add(&g_netif[i], &g_addr[i], &mask, &g_addr[1 - i], NULL, perf_netif_init, ip_input);
+		netif_set_up(&g_netif[i]);
+	}
+}
+
+/**
+ * Discard the packets in flight and clear the counters.
+ */
+void perf_link_reset(void)
+{
+	struct perf_pkt *pkt;
+
+	while ((pkt = g_queue) != NULL) {
+		g_queue = pkt->next;
+		free(pkt);
+	}
+	memset(&g_stats, 0, sizeof(g_stats));
+	g_busy[PERF_CLIENT] = g_busy[PERF_SERVER] = perf_now();
+}
+
+const ip4_addr_t *perf_link_addr(enum perf_side side)
+{
+	return &g_addr[side];
+}
+
+void perf_link_stats(struct perf_link_stats *stats)
+{
+	*stats = g_stats;
+}
+
+/**
+ * Deliver packets and run the TCP timers, advancing the virtual clock
+ * whenever nothing is due, until done() returns non-zero.
+ *
+ * @return 0 when done, -1 if timeout_ms of virtual time went by first
+ */
+int perf_run(int (*done)(void *arg), void *arg, u32_t timeout_ms)
+{
+	u32_t deadline = perf_now() + timeout_ms;
+	u32_t next;
+
+	while (!done(arg)) {
+		struct perf_pkt *pkt = g_queue;
+
+		perf_poll();
+
+		if (pkt != NULL && TCP_SEQ_LEQ(pkt->due, perf_now())) {
+			g_queue = pkt->next;
+			perf_deliver(pkt);
+			free(pkt);
+			continue;
+		}
+
+		if (TCP_SEQ_GEQ(perf_now(), deadline)) {
+			return -1;
+		}
+
+		next = g_next_tmr;
+		if (pkt != NULL && TCP_SEQ_LT(pkt->due, next)) {
+			next = pkt->due;
+		}
+		if (TCP_SEQ_GT(next, perf_now())) {
+			perf_advance(next - perf_now());
+		}
+		if (TCP_SEQ_GEQ(perf_now(), g_next_tmr)) {
+			g_next_tmr += TCP_TMR_INTERVAL;
+			tcp_tmr();
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * LWIP_HOOK_IP4_ROUTE_SRC: leave through the interface owning the source
+ * address, otherwise the peer's own interface would match first.
+ */
+struct netif *perf_route_src(const ip4_addr_t *dest, const ip4_addr_t *src)
+{
+	int i;
+
+	LWIP_UNUSED_ARG(dest);
+
+	if (src == NULL) {
+		return NULL;
+	}
+	for (i = 0; i < 2; i++) {
+		if (ip4_addr_cmp(src, &g_addr[i])) {
+			return &g_netif[i];
+		}
+	}
+	return NULL;
+}
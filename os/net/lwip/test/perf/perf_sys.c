@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/**
+ * @file perf_sys.c
+ * @brief Host replacement for the lwIP system layer used by the benchmark
+ *
+ * The benchmark runs the stack in a single thread, the way the tcpip
+ * thread does on the target, so protection and semaphores are no-ops and
+ * callbacks queued for the tcpip thread run from the event loop.  Time
+ * comes from a virtual millisecond clock that the event loop in
+ * perf_link.c advances; the TCP timers are called from there as well.
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+#include "lwip/timeouts.h"
+#include "lwip/tcpip.h"
+#include "lwip/priv/tcp_priv.h"
+
+#include "lwip_perf.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PERF_NCALLBACKS		8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct perf_callback {
+	tcpip_callback_fn function;
+	void *ctx;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static u32_t g_perf_now;
+static struct perf_callback g_callbacks[PERF_NCALLBACKS];
+static int g_ncallbacks;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+u32_t perf_now(void)
+{
+	return g_perf_now;
+}
+
+void perf_advance(u32_t ms)
+{
+	g_perf_now += ms;
+}
+
+/* Run the callbacks queued with tcpip_callback() */
+
+void perf_poll(void)
+{
+	while (g_ncallbacks > 0) {
+		struct perf_callback cb = g_callbacks[--g_ncallbacks];
+
+		cb.function(cb.ctx);
+	}
+}
+
+err_t tcpip_callback_with_block(tcpip_callback_fn function, void *ctx, u8_t block)
+{
+	LWIP_UNUSED_ARG(block);
+
+	if (g_ncallbacks == PERF_NCALLBACKS) {
+		return ERR_MEM;
+	}
+	g_callbacks[g_ncallbacks].function = function;
+	g_callbacks[g_ncallbacks].ctx = ctx;
+	g_ncallbacks++;
+	return ERR_OK;
+}
+
+u32_t sys_now(void)
+{
+	return g_perf_now;
+}
+
+void sys_init(void)
+{
+}
+
+#if LWIP_TIMERS
+void sys_timeouts_init(void)
+{
+}
+#endif
+
+#if LWIP_TCP
+void tcp_timer_needed(void)
+{
+	/* The event loop calls tcp_tmr() unconditionally */
+}
+#endif
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+	LWIP_UNUSED_ARG(sem);
+	LWIP_UNUSED_ARG(count);
+	return ERR_OK;
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+	LWIP_UNUSED_ARG(sem);
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+	LWIP_UNUSED_ARG(sem);
+	LWIP_UNUSED_ARG(timeout);
+	return 0;
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+	LWIP_UNUSED_ARG(sem);
+}
+
+#if SYS_LIGHTWEIGHT_PROT
+sys_prot_t sys_arch_protect(void)
+{
+	return 0;
+}
+
+void sys_arch_unprotect(sys_prot_t pval)
+{
+	LWIP_UNUSED_ARG(pval);
+}
+#endif
@@ -0,0 +1,488 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_pcb_hash.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "lwip/inet_chksum.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/prot/udp.h"
+#include "lwip/priv/tcp_priv.h"
+
+#if !LWIP_STATS || !MEMP_STATS
+#error "This tests needs MEMP-statistics enabled"
+#endif
+
+#define PCB_HASH_MAXPCBS   256
+#define PCB_HASH_ROUNDS    200		/* segments per pcb and benchmark run */
+#define PCB_HASH_BATCH     32		/* segments built ahead of each timed batch */
+#define PCB_HASH_TCP_PORT  1883		/* local port of all TCP connections */
+#define PCB_HASH_UDP_PORT  5683		/* local port of the first UDP pcb */
+#define PCB_HASH_RPORT     40000	/* remote port of the first connection */
+
+static struct netif g_netif;
+static ip_addr_t g_local;
+static ip_addr_t g_remote;
+static struct tcp_pcb *g_tcp[PCB_HASH_MAXPCBS];
+static struct udp_pcb *g_udp[PCB_HASH_MAXPCBS];
+static u32_t g_recv[PCB_HASH_MAXPCBS];
+
+/* Helper functions */
+
+static err_t pcb_hash_netif_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	LWIP_UNUSED_ARG(netif);
+	LWIP_UNUSED_ARG(p);
+	LWIP_UNUSED_ARG(ipaddr);
+	return ERR_OK;
+}
+
+static err_t pcb_hash_netif_init(struct netif *netif)
+{
+	netif->output = pcb_hash_netif_output;
+	netif->mtu = 1500;
+	netif->flags = NETIF_FLAG_BROADCAST;
+	return ERR_OK;
+}
+
+static void pcb_hash_remove_all(void)
+{
+	while (tcp_active_pcbs != NULL) {
+		tcp_abort(tcp_active_pcbs);
+	}
+	while (tcp_tw_pcbs != NULL) {
+		tcp_abort(tcp_tw_pcbs);
+	}
+	while (tcp_listen_pcbs.pcbs != NULL) {
+		tcp_close(tcp_listen_pcbs.pcbs);
+	}
+	while (udp_pcbs != NULL) {
+		udp_remove(udp_pcbs);
+	}
+
+	memset(g_tcp, 0, sizeof(g_tcp));
+	memset(g_udp, 0, sizeof(g_udp));
+	memset(g_recv, 0, sizeof(g_recv));
+
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB_LISTEN]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_UDP_PCB]->used == 0);
+}
+
+/* Allocate a datagram from g_remote to g_local with an IPv4 header in
+ * front of 'len' bytes of transport header and data.  The payload is left
+ * at the transport header, as ip4_input() passes it up.
+ */
+static struct pbuf *pcb_hash_alloc(u8_t proto, u16_t len)
+{
+	struct pbuf *p;
+	struct ip_hdr *iphdr;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + len, PBUF_RAM);
+	EXPECT_RETNULL(p != NULL);
+	memset(p->payload, 0, p->len);
+
+	iphdr = (struct ip_hdr *)p->payload;
+	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(iphdr, lwip_htons(IP_HLEN + len));
+	IPH_TTL_SET(iphdr, 64);
+	IPH_PROTO_SET(iphdr, proto);
+	ip4_addr_copy(iphdr->src, *ip_2_ip4(&g_remote));
+	ip4_addr_copy(iphdr->dest, *ip_2_ip4(&g_local));
+
+	pbuf_header(p, -IP_HLEN);
+	return p;
+}
+
+static struct pbuf *pcb_hash_tcp_segment(u16_t remote_port, u16_t local_port, u32_t seqno, u32_t ackno, u8_t flags, u16_t datalen)
+{
+	struct pbuf *p;
+	struct tcp_hdr *tcphdr;
+
+	p = pcb_hash_alloc(IP_PROTO_TCP, TCP_HLEN + datalen);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	tcphdr = (struct tcp_hdr *)p->payload;
+	tcphdr->src = lwip_htons(remote_port);
+	tcphdr->dest = lwip_htons(local_port);
+	tcphdr->seqno = lwip_htonl(seqno);
+	tcphdr->ackno = lwip_htonl(ackno);
+	TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, flags);
+	tcphdr->wnd = lwip_htons(TCP_WND);
+	tcphdr->chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, &g_remote, &g_local);
+	return p;
+}
+
+/* A segment the connection accepts: pure ACK or one byte of data */
+
+static struct pbuf *pcb_hash_tcp_rx(struct tcp_pcb *pcb, u16_t datalen)
+{
+	return pcb_hash_tcp_segment(pcb->remote_port, pcb->local_port, pcb->rcv_nxt, pcb->snd_nxt, TCP_ACK | (datalen ? TCP_PSH : 0), datalen);
+}
+
+static struct pbuf *pcb_hash_udp_datagram(u16_t remote_port, u16_t local_port)
+{
+	struct pbuf *p;
+	struct udp_hdr *udphdr;
+
+	p = pcb_hash_alloc(IP_PROTO_UDP, UDP_HLEN + 1);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	/* no checksum */
+	udphdr = (struct udp_hdr *)p->payload;
+	udphdr->src = lwip_htons(remote_port);
+	udphdr->dest = lwip_htons(local_port);
+	udphdr->len = lwip_htons(UDP_HLEN + 1);
+	return p;
+}
+
+/* Pass a datagram from pcb_hash_alloc() to tcp_input() or udp_input() the
+ * way ip4_input() does.
+ */
+static void pcb_hash_input(struct pbuf *p)
+{
+	struct ip_hdr *iphdr = (struct ip_hdr *)((u8_t *)p->payload - IP_HLEN);
+
+	ip_data.current_netif = &g_netif;
+	ip_data.current_input_netif = &g_netif;
+	ip_data.current_ip4_header = iphdr;
+	ip_data.current_ip_header_tot_len = IP_HLEN;
+	ip_addr_copy_from_ip4(ip_data.current_iphdr_src, iphdr->src);
+	ip_addr_copy_from_ip4(ip_data.current_iphdr_dest, iphdr->dest);
+
+	if (IPH_PROTO(iphdr) == IP_PROTO_TCP) {
+		tcp_input(p, &g_netif);
+	} else {
+		udp_input(p, &g_netif);
+	}
+
+	memset(&ip_data, 0, sizeof(ip_data));
+}
+
+static err_t pcb_hash_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	LWIP_UNUSED_ARG(err);
+
+	if (p != NULL) {
+		g_recv[(intptr_t)arg]++;
+		tcp_recved(pcb, p->tot_len);
+		pbuf_free(p);
+	}
+	return ERR_OK;
+}
+
+static void pcb_hash_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(addr);
+	LWIP_UNUSED_ARG(port);
+
+	g_recv[(intptr_t)arg]++;
+	pbuf_free(p);
+}
+
+/* Open 'n' established connections to PCB_HASH_TCP_PORT, one per remote port */
+
+static void pcb_hash_tcp_open(int n)
+{
+	struct tcp_pcb *pcb;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pcb = tcp_new();
+		EXPECT_RET(pcb != NULL);
+		pcb->state = ESTABLISHED;
+		ip_addr_copy(pcb->local_ip, g_local);
+		ip_addr_copy(pcb->remote_ip, g_remote);
+		pcb->local_port = PCB_HASH_TCP_PORT;
+		pcb->remote_port = (u16_t)(PCB_HASH_RPORT + i);
+		pcb->rcv_nxt = 1000;
+		pcb->snd_nxt = pcb->lastack = pcb->snd_lbb = 2000;
+		tcp_arg(pcb, (void *)(intptr_t)i);
+		tcp_recv(pcb, pcb_hash_tcp_recv);
+		TCP_REG_ACTIVE(pcb);
+		g_tcp[i] = pcb;
+	}
+}
+
+/* Bind 'n' UDP pcbs to consecutive ports from PCB_HASH_UDP_PORT */
+
+static void pcb_hash_udp_open(int n)
+{
+	struct udp_pcb *pcb;
+	err_t err;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pcb = udp_new();
+		EXPECT_RET(pcb != NULL);
+		err = udp_bind(pcb, &g_local, (u16_t)(PCB_HASH_UDP_PORT + i));
+		EXPECT_RET(err == ERR_OK);
+		udp_recv(pcb, pcb_hash_udp_recv, (void *)(intptr_t)i);
+		g_udp[i] = pcb;
+	}
+}
+
+static double pcb_hash_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Average nanoseconds per tcp_input() or udp_input() call with traffic
+ * spread round-robin over the first 'n' pcbs, so that move-to-front does
+ * not help the list lookup.  Only the input calls are timed.
+ */
+static double pcb_hash_bench(int tcp, int n)
+{
+	struct pbuf *p[PCB_HASH_BATCH];
+	struct timespec start;
+	double elapsed = 0;
+	int round;
+	int i;
+	int j;
+	int k;
+
+	for (round = 0; round < PCB_HASH_ROUNDS; round++) {
+		for (i = 0; i < n; i += k) {
+			k = LWIP_MIN(PCB_HASH_BATCH, n - i);
+			for (j = 0; j < k; j++) {
+				if (tcp) {
+					p[j] = pcb_hash_tcp_rx(g_tcp[i + j], 0);
+				} else {
+					p[j] = pcb_hash_udp_datagram(PCB_HASH_RPORT, (u16_t)(PCB_HASH_UDP_PORT + i + j));
+				}
+				fail_unless(p[j] != NULL);
+			}
+
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			for (j = 0; j < k; j++) {
+				pcb_hash_input(p[j]);
+			}
+			elapsed += pcb_hash_elapsed(&start);
+		}
+	}
+
+	return elapsed * 1e9 / ((double)PCB_HASH_ROUNDS * n);
+}
+
+/* Setups/teardown functions */
+
+static void pcb_hash_setup(void)
+{
+	ip4_addr_t netmask;
+	ip4_addr_t gw;
+
+	IP_ADDR4(&g_local, 192, 168, 0, 1);
+	IP_ADDR4(&g_remote, 192, 168, 0, 2);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	IP4_ADDR(&gw, 192, 168, 0, 254);
+
+	netif_add(&g_netif, ip_2_ip4(&g_local), &netmask, &gw, NULL, pcb_hash_netif_init, NULL);
+	netif_set_default(&g_netif);
+	netif_set_up(&g_netif);
+
+	pcb_hash_remove_all();
+}
+
+static void pcb_hash_teardown(void)
+{
+	pcb_hash_remove_all();
+	netif_remove(&g_netif);
+}
+
+/* Test functions */
+
+/** Every segment reaches its own connection, also after others went away */
+START_TEST(test_pcb_hash_tcp_demux)
+{
+	struct pbuf *p;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb_hash_tcp_open(PCB_HASH_MAXPCBS);
+
+	/* reverse order, so the list lookup has to walk */
+	for (i = PCB_HASH_MAXPCBS - 1; i >= 0; i--) {
+		p = pcb_hash_tcp_rx(g_tcp[i], 1);
+		EXPECT_RET(p != NULL);
+		pcb_hash_input(p);
+	}
+	for (i = 0; i < PCB_HASH_MAXPCBS; i++) {
+		fail_unless(g_recv[i] == 1);
+	}
+
+	/* abort every other connection: its segments must not be taken by a
+	 * remaining one and the remaining ones must still be found
+	 */
+	for (i = 0; i < PCB_HASH_MAXPCBS; i += 2) {
+		tcp_abort(g_tcp[i]);
+		g_tcp[i] = NULL;
+	}
+	for (i = 0; i < PCB_HASH_MAXPCBS; i++) {
+		if (g_tcp[i] != NULL) {
+			p = pcb_hash_tcp_rx(g_tcp[i], 1);
+		} else {
+			p = pcb_hash_tcp_segment((u16_t)(PCB_HASH_RPORT + i), PCB_HASH_TCP_PORT, 1001, 2000, TCP_ACK | TCP_PSH, 1);
+		}
+		EXPECT_RET(p != NULL);
+		pcb_hash_input(p);
+	}
+	for (i = 0; i < PCB_HASH_MAXPCBS; i++) {
+		fail_unless(g_recv[i] == ((i & 1) ? 2 : 1));
+	}
+}
+
+END_TEST
+/** A SYN reaches the listener on its port and creates a new connection */
+START_TEST(test_pcb_hash_tcp_listen)
+{
+	struct tcp_pcb *pcb;
+	struct pbuf *p;
+	u16_t used;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < 4; i++) {
+		pcb = tcp_new();
+		EXPECT_RET(pcb != NULL);
+		err = tcp_bind(pcb, &g_local, (u16_t)(PCB_HASH_TCP_PORT + i));
+		EXPECT_RET(err == ERR_OK);
+		pcb = tcp_listen(pcb);
+		EXPECT_RET(pcb != NULL);
+	}
+
+	for (i = 0; i < 4; i++) {
+		used = lwip_stats.memp[MEMP_TCP_PCB]->used;
+		p = pcb_hash_tcp_segment(PCB_HASH_RPORT, (u16_t)(PCB_HASH_TCP_PORT + i), 5000, 0, TCP_SYN, 0);
+		EXPECT_RET(p != NULL);
+		pcb_hash_input(p);
+		fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == used + 1);
+		fail_unless(tcp_active_pcbs != NULL && tcp_active_pcbs->state == SYN_RCVD);
+		fail_unless(tcp_active_pcbs->local_port == PCB_HASH_TCP_PORT + i);
+	}
+
+	/* nobody listens here: answered with a RST, no connection */
+	used = lwip_stats.memp[MEMP_TCP_PCB]->used;
+	p = pcb_hash_tcp_segment(PCB_HASH_RPORT, PCB_HASH_TCP_PORT + 4, 5000, 0, TCP_SYN, 0);
+	EXPECT_RET(p != NULL);
+	pcb_hash_input(p);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == used);
+}
+
+END_TEST
+/** Datagrams reach the pcb bound to their port, also after a rebind */
+START_TEST(test_pcb_hash_udp_demux)
+{
+	struct pbuf *p;
+	err_t err;
+	int i;
+	LWIP_UNUSED_ARG(_i);
+
+	pcb_hash_udp_open(PCB_HASH_MAXPCBS);
+
+	for (i = PCB_HASH_MAXPCBS - 1; i >= 0; i--) {
+		p = pcb_hash_udp_datagram(PCB_HASH_RPORT, (u16_t)(PCB_HASH_UDP_PORT + i));
+		EXPECT_RET(p != NULL);
+		pcb_hash_input(p);
+	}
+	for (i = 0; i < PCB_HASH_MAXPCBS; i++) {
+		fail_unless(g_recv[i] == 1);
+	}
+
+	/* move pcb 0 onto a free port */
+	err = udp_bind(g_udp[0], &g_local, PCB_HASH_UDP_PORT + PCB_HASH_MAXPCBS);
+	EXPECT_RET(err == ERR_OK);
+	p = pcb_hash_udp_datagram(PCB_HASH_RPORT, PCB_HASH_UDP_PORT + PCB_HASH_MAXPCBS);
+	EXPECT_RET(p != NULL);
+	pcb_hash_input(p);
+	fail_unless(g_recv[0] == 2);
+
+	/* a connected pcb only takes datagrams from its peer */
+	err = udp_connect(g_udp[2], &g_remote, PCB_HASH_RPORT);
+	EXPECT_RET(err == ERR_OK);
+	p = pcb_hash_udp_datagram(PCB_HASH_RPORT, PCB_HASH_UDP_PORT + 2);
+	EXPECT_RET(p != NULL);
+	pcb_hash_input(p);
+	p = pcb_hash_udp_datagram(PCB_HASH_RPORT + 1, PCB_HASH_UDP_PORT + 2);
+	EXPECT_RET(p != NULL);
+	pcb_hash_input(p);
+	fail_unless(g_recv[2] == 2);
+
+	/* a removed pcb is gone from the table */
+	udp_remove(g_udp[2]);
+	g_udp[2] = NULL;
+	p = pcb_hash_udp_datagram(PCB_HASH_RPORT, PCB_HASH_UDP_PORT + 2);
+	EXPECT_RET(p != NULL);
+	pcb_hash_input(p);
+	fail_unless(g_recv[2] == 2);
+	fail_unless(g_recv[3] == 1);
+}
+
+END_TEST
+/** Input cost versus the number of open pcbs */
+START_TEST(test_pcb_hash_bench)
+{
+	static const int npcbs[] = { 1, 16, 64, 256 };
+	double tcp;
+	double udp;
+	size_t i;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < sizeof(npcbs) / sizeof(npcbs[0]); i++) {
+		pcb_hash_tcp_open(npcbs[i]);
+		pcb_hash_udp_open(npcbs[i]);
+
+		tcp = pcb_hash_bench(1, npcbs[i]);
+		udp = pcb_hash_bench(0, npcbs[i]);
+		printf("pcb_hash: LWIP_PCB_HASH=%d %3d pcbs, tcp_input %.0f ns, udp_input %.0f ns\n", LWIP_PCB_HASH, npcbs[i], tcp, udp);
+
+		pcb_hash_remove_all();
+	}
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *pcb_hash_suite(void)
+{
+	TFun tests[] = {
+		test_pcb_hash_tcp_demux,
+		test_pcb_hash_tcp_listen,
+		test_pcb_hash_udp_demux,
+		test_pcb_hash_bench
+	};
+	return create_suite("PCB_HASH", tests, sizeof(tests) / sizeof(TFun), pcb_hash_setup, pcb_hash_teardown);
+}
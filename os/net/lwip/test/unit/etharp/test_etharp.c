@@ -18,6 +18,8 @@
 
 #include "test_etharp.h"
 
+#include <string.h>
+
 #include "lwip/udp.h"
 #include "lwip/netif/etharp.h"
 #include "lwip/stats.h"
@@ -99,13 +101,13 @@ static void create_arp_response(ip_addr_t *adr)
 
 	ethhdr->dest = test_ethaddr;
 	ethhdr->src = test_ethaddr2;
-	ethhdr->type = htons(ETHTYPE_ARP);
+	ethhdr->type = lwip_htons(ETHTYPE_ARP);
 
-	etharphdr->hwtype = htons(/*HWTYPE_ETHERNET */ 1);
-	etharphdr->proto = htons(ETHTYPE_IP);
+	etharphdr->hwtype = lwip_htons(/*HWTYPE_ETHERNET */ 1);
+	etharphdr->proto = lwip_htons(ETHTYPE_IP);
 	etharphdr->hwlen = ETHARP_HWADDR_LEN;
 	etharphdr->protolen = sizeof(ip_addr_t);
-	etharphdr->opcode = htons(ARP_REPLY);
+	etharphdr->opcode = lwip_htons(ARP_REPLY);
 
 	SMEMCPY(&etharphdr->sipaddr, adr, sizeof(ip_addr_t));
 	SMEMCPY(&etharphdr->dipaddr, &test_ipaddr, sizeof(ip_addr_t));
@@ -147,7 +149,7 @@ START_TEST(test_etharp_table)
 	err_t err;
 #endif							/* ETHARP_SUPPORT_STATIC_ENTRIES */
 	s8_t idx;
-	ip_addr_t *unused_ipaddr;
+	const ip4_addr_t *unused_ipaddr;
 	struct eth_addr *unused_ethaddr;
 	struct udp_pcb *pcb;
 	LWIP_UNUSED_ARG(_i);
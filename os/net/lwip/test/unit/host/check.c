@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* The check functions used by the lwIP unit tests, see check.h */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "check.h"
+
+static jmp_buf ck_jmp;
+static const char *ck_test;
+
+void ck_fail(const char *file, int line, const char *msg)
+{
+	printf("%s:%d:F:%s: %s\n", file, line, ck_test, msg);
+	longjmp(ck_jmp, 1);
+}
+
+Suite *suite_create(const char *name)
+{
+	Suite *s = (Suite *)calloc(1, sizeof(Suite));
+
+	s->name = name;
+	s->last = &s->tcases;
+	return s;
+}
+
+TCase *tcase_create(const char *name)
+{
+	(void)name;
+	return (TCase *)calloc(1, sizeof(TCase));
+}
+
+void tcase_add_checked_fixture(TCase *tc, SFun setup, SFun teardown)
+{
+	tc->setup = setup;
+	tc->teardown = teardown;
+}
+
+void ck_tcase_add_test(TCase *tc, TFun tf, const char *name)
+{
+	if (tc->ntests < CK_MAX_TESTS) {
+		tc->names[tc->ntests] = name;
+		tc->tests[tc->ntests++] = tf;
+	}
+}
+
+void suite_add_tcase(Suite *s, TCase *tc)
+{
+	*s->last = tc;
+	s->last = &tc->next;
+}
+
+void srunner_add_suite(SRunner *sr, Suite *s)
+{
+	*sr->last = s;
+	sr->last = &s->next;
+}
+
+SRunner *srunner_create(Suite *s)
+{
+	SRunner *sr = (SRunner *)calloc(1, sizeof(SRunner));
+
+	sr->last = &sr->suites;
+	sr->fstat = CK_FORK;
+	srunner_add_suite(sr, s);
+	return sr;
+}
+
+void srunner_set_fork_status(SRunner *sr, enum fork_status fstat)
+{
+	sr->fstat = fstat;
+}
+
+/* Run one test with its fixture, return 1 if an assertion failed */
+
+static int ck_run_test(TCase *tc, int i)
+{
+	volatile int failed = 0;
+
+	ck_test = tc->names[i];
+	if (setjmp(ck_jmp) == 0) {
+		if (tc->setup != NULL) {
+			tc->setup();
+		}
+		tc->tests[i](i);
+	} else {
+		failed = 1;
+	}
+	if (setjmp(ck_jmp) == 0) {
+		if (tc->teardown != NULL) {
+			tc->teardown();
+		}
+	} else {
+		failed = 1;
+	}
+	return failed;
+}
+
+static int ck_fork_test(TCase *tc, int i)
+{
+	pid_t pid;
+	int status;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		return 1;
+	}
+	if (pid == 0) {
+		status = ck_run_test(tc, i);
+		fflush(stdout);
+		_exit(status);
+	}
+	if (waitpid(pid, &status, 0) < 0) {
+		perror("waitpid");
+		return 1;
+	}
+	if (WIFSIGNALED(status)) {
+		printf("%s: killed by signal %d\n", tc->names[i], WTERMSIG(status));
+		return 1;
+	}
+	return WEXITSTATUS(status) != 0;
+}
+
+void srunner_run_all(SRunner *sr, enum print_output print_mode)
+{
+	Suite *s;
+	TCase *tc;
+	int failed;
+	int i;
+
+	(void)print_mode;
+	for (s = sr->suites; s != NULL; s = s->next) {
+		failed = 0;
+		for (tc = s->tcases; tc != NULL; tc = tc->next) {
+			for (i = 0; i < tc->ntests; i++) {
+				if (sr->fstat == CK_FORK) {
+					failed += ck_fork_test(tc, i);
+				} else {
+					failed += ck_run_test(tc, i);
+				}
+				sr->run++;
+			}
+		}
+		printf("%s: %s\n", s->name, failed ? "FAILED" : "passed");
+		sr->failed += failed;
+	}
+	printf("%d tests, %d failed\n", sr->run, sr->failed);
+}
+
+int srunner_ntests_failed(SRunner *sr)
+{
+	return sr->failed;
+}
+
+void srunner_free(SRunner *sr)
+{
+	Suite *s;
+	Suite *snext;
+	TCase *tc;
+	TCase *tcnext;
+
+	for (s = sr->suites; s != NULL; s = snext) {
+		snext = s->next;
+		for (tc = s->tcases; tc != NULL; tc = tcnext) {
+			tcnext = tc->next;
+			free(tc);
+		}
+		free(s);
+	}
+	free(sr);
+}
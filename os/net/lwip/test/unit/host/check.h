@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for <check.h>: the part of the check unit test framework
+ * that the lwIP suites use.  As with check, each test runs in a child
+ * process unless the runner is set to CK_NOFORK, and a failed assertion
+ * ends its test and is counted.
+ */
+
+#ifndef __LWIP_UNIT_HOST_CHECK_H
+#define __LWIP_UNIT_HOST_CHECK_H
+
+#define CK_MAX_TESTS    64
+
+enum print_output {
+	CK_NORMAL
+};
+
+enum fork_status {
+	CK_FORK,
+	CK_NOFORK
+};
+
+typedef void (*TFun)(int _i);
+typedef void (*SFun)(void);
+
+typedef struct TCase {
+	TFun tests[CK_MAX_TESTS];
+	const char *names[CK_MAX_TESTS];
+	int ntests;
+	SFun setup;
+	SFun teardown;
+	struct TCase *next;
+} TCase;
+
+typedef struct Suite {
+	const char *name;
+	TCase *tcases;
+	TCase **last;
+	struct Suite *next;
+} Suite;
+
+typedef struct SRunner {
+	Suite *suites;
+	Suite **last;
+	enum fork_status fstat;
+	int run;
+	int failed;
+} SRunner;
+
+#define START_TEST(name) static void name(int _i) {
+#define END_TEST }
+
+#define tcase_add_test(tc, tf) ck_tcase_add_test(tc, tf, #tf)
+
+#define fail_unless(expr, ...) \
+	((expr) ? (void)0 : ck_fail(__FILE__, __LINE__, "Assertion '" #expr "' failed"))
+#define fail_if(expr, ...) \
+	((expr) ? ck_fail(__FILE__, __LINE__, "Failure '" #expr "' occurred") : (void)0)
+#define fail(...) ck_fail(__FILE__, __LINE__, "Failed")
+
+void ck_fail(const char *file, int line, const char *msg);
+void ck_tcase_add_test(TCase *tc, TFun tf, const char *name);
+Suite *suite_create(const char *name);
+TCase *tcase_create(const char *name);
+void tcase_add_checked_fixture(TCase *tc, SFun setup, SFun teardown);
+void suite_add_tcase(Suite *s, TCase *tc);
+SRunner *srunner_create(Suite *s);
+void srunner_add_suite(SRunner *sr, Suite *s);
+void srunner_set_fork_status(SRunner *sr, enum fork_status fstat);
+void srunner_run_all(SRunner *sr, enum print_output print_mode);
+int srunner_ntests_failed(SRunner *sr);
+void srunner_free(SRunner *sr);
+
+#endif							/* __LWIP_UNIT_HOST_CHECK_H */
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host stand-in for the <config.h> of the lwIP unix port, which
+ * lwip_check.h includes. Nothing in it is needed by the unit tests.
+ */
+
+#ifndef __LWIP_UNIT_HOST_CONFIG_H
+#define __LWIP_UNIT_HOST_CONFIG_H
+
+#endif							/* __LWIP_UNIT_HOST_CONFIG_H */
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host replacement for the lwIP system layer used by the unit tests.
+ * The tests run with NO_SYS and drive the TCP timers themselves, so
+ * lwIP only needs a clock.  It stands still unless a test advances
+ * lwip_sys_now.
+ */
+
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+
+u32_t lwip_sys_now;
+
+u32_t sys_now(void)
+{
+	return lwip_sys_now;
+}
@@ -21,8 +21,11 @@
 #include "udp/test_udp.h"
 #include "tcp/test_tcp.h"
 #include "tcp/test_tcp_oos.h"
+#include "tcp/test_tcp_sack.h"
 #include "core/test_mem.h"
+#include "core/test_pcb_hash.h"
 #include "etharp/test_etharp.h"
+#include "sys/test_mbox.h"
 
 #include "lwip/init.h"
 
@@ -32,11 +35,18 @@ int main()
 	SRunner *sr;
 	size_t i;
 	suite_getter_fn *suites[] = {
+#if defined(LWIP_UNITTESTS_SACK)
+		tcp_sack_suite
+#elif defined(LWIP_UNITTESTS_PCB_HASH)
+		pcb_hash_suite
+#else
 		udp_suite,
 		tcp_suite,
 		tcp_oos_suite,
 		mem_suite,
-		etharp_suite
+		etharp_suite,
+		mbox_suite
+#endif
 	};
 	size_t num = sizeof(suites) / sizeof(void *);
 	LWIP_ASSERT("No suites defined", num > 0);
@@ -54,6 +54,10 @@
 #define NO_SYS                          1
 #define LWIP_NETCONN                    0
 #define LWIP_SOCKET                     0
+#define LWIP_DHCP                       0
+
+/* The tests check the MEM/MEMP/TCP statistics, which opt.h turns off: */
+#define LWIP_STATS                      1
 
 /* Minimal changes to opt.h required for tcp unit tests: */
 #define MEM_SIZE                        16000
@@ -62,6 +66,30 @@
 #define TCP_SND_BUF                     (12 * TCP_MSS)
 #define TCP_WND                         (10 * TCP_MSS)
 
+/* Minimal changes to opt.h required for pcb hash unit tests.  The hash
+   tables change how PCBs are found, so they are only enabled for a separate
+   build running the PCB_HASH suite alone: build with
+   -DLWIP_UNITTESTS_PCB_HASH (and with -DLWIP_PCB_HASH=0 to measure the
+   list lookup): */
+#ifdef LWIP_UNITTESTS_PCB_HASH
+#define MEMP_NUM_TCP_PCB                260
+#define MEMP_NUM_UDP_PCB                260
+#ifndef LWIP_PCB_HASH
+#define LWIP_PCB_HASH                   1
+#endif
+#endif
+
+/* Minimal changes to opt.h required for tcp sack unit tests.  SACK changes
+   what goes on the wire, so it is only enabled for a separate build running
+   the TCP_SACK suite alone: build with -DLWIP_UNITTESTS_SACK (and with
+   -DLWIP_TCP_RACK=0 to compare plain SACK recovery): */
+#ifdef LWIP_UNITTESTS_SACK
+#define LWIP_TCP_SACK                   1
+#ifndef LWIP_TCP_RACK
+#define LWIP_TCP_RACK                   1
+#endif
+#endif
+
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
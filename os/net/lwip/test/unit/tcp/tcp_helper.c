@@ -18,10 +18,12 @@
 
 #include "tcp_helper.h"
 
-#include "lwip/tcp_impl.h"
+#include <string.h>
+
+#include "lwip/priv/tcp_priv.h"
 #include "lwip/stats.h"
 #include "lwip/pbuf.h"
-#include "lwip/ipv4/inet_chksum.h"
+#include "lwip/inet_chksum.h"
 
 #if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
 #error "This tests needs TCP- and MEMP-statistics enabled"
@@ -46,10 +48,10 @@ void tcp_remove_all(void)
 	tcp_remove(tcp_listen_pcbs.pcbs);
 	tcp_remove(tcp_active_pcbs);
 	tcp_remove(tcp_tw_pcbs);
-	fail_unless(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
-	fail_unless(lwip_stats.memp[MEMP_TCP_PCB_LISTEN].used == 0);
-	fail_unless(lwip_stats.memp[MEMP_TCP_SEG].used == 0);
-	fail_unless(lwip_stats.memp[MEMP_PBUF_POOL].used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB_LISTEN]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_SEG]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_PBUF_POOL]->used == 0);
 }
 
 /** Create a TCP segment usable for passing to tcp_input */
@@ -79,20 +81,20 @@ static struct pbuf *tcp_create_segment_wnd(ip_addr_t *src_ip, ip_addr_t *dst_ip,
 	iphdr->src.addr = src_ip->addr;
 	IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
 	IPH_TOS_SET(iphdr, 0);
-	IPH_LEN_SET(iphdr, htons(p->tot_len));
+	IPH_LEN_SET(iphdr, lwip_htons(p->tot_len));
 	IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
 
 	/* let p point to TCP header */
 	pbuf_header(p, -(s16_t) sizeof(struct ip_hdr));
 
 	tcphdr = p->payload;
-	tcphdr->src = htons(src_port);
-	tcphdr->dest = htons(dst_port);
-	tcphdr->seqno = htonl(seqno);
-	tcphdr->ackno = htonl(ackno);
+	tcphdr->src = lwip_htons(src_port);
+	tcphdr->dest = lwip_htons(dst_port);
+	tcphdr->seqno = lwip_htonl(seqno);
+	tcphdr->ackno = lwip_htonl(ackno);
 	TCPH_HDRLEN_SET(tcphdr, sizeof(struct tcp_hdr) / 4);
 	TCPH_FLAGS_SET(tcphdr, headerflags);
-	tcphdr->wnd = htons(wnd);
+	tcphdr->wnd = lwip_htons(wnd);
 
 	if (data_len > 0) {
 		/* let p point to TCP data */
@@ -105,7 +107,7 @@ static struct pbuf *tcp_create_segment_wnd(ip_addr_t *src_ip, ip_addr_t *dst_ip,
 
 	/* calculate checksum */
 
-	tcphdr->chksum = inet_chksum_pseudo(p, src_ip, dst_ip, IP_PROTO_TCP, p->tot_len);
+	tcphdr->chksum = inet_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len, src_ip, dst_ip);
 
 	pbuf_header(p, sizeof(struct ip_hdr));
 
@@ -140,19 +142,31 @@ struct pbuf *tcp_create_rx_segment_wnd(struct tcp_pcb *pcb, void *data, size_t d
 /** Safely bring a tcp_pcb into the requested state */
 void tcp_set_state(struct tcp_pcb *pcb, enum tcp_state state, ip_addr_t *local_ip, ip_addr_t *remote_ip, u16_t local_port, u16_t remote_port)
 {
+	u32_t iss;
+
 	/* @todo: are these all states? */
 	/* @todo: remove from previous list */
 	pcb->state = state;
+
+	/* the iss is picked on connect, which these pcbs skip */
+	iss = tcp_next_iss(pcb);
+	pcb->snd_wl2 = iss;
+	pcb->snd_nxt = iss;
+	pcb->lastack = iss;
+	pcb->snd_lbb = iss;
+
 	if (state == ESTABLISHED) {
-		TCP_REG(&tcp_active_pcbs, pcb);
+		/* the 4-tuple must be set before the pcb is hashed */
 		pcb->local_ip.addr = local_ip->addr;
 		pcb->local_port = local_port;
 		pcb->remote_ip.addr = remote_ip->addr;
 		pcb->remote_port = remote_port;
+		TCP_REG_ACTIVE(pcb);
 	} else if (state == LISTEN) {
-		TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
 		pcb->local_ip.addr = local_ip->addr;
 		pcb->local_port = local_port;
+		TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
+		TCP_HASH_REG(pcb);
 	} else if (state == TIME_WAIT) {
 		TCP_REG(&tcp_tw_pcbs, pcb);
 		pcb->local_ip.addr = local_ip->addr;
@@ -231,24 +245,25 @@ struct tcp_pcb *test_tcp_new_counters_pcb(struct test_tcp_counters *counters)
 	return pcb;
 }
 
-/** Calls tcp_input() after adjusting current_iphdr_dest */
+/** Calls tcp_input() after setting up ip_data for the datagram */
 void test_tcp_input(struct pbuf *p, struct netif *inp)
 {
 	struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
-	ip_addr_copy(current_iphdr_dest, iphdr->dest);
-	ip_addr_copy(current_iphdr_src, iphdr->src);
-	current_netif = inp;
-	current_header = iphdr;
+	ip_addr_copy_from_ip4(ip_data.current_iphdr_dest, iphdr->dest);
+	ip_addr_copy_from_ip4(ip_data.current_iphdr_src, iphdr->src);
+	ip_data.current_netif = inp;
+	ip_data.current_input_netif = inp;
+	ip_data.current_ip4_header = iphdr;
+	ip_data.current_ip_header_tot_len = IPH_HL(iphdr) * 4;
 
+	/* tcp_input() expects p->payload to point to the tcp header */
+	pbuf_header(p, -(s16_t)(IPH_HL(iphdr) * 4));
 	tcp_input(p, inp);
 
-	current_iphdr_dest.addr = 0;
-	current_iphdr_src.addr = 0;
-	current_netif = NULL;
-	current_header = NULL;
+	memset(&ip_data, 0, sizeof(ip_data));
 }
 
-static err_t test_tcp_netif_output(struct netif *netif, struct pbuf *p, ip_addr_t *ipaddr)
+static err_t test_tcp_netif_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
 {
 	struct test_tcp_txcounters *txcounters = (struct test_tcp_txcounters *)
 			netif->state;
@@ -277,7 +292,7 @@ void test_tcp_init_netif(struct netif *netif, struct test_tcp_txcounters *txcoun
 	memset(txcounters, 0, sizeof(struct test_tcp_txcounters));
 	netif->output = test_tcp_netif_output;
 	netif->state = txcounters;
-	netif->flags |= NETIF_FLAG_UP;
+	netif->flags |= NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
 	ip_addr_copy(netif->netmask, *netmask);
 	ip_addr_copy(netif->ip_addr, *ip_addr);
 	for (n = netif_list; n != NULL; n = n->next) {
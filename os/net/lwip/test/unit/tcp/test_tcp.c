@@ -18,7 +18,9 @@
 
 #include "test_tcp.h"
 
-#include "lwip/tcp_impl.h"
+#include <string.h>
+
+#include "lwip/priv/tcp_priv.h"
 #include "lwip/stats.h"
 #include "tcp_helper.h"
 
@@ -50,8 +52,8 @@ static void tcp_setup(void)
 {
 	/* reset iss to default (6510) */
 	tcp_ticks = 0;
-	tcp_ticks = 0 - (tcp_next_iss() - 6510);
-	tcp_next_iss();
+	tcp_ticks = 0 - (tcp_next_iss(NULL) - 6510);
+	tcp_next_iss(NULL);
 	tcp_ticks = 0;
 
 	test_tcp_timer = 0;
@@ -72,14 +74,14 @@ START_TEST(test_tcp_new_abort)
 	struct tcp_pcb *pcb;
 	LWIP_UNUSED_ARG(_i);
 
-	fail_unless(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 
 	pcb = tcp_new();
 	fail_unless(pcb != NULL);
 	if (pcb != NULL) {
-		fail_unless(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+		fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 		tcp_abort(pcb);
-		fail_unless(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+		fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 	}
 }
 
@@ -126,9 +128,9 @@ START_TEST(test_tcp_recv_inseq)
 	}
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 END_TEST
@@ -146,7 +148,7 @@ START_TEST(test_tcp_fast_retx_recover)
 	char data3[] = { 9, 10, 11, 12 };
 	char data4[] = { 13, 14, 15, 16 };
 	char data5[] = { 17, 18, 19, 20 };
-	char data6[] = { 21, 22, 23, 24 };
+	char data6[TCP_MSS] = { 21, 22, 23, 24 };
 	ip_addr_t remote_ip, local_ip, netmask;
 	u16_t remote_port = 0x100, local_port = 0x101;
 	err_t err;
@@ -297,9 +299,9 @@ START_TEST(test_tcp_fast_retx_recover)
 	}
 #endif
 	/* make sure the pcb is freed */
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 END_TEST static u8_t tx_data[TCP_WND * 2];
@@ -310,7 +312,7 @@ static void check_seqnos(struct tcp_seg *segs, int num_expected, u32_t *seqnos_e
 	int i;
 	for (i = 0; i < num_expected; i++, s = s->next) {
 		EXPECT_RET(s != NULL);
-		EXPECT(s->tcphdr->seqno == htonl(seqnos_expected[i]));
+		EXPECT(s->tcphdr->seqno == lwip_htonl(seqnos_expected[i]));
 	}
 	EXPECT(s == NULL);
 }
@@ -356,11 +358,13 @@ START_TEST(test_tcp_fast_rexmit_wraparound)
 	tcp_ticks = SEQNO1 - ISS;
 	pcb = test_tcp_new_counters_pcb(&counters);
 	EXPECT_RET(pcb != NULL);
-	EXPECT(pcb->lastack == SEQNO1);
 	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	EXPECT(pcb->lastack == SEQNO1);
 	pcb->mss = TCP_MSS;
 	/* disable initial congestion window (we don't send a SYN here...) */
 	pcb->cwnd = 2 * TCP_MSS;
+	/* start in congestion avoidance, ssthresh is TCP_SND_BUF since lwIP 2.0 */
+	pcb->ssthresh = pcb->cwnd;
 
 	/* send 6 mss-sized segments */
 	for (i = 0; i < 6; i++) {
@@ -408,9 +412,9 @@ START_TEST(test_tcp_fast_rexmit_wraparound)
 	check_seqnos(pcb->unacked, 5, &seqnos[1]);
 
 	/* make sure the pcb is freed */
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 END_TEST
@@ -452,12 +456,12 @@ START_TEST(test_tcp_rto_rexmit_wraparound)
 
 	/* create and initialize the pcb */
 	tcp_ticks = 0;
-	tcp_ticks = 0 - tcp_next_iss();
-	tcp_ticks = SEQNO1 - tcp_next_iss();
+	tcp_ticks = 0 - tcp_next_iss(NULL);
+	tcp_ticks = SEQNO1 - tcp_next_iss(NULL);
 	pcb = test_tcp_new_counters_pcb(&counters);
 	EXPECT_RET(pcb != NULL);
-	EXPECT(pcb->lastack == SEQNO1);
 	tcp_set_state(pcb, ESTABLISHED, &local_ip, &remote_ip, local_port, remote_port);
+	EXPECT(pcb->lastack == SEQNO1);
 	pcb->mss = TCP_MSS;
 	/* disable initial congestion window (we don't send a SYN here...) */
 	pcb->cwnd = 2 * TCP_MSS;
@@ -499,9 +503,9 @@ START_TEST(test_tcp_rto_rexmit_wraparound)
 	check_seqnos(pcb->unacked, 6, seqnos);
 
 	/* make sure the pcb is freed */
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 END_TEST
@@ -644,9 +648,9 @@ static void test_tcp_tx_full_window_lost(u8_t zero_window_probe_from_unsent)
 	}
 
 	/* make sure the pcb is freed */
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT_RET(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 START_TEST(test_tcp_tx_full_window_lost_from_unsent)
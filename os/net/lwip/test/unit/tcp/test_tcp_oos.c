@@ -18,7 +18,9 @@
 
 #include "test_tcp_oos.h"
 
-#include "lwip/tcp_impl.h"
+#include <string.h>
+
+#include "lwip/priv/tcp_priv.h"
 #include "lwip/stats.h"
 #include "tcp_helper.h"
 
@@ -278,9 +280,9 @@ START_TEST(test_tcp_recv_ooseq_FIN_OOSEQ)
 	}
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 END_TEST
@@ -452,12 +454,12 @@ START_TEST(test_tcp_recv_ooseq_FIN_INSEQ)
 	}
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
-END_TEST static char data_full_wnd[TCP_WND];
+END_TEST static char data_full_wnd[TCP_WND + TCP_MSS];
 
 /** create multiple segments and pass them to tcp_input with the first segment missing
  * to simulate overruning the rxwin with ooseq queueing enabled */
@@ -543,9 +545,9 @@ START_TEST(test_tcp_recv_ooseq_overrun_rxwin)
 	EXPECT(pcb->ooseq == NULL);
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 #endif							/* !TCP_OOSEQ_MAX_BYTES && !TCP_OOSEQ_MAX_PBUFS */
 	LWIP_UNUSED_ARG(_i);
 }
@@ -621,9 +623,9 @@ END_TEST START_TEST(test_tcp_recv_ooseq_max_bytes)
 	EXPECT_OOSEQ(datalen2 == ((i - 1) * TCP_MSS));
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 #endif							/* TCP_OOSEQ_MAX_BYTES && (TCP_OOSEQ_MAX_BYTES < (TCP_WND + 1)) && (PBUF_POOL_BUFSIZE >= (TCP_MSS + PBUF_LINK_HLEN + PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN)) */
 	LWIP_UNUSED_ARG(_i);
 }
@@ -699,9 +701,9 @@ END_TEST START_TEST(test_tcp_recv_ooseq_max_pbufs)
 	EXPECT_OOSEQ(datalen2 == (i - 1));
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 #endif							/* TCP_OOSEQ_MAX_PBUFS && (TCP_OOSEQ_MAX_BYTES < (TCP_WND + 1)) && (PBUF_POOL_BUFSIZE >= (TCP_MSS + PBUF_LINK_HLEN + PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN)) */
 	LWIP_UNUSED_ARG(_i);
 }
@@ -887,9 +889,9 @@ static void test_tcp_recv_ooseq_double_FINs(int delay_packet)
 	EXPECT(pcb->ooseq == NULL);
 
 	/* make sure the pcb is freed */
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 1);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 1);
 	tcp_abort(pcb);
-	EXPECT(lwip_stats.memp[MEMP_TCP_PCB].used == 0);
+	EXPECT(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
 }
 
 /** create multiple segments and pass them to tcp_input with the first segment missing
@@ -0,0 +1,474 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include "test_tcp_sack.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+#include "lwip/tcp.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/priv/tcp_priv.h"
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+#if LWIP_TCP_SACK				/* only built with LWIP_UNITTESTS_SACK */
+
+#if !TCP_QUEUE_OOSEQ
+#error "This tests needs TCP_QUEUE_OOSEQ enabled"
+#endif
+
+#define SACK_TEST_PORT        5001
+#define SACK_TEST_BYTES       (128 * 1024)	/* bytes sent per transfer */
+#define SACK_TEST_DELAY       25		/* one-way delay of the link in ms */
+#define SACK_TEST_TMR_PASSES  (TCP_TMR_INTERVAL / SACK_TEST_DELAY)
+#define SACK_TEST_MAX_PASSES  200000
+#define SACK_TEST_QLEN        64		/* packets in flight on the link */
+#define SACK_TEST_PKTLEN      (TCP_MSS + 100)
+
+/* The lossy link: g_netif sends every packet back to itself.  A packet is
+ * delivered to ip_input() one pass (SACK_TEST_DELAY ms) after it was sent,
+ * unless the link drops it.
+ */
+struct sack_test_link {
+	u32_t drop_permille;		/* random loss rate, both directions */
+	u32_t drop_nth;				/* only drop the nth data segment (1-based) */
+	u32_t rnd;					/* xorshift32 state */
+	u16_t head;
+	u16_t count;
+	u16_t len[SACK_TEST_QLEN];
+	u8_t data[SACK_TEST_QLEN][SACK_TEST_PKTLEN];
+
+	/* Data direction, from the client to the server */
+	u16_t data_port;			/* client port */
+	u32_t data_segs;
+	u32_t data_bytes;			/* payload sent, retransmissions included */
+	u32_t retx_bytes;			/* payload sent below the highest seqno sent */
+	u32_t dropped_bytes;		/* payload dropped */
+	u32_t high_seq;
+	/* ACK direction */
+	u32_t sack_acks;			/* ACKs carrying a SACK option */
+	u32_t overflow;				/* packets lost because the link was full */
+};
+
+struct sack_test_conn {
+	struct tcp_pcb *client;
+	struct tcp_pcb *server;
+	u32_t sent;
+	u32_t received;
+	u8_t connected;
+	u8_t corrupt;
+};
+
+/* The clock of the unit test harness, in ms */
+extern u32_t lwip_sys_now;
+
+static struct netif g_netif;
+static ip_addr_t g_local;
+static struct sack_test_link g_link;
+static u8_t g_timer;
+
+/* Helper functions */
+
+static u8_t sack_test_byte(u32_t off)
+{
+	return (u8_t)(off % 251);
+}
+
+static u32_t sack_test_random(void)
+{
+	u32_t x = g_link.rnd;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	g_link.rnd = x;
+	return x;
+}
+
+/* Return 1 if the TCP options of 'tcphdr' hold a SACK option */
+static int sack_test_has_sack(const struct tcp_hdr *tcphdr)
+{
+	const u8_t *opt = (const u8_t *)(tcphdr + 1);
+	u16_t optlen = TCPH_HDRLEN(tcphdr) * 4 - TCP_HLEN;
+	u16_t i = 0;
+
+	while (i < optlen) {
+		if (opt[i] == LWIP_TCP_OPT_EOL) {
+			break;
+		}
+		if (opt[i] == LWIP_TCP_OPT_NOP) {
+			i++;
+			continue;
+		}
+		if (opt[i] == LWIP_TCP_OPT_SACK) {
+			return 1;
+		}
+		if (i + 1 >= optlen || opt[i + 1] < 2) {
+			break;
+		}
+		i += opt[i + 1];
+	}
+	return 0;
+}
+
+static err_t sack_test_netif_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+	struct ip_hdr *iphdr;
+	struct tcp_hdr *tcphdr;
+	u16_t slot;
+	u16_t hlen;
+	u16_t payload;
+	u32_t seq;
+	int drop = 0;
+
+	LWIP_UNUSED_ARG(netif);
+	LWIP_UNUSED_ARG(ipaddr);
+
+	if (g_link.count == SACK_TEST_QLEN || p->tot_len > SACK_TEST_PKTLEN) {
+		g_link.overflow++;
+		return ERR_OK;
+	}
+	slot = (g_link.head + g_link.count) % SACK_TEST_QLEN;
+	g_link.len[slot] = pbuf_copy_partial(p, g_link.data[slot], p->tot_len, 0);
+
+	iphdr = (struct ip_hdr *)g_link.data[slot];
+	hlen = IPH_HL(iphdr) * 4;
+	tcphdr = (struct tcp_hdr *)(g_link.data[slot] + hlen);
+	hlen += TCPH_HDRLEN(tcphdr) * 4;
+	payload = g_link.len[slot] - hlen;
+
+	if (g_link.data_port != 0 && lwip_ntohs(tcphdr->src) == g_link.data_port) {
+		if (payload > 0) {
+			seq = lwip_ntohl(tcphdr->seqno);
+			g_link.data_segs++;
+			g_link.data_bytes += payload;
+			if (TCP_SEQ_LT(seq, g_link.high_seq)) {
+				g_link.retx_bytes += payload;
+			} else {
+				g_link.high_seq = seq + payload;
+			}
+			if (g_link.data_segs == g_link.drop_nth) {
+				drop = 1;
+			}
+		}
+	} else if (g_link.data_port != 0 && sack_test_has_sack(tcphdr)) {
+		g_link.sack_acks++;
+	}
+
+	if (g_link.drop_permille != 0 && (sack_test_random() % 1000) < g_link.drop_permille) {
+		drop = 1;
+	}
+	if (drop) {
+		if (g_link.data_port != 0 && lwip_ntohs(tcphdr->src) == g_link.data_port) {
+			g_link.dropped_bytes += payload;
+		}
+		return ERR_OK;
+	}
+
+	g_link.count++;
+	return ERR_OK;
+}
+
+static err_t sack_test_netif_init(struct netif *netif)
+{
+	netif->output = sack_test_netif_output;
+	netif->mtu = 1500;
+	netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_LINK_UP;
+	return ERR_OK;
+}
+
+/* Deliver the packets that were on the link when the pass began */
+static void sack_test_deliver(void)
+{
+	struct pbuf *p;
+	u16_t n = g_link.count;
+
+	while (n-- > 0) {
+		p = pbuf_alloc(PBUF_RAW, g_link.len[g_link.head], PBUF_POOL);
+		EXPECT_RET(p != NULL);
+		pbuf_take(p, g_link.data[g_link.head], g_link.len[g_link.head]);
+		g_link.head = (g_link.head + 1) % SACK_TEST_QLEN;
+		g_link.count--;
+		ip_input(p, &g_netif);
+	}
+}
+
+/* our own version of tcp_tmr so we can reset fast/slow timer state */
+static void sack_test_tmr(void)
+{
+	tcp_fasttmr();
+	if (++g_timer & 1) {
+		tcp_slowtmr();
+	}
+}
+
+static void sack_test_fill(struct sack_test_conn *conn)
+{
+	u8_t buf[TCP_MSS];
+	u32_t len;
+	u32_t i;
+
+	while (conn->client != NULL && conn->sent < SACK_TEST_BYTES) {
+		len = LWIP_MIN(tcp_sndbuf(conn->client), sizeof(buf));
+		len = LWIP_MIN(len, SACK_TEST_BYTES - conn->sent);
+		if (len == 0) {
+			break;
+		}
+		for (i = 0; i < len; i++) {
+			buf[i] = sack_test_byte(conn->sent + i);
+		}
+		if (tcp_write(conn->client, buf, (u16_t)len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+			break;
+		}
+		conn->sent += len;
+	}
+	if (conn->client != NULL) {
+		tcp_output(conn->client);
+	}
+}
+
+static err_t sack_test_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+	struct sack_test_conn *conn = (struct sack_test_conn *)arg;
+	struct pbuf *q;
+	u16_t i;
+
+	LWIP_UNUSED_ARG(err);
+	if (p == NULL) {
+		return ERR_OK;
+	}
+	for (q = p; q != NULL; q = q->next) {
+		for (i = 0; i < q->len; i++) {
+			if (((u8_t *)q->payload)[i] != sack_test_byte(conn->received + i)) {
+				conn->corrupt = 1;
+			}
+		}
+		conn->received += q->len;
+	}
+	tcp_recved(pcb, p->tot_len);
+	pbuf_free(p);
+	return ERR_OK;
+}
+
+static err_t sack_test_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(len);
+	sack_test_fill((struct sack_test_conn *)arg);
+	return ERR_OK;
+}
+
+static void sack_test_client_err(void *arg, err_t err)
+{
+	LWIP_UNUSED_ARG(err);
+	((struct sack_test_conn *)arg)->client = NULL;
+}
+
+static void sack_test_server_err(void *arg, err_t err)
+{
+	LWIP_UNUSED_ARG(err);
+	((struct sack_test_conn *)arg)->server = NULL;
+}
+
+static err_t sack_test_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+	LWIP_UNUSED_ARG(pcb);
+	LWIP_UNUSED_ARG(err);
+	((struct sack_test_conn *)arg)->connected = 1;
+	return ERR_OK;
+}
+
+static err_t sack_test_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+	struct sack_test_conn *conn = (struct sack_test_conn *)arg;
+
+	LWIP_UNUSED_ARG(err);
+	conn->server = newpcb;
+	tcp_arg(newpcb, conn);
+	tcp_recv(newpcb, sack_test_recv);
+	tcp_err(newpcb, sack_test_server_err);
+	return ERR_OK;
+}
+
+/* Connect over a clean link, then send SACK_TEST_BYTES from the client to
+ * the server over a link dropping 'drop_permille' of all packets (or only
+ * the 'drop_nth' data segment).  With 'sack' == 0 the SACK flag is cleared
+ * on both ends after the handshake, which gives the cumulative-ACK baseline.
+ *
+ * @return the number of passes (of SACK_TEST_DELAY ms) the transfer took
+ */
+static u32_t sack_test_transfer(struct sack_test_conn *conn, u32_t drop_permille, u32_t drop_nth, int sack)
+{
+	struct tcp_pcb *lpcb;
+	u32_t pass;
+	err_t err;
+
+	memset(conn, 0, sizeof(*conn));
+	memset(&g_link, 0, sizeof(g_link));
+	g_link.rnd = 0x2545f491;
+
+	lpcb = tcp_new();
+	EXPECT_RETX(lpcb != NULL, 0);
+	err = tcp_bind(lpcb, &g_local, SACK_TEST_PORT);
+	EXPECT_RETX(err == ERR_OK, 0);
+	lpcb = tcp_listen(lpcb);
+	EXPECT_RETX(lpcb != NULL, 0);
+	tcp_arg(lpcb, conn);
+	tcp_accept(lpcb, sack_test_accept);
+
+	conn->client = tcp_new();
+	EXPECT_RETX(conn->client != NULL, 0);
+	tcp_arg(conn->client, conn);
+	tcp_err(conn->client, sack_test_client_err);
+	tcp_sent(conn->client, sack_test_sent);
+	err = tcp_connect(conn->client, &g_local, SACK_TEST_PORT, sack_test_connected);
+	EXPECT_RETX(err == ERR_OK, 0);
+
+	for (pass = 0; pass < 4 && !(conn->connected && conn->server != NULL); pass++) {
+		lwip_sys_now += SACK_TEST_DELAY;
+		sack_test_deliver();
+	}
+	tcp_close(lpcb);
+	EXPECT_RETX(conn->connected && conn->server != NULL, 0);
+	/* both ends offered SACK-permitted */
+	EXPECT_RETX((conn->client->flags & TF_SACK) && (conn->server->flags & TF_SACK), 0);
+	if (!sack) {
+		conn->client->flags &= ~TF_SACK;
+		conn->server->flags &= ~TF_SACK;
+	}
+
+	g_link.data_port = conn->client->local_port;
+	g_link.high_seq = conn->client->snd_nxt;
+	g_link.drop_permille = drop_permille;
+	g_link.drop_nth = drop_nth;
+
+	sack_test_fill(conn);
+	for (pass = 0; pass < SACK_TEST_MAX_PASSES && conn->client != NULL && conn->received < SACK_TEST_BYTES; pass++) {
+		lwip_sys_now += SACK_TEST_DELAY;
+		sack_test_deliver();
+		if ((pass % SACK_TEST_TMR_PASSES) == SACK_TEST_TMR_PASSES - 1) {
+			sack_test_tmr();
+		}
+	}
+
+	EXPECT(conn->received == SACK_TEST_BYTES);
+	EXPECT(!conn->corrupt);
+	return pass;
+}
+
+static void sack_test_close(struct sack_test_conn *conn)
+{
+	if (conn->client != NULL) {
+		tcp_abort(conn->client);
+	}
+	if (conn->server != NULL) {
+		tcp_abort(conn->server);
+	}
+	memset(&g_link, 0, sizeof(g_link));
+}
+
+/* Setups/teardown functions */
+
+static void sack_test_setup(void)
+{
+	ip4_addr_t netmask;
+	ip4_addr_t gw;
+
+	IP_ADDR4(&g_local, 192, 168, 0, 1);
+	IP4_ADDR(&netmask, 255, 255, 255, 0);
+	IP4_ADDR(&gw, 192, 168, 0, 254);
+
+	netif_add(&g_netif, ip_2_ip4(&g_local), &netmask, &gw, NULL, sack_test_netif_init, NULL);
+	netif_set_default(&g_netif);
+	netif_set_up(&g_netif);
+
+	g_timer = 0;
+	memset(&g_link, 0, sizeof(g_link));
+}
+
+static void sack_test_teardown(void)
+{
+	netif_remove(&g_netif);
+	fail_unless(lwip_stats.memp[MEMP_TCP_PCB]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_TCP_SEG]->used == 0);
+	fail_unless(lwip_stats.memp[MEMP_PBUF_POOL]->used == 0);
+}
+
+/* Test functions */
+
+/** One lost segment: the receiver reports the data behind the hole and only
+ * the hole is resent */
+START_TEST(test_tcp_sack_single_loss)
+{
+	struct sack_test_conn conn;
+	LWIP_UNUSED_ARG(_i);
+
+	sack_test_transfer(&conn, 0, 5, 1);
+
+	EXPECT(g_link.dropped_bytes == TCP_MSS);
+	EXPECT(g_link.sack_acks > 0);
+	EXPECT(g_link.retx_bytes == g_link.dropped_bytes);
+
+	sack_test_close(&conn);
+}
+
+END_TEST
+/** Goodput with and without SACK at increasing loss rates */
+START_TEST(test_tcp_sack_goodput)
+{
+	static const u32_t loss[] = { 0, 10, 20, 50 };
+	struct sack_test_conn conn;
+	u32_t passes;
+	size_t i;
+	int sack;
+	LWIP_UNUSED_ARG(_i);
+
+	for (i = 0; i < sizeof(loss) / sizeof(loss[0]); i++) {
+		for (sack = 1; sack >= 0; sack--) {
+			passes = sack_test_transfer(&conn, loss[i], 0, sack);
+			if (loss[i] == 0) {
+				EXPECT(g_link.retx_bytes == 0);
+			}
+			printf("tcp_sack: loss %2u.%u%%, SACK %s (RACK %d): %5u kbit/s goodput, %3u%% resent\n",
+				   (unsigned)(loss[i] / 10), (unsigned)(loss[i] % 10), sack ? "on " : "off", LWIP_TCP_RACK,
+				   (unsigned)(passes ? conn.received * 8 / (passes * SACK_TEST_DELAY) : 0),
+				   (unsigned)(g_link.retx_bytes * 100 / SACK_TEST_BYTES));
+			sack_test_close(&conn);
+		}
+	}
+}
+
+END_TEST
+/** Create the suite including all tests for this module */
+Suite *tcp_sack_suite(void)
+{
+	TFun tests[] = {
+		test_tcp_sack_single_loss,
+		test_tcp_sack_goodput
+	};
+	return create_suite("TCP_SACK", tests, sizeof(tests) / sizeof(TFun), sack_test_setup, sack_test_teardown);
+}
+
+#endif							/* LWIP_TCP_SACK */
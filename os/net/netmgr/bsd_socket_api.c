@@ -26,6 +26,9 @@
 
 #ifdef CONFIG_NET
 #include <tinyara/cancelpt.h>
+#include <tinyara/clock.h>
+#include <errno.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <netinet/in.h>
@@ -179,6 +182,133 @@ ssize_t sendmsg(int sockfd, struct msghdr *msg, int flags)
 	NETSTACK_CALL_BYFD(sockfd, sendmsg, (sockfd, msg, flags));
 }
 
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *	 Receive up to vlen messages with one call.  The first message is
+ *	 waited for as in recvmsg(); after it, only messages that are already
+ *	 queued are returned (as with MSG_WAITFORONE).
+ *
+ * Parameters:
+ *	 sockfd	  Socket descriptor of socket
+ *	 msgvec	  Array of messages; msg_len receives the length of each
+ *	 vlen	  Number of entries in msgvec
+ *	 flags	  Receive flags
+ *	 timeout  If not NULL, the longest time to wait for the first message
+ *
+ * Returned Value:
+ *	 The number of messages received, or -1 with errno set.
+ *
+ ****************************************************************************/
+int recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags, struct timespec *timeout)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+
+	if (timeout != NULL) {
+		struct pollfd pfd;
+		int msec = timeout->tv_sec * MSEC_PER_SEC + timeout->tv_nsec / NSEC_PER_MSEC;
+
+		pfd.fd = sockfd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		res = poll(&pfd, 1, msec);
+		if (res <= 0) {
+			if (res == 0) {
+				set_errno(EAGAIN);
+			}
+			leave_cancellation_point();
+			return -1;
+		}
+		flags |= MSG_DONTWAIT;
+		res = -1;
+	}
+
+	NETSTACK_CALL_BYFD_RET(sockfd, recvmmsg, (sockfd, msgvec, vlen, flags), res);
+	leave_cancellation_point();
+	return res;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *	 Send up to vlen messages with one call.  Datagrams are handed to the
+ *	 network stack in batches instead of one by one.
+ *
+ * Parameters:
+ *	 sockfd	  Socket descriptor of socket
+ *	 msgvec	  Array of messages; msg_len receives the bytes sent for each
+ *	 vlen	  Number of entries in msgvec
+ *	 flags	  Send flags
+ *
+ * Returned Value:
+ *	 The number of messages sent, or -1 with errno set if none was sent.
+ *
+ ****************************************************************************/
+int sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, sendmmsg, (sockfd, msgvec, vlen, flags), res);
+	leave_cancellation_point();
+	return res;
+}
+
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+/****************************************************************************
+ * Function: recvmsg_zc
+ *
+ * Description:
+ *	 Receive a message by borrowing the network buffers instead of copying
+ *	 them. See sys/socket.h.
+ *
+ ****************************************************************************/
+ssize_t recvmsg_zc(int sockfd, struct msghdr *msg, int flags, void **zcbuf)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, recvmsg_zc, (sockfd, msg, flags, zcbuf), res);
+	leave_cancellation_point();
+	return res;
+}
+
+/****************************************************************************
+ * Function: recvmsg_zc_release
+ *
+ * Description:
+ *	 Give back the network buffers lent by recvmsg_zc().
+ *
+ ****************************************************************************/
+int recvmsg_zc_release(void *zcbuf)
+{
+	struct netstack *stk = get_netstack(TR_SOCKET);
+	NETSTACK_CALL(stk, zc_release, (zcbuf));
+}
+
+/****************************************************************************
+ * Function: sendmsg_zc
+ *
+ * Description:
+ *	 Send a message from caller-owned buffers without copying them; done is
+ *	 called when the stack no longer references them. See sys/socket.h.
+ *
+ ****************************************************************************/
+ssize_t sendmsg_zc(int sockfd, const struct msghdr *msg, int flags, sendmsg_zc_done_t done, void *arg)
+{
+	/* Treat as a cancellation point */
+	(void)enter_cancellation_point();
+	int res = -1;
+	NETSTACK_CALL_BYFD_RET(sockfd, sendmsg_zc, (sockfd, msg, flags, done, arg), res);
+	leave_cancellation_point();
+	return res;
+}
+#endif
+
 int socket(int domain, int type, int protocol)
 {
 	struct netstack *stk = NULL;
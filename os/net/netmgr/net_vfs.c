@@ -114,19 +114,22 @@ int net_close(int sd)
  * Function: net_poll
  *
  * Description:
- *   poll() waits for one of a set of file descriptors to become ready to
- *   perform I/O.
+ *   Set up or tear down the poll operation on a socket descriptor by
+ *   handing it to the network stack that owns the socket.
  *
-  * Returned Value:
- *   0 on success; -1 on error with errno set appropriately.
+ * Returned Value:
+ *   0 on success; a negated errno value on failure.  -ENOSYS is returned
+ *   if the stack owning the socket does not support poll.
  *
  * Assumptions:
  *
  ****************************************************************************/
 int net_poll(int fd, struct pollfd *fds, bool setup)
 {
-	// ToDo
-	return -1;
+	int ret = -ENOSYS;
+
+	NETSTACK_CALL_BYFD_RET(fd, poll, (fd, fds, setup), ret);
+	return ret;
 }
 
 /****************************************************************************
@@ -221,6 +224,40 @@ errout:
 	return ERROR;
 }
 
+/****************************************************************************
+ * Name: net_sendfile
+ *
+ * Description:
+ *   Transfer data from an open file to a socket inside the network stack
+ *   that owns the socket.
+ *
+ * Parameters:
+ *   outfd    Socket descriptor to send on
+ *   infile   The open file to read from
+ *   offset   Optional file offset to start from (see sendfile())
+ *   count    The number of bytes to transfer
+ *
+ * Return:
+ *   The number of bytes sent on success.  On a failure, -1 is returned
+ *   with errno set appropriately.  ENOSYS is returned when the stack has no
+ *   sendfile support so that the caller can fall back to a copy loop.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE
+ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset, size_t count)
+{
+	struct netstack *stk = get_netstack_byfd(outfd);
+
+	if (stk == NULL || stk->ops->sendfile == NULL) {
+		errno = ENOSYS;
+		return ERROR;
+	}
+
+	return stk->ops->sendfile(outfd, infile, offset, count);
+}
+#endif
+
 
 /****************************************************************************
  * Name: net_vfcntl
@@ -650,6 +650,7 @@ static int lwip_input(struct netdev *dev, uint8_t *frame_ptr, uint16_t len)
 		if (netif->input(p, netif) != ERR_OK) {
 			LWIP_DEBUGF(NETIF_DEBUG, ("input processing error\n"));
 			LINK_STATS_INC(link.err);
+			NETIF_DROP_INC(netif, RX_QFULL);
 			pbuf_free(p);
 			/* Don't reference the packet any more! */
 			p = NULL;
@@ -660,6 +661,7 @@ static int lwip_input(struct netdev *dev, uint8_t *frame_ptr, uint16_t len)
 		LWIP_DEBUGF(NETIF_DEBUG, ("mem error\n"));
 		LINK_STATS_INC(link.memerr);
 		LINK_STATS_INC(link.drop);
+		NETIF_DROP_INC(netif, RX_NOMEM);
 		return -1;
 	}
 	return 0;
@@ -681,6 +683,9 @@ static int lwip_get_stats(struct netdev *dev, struct netmon_netdev_stats *stats)
 		ni->mib2_counters.ifouterrors;
 
 	stats->devoutoctets = ni->mib2_counters.ifoutoctets;
+#ifdef CONFIG_NET_STATS_PERF
+	memcpy(stats->devdrops, ni->drops, sizeof(stats->devdrops));
+#endif
 
 	return 0;
 }
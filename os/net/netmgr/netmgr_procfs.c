@@ -0,0 +1,390 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <net/if.h>
+#include <arpa/inet.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/netmgr/netdev_mgr.h>
+
+#include "netstack.h"
+#include "netdev_mgr_internal.h"
+
+#if defined(CONFIG_NET_STATS_PERF) && defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Upper bound of one formatted line of each report */
+
+#define NET_PROCFS_DEVLINE  160
+#define NET_PROCFS_SOCKLINE 160
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum net_procfs_node_e {
+	NET_PROCFS_DEV,				/* /proc/net/dev */
+	NET_PROCFS_SOCK,			/* /proc/net/sock */
+};
+
+/* This structure describes one open "file" */
+
+struct net_procfs_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	enum net_procfs_node_e node;	/* Which report this file shows */
+	size_t bufsize;				/* Size of buf[] */
+	size_t buflen;				/* Number of valid characters in buf[] */
+	FAR char *buf;				/* The report sampled on the first read */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int net_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int net_procfs_close(FAR struct file *filep);
+static ssize_t net_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+static int net_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+static int net_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations net_procfsoperations = {
+	net_procfs_open,			/* open */
+	net_procfs_close,			/* close */
+	net_procfs_read,			/* read */
+	NULL,						/* write */
+
+	net_procfs_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	net_procfs_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_procfs_node
+ ****************************************************************************/
+
+static int net_procfs_node(FAR const char *relpath, FAR enum net_procfs_node_e *node)
+{
+	if (strcmp(relpath, "net/dev") == 0) {
+		*node = NET_PROCFS_DEV;
+	} else if (strcmp(relpath, "net/sock") == 0) {
+		*node = NET_PROCFS_SOCK;
+	} else {
+		return -ENOENT;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: net_procfs_devline
+ *
+ * Description:
+ *   nm_foreach() callback appending the counters of one interface.
+ *
+ ****************************************************************************/
+
+static int net_procfs_devline(struct netdev *dev, void *arg)
+{
+	FAR struct net_procfs_file_s *attr = (FAR struct net_procfs_file_s *)arg;
+	struct netmon_netdev_stats stats;
+	struct netdev_ops *ops = (struct netdev_ops *)dev->ops;
+	size_t remain = attr->bufsize - attr->buflen;
+
+	if (remain < NET_PROCFS_DEVLINE) {
+		return 1;
+	}
+
+	memset(&stats, 0, sizeof(stats));
+	if (ops == NULL || ops->get_stats == NULL || ops->get_stats(dev, &stats) < 0) {
+		return 0;
+	}
+
+	attr->buflen += snprintf(&attr->buf[attr->buflen], remain,
+							 "%-6.6s %10lu %10lu %10lu %10lu %6lu %6lu %6lu %6lu %6lu %6lu %6lu %6lu\n",
+							 dev->ifname,
+							 (unsigned long)stats.devinpkts, (unsigned long)stats.devinoctets,
+							 (unsigned long)stats.devoutpkts, (unsigned long)stats.devoutoctets,
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_NOMEM],
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_QFULL],
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_HDR],
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_CHKSUM],
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_PROTO],
+							 (unsigned long)stats.devdrops[NETMON_DROP_RX_ADDR],
+							 (unsigned long)stats.devdrops[NETMON_DROP_TX_NOBUF],
+							 (unsigned long)stats.devdrops[NETMON_DROP_TX_ERR]);
+	return 0;
+}
+
+/****************************************************************************
+ * Name: net_procfs_sockline
+ ****************************************************************************/
+
+static void net_procfs_sockline(FAR struct net_procfs_file_s *attr, int fd, FAR struct netmon_sock *sinfo)
+{
+	char laddr[INET_ADDRSTRLEN];
+	char raddr[INET_ADDRSTRLEN];
+	FAR const char *proto;
+
+	if (sinfo->type & NETMON_TCP) {
+		proto = "TCP";
+	} else if (sinfo->type & NETMON_UDP) {
+		proto = "UDP";
+	} else {
+		proto = "RAW";
+	}
+
+	if (inet_ntop(AF_INET, &sinfo->local.ip.sin_addr, laddr, sizeof(laddr)) == NULL) {
+		strncpy(laddr, "-", sizeof(laddr));
+	}
+	if (inet_ntop(AF_INET, &sinfo->remote.ip.sin_addr, raddr, sizeof(raddr)) == NULL) {
+		strncpy(raddr, "-", sizeof(raddr));
+	}
+
+	attr->buflen += snprintf(&attr->buf[attr->buflen], attr->bufsize - attr->buflen,
+							 "%-3d %-5s %15s:%-5u %15s:%-5u %6lu %7lu %6lu %4lu %6lu %6lu %6lu %d\n",
+							 fd, proto,
+							 laddr, (unsigned int)sinfo->local.ip.sin_port,
+							 raddr, (unsigned int)sinfo->remote.ip.sin_port,
+							 (unsigned long)sinfo->rtt, (unsigned long)sinfo->cwnd,
+							 (unsigned long)sinfo->rexmits, (unsigned long)sinfo->rtos,
+							 (unsigned long)sinfo->recvq, (unsigned long)sinfo->recvq_hwm,
+							 (unsigned long)sinfo->recvq_drops, sinfo->pid);
+}
+
+/****************************************************************************
+ * Name: net_procfs_sample
+ *
+ * Description:
+ *   Format the report.  The counters are read as they are, without
+ *   stopping the stack, like the SIOCGETSOCK and SIOCGDSTATS ioctls do.
+ *
+ ****************************************************************************/
+
+static void net_procfs_sample(FAR struct net_procfs_file_s *attr)
+{
+	attr->buflen = 0;
+
+	if (attr->node == NET_PROCFS_DEV) {
+		attr->buflen = snprintf(attr->buf, attr->bufsize,
+								"%-6s %10s %10s %10s %10s %6s %6s %6s %6s %6s %6s %6s %6s\n",
+								"Iface", "RxPkts", "RxBytes", "TxPkts", "TxBytes",
+								"NoMem", "QFull", "Hdr", "Chksum", "Proto", "Addr", "TxBuf", "TxErr");
+		(void)nm_foreach(net_procfs_devline, attr);
+	} else {
+		struct netstack *st = get_netstack(TR_SOCKET);
+		FAR struct netmon_sock *sinfo;
+		int i;
+
+		attr->buflen = snprintf(attr->buf, attr->bufsize,
+								"%-3s %-5s %21s %21s %6s %7s %6s %4s %6s %6s %6s %s\n",
+								"Fd", "Proto", "Local", "Remote", "RTT", "Cwnd", "Rexmit", "RTO",
+								"RecvQ", "MaxQ", "Drops", "PID");
+		for (i = 0; i < CONFIG_NSOCKET_DESCRIPTORS; i++) {
+			if (attr->bufsize - attr->buflen < NET_PROCFS_SOCKLINE) {
+				break;
+			}
+			sinfo = NULL;
+			if (st == NULL || st->ops->getstats == NULL || st->ops->getstats(i, &sinfo) < 0) {
+				continue;
+			}
+			net_procfs_sockline(attr, i, sinfo);
+			free(sinfo);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: net_procfs_open
+ ****************************************************************************/
+
+static int net_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct net_procfs_file_s *attr;
+	enum net_procfs_node_e node;
+	size_t bufsize;
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	if (net_procfs_node(relpath, &node) < 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	if (node == NET_PROCFS_DEV) {
+		bufsize = (nm_count() + 1) * NET_PROCFS_DEVLINE;
+	} else {
+		bufsize = (CONFIG_NSOCKET_DESCRIPTORS + 1) * NET_PROCFS_SOCKLINE;
+	}
+
+	attr = (FAR struct net_procfs_file_s *)kmm_zalloc(sizeof(struct net_procfs_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	attr->buf = (FAR char *)kmm_malloc(bufsize);
+	if (!attr->buf) {
+		fdbg("ERROR: Failed to allocate report buffer\n");
+		kmm_free(attr);
+		return -ENOMEM;
+	}
+
+	attr->node = node;
+	attr->bufsize = bufsize;
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: net_procfs_close
+ ****************************************************************************/
+
+static int net_procfs_close(FAR struct file *filep)
+{
+	FAR struct net_procfs_file_s *attr;
+
+	attr = (FAR struct net_procfs_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	kmm_free(attr->buf);
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: net_procfs_read
+ ****************************************************************************/
+
+static ssize_t net_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct net_procfs_file_s *attr;
+	off_t offset;
+	ssize_t ret;
+
+	attr = (FAR struct net_procfs_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Sample the counters on the first read so that the report stays
+	 * consistent if it is read in several pieces.
+	 */
+
+	if (filep->f_pos == 0) {
+		net_procfs_sample(attr);
+	}
+
+	offset = filep->f_pos;
+	ret = procfs_memcpy(attr->buf, attr->buflen, buffer, buflen, &offset);
+	if (ret > 0) {
+		filep->f_pos += ret;
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: net_procfs_dup
+ ****************************************************************************/
+
+static int net_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct net_procfs_file_s *oldattr;
+	FAR struct net_procfs_file_s *newattr;
+
+	oldattr = (FAR struct net_procfs_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	newattr = (FAR struct net_procfs_file_s *)kmm_malloc(sizeof(struct net_procfs_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	memcpy(newattr, oldattr, sizeof(struct net_procfs_file_s));
+	newattr->buf = (FAR char *)kmm_malloc(oldattr->bufsize);
+	if (!newattr->buf) {
+		fdbg("ERROR: Failed to allocate report buffer\n");
+		kmm_free(newattr);
+		return -ENOMEM;
+	}
+
+	memcpy(newattr->buf, oldattr->buf, oldattr->buflen);
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: net_procfs_stat
+ ****************************************************************************/
+
+static int net_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+	enum net_procfs_node_e node;
+
+	if (net_procfs_node(relpath, &node) < 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif /* CONFIG_NET_STATS_PERF && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_NET */
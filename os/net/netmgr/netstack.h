@@ -77,6 +77,8 @@ struct netstack_ops {
 	ssize_t (*send)(int s, const void *data, size_t size, int flags);
 	ssize_t (*sendto)(int s, const void *data, size_t size, int flags, const struct sockaddr *to, socklen_t tolen);
 	ssize_t (*sendmsg)(int s, struct msghdr *msg, int flags);
+	int (*recvmmsg)(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
+	int (*sendmmsg)(int s, struct mmsghdr *msgvec, unsigned int vlen, int flags);
 	int (*getsockname)(int s, struct sockaddr *name, socklen_t *namelen);
 	int (*getpeername)(int s, struct sockaddr *name, socklen_t *namelen);
 	int (*setsockopt)(int s, int level, int optname, const void *optval, socklen_t optlen);
@@ -91,6 +93,15 @@ struct netstack_ops {
 #ifdef CONFIG_NET_NETMON
 	int (*getstats)(int fd, struct netmon_sock **sock);
 #endif
+#ifdef CONFIG_NET_SENDFILE
+	ssize_t (*sendfile)(int s, FAR struct file *infile, FAR off_t *offset, size_t count);
+#endif
+
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+	ssize_t (*recvmsg_zc)(int s, FAR struct msghdr *msg, int flags, FAR void **zcbuf);
+	int (*zc_release)(FAR void *zcbuf);
+	ssize_t (*sendmsg_zc)(int s, FAR const struct msghdr *msg, int flags, sendmsg_zc_done_t done, FAR void *arg);
+#endif
 };
 
 struct netstack {
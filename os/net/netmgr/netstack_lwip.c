@@ -30,6 +30,11 @@
 #include "lwip/tcpip.h"
 #include "lwip/sys.h"
 #include "lwip/netif.h"
+#ifdef CONFIG_NET_SENDFILE
+#include <tinyara/fs/fs.h>
+#include <tinyara/kmalloc.h>
+#include "lwip/api.h"
+#endif
 #ifdef CONFIG_NET_NETMON
 #include "lwip/ip.h"
 #include "lwip/ip6.h"
@@ -226,8 +231,11 @@ static int lwip_ns_vfcntl(int sockfd, int cmd, va_list ap)
 
 static int lwip_ns_poll(int fd, struct pollfd *fds, bool setup)
 {
-	// ToDo
-	return 0;
+#ifndef CONFIG_DISABLE_POLL
+	return lwip_poll(fd, fds, setup);
+#else
+	return -ENOSYS;
+#endif
 }
 
 
@@ -340,6 +348,153 @@ static ssize_t lwip_ns_sendmsg(int sockfd, struct msghdr *msg, int flags)
 	return sendto(sockfd, buf, len, flags, to, (socklen_t) *addrlen);
 }
 
+static int lwip_ns_recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	return lwip_recvmmsg(sockfd, msgvec, vlen, flags);
+}
+
+
+static int lwip_ns_sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	return lwip_sendmmsg(sockfd, msgvec, vlen, flags);
+}
+
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+static ssize_t lwip_ns_recvmsg_zc(int sockfd, struct msghdr *msg, int flags, void **zcbuf)
+{
+	return lwip_recvmsg_zc(sockfd, msg, flags, zcbuf);
+}
+
+
+static int lwip_ns_zc_release(void *zcbuf)
+{
+	return lwip_zc_release(zcbuf);
+}
+
+
+static ssize_t lwip_ns_sendmsg_zc(int sockfd, const struct msghdr *msg, int flags, sendmsg_zc_done_t done, void *arg)
+{
+	return lwip_sendmsg_zc(sockfd, msg, flags, done, arg);
+}
+#endif
+
+#ifdef CONFIG_NET_SENDFILE
+/****************************************************************************
+ * Function: lwip_ns_sendfile
+ *
+ * Description:
+ *	 Send file data on a TCP socket without a user space bounce buffer.
+ *	 Files on XIP ROMFS are queued by reference: the TCP segments point at
+ *	 the flash image (PBUF_ROM) and no copy is made.  Other files are read
+ *	 into a kernel buffer and copied once into TCP segments.
+ *
+ * Returned Value:
+ *	 The number of bytes sent, or -1 with errno set.  errno is ENOSYS for
+ *	 non-TCP sockets so that the caller falls back to a copy loop.
+ *
+ ****************************************************************************/
+
+static ssize_t lwip_ns_sendfile(int s, FAR struct file *infile, FAR off_t *offset, size_t count)
+{
+	struct lwip_sock *sock;
+	FAR const uint8_t *xipbase;
+	FAR uint8_t *iobuffer;
+	off_t filesize;
+	off_t savepos;
+	off_t startpos;
+	size_t total = 0;
+	size_t written;
+	ssize_t nread;
+	u8_t write_flags;
+	err_t err = ERR_OK;
+	int errcode = 0;
+
+	sock = get_socket(s);
+	if (!sock) {
+		return -1;
+	}
+
+	if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) != NETCONN_TCP) {
+		errno = ENOSYS;
+		return -1;
+	}
+
+	write_flags = netconn_is_nonblocking(sock->conn) ? NETCONN_DONTBLOCK : 0;
+	savepos = infile->f_pos;
+	startpos = offset ? *offset : savepos;
+
+	if (file_xipbase(infile, &xipbase, &filesize) == OK) {
+		/* The data is immutable and always mapped: lend it to TCP */
+
+		if (startpos >= filesize) {
+			count = 0;
+		} else if (count > (size_t)(filesize - startpos)) {
+			count = (size_t)(filesize - startpos);
+		}
+
+		if (count > 0) {
+			err = netconn_write_partly(sock->conn, xipbase + startpos, count, write_flags, &total);
+		}
+	} else {
+		/* Move the file position once, then stream sequentially */
+
+		if (file_seek(infile, startpos, SEEK_SET) == (off_t)-1) {
+			return -1;
+		}
+
+		iobuffer = (FAR uint8_t *)kmm_malloc(CONFIG_NET_SENDFILE_BUFSIZE);
+		if (iobuffer == NULL) {
+			errno = ENOMEM;
+			return -1;
+		}
+
+		while (total < count) {
+			nread = file_read(infile, iobuffer, LWIP_MIN(count - total, CONFIG_NET_SENDFILE_BUFSIZE));
+			if (nread <= 0) {
+				errcode = -nread;
+				break;
+			}
+
+			written = 0;
+			err = netconn_write_partly(sock->conn, iobuffer, (size_t)nread, NETCONN_COPY | write_flags, &written);
+			total += written;
+			if (err != ERR_OK || written < (size_t)nread) {
+				break;
+			}
+		}
+
+		kmm_free(iobuffer);
+	}
+
+	/* Report where the transfer stopped.  With an explicit offset the file
+	 * position must be left as it was found.
+	 */
+
+	if (offset) {
+		*offset = startpos + total;
+		if (infile->f_pos != savepos) {
+			(void)file_seek(infile, savepos, SEEK_SET);
+		}
+	} else {
+		(void)file_seek(infile, startpos + total, SEEK_SET);
+	}
+
+	if (total == 0) {
+		if (errcode != 0) {
+			errno = errcode;
+			return -1;
+		}
+
+		if (err != ERR_OK) {
+			errno = err_to_errno(err);
+			return -1;
+		}
+	}
+
+	return (ssize_t)total;
+}
+#endif
+
 static int lwip_ns_init(void *data)
 {
 	lwip_init();
@@ -446,6 +601,31 @@ static void _get_raw_info(struct netmon_sock *sock_info, struct lwip_sock *lsock
 	sock_info->remote.ip.sin_port = 0;
 }
 
+#ifdef CONFIG_NET_STATS_PERF
+static void _get_perf_info(struct netmon_sock *sock_info, struct lwip_sock *lsock)
+{
+	struct netconn *conn = lsock->conn;
+
+	sock_info->rtt = 0;
+	sock_info->cwnd = 0;
+	sock_info->rexmits = 0;
+	sock_info->rtos = 0;
+	if (NETCONNTYPE_GROUP(conn->type) == NETCONN_TCP && conn->pcb.tcp->state != LISTEN) {
+		/* a listening pcb is a struct tcp_pcb_listen without these fields */
+		sock_info->rtt = conn->pcb.tcp->perf_srtt >> 3;
+		sock_info->cwnd = conn->pcb.tcp->cwnd;
+		sock_info->rexmits = conn->pcb.tcp->perf_rexmits;
+		sock_info->rtos = conn->pcb.tcp->perf_rtos;
+	}
+
+	/* the counters are sampled without the core lock, so the depth may be
+	 * off by the packet being posted while reading them */
+	sock_info->recvq = conn->recvq_in - conn->recvq_out;
+	sock_info->recvq_hwm = conn->recvq_hwm;
+	sock_info->recvq_drops = conn->recvq_drops;
+}
+#endif
+
 extern struct lwip_sock *get_lwip_sock_info(void);
 
 /**
@@ -484,6 +664,9 @@ static int lwip_ns_getstats(int fd, struct netmon_sock **sock_info)
 	} else {
 		_get_raw_info(sinfo, &sockets[fd]);
 	}
+#ifdef CONFIG_NET_STATS_PERF
+	_get_perf_info(sinfo, &sockets[fd]);
+#endif
 	if (pthread_getname_np(sockets[fd].conn->pid, sinfo->pid_name)) {
 		strncpy(sinfo->pid_name, "NONE", 5);
 	}
@@ -521,6 +704,8 @@ struct netstack_ops g_lwip_stack_ops = {
 	lwip_ns_send,
 	lwip_ns_sendto,
 	lwip_ns_sendmsg,
+	lwip_ns_recvmmsg,
+	lwip_ns_sendmmsg,
 
 	lwip_ns_getsockname,
 	lwip_ns_getpeername,
@@ -533,6 +718,14 @@ struct netstack_ops g_lwip_stack_ops = {
 #ifdef CONFIG_NET_NETMON
 	lwip_ns_getstats,
 #endif
+#ifdef CONFIG_NET_SENDFILE
+	lwip_ns_sendfile,
+#endif
+#ifdef CONFIG_NET_LWIP_ZEROCOPY
+	lwip_ns_recvmsg_zc,
+	lwip_ns_zc_release,
+	lwip_ns_sendmsg_zc,
+#endif
 };
 
 
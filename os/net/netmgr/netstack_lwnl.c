@@ -70,6 +70,8 @@ struct netstack_ops g_netlink_stack_ops = {
 	NULL,
 	NULL,
 	NULL,
+	NULL,
+	NULL,
 
 	NULL,
 	NULL,
@@ -82,6 +84,9 @@ struct netstack_ops g_netlink_stack_ops = {
 #ifdef CONFIG_NET_NETMON
 	NULL,
 #endif
+#ifdef CONFIG_NET_SENDFILE
+	NULL,
+#endif
 };
 
 struct netstack g_netlink_stack = {&g_netlink_stack_ops, NULL};
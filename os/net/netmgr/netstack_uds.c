@@ -36,7 +36,7 @@ struct netstack_ops g_uds_stack_ops = {
 	uds_checksd,
 	NULL,
 	NULL,
-	NULL,
+	uds_poll,
 
 	uds_socket,
 	uds_bind,
@@ -51,6 +51,8 @@ struct netstack_ops g_uds_stack_ops = {
 	uds_send,
 	uds_sendto,
 	NULL,
+	NULL,
+	NULL,
 
 	uds_getsockname,
 	uds_getpeername,
@@ -63,6 +65,9 @@ struct netstack_ops g_uds_stack_ops = {
 #ifdef CONFIG_NET_NETMON
 	NULL,
 #endif
+#ifdef CONFIG_NET_SENDFILE
+	uds_sendfile,
+#endif
 };
 
 struct netstack g_uds_stack = {&g_uds_stack_ops, NULL};
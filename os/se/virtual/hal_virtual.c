@@ -23,6 +23,9 @@
 #include <string.h>
 #include <tinyara/seclink_drv.h>
 #include <tinyara/security_hal.h>
+#ifdef CONFIG_HW_AES
+#include <mbedtls/aes.h>
+#endif
 
 #define _IN_
 #define _OUT_
@@ -30,7 +33,12 @@
 
 #define VH_TAG "[VH]"
 
+/* Tracing every request would dominate the cost of the crypto offload */
+#ifdef CONFIG_DEBUG_SECURE_ELEMENT_INFO
 #define VH_LOG printf
+#else
+#define VH_LOG(...)
+#endif
 
 #define VH_ENTER														\
 	do {																\
@@ -39,7 +47,7 @@
 
 #define VH_ERR(fd)												\
 	do {														\
-		VH_LOG("[ERR:%s] %s %s:%d ret(%d) code(%s)\n",			\
+		printf("[ERR:%s] %s %s:%d ret(%d) code(%s)\n",			\
 			   VH_TAG, __FUNCTION__, __FILE__, __LINE__, fd);	\
 	} while (0)
 
@@ -128,6 +136,246 @@ static int _virtual_is_ecc(hal_key_type type)
 	return 0;
 }
 
+#ifdef CONFIG_HW_AES
+/*
+ * Software model of an aes engine with key slots, so that the mbedtls
+ * offload (MBEDTLS_GCM_ALT) can run and be verified without a SE
+ */
+#define VH_AES_KEY_MAX 8
+
+struct virtual_aes_key {
+	int used;
+	uint32_t idx;
+	unsigned int keybits;
+	unsigned char key[32];
+};
+
+static struct virtual_aes_key g_virtual_aes_keys[VH_AES_KEY_MAX];
+
+static unsigned int _virtual_aes_keybits(hal_key_type type)
+{
+	switch (type) {
+	case HAL_KEY_AES_128:
+		return 128;
+	case HAL_KEY_AES_192:
+		return 192;
+	case HAL_KEY_AES_256:
+		return 256;
+	default:
+		return 0;
+	}
+}
+
+static struct virtual_aes_key *_virtual_aes_find(uint32_t key_idx)
+{
+	int i;
+	for (i = 0; i < VH_AES_KEY_MAX; i++) {
+		if (g_virtual_aes_keys[i].used && g_virtual_aes_keys[i].idx == key_idx) {
+			return &g_virtual_aes_keys[i];
+		}
+	}
+	return NULL;
+}
+
+static int _virtual_aes_set_key(hal_key_type type, uint32_t key_idx, hal_data *key)
+{
+	unsigned int keybits = _virtual_aes_keybits(type);
+	struct virtual_aes_key *k;
+	int i;
+
+	if (!key || !key->data || key->data_len != keybits / 8) {
+		return HAL_INVALID_ARGS;
+	}
+
+	k = _virtual_aes_find(key_idx);
+	for (i = 0; !k && i < VH_AES_KEY_MAX; i++) {
+		if (!g_virtual_aes_keys[i].used) {
+			k = &g_virtual_aes_keys[i];
+		}
+	}
+	if (!k) {
+		return HAL_NOT_ENOUGH_MEMORY;
+	}
+
+	k->used = 1;
+	k->idx = key_idx;
+	k->keybits = keybits;
+	memcpy(k->key, key->data, key->data_len);
+
+	return HAL_SUCCESS;
+}
+
+static int _virtual_aes_crypt(int encrypt, hal_data *in, hal_aes_param *param, struct virtual_aes_key *k, hal_data *out)
+{
+	mbedtls_aes_context aes;
+	unsigned char iv[16];
+	unsigned char stream[16];
+	const unsigned char *src = in->data;
+	unsigned char *dst = out->data;
+	size_t nc_off = 0;
+	uint32_t i;
+	int ret;
+
+	if (!param || !in->data || !out->data || out->data_len < in->data_len) {
+		return HAL_INVALID_ARGS;
+	}
+
+	if (param->mode != HAL_AES_ECB_NOPAD) {
+		if (!param->iv || param->iv_len != 16) {
+			return HAL_INVALID_ARGS;
+		}
+		memcpy(iv, param->iv, 16);
+	}
+
+	mbedtls_aes_init(&aes);
+	if (encrypt || param->mode == HAL_AES_CTR) {
+		ret = mbedtls_aes_setkey_enc(&aes, k->key, k->keybits);
+	} else {
+		ret = mbedtls_aes_setkey_dec(&aes, k->key, k->keybits);
+	}
+	if (ret != 0) {
+		mbedtls_aes_free(&aes);
+		return HAL_FAIL;
+	}
+
+	switch (param->mode) {
+	case HAL_AES_ECB_NOPAD:
+		if (in->data_len % 16) {
+			ret = HAL_INVALID_ARGS;
+			break;
+		}
+		for (i = 0; i < in->data_len && ret == 0; i += 16) {
+			ret = mbedtls_aes_crypt_ecb(&aes, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, src + i, dst + i);
+		}
+		break;
+	case HAL_AES_CBC_NOPAD:
+		ret = mbedtls_aes_crypt_cbc(&aes, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, in->data_len, iv, src, dst);
+		break;
+	case HAL_AES_CTR:
+		ret = mbedtls_aes_crypt_ctr(&aes, in->data_len, &nc_off, iv, stream, src, dst);
+		break;
+	default:
+		mbedtls_aes_free(&aes);
+		return HAL_NOT_SUPPORTED;
+	}
+	mbedtls_aes_free(&aes);
+
+	if (ret == HAL_INVALID_ARGS) {
+		return ret;
+	}
+	if (ret != 0) {
+		return HAL_FAIL;
+	}
+
+	out->data_len = in->data_len;
+	return HAL_SUCCESS;
+}
+#endif
+
+#ifdef CONFIG_HW_HASH
+/*
+ * The virtual SE computes SHA-256 on its own: calling mbedtls here would
+ * come back to the HAL when MBEDTLS_SHA256_ALT is enabled.
+ */
+static const uint32_t g_virtual_sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define VH_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void _virtual_sha256_block(uint32_t st[8], const unsigned char *p)
+{
+	uint32_t w[64];
+	uint32_t a, b, c, d, e, f, g, h, t1, t2;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 | (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+	}
+	for (; i < 64; i++) {
+		w[i] = (VH_ROTR(w[i - 2], 17) ^ VH_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7]
+			   + (VH_ROTR(w[i - 15], 7) ^ VH_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+	}
+
+	a = st[0];
+	b = st[1];
+	c = st[2];
+	d = st[3];
+	e = st[4];
+	f = st[5];
+	g = st[6];
+	h = st[7];
+	for (i = 0; i < 64; i++) {
+		t1 = h + (VH_ROTR(e, 6) ^ VH_ROTR(e, 11) ^ VH_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + g_virtual_sha256_k[i] + w[i];
+		t2 = (VH_ROTR(a, 2) ^ VH_ROTR(a, 13) ^ VH_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	st[0] += a;
+	st[1] += b;
+	st[2] += c;
+	st[3] += d;
+	st[4] += e;
+	st[5] += f;
+	st[6] += g;
+	st[7] += h;
+}
+
+static void _virtual_sha256(int is224, const unsigned char *in, uint32_t len, unsigned char *out)
+{
+	static const uint32_t iv256[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	static const uint32_t iv224[8] = {
+		0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+	};
+	unsigned char last[128];
+	uint32_t st[8];
+	uint32_t rest;
+	uint32_t pad;
+	uint64_t bits = (uint64_t)len * 8;
+	int i;
+
+	memcpy(st, is224 ? iv224 : iv256, sizeof(st));
+	for (; len >= 64; in += 64, len -= 64) {
+		_virtual_sha256_block(st, in);
+	}
+
+	rest = len;
+	memset(last, 0, sizeof(last));
+	memcpy(last, in, rest);
+	last[rest] = 0x80;
+	pad = (rest < 56) ? 64 : 128;
+	for (i = 0; i < 8; i++) {
+		last[pad - 1 - i] = (unsigned char)(bits >> (8 * i));
+	}
+	_virtual_sha256_block(st, last);
+	if (pad == 128) {
+		_virtual_sha256_block(st, last + 64);
+	}
+
+	for (i = 0; i < (is224 ? 7 : 8); i++) {
+		out[4 * i] = (unsigned char)(st[i] >> 24);
+		out[4 * i + 1] = (unsigned char)(st[i] >> 16);
+		out[4 * i + 2] = (unsigned char)(st[i] >> 8);
+		out[4 * i + 3] = (unsigned char)st[i];
+	}
+}
+#endif
+
 /**
  * Common
  */
@@ -168,6 +416,11 @@ int virtual_hal_set_key(_IN_ hal_key_type type, _IN_ uint32_t key_idx, _IN_ hal_
 {
 	VH_ENTER;
 	VH_LOG("type(%d) key index(%d)\n", type, key_idx);
+#ifdef CONFIG_HW_AES
+	if (_virtual_aes_keybits(type)) {
+		return _virtual_aes_set_key(type, key_idx, key);
+	}
+#endif
 	int is_asym = _virtual_is_asymmetric(type);
 	if (is_asym) {
 		VH_LOG("Asymmetric Key");
@@ -203,6 +456,15 @@ int virtual_hal_remove_key(_IN_ hal_key_type mode, _IN_ uint32_t key_idx)
 {
 	VH_ENTER;
 	VH_LOG("mode(%d) key index(%d)\n", mode, key_idx);
+#ifdef CONFIG_HW_AES
+	if (_virtual_aes_keybits(mode)) {
+		struct virtual_aes_key *k = _virtual_aes_find(key_idx);
+		if (!k) {
+			return HAL_INVALID_ARGS;
+		}
+		memset(k, 0, sizeof(*k));
+	}
+#endif
 
 	return 0;
 }
@@ -234,6 +496,16 @@ int virtual_hal_generate_random(_IN_ uint32_t len, _OUT_ hal_data *random)
 int virtual_hal_get_hash(_IN_ hal_hash_type mode, _IN_ hal_data *input, _OUT_ hal_data *hash)
 {
 	VH_ENTER;
+#ifdef CONFIG_HW_HASH
+	if (mode == HAL_HASH_SHA256 || mode == HAL_HASH_SHA224) {
+		uint32_t len = (mode == HAL_HASH_SHA224) ? 28 : 32;
+		if (!input || (!input->data && input->data_len) || !hash || !hash->data || hash->data_len < len) {
+			return HAL_INVALID_ARGS;
+		}
+		_virtual_sha256(mode == HAL_HASH_SHA224, input->data, input->data_len, hash->data);
+		hash->data_len = len;
+	}
+#endif
 	return 0;
 }
 
@@ -369,6 +641,12 @@ int virtual_hal_get_factory_data(_IN_ uint32_t data_idx, _IN_ hal_data *data)
 int virtual_hal_aes_encrypt(_IN_ hal_data *dec_data, _IN_ hal_aes_param *aes_param, _IN_ uint32_t key_idx, _OUT_ hal_data *enc_data)
 {
 	VH_ENTER;
+#ifdef CONFIG_HW_AES
+	struct virtual_aes_key *k = _virtual_aes_find(key_idx);
+	if (k) {
+		return _virtual_aes_crypt(1, dec_data, aes_param, k, enc_data);
+	}
+#endif
 
 	enc_data->data = (unsigned char *)malloc(dec_data->data_len);
 	memcpy(enc_data->data, dec_data->data, dec_data->data_len);
@@ -380,6 +658,12 @@ int virtual_hal_aes_encrypt(_IN_ hal_data *dec_data, _IN_ hal_aes_param *aes_par
 int virtual_hal_aes_decrypt(_IN_ hal_data *enc_data, _IN_ hal_aes_param *aes_param, _IN_ uint32_t key_idx, _OUT_ hal_data *dec_data)
 {
 	VH_ENTER;
+#ifdef CONFIG_HW_AES
+	struct virtual_aes_key *k = _virtual_aes_find(key_idx);
+	if (k) {
+		return _virtual_aes_crypt(0, enc_data, aes_param, k, dec_data);
+	}
+#endif
 
 	dec_data->data = (unsigned char *)malloc(enc_data->data_len);
 	memcpy(dec_data->data, enc_data->data, enc_data->data_len);
@@ -75,6 +75,7 @@
 #include <sys/socket.h>
 #include <sys/mount.h>
 #include <sys/boardctl.h>
+#include <sys/epoll.h>
 
 #include <stdio.h>
 #include <stdlib.h>
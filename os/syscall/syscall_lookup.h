@@ -204,6 +204,12 @@ SYSCALL_LOOKUP(aio_cancel,              2, SYS_aio_cancel)
 #  ifndef CONFIG_DISABLE_POLL
 SYSCALL_LOOKUP(poll,                    3, STUB_poll)
 SYSCALL_LOOKUP(select,                  5, STUB_select)
+#  ifdef CONFIG_FS_EPOLL
+SYSCALL_LOOKUP(epoll_create,            1, STUB_epoll_create)
+SYSCALL_LOOKUP(epoll_create1,           1, STUB_epoll_create1)
+SYSCALL_LOOKUP(epoll_ctl,               4, STUB_epoll_ctl)
+SYSCALL_LOOKUP(epoll_wait,              4, STUB_epoll_wait)
+#  endif
 #  endif
 #endif
 
@@ -225,7 +231,10 @@ SYSCALL_LOOKUP(lseek,                   3, STUB_lseek)
 #if defined(CONFIG_PIPES)
 SYSCALL_LOOKUP(mkfifo,                  2, STUB_mkfifo)
 #endif
-SYSCALL_LOOKUP(mmap,                    6, NULL)
+#if defined(CONFIG_FS_MMAP)
+SYSCALL_LOOKUP(mmap,                    6, STUB_mmap)
+SYSCALL_LOOKUP(munmap,                  2, STUB_munmap)
+#endif
 SYSCALL_LOOKUP(open,                    6, STUB_open)
 SYSCALL_LOOKUP(opendir,                 1, STUB_opendir)
 #if defined(CONFIG_PIPES)
@@ -343,6 +352,11 @@ SYSCALL_LOOKUP(sendto,                  6, STUB_sendto)
 SYSCALL_LOOKUP(setsockopt,              5, STUB_setsockopt)
 SYSCALL_LOOKUP(shutdown,                2, STUB_shutdown)
 SYSCALL_LOOKUP(socket,                  3, STUB_socket)
+SYSCALL_LOOKUP(recvmmsg,                5, STUB_recvmmsg)
+SYSCALL_LOOKUP(sendmmsg,                4, STUB_sendmmsg)
+#ifdef CONFIG_NET_SENDFILE
+SYSCALL_LOOKUP(sendfile,                4, STUB_sendfile)
+#endif
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -0,0 +1,574 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Headless rendering benchmark.
+ *
+ * Usage: bench [-t msec] [-d dir] [font.ttf]
+ *
+ * Every screen is shown for the given time (2 seconds by default) while the
+ * headless DAL records each frame the UI core presents: the time spent from
+ * the start of the frame to its last redraw, the pixels drawn and the heap in
+ * use. The core runs unthrottled (CONFIG_UI_MAXIMUM_FPS is 0), so the frame
+ * rate is the rendering throughput of the screen. Some screens animate by
+ * themselves, the others are driven by scripted touch gestures. Each screen
+ * is measured twice: once with the renderer writing into the framebuffer of
+ * the DAL and once through the per-pixel put_pixel functions. With -d, the
+ * panel is written to <dir>/<screen>_<pass>.ppm at the end of each pass. The
+ * text screens need a TTF file.
+ */
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <araui/ui_asset.h>
+#include <araui/ui_core.h>
+#include <araui/ui_window.h>
+#include <araui/ui_widget.h>
+#include <araui/ui_animation.h>
+#include "ui_asset_internal.h"
+#include "dal/dal_headless.h"
+
+#define BENCH_WARMUP_MS     (300)
+#define BENCH_MAX_FRAMES    (1 << 18)
+#define BENCH_ICON_SIZE     (64)
+#define BENCH_ICON_COUNT    (4)
+#define BENCH_SPIN_SIZE     (96)
+#define BENCH_SCROLL_SIZE   (16)
+#define BENCH_SCROLL_TEXT   "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs. " \
+	"Sphinx of black quartz, judge my vow. How vexingly quick daft zebras jump! "
+#define BENCH_ROW_HEIGHT    (80)
+#define BENCH_ROW_MARGIN    (8)
+#define BENCH_LIST_PAGES    (4)
+#define BENCH_PAGE_COUNT    (4)
+#define BENCH_TOUCH_STEP_MS (16)
+#define BENCH_SWIPE_STEPS   (12)
+
+typedef void (*bench_build_t)(ui_widget_t screen);
+typedef void (*bench_drive_t)(uint32_t gesture);
+typedef void (*bench_cleanup_t)(void);
+
+typedef struct {
+	const char *name;
+	bench_build_t build;
+	bench_drive_t drive;      //!< Plays one gesture and waits until it settles, NULL if the screen animates by itself
+	bench_cleanup_t cleanup;  //!< Releases what build() set up outside of the screen, may be NULL
+	bool needs_font;
+} bench_screen_t;
+
+static ui_window_t g_window;
+static uint8_t *g_bg_bitmap;
+static uint8_t *g_icon_bitmap;
+static uint8_t *g_spin_bitmap;
+static uint8_t *g_row_bitmap;
+static ui_asset_t g_bg;
+static ui_asset_t g_icon;
+static ui_asset_t g_spin;
+static ui_asset_t g_row;
+static ui_asset_t g_font;
+static ui_anim_t g_anims[BENCH_ICON_COUNT];
+static ui_anim_t g_scroll_anim;
+static ui_widget_t g_pages[BENCH_PAGE_COUNT];
+static ui_widget_t g_quick_panel;
+static headless_frame_t *g_frames;
+static const char *g_dump_dir;
+
+static void on_create_cb(ui_window_t window)
+{
+
+}
+
+static uint64_t bench_now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint8_t *bench_bitmap_create(int32_t width, int32_t height, ui_pixel_format_t pf)
+{
+	ui_bitmap_data_t *header;
+	uint8_t *bitmap;
+	uint8_t *pixel;
+	uint32_t bpp = (pf == UI_PIXEL_FORMAT_RGBA8888) ? 4 : 3;
+	int32_t radius = width / 2;
+	int32_t dx;
+	int32_t dy;
+	int32_t d;
+	int32_t x;
+	int32_t y;
+
+	bitmap = (uint8_t *)malloc(sizeof(ui_bitmap_data_t) + width * height * bpp);
+	if (!bitmap) {
+		return NULL;
+	}
+
+	header = (ui_bitmap_data_t *)bitmap;
+	memset(header, 0, sizeof(ui_bitmap_data_t));
+	header->width = width;
+	header->height = height;
+	header->pf = pf;
+	header->header_size = sizeof(ui_bitmap_data_t);
+	header->data_size = width * height * bpp;
+
+	pixel = bitmap + sizeof(ui_bitmap_data_t);
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			pixel[0] = (x * 255) / width;
+			pixel[1] = (y * 255) / height;
+			pixel[2] = ((x ^ y) & 0x10) ? 0xc0 : 0x40;
+			if (bpp == 4) {
+				// A disc with a soft edge, fully transparent in the corners
+				dx = x - radius;
+				dy = y - radius;
+				d = radius * radius - (dx * dx + dy * dy);
+				pixel[3] = (d <= 0) ? 0 : (d >= radius * 8) ? 0xff : (d * 0xff) / (radius * 8);
+			}
+			pixel += bpp;
+		}
+	}
+
+	return bitmap;
+}
+
+/**
+ * @brief Drags a finger from one point to another in BENCH_SWIPE_STEPS moves
+ *        at the rate of a touch panel, then lifts it.
+ */
+static void bench_swipe(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+	int32_t i;
+
+	headless_push_touch(true, x0, y0);
+	for (i = 1; i <= BENCH_SWIPE_STEPS; i++) {
+		usleep(BENCH_TOUCH_STEP_MS * 1000);
+		headless_push_touch(true, x0 + (x1 - x0) * i / BENCH_SWIPE_STEPS, y0 + (y1 - y0) * i / BENCH_SWIPE_STEPS);
+	}
+	usleep(BENCH_TOUCH_STEP_MS * 1000);
+	headless_push_touch(false, x1, y1);
+}
+
+static ui_widget_t bench_add_background(ui_widget_t screen)
+{
+	ui_widget_t bg;
+
+	bg = ui_image_widget_create(g_bg);
+	ui_widget_add_child(screen, bg, 0, 0);
+
+	return bg;
+}
+
+static void bench_build_background(ui_widget_t screen)
+{
+	bench_add_background(screen);
+}
+
+static void bench_build_icons(ui_widget_t screen)
+{
+	int32_t gap = (CONFIG_UI_DISPLAY_WIDTH - BENCH_ICON_COUNT * BENCH_ICON_SIZE) / (BENCH_ICON_COUNT + 1);
+	int32_t row;
+	int32_t col;
+
+	bench_add_background(screen);
+
+	for (row = 0; row < BENCH_ICON_COUNT; row++) {
+		for (col = 0; col < BENCH_ICON_COUNT; col++) {
+			ui_widget_add_child(screen, ui_image_widget_create(g_icon),
+				gap + col * (BENCH_ICON_SIZE + gap), gap + row * (BENCH_ICON_SIZE + gap));
+		}
+	}
+}
+
+static void bench_build_rotate(ui_widget_t screen)
+{
+	ui_widget_t spin;
+	int32_t half = CONFIG_UI_DISPLAY_WIDTH / 2;
+	int i;
+
+	bench_add_background(screen);
+
+	for (i = 0; i < BENCH_ICON_COUNT; i++) {
+		spin = ui_image_widget_create(g_spin);
+		ui_widget_set_pivot_point(spin, BENCH_SPIN_SIZE / 2, BENCH_SPIN_SIZE / 2);
+		ui_widget_add_child(screen, spin, (i % 2) * half + (half - BENCH_SPIN_SIZE) / 2,
+			(i / 2) * half + (half - BENCH_SPIN_SIZE) / 2);
+		ui_widget_play_anim(spin, g_anims[i], NULL, true);
+	}
+}
+
+static void bench_build_text(ui_widget_t screen)
+{
+	ui_widget_t text;
+
+	bench_add_background(screen);
+
+	text = ui_text_widget_create(CONFIG_UI_DISPLAY_WIDTH - 40, CONFIG_UI_DISPLAY_HEIGHT - 40, g_font,
+		"The quick brown fox jumps over the lazy dog. "
+		"Pack my box with five dozen liquor jugs. 0123456789", 24);
+	ui_text_widget_set_word_wrap(text, true);
+	ui_text_widget_set_color(text, 0xffffff);
+	ui_widget_add_child(screen, text, 20, 20);
+}
+
+static void bench_build_text_scroll(ui_widget_t screen)
+{
+	ui_widget_t text;
+
+	bench_add_background(screen);
+
+	/* A long text moving up through the screen, most of its lines are out of sight */
+	text = ui_text_widget_create(CONFIG_UI_DISPLAY_WIDTH - 20, CONFIG_UI_DISPLAY_HEIGHT * 4, g_font,
+		BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT
+		BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT BENCH_SCROLL_TEXT, BENCH_SCROLL_SIZE);
+	ui_text_widget_set_word_wrap(text, true);
+	ui_text_widget_set_color(text, 0xffffff);
+	ui_widget_add_child(screen, text, 10, 0);
+	ui_widget_play_anim(text, g_scroll_anim, NULL, true);
+}
+
+static void bench_build_list(ui_widget_t screen)
+{
+	ui_widget_t scroll;
+	int32_t rows = (CONFIG_UI_DISPLAY_HEIGHT * BENCH_LIST_PAGES) / BENCH_ROW_HEIGHT;
+	int32_t y;
+	int32_t i;
+
+	scroll = ui_scroll_widget_create(CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT);
+	ui_scroll_widget_set_direction(scroll, UI_DIRECTION_VERTICAL);
+	ui_scroll_widget_set_content_size(scroll, CONFIG_UI_DISPLAY_WIDTH, rows * BENCH_ROW_HEIGHT);
+
+	for (i = 0; i < rows; i++) {
+		y = i * BENCH_ROW_HEIGHT + BENCH_ROW_MARGIN / 2;
+		ui_widget_add_child(scroll, ui_image_widget_create(g_row), BENCH_ROW_MARGIN, y);
+		ui_widget_add_child(scroll, ui_image_widget_create(g_icon), BENCH_ROW_MARGIN * 2,
+			y + (BENCH_ROW_HEIGHT - BENCH_ROW_MARGIN - BENCH_ICON_SIZE) / 2);
+	}
+
+	ui_widget_add_child(screen, scroll, 0, 0);
+}
+
+static void bench_drive_list(uint32_t gesture)
+{
+	int32_t x = CONFIG_UI_DISPLAY_WIDTH / 2;
+	int32_t top = CONFIG_UI_DISPLAY_HEIGHT / 4;
+	int32_t bottom = CONFIG_UI_DISPLAY_HEIGHT * 3 / 4;
+
+	// Three flicks down the list, then three back up, each one left to fling out
+	if ((gesture / 3) % 2 == 0) {
+		bench_swipe(x, bottom, x, top);
+	} else {
+		bench_swipe(x, top, x, bottom);
+	}
+	usleep(500 * 1000);
+}
+
+static void bench_build_pages(ui_widget_t screen)
+{
+	int32_t gap = (CONFIG_UI_DISPLAY_WIDTH - BENCH_ICON_COUNT * BENCH_ICON_SIZE) / (BENCH_ICON_COUNT + 1);
+	int32_t i;
+	int32_t j;
+
+	for (i = 0; i < BENCH_PAGE_COUNT; i++) {
+		g_pages[i] = ui_widget_create(CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT);
+		bench_add_background(g_pages[i]);
+
+		/* The pages differ by the number of icons on them */
+		for (j = 0; j <= i; j++) {
+			ui_widget_add_child(g_pages[i], ui_image_widget_create(g_icon),
+				gap + j * (BENCH_ICON_SIZE + gap), (CONFIG_UI_DISPLAY_HEIGHT - BENCH_ICON_SIZE) / 2);
+		}
+	}
+
+	ui_widget_add_child(screen, ui_paginator_widget_create(CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT,
+		g_pages, BENCH_PAGE_COUNT), 0, 0);
+}
+
+static void bench_drive_pages(uint32_t gesture)
+{
+	int32_t y = CONFIG_UI_DISPLAY_HEIGHT / 2;
+	int32_t left = CONFIG_UI_DISPLAY_WIDTH / 4;
+	int32_t right = CONFIG_UI_DISPLAY_WIDTH * 3 / 4;
+
+	// Page through to the last page and back to the first one
+	if ((gesture / (BENCH_PAGE_COUNT - 1)) % 2 == 0) {
+		bench_swipe(right, y, left, y);
+	} else {
+		bench_swipe(left, y, right, y);
+	}
+	usleep(200 * 1000);
+}
+
+static void bench_cleanup_pages(void)
+{
+	int32_t i;
+
+	/* The paginator only frees the pages on show, the others are not in its
+	 * tree. A page detaches itself from the paginator when it is destroyed.
+	 */
+	for (i = 0; i < BENCH_PAGE_COUNT; i++) {
+		ui_widget_destroy(g_pages[i]);
+		g_pages[i] = UI_NULL;
+	}
+}
+
+static void bench_build_quick_panel(ui_widget_t screen)
+{
+	int32_t gap = (CONFIG_UI_DISPLAY_WIDTH - BENCH_ICON_COUNT * BENCH_ICON_SIZE) / (BENCH_ICON_COUNT + 1);
+	int32_t i;
+
+	bench_build_icons(screen);
+
+	g_quick_panel = ui_quick_panel_create(UI_TRANSITION_SLIDE);
+	bench_add_background(g_quick_panel);
+	for (i = 0; i < BENCH_ICON_COUNT; i++) {
+		ui_widget_add_child(g_quick_panel, ui_image_widget_create(g_spin),
+			gap + i * (BENCH_ICON_SIZE + gap) - (BENCH_SPIN_SIZE - BENCH_ICON_SIZE) / 2, CONFIG_UI_DISPLAY_HEIGHT / 3);
+	}
+	ui_core_set_quick_panel(UI_QUICK_PANEL_TOP_SWIPE, g_quick_panel);
+}
+
+static void bench_drive_quick_panel(uint32_t gesture)
+{
+	int32_t x = CONFIG_UI_DISPLAY_WIDTH / 2;
+
+	// Pull the panel down from the top edge and push it back up, so that it
+	// is closed again when the screen is left.
+	bench_swipe(x, 4, x, CONFIG_UI_DISPLAY_HEIGHT * 2 / 3);
+	usleep(400 * 1000);
+	bench_swipe(x, CONFIG_UI_DISPLAY_HEIGHT * 2 / 3, x, CONFIG_UI_DISPLAY_HEIGHT / 6);
+	usleep(400 * 1000);
+}
+
+static void bench_cleanup_quick_panel(void)
+{
+	if (ui_core_unset_quick_panel(UI_QUICK_PANEL_TOP_SWIPE) == UI_OK) {
+		ui_widget_destroy(g_quick_panel);
+	}
+	g_quick_panel = UI_NULL;
+}
+
+static const bench_screen_t g_screens[] = {
+	{"background",  bench_build_background,  NULL,                    NULL,                      false},
+	{"icons",       bench_build_icons,       NULL,                    NULL,                      false},
+	{"rotate",      bench_build_rotate,      NULL,                    NULL,                      false},
+	{"list",        bench_build_list,        bench_drive_list,        NULL,                      false},
+	{"pages",       bench_build_pages,       bench_drive_pages,       bench_cleanup_pages,       false},
+	{"quick_panel", bench_build_quick_panel, bench_drive_quick_panel, bench_cleanup_quick_panel, false},
+	{"text",        bench_build_text,        NULL,                    NULL,                      true},
+	{"text_scroll", bench_build_text_scroll, NULL,                    NULL,                      true},
+};
+
+static int bench_compare_render(const void *a, const void *b)
+{
+	uint32_t ra = ((const headless_frame_t *)a)->render_us;
+	uint32_t rb = ((const headless_frame_t *)b)->render_us;
+
+	return (ra > rb) - (ra < rb);
+}
+
+static void bench_report(const char *name, const char *pass, uint32_t count, uint64_t elapsed, uint32_t heap_base)
+{
+	uint64_t render = 0;
+	uint64_t pixels = 0;
+	uint64_t areas = 0;
+	uint32_t heap_peak = heap_base;
+	uint32_t i;
+
+	if (count == 0) {
+		printf("%-12s %-9s %7u   no frames were presented\n", name, pass, count);
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		render += g_frames[i].render_us;
+		pixels += g_frames[i].pixels;
+		areas += g_frames[i].areas;
+		if (g_frames[i].heap > heap_peak) {
+			heap_peak = g_frames[i].heap;
+		}
+	}
+
+	qsort(g_frames, count, sizeof(headless_frame_t), bench_compare_render);
+
+	printf("%-12s %-9s %7u %8.1f %8.3f %8.3f %8.3f %9u %6.1f %8.1f\n", name, pass, count,
+		(count * 1000.0) / elapsed,
+		render / 1000.0 / count,
+		g_frames[(count - 1) * 95 / 100].render_us / 1000.0,
+		g_frames[count - 1].render_us / 1000.0,
+		(uint32_t)(pixels / count),
+		(double)areas / count,
+		(heap_peak - heap_base) / 1024.0);
+}
+
+static void bench_run(const bench_screen_t *bench, uint32_t msec)
+{
+	ui_widget_t screen;
+	char path[256];
+	const char *pass_name;
+	uint32_t heap_base;
+	uint32_t gesture;
+	uint32_t count;
+	uint64_t start;
+	uint64_t elapsed;
+	int pass;
+
+	heap_base = headless_get_heap_used();
+
+	screen = ui_widget_create(CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT);
+	bench->build(screen);
+	ui_window_add_widget(g_window, screen, 0, 0);
+
+	for (pass = 0; pass < 2; pass++) {
+		pass_name = (pass == 0) ? "fb" : "put_pixel";
+
+		headless_use_framebuffer(pass == 0);
+		usleep(BENCH_WARMUP_MS * 1000);
+
+		headless_start_recording(g_frames, BENCH_MAX_FRAMES);
+		start = bench_now_ms();
+		if (bench->drive) {
+			gesture = 0;
+			while (bench_now_ms() - start < msec) {
+				bench->drive(gesture++);
+			}
+		} else {
+			usleep(msec * 1000);
+		}
+		elapsed = bench_now_ms() - start;
+		count = headless_stop_recording();
+
+		bench_report(bench->name, pass_name, count, elapsed, heap_base);
+
+		if (g_dump_dir) {
+			snprintf(path, sizeof(path), "%s/%s_%s.ppm", g_dump_dir, bench->name, pass_name);
+			if (!headless_dump_ppm(path)) {
+				printf("error: cannot write %s\n", path);
+			}
+		}
+	}
+
+	if (bench->cleanup) {
+		bench->cleanup();
+	}
+	ui_widget_destroy(screen);
+
+	// Lets the UI thread free the screen before the heap of the next one is measured.
+	usleep(BENCH_WARMUP_MS * 1000);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *font_path = NULL;
+	uint32_t msec = 2000;
+	uint32_t i;
+
+	for (i = 1; i < (uint32_t)argc; i++) {
+		if (!strcmp(argv[i], "-t") && i + 1 < (uint32_t)argc) {
+			msec = (uint32_t)atoi(argv[++i]);
+		} else if (!strcmp(argv[i], "-d") && i + 1 < (uint32_t)argc) {
+			g_dump_dir = argv[++i];
+		} else {
+			font_path = argv[i];
+		}
+	}
+
+	if (msec == 0) {
+		printf("Usage: %s [-t msec] [-d dir] [font.ttf]\n", argv[0]);
+		return -1;
+	}
+
+	g_frames = (headless_frame_t *)malloc(BENCH_MAX_FRAMES * sizeof(headless_frame_t));
+	g_bg_bitmap = bench_bitmap_create(CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT, UI_PIXEL_FORMAT_RGB888);
+	g_icon_bitmap = bench_bitmap_create(BENCH_ICON_SIZE, BENCH_ICON_SIZE, UI_PIXEL_FORMAT_RGBA8888);
+	g_spin_bitmap = bench_bitmap_create(BENCH_SPIN_SIZE, BENCH_SPIN_SIZE, UI_PIXEL_FORMAT_RGBA8888);
+	g_row_bitmap = bench_bitmap_create(CONFIG_UI_DISPLAY_WIDTH - BENCH_ROW_MARGIN * 2, BENCH_ROW_HEIGHT - BENCH_ROW_MARGIN,
+		UI_PIXEL_FORMAT_RGB888);
+	if (!g_frames || !g_bg_bitmap || !g_icon_bitmap || !g_spin_bitmap || !g_row_bitmap) {
+		printf("error: out of memory!\n");
+		return -1;
+	}
+
+	if (ui_start() != UI_OK) {
+		printf("error: ui_start failed!\n");
+		return -1;
+	}
+
+	g_window = ui_window_create(on_create_cb, NULL, NULL, NULL);
+
+	g_bg = ui_image_asset_create_from_buffer(g_bg_bitmap);
+	g_icon = ui_image_asset_create_from_buffer(g_icon_bitmap);
+	g_spin = ui_image_asset_create_from_buffer(g_spin_bitmap);
+	g_row = ui_image_asset_create_from_buffer(g_row_bitmap);
+	for (i = 0; i < BENCH_ICON_COUNT; i++) {
+		g_anims[i] = ui_rotate_anim_create(0, (i % 2) ? -360 : 360, 1000 + i * 250, UI_INTRP_LINEAR);
+	}
+	g_scroll_anim = ui_move_anim_create(10, 0, 10, -CONFIG_UI_DISPLAY_HEIGHT * 3, 8000, UI_INTRP_LINEAR);
+
+	if (font_path) {
+		g_font = ui_font_asset_create_from_file(font_path);
+		if (!g_font) {
+			printf("error: cannot load the font %s\n", font_path);
+		}
+	}
+
+	printf("%dx%d RGB888, %s update, %u ms per screen\n", CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT,
+#if defined(CONFIG_UI_PARTIAL_UPDATE)
+		"partial",
+#else
+		"full",
+#endif
+		msec);
+	printf("%-12s %-9s %7s %8s %8s %8s %8s %9s %6s %8s\n", "screen", "pass", "frames", "fps",
+		"avg ms", "p95 ms", "max ms", "px/frame", "areas", "heap KB");
+
+	for (i = 0; i < sizeof(g_screens) / sizeof(g_screens[0]); i++) {
+		if (g_screens[i].needs_font && !g_font) {
+			continue;
+		}
+		bench_run(&g_screens[i], msec);
+	}
+
+	// The requests are handled in order, the screens are gone before the assets.
+	for (i = 0; i < BENCH_ICON_COUNT; i++) {
+		ui_anim_destroy(g_anims[i]);
+	}
+	ui_anim_destroy(g_scroll_anim);
+	if (g_font) {
+		ui_font_asset_destroy(g_font);
+	}
+	ui_image_asset_destroy(g_row);
+	ui_image_asset_destroy(g_spin);
+	ui_image_asset_destroy(g_icon);
+	ui_image_asset_destroy(g_bg);
+	ui_window_destroy(g_window);
+
+	ui_stop();
+
+	free(g_row_bitmap);
+	free(g_spin_bitmap);
+	free(g_icon_bitmap);
+	free(g_bg_bitmap);
+	free(g_frames);
+
+	return 0;
+}
@@ -0,0 +1,363 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+//!< AraUI Public
+#include <araui/ui_commons.h>
+
+//!< AraUI Internal
+#include "ui_debug.h"
+#include "ui_commons_internal.h"
+#include "ui_renderer.h"
+#include "dal/ui_dal.h"
+
+//!< Local
+#include "dal_headless.h"
+
+/****************************************************************************
+ * Macros
+ ****************************************************************************/
+#define FB_STRIDE      (CONFIG_UI_DISPLAY_WIDTH * 3)
+#define FB_SIZE        (FB_STRIDE * CONFIG_UI_DISPLAY_HEIGHT)
+
+#define HEADLESS_TOUCH_QUEUE_SIZE (64)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+typedef struct {
+	bool pressed;
+	ui_coord_t coord;
+} headless_touch_t;
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+// The renderer draws into the back buffer, the redrawn areas are copied to
+// the front buffer which stands for the memory of the panel.
+static uint8_t             *g_back;
+static uint8_t             *g_front;
+static pthread_mutex_t      g_mutex;
+static bool                 g_use_fb = true;
+static ui_rect_t            g_viewport = {0, };
+
+//!< Frame being drawn, only touched by the UI thread
+static headless_frame_t     g_cur;
+static uint64_t             g_cur_start;
+static uint64_t             g_cur_copy;
+
+//!< Recording, protected by g_mutex
+static headless_frame_t    *g_frames;
+static uint32_t             g_frames_max;
+static uint32_t             g_frames_count;
+
+//!< Touch queue, protected by g_mutex
+static headless_touch_t     g_touch_queue[HEADLESS_TOUCH_QUEUE_SIZE];
+static uint32_t             g_touch_head;
+static uint32_t             g_touch_tail;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static uint64_t _headless_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint32_t _headless_heap_used(void)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return (uint32_t)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+	return (uint32_t)mallinfo().uordblks;
+#elif defined(__APPLE__)
+	return (uint32_t)mstats().bytes_used;
+#else
+	return 0;
+#endif
+}
+
+static void _headless_end_frame(void)
+{
+	if (g_cur.areas == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&g_mutex);
+	if (g_frames && g_frames_count < g_frames_max) {
+		g_frames[g_frames_count++] = g_cur;
+	}
+	pthread_mutex_unlock(&g_mutex);
+}
+
+/****************************************************************************
+ * DAL Interface Implementation
+ ****************************************************************************/
+UI_DAL ui_error_t ui_dal_init(void)
+{
+	g_back = (uint8_t *)UI_ALLOC(FB_SIZE);
+	g_front = (uint8_t *)UI_ALLOC(FB_SIZE);
+	if (!g_back || !g_front) {
+		UI_LOGE("error: cannot alloc the framebuffers!\n");
+		UI_FREE(g_back);
+		UI_FREE(g_front);
+		g_back = NULL;
+		g_front = NULL;
+		return UI_INIT_FAILURE;
+	}
+
+	memset(g_back, 0, FB_SIZE);
+	memset(g_front, 0, FB_SIZE);
+	memset(&g_cur, 0, sizeof(headless_frame_t));
+	pthread_mutex_init(&g_mutex, NULL);
+	g_touch_head = 0;
+	g_touch_tail = 0;
+
+	return UI_OK;
+}
+
+UI_DAL ui_error_t ui_dal_deinit(void)
+{
+	UI_FREE(g_back);
+	UI_FREE(g_front);
+	g_back = NULL;
+	g_front = NULL;
+
+	pthread_mutex_destroy(&g_mutex);
+
+	return UI_OK;
+}
+
+UI_DAL void ui_dal_redraw(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	uint64_t start;
+	int32_t x2 = x + width;
+	int32_t y2 = y + height;
+	int32_t row;
+
+	start = _headless_now_us();
+
+	x = UI_MAX(x, 0);
+	y = UI_MAX(y, 0);
+	x2 = UI_MIN(x2, CONFIG_UI_DISPLAY_WIDTH);
+	y2 = UI_MIN(y2, CONFIG_UI_DISPLAY_HEIGHT);
+
+	pthread_mutex_lock(&g_mutex);
+	for (row = y; row < y2 && x < x2; row++) {
+		memcpy(&g_front[row * FB_STRIDE + x * 3], &g_back[row * FB_STRIDE + x * 3], (x2 - x) * 3);
+	}
+	pthread_mutex_unlock(&g_mutex);
+
+	// The transfers to the panel so far are not a part of the render time.
+	g_cur.render_us = (uint32_t)(start - g_cur_start - g_cur_copy);
+	g_cur_copy += _headless_now_us() - start;
+	g_cur.pixels = ui_renderer_get_pixel_count();
+	g_cur.heap = _headless_heap_used();
+	g_cur.areas++;
+}
+
+UI_DAL void ui_dal_clear(void)
+{
+	// The UI core clears at the start of every frame, so this closes the last one.
+	_headless_end_frame();
+
+	memset(&g_cur, 0, sizeof(headless_frame_t));
+	g_cur_start = _headless_now_us();
+	g_cur_copy = 0;
+
+	memset(g_back, 0, FB_SIZE);
+}
+
+UI_DAL void ui_dal_put_pixel_rgba8888(int32_t x, int32_t y, ui_color_t color)
+{
+	ui_color_rgba8888_t *fg;
+	uint8_t *bg;
+
+	if (x < 0 || x >= CONFIG_UI_DISPLAY_WIDTH || y < 0 || y >= CONFIG_UI_DISPLAY_HEIGHT) {
+		return;
+	}
+
+	fg = (ui_color_rgba8888_t *)&color;
+	bg = &g_back[y * FB_STRIDE + x * 3];
+
+	bg[0] = ((fg->r * fg->a) + (bg[0] * (255 - fg->a))) / 255;
+	bg[1] = ((fg->g * fg->a) + (bg[1] * (255 - fg->a))) / 255;
+	bg[2] = ((fg->b * fg->a) + (bg[2] * (255 - fg->a))) / 255;
+}
+
+UI_DAL void ui_dal_put_pixel_rgb888(int32_t x, int32_t y, ui_color_t color)
+{
+	ui_color_rgb888_t *fg;
+	uint8_t *bg;
+
+	if (x < 0 || x >= CONFIG_UI_DISPLAY_WIDTH || y < 0 || y >= CONFIG_UI_DISPLAY_HEIGHT) {
+		return;
+	}
+
+	fg = (ui_color_rgb888_t *)&color;
+	bg = &g_back[y * FB_STRIDE + x * 3];
+
+	bg[0] = fg->r;
+	bg[1] = fg->g;
+	bg[2] = fg->b;
+}
+
+UI_DAL ui_error_t ui_dal_set_viewport(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	g_viewport.x = x;
+	g_viewport.y = y;
+	g_viewport.width = width;
+	g_viewport.height = height;
+
+	return UI_OK;
+}
+
+UI_DAL ui_rect_t ui_dal_get_viewport(void)
+{
+	return g_viewport;
+}
+
+#if defined(CONFIG_UI_ENABLE_DAL_FRAMEBUFFER)
+
+UI_DAL ui_error_t ui_dal_get_framebuffer(ui_dal_framebuffer_t *fb)
+{
+	if (!g_use_fb) {
+		return UI_OPERATION_FAIL;
+	}
+
+	fb->buf = g_back;
+	fb->stride = FB_STRIDE;
+	fb->pf = UI_PIXEL_FORMAT_RGB888;
+
+	return UI_OK;
+}
+
+#endif // CONFIG_UI_ENABLE_DAL_FRAMEBUFFER
+
+#if defined(CONFIG_UI_ENABLE_TOUCH)
+
+UI_DAL bool ui_dal_get_touch(bool *pressed, ui_coord_t *coord)
+{
+	bool ret = false;
+
+	pthread_mutex_lock(&g_mutex);
+	if (g_touch_head != g_touch_tail) {
+		*pressed = g_touch_queue[g_touch_head].pressed;
+		*coord = g_touch_queue[g_touch_head].coord;
+		g_touch_head = (g_touch_head + 1) % HEADLESS_TOUCH_QUEUE_SIZE;
+		ret = true;
+	}
+	pthread_mutex_unlock(&g_mutex);
+
+	return ret;
+}
+
+#endif // CONFIG_UI_ENABLE_TOUCH
+
+/****************************************************************************
+ * Headless Interface Implementation
+ ****************************************************************************/
+void headless_use_framebuffer(bool enable)
+{
+	g_use_fb = enable;
+}
+
+void headless_start_recording(headless_frame_t *frames, uint32_t max)
+{
+	pthread_mutex_lock(&g_mutex);
+	g_frames = frames;
+	g_frames_max = max;
+	g_frames_count = 0;
+	pthread_mutex_unlock(&g_mutex);
+}
+
+uint32_t headless_stop_recording(void)
+{
+	uint32_t count;
+
+	pthread_mutex_lock(&g_mutex);
+	count = g_frames_count;
+	g_frames = NULL;
+	g_frames_max = 0;
+	g_frames_count = 0;
+	pthread_mutex_unlock(&g_mutex);
+
+	return count;
+}
+
+bool headless_push_touch(bool pressed, int32_t x, int32_t y)
+{
+	uint32_t next;
+	bool ret = false;
+
+	pthread_mutex_lock(&g_mutex);
+	next = (g_touch_tail + 1) % HEADLESS_TOUCH_QUEUE_SIZE;
+	if (next != g_touch_head) {
+		g_touch_queue[g_touch_tail].pressed = pressed;
+		g_touch_queue[g_touch_tail].coord.x = x;
+		g_touch_queue[g_touch_tail].coord.y = y;
+		g_touch_tail = next;
+		ret = true;
+	}
+	pthread_mutex_unlock(&g_mutex);
+
+	return ret;
+}
+
+uint32_t headless_get_heap_used(void)
+{
+	return _headless_heap_used();
+}
+
+bool headless_dump_ppm(const char *path)
+{
+	FILE *fp;
+	size_t written;
+
+	fp = fopen(path, "wb");
+	if (!fp) {
+		return false;
+	}
+
+	fprintf(fp, "P6\n%d %d\n255\n", CONFIG_UI_DISPLAY_WIDTH, CONFIG_UI_DISPLAY_HEIGHT);
+
+	pthread_mutex_lock(&g_mutex);
+	written = fwrite(g_front, 1, FB_SIZE, fp);
+	pthread_mutex_unlock(&g_mutex);
+
+	fclose(fp);
+
+	return written == FB_SIZE;
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __DAL_HEADLESS_H__
+#define __DAL_HEADLESS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief A frame presented by the UI core.
+ *
+ * A frame starts at ui_dal_clear() and is recorded only when at least one
+ * area of it was sent to the panel with ui_dal_redraw().
+ */
+typedef struct {
+	uint32_t render_us;  //!< From the start of the frame to the end of its last redraw
+	uint32_t pixels;     //!< Pixels drawn by the renderer
+	uint32_t areas;      //!< Number of ui_dal_redraw() calls
+	uint32_t heap;       //!< Bytes allocated from the heap at the end of the frame, 0 if unknown
+} headless_frame_t;
+
+/**
+ * @brief Lets the renderer write into the framebuffer directly, or forces
+ *        it back to the per-pixel put_pixel functions.
+ */
+void headless_use_framebuffer(bool enable);
+
+/**
+ * @brief Starts recording the presented frames into the given array.
+ *
+ * Frames after the first max ones are not recorded.
+ */
+void headless_start_recording(headless_frame_t *frames, uint32_t max);
+
+/**
+ * @brief Stops recording and returns how many frames were recorded.
+ */
+uint32_t headless_stop_recording(void);
+
+/**
+ * @brief Queues a touch event, as if it came from a touch panel.
+ *
+ * Returns false if the queue is full.
+ */
+bool headless_push_touch(bool pressed, int32_t x, int32_t y);
+
+/**
+ * @brief Returns how many bytes are allocated from the heap, 0 if unknown.
+ */
+uint32_t headless_get_heap_used(void);
+
+/**
+ * @brief Writes what is on the panel now to a binary PPM (P6) file.
+ */
+bool headless_dump_ppm(const char *path);
+
+#endif // __DAL_HEADLESS_H__
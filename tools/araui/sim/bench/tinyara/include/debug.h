@@ -0,0 +1,11 @@
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+#include <stdio.h>
+
+//!< TizenRT debug macros, only used when CONFIG_DEBUG_UI_* is defined
+#define uidbg(format, ...)  printf(format, ##__VA_ARGS__)
+#define uiwdbg(format, ...) printf(format, ##__VA_ARGS__)
+#define uivdbg(format, ...) printf(format, ##__VA_ARGS__)
+
+#endif
@@ -16,6 +16,7 @@
 #define CONFIG_UI_DISPLAY_HEIGHT      (360)
 #define CONFIG_UI_STACK_SIZE          (8192)
 #define CONFIG_UI_UPDATE_MEMPOOL_SIZE (128)
+#define CONFIG_UI_GLYPH_CACHE_SIZE    (16384)
 #define CONFIG_UI_MAXIMUM_FPS         (30)
 #define CONFIG_UI_DISPLAY_SCALE       (1)
 
@@ -0,0 +1,243 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <crc32.h>
+#include <chksum.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BENCH_BUFSIZE   4096
+#define BENCH_BYTES     (256 * 1024 * 1024)
+#define CHECK_MAXLEN    300
+
+/****************************************************************************
+ * External Function Prototypes
+ ****************************************************************************/
+
+/* lib_crc32.c built without CONFIG_LIBC_CRC32_SLICEBY8 */
+
+uint32_t crc32part_bytewise(const uint8_t *src, size_t len, uint32_t crc32val);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static uint8_t g_buf[BENCH_BUFSIZE + 8];
+static volatile uint32_t g_sink;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Bitwise reflected CRC32 (polynomial 0xedb88320) */
+
+static uint32_t crc32_ref(const uint8_t *src, size_t len, uint32_t crc)
+{
+	int bit;
+
+	crc = ~crc;
+	while (len-- > 0) {
+		crc ^= *src++;
+		for (bit = 0; bit < 8; bit++) {
+			crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+		}
+	}
+
+	return ~crc;
+}
+
+/* RFC 1071 sum of network order words, returned in host order */
+
+static uint16_t chksum16_ref(const uint8_t *src, size_t len)
+{
+	uint32_t sum = 0;
+	uint8_t net[2];
+	uint16_t host;
+	size_t i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		sum += ((uint32_t)src[i] << 8) | src[i + 1];
+	}
+
+	if (i < len) {
+		sum += (uint32_t)src[i] << 8;
+	}
+
+	while ((sum >> 16) != 0) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	net[0] = (uint8_t)(sum >> 8);
+	net[1] = (uint8_t)sum;
+	memcpy(&host, net, sizeof(host));
+	return host;
+}
+
+/* lwIP's default LWIP_CHKSUM (algorithm 2), for comparison */
+
+static uint16_t chksum16_lwip(const void *dataptr, int len)
+{
+	const uint8_t *pb = (const uint8_t *)dataptr;
+	const uint16_t *ps;
+	uint16_t t = 0;
+	uint32_t sum = 0;
+	int odd = ((uintptr_t)pb & 1);
+
+	if (odd && len > 0) {
+		((uint8_t *)&t)[1] = *pb++;
+		len--;
+	}
+
+	ps = (const uint16_t *)(const void *)pb;
+	while (len > 1) {
+		sum += *ps++;
+		len -= 2;
+	}
+
+	if (len > 0) {
+		((uint8_t *)&t)[0] = *(const uint8_t *)ps;
+	}
+
+	sum += t;
+	sum = (sum >> 16) + (sum & 0xffff);
+	sum = (sum >> 16) + (sum & 0xffff);
+
+	if (odd) {
+		sum = ((sum & 0xff) << 8) | ((sum & 0xff00) >> 8);
+	}
+
+	return (uint16_t)sum;
+}
+
+static int chksum_bench_verify(void)
+{
+	size_t align;
+	size_t len;
+	uint32_t ref;
+	int errors = 0;
+
+	for (align = 0; align < 8; align++) {
+		for (len = 0; len <= CHECK_MAXLEN; len++) {
+			ref = crc32_ref(g_buf + align, len, 0);
+			if (crc32(g_buf + align, len) != ref || crc32part_bytewise(g_buf + align, len, 0) != ref) {
+				printf("crc32 mismatch: align %zu len %zu\n", align, len);
+				errors++;
+			}
+
+			if (chksum16(g_buf + align, len) != chksum16_ref(g_buf + align, len)) {
+				printf("chksum16 mismatch: align %zu len %zu\n", align, len);
+				errors++;
+			}
+		}
+	}
+
+	if (crc32((const uint8_t *)"123456789", 9) != 0xcbf43926) {
+		printf("crc32 check value mismatch\n");
+		errors++;
+	}
+
+	return errors;
+}
+
+static double chksum_bench_elapsed(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void chksum_bench_report(const char *name, size_t len, double sec)
+{
+	printf("%-20s %5zu bytes/call: %8.1f MB/s\n", name, len, BENCH_BYTES / sec / 1e6);
+}
+
+static void chksum_bench_run(size_t len)
+{
+	struct timespec start;
+	size_t calls = BENCH_BYTES / len;
+	uint32_t crc;
+	size_t i;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0, crc = 0; i < calls; i++) {
+		crc = crc32part_bytewise(g_buf, len, crc);
+	}
+	g_sink = crc;
+	chksum_bench_report("crc32 bytewise", len, chksum_bench_elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0, crc = 0; i < calls; i++) {
+		crc = crc32part(g_buf, len, crc);
+	}
+	g_sink = crc;
+	chksum_bench_report("crc32 slice-by-8", len, chksum_bench_elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0, crc = 0; i < calls; i++) {
+		crc += chksum16_lwip(g_buf + (i & 1), (int)len);
+	}
+	g_sink = crc;
+	chksum_bench_report("lwip_standard_chksum", len, chksum_bench_elapsed(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0, crc = 0; i < calls; i++) {
+		crc += chksum16(g_buf + (i & 1), len);
+	}
+	g_sink = crc;
+	chksum_bench_report("chksum16", len, chksum_bench_elapsed(&start));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+	static const size_t lens[] = { 64, 512, 1500, 4096 };
+	size_t i;
+
+	srand(1);
+	for (i = 0; i < sizeof(g_buf); i++) {
+		g_buf[i] = (uint8_t)rand();
+	}
+
+	if (chksum_bench_verify() != 0) {
+		return EXIT_FAILURE;
+	}
+
+	printf("crc32 and chksum16 match the reference implementations\n");
+
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		chksum_bench_run(lens[i]);
+	}
+
+	return EXIT_SUCCESS;
+}